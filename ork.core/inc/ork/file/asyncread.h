@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ork/file/path.h>
+#include <ork/kernel/datablock.h>
+#include <ork/kernel/opq.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// batched asynchronous reads
+//
+//  add N requests to an AsyncReadBatch, submit() them all at once,
+//   each request's completion runs on the batch's completion queue.
+//
+//  backends:
+//    IO_URING   : linux, one shared ring, reads issued as a single submission
+//    THREADPOOL : pread() on opq::concurrentQueue()
+//
+//  reads of at least kDIRECT_THRESHOLD bytes use O_DIRECT into page aligned
+//   buffers (falling back to buffered io where the filesystem refuses it).
+//  paths served by a mounted pak resolve immediately (zero copy),
+//   paths on other non-posix devices go through a regular File read.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::file {
+
+static constexpr size_t kDIRECT_THRESHOLD = 1 << 20;
+static constexpr size_t kDIRECT_ALIGN     = 4096;
+
+struct AsyncReadRequest;
+struct AsyncReadBatch;
+using asyncreadreq_ptr_t   = std::shared_ptr<AsyncReadRequest>;
+using asyncreadbatch_ptr_t = std::shared_ptr<AsyncReadBatch>;
+using asyncreadcompletion_t = std::function<void(asyncreadreq_ptr_t)>;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct AsyncReadRequest {
+
+  Path _path;
+  size_t _offset = 0;
+  size_t _length = 0; // 0 : through end of file
+  /// optional caller owned destination (at least _length bytes)
+  ///  if null the result is returned in _data
+  void* _destination = nullptr;
+  asyncreadcompletion_t _onComplete;
+
+  //////////////////////////////
+  // results, valid once completed
+  //////////////////////////////
+
+  datablock_ptr_t _data;  // null when reading into _destination
+  size_t _bytesRead = 0;
+  int _error        = 0; // 0 or errno
+  bool _direct      = false; // read went through O_DIRECT
+
+  bool ok() const {
+    return _error == 0;
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct AsyncReadBatch {
+
+  /// completions are enqueued on completion_queue,
+  ///  a null queue runs them inline on the io thread
+  ///  (the thread pool backend then reads on the submitting thread)
+  AsyncReadBatch(opq::opq_ptr_t completion_queue = opq::concurrentQueue());
+  ~AsyncReadBatch();
+
+  asyncreadreq_ptr_t add(const Path& path, asyncreadcompletion_t on_complete = nullptr);
+  asyncreadreq_ptr_t add(
+      const Path& path, //
+      size_t offset,
+      size_t length,
+      void* destination                = nullptr,
+      asyncreadcompletion_t on_complete = nullptr);
+
+  /// issue all added requests. requests are resolved, opened and sized
+  ///  on the backend workers (inline only with a null completion queue)
+  void submit();
+  /// block until every completion has run.
+  ///  do not wait from a thread the completion queue needs to make progress
+  void wait();
+  /// submit() then wait()
+  void submitAndWait();
+
+  size_t numPending() const;
+
+  /// (internal) called by the backends as each request finishes
+  void _completed(asyncreadreq_ptr_t request);
+
+  std::vector<asyncreadreq_ptr_t> _requests;
+  opq::opq_ptr_t _completionQueue;
+
+private:
+  mutable std::mutex _mutex;
+  std::condition_variable _condition;
+  size_t _numPending = 0;
+  bool _submitted    = false;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum class AsyncReadBackend {
+  IO_URING = 0,
+  THREADPOOL,
+};
+
+/// backend in use (IO_URING when the kernel supports it)
+AsyncReadBackend asyncReadBackend();
+/// override backend selection (eg. for testing the fallback)
+void setAsyncReadBackend(AsyncReadBackend backend);
+
+/// read a whole file through the async backend, blocking until done.
+///  large files get O_DIRECT, returns nullptr if the file could not be read
+datablock_ptr_t readFileDirect(const Path& path);
+
+/// readFileDirect for loaders that may run concurrently :
+///  reads requested while another is in flight are gathered
+///  and issued together as the next AsyncReadBatch
+datablock_ptr_t readFileBatched(const Path& path);
+
+} // namespace ork::file
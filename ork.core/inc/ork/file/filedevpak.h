@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ork/file/file.h>
+#include <ork/kernel/datablock.h>
+#include <ork/kernel/mutex.h>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// pak archives
+//
+//  a pak is a single file holding many assets, read through mmap.
+//
+//  layout:
+//    Header
+//    entry data    (in recorded load order, kALIGN aligned)
+//    Entry index   (sorted by path hash)
+//    path strings  (nul terminated, referenced by Entry::_pathoffset)
+//
+//  paths are keyed by their url form ("data://foo/bar.png"),
+//   see pak::normalizePath()
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::pak {
+
+static constexpr uint32_t kMAGIC   = 0x504b524f; // "ORKP" little endian
+static constexpr uint32_t kVERSION = 1;
+static constexpr size_t kALIGN     = 64;
+
+enum class Codec : uint32_t {
+  NONE = 0,
+  LZ4,
+};
+
+struct Header {
+  uint32_t _magic   = kMAGIC;
+  uint32_t _version = kVERSION;
+  uint64_t _numentries    = 0;
+  uint64_t _indexoffset   = 0;
+  uint64_t _stringsoffset = 0;
+  uint64_t _stringslength = 0;
+};
+
+struct Entry {
+  uint64_t _pathhash   = 0;
+  uint64_t _offset     = 0;
+  uint64_t _size       = 0; // stored size
+  uint64_t _rawsize    = 0; // decompressed size
+  uint32_t _codec      = 0;
+  uint32_t _pathoffset = 0;
+};
+
+std::string normalizePath(const file::Path& path);
+uint64_t hashPath(const std::string& normalized_path);
+
+///////////////////////////////////////////////////////////////////////////////
+// Archive : read only mapped pak
+///////////////////////////////////////////////////////////////////////////////
+
+struct Archive : public std::enable_shared_from_this<Archive> {
+
+  ~Archive();
+
+  const Entry* find(const file::Path& path) const;
+  const char* pathOf(const Entry* entry) const;
+  size_t numEntries() const {
+    return _numentries;
+  }
+  const Entry* entry(size_t index) const {
+    return _index + index;
+  }
+  /// contents of an entry
+  ///  uncompressed entries reference the mapping directly (zero copy)
+  datablock_ptr_t load(const Entry* entry);
+
+  std::string _filename;
+  const uint8_t* _mapped = nullptr;
+  size_t _mappedlength   = 0;
+  const Entry* _index    = nullptr;
+  size_t _numentries     = 0;
+  const char* _strings   = nullptr;
+  size_t _stringslength  = 0;
+};
+
+using archive_ptr_t = std::shared_ptr<Archive>;
+
+/// map a pak file, returns nullptr if missing or invalid
+archive_ptr_t openArchive(const file::Path& filename);
+
+///////////////////////////////////////////////////////////////////////////////
+// Writer : builds a pak (see utils/pak)
+///////////////////////////////////////////////////////////////////////////////
+
+struct Writer {
+
+  /// entries are laid out in the order they are added
+  void addEntry(const file::Path& path, datablock_constptr_t data, Codec codec = Codec::NONE);
+  bool write(const std::string& filename) const;
+
+  struct Item {
+    std::string _path;
+    datablock_constptr_t _data;
+    Codec _codec;
+  };
+  std::vector<Item> _items;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// load order recording (feeds the packer's entry layout)
+///////////////////////////////////////////////////////////////////////////////
+
+void beginLoadOrderRecording();
+std::vector<std::string> endLoadOrderRecording();
+void recordLoad(const file::Path& path);
+
+} // namespace ork::pak
+
+///////////////////////////////////////////////////////////////////////////////
+namespace ork {
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// FileDevPak : FileDev over a stack of mounted paks.
+//  later mounts override earlier ones (patch paks over base paks),
+//  anything not found in a pak (and all writes) go to the fallback device.
+///////////////////////////////////////////////////////////////////////////////
+
+class FileDevPak : public FileDev {
+
+public:
+  FileDevPak(FileDev* fallback);
+
+  void mount(pak::archive_ptr_t archive);
+  bool unmount(pak::archive_ptr_t archive);
+
+  /// zero copy load (nullptr if not in any mounted pak)
+  datablock_ptr_t loadDataBlock(const file::Path& path);
+
+  /// install a pak device in front of the device currently serving uriproto
+  static FileDevPak* installForUriProto(const std::string& uriproto);
+
+  EFileErrCode write(File& rFile, const void* pFrom, size_t iSize) final;
+  EFileErrCode getCurrentDirectory(file::Path::NameType& directory) final;
+  EFileErrCode setCurrentDirectory(const file::Path::NameType& directory) final;
+
+  bool doesFileExist(const file::Path& filespec) final;
+  bool doesDirectoryExist(const file::Path& filespec) final;
+  bool isFileWritable(const file::Path& filespec) final;
+
+  FileDev* _fallback = nullptr;
+
+private:
+  EFileErrCode _doOpenFile(File& rFile) final;
+  EFileErrCode _doCloseFile(File& rFile) final;
+  EFileErrCode _doRead(File& rFile, void* pTo, size_t iSize, size_t& iactualread) final;
+  EFileErrCode _doSeekFromStart(File& rFile, size_t iTo) final;
+  EFileErrCode _doSeekFromCurrent(File& rFile, size_t iOffset) final;
+  EFileErrCode _doGetLength(File& rFile, size_t& riLength) final;
+
+  struct Lookup {
+    pak::archive_ptr_t _archive;
+    const pak::Entry* _entry = nullptr;
+  };
+  struct OpenPakFile {
+    datablock_ptr_t _data;
+  };
+
+  Lookup _find(const file::Path& path);
+
+  ork::mutex _mutex;
+  std::vector<pak::archive_ptr_t> _mounts; // mount order, last wins
+};
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork
+///////////////////////////////////////////////////////////////////////////////
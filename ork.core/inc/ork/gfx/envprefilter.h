@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ork/math/cvector2.h>
+#include <ork/math/cvector3.h>
+#include <ork/math/cvector4.h>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// envprefilter : cpu prefiltering of lat-long environment maps for pbr
+//
+//  diffuse  : the environment is projected onto 9 SH coefficients (bands 0-2),
+//             the irradiance map is the cosine convolved SH evaluated per
+//             texel (stored as irradiance/pi, ready to multiply by albedo).
+//  specular : GGX prefiltered mip chain, roughness = level/(numlevels-1).
+//             importance sampled (hammersley), with filtered importance
+//             sampling : each sample reads the source mip matching its
+//             solid angle, so few samples per texel are needed.
+//             sample directions are transformed and mapped to lat-long uvs
+//             in blocks (branch free, so the compiler emits simd for them),
+//             then fetched.
+//  work is split into tiles of rows on the opq concurrent queue, results
+//   do not depend on the tiling.
+//
+//  texel (u,v) of the outputs faces (sin(t)cos(p), cos(t), sin(t)sin(p)),
+//   p = 2pi*u-pi, t = pi*v (pbr_filterenv.glfx's env_equirectangularUV2N),
+//   row 0 of every image is v=0.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::envprefilter {
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct EnvImage {
+
+  EnvImage(int w = 0, int h = 0);
+
+  fvec4& texel(int x, int y) {
+    return _texels[y * _width + x];
+  }
+  const fvec4& texel(int x, int y) const {
+    return _texels[y * _width + x];
+  }
+  //! bilinear, wraps in u, clamps in v
+  fvec3 sampleBilinear(float u, float v) const;
+
+  int _width  = 0;
+  int _height = 0;
+  std::vector<fvec4> _texels; // row major
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct Params {
+  bool _sourceZPole    = false; // source pole on z (as env_equirectangularN2UV reads it), else on y
+  bool _diffuseFlipYZ  = false; // diffuse texels face (x,-y,-z) : orientation of the gpu diffuse filter
+  int _specularSamples = 64;    // per texel (per level > 0)
+  int _diffuseWidth    = 128;   // diffuse map is w x w/2 (never larger than the source)
+  int _rowsPerTile     = 8;
+};
+
+struct Result {
+  fvec3 _sh9[9]; // radiance
+  std::vector<EnvImage> _specularLevels;
+  std::vector<EnvImage> _diffuseLevels;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//! output texel direction (see above)
+fvec3 texelDirection(float u, float v);
+//! source texel direction and its inverse
+fvec3 sourceDirection(float u, float v, bool zpole);
+fvec2 sourceUV(const fvec3& dir, bool zpole);
+
+//! radiance SH coefficients (out[9]) of a source image
+void projectSH9(const EnvImage& src, bool zpole, fvec3* out);
+//! irradiance/pi at normal n from radiance coefficients
+fvec3 irradianceSH9(const fvec3* sh9, const fvec3& n);
+
+//! 2x2 box, sizes floored (min 1)
+EnvImage downsample(const EnvImage& src);
+//! levels in the specular chain (halving while both sides are > 4)
+int numSpecularLevels(int w, int h);
+
+std::vector<EnvImage> specularChain(const EnvImage& src, const Params& params);
+std::vector<EnvImage> diffuseChain(const fvec3* sh9, int w, int h, const Params& params);
+
+//! all of the above
+Result prefilter(const EnvImage& src, const Params& params);
+
+} // namespace ork::envprefilter
@@ -87,7 +87,20 @@ struct DataBlock {
   /////////////////////////////////////////////
   datablock_ptr_t decrypt(encryptioncodec_ptr_t codec) const;
   /////////////////////////////////////////////
+  /// reference (do not copy) externally owned memory, eg. a mapped pak entry.
+  ///  owner is held for the lifetime of the reference.
+  ///  any mutation first copies the referenced bytes into _storage
+  void referenceExternal(const void* data, size_t length, std::shared_ptr<const void> owner);
+  bool isExternal() const {
+    return _external != nullptr;
+  }
+  /// copy externally referenced bytes into _storage (no-op if not external)
+  void materialize();
+  /////////////////////////////////////////////
   std::vector<uint8_t> _storage;
+  const uint8_t* _external = nullptr;
+  size_t _externalLength   = 0;
+  std::shared_ptr<const void> _externalOwner;
   std::shared_ptr<varmap::VarMap> _vars;
   std::string _name = "noname";
 };
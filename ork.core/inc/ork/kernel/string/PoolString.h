@@ -14,11 +14,29 @@
 
 #include <ork/kernel/string/ConstString.h>
 #include <ork/kernel/string/PieceString.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 
 ///////////////////////////////////////////////////////////////////////////////
 namespace ork {
 ///////////////////////////////////////////////////////////////////////////////
 
+///
+/// Every pooled string is stored in its StringPool's arena directly after
+/// a PoolStringHeader, so a PoolString's hash and length are O(1) reads.
+///
+
+struct PoolStringHeader {
+  const PoolStringHeader* _next = nullptr; // hash bucket chain, owned by StringPool
+  uint64_t _hash                = 0;
+  uint32_t _length              = 0;
+  std::atomic<int32_t> _index   = -1; // StringPool::FromIndex() index
+  const char* chars() const {
+    return reinterpret_cast<const char*>(this + 1);
+  }
+};
+
 ///
 /// PoolStrings are like ConstStrings except their string pointers are
 /// guaranteed to be one-one with their data.  Comparisons between PoolStrings is
@@ -26,8 +44,11 @@ namespace ork {
 /// different orderings on different runs/platforms.
 ///
 /// To conserve space, and because PoolStrings are used in maps,
-/// there is no need to store the length of the string in the
-/// structure.
+/// the structure is a single pointer; length and hash live in the
+/// pool's PoolStringHeader in front of the string data.
+///
+/// Equality is O(1) (pointer, then stored hash and length for strings
+/// from different pools), ordering remains lexical (strcmp).
 ///
 /// Consider PoolString the same thing as a const char * for use in maps
 /// with pooling keeping them unique.
@@ -64,6 +85,11 @@ public:
   /// @returns true if the string is not set, or is the empty string.
   bool empty() const;
 
+  /// @returns the length of the string (0 if not set).
+  size_t length() const;
+  /// @returns the stored hash of the string data (0 if not set).
+  uint64_t hash() const;
+
 private:
   friend class StringPool;
 
@@ -71,6 +97,7 @@ private:
   PoolString(const char* string);
 
   int compare(const PoolString&) const;
+  const PoolStringHeader* header() const;
 
   /// The character pointer to the string data
   const char* _stringptr;
@@ -87,6 +114,30 @@ inline const char* PoolString::c_str() const {
   return _stringptr;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+inline const PoolStringHeader* PoolString::header() const {
+  return reinterpret_cast<const PoolStringHeader*>(_stringptr) - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline size_t PoolString::length() const {
+  return _stringptr ? header()->_length : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline uint64_t PoolString::hash() const {
+  return _stringptr ? header()->_hash : 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 } // namespace ork
 ///////////////////////////////////////////////////////////////////////////////
+
+template <> struct std::hash<ork::PoolString> {
+  size_t operator()(const ork::PoolString& s) const {
+    return size_t(s.hash());
+  }
+};
@@ -3,7 +3,7 @@
 // Copyright 1996-2023, Michael T. Mayers.
 // Distributed under the MIT License.
 // see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
-//////////////////////////////////////////////////////////////// 
+////////////////////////////////////////////////////////////////
 
 #pragma once
 
@@ -12,18 +12,38 @@
 #include <ork/kernel/string/PoolString.h>
 
 #include <ork/orkstl.h>
-#include <ork/kernel/mutex.h>
+#include <atomic>
 
 ///////////////////////////////////////////////////////////////////////////////
 namespace ork {
 ///////////////////////////////////////////////////////////////////////////////
 
+///
+/// StringPool : lock-free string intern table
+///
+///  strings are hashed into kNUMSHARDS shards of kNUMBUCKETS chained buckets.
+///  lookups walk a bucket chain without locking, inserts publish a new chain
+///  head with a single CAS (retrying against whatever was pushed meanwhile),
+///  so a given string is only ever pooled once.
+///
+///  string storage comes from a per shard bump arena (PoolStringHeader + data)
+///  and lives for the lifetime of the process.
+///
+///  indices (FromIndex, FindIndex..) are assigned in insertion order.
+///
+
 class StringPool
 {
 public:
-	typedef orkvector<const char * > VecType;
+	static constexpr size_t kNUMSHARDS    = 32;
+	static constexpr size_t kNUMBUCKETS   = 1024; // per shard
+	static constexpr size_t kARENABLOCK   = 64 << 10;
+	static constexpr size_t kINDEXCHUNK   = 4096;
+	static constexpr size_t kMAXINDEXCHUNKS = 1024;
 
 	explicit StringPool(const StringPool *parent = NULL);
+	~StringPool();
+
 	PoolString String(const PieceString &);
 	PoolString Literal(const ConstString &);
 	PoolString Find(const PieceString &) const;
@@ -33,16 +53,23 @@ public:
 	int FindIndex(const PieceString &) const;
 	int Size() const;
 	PoolString FromIndex(int) const;
+
+	static uint64_t hashString(const char* data, size_t length);
+
 private:
-	const char *FindRecursive(const PieceString &) const;
-	const char *FindFirst(const PieceString &, VecType::iterator &);
-	VecType::size_type BinarySearch(const PieceString &, bool &) const;
+	struct ArenaBlock;
+	struct Shard;
+	using indexchunk_t = std::atomic<const char*>;
 
-	VecType										mStringPool;
-	mutable ork::recursive_mutex				mStringPoolMutex;
+	const PoolStringHeader* findLocal(const char* data, size_t length, uint64_t hash) const;
+	const PoolStringHeader* findRecursive(const char* data, size_t length, uint64_t hash) const;
+	PoolStringHeader* allocate(Shard& shard, const char* data, size_t length, uint64_t hash);
+	void assignIndex(PoolStringHeader* header);
+	Shard& shardFor(uint64_t hash) const;
 
-	void Lock() const { mStringPoolMutex.Lock(); }
-	void UnLock() const { mStringPoolMutex.UnLock(); }
+	Shard*									_shards;
+	std::atomic<int>						_count;
+	std::atomic<indexchunk_t*>				_indexchunks[kMAXINDEXCHUNKS];
 
 protected:
 	const StringPool *_parent;
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ork/math/cvector2.h>
+#include <ork/math/cvector3.h>
+#include <cstdint>
+
+///////////////////////////////////////////////////////////////////////////////
+// batch noise : value / gradient / simplex noise and their fractal sums,
+//  evaluated over arrays of positions (SoA) or whole grids.
+//
+//  every basis is one kernel written against a lane type, compiled for
+//   scalar, SSE4.1 (4 lanes) and AVX2 (8 lanes). the widest one the target
+//   was compiled for (-march) runs the batches, the scalar one backs the
+//   single point calls and batch tails, so both agree (to fma contraction).
+//  lattice hashing is integer arithmetic (no permutation table gathers),
+//   octaves are summed in registers per block of lanes.
+//
+//  output is roughly -1 .. 1 for NONE and FBM (fbm is normalized by the
+//   octave amplitude sum), 0 .. 1 for RIDGED.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::math {
+
+enum class NoiseBasis {
+  VALUE = 0,
+  GRADIENT,
+  SIMPLEX,
+};
+
+enum class NoiseFractal {
+  NONE = 0, // single octave
+  FBM,
+  RIDGED,
+};
+
+struct NoiseParams {
+  NoiseBasis _basis     = NoiseBasis::GRADIENT;
+  NoiseFractal _fractal = NoiseFractal::FBM;
+  int _octaves          = 4;
+  float _frequency      = 1.0f;
+  float _lacunarity     = 2.0f;
+  float _gain           = 0.5f;
+  uint32_t _seed        = 0;
+};
+
+namespace noise {
+
+///////////////////////////////////////////////////////////////////////////////
+// single point (scalar kernels)
+///////////////////////////////////////////////////////////////////////////////
+
+float value2(float x, float y, uint32_t seed = 0);
+float value3(float x, float y, float z, uint32_t seed = 0);
+float gradient2(float x, float y, uint32_t seed = 0);
+float gradient3(float x, float y, float z, uint32_t seed = 0);
+float simplex2(float x, float y, uint32_t seed = 0);
+float simplex3(float x, float y, float z, uint32_t seed = 0);
+
+float sample2(const fvec2& pos, const NoiseParams& params);
+float sample3(const fvec3& pos, const NoiseParams& params);
+
+///////////////////////////////////////////////////////////////////////////////
+// batches : out[i] = sample(xs[i], ys[i] (, zs[i]))
+///////////////////////////////////////////////////////////////////////////////
+
+void batch2(const float* xs, const float* ys, float* out, size_t count, const NoiseParams& params);
+void batch3(const float* xs, const float* ys, const float* zs, float* out, size_t count, const NoiseParams& params);
+
+//! row major w*h grid, out[j*w+i] = sample(origin + (i,j)*step)
+void grid2(float* out, int w, int h, const fvec2& origin, const fvec2& step, const NoiseParams& params);
+//! one z slice of a 3d field, same layout as grid2
+void grid3(float* out, int w, int h, const fvec3& origin, const fvec2& step, const NoiseParams& params);
+
+//! lanes and instruction set the batches were compiled for ("avx2", "sse4.1", "scalar")
+int simdWidth();
+const char* simdName();
+
+} // namespace noise
+} // namespace ork::math
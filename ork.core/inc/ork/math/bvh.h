@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ork/math/cvector3.h>
+#include <ork/kernel/datablock.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// BVH4 : 4 wide bounding volume hierarchy
+//
+//  built top down with binned SAH into a binary tree,
+//   which is then collapsed into 4 wide nodes.
+//  child bounds are stored SoA so the 4 slab tests of a node
+//   run as straight line (auto vectorizable) code.
+//
+//  the BVH knows nothing about primitives beyond their bounds:
+//   leaves are ranges of _primIndices, intersection is up to the caller.
+//   owners that reorder their primitives by _primIndices after the build
+//   can index them with the leaf range directly.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork {
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct BVH4Ray {
+
+  BVH4Ray(const fvec3& origin, const fvec3& direction, float tmin = 0.0f, float tmax = std::numeric_limits<float>::infinity());
+
+  fvec3 _origin;
+  fvec3 _direction;
+  fvec3 _invdir;
+  int _positive[3];
+  float _tmin;
+  float _tmax; // shrunk by the leaf callback on hits
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// coherent ray packet (eg. a 4x2 pixel block of primary rays), SoA by lane.
+//  a node is entered when any active ray hits it, the leaf callback gets
+//  the mask of rays which hit the leaf bounds.
+///////////////////////////////////////////////////////////////////////////////
+
+struct BVH4Packet {
+
+  static constexpr int kSize = 8;
+
+  BVH4Packet();
+
+  void setRay(
+      int lane,
+      const fvec3& origin,
+      const fvec3& direction,
+      float tmin = 0.0f,
+      float tmax = std::numeric_limits<float>::infinity());
+
+  float _ox[kSize], _oy[kSize], _oz[kSize];
+  float _dx[kSize], _dy[kSize], _dz[kSize];
+  float _ix[kSize], _iy[kSize], _iz[kSize]; // 1/direction
+  float _tmin[kSize];
+  float _tmax[kSize]; // shrunk by the leaf callback on hits
+  uint32_t _active = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct BVH4 {
+
+  static constexpr int kWidth    = 4;
+  static constexpr int kMaxDepth = 64;
+
+  struct BuildPrim {
+    fvec3 _min;
+    fvec3 _max;
+  };
+
+  //  lane encoding :
+  //   _count[i] > 0  : leaf, _child[i] is the first _primIndices slot
+  //   _count[i] == 0 : inner, _child[i] is a node index
+  //   _child[i] < 0  : empty lane
+  struct Node {
+    float _minx[kWidth], _miny[kWidth], _minz[kWidth];
+    float _maxx[kWidth], _maxy[kWidth], _maxz[kWidth];
+    int32_t _child[kWidth];
+    int32_t _count[kWidth];
+  };
+
+  void build(const std::vector<BuildPrim>& prims, int maxleafsize = 4);
+  void clear();
+
+  bool empty() const {
+    return _nodes.empty();
+  }
+
+  /////////////////////////////////////
+  // closest hit / any hit traversal
+  //  on_leaf(first,count,ray) intersects _primIndices[first..first+count),
+  //  shrinking ray._tmax on a hit. returning true ends the traversal
+  //  (any hit queries, eg. shadow rays)
+  /////////////////////////////////////
+
+  template <typename leaf_fn_t> void traverse(BVH4Ray& ray, const leaf_fn_t& on_leaf) const;
+
+  /////////////////////////////////////
+  // packet traversal
+  //  on_leaf(first,count,packet,raymask), same contract as above
+  /////////////////////////////////////
+
+  template <typename leaf_fn_t> void traversePacket(BVH4Packet& packet, const leaf_fn_t& on_leaf) const;
+
+  /////////////////////////////////////
+  // plain old data, so the cache format is just the arrays
+  /////////////////////////////////////
+
+  void serialize(DataBlock& out) const;
+  bool deserialize(DataBlockInputStream& inp);
+
+  std::vector<Node> _nodes;
+  std::vector<uint32_t> _primIndices;
+  fvec3 _boundsMin;
+  fvec3 _boundsMax;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename leaf_fn_t> void BVH4::traverse(BVH4Ray& ray, const leaf_fn_t& on_leaf) const {
+  if (_nodes.empty())
+    return;
+  struct StackItem {
+    int32_t _child;
+    int32_t _count;
+    float _tnear;
+  };
+  StackItem stack[kMaxDepth * (kWidth - 1) + 1];
+  int sp      = 0;
+  stack[sp++] = StackItem{0, 0, ray._tmin};
+  while (sp) {
+    const auto item = stack[--sp];
+    if (item._tnear > ray._tmax)
+      continue;
+    if (item._count) {
+      if (on_leaf(uint32_t(item._child), uint32_t(item._count), ray))
+        return;
+      continue;
+    }
+    const Node& node = _nodes[item._child];
+    ////////////////////////////////
+    // 4 slab tests, near/far planes picked by ray direction sign
+    ////////////////////////////////
+    const float* nearx = ray._positive[0] ? node._minx : node._maxx;
+    const float* farx  = ray._positive[0] ? node._maxx : node._minx;
+    const float* neary = ray._positive[1] ? node._miny : node._maxy;
+    const float* fary  = ray._positive[1] ? node._maxy : node._miny;
+    const float* nearz = ray._positive[2] ? node._minz : node._maxz;
+    const float* farz  = ray._positive[2] ? node._maxz : node._minz;
+    float tnear[kWidth];
+    float tfar[kWidth];
+    for (int i = 0; i < kWidth; i++) {
+      float tx0 = (nearx[i] - ray._origin.x) * ray._invdir.x;
+      float ty0 = (neary[i] - ray._origin.y) * ray._invdir.y;
+      float tz0 = (nearz[i] - ray._origin.z) * ray._invdir.z;
+      float tx1 = (farx[i] - ray._origin.x) * ray._invdir.x;
+      float ty1 = (fary[i] - ray._origin.y) * ray._invdir.y;
+      float tz1 = (farz[i] - ray._origin.z) * ray._invdir.z;
+      tnear[i]  = std::max(std::max(ray._tmin, tx0), std::max(ty0, tz0));
+      tfar[i]   = std::min(std::min(ray._tmax, tx1), std::min(ty1, tz1));
+    }
+    ////////////////////////////////
+    // push hit lanes far to near, so the nearest pops first
+    ////////////////////////////////
+    int order[kWidth];
+    int numhit = 0;
+    for (int i = 0; i < kWidth; i++) {
+      if (node._child[i] >= 0 and tnear[i] <= tfar[i]) {
+        int j = numhit++;
+        while (j > 0 and tnear[order[j - 1]] < tnear[i]) {
+          order[j] = order[j - 1];
+          j--;
+        }
+        order[j] = i;
+      }
+    }
+    for (int j = 0; j < numhit; j++) {
+      int i       = order[j];
+      stack[sp++] = StackItem{node._child[i], node._count[i], tnear[i]};
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename leaf_fn_t> void BVH4::traversePacket(BVH4Packet& packet, const leaf_fn_t& on_leaf) const {
+  if (_nodes.empty() or packet._active == 0)
+    return;
+  constexpr int N = BVH4Packet::kSize;
+  struct StackItem {
+    int32_t _child;
+    int32_t _count;
+    uint32_t _mask;
+    float _tnear; // nearest entry over the masked rays
+  };
+  StackItem stack[kMaxDepth * (kWidth - 1) + 1];
+  int sp      = 0;
+  stack[sp++] = StackItem{0, 0, packet._active, -std::numeric_limits<float>::infinity()};
+  while (sp) {
+    const auto item = stack[--sp];
+    ////////////////////////////////
+    // cull once every ray has a closer hit
+    ////////////////////////////////
+    float tfarthest = -std::numeric_limits<float>::infinity();
+    for (int r = 0; r < N; r++) {
+      float tmax = ((item._mask >> r) & 1) ? packet._tmax[r] : -std::numeric_limits<float>::infinity();
+      tfarthest  = std::max(tfarthest, tmax);
+    }
+    if (item._tnear > tfarthest)
+      continue;
+    if (item._count) {
+      if (on_leaf(uint32_t(item._child), uint32_t(item._count), packet, item._mask))
+        return;
+      continue;
+    }
+    const Node& node = _nodes[item._child];
+    ////////////////////////////////
+    // child x ray slab tests, the ray loop is straight line code.
+    //  signs differ per ray, so near/far come from min/max
+    ////////////////////////////////
+    uint32_t hitmask[kWidth];
+    float tnear[kWidth];
+    for (int c = 0; c < kWidth; c++) {
+      float lo[N], hi[N];
+      for (int r = 0; r < N; r++) {
+        float tx0 = (node._minx[c] - packet._ox[r]) * packet._ix[r];
+        float tx1 = (node._maxx[c] - packet._ox[r]) * packet._ix[r];
+        float ty0 = (node._miny[c] - packet._oy[r]) * packet._iy[r];
+        float ty1 = (node._maxy[c] - packet._oy[r]) * packet._iy[r];
+        float tz0 = (node._minz[c] - packet._oz[r]) * packet._iz[r];
+        float tz1 = (node._maxz[c] - packet._oz[r]) * packet._iz[r];
+        lo[r]     = std::max(std::max(packet._tmin[r], std::min(tx0, tx1)), std::max(std::min(ty0, ty1), std::min(tz0, tz1)));
+        hi[r]     = std::min(std::min(packet._tmax[r], std::max(tx0, tx1)), std::min(std::max(ty0, ty1), std::max(tz0, tz1)));
+      }
+      uint32_t mask = 0;
+      float nearest = std::numeric_limits<float>::infinity();
+      for (int r = 0; r < N; r++) {
+        uint32_t hit = ((item._mask >> r) & 1) & uint32_t(lo[r] <= hi[r]);
+        mask |= hit << r;
+        nearest = std::min(nearest, hit ? lo[r] : std::numeric_limits<float>::infinity());
+      }
+      hitmask[c] = (node._child[c] >= 0) ? mask : 0;
+      tnear[c]   = nearest;
+    }
+    ////////////////////////////////
+    // push hit lanes far to near
+    ////////////////////////////////
+    int order[kWidth];
+    int numhit = 0;
+    for (int i = 0; i < kWidth; i++) {
+      if (hitmask[i]) {
+        int j = numhit++;
+        while (j > 0 and tnear[order[j - 1]] < tnear[i]) {
+          order[j] = order[j - 1];
+          j--;
+        }
+        order[j] = i;
+      }
+    }
+    for (int j = 0; j < numhit; j++) {
+      int i       = order[j];
+      stack[sp++] = StackItem{node._child[i], node._count[i], hitmask[i], tnear[i]};
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork
+///////////////////////////////////////////////////////////////////////////////
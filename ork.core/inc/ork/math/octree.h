@@ -13,8 +13,9 @@
 #include <ork/math/box.h>
 #include <ork/math/raytracer.h>
 #include <queue>
+#include <atomic>
 
-extern s64 giNumRays;
+extern std::atomic<s64> giNumRays;
 
 namespace ork {
 
@@ -163,8 +164,6 @@ public:
 
 	inline bool FindNearest( const fray3& a_Ray, float& a_Dist, fvec3& isect, const Primitive*& a_Prim ) const
 	{
-		giNumRays++;
-
 		float fdisttmp;
 		bool retval = false;
 		const AABox& e = mExtends;
@@ -15,6 +15,7 @@
 #include <ork/math/box.h>
 #include <ork/math/cvector3.h>
 #include <ork/math/line.h>
+#include <ork/math/bvh.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 namespace ork {
@@ -263,7 +264,7 @@ public:
   virtual int Intersect(const fray3& a_Ray, fvec3& isect, float& a_Dist) const = 0;
   virtual fvec3 GetNormal(const fvec3& pos) const                              = 0;
   virtual bool IntersectBox(const AABox& a_Box) const                          = 0;
-  virtual void Rasterize(Engine* peng) const                                   = 0;
+  virtual void Rasterize(Engine* peng, int iy0, int iy1) const                 = 0; // target rows [iy0,iy1)
   //////////////////////////////////////////////////
 
 protected:
@@ -295,7 +296,7 @@ public:
   virtual int Intersect(const fray3& a_Ray, fvec3& isect, float& a_Dist) const;
   virtual fvec3 GetNormal(const fvec3& pos) const;
   virtual bool IntersectBox(const AABox& a_Box) const;
-  virtual void Rasterize(Engine* peng) const;
+  virtual void Rasterize(Engine* peng, int iy0, int iy1) const;
 };
 
 class RaytTriangle : public Primitive {
@@ -324,7 +325,7 @@ public:
   virtual int Intersect(const fray3& a_Ray, fvec3& isect, float& a_Dist) const;
   virtual fvec3 GetNormal(const fvec3& pos) const;
   virtual bool IntersectBox(const AABox& a_Box) const;
-  virtual void Rasterize(Engine* peng) const;
+  virtual void Rasterize(Engine* peng, int iy0, int iy1) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -374,12 +375,30 @@ public:
   bool InitScene(const AABox& scene_box);
   void ExitScene();
   ////////////////////////////////////////////////////////
+  // ray queries (BVH, or the FixedGrid when enabled)
+  //  dist is the max distance on input, the hit distance on output
+  ////////////////////////////////////////////////////////
+  bool FindNearest(const fray3& ray, float& dist, const Primitive*& prim) const;
+  bool Occluded(const fray3& ray, float maxdist) const;
+  //! closest hit for each active packet lane, prims[lane] is 0 on a miss
+  void FindNearest(BVH4Packet& packet, const Primitive** prims) const;
+  ////////////////////////////////////////////////////////
   const AABox& GetExtends() const {
     return mExtends;
   }
   FixedGrid* GetFixedGrid() const {
     return mpFixedGrid;
   }
+  //! legacy 256^3 grid instead of the BVH (benchmarking), set before InitScene
+  void SetUseFixedGrid(bool bv) {
+    mUseFixedGrid = bv;
+  }
+  bool GetUseFixedGrid() const {
+    return mUseFixedGrid;
+  }
+  const BVH4& GetBvh() const {
+    return mBvh;
+  }
   void AddGeoset(const std::string& name, RgmGeoSet* pset);
   void RemoveGeoset(const std::string& name);
   const RgmGeoSet* FindGeoset(const std::string& name) const;
@@ -397,11 +416,22 @@ public:
   }
   ////////////////////////////////////////////////////////
 private:
+  ////////////////////////////////////////////////////////
+  struct AccelTriangle { // moller trumbore layout
+    fvec3 mP0;
+    fvec3 mE1;
+    fvec3 mE2;
+  };
   ////////////////////////////////////////////////////////
   orkmap<std::string, const RgmGeoSet*> mGeoSets;
   orkvector<RgmLight> mLights;
   AABox mExtends;
   FixedGrid* mpFixedGrid;
+  bool mUseFixedGrid;
+  BVH4 mBvh;
+  orkvector<const Primitive*> mBvhPrims;  // BVH order
+  orkvector<AccelTriangle> mBvhTriangles; // parallel to mBvhPrims
+  orkvector<u8> mBvhIsTriangle;           // else Primitive::Intersect
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -469,11 +499,13 @@ public:
   Scene* GetScene() {
     return mScene;
   }
-  bool
-  FindNearest(const FixedGrid* fg, const fray3& a_Ray, const float tmin, const float tmax, float& dist, const Primitive*& prim);
+  bool FindNearest(const fray3& a_Ray, float& dist, const Primitive*& prim);
   const Primitive* Raytrace(const fray3& ray, const int depth, const float rindex, fvec3& acc, float& dist);
+  void Shade(const fray3& ray, const Primitive* prim, float dist, fvec3& acc);
   void InitRender(fvec3& eye, fvec3& tgt);
   const Primitive* RenderRay(fvec3 screenpos, fvec3& acc);
+  //! primary rays for pixels [ix0,ix1)x[iy0,iy1), traced in 4x2 packets
+  int RenderTile(int ix0, int iy0, int ix1, int iy1, const Jitterer& jitter);
   bool Render(const AABox& aab, const std::string& OutputName);
   bool Bake(const AABox& bbox, const std::string& OutputName);
   int height() const {
@@ -537,7 +569,9 @@ public:
       const BakeShadowFragment& d2,
       int x3,
       int y3,
-      const BakeShadowFragment& d3);
+      const BakeShadowFragment& d3,
+      int clip_y0,
+      int clip_y1);
 
 private:
   Scene* mScene;
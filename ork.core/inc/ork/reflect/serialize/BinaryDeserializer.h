@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ork/reflect/IDeserializer.h>
+#include <ork/reflect/serialize/BinaryFormat.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+
+#include <rapidjson/document.h>
+
+#pragma GCC diagnostic pop
+
+namespace ork::reflect::serdes {
+
+struct BinaryReader;
+
+///////////////////////////////////////////////////////////////////////////////
+// BinaryDeserializer
+//  decodes a BinarySerializer stream straight into the reflected
+//  properties, walking the same node protocol as JsonDeserializer
+//  (no intermediate json document). properties are resolved per schema
+//  once : by dense id when the recorded schema hash matches the live
+//  class, by name only when it does not. strings are read from the
+//  string table, packed arrays are read in place.
+///////////////////////////////////////////////////////////////////////////////
+
+class BinaryDeserializer : public IDeserializer {
+public:
+  BinaryDeserializer(const void* data, size_t length);
+  BinaryDeserializer(const std::string& bindata);
+
+  void deserializeTop(object_ptr_t&) override;
+  node_ptr_t deserializeElement(node_ptr_t elemnode) override;
+  node_ptr_t deserializeObject(node_ptr_t) override;
+
+  size_t _numSchemaMatches    = 0;
+  size_t _numSchemaMismatches = 0;
+
+private:
+  using schemaprops_t = std::vector<const ObjectProperty*>; // by dense property id
+
+  node_ptr_t pushNode(std::string named, NodeType type) override;
+  void popNode() override;
+
+  node_ptr_t _parseRecord(node_ptr_t parentnode, BinaryReader& reader);
+  object_ptr_t _parseObjectRecord(node_ptr_t dsernode, BinaryReader& reader);
+  void _parseProperty(node_ptr_t propnode, BinaryReader& reader);
+
+  std::string _data; // owned copy, records are decoded lazily
+  size_t _rootoffset = 0;
+  std::vector<std::string> _strings;
+  std::vector<binary::ClassSchema> _schemas;
+  std::vector<schemaprops_t> _schemaprops;
+  std::stack<const ObjectProperty*> _property_stack;
+};
+
+/// decode a binary stream back to (pretty printed) json text
+std::string binaryToJson(const std::string& bindata);
+
+/// decode a binary stream into a json document
+///  string values are referenced (not copied) from strings_out,
+///  which must outlive the document
+void decodeBinary(
+    const void* data, //
+    size_t length,
+    rapidjson::Document& document_out,
+    std::vector<std::string>& strings_out,
+    std::vector<binary::ClassSchema>& schemas_out);
+
+} // namespace ork::reflect::serdes
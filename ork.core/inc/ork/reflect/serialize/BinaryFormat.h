@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ork/orktypes.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+///////////////////////////////////////////////////////////////////////////////
+// binary serdes container layout
+//
+//  magic    "ORKB"
+//  version  u32
+//  strings  varint count, { varint len, bytes }...
+//  schemas  varint count, { varint classname, u64 hash, varint numprops, { varint propname }... }...
+//  root     tagged record (see RecordTag)
+//
+//  object records reference a schema by index and address their
+//   properties by dense id (index into the schema's property list),
+//   so no property name is ever stored more than once per file.
+//  all strings (class names, keys, string leaves) go through the
+//   shared string table and are referenced by index.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::reflect::serdes::binary {
+
+static constexpr uint32_t kmagic   = 0x424b524f; // "ORKB" little endian
+static constexpr uint32_t kversion = 1;
+
+enum class RecordTag : uint8_t {
+  NIL = 0,
+  FALSE_,
+  TRUE_,
+  INT32,
+  UINT32,
+  INT64,
+  UINT64,
+  DOUBLE,
+  STRING,       // varint stringindex
+  ARRAY,        // varint count, records...
+  MAP,          // varint count, { varint keyindex, record }...
+  OBJECT,       // varint schemaindex, uuid[16], varint count, { varint propid, record }...
+  OBJECT_REF,   // uuid[16]
+  PACKED_INT32, // varint count, int32[count] (memcpy)
+  PACKED_FLOAT, // varint count, float[count] (memcpy)
+  PACKED_DOUBLE // varint count, double[count] (memcpy)
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// per-class schema: ordered property names plus a hash of
+//  (classname, propnames...). a live class whose schema hash matches
+//  the recorded hash needs no per-property name resolution.
+///////////////////////////////////////////////////////////////////////////////
+
+struct ClassSchema {
+  std::string _classname;
+  std::vector<std::string> _propnames;
+  uint64_t _hash = 0;
+  void computeHash();
+};
+
+/// schema of a registered class (including its parent classes, in serialization order)
+///  returns false if the class is not registered
+bool liveClassSchema(const std::string& classname, ClassSchema& schema_out);
+
+/// true if the data starts with the binary serdes magic
+bool isBinary(const void* data, size_t length);
+
+} // namespace ork::reflect::serdes::binary
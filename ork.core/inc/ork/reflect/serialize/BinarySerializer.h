@@ -0,0 +1,31 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ork/reflect/serialize/JsonSerializer.h>
+#include <ork/reflect/serialize/BinaryFormat.h>
+
+namespace ork::reflect::serdes {
+
+///////////////////////////////////////////////////////////////////////////////
+// BinarySerializer
+//  walks objects exactly like JsonSerializer, but output() emits
+//  the compact tagged record stream described in BinaryFormat.h
+///////////////////////////////////////////////////////////////////////////////
+
+class BinarySerializer : public JsonSerializer {
+public:
+  std::string output();
+};
+
+/// re-encode a JsonSerializer document as binary
+std::string jsonToBinary(const std::string& jsondata);
+/// encode an in memory json document as binary
+std::string encodeBinary(const rapidjson::Value& document);
+
+} // namespace ork::reflect::serdes
@@ -30,7 +30,9 @@ public:
 
   JsonDeserializer(const std::string& jsondata);
 
-private:
+protected:
+  JsonDeserializer(); // for subclasses which populate _document themselves
+
   using allocator_t = rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>*;
   node_ptr_t pushNode(std::string named, NodeType type) override;
   void popNode() override;
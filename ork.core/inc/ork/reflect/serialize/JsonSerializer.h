@@ -35,7 +35,7 @@ public:
 
   std::string output();
 
-private:
+protected:
   using allocator_t = rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>;
 
   void _serializeNamedItem(std::string name, const var_t&);
@@ -0,0 +1,32 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+///////////////////////////////////////////////////////////////////////////////
+// self contained LZ4 *block* format codec (no frame format)
+//  greedy single probe compressor - fast, not the best ratio
+//  output is decodable by any conforming LZ4 block decoder
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::lz4 {
+
+/// worst case compressed size of an input of length srclen
+size_t compressBound(size_t srclen);
+
+/// compress src into dst,
+///  returns compressed length, or 0 if it did not fit in dstcapacity
+size_t compress(const void* src, size_t srclen, void* dst, size_t dstcapacity);
+
+/// decompress src into dst, which must be exactly dstlen (the raw length)
+///  returns false on malformed input
+bool decompress(const void* src, size_t srclen, void* dst, size_t dstlen);
+
+} // namespace ork::lz4
@@ -6,6 +6,7 @@
 #include <ork/util/scanner.h>
 #include <unordered_set>
 #include <unordered_map>
+#include <memory_resource>
 #include <ork/util/crc.h>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -15,6 +16,7 @@ namespace ork {
 struct MatchAttempt;
 struct Match;
 struct MatchAttemptContext;
+struct MatchArena;
 
 struct SequenceAttempt;
 struct GroupAttempt;
@@ -59,6 +61,7 @@ using matcher_filterfn_t = std::function<bool(match_attempt_ptr_t top_match)>;
 using matcher_pair_t     = std::pair<std::string, matcher_ptr_t>;
 
 using genmatch_fn_t = std::function<match_ptr_t(match_attempt_ptr_t)>;
+using matcharena_ptr_t = std::shared_ptr<MatchArena>;
 
 //////////////////////////////////////////////////////////////
 
@@ -66,9 +69,53 @@ match_attempt_ptr_t filtered_match(matcher_ptr_t matcher, match_attempt_ptr_t th
 
 //////////////////////////////////////////////////////////////
 
+//////////////////////////////////////////////////////////////
+// bump allocator for MatchAttempt/Match nodes
+//  every node allocated during one Parser::match() call lives in
+//  the same arena. nodes hold a reference to their arena, so the
+//  whole arena is released in one shot when the last node of the
+//  parse (attempt tree, match tree or memo) goes away.
+//////////////////////////////////////////////////////////////
+
+struct MatchArena {
+  static constexpr size_t kInitialBlockSize = 64 << 10;
+  MatchArena();
+  std::pmr::monotonic_buffer_resource _resource;
+  size_t _numallocs = 0;
+  size_t _numbytes  = 0;
+};
+
+template <typename T> struct MatchArenaAllocator {
+  using value_type = T;
+  MatchArenaAllocator(matcharena_ptr_t arena)
+      : _arena(arena) {
+  }
+  template <typename U>
+  MatchArenaAllocator(const MatchArenaAllocator<U>& oth)
+      : _arena(oth._arena) {
+  }
+  T* allocate(size_t n) {
+    _arena->_numallocs++;
+    _arena->_numbytes += n * sizeof(T);
+    return static_cast<T*>(_arena->_resource.allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* p, size_t n) {
+    // monotonic, storage is reclaimed with the arena
+  }
+  template <typename U> bool operator==(const MatchArenaAllocator<U>& oth) const {
+    return _arena == oth._arena;
+  }
+  template <typename U> bool operator!=(const MatchArenaAllocator<U>& oth) const {
+    return _arena != oth._arena;
+  }
+  matcharena_ptr_t _arena;
+};
+
+//////////////////////////////////////////////////////////////
+
 struct MatchAttempt {
   matcher_ptr_t _matcher;
-  match_attempt_ptr_t _parent;
+  MatchAttempt* _parent = nullptr; // diagnostic only, first parent when memoized
   std::vector<match_attempt_ptr_t> _children;
   scannerlightview_ptr_t _view;
   svar32_t _impl;
@@ -146,6 +193,20 @@ struct Match {
   }
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// per matcher parse statistics (see Parser::_collect_stats)
+///////////////////////////////////////////////////////////////////////////////
+
+struct MatcherStats {
+  void reset() {
+    *this = MatcherStats();
+  }
+  size_t _numattempts = 0; // calls through Parser::_tryMatch
+  size_t _nummatches  = 0; // successful (including memoized)
+  size_t _nummemohits = 0; // resolved by the packrat memo
+  uint64_t _nanos     = 0; // exclusive time spent in the matcher (sub matchers not included)
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct Matcher {
@@ -161,8 +222,33 @@ struct Matcher {
   varmap::VarMap _uservars;
   uint64_t hash(scannerlightview_constptr_t slv) const; // packrat hash
   void _hash(boost::Crc64& crc_out) const;              // packrat hash
+  MatcherStats _stats;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// packrat memo key : a matcher's result depends only on the token range
+///////////////////////////////////////////////////////////////////////////////
+
+struct PackratKey {
+  const Matcher* _matcher = nullptr;
+  size_t _start           = 0;
+  size_t _end             = 0;
+  bool operator==(const PackratKey& rhs) const {
+    return (_matcher == rhs._matcher) and (_start == rhs._start) and (_end == rhs._end);
+  }
+};
+
+struct PackratKeyHasher {
+  size_t operator()(const PackratKey& key) const {
+    size_t h = std::hash<const void*>()(key._matcher);
+    h ^= (key._start * 0x9e3779b97f4a7c15ull) + (h << 6) + (h >> 2);
+    h ^= (key._end * 0xc2b2ae3d27d4eb4full) + (h << 6) + (h >> 2);
+    return h;
+  }
 };
 
+using packrat_memo_t = std::unordered_map<PackratKey, match_attempt_ptr_t, PackratKeyHasher>;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct MatchAttemptContextItem {
@@ -341,6 +427,12 @@ struct Parser {
 
   void _visitMatch(match_ptr_t m);
 
+  match_attempt_ptr_t _newMatchAttempt();
+  match_ptr_t _newMatch(match_attempt_constptr_t attempt);
+
+  void resetStats();
+  void dumpStats(size_t maxlines = 32) const;
+
   std::unordered_set<matcher_ptr_t> _matchers;
   std::unordered_map<std::string, matcher_ptr_t> _matchers_by_name;
   std::vector<match_attempt_ptr_t> _match_stack;
@@ -349,6 +441,11 @@ struct Parser {
   svar64_t _user;
   size_t _cache_misses = 0;
   size_t _cache_hits   = 0;
+  bool _packrat        = false; // memoize (matcher,range) -> attempt, opt in per parser
+  bool _collect_stats  = false; // per matcher timing, see dumpStats()
+  packrat_memo_t _packrat_memo;
+  matcharena_ptr_t _arena;
+  std::vector<uint64_t> _stats_child_nanos; // per active _tryMatch : time of its sub matchers
   bool _DEBUG_MATCH    = false;
   bool _DEBUG_INFO     = false;
   std::string _name;
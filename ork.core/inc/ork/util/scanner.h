@@ -8,6 +8,9 @@
 #pragma once
 
 #include <regex>
+#include <string_view>
+#include <unordered_set>
+#include <ork/kernel/datablock.h>
 #include <lexertl/generator.hpp>
 #include <lexertl/lookup.hpp>
 #include <lexertl/iterator.hpp>
@@ -32,10 +35,20 @@ struct Token {
   int icol;
   uint64_t _class = -1;
   std::string text;
+  size_t _offset = 0; // byte range of token within Scanner::_fxbuffer
+  size_t _length = 0;
   Token(const std::string& txt, int il, int ic)
       : iline(il)
       , icol(ic)
-      , text(txt) {
+      , text(txt)
+      , _length(txt.length()) {
+  }
+  Token(const char* txt, size_t offset, size_t length, int il, int ic)
+      : iline(il)
+      , icol(ic)
+      , text(txt, length)
+      , _offset(offset)
+      , _length(length) {
   }
 };
 
@@ -102,10 +115,19 @@ struct Scanner {
     addRule(rule, static_cast<id_t>(state));
   }
   /////////////////////////////////////////
+  /////////////////////////////////////////
+  // DFA tables are built once per grammar (hash of rules and macros),
+  //  shared across Scanner instances and persisted in the DataBlockCache
+  /////////////////////////////////////////
   void buildStateMachine();
   void scan();
   void scanString(std::string str);
   /////////////////////////////////////////
+  // tokens of an ignored class are dropped during scan(),
+  //  they are never materialized (cheaper than discardTokensOfClass)
+  /////////////////////////////////////////
+  void ignoreTokensOfClass(uint64_t tokclass);
+  /////////////////////////////////////////
   inline size_t length() const {
     return _fxbuffer.size();
   }
@@ -114,6 +136,7 @@ struct Scanner {
   }
   /////////////////////////////////////////
   const Token* token(size_t i) const;
+  std::string_view tokenView(const Token& tok) const;
   /////////////////////////////////////////
   void discardTokensOfClass(uint64_t tokclass);
   /////////////////////////////////////////
@@ -130,17 +153,23 @@ struct Scanner {
   scan_state ss;
   bool _quotedstrings = true;
 
-  using match_t = lexertl::match_results<std::string::const_iterator,id_t>;
+  using match_t = lexertl::match_results<const char*,id_t>;
   using rules_t = lexertl::basic_rules<char,char,id_t>;
   using macros_t = std::vector<std::pair<std::string,std::string>>;
   using statemachine_t = lexertl::basic_state_machine<char,id_t>;
+  using statemachine_constptr_t = std::shared_ptr<const statemachine_t>;
   using gen_t = lexertl::basic_generator<rules_t, statemachine_t>;
-  using iter_t = lexertl::iterator<std::string::const_iterator,statemachine_t,match_t>;
+  using iter_t = lexertl::iterator<const char*,statemachine_t,match_t>;
+
+  static constexpr size_t kBytesPerTokenEstimate = 4;
 
   rules_t _rules;
   macros_t _macros;
   std::vector<std::string> _str_hold;
-  statemachine_t _statemachine;
+  std::vector<std::string> _grammarkeys; // rules and macros in order, hashed by buildStateMachine()
+  uint64_t _grammarhash = 0;
+  statemachine_constptr_t _statemachine;
+  std::unordered_set<uint64_t> _ignoredclasses;
 };
 
 struct ScanViewRegex : public ScanViewFilter {
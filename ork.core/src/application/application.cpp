@@ -180,27 +180,15 @@ StringPoolContext::StringPoolContext() {
 ///////////////////////////////////////////////////////////////////////////////
 
 PoolString StringPoolContext::AddPooledString(const PieceString& string) {
-  PoolString result = FindPooledString(string);
-  if (result)
-    return result;
-
-  ResizableString copy(string);
-  const char* data = copy.c_str();
-  new (&copy) ResizableString;
-
   auto papp = StringPoolStack::top();
   OrkAssert(papp);
-
-  return papp->_stringpool.String(data);
+  // lookup first, insert on miss (the pool copies the string)
+  return papp->_stringpool.String(string);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 PoolString StringPoolContext::AddPooledLiteral(const ConstString& string) {
-  PoolString result = FindPooledString(string);
-  if (result)
-    return result;
-
   auto app = StringPoolStack::top();
   OrkAssert(app);
 
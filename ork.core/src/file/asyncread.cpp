@@ -0,0 +1,691 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/file/asyncread.h>
+#include <ork/file/fileenv.h>
+#include <ork/file/filestd.h>
+#include <ork/file/filedevpak.h>
+#include <ork/kernel/thread.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define ORK_ASYNCREAD_IO_URING
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace ork::file {
+///////////////////////////////////////////////////////////////////////////////
+
+static AsyncReadBackend _forcedBackend = AsyncReadBackend::IO_URING;
+
+///////////////////////////////////////////////////////////////////////////////
+// ReadJob : backend state for one in flight request
+///////////////////////////////////////////////////////////////////////////////
+
+struct ReadJob {
+
+  asyncreadreq_ptr_t _request;
+  AsyncReadBatch* _batch = nullptr;
+  std::string _abspath;
+  int _fd      = -1;
+  bool _direct = false;
+  uint8_t* _buffer = nullptr;            // read target
+  std::shared_ptr<const void> _aligned; // owns _buffer for direct reads into _data
+  size_t _fileoffset = 0;               // file offset of _buffer[0]
+  size_t _headskip   = 0;               // _buffer bytes in front of the requested offset
+  size_t _length     = 0;               // requested bytes (clamped to the file)
+  size_t _wanted     = 0;               // bytes to read into _buffer
+  size_t _done       = 0;               // bytes read into _buffer so far
+  struct iovec _iov;
+
+  size_t needed() const {
+    return _headskip + _length;
+  }
+  /// drop O_DIRECT for the remainder of the read
+  bool reopenBuffered() {
+    if (_fd >= 0)
+      close(_fd);
+    _direct = false;
+    _fd     = open(_abspath.c_str(), O_RDONLY | O_CLOEXEC);
+    return _fd >= 0;
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static datablock_ptr_t _sliceBlock(datablock_ptr_t block, size_t offset, size_t& length) {
+  size_t total = block->length();
+  if (offset >= total) {
+    length = 0;
+    return std::make_shared<DataBlock>();
+  }
+  if (length == 0 or (offset + length) > total)
+    length = total - offset;
+  if (offset == 0 and length == total)
+    return block;
+  auto slice = std::make_shared<DataBlock>();
+  slice->referenceExternal(block->data(offset), length, block);
+  return slice;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// completes the job and deletes it
+///////////////////////////////////////////////////////////////////////////////
+
+static void _finishJob(ReadJob* job, int error) {
+  auto req = job->_request;
+  if (job->_fd >= 0)
+    close(job->_fd);
+  req->_error  = error;
+  req->_direct = job->_direct;
+  if (error == 0) {
+    size_t avail    = (job->_done > job->_headskip) ? (job->_done - job->_headskip) : 0;
+    req->_bytesRead = std::min(avail, job->_length);
+    if (req->_destination == nullptr) {
+      if (job->_aligned) {
+        req->_data = std::make_shared<DataBlock>();
+        req->_data->referenceExternal(job->_buffer + job->_headskip, req->_bytesRead, job->_aligned);
+      } else if (req->_bytesRead < job->_length) {
+        req->_data->_storage.resize(req->_bytesRead);
+      }
+    }
+  } else {
+    req->_data = nullptr;
+  }
+  auto batch = job->_batch;
+  delete job;
+  batch->_completed(req);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// resolve device, open and size the file, choose buffered vs direct
+//  returns false if the job was completed immediately (and deleted)
+///////////////////////////////////////////////////////////////////////////////
+
+static bool _prepareJob(ReadJob* job) {
+  auto req     = job->_request;
+  auto& env    = FileEnv::GetRef();
+  auto device  = env.GetDeviceForUrl(req->_path);
+  auto deliver = [&](datablock_ptr_t block) -> bool {
+    if (block == nullptr) {
+      _finishJob(job, ENOENT);
+      return false;
+    }
+    size_t length = req->_length;
+    auto slice    = _sliceBlock(block, req->_offset, length);
+    if (req->_destination) {
+      memcpy(req->_destination, slice->data(), length);
+      slice = nullptr;
+    }
+    req->_data      = slice;
+    job->_length    = length;
+    job->_done      = length;
+    _finishJob(job, 0);
+    return false;
+  };
+  //////////////////////////////////////////
+  // pak'd : already mapped, nothing to read
+  //////////////////////////////////////////
+  if (auto as_pak = dynamic_cast<FileDevPak*>(device)) {
+    if (auto block = as_pak->loadDataBlock(req->_path))
+      return deliver(block);
+    device = as_pak->_fallback;
+  }
+  //////////////////////////////////////////
+  // non posix device : regular File read
+  //////////////////////////////////////////
+  if (nullptr == dynamic_cast<FileDevStd*>(device)) {
+    return deliver(datablockFromFileAtPath(req->_path));
+  }
+  //////////////////////////////////////////
+  job->_abspath = req->_path.toAbsolute().c_str();
+  struct stat st;
+  if (0 != stat(job->_abspath.c_str(), &st)) {
+    _finishJob(job, errno);
+    return false;
+  }
+  size_t filelen = size_t(st.st_size);
+  if (req->_offset > filelen) {
+    _finishJob(job, EINVAL);
+    return false;
+  }
+  size_t length = req->_length;
+  if (length == 0 or (req->_offset + length) > filelen)
+    length = filelen - req->_offset;
+  job->_length = length;
+  //////////////////////////////////////////
+  // direct io needs aligned offset, length and memory
+  //////////////////////////////////////////
+  bool want_direct = (length >= kDIRECT_THRESHOLD);
+  if (want_direct and req->_destination) {
+    want_direct = ((uintptr_t(req->_destination) % kDIRECT_ALIGN) == 0) //
+                  and ((req->_offset % kDIRECT_ALIGN) == 0)             //
+                  and ((length % kDIRECT_ALIGN) == 0);
+  }
+#if defined(O_DIRECT)
+  if (want_direct) {
+    job->_fd     = open(job->_abspath.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+    job->_direct = (job->_fd >= 0);
+  }
+#endif
+  if (job->_fd < 0 and not job->reopenBuffered()) {
+    _finishJob(job, errno);
+    return false;
+  }
+  //////////////////////////////////////////
+  if (req->_destination) {
+    job->_buffer     = (uint8_t*)req->_destination;
+    job->_fileoffset = req->_offset;
+    job->_wanted     = length;
+  } else if (job->_direct) {
+    job->_fileoffset = req->_offset & ~(kDIRECT_ALIGN - 1);
+    job->_headskip   = req->_offset - job->_fileoffset;
+    job->_wanted     = (job->_headskip + length + kDIRECT_ALIGN - 1) & ~(kDIRECT_ALIGN - 1);
+    job->_buffer     = (uint8_t*)aligned_alloc(kDIRECT_ALIGN, job->_wanted);
+    job->_aligned    = std::shared_ptr<const void>(job->_buffer, [](const void* p) { free((void*)p); });
+  } else {
+    req->_data       = std::make_shared<DataBlock>();
+    job->_buffer     = (uint8_t*)req->_data->allocateBlock(length);
+    job->_fileoffset = req->_offset;
+    job->_wanted     = length;
+  }
+  if (job->_wanted == 0) {
+    _finishJob(job, 0);
+    return false;
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// THREADPOOL backend
+///////////////////////////////////////////////////////////////////////////////
+
+static void _readBlocking(ReadJob* job) {
+  while (job->_done < job->needed()) {
+    ssize_t res = pread(
+        job->_fd, //
+        job->_buffer + job->_done,
+        job->_wanted - job->_done,
+        off_t(job->_fileoffset + job->_done));
+    if (res < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EINVAL and job->_direct and job->reopenBuffered())
+        continue;
+      _finishJob(job, errno);
+      return;
+    }
+    if (res == 0) // eof
+      break;
+    job->_done += size_t(res);
+    if (job->_direct and (job->_done % kDIRECT_ALIGN) and job->_done < job->needed()) {
+      if (not job->reopenBuffered()) {
+        _finishJob(job, errno);
+        return;
+      }
+    }
+  }
+  _finishJob(job, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// IO_URING backend
+//  one ring shared by all batches. submitters push sqes under _sqmutex
+//  and enter immediately (so the sq never holds stale entries), a single
+//  reaper thread owns the cq. in flight reads are capped at the sq depth,
+//  the cq is twice that so it cannot overflow.
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(ORK_ASYNCREAD_IO_URING)
+
+struct UringReader {
+
+  static constexpr unsigned kENTRIES = 256;
+
+  static UringReader* instance() {
+    static UringReader* _instance = []() -> UringReader* {
+      auto reader = new UringReader;
+      if (reader->_init())
+        return reader;
+      printf("asyncread: io_uring unavailable, using thread pool\n");
+      delete reader;
+      return nullptr;
+    }();
+    return _instance;
+  }
+
+  ////////////////////////////////////////////
+
+  bool _init() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    _ringfd = int(syscall(__NR_io_uring_setup, kENTRIES, &params));
+    if (_ringfd < 0)
+      return false;
+    size_t sqsize  = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cqsize  = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singlemap = (params.features & IORING_FEAT_SINGLE_MMAP);
+    if (singlemap)
+      sqsize = cqsize = std::max(sqsize, cqsize);
+    auto sqring = (uint8_t*)mmap(0, sqsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringfd, IORING_OFF_SQ_RING);
+    if (sqring == MAP_FAILED) {
+      close(_ringfd);
+      return false;
+    }
+    auto cqring = sqring;
+    if (not singlemap) {
+      cqring = (uint8_t*)mmap(0, cqsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringfd, IORING_OFF_CQ_RING);
+      if (cqring == MAP_FAILED) {
+        close(_ringfd);
+        return false;
+      }
+    }
+    _sqes = (io_uring_sqe*)mmap(
+        0, //
+        params.sq_entries * sizeof(io_uring_sqe),
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE,
+        _ringfd,
+        IORING_OFF_SQES);
+    if (_sqes == MAP_FAILED) {
+      close(_ringfd);
+      return false;
+    }
+    _sqhead  = (unsigned*)(sqring + params.sq_off.head);
+    _sqtail  = (unsigned*)(sqring + params.sq_off.tail);
+    _sqmask  = *(unsigned*)(sqring + params.sq_off.ring_mask);
+    _sqarray = (unsigned*)(sqring + params.sq_off.array);
+    _cqhead  = (unsigned*)(cqring + params.cq_off.head);
+    _cqtail  = (unsigned*)(cqring + params.cq_off.tail);
+    _cqmask  = *(unsigned*)(cqring + params.cq_off.ring_mask);
+    _cqes    = (io_uring_cqe*)(cqring + params.cq_off.cqes);
+    _maxinflight = std::min(params.sq_entries, params.cq_entries);
+    _reaper.start([this](anyp) { _reapLoop(); });
+    return true;
+  }
+
+  ////////////////////////////////////////////
+  // sq : caller holds _sqmutex
+  ////////////////////////////////////////////
+
+  void _pushRead(ReadJob* job) {
+    unsigned tail  = *_sqtail;
+    unsigned index = tail & _sqmask;
+    auto sqe       = _sqes + index;
+    memset(sqe, 0, sizeof(io_uring_sqe));
+    job->_iov.iov_base = job->_buffer + job->_done;
+    job->_iov.iov_len  = job->_wanted - job->_done;
+    sqe->opcode        = IORING_OP_READV;
+    sqe->fd            = job->_fd;
+    sqe->addr          = uint64_t(uintptr_t(&job->_iov));
+    sqe->len           = 1;
+    sqe->off           = uint64_t(job->_fileoffset + job->_done);
+    sqe->user_data     = uint64_t(uintptr_t(job));
+    _sqarray[index]    = index;
+    __atomic_store_n(_sqtail, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  void _enter(unsigned count) {
+    while (count) {
+      int res = int(syscall(__NR_io_uring_enter, _ringfd, count, 0, 0, nullptr, 0));
+      if (res < 0) {
+        if (errno == EINTR or errno == EAGAIN or errno == EBUSY) {
+          sched_yield();
+          continue;
+        }
+        printf("asyncread: io_uring_enter failed errno<%d>\n", errno);
+        OrkAssert(false);
+      }
+      count -= unsigned(res);
+    }
+  }
+
+  ////////////////////////////////////////////
+  // all prepared jobs go in as one submission
+  //  (split only when they exceed the free in flight slots)
+  ////////////////////////////////////////////
+
+  void submit(const std::vector<ReadJob*>& jobs) {
+    size_t index = 0;
+    while (index < jobs.size()) {
+      size_t count = 0;
+      {
+        std::unique_lock<std::mutex> lock(_slotmutex);
+        _slotcondition.wait(lock, [this]() { return _inflight < _maxinflight; });
+        count = std::min(jobs.size() - index, size_t(_maxinflight - _inflight));
+        _inflight += count;
+      }
+      std::lock_guard<std::mutex> lock(_sqmutex);
+      for (size_t i = 0; i < count; i++)
+        _pushRead(jobs[index + i]);
+      _enter(unsigned(count));
+      index += count;
+    }
+  }
+
+  ////////////////////////////////////////////
+
+  void _resubmit(ReadJob* job) {
+    std::lock_guard<std::mutex> lock(_sqmutex);
+    _pushRead(job);
+    _enter(1);
+  }
+
+  void _release(ReadJob* job, int error) {
+    _finishJob(job, error);
+    std::lock_guard<std::mutex> lock(_slotmutex);
+    _inflight--;
+    _slotcondition.notify_one();
+  }
+
+  ////////////////////////////////////////////
+
+  void _onCompletion(ReadJob* job, int res) {
+    if (res < 0) {
+      int error = -res;
+      if (error == EINTR or error == EAGAIN)
+        return _resubmit(job);
+      if (error == EINVAL and job->_direct and job->reopenBuffered())
+        return _resubmit(job);
+      return _release(job, error);
+    }
+    job->_done += size_t(res);
+    if (res == 0 or job->_done >= job->needed())
+      return _release(job, 0);
+    // short read, continue where it stopped
+    if (job->_direct and (job->_done % kDIRECT_ALIGN)) {
+      if (not job->reopenBuffered())
+        return _release(job, errno);
+    }
+    _resubmit(job);
+  }
+
+  ////////////////////////////////////////////
+
+  void _reapLoop() {
+    SetCurrentThreadName("asyncread.uring");
+    while (true) {
+      int res = int(syscall(__NR_io_uring_enter, _ringfd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+      if (res < 0 and errno != EINTR) {
+        printf("asyncread: io_uring wait failed errno<%d>\n", errno);
+        usleep(1000);
+      }
+      unsigned head = *_cqhead;
+      unsigned tail = __atomic_load_n(_cqtail, __ATOMIC_ACQUIRE);
+      while (head != tail) {
+        auto cqe = _cqes + (head & _cqmask);
+        auto job = (ReadJob*)uintptr_t(cqe->user_data);
+        int jres = cqe->res;
+        head++;
+        // hand the cqe back before completing (completion may resubmit)
+        __atomic_store_n(_cqhead, head, __ATOMIC_RELEASE);
+        _onCompletion(job, jres);
+      }
+    }
+  }
+
+  ////////////////////////////////////////////
+
+  int _ringfd = -1;
+  io_uring_sqe* _sqes = nullptr;
+  unsigned* _sqhead   = nullptr;
+  unsigned* _sqtail   = nullptr;
+  unsigned* _sqarray  = nullptr;
+  unsigned _sqmask    = 0;
+  unsigned* _cqhead   = nullptr;
+  unsigned* _cqtail   = nullptr;
+  unsigned _cqmask    = 0;
+  io_uring_cqe* _cqes = nullptr;
+  std::mutex _sqmutex;
+  std::mutex _slotmutex;
+  std::condition_variable _slotcondition;
+  unsigned _inflight    = 0;
+  unsigned _maxinflight = 0;
+  ork::Thread _reaper;
+};
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+AsyncReadBackend asyncReadBackend() {
+#if defined(ORK_ASYNCREAD_IO_URING)
+  if (_forcedBackend == AsyncReadBackend::IO_URING and UringReader::instance())
+    return AsyncReadBackend::IO_URING;
+#endif
+  return AsyncReadBackend::THREADPOOL;
+}
+
+void setAsyncReadBackend(AsyncReadBackend backend) {
+  _forcedBackend = backend;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// prepare the jobs, then hand the survivors to the backend
+//  (io_uring takes them as one submission)
+///////////////////////////////////////////////////////////////////////////////
+
+static void _issueJobs(const std::vector<ReadJob*>& jobs) {
+  std::vector<ReadJob*> prepared;
+  prepared.reserve(jobs.size());
+  for (auto job : jobs) {
+    if (_prepareJob(job))
+      prepared.push_back(job);
+  }
+  if (prepared.empty())
+    return;
+#if defined(ORK_ASYNCREAD_IO_URING)
+  if (asyncReadBackend() == AsyncReadBackend::IO_URING) {
+    UringReader::instance()->submit(prepared);
+    return;
+  }
+#endif
+  for (auto job : prepared)
+    _readBlocking(job);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// AsyncReadBatch
+///////////////////////////////////////////////////////////////////////////////
+
+AsyncReadBatch::AsyncReadBatch(opq::opq_ptr_t completion_queue)
+    : _completionQueue(completion_queue) {
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+AsyncReadBatch::~AsyncReadBatch() {
+  // in flight jobs point back at us
+  if (_submitted)
+    wait();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+asyncreadreq_ptr_t AsyncReadBatch::add(const Path& path, asyncreadcompletion_t on_complete) {
+  return add(path, 0, 0, nullptr, on_complete);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+asyncreadreq_ptr_t AsyncReadBatch::add(
+    const Path& path, //
+    size_t offset,
+    size_t length,
+    void* destination,
+    asyncreadcompletion_t on_complete) {
+  OrkAssert(not _submitted);
+  auto req          = std::make_shared<AsyncReadRequest>();
+  req->_path        = path;
+  req->_offset      = offset;
+  req->_length      = length;
+  req->_destination = destination;
+  req->_onComplete  = on_complete;
+  _requests.push_back(req);
+  return req;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AsyncReadBatch::submit() {
+  OrkAssert(not _submitted);
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _submitted  = true;
+    _numPending = _requests.size();
+  }
+  std::vector<ReadJob*> jobs;
+  jobs.reserve(_requests.size());
+  for (auto req : _requests) {
+    auto job      = new ReadJob;
+    job->_request = req;
+    job->_batch   = this;
+    jobs.push_back(job);
+  }
+  //////////////////////////////////////////
+  // inline : the caller is going to block anyway
+  //////////////////////////////////////////
+  if (nullptr == _completionQueue) {
+    _issueJobs(jobs);
+    return;
+  }
+  //////////////////////////////////////////
+  // device lookup, stat and open happen on the
+  //  backend workers, never on the submitting thread
+  //////////////////////////////////////////
+  auto pool = opq::concurrentQueue();
+#if defined(ORK_ASYNCREAD_IO_URING)
+  if (asyncReadBackend() == AsyncReadBackend::IO_URING) {
+    pool->enqueue([jobs]() { _issueJobs(jobs); }, "asyncread.prepare");
+    return;
+  }
+#endif
+  for (auto job : jobs)
+    pool->enqueue(
+        [job]() {
+          if (_prepareJob(job))
+            _readBlocking(job);
+        },
+        "asyncread");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AsyncReadBatch::_completed(asyncreadreq_ptr_t request) {
+  auto finish = [this, request]() {
+    if (request->_onComplete)
+      request->_onComplete(request);
+    // notify under the lock, a waiter may destroy the batch right after
+    std::lock_guard<std::mutex> lock(_mutex);
+    _numPending--;
+    if (_numPending == 0)
+      _condition.notify_all();
+  };
+  if (_completionQueue)
+    _completionQueue->enqueue(finish, "asyncread.completion");
+  else
+    finish();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AsyncReadBatch::wait() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _condition.wait(lock, [this]() { return _numPending == 0; });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AsyncReadBatch::submitAndWait() {
+  submit();
+  wait();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t AsyncReadBatch::numPending() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _numPending;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+datablock_ptr_t readFileDirect(const Path& path) {
+  AsyncReadBatch batch(nullptr);
+  auto req = batch.add(path);
+  batch.submitAndWait();
+  return req->ok() ? req->_data : nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// group commit : whoever finds no batch in flight becomes the leader and
+//  issues every read queued so far as one batch, reads arriving meanwhile
+//  queue up for the next one.
+///////////////////////////////////////////////////////////////////////////////
+
+struct BatchedRead {
+  Path _path;
+  datablock_ptr_t _data;
+  bool _done = false;
+};
+
+using batchedread_ptr_t = std::shared_ptr<BatchedRead>;
+
+struct SharedReadQueue {
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::vector<batchedread_ptr_t> _pending;
+  bool _inflight = false;
+};
+
+datablock_ptr_t readFileBatched(const Path& path) {
+  static SharedReadQueue _queue;
+  auto read   = std::make_shared<BatchedRead>();
+  read->_path = path;
+  std::unique_lock<std::mutex> lock(_queue._mutex);
+  _queue._pending.push_back(read);
+  while (not read->_done) {
+    if (_queue._inflight) {
+      _queue._condition.wait(lock);
+      continue;
+    }
+    _queue._inflight = true;
+    auto group       = std::move(_queue._pending);
+    _queue._pending.clear();
+    lock.unlock();
+    //////////////////////////////////////////
+    AsyncReadBatch batch(nullptr);
+    for (auto item : group)
+      batch.add(item->_path);
+    batch.submitAndWait();
+    //////////////////////////////////////////
+    lock.lock();
+    for (size_t i = 0; i < group.size(); i++) {
+      auto req        = batch._requests[i];
+      group[i]->_data = req->ok() ? req->_data : nullptr;
+      group[i]->_done = true;
+    }
+    _queue._inflight = false;
+    _queue._condition.notify_all();
+  }
+  return read->_data;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::file
+///////////////////////////////////////////////////////////////////////////////
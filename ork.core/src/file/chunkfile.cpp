@@ -9,6 +9,7 @@
 
 #include <ork/file/chunkfile.h>
 #include <ork/file/chunkfile.inl>
+#include <ork/file/asyncread.h>
 #include <ork/kernel/string/string.h>
 #include <ork/util/crc.h>
 #include <ork/math/cmatrix3.h>
@@ -329,15 +330,12 @@ Reader::Reader(const file::Path& inpath, const char* ptype, ILoadAllocator& allo
     , _allocator(allocator) {
 
   if (FileEnv::GetRef().DoesFileExist(inpath)) {
-    ork::File inputfile(inpath, ork::EFM_READ);
-    size_t length = 0;
-    inputfile.GetLength(length);
-    auto dblock = std::make_shared<DataBlock>();
-    void* dest  = dblock->allocateBlock(length);
-    inputfile.Read(dest, length);
-    inputfile.Close();
-    mbOk = readFromDataBlock(dblock);
-    OrkAssert(_chunkfiletype == std::string(ptype));
+    // large chunkfiles (models, xtx textures) go through O_DIRECT,
+    //  concurrent loads share batches
+    if (auto dblock = file::readFileBatched(inpath)) {
+      mbOk = readFromDataBlock(dblock);
+      OrkAssert(_chunkfiletype == std::string(ptype));
+    }
   }
 }
 ///////////////////////////////////////////////////////////////////////////////
@@ -10,6 +10,7 @@
 
 #include <ork/file/filedev.h>
 #include <ork/file/filestd.h>
+#include <ork/file/filedevpak.h>
 
 //#include <ork/util/crc64.h>
 #include <ork/util/crc.h>
@@ -95,6 +96,8 @@ EFileErrCode FileDev::openFile(File& rFile) {
   if (checkFileDevCaps(rFile) == EFEC_FILE_UNSUPPORTED) {
     return EFEC_FILE_UNSUPPORTED;
   }
+  if (rFile.Reading())
+    pak::recordLoad(rFile.GetFileName());
   return _doOpenFile(rFile);
 }
 
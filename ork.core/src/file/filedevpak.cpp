@@ -0,0 +1,477 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/file/filedevpak.h>
+#include <ork/file/fileenv.h>
+#include <ork/util/lz4block.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <unordered_set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace ork::pak {
+///////////////////////////////////////////////////////////////////////////////
+
+std::string normalizePath(const file::Path& path) {
+  std::string rval = path.c_str();
+  std::replace(rval.begin(), rval.end(), '\\', '/');
+  return rval;
+}
+
+uint64_t hashPath(const std::string& normalized_path) {
+  auto hasher = DataBlock::createHasher();
+  hasher->accumulateString(normalized_path);
+  hasher->finish();
+  return hasher->result();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+archive_ptr_t openArchive(const file::Path& filename) {
+  auto abspath = filename.toAbsolute();
+  int fd       = open(abspath.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+  struct stat st;
+  if (fstat(fd, &st) != 0 or size_t(st.st_size) < sizeof(Header)) {
+    close(fd);
+    return nullptr;
+  }
+  size_t length = size_t(st.st_size);
+  void* mapped  = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // mapping holds its own reference
+  if (mapped == MAP_FAILED)
+    return nullptr;
+  auto archive           = std::make_shared<Archive>();
+  archive->_filename     = abspath.c_str();
+  archive->_mapped       = (const uint8_t*)mapped;
+  archive->_mappedlength = length;
+  //////////////////////////////////////////
+  // validate
+  //////////////////////////////////////////
+  auto header = (const Header*)archive->_mapped;
+  bool valid  = (header->_magic == kMAGIC) and (header->_version == kVERSION);
+  valid       = valid and (header->_indexoffset + header->_numentries * sizeof(Entry)) <= length;
+  valid       = valid and (header->_stringsoffset + header->_stringslength) <= length;
+  if (not valid) {
+    printf("pak<%s> invalid header\n", abspath.c_str());
+    return nullptr;
+  }
+  archive->_index         = (const Entry*)(archive->_mapped + header->_indexoffset);
+  archive->_numentries    = header->_numentries;
+  archive->_strings       = (const char*)(archive->_mapped + header->_stringsoffset);
+  archive->_stringslength = header->_stringslength;
+  //////////////////////////////////////////
+  // entries are read in order, let the kernel prefetch
+  //////////////////////////////////////////
+  madvise((void*)archive->_mapped, length, MADV_WILLNEED);
+  return archive;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Archive::~Archive() {
+  if (_mapped)
+    munmap((void*)_mapped, _mappedlength);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const char* Archive::pathOf(const Entry* entry) const {
+  OrkAssert(entry->_pathoffset < _stringslength);
+  return _strings + entry->_pathoffset;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const Entry* Archive::find(const file::Path& path) const {
+  auto normalized = normalizePath(path);
+  uint64_t hash   = hashPath(normalized);
+  auto begin      = _index;
+  auto end        = _index + _numentries;
+  auto it         = std::lower_bound(begin, end, hash, [](const Entry& e, uint64_t h) { //
+    return e._pathhash < h;
+  });
+  ///////////////////////////////////
+  // resolve (unlikely) hash collisions by path
+  ///////////////////////////////////
+  for (; it != end and it->_pathhash == hash; ++it) {
+    if (normalized == pathOf(it))
+      return it;
+  }
+  return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+datablock_ptr_t Archive::load(const Entry* entry) {
+  OrkAssert((entry->_offset + entry->_size) <= _mappedlength);
+  auto rval   = std::make_shared<DataBlock>();
+  rval->_name = pathOf(entry);
+  const uint8_t* stored = _mapped + entry->_offset;
+  switch (Codec(entry->_codec)) {
+    case Codec::NONE:
+      rval->referenceExternal(stored, entry->_size, shared_from_this());
+      break;
+    case Codec::LZ4: {
+      void* dest = rval->allocateBlock(entry->_rawsize);
+      bool ok    = lz4::decompress(stored, entry->_size, dest, entry->_rawsize);
+      if (not ok) {
+        printf("pak<%s> entry<%s> corrupt lz4 data\n", _filename.c_str(), pathOf(entry));
+        return nullptr;
+      }
+      break;
+    }
+    default:
+      printf("pak<%s> entry<%s> unknown codec<%u>\n", _filename.c_str(), pathOf(entry), entry->_codec);
+      return nullptr;
+  }
+  return rval;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Writer::addEntry(const file::Path& path, datablock_constptr_t data, Codec codec) {
+  _items.push_back(Item{normalizePath(path), data, codec});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Writer::write(const std::string& filename) const {
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (not out.good())
+    return false;
+
+  auto pad = [&](size_t& cursor) {
+    static const char zeros[kALIGN] = {0};
+    size_t aligned = (cursor + kALIGN - 1) & ~(kALIGN - 1);
+    out.write(zeros, aligned - cursor);
+    cursor = aligned;
+  };
+
+  Header header;
+  out.write((const char*)&header, sizeof(Header)); // placeholder
+  size_t cursor = sizeof(Header);
+
+  std::vector<Entry> index;
+  std::string strings;
+  std::unordered_set<std::string> seen;
+
+  //////////////////////////////////////////
+  // data, in insertion (load) order
+  //////////////////////////////////////////
+  for (const auto& item : _items) {
+    if (seen.count(item._path)) {
+      printf("pak: duplicate entry<%s> ignored\n", item._path.c_str());
+      continue;
+    }
+    seen.insert(item._path);
+    pad(cursor);
+    Entry entry;
+    entry._pathhash   = hashPath(item._path);
+    entry._offset     = cursor;
+    entry._rawsize    = item._data->length();
+    entry._pathoffset = strings.length();
+    strings += item._path;
+    strings.push_back(0);
+    const uint8_t* payload = item._data->data();
+    size_t payloadsize     = item._data->length();
+    std::vector<uint8_t> compressed;
+    if (item._codec == Codec::LZ4 and payloadsize) {
+      compressed.resize(lz4::compressBound(payloadsize));
+      size_t clen = lz4::compress(payload, payloadsize, compressed.data(), compressed.size());
+      // keep only if it actually saves something
+      if (clen and clen < payloadsize) {
+        entry._codec = uint32_t(Codec::LZ4);
+        payload      = compressed.data();
+        payloadsize  = clen;
+      }
+    }
+    entry._size = payloadsize;
+    out.write((const char*)payload, payloadsize);
+    cursor += payloadsize;
+    index.push_back(entry);
+  }
+  //////////////////////////////////////////
+  // index
+  //////////////////////////////////////////
+  std::stable_sort(index.begin(), index.end(), [](const Entry& a, const Entry& b) { //
+    return a._pathhash < b._pathhash;
+  });
+  pad(cursor);
+  header._numentries  = index.size();
+  header._indexoffset = cursor;
+  out.write((const char*)index.data(), index.size() * sizeof(Entry));
+  cursor += index.size() * sizeof(Entry);
+  //////////////////////////////////////////
+  // strings
+  //////////////////////////////////////////
+  header._stringsoffset = cursor;
+  header._stringslength = strings.length();
+  out.write(strings.data(), strings.length());
+  //////////////////////////////////////////
+  out.seekp(0);
+  out.write((const char*)&header, sizeof(Header));
+  return out.good();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<bool> _recording_load_order = false;
+static ork::mutex _load_order_mutex("pak.loadorder");
+static std::vector<std::string> _load_order;
+static std::unordered_set<std::string> _load_order_seen;
+
+void beginLoadOrderRecording() {
+  _load_order_mutex.Lock();
+  _load_order.clear();
+  _load_order_seen.clear();
+  _recording_load_order = true;
+  _load_order_mutex.UnLock();
+}
+
+std::vector<std::string> endLoadOrderRecording() {
+  _load_order_mutex.Lock();
+  _recording_load_order = false;
+  auto rval             = _load_order;
+  _load_order.clear();
+  _load_order_seen.clear();
+  _load_order_mutex.UnLock();
+  return rval;
+}
+
+void recordLoad(const file::Path& path) {
+  if (not _recording_load_order)
+    return;
+  auto normalized = normalizePath(path);
+  _load_order_mutex.Lock();
+  if (_load_order_seen.insert(normalized).second)
+    _load_order.push_back(normalized);
+  _load_order_mutex.UnLock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::pak
+///////////////////////////////////////////////////////////////////////////////
+namespace ork {
+///////////////////////////////////////////////////////////////////////////////
+
+FileDevPak::FileDevPak(FileDev* fallback)
+    : FileDev("pak", "/", EFDF_CAN_READ | EFDF_CAN_WRITE)
+    , _fallback(fallback)
+    , _mutex("FileDevPak") {
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FileDevPak::mount(pak::archive_ptr_t archive) {
+  OrkAssert(archive);
+  _mutex.Lock();
+  _mounts.push_back(archive);
+  _mutex.UnLock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool FileDevPak::unmount(pak::archive_ptr_t archive) {
+  _mutex.Lock();
+  auto it    = std::find(_mounts.begin(), _mounts.end(), archive);
+  bool found = (it != _mounts.end());
+  if (found)
+    _mounts.erase(it);
+  _mutex.UnLock();
+  return found;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FileDevPak::Lookup FileDevPak::_find(const file::Path& path) {
+  Lookup rval;
+  _mutex.Lock();
+  for (auto it = _mounts.rbegin(); it != _mounts.rend(); ++it) { // newest first
+    if (auto entry = (*it)->find(path)) {
+      rval._archive = *it;
+      rval._entry   = entry;
+      break;
+    }
+  }
+  _mutex.UnLock();
+  return rval;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+datablock_ptr_t FileDevPak::loadDataBlock(const file::Path& path) {
+  auto lookup = _find(path);
+  if (nullptr == lookup._entry)
+    return nullptr;
+  pak::recordLoad(path);
+  return lookup._archive->load(lookup._entry);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FileDevPak* FileDevPak::installForUriProto(const std::string& uriproto) {
+  auto& env = FileEnv::GetRef();
+  auto it   = env.uriRegistry().find(uriproto);
+  if (it == env.uriRegistry().end())
+    return nullptr;
+  auto context = it->second;
+  auto prevdev = context->GetFileDevice();
+  if (nullptr == prevdev)
+    prevdev = env.GetDefaultDevice();
+  if (auto as_pak = dynamic_cast<FileDevPak*>(prevdev))
+    return as_pak;
+  auto pakdev = new FileDevPak(prevdev);
+  context->SetFileDevice(pakdev);
+  return pakdev;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EFileErrCode FileDevPak::_doOpenFile(File& rFile) {
+  auto lookup = rFile.Reading() ? _find(rFile.GetFileName()) : Lookup();
+  if (lookup._entry) {
+    auto data = lookup._archive->load(lookup._entry);
+    if (nullptr == data)
+      return EFEC_FILE_UNKNOWN;
+    auto openfile   = new OpenPakFile;
+    openfile->_data = data;
+    rFile.mHandle   = reinterpret_cast<FileH>(openfile);
+    rFile.miFileLen = data->length();
+    rFile.SetUserPos(0);
+    rFile.SetPhysicalPos(0);
+    return EFEC_FILE_OK;
+  }
+  //////////////////////////////////////////
+  // not in a pak (or writing): hand the file over to the fallback device
+  //////////////////////////////////////////
+  if (nullptr == _fallback)
+    return EFEC_FILE_DOES_NOT_EXIST;
+  rFile.mpDevice = _fallback;
+  return _fallback->openFile(rFile);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EFileErrCode FileDevPak::_doCloseFile(File& rFile) {
+  OrkAssert(rFile.IsOpen());
+  auto openfile = reinterpret_cast<OpenPakFile*>(rFile.mHandle);
+  delete openfile;
+  rFile.mHandle   = 0;
+  rFile.miFileLen = 0;
+  return EFEC_FILE_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EFileErrCode FileDevPak::_doRead(File& rFile, void* pTo, size_t icount, size_t& iactualread) {
+  OrkAssert(rFile.IsOpen());
+  OrkAssert(pTo);
+  auto openfile    = reinterpret_cast<OpenPakFile*>(rFile.mHandle);
+  size_t iphyspos  = rFile.GetPhysicalPos();
+  size_t ifilelen  = openfile->_data->length();
+  size_t iphysleft = ifilelen - iphyspos;
+  iactualread      = (icount <= iphysleft) ? icount : iphysleft;
+  memcpy(pTo, openfile->_data->data(iphyspos), iactualread);
+  if (iactualread < icount) // read past end of file, so terminate read buffer with 0's
+    memset(((U8*)pTo) + iactualread, 0, icount - iactualread);
+  rFile.SetPhysicalPos(iphyspos + iactualread);
+  if (_watcher)
+    _watcher->Reading(&rFile, iactualread);
+  return EFEC_FILE_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EFileErrCode FileDevPak::_doSeekFromStart(File& rFile, size_t iTo) {
+  OrkAssert(rFile.IsOpen());
+  if (iTo > rFile.miFileLen)
+    return EFEC_FILE_INVALID_SIZE;
+  rFile.SetPhysicalPos(iTo);
+  return EFEC_FILE_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EFileErrCode FileDevPak::_doSeekFromCurrent(File& rFile, size_t iOffset) {
+  OrkAssert(rFile.IsOpen());
+  size_t inext = rFile.GetPhysicalPos() + iOffset;
+  if (inext > rFile.miFileLen)
+    return EFEC_FILE_INVALID_SIZE;
+  rFile.SetPhysicalPos(inext);
+  return EFEC_FILE_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EFileErrCode FileDevPak::_doGetLength(File& rFile, size_t& riLength) {
+  auto lookup = _find(rFile.GetFileName());
+  if (lookup._entry) {
+    riLength = lookup._entry->_rawsize;
+    return EFEC_FILE_OK;
+  }
+  if (_fallback)
+    return _fallback->getLength(rFile, riLength);
+  return EFEC_FILE_DOES_NOT_EXIST;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EFileErrCode FileDevPak::write(File& rFile, const void* pFrom, size_t iSize) {
+  // writes are redirected to the fallback device at open time
+  return EFEC_FILE_UNSUPPORTED;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EFileErrCode FileDevPak::getCurrentDirectory(file::Path::NameType& directory) {
+  if (_fallback)
+    return _fallback->getCurrentDirectory(directory);
+  directory = "/";
+  return EFEC_FILE_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EFileErrCode FileDevPak::setCurrentDirectory(const file::Path::NameType& directory) {
+  if (_fallback)
+    return _fallback->setCurrentDirectory(directory);
+  return EFEC_FILE_UNSUPPORTED;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool FileDevPak::doesFileExist(const file::Path& filespec) {
+  if (_find(filespec)._entry)
+    return true;
+  return _fallback ? _fallback->doesFileExist(filespec) : false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool FileDevPak::doesDirectoryExist(const file::Path& filespec) {
+  return _fallback ? _fallback->doesDirectoryExist(filespec) : false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool FileDevPak::isFileWritable(const file::Path& filespec) {
+  if (_find(filespec)._entry)
+    return false;
+  return _fallback ? _fallback->isFileWritable(filespec) : false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork
+///////////////////////////////////////////////////////////////////////////////
@@ -12,6 +12,7 @@
 #include <ork/orkstd.h> // For OrkAssert
 
 #include <ork/file/filestd.h>
+#include <ork/file/filedevpak.h>
 #include <unistd.h>
 #include <ork/kernel/datablock.h>
 
@@ -20,6 +21,16 @@ namespace ork {
 datablock_ptr_t datablockFromFileAtPath(const file::Path& path) {
 
   datablock_ptr_t rval = nullptr;
+  //////////////////////////////////////////
+  // zero copy path for pak'd files
+  //////////////////////////////////////////
+  auto device = FileEnv::GetRef().GetDeviceForUrl(path);
+  if (auto as_pak = dynamic_cast<FileDevPak*>(device)) {
+    rval = as_pak->loadDataBlock(path);
+    if (rval)
+      return rval;
+  }
+  //////////////////////////////////////////
   if (FileEnv::GetRef().DoesFileExist(path)) {
     ork::File inputfile(path, ork::EFM_READ);
     size_t length = 0;
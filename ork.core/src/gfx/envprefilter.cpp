@@ -0,0 +1,463 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/gfx/envprefilter.h>
+#include <ork/gfx/brdf.inl>
+#include <ork/kernel/opq.h>
+#include <cmath>
+
+namespace ork::envprefilter {
+
+static constexpr float kPI     = 3.14159265358979f;
+static constexpr float kINVPI  = 1.0f / kPI;
+static constexpr int kBLOCK    = 16; // samples per simd block
+static constexpr int kMAXLEVEL = 16;
+
+///////////////////////////////////////////////////////////////////////////////
+// branch free approximations (no libm calls but sqrt, selects as arithmetic),
+//  so the sample blocks vectorize (needs -fno-math-errno, see CMakeLists.txt)
+//  atan2 : |err| < 1e-5 rad, acos : |err| < 2e-7 rad (A&S 4.4.46)
+///////////////////////////////////////////////////////////////////////////////
+
+static inline float _atan2(float y, float x) {
+  float ax   = fabsf(x);
+  float ay   = fabsf(y);
+  float mx   = ax > ay ? ax : ay;
+  float mn   = ax > ay ? ay : ax;
+  float a    = mn / (mx + 1.0e-30f);
+  float s    = a * a;
+  float r    = ((((-0.0117212f * s + 0.05265332f) * s - 0.11643287f) * s + 0.19354346f) * s - 0.33262347f) * s * a + 0.99997726f * a;
+  float swap = float(ay > ax);
+  r          = r + swap * (1.57079637f - 2.0f * r);
+  float neg  = float(x < 0.0f);
+  r          = r + neg * (3.14159274f - 2.0f * r);
+  return copysignf(r, y);
+}
+
+static inline float _acos(float x) {
+  float ax  = fabsf(x);
+  ax        = ax < 1.0f ? ax : 1.0f;
+  float p   = -0.0012624911f;
+  p         = p * ax + 0.0066700901f;
+  p         = p * ax - 0.0170881256f;
+  p         = p * ax + 0.0308918810f;
+  p         = p * ax - 0.0501743046f;
+  p         = p * ax + 0.0889789874f;
+  p         = p * ax - 0.2145988016f;
+  p         = p * ax + 1.5707963050f;
+  float r   = sqrtf(1.0f - ax) * p;
+  float neg = float(x < 0.0f);
+  return r + neg * (kPI - 2.0f * r);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EnvImage::EnvImage(int w, int h)
+    : _width(w)
+    , _height(h) {
+  _texels.resize(size_t(w) * size_t(h));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+fvec3 EnvImage::sampleBilinear(float u, float v) const {
+  float fx = u * float(_width) - 0.5f;
+  float fy = v * float(_height) - 0.5f;
+  float x0 = floorf(fx);
+  float y0 = floorf(fy);
+  float tx = fx - x0;
+  float ty = fy - y0;
+  int ix0  = int(x0) % _width;
+  ix0      = (ix0 < 0) ? ix0 + _width : ix0;
+  int ix1  = (ix0 + 1 == _width) ? 0 : ix0 + 1;
+  int iy0  = std::clamp(int(y0), 0, _height - 1);
+  int iy1  = std::clamp(int(y0) + 1, 0, _height - 1);
+  const auto& a = texel(ix0, iy0);
+  const auto& b = texel(ix1, iy0);
+  const auto& c = texel(ix0, iy1);
+  const auto& d = texel(ix1, iy1);
+  float wa      = (1.0f - tx) * (1.0f - ty);
+  float wb      = tx * (1.0f - ty);
+  float wc      = (1.0f - tx) * ty;
+  float wd      = tx * ty;
+  return fvec3(
+      a.x * wa + b.x * wb + c.x * wc + d.x * wd, //
+      a.y * wa + b.y * wb + c.y * wc + d.y * wd,
+      a.z * wa + b.z * wb + c.z * wc + d.z * wd);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+fvec3 texelDirection(float u, float v) {
+  float phi   = u * 2.0f * kPI - kPI;
+  float theta = v * kPI;
+  float st    = sinf(theta);
+  return fvec3(st * cosf(phi), cosf(theta), st * sinf(phi));
+}
+
+fvec3 sourceDirection(float u, float v, bool zpole) {
+  fvec3 d = texelDirection(u, v);
+  return zpole ? fvec3(d.x, d.z, d.y) : d;
+}
+
+fvec2 sourceUV(const fvec3& dir, bool zpole) {
+  float py = zpole ? dir.z : dir.y; // pole
+  float pz = zpole ? dir.y : dir.z;
+  return fvec2((_atan2(pz, dir.x) * kINVPI + 1.0f) * 0.5f, _acos(py) * kINVPI);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void _evalSH9(const fvec3& d, float* y) {
+  y[0] = 0.282095f;
+  y[1] = 0.488603f * d.y;
+  y[2] = 0.488603f * d.z;
+  y[3] = 0.488603f * d.x;
+  y[4] = 1.092548f * d.x * d.y;
+  y[5] = 1.092548f * d.y * d.z;
+  y[6] = 0.315392f * (3.0f * d.z * d.z - 1.0f);
+  y[7] = 1.092548f * d.x * d.z;
+  y[8] = 0.546274f * (d.x * d.x - d.y * d.y);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void projectSH9(const EnvImage& src, bool zpole, fvec3* out) {
+  const int w       = src._width;
+  const int h       = src._height;
+  const int rows    = 8;
+  const int ntiles  = (h + rows - 1) / rows;
+  const double dphi = 2.0 * double(kPI) / double(w);
+  const double dth  = double(kPI) / double(h);
+  // per tile partial sums, reduced in tile order (result independent of scheduling)
+  std::vector<double> partials(size_t(ntiles) * 27, 0.0);
+  auto group = opq::createCompletionGroup(opq::concurrentQueue(), "ENVSH9");
+  for (int tile = 0; tile < ntiles; tile++) {
+    group->enqueue([&, tile]() {
+      double* acc = partials.data() + tile * 27;
+      int yend    = std::min(h, (tile + 1) * rows);
+      float y9[9];
+      for (int iy = tile * rows; iy < yend; iy++) {
+        float v       = (float(iy) + 0.5f) / float(h);
+        double domega = dphi * dth * sin(double(v) * double(kPI));
+        for (int ix = 0; ix < w; ix++) {
+          float u         = (float(ix) + 0.5f) / float(w);
+          const auto& tex = src.texel(ix, iy);
+          _evalSH9(sourceDirection(u, v, zpole), y9);
+          for (int c = 0; c < 9; c++) {
+            double k = double(y9[c]) * domega;
+            acc[c * 3 + 0] += double(tex.x) * k;
+            acc[c * 3 + 1] += double(tex.y) * k;
+            acc[c * 3 + 2] += double(tex.z) * k;
+          }
+        }
+      }
+    });
+  }
+  group->join();
+  double sum[27] = {0.0};
+  for (int tile = 0; tile < ntiles; tile++)
+    for (int i = 0; i < 27; i++)
+      sum[i] += partials[tile * 27 + i];
+  for (int c = 0; c < 9; c++)
+    out[c] = fvec3(float(sum[c * 3 + 0]), float(sum[c * 3 + 1]), float(sum[c * 3 + 2]));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Ramamoorthi & Hanrahan : E(n) = sum A_l L_lm Y_lm(n),
+//  A0 = pi, A1 = 2pi/3, A2 = pi/4 (divided by pi here)
+///////////////////////////////////////////////////////////////////////////////
+
+fvec3 irradianceSH9(const fvec3* sh9, const fvec3& n) {
+  static constexpr float kband[9] = {1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f};
+  float y9[9];
+  _evalSH9(n, y9);
+  fvec3 rval(0, 0, 0);
+  for (int c = 0; c < 9; c++) {
+    float k = kband[c] * y9[c];
+    rval.x += sh9[c].x * k;
+    rval.y += sh9[c].y * k;
+    rval.z += sh9[c].z * k;
+  }
+  return fvec3(std::max(rval.x, 0.0f), std::max(rval.y, 0.0f), std::max(rval.z, 0.0f));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EnvImage downsample(const EnvImage& src) {
+  EnvImage dst(std::max(src._width >> 1, 1), std::max(src._height >> 1, 1));
+  for (int y = 0; y < dst._height; y++) {
+    int y0 = std::min(y * 2, src._height - 1);
+    int y1 = std::min(y * 2 + 1, src._height - 1);
+    for (int x = 0; x < dst._width; x++) {
+      int x0        = std::min(x * 2, src._width - 1);
+      int x1        = std::min(x * 2 + 1, src._width - 1);
+      const auto& a = src.texel(x0, y0);
+      const auto& b = src.texel(x1, y0);
+      const auto& c = src.texel(x0, y1);
+      const auto& d = src.texel(x1, y1);
+      dst.texel(x, y) = fvec4(
+          (a.x + b.x + c.x + d.x) * 0.25f, //
+          (a.y + b.y + c.y + d.y) * 0.25f,
+          (a.z + b.z + c.z + d.z) * 0.25f,
+          (a.w + b.w + c.w + d.w) * 0.25f);
+    }
+  }
+  return dst;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int numSpecularLevels(int w, int h) {
+  int count = 0;
+  while (w > 4 and h > 4) {
+    w >>= 1;
+    h >>= 1;
+    count++;
+  }
+  return std::max(count, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// GGX lobe samples of one level, in tangent space (n = v = +z),
+//  SoA and padded to whole blocks (padding has zero weight)
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct LobeSamples {
+
+  LobeSamples(float roughness, int numsamples, float texelsolidangle, int maxlod) {
+    float alpha  = roughness * roughness;
+    float alpha2 = alpha * alpha;
+    for (int i = 0; i < numsamples; i++) {
+      dvec2 e     = brdf::hammersley(i, numsamples);
+      dvec3 h     = brdf::importanceSampleGGX(e, roughness);
+      float ndoth = float(h.z);
+      float lz    = 2.0f * ndoth * ndoth - 1.0f;
+      if (lz <= 0.0f)
+        continue;
+      // pdf(l) = D(h) * ndoth / (4 vdoth), with v = n
+      float dd          = (alpha2 - 1.0f) * ndoth * ndoth + 1.0f;
+      float pdf         = alpha2 / (kPI * dd * dd) * 0.25f;
+      float samplesolid = 1.0f / (float(numsamples) * pdf + 1.0e-6f);
+      float lod         = 0.5f * log2f(samplesolid / texelsolidangle) + 1.0f;
+      _lx.push_back(2.0f * ndoth * float(h.x));
+      _ly.push_back(2.0f * ndoth * float(h.y));
+      _lz.push_back(lz);
+      _weight.push_back(lz);
+      _lod.push_back(std::clamp(lod, 0.0f, float(maxlod)));
+    }
+    while (_lx.size() % kBLOCK) {
+      _lx.push_back(0.0f);
+      _ly.push_back(0.0f);
+      _lz.push_back(1.0f);
+      _weight.push_back(0.0f);
+      _lod.push_back(0.0f);
+    }
+  }
+  size_t size() const {
+    return _lx.size();
+  }
+
+  std::vector<float> _lx, _ly, _lz, _weight, _lod;
+};
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+// rotate one block of tangent space directions to world (unit length in,
+//  so no normalize) and map them to source uvs : straight line code, simd
+static void _blockToUV(
+    const float* __restrict lx,
+    const float* __restrict ly,
+    const float* __restrict lz,
+    const float* rx,
+    const float* ry,
+    const float* rz,
+    float* __restrict us,
+    float* __restrict vs) {
+  const float rx0 = rx[0], rx1 = rx[1], rx2 = rx[2];
+  const float ry0 = ry[0], ry1 = ry[1], ry2 = ry[2];
+  const float rz0 = rz[0], rz1 = rz[1], rz2 = rz[2];
+  for (int k = 0; k < kBLOCK; k++) {
+    float dx = lx[k] * rx0 + ly[k] * rx1 + lz[k] * rx2;
+    float dp = lx[k] * ry0 + ly[k] * ry1 + lz[k] * ry2;
+    float dz = lx[k] * rz0 + ly[k] * rz1 + lz[k] * rz2;
+    us[k]    = (_atan2(dz, dx) * kINVPI + 1.0f) * 0.5f;
+    vs[k]    = _acos(dp) * kINVPI;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void _filterRows(
+    const std::vector<EnvImage>& pyramid, //
+    const LobeSamples& lobe,
+    bool zpole,
+    EnvImage& dst,
+    int ybeg,
+    int yend) {
+
+  const int w      = dst._width;
+  const int h      = dst._height;
+  const size_t cnt = lobe.size();
+  const int maxlod = int(pyramid.size()) - 1;
+  alignas(64) float us[kBLOCK];
+  alignas(64) float vs[kBLOCK];
+
+  for (int iy = ybeg; iy < yend; iy++) {
+    float v = (float(iy) + 0.5f) / float(h);
+    for (int ix = 0; ix < w; ix++) {
+      float u = (float(ix) + 0.5f) / float(w);
+      fvec3 n = texelDirection(u, v);
+      // tangent frame around n
+      fvec3 up = (fabsf(n.y) < 0.999f) ? fvec3(0, 1, 0) : fvec3(1, 0, 0);
+      fvec3 t  = up.crossWith(n).normalized();
+      fvec3 b  = n.crossWith(t);
+      // rows of the tangent->world rotation, pole row picked up front
+      const float rx[3] = {t.x, b.x, n.x};
+      const float ry[3] = {zpole ? t.z : t.y, zpole ? b.z : b.y, zpole ? n.z : n.y};
+      const float rz[3] = {zpole ? t.y : t.z, zpole ? b.y : b.z, zpole ? n.y : n.z};
+      float accr = 0.0f, accg = 0.0f, accb = 0.0f, accw = 0.0f;
+      for (size_t base = 0; base < cnt; base += kBLOCK) {
+        _blockToUV(lobe._lx.data() + base, lobe._ly.data() + base, lobe._lz.data() + base, rx, ry, rz, us, vs);
+        // fetch : trilinear from the source pyramid
+        for (int k = 0; k < kBLOCK; k++) {
+          float wgt = lobe._weight[base + k];
+          if (wgt <= 0.0f)
+            continue;
+          float lod = lobe._lod[base + k];
+          int l0    = std::min(int(lod), maxlod);
+          int l1    = std::min(l0 + 1, maxlod);
+          float lt  = lod - float(l0);
+          fvec3 c0  = pyramid[l0].sampleBilinear(us[k], vs[k]);
+          fvec3 c1  = pyramid[l1].sampleBilinear(us[k], vs[k]);
+          accr += (c0.x + (c1.x - c0.x) * lt) * wgt;
+          accg += (c0.y + (c1.y - c0.y) * lt) * wgt;
+          accb += (c0.z + (c1.z - c0.z) * lt) * wgt;
+          accw += wgt;
+        }
+      }
+      float inv         = (accw > 0.0f) ? 1.0f / accw : 0.0f;
+      dst.texel(ix, iy) = fvec4(accr * inv, accg * inv, accb * inv, 1.0f);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<EnvImage> specularChain(const EnvImage& src, const Params& params) {
+  const int numlevels = numSpecularLevels(src._width, src._height);
+  std::vector<EnvImage> levels;
+  int w = src._width;
+  int h = src._height;
+  for (int l = 0; l < numlevels; l++) {
+    levels.emplace_back(w, h);
+    w = std::max(w >> 1, 1);
+    h = std::max(h >> 1, 1);
+  }
+
+  ////////////////////////////////////
+  // level 0 (mirror) : the source, re-oriented if needed
+  ////////////////////////////////////
+
+  if (not params._sourceZPole) {
+    levels[0] = src;
+  } else {
+    auto& dst = levels[0];
+    for (int iy = 0; iy < dst._height; iy++) {
+      float v = (float(iy) + 0.5f) / float(dst._height);
+      for (int ix = 0; ix < dst._width; ix++) {
+        fvec2 uv          = sourceUV(texelDirection((float(ix) + 0.5f) / float(dst._width), v), true);
+        dst.texel(ix, iy) = fvec4(src.sampleBilinear(uv.x, uv.y), 1.0f);
+      }
+    }
+  }
+  if (numlevels == 1)
+    return levels;
+
+  ////////////////////////////////////
+  // source pyramid for filtered importance sampling
+  ////////////////////////////////////
+
+  std::vector<EnvImage> pyramid;
+  pyramid.push_back(src);
+  while (pyramid.size() < kMAXLEVEL and (pyramid.back()._width > 1 or pyramid.back()._height > 1))
+    pyramid.push_back(downsample(pyramid.back()));
+  float texelsolid = 4.0f * kPI / (float(src._width) * float(src._height));
+
+  std::vector<LobeSamples> lobes;
+  for (int l = 1; l < numlevels; l++) {
+    float roughness = float(l) / float(numlevels - 1);
+    lobes.emplace_back(roughness, params._specularSamples, texelsolid, int(pyramid.size()) - 1);
+  }
+
+  ////////////////////////////////////
+  // every (level,tile) is one job
+  ////////////////////////////////////
+
+  auto group = opq::createCompletionGroup(opq::concurrentQueue(), "ENVGGX");
+  for (int l = 1; l < numlevels; l++) {
+    auto& dst      = levels[l];
+    const auto& lb = lobes[l - 1];
+    for (int y = 0; y < dst._height; y += params._rowsPerTile) {
+      int yend = std::min(dst._height, y + params._rowsPerTile);
+      group->enqueue([&pyramid, &lb, &dst, &params, y, yend]() { //
+        _filterRows(pyramid, lb, params._sourceZPole, dst, y, yend);
+      });
+    }
+  }
+  group->join();
+  return levels;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<EnvImage> diffuseChain(const fvec3* sh9, int w, int h, const Params& params) {
+  std::vector<EnvImage> levels;
+  while (w >= 1 and h >= 1) {
+    levels.emplace_back(w, h);
+    w >>= 1;
+    h >>= 1;
+  }
+  auto group = opq::createCompletionGroup(opq::concurrentQueue(), "ENVDIFF");
+  for (auto& level : levels) {
+    for (int y = 0; y < level._height; y += params._rowsPerTile) {
+      int yend = std::min(level._height, y + params._rowsPerTile);
+      group->enqueue([&level, sh9, &params, y, yend]() {
+        for (int iy = y; iy < yend; iy++) {
+          float v = (float(iy) + 0.5f) / float(level._height);
+          for (int ix = 0; ix < level._width; ix++) {
+            fvec3 n = texelDirection((float(ix) + 0.5f) / float(level._width), v);
+            if (params._diffuseFlipYZ)
+              n = fvec3(n.x, -n.y, -n.z);
+            level.texel(ix, iy) = fvec4(irradianceSH9(sh9, n), 1.0f);
+          }
+        }
+      });
+    }
+  }
+  group->join();
+  return levels;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Result prefilter(const EnvImage& src, const Params& params) {
+  Result rval;
+  projectSH9(src, params._sourceZPole, rval._sh9);
+  rval._specularLevels = specularChain(src, params);
+  int dw               = std::min(params._diffuseWidth, src._width);
+  int dh               = std::max(std::min(dw / 2, src._height), 1);
+  rval._diffuseLevels  = diffuseChain(rval._sh9, dw, dh, params);
+  return rval;
+}
+
+} // namespace ork::envprefilter
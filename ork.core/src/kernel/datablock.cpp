@@ -15,7 +15,7 @@ namespace ork {
 std::string dblock_to_str(datablock_ptr_t db){
     if(db==nullptr)
         return "";
-  std::string rval = FormatString("dblock[len<%d>]",db->_storage.size());
+  std::string rval = FormatString("dblock[len<%d>]",int(db->length()));
   return rval;
 }
 ///////////////////////////////////////////////////////////////////////////////
@@ -38,14 +38,15 @@ datablock_ptr_t DefaultEncryptionCodec::encrypt(const DataBlock* inp) {
   auto rval = std::make_shared<DataBlock>();
   rval->_name = inp->_name;
   rval->_vars = inp->_vars;
-  size_t size = inp->_storage.size();
+  size_t size = inp->length();
   rval->_storage.reserve(size+4);
   auto encmagic = Char4("oems");
   auto data = (uint8_t*) encmagic.mCharMems;
   rval->addItem<uint32_t>(encmagic.muVal32);
   rval->addItem<uint32_t>("default_encryption"_crcu);
   uint32_t counter = (5<<0)|(1<<8)|(11<<16);
-  for (uint8_t byte : inp->_storage) {
+  for (size_t i = 0; i < size; i++) {
+    uint8_t byte = *inp->data(i);
     byte += (counter&0xff);
     rval->_storage.push_back(byte);
     counter++;
@@ -57,10 +58,11 @@ datablock_ptr_t DefaultEncryptionCodec::decrypt(const DataBlock* inp) {
   auto rval = std::make_shared<DataBlock>();
   rval->_name = inp->_name;
   rval->_vars = inp->_vars;
-  size_t size = inp->_storage.size();
+  size_t size = inp->length();
   rval->_storage.reserve(size);
   uint32_t counter = (5<<0)|(1<<8)|(11<<16);
-  for (uint8_t byte : inp->_storage) {
+  for (size_t i = 0; i < size; i++) {
+    uint8_t byte = *inp->data(i);
     byte -= (counter&0xff);
     rval->_storage.push_back(byte);
     counter++;
@@ -89,12 +91,32 @@ datablock_ptr_t DataBlock::decrypt(encryptioncodec_ptr_t codec) const {
 }
 ///////////////////////////////////////////////////////////////////////////////
 const uint8_t* DataBlock::data(size_t index) const {
+  if (_external)
+    return _external + index;
   return (const uint8_t*)_storage.data() + index;
 }
 ///////////////////////////////////////////////////////////////////////////////
+void DataBlock::referenceExternal(const void* data, size_t length, std::shared_ptr<const void> owner) {
+  _storage.clear();
+  _external       = (const uint8_t*)data;
+  _externalLength = length;
+  _externalOwner  = owner;
+}
+///////////////////////////////////////////////////////////////////////////////
+void DataBlock::materialize() {
+  if (nullptr == _external)
+    return;
+  _storage.assign(_external, _external + _externalLength);
+  _external       = nullptr;
+  _externalLength = 0;
+  _externalOwner  = nullptr;
+}
+///////////////////////////////////////////////////////////////////////////////
 bool DataBlock::is_ascii() const {
-  for( uint8_t byte : _storage ){
-    if( byte>=128 )
+  auto bytes = data();
+  size_t len = length();
+  for( size_t i=0; i<len; i++ ){
+    if( bytes[i]>=128 )
       return false;
   }
   return true;
@@ -107,7 +129,10 @@ bool DataBlock::is_likely_json() const {
     char prevChar = 0;
     char ch;
 
-    for( auto ch : _storage ) {
+    auto bytes = data();
+    size_t len = length();
+    for( size_t i=0; i<len; i++ ) {
+        ch = char(bytes[i]);
         // Skip characters within quotes
         if (ch == '"' && prevChar != '\\') {
             inQuote = !inQuote;
@@ -138,18 +163,23 @@ bool DataBlock::is_likely_json() const {
     return brackets.empty();
 }
 void DataBlock::zeroExtend(){
+  materialize();
   _storage.push_back(0);
 }
 ///////////////////////////////////////////////////////////////////////////////
 void DataBlock::reserve(size_t len) {
+  materialize();
   _storage.reserve(len);
 }
 ///////////////////////////////////////////////////////////////////////////////
 size_t DataBlock::length() const {
+  if (_external)
+    return _externalLength;
   return _storage.size();
 }
 ///////////////////////////////////////////////////////////////////////////////
 void* DataBlock::allocateBlock(size_t length) {
+  materialize();
   size_t prev_length = _storage.size();
   _storage.resize(prev_length + length);
   auto cursor = _storage.data() + prev_length;
@@ -161,6 +191,7 @@ void DataBlock::addData(const void* ptr, size_t length) {
 }
 ///////////////////////////////////////////////////////////////////////////////
 bool DataBlock::_append(const unsigned char* buffer, size_t bufmax) {
+  materialize();
   if (bufmax != 0)
     _storage.insert(_storage.end(), buffer, buffer + bufmax);
   return true;
@@ -170,14 +201,14 @@ uint64_t DataBlock::hash() const {
   XXH64HASH xxh;
   xxh.init();
   xxh.accumulateString(_name);                      // identifier
-  xxh.accumulate(_storage.data(), _storage.size()); // data content
+  xxh.accumulate(data(), length()); // data content
   xxh.finish();
   return xxh.result();
 }
 ///////////////////////////////////////////////////////////////////////////////
 void DataBlock::accumlateHash(hasher_t hasher) const {
   hasher->accumulateString(_name);                      // identifier
-  hasher->accumulate(_storage.data(), _storage.size()); // data content
+  hasher->accumulate(data(), length()); // data content
 }
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -192,7 +223,7 @@ const void* DataBlockInputStream::data(size_t idx) const {
   return (const void*)(_datablock->data(idx));
 }
 size_t DataBlockInputStream::length() const {
-  return _datablock->_storage.size();
+  return _datablock->length();
 }
 void DataBlockInputStream::advance(size_t l) {
   _cursor += l;
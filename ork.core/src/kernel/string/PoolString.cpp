@@ -35,7 +35,16 @@ PoolString::operator ConstString() const {
 }
 
 bool PoolString::operator==(const PoolString& other) const {
-  return COMPARE(==, other);
+  if (_stringptr == other._stringptr)
+    return true;
+  if (_stringptr == NULL or other._stringptr == NULL)
+    return false;
+  // strings from different pools (eg. pushed StringPoolContexts)
+  auto lhdr = header();
+  auto rhdr = other.header();
+  if (lhdr->_hash != rhdr->_hash or lhdr->_length != rhdr->_length)
+    return false;
+  return 0 == memcmp(_stringptr, other._stringptr, lhdr->_length);
 }
 
 bool PoolString::operator<(const PoolString& other) const {
@@ -55,7 +64,7 @@ bool PoolString::operator>(const PoolString& other) const {
 }
 
 bool PoolString::operator!=(const PoolString& other) const {
-  return COMPARE(!=, other);
+  return not operator==(other);
 }
 
 PoolString::operator bool() const {
@@ -81,155 +90,6 @@ int PoolString::compare(const PoolString& rhs) const {
     return strcmp(_stringptr, rhs._stringptr);
 }
 
-///////////////////////////////////////////////////////////
-
-StringPool::StringPool(const StringPool* parent)
-    : mStringPool()
-    , mStringPoolMutex("StringPoolMutex")
-    , _parent(parent) {
-  // mStringPool.reserve( 2<<20 );
-}
-
-const char* StringPool::FindRecursive(const PieceString& string) const {
-  const char* result = NULL;
-  Lock();
-  {
-    bool search_result;
-    orkvector<const char*>::size_type pos = BinarySearch(string, search_result);
-
-    if (search_result)
-      result = mStringPool[pos];
-    else if (_parent)
-      result = _parent->FindRecursive(string);
-  }
-  UnLock();
-  return result;
-}
-
-const char* StringPool::FindFirst(const PieceString& string, VecType::iterator& it) {
-  const char* result = NULL;
-  Lock();
-  {
-    bool search_result;
-    volatile VecType::size_type pos = BinarySearch(string, search_result);
-
-    if (search_result)
-      result = mStringPool[pos];
-    else if (_parent)
-      result = _parent->FindRecursive(string);
-
-    OrkHeapCheck();
-
-    if (NULL == result) {
-      if (bool bpastend = (pos >= mStringPool.size()))
-        it = mStringPool.end();
-      else
-        it = mStringPool.begin() + pos;
-    }
-  }
-  UnLock();
-  return result;
-}
-
-int StringPool::FindIndex(const PieceString& string) const {
-  orkvector<const char*>::size_type pos;
-  bool search_result = false;
-  Lock();
-  {
-    OrkAssert(_parent == NULL);
-
-    pos = BinarySearch(string, search_result);
-  }
-  UnLock();
-
-  return search_result ? int(pos) : -1;
-}
-
-int StringPool::StringIndex(const PieceString& string) {
-  PoolString pooled_string = String(string);
-
-  return FindIndex(pooled_string);
-}
-
-int StringPool::LiteralIndex(const ConstString& string) {
-  PoolString pooled_string = Literal(string);
-
-  return FindIndex(pooled_string);
-}
-
-int StringPool::Size() const {
-  return int(mStringPool.size());
-}
-
-PoolString StringPool::FromIndex(int index) const {
-  OrkAssert(_parent == NULL);
-
-  if (index == -1 || index >= int(mStringPool.size()))
-    return PoolString();
-  else
-    return mStringPool[orkvector<const char*>::size_type(index)];
-}
-
-StringPool::VecType::size_type StringPool::BinarySearch(const PieceString& string, bool& result) const {
-  VecType::size_type lo = 0;
-  VecType::size_type hi = mStringPool.size();
-
-  while (lo < hi) {
-    orkvector<const char*>::size_type mid = (lo + hi) / 2;
-    int cmp                               = string.compare(mStringPool[mid]);
-
-    if (cmp < 0)
-      hi = mid;
-    else if (cmp > 0)
-      lo = mid + 1;
-    else {
-      result = true;
-      return mid;
-    }
-  }
-
-  result = false;
-  return lo;
-}
-
-PoolString StringPool::String(const PieceString& s) {
-  const char* string = 0;
-  Lock();
-  {
-    VecType::iterator insertion_point;
-    string = FindFirst(s, insertion_point);
-    if (string == NULL) {
-      char* new_string = new char[s.length() + 1];
-      std::memcpy(new_string, s.c_str(), s.length());
-      new_string[s.length()] = '\0';
-
-      string = new_string;
-      mStringPool.insert(insertion_point, string);
-    }
-  }
-  UnLock();
-  return PoolString(string);
-}
-
-PoolString StringPool::Literal(const ConstString& s) {
-  const char* string = 0;
-  Lock();
-  {
-    VecType::iterator insertion_point = mStringPool.end();
-    string                            = FindFirst(s, insertion_point);
-    if (string == NULL) {
-      string = s.c_str();
-      mStringPool.insert(insertion_point, string);
-    }
-  }
-  UnLock();
-  return PoolString(string);
-}
-
-PoolString StringPool::Find(const PieceString& s) const {
-  return FindRecursive(s);
-}
-
 ///////////////////////////////////////////////////
 /*
 namespace reflect {
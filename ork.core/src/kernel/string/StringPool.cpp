@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <xxhash.h>
+#include <ork/kernel/string/StringPool.h>
+
+namespace ork {
+
+static_assert((sizeof(PoolStringHeader) % alignof(PoolStringHeader)) == 0);
+
+///////////////////////////////////////////////////////////////////////////////
+// bump allocated storage, blocks chained newest first
+///////////////////////////////////////////////////////////////////////////////
+
+struct StringPool::ArenaBlock {
+  ArenaBlock* _prev = nullptr;
+  size_t _size      = 0;
+  std::atomic<size_t> _used;
+  uint8_t* data() {
+    return reinterpret_cast<uint8_t*>(this + 1);
+  }
+};
+
+struct StringPool::Shard {
+  std::atomic<const PoolStringHeader*> _buckets[kNUMBUCKETS];
+  std::atomic<ArenaBlock*> _arena;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+StringPool::StringPool(const StringPool* parent)
+    : _shards(new Shard[kNUMSHARDS])
+    , _count(0)
+    , _parent(parent) {
+  for (size_t s = 0; s < kNUMSHARDS; s++) {
+    for (auto& bucket : _shards[s]._buckets)
+      bucket.store(nullptr, std::memory_order_relaxed);
+    _shards[s]._arena.store(nullptr, std::memory_order_relaxed);
+  }
+  for (auto& chunk : _indexchunks)
+    chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// pooled strings may outlive the pool (they always have), so the arenas
+//  are intentionally not released, only the lookup structures are.
+///////////////////////////////////////////////////////////////////////////////
+
+StringPool::~StringPool() {
+  for (auto& chunk : _indexchunks)
+    delete[] chunk.load();
+  delete[] _shards;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t StringPool::hashString(const char* data, size_t length) {
+  return XXH3_64bits(data, length);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+StringPool::Shard& StringPool::shardFor(uint64_t hash) const {
+  // top bits pick the shard, low bits pick the bucket
+  return _shards[(hash >> 32) % kNUMSHARDS];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const PoolStringHeader* StringPool::findLocal(const char* data, size_t length, uint64_t hash) const {
+  auto& bucket = shardFor(hash)._buckets[hash % kNUMBUCKETS];
+  for (auto it = bucket.load(std::memory_order_acquire); it != nullptr; it = it->_next) {
+    if (it->_hash == hash and it->_length == length and 0 == memcmp(it->chars(), data, length))
+      return it;
+  }
+  return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const PoolStringHeader* StringPool::findRecursive(const char* data, size_t length, uint64_t hash) const {
+  if (auto found = findLocal(data, length, hash))
+    return found;
+  return _parent ? _parent->findRecursive(data, length, hash) : nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PoolStringHeader* StringPool::allocate(Shard& shard, const char* data, size_t length, uint64_t hash) {
+  constexpr size_t kalign = alignof(PoolStringHeader);
+  size_t size             = (sizeof(PoolStringHeader) + length + 1 + kalign - 1) & ~(kalign - 1);
+  uint8_t* mem            = nullptr;
+  while (nullptr == mem) {
+    auto block = shard._arena.load(std::memory_order_acquire);
+    if (block) {
+      size_t offset = block->_used.fetch_add(size);
+      if ((offset + size) <= block->_size) {
+        mem = block->data() + offset;
+        break;
+      }
+    }
+    // current block is full (or missing), race to install a new one
+    size_t blocksize = std::max(kARENABLOCK, size);
+    auto newblock    = new (malloc(sizeof(ArenaBlock) + blocksize)) ArenaBlock;
+    newblock->_prev  = block;
+    newblock->_size  = blocksize;
+    newblock->_used.store(0);
+    if (not shard._arena.compare_exchange_strong(block, newblock))
+      free(newblock);
+  }
+  auto header     = new (mem) PoolStringHeader;
+  header->_hash   = hash;
+  header->_length = uint32_t(length);
+  char* chars     = reinterpret_cast<char*>(header + 1);
+  memcpy(chars, data, length);
+  chars[length] = 0;
+  return header;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void StringPool::assignIndex(PoolStringHeader* header) {
+  int index         = _count.fetch_add(1);
+  size_t chunkindex = size_t(index) / kINDEXCHUNK;
+  OrkAssert(chunkindex < kMAXINDEXCHUNKS);
+  auto& chunkslot = _indexchunks[chunkindex];
+  auto chunk      = chunkslot.load(std::memory_order_acquire);
+  if (nullptr == chunk) {
+    auto newchunk = new indexchunk_t[kINDEXCHUNK];
+    for (size_t i = 0; i < kINDEXCHUNK; i++)
+      newchunk[i].store(nullptr, std::memory_order_relaxed);
+    if (chunkslot.compare_exchange_strong(chunk, newchunk))
+      chunk = newchunk;
+    else
+      delete[] newchunk;
+  }
+  chunk[size_t(index) % kINDEXCHUNK].store(header->chars(), std::memory_order_release);
+  header->_index.store(index, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PoolString StringPool::String(const PieceString& s) {
+  const char* data = s.c_str();
+  size_t length    = s.length();
+  uint64_t hash    = hashString(data, length);
+  if (auto found = findRecursive(data, length, hash))
+    return PoolString(found->chars());
+  ///////////////////////////////////////////
+  auto& shard                   = shardFor(hash);
+  auto& bucket                  = shard._buckets[hash % kNUMBUCKETS];
+  PoolStringHeader* inserted    = nullptr;
+  const PoolStringHeader* head  = bucket.load(std::memory_order_acquire);
+  const PoolStringHeader* known = nullptr; // chain from here on was already searched
+  while (true) {
+    for (auto it = head; it != known; it = it->_next) {
+      if (it->_hash == hash and it->_length == length and 0 == memcmp(it->chars(), data, length)) {
+        // another thread pooled it first,
+        //  our copy (if any) stays unused in the arena
+        return PoolString(it->chars());
+      }
+    }
+    if (nullptr == inserted)
+      inserted = allocate(shard, data, length, hash);
+    inserted->_next = head;
+    if (bucket.compare_exchange_weak(head, inserted, std::memory_order_release, std::memory_order_acquire))
+      break;
+    known = inserted->_next;
+  }
+  assignIndex(inserted);
+  return PoolString(inserted->chars());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// literals are copied as well, every pooled string needs its header
+///////////////////////////////////////////////////////////////////////////////
+
+PoolString StringPool::Literal(const ConstString& s) {
+  return String(PieceString(s.c_str(), s.length()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PoolString StringPool::Find(const PieceString& s) const {
+  const char* data = s.c_str();
+  size_t length    = s.length();
+  if (auto found = findRecursive(data, length, hashString(data, length)))
+    return PoolString(found->chars());
+  return PoolString();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int StringPool::FindIndex(const PieceString& s) const {
+  OrkAssert(_parent == NULL);
+  const char* data = s.c_str();
+  size_t length    = s.length();
+  auto found       = findLocal(data, length, hashString(data, length));
+  if (nullptr == found)
+    return -1;
+  // the inserting thread assigns the index right after publishing
+  int index = found->_index.load(std::memory_order_acquire);
+  while (index < 0)
+    index = found->_index.load(std::memory_order_acquire);
+  return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int StringPool::StringIndex(const PieceString& string) {
+  PoolString pooled_string = String(string);
+  return FindIndex(pooled_string);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int StringPool::LiteralIndex(const ConstString& string) {
+  PoolString pooled_string = Literal(string);
+  return FindIndex(pooled_string);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int StringPool::Size() const {
+  return _count.load();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PoolString StringPool::FromIndex(int index) const {
+  OrkAssert(_parent == NULL);
+  if (index < 0 or index >= Size())
+    return PoolString();
+  auto chunk = _indexchunks[size_t(index) / kINDEXCHUNK].load(std::memory_order_acquire);
+  if (nullptr == chunk)
+    return PoolString();
+  return PoolString(chunk[size_t(index) % kINDEXCHUNK].load(std::memory_order_acquire));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork
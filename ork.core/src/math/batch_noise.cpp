@@ -0,0 +1,826 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/math/batch_noise.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace ork::math::noise {
+
+///////////////////////////////////////////////////////////////////////////////
+// lane types : the kernels below only talk to these
+//  F : floats, I : 32 bit ints (wrapping), M : lane masks
+///////////////////////////////////////////////////////////////////////////////
+
+struct ScalarLanes {
+  static constexpr int kWidth = 1;
+  using F                     = float;
+  using I                     = uint32_t;
+  using M                     = bool;
+
+  static F fset(float v) {
+    return v;
+  }
+  static I iset(uint32_t v) {
+    return v;
+  }
+  static F load(const float* p) {
+    return *p;
+  }
+  static void store(float* p, F v) {
+    *p = v;
+  }
+  static F iota() {
+    return 0.0f;
+  }
+  static F floor(F x) {
+    return floorf(x);
+  }
+  static I toInt(F x) { // x is integral
+    return uint32_t(int32_t(x));
+  }
+  static F toFloat(I i) {
+    return float(int32_t(i));
+  }
+  static I srl(I a, int n) {
+    return a >> n;
+  }
+  static I sll(I a, int n) {
+    return a << n;
+  }
+  static M lt(F a, F b) {
+    return a < b;
+  }
+  static M ge(F a, F b) {
+    return a >= b;
+  }
+  static M ilt(I a, uint32_t c) {
+    return a < c;
+  }
+  static M ieq(I a, uint32_t c) {
+    return a == c;
+  }
+  static M mand(M a, M b) {
+    return a and b;
+  }
+  static M mor(M a, M b) {
+    return a or b;
+  }
+  static M mnot(M a) {
+    return not a;
+  }
+  static F select(M m, F a, F b) {
+    return m ? a : b;
+  }
+  static I iselect(M m, I a, I b) {
+    return m ? a : b;
+  }
+  static F max(F a, F b) {
+    return (a > b) ? a : b;
+  }
+  static F abs(F a) {
+    return fabsf(a);
+  }
+  //! negate v where bit 31 of bits is set
+  static F flipsign(F v, I bits) {
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+    u ^= (bits & 0x80000000u);
+    memcpy(&v, &u, sizeof(u));
+    return v;
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(__SSE4_1__)
+struct SseLanes {
+  static constexpr int kWidth = 4;
+
+  struct F {
+    __m128 v;
+    friend F operator+(F a, F b) {
+      return {_mm_add_ps(a.v, b.v)};
+    }
+    friend F operator-(F a, F b) {
+      return {_mm_sub_ps(a.v, b.v)};
+    }
+    friend F operator*(F a, F b) {
+      return {_mm_mul_ps(a.v, b.v)};
+    }
+  };
+  struct I {
+    __m128i v;
+    friend I operator+(I a, I b) {
+      return {_mm_add_epi32(a.v, b.v)};
+    }
+    friend I operator*(I a, I b) {
+      return {_mm_mullo_epi32(a.v, b.v)};
+    }
+    friend I operator^(I a, I b) {
+      return {_mm_xor_si128(a.v, b.v)};
+    }
+    friend I operator&(I a, I b) {
+      return {_mm_and_si128(a.v, b.v)};
+    }
+  };
+  using M = F;
+
+  static F fset(float v) {
+    return {_mm_set1_ps(v)};
+  }
+  static I iset(uint32_t v) {
+    return {_mm_set1_epi32(int(v))};
+  }
+  static F load(const float* p) {
+    return {_mm_loadu_ps(p)};
+  }
+  static void store(float* p, F v) {
+    _mm_storeu_ps(p, v.v);
+  }
+  static F iota() {
+    return {_mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)};
+  }
+  static F floor(F x) {
+    return {_mm_floor_ps(x.v)};
+  }
+  static I toInt(F x) {
+    return {_mm_cvttps_epi32(x.v)};
+  }
+  static F toFloat(I i) {
+    return {_mm_cvtepi32_ps(i.v)};
+  }
+  static I srl(I a, int n) {
+    return {_mm_srli_epi32(a.v, n)};
+  }
+  static I sll(I a, int n) {
+    return {_mm_slli_epi32(a.v, n)};
+  }
+  static M lt(F a, F b) {
+    return {_mm_cmplt_ps(a.v, b.v)};
+  }
+  static M ge(F a, F b) {
+    return {_mm_cmpge_ps(a.v, b.v)};
+  }
+  static M ilt(I a, uint32_t c) { // small non negative operands only
+    return {_mm_castsi128_ps(_mm_cmplt_epi32(a.v, _mm_set1_epi32(int(c))))};
+  }
+  static M ieq(I a, uint32_t c) {
+    return {_mm_castsi128_ps(_mm_cmpeq_epi32(a.v, _mm_set1_epi32(int(c))))};
+  }
+  static M mand(M a, M b) {
+    return {_mm_and_ps(a.v, b.v)};
+  }
+  static M mor(M a, M b) {
+    return {_mm_or_ps(a.v, b.v)};
+  }
+  static M mnot(M a) {
+    return {_mm_xor_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(-1)))};
+  }
+  static F select(M m, F a, F b) {
+    return {_mm_blendv_ps(b.v, a.v, m.v)};
+  }
+  static I iselect(M m, I a, I b) {
+    return {_mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(b.v), _mm_castsi128_ps(a.v), m.v))};
+  }
+  static F max(F a, F b) {
+    return {_mm_max_ps(a.v, b.v)};
+  }
+  static F abs(F a) {
+    return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+  }
+  static F flipsign(F v, I bits) {
+    __m128i sign = _mm_and_si128(bits.v, _mm_set1_epi32(int(0x80000000u)));
+    return {_mm_xor_ps(v.v, _mm_castsi128_ps(sign))};
+  }
+};
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(__AVX2__)
+struct Avx2Lanes {
+  static constexpr int kWidth = 8;
+
+  struct F {
+    __m256 v;
+    friend F operator+(F a, F b) {
+      return {_mm256_add_ps(a.v, b.v)};
+    }
+    friend F operator-(F a, F b) {
+      return {_mm256_sub_ps(a.v, b.v)};
+    }
+    friend F operator*(F a, F b) {
+      return {_mm256_mul_ps(a.v, b.v)};
+    }
+  };
+  struct I {
+    __m256i v;
+    friend I operator+(I a, I b) {
+      return {_mm256_add_epi32(a.v, b.v)};
+    }
+    friend I operator*(I a, I b) {
+      return {_mm256_mullo_epi32(a.v, b.v)};
+    }
+    friend I operator^(I a, I b) {
+      return {_mm256_xor_si256(a.v, b.v)};
+    }
+    friend I operator&(I a, I b) {
+      return {_mm256_and_si256(a.v, b.v)};
+    }
+  };
+  using M = F;
+
+  static F fset(float v) {
+    return {_mm256_set1_ps(v)};
+  }
+  static I iset(uint32_t v) {
+    return {_mm256_set1_epi32(int(v))};
+  }
+  static F load(const float* p) {
+    return {_mm256_loadu_ps(p)};
+  }
+  static void store(float* p, F v) {
+    _mm256_storeu_ps(p, v.v);
+  }
+  static F iota() {
+    return {_mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)};
+  }
+  static F floor(F x) {
+    return {_mm256_floor_ps(x.v)};
+  }
+  static I toInt(F x) {
+    return {_mm256_cvttps_epi32(x.v)};
+  }
+  static F toFloat(I i) {
+    return {_mm256_cvtepi32_ps(i.v)};
+  }
+  static I srl(I a, int n) {
+    return {_mm256_srli_epi32(a.v, n)};
+  }
+  static I sll(I a, int n) {
+    return {_mm256_slli_epi32(a.v, n)};
+  }
+  static M lt(F a, F b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)};
+  }
+  static M ge(F a, F b) {
+    return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)};
+  }
+  static M ilt(I a, uint32_t c) { // small non negative operands only
+    return {_mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(int(c)), a.v))};
+  }
+  static M ieq(I a, uint32_t c) {
+    return {_mm256_castsi256_ps(_mm256_cmpeq_epi32(a.v, _mm256_set1_epi32(int(c))))};
+  }
+  static M mand(M a, M b) {
+    return {_mm256_and_ps(a.v, b.v)};
+  }
+  static M mor(M a, M b) {
+    return {_mm256_or_ps(a.v, b.v)};
+  }
+  static M mnot(M a) {
+    return {_mm256_xor_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))};
+  }
+  static F select(M m, F a, F b) {
+    return {_mm256_blendv_ps(b.v, a.v, m.v)};
+  }
+  static I iselect(M m, I a, I b) {
+    return {_mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b.v), _mm256_castsi256_ps(a.v), m.v))};
+  }
+  static F max(F a, F b) {
+    return {_mm256_max_ps(a.v, b.v)};
+  }
+  static F abs(F a) {
+    return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)};
+  }
+  static F flipsign(F v, I bits) {
+    __m256i sign = _mm256_and_si256(bits.v, _mm256_set1_epi32(int(0x80000000u)));
+    return {_mm256_xor_ps(v.v, _mm256_castsi256_ps(sign))};
+  }
+};
+using Lanes = Avx2Lanes;
+static constexpr const char* kSimdName = "avx2";
+#elif defined(__SSE4_1__)
+using Lanes = SseLanes;
+static constexpr const char* kSimdName = "sse4.1";
+#else
+using Lanes = ScalarLanes;
+static constexpr const char* kSimdName = "scalar";
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// lattice hashing (no tables, so no gathers)
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename L> inline typename L::I _mix(typename L::I h) {
+  h = h ^ L::srl(h, 16);
+  h = h * L::iset(0x7feb352du);
+  h = h ^ L::srl(h, 15);
+  h = h * L::iset(0x846ca68bu);
+  h = h ^ L::srl(h, 16);
+  return h;
+}
+
+template <typename L> inline typename L::I _hash2(typename L::I ix, typename L::I iy, typename L::I seed) {
+  return _mix<L>(seed ^ (ix * L::iset(0x27d4eb2du)) ^ (iy * L::iset(0x165667b1u)));
+}
+
+template <typename L>
+inline typename L::I _hash3(typename L::I ix, typename L::I iy, typename L::I iz, typename L::I seed) {
+  return _mix<L>(seed ^ (ix * L::iset(0x27d4eb2du)) ^ (iy * L::iset(0x165667b1u)) ^ (iz * L::iset(0x9e3779b1u)));
+}
+
+//! hash to -1 .. 1
+template <typename L> inline typename L::F _unit(typename L::I h) {
+  return L::toFloat(L::srl(h, 8)) * L::fset(2.0f / 16777215.0f) - L::fset(1.0f);
+}
+
+//! 6t^5 - 15t^4 + 10t^3
+template <typename L> inline typename L::F _fade(typename L::F t) {
+  return t * t * t * (t * (t * L::fset(6.0f) - L::fset(15.0f)) + L::fset(10.0f));
+}
+
+template <typename L> inline typename L::F _lerp(typename L::F a, typename L::F b, typename L::F t) {
+  return a + t * (b - a);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// gradients : 8 directions in 2d ((1,2) family), 12 cube edges in 3d
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename L> inline typename L::F _grad2(typename L::I h, typename L::F x, typename L::F y) {
+  auto lo = L::ilt(h & L::iset(7), 4);
+  auto u  = L::select(lo, x, y);
+  auto v  = L::select(lo, y, x);
+  return L::flipsign(u, L::sll(h, 31)) + L::flipsign(v + v, L::sll(h, 30));
+}
+
+template <typename L>
+inline typename L::F _grad3(typename L::I h, typename L::F x, typename L::F y, typename L::F z) {
+  auto h15 = h & L::iset(15);
+  auto xz  = L::mor(L::ieq(h15, 12), L::ieq(h15, 14));
+  auto u   = L::select(L::ilt(h15, 8), x, y);
+  auto v   = L::select(L::ilt(h15, 4), y, L::select(xz, x, z));
+  return L::flipsign(u, L::sll(h, 31)) + L::flipsign(v, L::sll(h, 30));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// bases
+///////////////////////////////////////////////////////////////////////////////
+
+struct ValueBasis {
+  template <typename L> static typename L::F eval2(typename L::F x, typename L::F y, typename L::I seed) {
+    using I  = typename L::I;
+    auto fx  = L::floor(x);
+    auto fy  = L::floor(y);
+    I ix     = L::toInt(fx);
+    I iy     = L::toInt(fy);
+    I one    = L::iset(1);
+    auto u   = _fade<L>(x - fx);
+    auto v   = _fade<L>(y - fy);
+    auto n00 = _unit<L>(_hash2<L>(ix, iy, seed));
+    auto n10 = _unit<L>(_hash2<L>(ix + one, iy, seed));
+    auto n01 = _unit<L>(_hash2<L>(ix, iy + one, seed));
+    auto n11 = _unit<L>(_hash2<L>(ix + one, iy + one, seed));
+    return _lerp<L>(_lerp<L>(n00, n10, u), _lerp<L>(n01, n11, u), v);
+  }
+  template <typename L>
+  static typename L::F eval3(typename L::F x, typename L::F y, typename L::F z, typename L::I seed) {
+    using I = typename L::I;
+    auto fx = L::floor(x);
+    auto fy = L::floor(y);
+    auto fz = L::floor(z);
+    I ix    = L::toInt(fx);
+    I iy    = L::toInt(fy);
+    I iz    = L::toInt(fz);
+    I one   = L::iset(1);
+    auto u  = _fade<L>(x - fx);
+    auto v  = _fade<L>(y - fy);
+    auto w  = _fade<L>(z - fz);
+    auto z0 = _lerp<L>(
+        _lerp<L>(_unit<L>(_hash3<L>(ix, iy, iz, seed)), _unit<L>(_hash3<L>(ix + one, iy, iz, seed)), u),
+        _lerp<L>(_unit<L>(_hash3<L>(ix, iy + one, iz, seed)), _unit<L>(_hash3<L>(ix + one, iy + one, iz, seed)), u),
+        v);
+    iz      = iz + one;
+    auto z1 = _lerp<L>(
+        _lerp<L>(_unit<L>(_hash3<L>(ix, iy, iz, seed)), _unit<L>(_hash3<L>(ix + one, iy, iz, seed)), u),
+        _lerp<L>(_unit<L>(_hash3<L>(ix, iy + one, iz, seed)), _unit<L>(_hash3<L>(ix + one, iy + one, iz, seed)), u),
+        v);
+    return _lerp<L>(z0, z1, w);
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct GradientBasis {
+  template <typename L> static typename L::F eval2(typename L::F x, typename L::F y, typename L::I seed) {
+    using I  = typename L::I;
+    auto fx  = L::floor(x);
+    auto fy  = L::floor(y);
+    I ix     = L::toInt(fx);
+    I iy     = L::toInt(fy);
+    I one    = L::iset(1);
+    auto x0  = x - fx;
+    auto y0  = y - fy;
+    auto x1  = x0 - L::fset(1.0f);
+    auto y1  = y0 - L::fset(1.0f);
+    auto n00 = _grad2<L>(_hash2<L>(ix, iy, seed), x0, y0);
+    auto n10 = _grad2<L>(_hash2<L>(ix + one, iy, seed), x1, y0);
+    auto n01 = _grad2<L>(_hash2<L>(ix, iy + one, seed), x0, y1);
+    auto n11 = _grad2<L>(_hash2<L>(ix + one, iy + one, seed), x1, y1);
+    auto u   = _fade<L>(x0);
+    auto v   = _fade<L>(y0);
+    return L::fset(0.507f) * _lerp<L>(_lerp<L>(n00, n10, u), _lerp<L>(n01, n11, u), v);
+  }
+  template <typename L>
+  static typename L::F eval3(typename L::F x, typename L::F y, typename L::F z, typename L::I seed) {
+    using I  = typename L::I;
+    auto fx  = L::floor(x);
+    auto fy  = L::floor(y);
+    auto fz  = L::floor(z);
+    I ix     = L::toInt(fx);
+    I iy     = L::toInt(fy);
+    I iz     = L::toInt(fz);
+    I one    = L::iset(1);
+    auto x0  = x - fx;
+    auto y0  = y - fy;
+    auto z0  = z - fz;
+    auto x1  = x0 - L::fset(1.0f);
+    auto y1  = y0 - L::fset(1.0f);
+    auto z1  = z0 - L::fset(1.0f);
+    auto u   = _fade<L>(x0);
+    auto v   = _fade<L>(y0);
+    auto w   = _fade<L>(z0);
+    auto n0  = _lerp<L>(
+        _lerp<L>(
+            _grad3<L>(_hash3<L>(ix, iy, iz, seed), x0, y0, z0),
+            _grad3<L>(_hash3<L>(ix + one, iy, iz, seed), x1, y0, z0),
+            u),
+        _lerp<L>(
+            _grad3<L>(_hash3<L>(ix, iy + one, iz, seed), x0, y1, z0),
+            _grad3<L>(_hash3<L>(ix + one, iy + one, iz, seed), x1, y1, z0),
+            u),
+        v);
+    I iz1   = iz + one;
+    auto n1 = _lerp<L>(
+        _lerp<L>(
+            _grad3<L>(_hash3<L>(ix, iy, iz1, seed), x0, y0, z1),
+            _grad3<L>(_hash3<L>(ix + one, iy, iz1, seed), x1, y0, z1),
+            u),
+        _lerp<L>(
+            _grad3<L>(_hash3<L>(ix, iy + one, iz1, seed), x0, y1, z1),
+            _grad3<L>(_hash3<L>(ix + one, iy + one, iz1, seed), x1, y1, z1),
+            u),
+        v);
+    return L::fset(0.936f) * _lerp<L>(n0, n1, w);
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// simplex : corner ordering done with lane masks instead of branches
+///////////////////////////////////////////////////////////////////////////////
+
+struct SimplexBasis {
+
+  template <typename L>
+  static typename L::F corner2(typename L::I h, typename L::F x, typename L::F y) {
+    auto t = L::max(L::fset(0.5f) - x * x - y * y, L::fset(0.0f));
+    t      = t * t;
+    return t * t * _grad2<L>(h, x, y);
+  }
+  template <typename L>
+  static typename L::F corner3(typename L::I h, typename L::F x, typename L::F y, typename L::F z) {
+    auto t = L::max(L::fset(0.6f) - x * x - y * y - z * z, L::fset(0.0f));
+    t      = t * t;
+    return t * t * _grad3<L>(h, x, y, z);
+  }
+
+  template <typename L> static typename L::F eval2(typename L::F x, typename L::F y, typename L::I seed) {
+    using F             = typename L::F;
+    using I             = typename L::I;
+    constexpr float kF2 = 0.366025403f; // (sqrt(3)-1)/2
+    constexpr float kG2 = 0.211324865f; // (3-sqrt(3))/6
+    F s                 = (x + y) * L::fset(kF2);
+    F fi                = L::floor(x + s);
+    F fj                = L::floor(y + s);
+    I i                 = L::toInt(fi);
+    I j                 = L::toInt(fj);
+    F t                 = (fi + fj) * L::fset(kG2);
+    F x0                = x - (fi - t);
+    F y0                = y - (fj - t);
+    auto lower          = L::lt(y0, x0); // x0 > y0 : lower triangle, (1,0) step first
+    F one               = L::fset(1.0f);
+    F zero              = L::fset(0.0f);
+    I ione              = L::iset(1);
+    I izero             = L::iset(0);
+    F x1                = x0 - L::select(lower, one, zero) + L::fset(kG2);
+    F y1                = y0 - L::select(lower, zero, one) + L::fset(kG2);
+    F x2                = x0 - one + L::fset(2.0f * kG2);
+    F y2                = y0 - one + L::fset(2.0f * kG2);
+    I i1                = L::iselect(lower, ione, izero);
+    I j1                = L::iselect(lower, izero, ione);
+    F n0                = corner2<L>(_hash2<L>(i, j, seed), x0, y0);
+    F n1                = corner2<L>(_hash2<L>(i + i1, j + j1, seed), x1, y1);
+    F n2                = corner2<L>(_hash2<L>(i + ione, j + ione, seed), x2, y2);
+    return L::fset(40.0f) * (n0 + n1 + n2);
+  }
+
+  template <typename L>
+  static typename L::F eval3(typename L::F x, typename L::F y, typename L::F z, typename L::I seed) {
+    using F             = typename L::F;
+    using I             = typename L::I;
+    constexpr float kF3 = 1.0f / 3.0f;
+    constexpr float kG3 = 1.0f / 6.0f;
+    F s                 = (x + y + z) * L::fset(kF3);
+    F fi                = L::floor(x + s);
+    F fj                = L::floor(y + s);
+    F fk                = L::floor(z + s);
+    I i                 = L::toInt(fi);
+    I j                 = L::toInt(fj);
+    I k                 = L::toInt(fk);
+    F t                 = (fi + fj + fk) * L::fset(kG3);
+    F x0                = x - (fi - t);
+    F y0                = y - (fj - t);
+    F z0                = z - (fk - t);
+    auto x_ge_y         = L::ge(x0, y0);
+    auto y_ge_z         = L::ge(y0, z0);
+    auto x_ge_z         = L::ge(x0, z0);
+    auto i1             = L::mand(x_ge_y, x_ge_z);
+    auto j1             = L::mand(L::mnot(x_ge_y), y_ge_z);
+    auto k1             = L::mand(L::mnot(x_ge_z), L::mnot(y_ge_z));
+    auto i2             = L::mor(x_ge_y, x_ge_z);
+    auto j2             = L::mor(L::mnot(x_ge_y), y_ge_z);
+    auto k2             = L::mnot(L::mand(x_ge_z, y_ge_z));
+    F one               = L::fset(1.0f);
+    F zero              = L::fset(0.0f);
+    I ione              = L::iset(1);
+    I izero             = L::iset(0);
+    F x1                = x0 - L::select(i1, one, zero) + L::fset(kG3);
+    F y1                = y0 - L::select(j1, one, zero) + L::fset(kG3);
+    F z1                = z0 - L::select(k1, one, zero) + L::fset(kG3);
+    F x2                = x0 - L::select(i2, one, zero) + L::fset(2.0f * kG3);
+    F y2                = y0 - L::select(j2, one, zero) + L::fset(2.0f * kG3);
+    F z2                = z0 - L::select(k2, one, zero) + L::fset(2.0f * kG3);
+    F x3                = x0 - one + L::fset(3.0f * kG3);
+    F y3                = y0 - one + L::fset(3.0f * kG3);
+    F z3                = z0 - one + L::fset(3.0f * kG3);
+    I h0                = _hash3<L>(i, j, k, seed);
+    I h1                = _hash3<L>( //
+        i + L::iselect(i1, ione, izero),
+        j + L::iselect(j1, ione, izero),
+        k + L::iselect(k1, ione, izero),
+        seed);
+    I h2 = _hash3<L>( //
+        i + L::iselect(i2, ione, izero),
+        j + L::iselect(j2, ione, izero),
+        k + L::iselect(k2, ione, izero),
+        seed);
+    I h3 = _hash3<L>(i + ione, j + ione, k + ione, seed);
+    F n  = corner3<L>(h0, x0, y0, z0) + corner3<L>(h1, x1, y1, z1) //
+          + corner3<L>(h2, x2, y2, z2) + corner3<L>(h3, x3, y3, z3);
+    return L::fset(32.0f) * n;
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// fractal sums : per octave constants resolved once per call
+///////////////////////////////////////////////////////////////////////////////
+
+static constexpr int kMaxOctaves = 16;
+
+struct OctaveTable {
+
+  OctaveTable(const NoiseParams& params) {
+    _count = (params._fractal == NoiseFractal::NONE) ? 1 : params._octaves;
+    OrkAssert(_count >= 1 and _count <= kMaxOctaves);
+    _ridged   = (params._fractal == NoiseFractal::RIDGED);
+    float amp = 1.0f;
+    float frq = params._frequency;
+    float sum = 0.0f;
+    for (int o = 0; o < _count; o++) {
+      _frequency[o] = frq;
+      _amplitude[o] = amp;
+      _seed[o]      = params._seed * 0x9e3779b9u + uint32_t(o) * 0x632be5abu;
+      sum += amp;
+      amp *= params._gain;
+      frq *= params._lacunarity;
+    }
+    for (int o = 0; o < _count; o++)
+      _amplitude[o] /= sum;
+  }
+
+  int _count   = 1;
+  bool _ridged = false;
+  float _frequency[kMaxOctaves];
+  float _amplitude[kMaxOctaves];
+  uint32_t _seed[kMaxOctaves];
+};
+
+template <typename L> inline typename L::F _octave(const OctaveTable& table, int o, typename L::F n) {
+  if (table._ridged) {
+    n = L::fset(1.0f) - L::abs(n);
+    n = n * n;
+  }
+  return n * L::fset(table._amplitude[o]);
+}
+
+template <typename L, typename basis_t>
+inline typename L::F _fractal2(const OctaveTable& table, typename L::F x, typename L::F y) {
+  auto sum = L::fset(0.0f);
+  for (int o = 0; o < table._count; o++) {
+    auto frq = L::fset(table._frequency[o]);
+    auto n   = basis_t::template eval2<L>(x * frq, y * frq, L::iset(table._seed[o]));
+    sum      = sum + _octave<L>(table, o, n);
+  }
+  return sum;
+}
+
+template <typename L, typename basis_t>
+inline typename L::F _fractal3(const OctaveTable& table, typename L::F x, typename L::F y, typename L::F z) {
+  auto sum = L::fset(0.0f);
+  for (int o = 0; o < table._count; o++) {
+    auto frq = L::fset(table._frequency[o]);
+    auto n   = basis_t::template eval3<L>(x * frq, y * frq, z * frq, L::iset(table._seed[o]));
+    sum      = sum + _octave<L>(table, o, n);
+  }
+  return sum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// batch drivers : full blocks on the wide lanes, tails on the scalar ones
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename basis_t>
+void _batch2(const float* xs, const float* ys, float* out, size_t count, const OctaveTable& table) {
+  constexpr size_t W = Lanes::kWidth;
+  size_t i           = 0;
+  for (; i + W <= count; i += W)
+    Lanes::store(out + i, _fractal2<Lanes, basis_t>(table, Lanes::load(xs + i), Lanes::load(ys + i)));
+  for (; i < count; i++)
+    out[i] = _fractal2<ScalarLanes, basis_t>(table, xs[i], ys[i]);
+}
+
+template <typename basis_t>
+void _batch3(const float* xs, const float* ys, const float* zs, float* out, size_t count, const OctaveTable& table) {
+  constexpr size_t W = Lanes::kWidth;
+  size_t i           = 0;
+  for (; i + W <= count; i += W)
+    Lanes::store(
+        out + i, //
+        _fractal3<Lanes, basis_t>(table, Lanes::load(xs + i), Lanes::load(ys + i), Lanes::load(zs + i)));
+  for (; i < count; i++)
+    out[i] = _fractal3<ScalarLanes, basis_t>(table, xs[i], ys[i], zs[i]);
+}
+
+template <typename basis_t>
+void _grid(float* out, int w, int h, const fvec3& origin, const fvec2& step, bool is3d, const OctaveTable& table) {
+  constexpr int W = Lanes::kWidth;
+  auto lanestep   = Lanes::iota() * Lanes::fset(step.x);
+  for (int j = 0; j < h; j++) {
+    float* row = out + size_t(j) * size_t(w);
+    float y    = origin.y + float(j) * step.y;
+    int i      = 0;
+    for (; i + W <= w; i += W) {
+      auto x = Lanes::fset(origin.x + float(i) * step.x) + lanestep;
+      auto r = is3d ? _fractal3<Lanes, basis_t>(table, x, Lanes::fset(y), Lanes::fset(origin.z))
+                    : _fractal2<Lanes, basis_t>(table, x, Lanes::fset(y));
+      Lanes::store(row + i, r);
+    }
+    for (; i < w; i++) {
+      float x = origin.x + float(i) * step.x;
+      row[i]  = is3d ? _fractal3<ScalarLanes, basis_t>(table, x, y, origin.z)
+                     : _fractal2<ScalarLanes, basis_t>(table, x, y);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// public interface
+///////////////////////////////////////////////////////////////////////////////
+
+float value2(float x, float y, uint32_t seed) {
+  return ValueBasis::eval2<ScalarLanes>(x, y, seed);
+}
+float value3(float x, float y, float z, uint32_t seed) {
+  return ValueBasis::eval3<ScalarLanes>(x, y, z, seed);
+}
+float gradient2(float x, float y, uint32_t seed) {
+  return GradientBasis::eval2<ScalarLanes>(x, y, seed);
+}
+float gradient3(float x, float y, float z, uint32_t seed) {
+  return GradientBasis::eval3<ScalarLanes>(x, y, z, seed);
+}
+float simplex2(float x, float y, uint32_t seed) {
+  return SimplexBasis::eval2<ScalarLanes>(x, y, seed);
+}
+float simplex3(float x, float y, float z, uint32_t seed) {
+  return SimplexBasis::eval3<ScalarLanes>(x, y, z, seed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+float sample2(const fvec2& pos, const NoiseParams& params) {
+  OctaveTable table(params);
+  switch (params._basis) {
+    case NoiseBasis::VALUE:
+      return _fractal2<ScalarLanes, ValueBasis>(table, pos.x, pos.y);
+    case NoiseBasis::GRADIENT:
+      return _fractal2<ScalarLanes, GradientBasis>(table, pos.x, pos.y);
+    case NoiseBasis::SIMPLEX:
+      return _fractal2<ScalarLanes, SimplexBasis>(table, pos.x, pos.y);
+  }
+  return 0.0f;
+}
+
+float sample3(const fvec3& pos, const NoiseParams& params) {
+  OctaveTable table(params);
+  switch (params._basis) {
+    case NoiseBasis::VALUE:
+      return _fractal3<ScalarLanes, ValueBasis>(table, pos.x, pos.y, pos.z);
+    case NoiseBasis::GRADIENT:
+      return _fractal3<ScalarLanes, GradientBasis>(table, pos.x, pos.y, pos.z);
+    case NoiseBasis::SIMPLEX:
+      return _fractal3<ScalarLanes, SimplexBasis>(table, pos.x, pos.y, pos.z);
+  }
+  return 0.0f;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void batch2(const float* xs, const float* ys, float* out, size_t count, const NoiseParams& params) {
+  OctaveTable table(params);
+  switch (params._basis) {
+    case NoiseBasis::VALUE:
+      _batch2<ValueBasis>(xs, ys, out, count, table);
+      break;
+    case NoiseBasis::GRADIENT:
+      _batch2<GradientBasis>(xs, ys, out, count, table);
+      break;
+    case NoiseBasis::SIMPLEX:
+      _batch2<SimplexBasis>(xs, ys, out, count, table);
+      break;
+  }
+}
+
+void batch3(const float* xs, const float* ys, const float* zs, float* out, size_t count, const NoiseParams& params) {
+  OctaveTable table(params);
+  switch (params._basis) {
+    case NoiseBasis::VALUE:
+      _batch3<ValueBasis>(xs, ys, zs, out, count, table);
+      break;
+    case NoiseBasis::GRADIENT:
+      _batch3<GradientBasis>(xs, ys, zs, out, count, table);
+      break;
+    case NoiseBasis::SIMPLEX:
+      _batch3<SimplexBasis>(xs, ys, zs, out, count, table);
+      break;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void _gridDispatch(float* out, int w, int h, const fvec3& origin, const fvec2& step, bool is3d, const NoiseParams& params) {
+  OctaveTable table(params);
+  switch (params._basis) {
+    case NoiseBasis::VALUE:
+      _grid<ValueBasis>(out, w, h, origin, step, is3d, table);
+      break;
+    case NoiseBasis::GRADIENT:
+      _grid<GradientBasis>(out, w, h, origin, step, is3d, table);
+      break;
+    case NoiseBasis::SIMPLEX:
+      _grid<SimplexBasis>(out, w, h, origin, step, is3d, table);
+      break;
+  }
+}
+
+void grid2(float* out, int w, int h, const fvec2& origin, const fvec2& step, const NoiseParams& params) {
+  _gridDispatch(out, w, h, fvec3(origin.x, origin.y, 0.0f), step, false, params);
+}
+
+void grid3(float* out, int w, int h, const fvec3& origin, const fvec2& step, const NoiseParams& params) {
+  _gridDispatch(out, w, h, origin, step, true, params);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int simdWidth() {
+  return Lanes::kWidth;
+}
+
+const char* simdName() {
+  return kSimdName;
+}
+
+} // namespace ork::math::noise
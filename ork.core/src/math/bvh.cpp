@@ -0,0 +1,330 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/math/bvh.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace ork {
+///////////////////////////////////////////////////////////////////////////////
+
+BVH4Ray::BVH4Ray(const fvec3& origin, const fvec3& direction, float tmin, float tmax)
+    : _origin(origin)
+    , _direction(direction)
+    , _invdir(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z)
+    , _tmin(tmin)
+    , _tmax(tmax) {
+  _positive[0] = (_invdir.x >= 0.0f);
+  _positive[1] = (_invdir.y >= 0.0f);
+  _positive[2] = (_invdir.z >= 0.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BVH4Packet::BVH4Packet() {
+  // inactive lanes can never pass a slab test (tmin > tmax)
+  for (int r = 0; r < kSize; r++) {
+    _ox[r] = _oy[r] = _oz[r] = 0.0f;
+    _dx[r] = _dy[r] = _dz[r] = 0.0f;
+    _ix[r] = _iy[r] = _iz[r] = 0.0f;
+    _tmin[r]                 = std::numeric_limits<float>::infinity();
+    _tmax[r]                 = -std::numeric_limits<float>::infinity();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BVH4Packet::setRay(int lane, const fvec3& origin, const fvec3& direction, float tmin, float tmax) {
+  OrkAssert(lane >= 0 and lane < kSize);
+  _ox[lane]   = origin.x;
+  _oy[lane]   = origin.y;
+  _oz[lane]   = origin.z;
+  _dx[lane]   = direction.x;
+  _dy[lane]   = direction.y;
+  _dz[lane]   = direction.z;
+  _ix[lane]   = 1.0f / direction.x;
+  _iy[lane]   = 1.0f / direction.y;
+  _iz[lane]   = 1.0f / direction.z;
+  _tmin[lane] = tmin;
+  _tmax[lane] = tmax;
+  _active |= (1u << lane);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+constexpr int kNumBins        = 16;
+constexpr float kTraversalCost = 1.0f;
+constexpr float kIntersectCost = 1.0f;
+
+struct Bounds {
+  fvec3 _min = fvec3(std::numeric_limits<float>::max());
+  fvec3 _max = fvec3(-std::numeric_limits<float>::max());
+
+  void grow(const fvec3& pmin, const fvec3& pmax) {
+    _min = _min.minXYZ(pmin);
+    _max = _max.maxXYZ(pmax);
+  }
+  void grow(const Bounds& oth) {
+    grow(oth._min, oth._max);
+  }
+  float area() const {
+    fvec3 d = _max - _min;
+    if (d.x < 0.0f or d.y < 0.0f or d.z < 0.0f)
+      return 0.0f;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+  }
+};
+
+struct BinaryNode {
+  Bounds _bounds;
+  int _left      = -1; // inner if >= 0
+  int _right     = -1;
+  uint32_t _first = 0;
+  uint32_t _count = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// binned SAH binary build over _primIndices
+///////////////////////////////////////////////////////////////////////////////
+
+struct BinaryBuilder {
+
+  BinaryBuilder(const std::vector<BVH4::BuildPrim>& prims, std::vector<uint32_t>& indices, int maxleafsize)
+      : _prims(prims)
+      , _indices(indices)
+      , _maxLeafSize(maxleafsize) {
+    _centroids.resize(prims.size());
+    for (size_t i = 0; i < prims.size(); i++)
+      _centroids[i] = (prims[i]._min + prims[i]._max) * 0.5f;
+    _nodes.reserve(prims.size() * 2 / std::max(maxleafsize, 1) + 1);
+  }
+
+  int build(uint32_t first, uint32_t count, int depth) {
+    int index = int(_nodes.size());
+    _nodes.emplace_back();
+    Bounds bounds, cbounds;
+    for (uint32_t i = first; i < first + count; i++) {
+      const auto& prim = _prims[_indices[i]];
+      bounds.grow(prim._min, prim._max);
+      const auto& c = _centroids[_indices[i]];
+      cbounds.grow(c, c);
+    }
+    _nodes[index]._bounds = bounds;
+    _nodes[index]._first  = first;
+    _nodes[index]._count  = count;
+    if (count <= uint32_t(_maxLeafSize) or depth >= BVH4::kMaxDepth - 1)
+      return index;
+    ////////////////////////////////
+    // best split over all 3 axes
+    ////////////////////////////////
+    float leafcost  = kIntersectCost * float(count);
+    float bestcost  = std::numeric_limits<float>::max();
+    int bestaxis    = -1;
+    int bestbin     = -1;
+    fvec3 cextent   = cbounds._max - cbounds._min;
+    float parentsa  = std::max(bounds.area(), std::numeric_limits<float>::min());
+    for (int axis = 0; axis < 3; axis++) {
+      if (cextent[axis] <= 0.0f)
+        continue;
+      Bounds binbounds[kNumBins];
+      uint32_t bincount[kNumBins] = {};
+      float binscale              = float(kNumBins) / cextent[axis];
+      for (uint32_t i = first; i < first + count; i++) {
+        const auto& prim = _prims[_indices[i]];
+        int b            = std::min(int((_centroids[_indices[i]][axis] - cbounds._min[axis]) * binscale), kNumBins - 1);
+        bincount[b]++;
+        binbounds[b].grow(prim._min, prim._max);
+      }
+      // sweep from the right, then from the left
+      float rightarea[kNumBins];
+      uint32_t rightcount[kNumBins];
+      Bounds accum;
+      uint32_t naccum = 0;
+      for (int b = kNumBins - 1; b > 0; b--) {
+        accum.grow(binbounds[b]);
+        naccum += bincount[b];
+        rightarea[b]  = accum.area();
+        rightcount[b] = naccum;
+      }
+      accum  = Bounds();
+      naccum = 0;
+      for (int b = 0; b < kNumBins - 1; b++) {
+        accum.grow(binbounds[b]);
+        naccum += bincount[b];
+        if (naccum == 0 or rightcount[b + 1] == 0)
+          continue;
+        float cost = kTraversalCost + kIntersectCost * (accum.area() * float(naccum) + rightarea[b + 1] * float(rightcount[b + 1])) / parentsa;
+        if (cost < bestcost) {
+          bestcost = cost;
+          bestaxis = axis;
+          bestbin  = b;
+        }
+      }
+    }
+    ////////////////////////////////
+    uint32_t mid = first;
+    if (bestaxis >= 0 and bestcost < leafcost) {
+      float binscale = float(kNumBins) / cextent[bestaxis];
+      auto it        = std::partition(_indices.begin() + first, _indices.begin() + first + count, [&](uint32_t idx) {
+        int b = std::min(int((_centroids[idx][bestaxis] - cbounds._min[bestaxis]) * binscale), kNumBins - 1);
+        return b <= bestbin;
+      });
+      mid = uint32_t(it - _indices.begin());
+    } else if (count > uint32_t(_maxLeafSize) * 4) {
+      // SAH says leaf (or centroids coincide) but the leaf would be huge,
+      //  median split along the widest centroid axis
+      int axis = (cextent.x >= cextent.y and cextent.x >= cextent.z) ? 0 : ((cextent.y >= cextent.z) ? 1 : 2);
+      mid      = first + count / 2;
+      std::nth_element(
+          _indices.begin() + first, _indices.begin() + mid, _indices.begin() + first + count, [&](uint32_t a, uint32_t b) {
+            return _centroids[a][axis] < _centroids[b][axis];
+          });
+    } else {
+      return index;
+    }
+    OrkAssert(mid > first and mid < first + count);
+    int left               = build(first, mid - first, depth + 1);
+    int right              = build(mid, first + count - mid, depth + 1);
+    _nodes[index]._left  = left;
+    _nodes[index]._right = right;
+    return index;
+  }
+
+  const std::vector<BVH4::BuildPrim>& _prims;
+  std::vector<uint32_t>& _indices;
+  std::vector<fvec3> _centroids;
+  std::vector<BinaryNode> _nodes;
+  int _maxLeafSize;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// binary -> 4 wide : keep opening the largest inner child until 4 lanes
+///////////////////////////////////////////////////////////////////////////////
+
+int _collapse(const std::vector<BinaryNode>& binnodes, int binindex, std::vector<BVH4::Node>& out) {
+  int children[BVH4::kWidth];
+  int numchildren = 0;
+  const auto& bnode = binnodes[binindex];
+  if (bnode._left < 0) {
+    children[numchildren++] = binindex;
+  } else {
+    children[numchildren++] = bnode._left;
+    children[numchildren++] = bnode._right;
+    while (numchildren < BVH4::kWidth) {
+      int best      = -1;
+      float bestsa  = -1.0f;
+      for (int i = 0; i < numchildren; i++) {
+        const auto& c = binnodes[children[i]];
+        if (c._left >= 0 and c._bounds.area() > bestsa) {
+          bestsa = c._bounds.area();
+          best   = i;
+        }
+      }
+      if (best < 0)
+        break;
+      int opened              = children[best];
+      children[best]          = binnodes[opened]._left;
+      children[numchildren++] = binnodes[opened]._right;
+    }
+  }
+  int index = int(out.size());
+  out.emplace_back();
+  for (int i = 0; i < BVH4::kWidth; i++) {
+    auto& node = out[index];
+    if (i >= numchildren) {
+      node._minx[i] = node._miny[i] = node._minz[i] = std::numeric_limits<float>::infinity();
+      node._maxx[i] = node._maxy[i] = node._maxz[i] = -std::numeric_limits<float>::infinity();
+      node._child[i] = -1;
+      node._count[i] = 0;
+      continue;
+    }
+    const auto& c = binnodes[children[i]];
+    node._minx[i] = c._bounds._min.x;
+    node._miny[i] = c._bounds._min.y;
+    node._minz[i] = c._bounds._min.z;
+    node._maxx[i] = c._bounds._max.x;
+    node._maxy[i] = c._bounds._max.y;
+    node._maxz[i] = c._bounds._max.z;
+    if (c._left < 0) {
+      node._child[i] = int32_t(c._first);
+      node._count[i] = int32_t(c._count);
+    } else {
+      int child      = _collapse(binnodes, children[i], out); // may reallocate out
+      out[index]._child[i] = child;
+      out[index]._count[i] = 0;
+    }
+  }
+  return index;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BVH4::clear() {
+  _nodes.clear();
+  _primIndices.clear();
+  _boundsMin = fvec3();
+  _boundsMax = fvec3();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BVH4::build(const std::vector<BuildPrim>& prims, int maxleafsize) {
+  clear();
+  if (prims.empty())
+    return;
+  _primIndices.resize(prims.size());
+  for (size_t i = 0; i < prims.size(); i++)
+    _primIndices[i] = uint32_t(i);
+  BinaryBuilder builder(prims, _primIndices, std::max(maxleafsize, 1));
+  builder.build(0, uint32_t(prims.size()), 0);
+  _nodes.reserve(builder._nodes.size() / 2 + 1);
+  _collapse(builder._nodes, 0, _nodes);
+  _boundsMin = builder._nodes[0]._bounds._min;
+  _boundsMax = builder._nodes[0]._bounds._max;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BVH4::serialize(DataBlock& out) const {
+  out.addItem<uint64_t>(_nodes.size());
+  out.addItem<uint64_t>(_primIndices.size());
+  out.addItem<fvec3>(_boundsMin);
+  out.addItem<fvec3>(_boundsMax);
+  out.addData(_nodes.data(), _nodes.size() * sizeof(Node));
+  out.addData(_primIndices.data(), _primIndices.size() * sizeof(uint32_t));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool BVH4::deserialize(DataBlockInputStream& inp) {
+  clear();
+  if (inp._cursor + 2 * sizeof(uint64_t) + 2 * sizeof(fvec3) > inp.length())
+    return false;
+  size_t numnodes   = inp.getItem<uint64_t>();
+  size_t numindices = inp.getItem<uint64_t>();
+  _boundsMin        = inp.getItem<fvec3>();
+  _boundsMax        = inp.getItem<fvec3>();
+  size_t nodebytes  = numnodes * sizeof(Node);
+  size_t idxbytes   = numindices * sizeof(uint32_t);
+  if (inp._cursor + nodebytes + idxbytes > inp.length())
+    return false;
+  _nodes.resize(numnodes);
+  memcpy(_nodes.data(), inp.current(), nodebytes);
+  inp.advance(nodebytes);
+  _primIndices.resize(numindices);
+  memcpy(_primIndices.data(), inp.current(), idxbytes);
+  inp.advance(idxbytes);
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork
+///////////////////////////////////////////////////////////////////////////////
@@ -25,7 +25,7 @@
 
 //#pragma comment( lib, "devil.lib" )
 
-extern s64 giNumRays;
+extern std::atomic<s64> giNumRays;
 
 using namespace ork;
 
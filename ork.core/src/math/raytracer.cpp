@@ -19,9 +19,13 @@
 #include <ork/kernel/Array.h>
 #include <ork/kernel/Array.hpp>
 #include <ork/kernel/gstack.h>
+#include <ork/kernel/opq.h>
+#include <ork/kernel/timer.h>
 #include <ork/file/chunkfile.h>
 #include <ork/file/chunkfile.inl>
 #include <queue>
+#include <atomic>
+#include <thread>
 //#include <boost/gil/typedefs.hpp>
 //#include <boost/cast.hpp>
 //#include <boost/gil/extension/io/png_dynamic_io.hpp>
@@ -33,7 +37,7 @@
 #include <unistd.h>
 #endif
 
-s64 giNumRays = 0;
+std::atomic<s64> giNumRays = 0; // rays cast through the Engine
 
 namespace ork {
 
@@ -45,8 +49,34 @@ static const int kIW       = 2048;
 static const int kOS       = 0;
 static const float kJITTER = 0.5f; // 0.5
 
-static int GetNumCores() {
-  return OldSchool::GetNumCores();
+///////////////////////////////////////////////////////////////////////////////
+// items are claimed in chunks through an atomic counter on the
+//  concurrent opq, the calling thread helps and waits for the stragglers
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename fn_t> static void parallelChunks(int numchunks, const char* name, const fn_t& fn) {
+  struct ChunkState {
+    std::atomic<int> _next = 0;
+    std::atomic<int> _done = 0;
+  };
+  auto state      = std::make_shared<ChunkState>();
+  auto run_chunks = [state, numchunks, &fn]() {
+    int ichunk = state->_next.fetch_add(1);
+    while (ichunk < numchunks) {
+      fn(ichunk);
+      state->_done.fetch_add(1, std::memory_order_release);
+      ichunk = state->_next.fetch_add(1);
+    }
+  };
+  auto q         = opq::concurrentQueue();
+  int numhelpers = std::min(numchunks, q->_numThreadsRunning.load() + 1) - 1;
+  for (int i = 0; i < numhelpers; i++) {
+    q->enqueue(run_chunks, name);
+  }
+  run_chunks();
+  while (state->_done.load(std::memory_order_acquire) < numchunks) {
+    std::this_thread::yield();
+  }
 }
 
 void RgmTri::Compute() {
@@ -370,7 +400,7 @@ bool RaytTriangle::IntersectBox(const AABox& a_Box) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void RaytTriangle::Rasterize(Engine* peng) const {
+void RaytTriangle::Rasterize(Engine* peng, int iy0, int iy1) const {
   int iw = peng->width();
   int ih = peng->height();
 
@@ -383,6 +413,11 @@ void RaytTriangle::Rasterize(Engine* peng) const {
   fvec3 v1(uv1.x * iw, uv1.y * ih, 0.0f);
   fvec3 v2(uv2.x * iw, uv2.y * ih, 0.0f);
 
+  int iminy = std::min(int(v0.y), std::min(int(v1.y), int(v2.y)));
+  int imaxy = std::max(int(v0.y), std::max(int(v1.y), int(v2.y)));
+  if (imaxy < iy0 or iminy >= iy1)
+    return;
+
   BakeShadowFragment bv0, bv1, bv2;
   bv0.mPos = mRgmPoly->mpv0->pos;
   bv1.mPos = mRgmPoly->mpv1->pos;
@@ -392,7 +427,7 @@ void RaytTriangle::Rasterize(Engine* peng) const {
   bv2.mNrm = mRgmPoly->mpv2->nrm;
 
   peng->RasterizeTriangle(
-      *bshader, int(v0.x), int(v0.y), bv0, int(v1.x), int(v1.y), bv1, int(v2.x), int(v2.y), bv2);
+      *bshader, int(v0.x), int(v0.y), bv0, int(v1.x), int(v1.y), bv1, int(v2.x), int(v2.y), bv2, iy0, iy1);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -436,14 +471,14 @@ bool RaytSphere::IntersectBox(const AABox& a_Box) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void RaytSphere::Rasterize(Engine* peng) const {
+void RaytSphere::Rasterize(Engine* peng, int iy0, int iy1) const {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 AABox RaytSphere::GetAABox() const {
-  AABox ret;
-  return ret;
+  fvec3 r(mRadius, mRadius, mRadius);
+  return AABox(mCenter - r, mCenter + r);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -486,7 +521,8 @@ fvec3 RaytSphere::GetNormal(const fvec3& a_Pos) const {
 
 Scene::Scene()
     : mExtends()
-    , mpFixedGrid(0) {
+    , mpFixedGrid(0)
+    , mUseFixedGrid(false) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -500,6 +536,10 @@ void Scene::ExitScene() {
   if (mpFixedGrid)
     delete mpFixedGrid;
   mpFixedGrid = 0;
+  mBvh.clear();
+  mBvhPrims.clear();
+  mBvhTriangles.clear();
+  mBvhIsTriangle.clear();
 }
 
 bool Scene::InitScene(const AABox& scene_box) {
@@ -513,9 +553,9 @@ bool Scene::InitScene(const AABox& scene_box) {
   // mat->SetParameters( 0.9f, 0, fvec3( 0.9f, 0.9f, 1 ), 0.3f, 0.7f );
   // mat->SetRefrIndex( 1.3f );
 
-  mExtends = scene_box;
+  ExitScene();
 
-  mpFixedGrid = new FixedGrid;
+  mExtends = scene_box;
 
   orkvector<const Primitive*> Prims;
 
@@ -534,11 +574,210 @@ bool Scene::InitScene(const AABox& scene_box) {
     }
   }
 
-  mpFixedGrid->BuildGrid(scene_box, Prims);
+  if (mUseFixedGrid) {
+    mpFixedGrid = new FixedGrid;
+    mpFixedGrid->BuildGrid(scene_box, Prims);
+    return true;
+  }
+
+  ///////////////////////////////////////////
+  // BVH, primitives stored in leaf order
+  //  triangles are flattened so leaves do not need the virtual Intersect
+  ///////////////////////////////////////////
+
+  int inumprims = int(Prims.size());
+  std::vector<BVH4::BuildPrim> buildprims(inumprims);
+  for (int ip = 0; ip < inumprims; ip++) {
+    AABox box           = Prims[ip]->GetAABox();
+    buildprims[ip]._min = box.Min();
+    buildprims[ip]._max = box.Max();
+  }
+  mBvh.build(buildprims, 4);
+
+  mBvhPrims.resize(inumprims);
+  mBvhTriangles.resize(inumprims);
+  mBvhIsTriangle.resize(inumprims);
+  for (int ip = 0; ip < inumprims; ip++) {
+    const Primitive* prim = Prims[mBvh._primIndices[ip]];
+    mBvhPrims[ip]         = prim;
+    auto tri              = dynamic_cast<const RaytTriangle*>(prim);
+    mBvhIsTriangle[ip]    = (tri != nullptr);
+    if (tri) {
+      const fvec3& v0       = tri->GetVertex(0)->pos;
+      mBvhTriangles[ip].mP0 = v0;
+      mBvhTriangles[ip].mE1 = tri->GetVertex(1)->pos - v0;
+      mBvhTriangles[ip].mE2 = tri->GetVertex(2)->pos - v0;
+    }
+  }
+  orkprintf("raytracer: BVH prims<%d> nodes<%zu>\n", inumprims, mBvh._nodes.size());
+
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// double sided moller trumbore, same hits as RaytTriangle::Intersect
+///////////////////////////////////////////////////////////////////////////////
+
+static inline bool intersectAccelTriangle(
+    const fvec3& p0,
+    const fvec3& e1,
+    const fvec3& e2,
+    const fvec3& org,
+    const fvec3& dir,
+    float tmin,
+    float tmax,
+    float& tout) {
+  fvec3 pvec = dir.crossWith(e2);
+  float det  = e1.dotWith(pvec);
+  if (fabsf(det) < 1.0e-12f)
+    return false;
+  float invdet = 1.0f / det;
+  fvec3 tvec   = org - p0;
+  float u      = tvec.dotWith(pvec) * invdet;
+  if (u < 0.0f or u > 1.0f)
+    return false;
+  fvec3 qvec = tvec.crossWith(e1);
+  float v    = dir.dotWith(qvec) * invdet;
+  if (v < 0.0f or (u + v) > 1.0f)
+    return false;
+  float t = e2.dotWith(qvec) * invdet;
+  if (t <= tmin or t >= tmax)
+    return false;
+  tout = t;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
+bool Scene::FindNearest(const fray3& ray, float& dist, const Primitive*& prim) const {
+  if (mpFixedGrid) {
+    fvec3 isect;
+    return mpFixedGrid->FindNearest(ray, dist, isect, prim);
+  }
+  BVH4Ray bray(ray.mOrigin, ray.mDirection, 0.0f, dist);
+  const Primitive* hitprim = nullptr;
+  mBvh.traverse(bray, [&](uint32_t first, uint32_t count, BVH4Ray& r) -> bool {
+    for (uint32_t i = first; i < first + count; i++) {
+      float t = r._tmax;
+      if (mBvhIsTriangle[i]) {
+        const auto& tri = mBvhTriangles[i];
+        if (not intersectAccelTriangle(tri.mP0, tri.mE1, tri.mE2, r._origin, r._direction, r._tmin, r._tmax, t))
+          continue;
+      } else {
+        fvec3 isect;
+        if (not mBvhPrims[i]->Intersect(ray, isect, t) or t <= r._tmin or t >= r._tmax)
+          continue;
+      }
+      r._tmax = t;
+      hitprim = mBvhPrims[i];
+    }
+    return false;
+  });
+  if (hitprim == nullptr)
+    return false;
+  dist = bray._tmax;
+  prim = hitprim;
   return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+bool Scene::Occluded(const fray3& ray, float maxdist) const {
+  if (mpFixedGrid) {
+    float dist               = maxdist;
+    const Primitive* hitprim = nullptr;
+    return FindNearest(ray, dist, hitprim);
+  }
+  bool occluded = false;
+  BVH4Ray bray(ray.mOrigin, ray.mDirection, 0.0f, maxdist);
+  mBvh.traverse(bray, [&](uint32_t first, uint32_t count, BVH4Ray& r) -> bool {
+    for (uint32_t i = first; i < first + count; i++) {
+      float t = r._tmax;
+      if (mBvhIsTriangle[i]) {
+        const auto& tri = mBvhTriangles[i];
+        occluded        = intersectAccelTriangle(tri.mP0, tri.mE1, tri.mE2, r._origin, r._direction, r._tmin, r._tmax, t);
+      } else {
+        fvec3 isect;
+        occluded = mBvhPrims[i]->Intersect(ray, isect, t) and t > r._tmin and t < r._tmax;
+      }
+      if (occluded)
+        return true;
+    }
+    return false;
+  });
+  return occluded;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Scene::FindNearest(BVH4Packet& packet, const Primitive** prims) const {
+  constexpr int N = BVH4Packet::kSize;
+  for (int r = 0; r < N; r++)
+    prims[r] = nullptr;
+  if (mpFixedGrid) {
+    for (int r = 0; r < N; r++) {
+      if (packet._active & (1u << r)) {
+        fray3 ray(fvec3(packet._ox[r], packet._oy[r], packet._oz[r]), fvec3(packet._dx[r], packet._dy[r], packet._dz[r]));
+        float dist = packet._tmax[r];
+        if (FindNearest(ray, dist, prims[r]))
+          packet._tmax[r] = dist;
+      }
+    }
+    return;
+  }
+  mBvh.traversePacket(packet, [&](uint32_t first, uint32_t count, BVH4Packet& pk, uint32_t mask) -> bool {
+    for (uint32_t i = first; i < first + count; i++) {
+      if (mBvhIsTriangle[i]) {
+        ////////////////////////////////
+        // one triangle against all lanes, straight line code,
+        //  lanes outside the mask are discarded afterwards
+        ////////////////////////////////
+        const auto& tri = mBvhTriangles[i];
+        float tt[N];
+        uint32_t hit[N];
+        for (int r = 0; r < N; r++) {
+          float px     = pk._dy[r] * tri.mE2.z - pk._dz[r] * tri.mE2.y;
+          float py     = pk._dz[r] * tri.mE2.x - pk._dx[r] * tri.mE2.z;
+          float pz     = pk._dx[r] * tri.mE2.y - pk._dy[r] * tri.mE2.x;
+          float det    = tri.mE1.x * px + tri.mE1.y * py + tri.mE1.z * pz;
+          float invdet = 1.0f / det;
+          float tx     = pk._ox[r] - tri.mP0.x;
+          float ty     = pk._oy[r] - tri.mP0.y;
+          float tz     = pk._oz[r] - tri.mP0.z;
+          float u      = (tx * px + ty * py + tz * pz) * invdet;
+          float qx     = ty * tri.mE1.z - tz * tri.mE1.y;
+          float qy     = tz * tri.mE1.x - tx * tri.mE1.z;
+          float qz     = tx * tri.mE1.y - ty * tri.mE1.x;
+          float v      = (pk._dx[r] * qx + pk._dy[r] * qy + pk._dz[r] * qz) * invdet;
+          float t      = (tri.mE2.x * qx + tri.mE2.y * qy + tri.mE2.z * qz) * invdet;
+          hit[r]       = uint32_t(fabsf(det) >= 1.0e-12f) & uint32_t(u >= 0.0f) & uint32_t(v >= 0.0f)
+                  & uint32_t((u + v) <= 1.0f) & uint32_t(t > pk._tmin[r]) & uint32_t(t < pk._tmax[r]);
+          tt[r] = t;
+        }
+        for (int r = 0; r < N; r++) {
+          if (((mask >> r) & 1) and hit[r]) {
+            pk._tmax[r] = tt[r];
+            prims[r]    = mBvhPrims[i];
+          }
+        }
+      } else {
+        for (int r = 0; r < N; r++) {
+          if (0 == ((mask >> r) & 1))
+            continue;
+          fray3 ray(fvec3(pk._ox[r], pk._oy[r], pk._oz[r]), fvec3(pk._dx[r], pk._dy[r], pk._dz[r]));
+          fvec3 isect;
+          float t = pk._tmax[r];
+          if (mBvhPrims[i]->Intersect(ray, isect, t) and t > pk._tmin[r] and t < pk._tmax[r]) {
+            pk._tmax[r] = t;
+            prims[r]    = mBvhPrims[i];
+          }
+        }
+      }
+    }
+    return false;
+  });
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -730,6 +969,13 @@ static float AreaOfTri(const fvec3& A, const fvec3& B, const fvec3& C) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool Engine::FindNearest(const fray3& a_Ray, float& dist, const Primitive*& prim) {
+  giNumRays.fetch_add(1, std::memory_order_relaxed);
+  return mScene->FindNearest(a_Ray, dist, prim);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 const Primitive* Engine::Raytrace(const fray3& ray, const int irecdepth, const float irindex, fvec3& acc, float& dist) {
   const Primitive* prim = 0;
 
@@ -737,13 +983,22 @@ const Primitive* Engine::Raytrace(const fray3& ray, const int irecdepth, const f
   // find the nearest intersection
   ////////////////////////////////////////////////////
 
-  acc = fvec3(0.1f, 0.1f, 0.2f);
-  fvec3 P;
-  bool bhit = GetScene()->GetFixedGrid()->FindNearest(ray, dist, P, prim);
+  bool bhit = FindNearest(ray, dist, prim);
   if (false == bhit)
-    return 0;
+    prim = 0;
+  Shade(ray, prim, dist, acc);
+  return prim;
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
-  /*	const RgmTri& tri = *prim->mRgmPoly;
+void Engine::Shade(const fray3& ray, const Primitive* prim, float dist, fvec3& acc) {
+  acc = fvec3(0.1f, 0.1f, 0.2f);
+  if (0 == prim)
+    return;
+
+  /*	fvec3 P = ray.mOrigin + ray.mDirection * dist;
+      const RgmTri& tri = *prim->mRgmPoly;
 
       ////////////////////////////////////////////////////
       // Compute Barycentric
@@ -791,7 +1046,7 @@ const Primitive* Engine::Raytrace(const fray3& ray, const int irecdepth, const f
       if( fdot <= 0.0f )
       {
           acc = fvec3::Black();
-          return prim;
+          return;
       }
       /////////////////////////////////////////////
       // perform shadowing test
@@ -800,23 +1055,12 @@ const Primitive* Engine::Raytrace(const fray3& ray, const int irecdepth, const f
       {
           const float shadowbias = 0.1f;
           Ray3 RayToLight( P+LightDir*shadowbias, LightDir );
-          const Primitive* primL = 0;
-
-          float shadowdist = 100000.0f;
-          fvec3 ShadowPos;
-          bool bshadowhit = GetScene()->GetFixedGrid()->FindNearest( RayToLight, shadowdist, ShadowPos, primL );
-
-          if( bshadowhit )
-          {
-              float disttolight = LMP.Mag();
-              if( shadowdist<disttolight )
-              {	acc *= 0.5f;
-                  return primL;
-              }
+          float disttolight = LMP.Mag();
+          if( GetScene()->Occluded( RayToLight, disttolight ) )
+          {	acc *= 0.5f;
+              return;
           }
       }*/
-
-  return prim;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -921,7 +1165,9 @@ void Engine::RasterizeTriangle(
     const BakeShadowFragment& d2,
     int x3,
     int y3,
-    const BakeShadowFragment& d3)
+    const BakeShadowFragment& d3,
+    int clip_y0,
+    int clip_y1)
 
 {
   SpanCtx ctx;
@@ -936,12 +1182,14 @@ void Engine::RasterizeTriangle(
   for (orkset<SpanFragment>::iterator it = scanned_pnts.begin(); it != scanned_pnts.end(); ++it) {
     int y = it->y;
     if (y != cur_yval) {
-      if (same_yval.size()) {
+      // only rows inside [clip_y0,clip_y1) are shaded,
+      //  but every row change starts a fresh span
+      if (same_yval.size() and cur_yval >= clip_y0 and cur_yval < clip_y1) {
         orkset<SpanFragment>::iterator it1 = same_yval.begin();
         orkset<SpanFragment>::iterator it2 = --same_yval.end();
         DrawSpanE(shader, it1->x, cur_yval, it1->mData, it2->x, cur_yval, it2->mData, ctx, 0);
-        same_yval.clear();
       }
+      same_yval.clear();
       cur_yval = y;
     }
     same_yval.insert(*it);
@@ -1040,81 +1288,54 @@ const Primitive* Engine::RenderRay(fvec3 screen_pos, fvec3& acc) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-struct RenderingJobCtx {
-  Engine* mpEngine;
-  int miCore;
-  int miNumCores;
-  int miNumRays;
-};
-
-///////////////////////////////////////////////////////////////////////////////
-
-void* RenderingJobThread(void* vptr_args) {
-  RenderingJobCtx* mpCtx = (RenderingJobCtx*)vptr_args;
-
-  mpCtx->miNumRays = 0;
-  int ih           = mpCtx->mpEngine->height();
-  int iw           = mpCtx->mpEngine->width();
-
-  const fvec3& cTL = mpCtx->mpEngine->CornerTL();
-  const fvec3& cTR = mpCtx->mpEngine->CornerTR();
-  const fvec3& cBL = mpCtx->mpEngine->CornerBL();
-  const fvec3& cBR = mpCtx->mpEngine->CornerBR();
-
-  const fvec3& cQX = (cTR - cTL) * 1.0f / float(iw);
-  const fvec3& cQY = (cBL - cTL) * 1.0f / float(ih);
-
-  const Jitterer my_jitter(kOS, kJITTER, cQX, cQY);
-
-  for (int y = mpCtx->miCore; y < ih; y += mpCtx->miNumCores) {
-    if (y % 64 == mpCtx->miCore)
-      orkprintf("core<%d> y<%d>\n", mpCtx->miCore, y);
-
-    float fy = float(y) / float(ih);
-    fvec3 lSC, rSC;
-    lSC.lerp(cTL, cBL, fy);
-    rSC.lerp(cTR, cBR, fy);
-    for (int x = 0; x < iw; x++) {
-      float fx = float(x) / float(iw);
-      fvec3 screen_pos, jittered_pos;
-      screen_pos.lerp(lSC, rSC, fx);
-
-      fvec3 acc(0, 0, 0);
-      for (int isamp = 0; isamp < my_jitter.miNumSamples; isamp++) {
-        jittered_pos = screen_pos + my_jitter.GetSample(isamp);
-
-        fvec3 sample(0, 0, 0);
-
-        const Primitive* prim = mpCtx->mpEngine->RenderRay(jittered_pos, sample);
-        acc += sample;
-        mpCtx->miNumRays++;
+int Engine::RenderTile(int ix0, int iy0, int ix1, int iy1, const Jitterer& jitter) {
+  constexpr int kPW = 4; // packet footprint in pixels
+  constexpr int kPH = BVH4Packet::kSize / kPW;
+  int inumrays      = 0;
+  for (int y = iy0; y < iy1; y += kPH) {
+    for (int x = ix0; x < ix1; x += kPW) {
+      fvec3 acc[BVH4Packet::kSize];
+      for (int isamp = 0; isamp < jitter.miNumSamples; isamp++) {
+        BVH4Packet packet;
+        for (int lane = 0; lane < BVH4Packet::kSize; lane++) {
+          int px = x + (lane % kPW);
+          int py = y + (lane / kPW);
+          if (px >= ix1 or py >= iy1)
+            continue;
+          fvec3 screen_pos = mCornerTL + mDX * float(px) + mDY * float(py) + jitter.GetSample(isamp);
+          packet.setRay(lane, mEye, (screen_pos - mEye).normalized(), 0.0f, 100000.0f);
+        }
+        const Primitive* prims[BVH4Packet::kSize];
+        mScene->FindNearest(packet, prims);
+        for (int lane = 0; lane < BVH4Packet::kSize; lane++) {
+          if (0 == (packet._active & (1u << lane)))
+            continue;
+          fray3 ray(mEye, fvec3(packet._dx[lane], packet._dy[lane], packet._dz[lane]));
+          fvec3 sample;
+          Shade(ray, prims[lane], packet._tmax[lane], sample);
+          acc[lane] += sample;
+          inumrays++;
+        }
+      }
+      for (int lane = 0; lane < BVH4Packet::kSize; lane++) {
+        int px = x + (lane % kPW);
+        int py = y + (lane / kPW);
+        if (px >= ix1 or py >= iy1)
+          continue;
+        fvec3 color = acc[lane] * (1.0f / float(jitter.miNumSamples));
+        int red     = std::clamp(int(color.x * 256), 0, 255);
+        int green   = std::clamp(int(color.y * 256), 0, 255);
+        int blue    = std::clamp(int(color.z * 256), 0, 255);
+        int ipix    = (py * miW) + ((miW - 1) - px);
+        RayPixel& rp = mDest[ipix];
+        rp.r         = red;
+        rp.g         = green;
+        rp.b         = blue;
       }
-
-      acc = acc * (1.0f / float(my_jitter.miNumSamples));
-      int red, green, blue;
-      red   = (int)(acc.x * 256);
-      green = (int)(acc.y * 256);
-      blue  = (int)(acc.z * 256);
-      if (red > 255)
-        red = 255;
-      if (green > 255)
-        green = 255;
-      if (blue > 255)
-        blue = 255;
-      if (red < 0)
-        red = 0;
-      if (green < 0)
-        green = 0;
-      if (blue < 0)
-        blue = 0;
-      int ipix     = (y * iw) + ((iw - 1) - x);
-      RayPixel& rp = mpCtx->mpEngine->RefPixel(ipix);
-      rp.r         = red;
-      rp.g         = green;
-      rp.b         = blue;
     }
   }
-  return 0;
+  giNumRays.fetch_add(inumrays, std::memory_order_relaxed);
+  return inumrays;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1134,48 +1355,31 @@ bool Engine::Render(const AABox& bbox, const std::string& OutputName) {
   GetScene()->InitScene(bbox);
   InitRender(eye, ctr);
 
+  /////////////////////////////////////////////////////////////////
+  // tiles over the concurrent opq
   /////////////////////////////////////////////////////////////////
 
-  int inumcores = GetNumCores();
-  orkvector<RenderingJobCtx*> JobCtxVect;
-#if 0
-	orkvector<pthread_t>		ThreadVect;
-	f64 ftimeA = OldSchool::GetRef().GetSystemRelTime(  );
-	for( int ic=0; ic<inumcores; ic++ )
-	{
-		RenderingJobCtx* ctx = new RenderingJobCtx;
-		ctx->mpEngine = this;
-		ctx->miNumCores = inumcores;
-		ctx->miCore = ic;
-
-		pthread_t job_thread;
-		if (pthread_create(&job_thread, NULL, RenderingJobThread, (void*)ctx) != 0)
-		{
-			OrkAssert(false);
-		}
-
-		ThreadVect.push_back(job_thread);
-		JobCtxVect.push_back(ctx);
-	}
-	for( orkvector<pthread_t>::iterator it=ThreadVect.begin(); it!=ThreadVect.end(); it++ )
-	{
-		pthread_t job = (*it);
-		pthread_join(job, NULL);
-	}
-	int inumrays = 0;
-	for( orkvector<RenderingJobCtx*>::iterator it=JobCtxVect.begin(); it!=JobCtxVect.end(); it++ )
-	{
-		RenderingJobCtx* ctx = *it;
-		inumrays += ctx->miNumRays;
-	}
-	f64 ftimeB = OldSchool::GetRef().GetSystemRelTime(  );
-	f64 ftime = ftimeB-ftimeA;
-	float frayspersec = float(inumrays)/ftime;
-	orkprintf( "Rays<%d> Time<%f? RaysPerSec<%f>\n", inumrays, ftime,  frayspersec );
-
-	/////////////////////////////////////////////////////////////////
-	GetScene()->ExitScene();
-#endif
+  constexpr int ktilesize = 32;
+  const Jitterer my_jitter(kOS, kJITTER, mDX, mDY);
+  int inumtilesx = (miW + ktilesize - 1) / ktilesize;
+  int inumtilesy = (miH + ktilesize - 1) / ktilesize;
+  std::atomic<s64> inumrays = 0;
+
+  ork::Timer timer;
+  timer.Start();
+  parallelChunks(inumtilesx * inumtilesy, "raytracer.render", [&](int itile) {
+    int ix0 = (itile % inumtilesx) * ktilesize;
+    int iy0 = (itile / inumtilesx) * ktilesize;
+    int ix1 = std::min(ix0 + ktilesize, miW);
+    int iy1 = std::min(iy0 + ktilesize, miH);
+    inumrays.fetch_add(RenderTile(ix0, iy0, ix1, iy1, my_jitter), std::memory_order_relaxed);
+  });
+  f64 ftime         = timer.SecsSinceStart();
+  float frayspersec = float(inumrays.load()) / ftime;
+  orkprintf("Rays<%d> Time<%f> RaysPerSec<%f>\n", int(inumrays.load()), ftime, frayspersec);
+
+  /////////////////////////////////////////////////////////////////
+  GetScene()->ExitScene();
 
   /*	ilInit();
       ILuint image;
@@ -1201,47 +1405,6 @@ bool Engine::Render(const AABox& bbox, const std::string& OutputName) {
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
-struct BakingJobCtx {
-  Engine* mpEngine;
-  int miCore;
-  int miNumCores;
-  int miNumRays;
-};
-
-///////////////////////////////////////////////////////////////////////////////
-
-void* BakingJobThread(void* pval) {
-  BakingJobCtx* mpCtx = (BakingJobCtx*)pval;
-
-  const orkmap<std::string, const RgmGeoSet*>& geosets = mpCtx->mpEngine->GetScene()->GetGeoSets();
-
-  for (orkmap<std::string, const RgmGeoSet*>::const_iterator it = geosets.begin(); it != geosets.end(); it++) {
-    const std::string& geoname = it->first;
-    if (geoname.find("raster_") != std::string::npos) {
-      const RgmGeoSet* RasterSet = it->second;
-
-      int inumtri = RasterSet->NumPrimitives();
-      int iw      = mpCtx->mpEngine->width();
-      int ih      = mpCtx->mpEngine->height();
-      int itrictr = inumtri / mpCtx->miNumCores;
-
-      int icntdwn = (inumtri >> 8); //
-
-      if (0 == icntdwn)
-        icntdwn = 1;
-
-      for (int ip = mpCtx->miCore; ip < inumtri; ip += mpCtx->miNumCores) {
-        if (itrictr % icntdwn == 0)
-          orkprintf("core<%d> numleft<%d> geoname<%s>\n", mpCtx->miCore, itrictr, geoname.c_str());
-        itrictr--;
-        const Primitive* prim = RasterSet->GetPrimitive(ip);
-        prim->Rasterize(mpCtx->mpEngine);
-      }
-    }
-  }
-  return 0;
-}
-
 bool Engine::Bake(const AABox& bbox, const std::string& OutputName) {
   int iKKos = kOS;
 
@@ -1270,44 +1433,33 @@ bool Engine::Bake(const AABox& bbox, const std::string& OutputName) {
   /////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////
-  // f64 ftimeA = OldSchool::GetRef().GetSystemRelTime(  );
-  {
-    int inumcores = GetNumCores();
-    orkvector<BakingJobCtx*> JobCtxVect;
-#if 0
-		orkvector<pthread_t>	ThreadVect;
-		for( int ic=0; ic<inumcores; ic++ )
-		{
-			BakingJobCtx* ctx = new BakingJobCtx;
-			ctx->mpEngine = this;
-			ctx->miNumCores = inumcores;
-			ctx->miCore = ic;
-
-			pthread_t job_thread;
-			if (pthread_create(&job_thread, NULL, BakingJobThread, (void*)ctx) != 0)
-			{
-				OrkAssert(false);
-			}
-
-			ThreadVect.push_back(job_thread);
-
-			JobCtxVect.push_back(ctx);
-		}
-		for( orkvector<pthread_t>::iterator it=ThreadVect.begin(); it!=ThreadVect.end(); it++ )
-		{
-			pthread_t job = (*it);
-			pthread_join(job, NULL);
-		}
-		int inumrays = 0;
-		//for( orkvector<BakingJobCtx*>::iterator it=JobCtxVect.begin(); it!=JobCtxVect.end(); it++ )
-		//{
-		//	RenderingJobCtx* ctx = *it;
-		//	inumrays += ctx->miNumRays;
-		//}
-#endif
+  // raster_ geosets are rasterized into uv space in bands of rows,
+  //  each band rasterizes every prim clipped to its rows, so no two
+  //  workers ever write the same pixel (whatever the uv layout)
+  /////////////////////////////////////////////////////////////////
+  orkvector<const Primitive*> RasterPrims;
+  for (const auto& it : GetScene()->GetGeoSets()) {
+    if (it.first.find("raster_") != std::string::npos) {
+      const auto& prims = it.second->GetPrims();
+      RasterPrims.insert(RasterPrims.end(), prims.begin(), prims.end());
+    }
   }
-  // f64 ftimeB = OldSchool::GetRef().GetSystemRelTime(  );
-  f64 ftime  = 1.0; // ftimeB-ftimeA;
+  constexpr int kbandrows = 16;
+  int inumbands           = (iKIW + kbandrows - 1) / kbandrows;
+  int iprogress           = std::max(inumbands / 16, 1);
+
+  giNumRays = 0;
+  ork::Timer timer;
+  timer.Start();
+  parallelChunks(inumbands, "raytracer.bake", [&](int iband) {
+    if (iband % iprogress == 0)
+      orkprintf("baking band<%d/%d>\n", iband, inumbands);
+    int iy0 = iband * kbandrows;
+    int iy1 = std::min(iy0 + kbandrows, iKIW);
+    for (auto prim : RasterPrims)
+      prim->Rasterize(this, iy0, iy1);
+  });
+  f64 ftime  = timer.SecsSinceStart();
   int inrays = int(giNumRays);
 
   float frayspersec = float(inrays) / ftime;
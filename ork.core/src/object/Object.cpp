@@ -20,6 +20,7 @@
 #include <ork/stream/StringInputStream.h>
 #include <ork/reflect/serialize/JsonDeserializer.h>
 #include <ork/reflect/serialize/JsonSerializer.h>
+#include <ork/reflect/serialize/BinaryDeserializer.h>
 #include <ork/stream/ResizableStringOutputStream.h>
 #include <ork/reflect/serialize/ShallowSerializer.h>
 #include <ork/reflect/serialize/ShallowDeserializer.h>
@@ -161,6 +162,12 @@ object_ptr_t loadObjectFromFile(const char* filename) {
     std::string jsondata;
     jsondata.resize(len);
     file.Read((void*)jsondata.c_str(), len);
+    if (reflect::serdes::binary::isBinary(jsondata.data(), len)) {
+      object_ptr_t instance_out = nullptr;
+      reflect::serdes::BinaryDeserializer deserializer(jsondata);
+      deserializer.deserializeTop(instance_out);
+      return instance_out;
+    }
     return loadObjectFromString(jsondata.c_str());
   }
   return nullptr;
@@ -0,0 +1,804 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/reflect/serialize/BinaryDeserializer.h>
+#include <ork/reflect/properties/ObjectProperty.h>
+#include <ork/reflect/properties/ITypedArray.h>
+#include <ork/rtti/Class.h>
+#include <ork/object/Object.h>
+#include <ork/util/logger.h>
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <cstring>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+
+#include <rapidjson/prettywriter.h>
+
+#pragma GCC diagnostic pop
+
+namespace ork::reflect::serdes {
+static logchannel_ptr_t logchan_bds = logger()->createChannel("reflection.binary.deser", fvec3(0.9, 1, 0.9), false);
+
+using namespace binary;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct BinaryReader {
+
+  BinaryReader(const void* data, size_t length)
+      : _cursor((const uint8_t*)data)
+      , _end(_cursor + length) {
+  }
+
+  void bytes(void* dest, size_t length) {
+    OrkAssert((_cursor + length) <= _end);
+    memcpy(dest, _cursor, length);
+    _cursor += length;
+  }
+  void skip(size_t length) {
+    OrkAssert((_cursor + length) <= _end);
+    _cursor += length;
+  }
+  uint8_t u8() {
+    OrkAssert(_cursor < _end);
+    return *_cursor++;
+  }
+  RecordTag tag() {
+    return RecordTag(u8());
+  }
+  uint64_t varint() {
+    uint64_t value = 0;
+    int shift      = 0;
+    uint8_t byte   = 0;
+    do {
+      byte = u8();
+      value |= uint64_t(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    return value;
+  }
+  template <typename T> T pod() {
+    T value;
+    bytes(&value, sizeof(T));
+    return value;
+  }
+  boost::uuids::uuid uuid() {
+    boost::uuids::uuid value;
+    bytes(&(*value.begin()), 16);
+    return value;
+  }
+
+  const uint8_t* _cursor;
+  const uint8_t* _end;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// advance past one record without decoding it
+////////////////////////////////////////////////////////////////////////////////
+
+static void skipRecord(BinaryReader& reader) {
+  switch (reader.tag()) {
+    case RecordTag::NIL:
+    case RecordTag::FALSE_:
+    case RecordTag::TRUE_:
+      break;
+    case RecordTag::INT32:
+    case RecordTag::UINT32:
+      reader.skip(4);
+      break;
+    case RecordTag::INT64:
+    case RecordTag::UINT64:
+    case RecordTag::DOUBLE:
+      reader.skip(8);
+      break;
+    case RecordTag::STRING:
+      reader.varint();
+      break;
+    case RecordTag::ARRAY: {
+      size_t count = reader.varint();
+      for (size_t i = 0; i < count; i++)
+        skipRecord(reader);
+      break;
+    }
+    case RecordTag::MAP: {
+      size_t count = reader.varint();
+      for (size_t i = 0; i < count; i++) {
+        reader.varint();
+        skipRecord(reader);
+      }
+      break;
+    }
+    case RecordTag::OBJECT: {
+      reader.varint();
+      reader.skip(16);
+      size_t count = reader.varint();
+      for (size_t i = 0; i < count; i++) {
+        reader.varint();
+        skipRecord(reader);
+      }
+      break;
+    }
+    case RecordTag::OBJECT_REF:
+      reader.skip(16);
+      break;
+    case RecordTag::PACKED_INT32:
+    case RecordTag::PACKED_FLOAT:
+      reader.skip(reader.varint() * 4);
+      break;
+    case RecordTag::PACKED_DOUBLE:
+      reader.skip(reader.varint() * 8);
+      break;
+    default:
+      OrkAssert(false);
+      break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// string table and class schemas
+//  schemastrings_out : per schema string indices {classname, propnames...}
+////////////////////////////////////////////////////////////////////////////////
+
+static void readHeader(
+    BinaryReader& reader, //
+    std::vector<std::string>& strings_out,
+    std::vector<ClassSchema>& schemas_out,
+    std::vector<std::vector<size_t>>& schemastrings_out) {
+  uint32_t magic   = reader.pod<uint32_t>();
+  uint32_t version = reader.pod<uint32_t>();
+  OrkAssert(magic == kmagic);
+  if (version != kversion) {
+    logerrchannel()->log("binary serdes: unsupported version<%u>", version);
+    OrkAssert(false);
+  }
+  //////////////////////////////////////////
+  // string table
+  //////////////////////////////////////////
+  size_t numstrings = reader.varint();
+  strings_out.resize(numstrings);
+  for (auto& str : strings_out) {
+    size_t len = reader.varint();
+    str.resize(len);
+    reader.bytes(str.data(), len);
+  }
+  //////////////////////////////////////////
+  // class schemas
+  //////////////////////////////////////////
+  size_t numschemas = reader.varint();
+  schemas_out.resize(numschemas);
+  schemastrings_out.resize(numschemas);
+  for (size_t i = 0; i < numschemas; i++) {
+    auto& schema      = schemas_out[i];
+    size_t classindex = reader.varint();
+    OrkAssert(classindex < numstrings);
+    schema._classname = strings_out[classindex];
+    schema._hash      = reader.pod<uint64_t>();
+    size_t numprops   = reader.varint();
+    schema._propnames.resize(numprops);
+    schemastrings_out[i].push_back(classindex);
+    for (auto& propname : schema._propnames) {
+      size_t propindex = reader.varint();
+      OrkAssert(propindex < numstrings);
+      propname = strings_out[propindex];
+      schemastrings_out[i].push_back(propindex);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct BinaryDecoder {
+
+  using allocator_t = rapidjson::Document::AllocatorType;
+  // per schema string indices : {classname, propnames...}
+  using schemastrings_t = std::vector<std::vector<size_t>>;
+
+  BinaryDecoder(
+      BinaryReader& reader, //
+      allocator_t& allocator,
+      const std::vector<std::string>& strings,
+      const schemastrings_t& schemas)
+      : _reader(reader)
+      , _allocator(allocator)
+      , _strings(strings)
+      , _schemas(schemas) {
+  }
+
+  ////////////////////////////////////////////
+  // strings are not copied, they reference the string table
+  ////////////////////////////////////////////
+
+  rapidjson::Value::StringRefType stringRef(size_t index) const {
+    OrkAssert(index < _strings.size());
+    const auto& str = _strings[index];
+    return rapidjson::StringRef(str.c_str(), str.length());
+  }
+
+  ////////////////////////////////////////////
+
+  void decodeUUID(rapidjson::Value& out) {
+    auto uuidstr = boost::uuids::to_string(_reader.uuid());
+    out.SetString(uuidstr.c_str(), uuidstr.length(), _allocator);
+  }
+
+  ////////////////////////////////////////////
+
+  template <typename T> void decodePacked(rapidjson::Value& out) {
+    size_t count = _reader.varint();
+    std::vector<T> packed(count);
+    _reader.bytes(packed.data(), count * sizeof(T));
+    out.SetArray();
+    out.Reserve(count, _allocator);
+    for (const auto& item : packed)
+      out.PushBack(item, _allocator);
+  }
+
+  ////////////////////////////////////////////
+
+  void decodeValue(rapidjson::Value& out) {
+    switch (_reader.tag()) {
+      case RecordTag::NIL:
+        out.SetNull();
+        break;
+      case RecordTag::FALSE_:
+        out.SetBool(false);
+        break;
+      case RecordTag::TRUE_:
+        out.SetBool(true);
+        break;
+      case RecordTag::INT32:
+        out.SetInt(_reader.pod<int32_t>());
+        break;
+      case RecordTag::UINT32:
+        out.SetUint(_reader.pod<uint32_t>());
+        break;
+      case RecordTag::INT64:
+        out.SetInt64(_reader.pod<int64_t>());
+        break;
+      case RecordTag::UINT64:
+        out.SetUint64(_reader.pod<uint64_t>());
+        break;
+      case RecordTag::DOUBLE:
+        out.SetDouble(_reader.pod<double>());
+        break;
+      case RecordTag::STRING:
+        out.SetString(stringRef(_reader.varint()));
+        break;
+      case RecordTag::ARRAY: {
+        size_t count = _reader.varint();
+        out.SetArray();
+        out.Reserve(count, _allocator);
+        for (size_t i = 0; i < count; i++) {
+          rapidjson::Value item;
+          decodeValue(item);
+          out.PushBack(item, _allocator);
+        }
+        break;
+      }
+      case RecordTag::MAP: {
+        size_t count = _reader.varint();
+        out.SetObject();
+        for (size_t i = 0; i < count; i++) {
+          auto key = stringRef(_reader.varint());
+          rapidjson::Value item;
+          decodeValue(item);
+          out.AddMember(key, item, _allocator);
+        }
+        break;
+      }
+      case RecordTag::OBJECT: {
+        size_t schemaindex = _reader.varint();
+        OrkAssert(schemaindex < _schemas.size());
+        const auto& schema = _schemas[schemaindex];
+        out.SetObject();
+        rapidjson::Value classval(stringRef(schema[0]));
+        out.AddMember("class", classval, _allocator);
+        rapidjson::Value uuidval;
+        decodeUUID(uuidval);
+        out.AddMember("uuid", uuidval, _allocator);
+        rapidjson::Value propsval(rapidjson::kObjectType);
+        size_t numprops = _reader.varint();
+        for (size_t i = 0; i < numprops; i++) {
+          size_t propid = _reader.varint();
+          OrkAssert((propid + 1) < schema.size());
+          rapidjson::Value propval;
+          decodeValue(propval);
+          propsval.AddMember(stringRef(schema[propid + 1]), propval, _allocator);
+        }
+        out.AddMember("properties", propsval, _allocator);
+        break;
+      }
+      case RecordTag::OBJECT_REF: {
+        out.SetObject();
+        rapidjson::Value uuidval;
+        decodeUUID(uuidval);
+        out.AddMember("uuid-ref", uuidval, _allocator);
+        break;
+      }
+      case RecordTag::PACKED_INT32:
+        decodePacked<int32_t>(out);
+        break;
+      case RecordTag::PACKED_FLOAT:
+        decodePacked<float>(out);
+        break;
+      case RecordTag::PACKED_DOUBLE:
+        decodePacked<double>(out);
+        break;
+      default:
+        OrkAssert(false);
+        break;
+    }
+  }
+
+  BinaryReader& _reader;
+  allocator_t& _allocator;
+  const std::vector<std::string>& _strings;
+  const schemastrings_t& _schemas;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void decodeBinary(
+    const void* data, //
+    size_t length,
+    rapidjson::Document& document_out,
+    std::vector<std::string>& strings_out,
+    std::vector<ClassSchema>& schemas_out) {
+
+  OrkAssert(isBinary(data, length));
+  BinaryReader reader(data, length);
+  BinaryDecoder::schemastrings_t schemastrings;
+  readHeader(reader, strings_out, schemas_out, schemastrings);
+  BinaryDecoder decoder(reader, document_out.GetAllocator(), strings_out, schemastrings);
+  decoder.decodeValue(document_out);
+  OrkAssert(reader._cursor == reader._end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string binaryToJson(const std::string& bindata) {
+  rapidjson::Document document;
+  std::vector<std::string> strings;
+  std::vector<ClassSchema> schemas;
+  decodeBinary(bindata.data(), bindata.length(), document, strings, schemas);
+  rapidjson::StringBuffer strbuf;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(strbuf);
+  writer.SetIndent(' ', 1);
+  document.Accept(writer);
+  return strbuf.GetString();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// deserializer node payloads
+//  a container (map / array / packed array) record : the record itself
+//  (for deserializeObject) and the cursor at its next unread element
+////////////////////////////////////////////////////////////////////////////////
+
+struct BinaryContainerNode {
+  BinaryContainerNode(const BinaryReader& record)
+      : _record(record)
+      , _next(record) {
+    _tag       = _next.tag();
+    _remaining = _next.varint();
+  }
+  BinaryReader _record;
+  BinaryReader _next;
+  RecordTag _tag;
+  size_t _remaining = 0;
+};
+
+using binarycontainer_ptr_t = std::shared_ptr<BinaryContainerNode>;
+
+static bool isContainer(RecordTag tag) {
+  switch (tag) {
+    case RecordTag::ARRAY:
+    case RecordTag::MAP:
+    case RecordTag::PACKED_INT32:
+    case RecordTag::PACKED_FLOAT:
+    case RecordTag::PACKED_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// numbers come back as double, as they do from JsonDeserializer
+////////////////////////////////////////////////////////////////////////////////
+
+static bool readLeaf(RecordTag tag, BinaryReader& reader, const std::vector<std::string>& strings, var_t& value_out) {
+  switch (tag) {
+    case RecordTag::NIL:
+      value_out.set<void*>(nullptr);
+      return true;
+    case RecordTag::FALSE_:
+      value_out.set<bool>(false);
+      return true;
+    case RecordTag::TRUE_:
+      value_out.set<bool>(true);
+      return true;
+    case RecordTag::INT32:
+      value_out.set<double>(reader.pod<int32_t>());
+      return true;
+    case RecordTag::UINT32:
+      value_out.set<double>(reader.pod<uint32_t>());
+      return true;
+    case RecordTag::INT64:
+      value_out.set<double>(double(reader.pod<int64_t>()));
+      return true;
+    case RecordTag::UINT64:
+      value_out.set<double>(double(reader.pod<uint64_t>()));
+      return true;
+    case RecordTag::DOUBLE:
+      value_out.set<double>(reader.pod<double>());
+      return true;
+    case RecordTag::STRING: {
+      size_t index = reader.varint();
+      OrkAssert(index < strings.size());
+      value_out.set<std::string>(strings[index]);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static double readPackedElement(RecordTag tag, BinaryReader& reader) {
+  switch (tag) {
+    case RecordTag::PACKED_INT32:
+      return reader.pod<int32_t>();
+    case RecordTag::PACKED_FLOAT:
+      return reader.pod<float>();
+    case RecordTag::PACKED_DOUBLE:
+      return reader.pod<double>();
+    default:
+      OrkAssert(false);
+      return 0.0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BinaryDeserializer::BinaryDeserializer(const void* data, size_t length)
+    : _data((const char*)data, length) {
+  OrkAssert(isBinary(data, length));
+  BinaryReader reader(_data.data(), _data.length());
+  std::vector<std::vector<size_t>> schemastrings;
+  readHeader(reader, _strings, _schemas, schemastrings);
+  _rootoffset = reader._cursor - (const uint8_t*)_data.data();
+  _property_stack.push(nullptr);
+  //////////////////////////////////////////
+  // resolve each schema's properties once :
+  //  by dense id if the live class has the same schema,
+  //  else by name (dropped properties resolve to nullptr)
+  //////////////////////////////////////////
+  _schemaprops.resize(_schemas.size());
+  for (size_t i = 0; i < _schemas.size(); i++) {
+    const auto& schema = _schemas[i];
+    auto& props        = _schemaprops[i];
+    auto objclazz      = dynamic_cast<object::ObjectClass*>(rtti::Class::FindClass(schema._classname));
+    ClassSchema live;
+    if (liveClassSchema(schema._classname, live) and live._hash == schema._hash) {
+      _numSchemaMatches++;
+      for (auto clazz = objclazz; clazz; clazz = dynamic_cast<object::ObjectClass*>(clazz->Parent())) {
+        for (auto prop_item : clazz->Description().properties())
+          props.push_back(prop_item.second); // same walk as liveClassSchema
+      }
+      OrkAssert(props.size() == schema._propnames.size());
+    } else {
+      _numSchemaMismatches++;
+      logchan_bds->log("schema drift class<%s>, resolving properties by name", schema._classname.c_str());
+      for (const auto& propname : schema._propnames)
+        props.push_back(objclazz ? objclazz->Description().property(propname.c_str()) : nullptr);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BinaryDeserializer::BinaryDeserializer(const std::string& bindata)
+    : BinaryDeserializer(bindata.data(), bindata.length()) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+node_ptr_t BinaryDeserializer::pushNode(std::string named, NodeType type) {
+  node_ptr_t n     = std::make_shared<Node>();
+  n->_name         = named;
+  n->_deserializer = this;
+  n->_type         = type;
+  _nodestack.push(n);
+  return n;
+}
+void BinaryDeserializer::popNode() {
+  _nodestack.pop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// the document is {"root":{"object":...}}
+////////////////////////////////////////////////////////////////////////////////
+
+void BinaryDeserializer::deserializeTop(object_ptr_t& instance_out) {
+  BinaryReader reader(_data.data() + _rootoffset, _data.length() - _rootoffset);
+  OrkAssert(reader.tag() == RecordTag::MAP);
+  OrkAssert(reader.varint() == 1);
+  size_t keyindex = reader.varint();
+  OrkAssert(_strings[keyindex] == "root");
+  auto topnode    = pushNode("root", NodeType::OBJECT);
+  auto child_node = _parseRecord(topnode, reader);
+  instance_out    = child_node->_deser_instance;
+  popNode();
+  OrkAssert(reader._cursor == reader._end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+node_ptr_t BinaryDeserializer::deserializeObject(node_ptr_t parnode) {
+  if (not parnode->_impl.isShared<BinaryContainerNode>()) {
+    OrkAssert(parnode->_value.get<std::string>() == "nil");
+    return nullptr;
+  }
+  auto container = parnode->_impl.getShared<BinaryContainerNode>();
+  OrkAssert(container->_tag == RecordTag::MAP);
+  auto topnode          = pushNode("object", NodeType::OBJECT);
+  auto reader           = container->_record;
+  auto child_node       = _parseRecord(topnode, reader);
+  container->_next      = reader; // whole record consumed
+  container->_remaining = 0;
+  popNode();
+  return child_node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+node_ptr_t BinaryDeserializer::deserializeElement(node_ptr_t elemnode) {
+  auto container = elemnode->_parent->_impl.getShared<BinaryContainerNode>();
+  OrkAssert(container->_remaining > 0);
+  container->_remaining--;
+  auto& reader = container->_next;
+  node_ptr_t childnode;
+  switch (elemnode->_type) {
+    case NodeType::MAP_ELEMENT_LEAF:
+    case NodeType::MAP_ELEMENT_OBJECT: {
+      OrkAssert(container->_tag == RecordTag::MAP);
+      size_t keyindex = reader.varint();
+      OrkAssert(keyindex < _strings.size());
+      childnode       = _parseRecord(elemnode, reader);
+      childnode->_key = _strings[keyindex];
+      break;
+    }
+    case NodeType::ARRAY_ELEMENT_LEAF:
+    case NodeType::ARRAY_ELEMENT_OBJECT:
+      if (container->_tag == RecordTag::ARRAY) {
+        childnode = _parseRecord(elemnode, reader);
+      } else {
+        childnode          = pushNode("", NodeType::OBJECT);
+        childnode->_parent = elemnode;
+        childnode->_value.set<double>(readPackedElement(container->_tag, reader));
+        popNode();
+      }
+      break;
+    default:
+      OrkAssert(false);
+      break;
+  }
+  return childnode;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// decode exactly one record (same node shape as JsonDeserializer::_parseSubNode)
+////////////////////////////////////////////////////////////////////////////////
+
+node_ptr_t BinaryDeserializer::_parseRecord(node_ptr_t parentnode, BinaryReader& reader) {
+  auto child_node             = pushNode("", NodeType::OBJECT);
+  child_node->_parent         = parentnode;
+  child_node->_property       = parentnode->_property;
+  child_node->_deser_instance = parentnode->_deser_instance;
+
+  RecordTag tag = reader.tag();
+  if (readLeaf(tag, reader, _strings, child_node->_value)) {
+    popNode();
+    return child_node;
+  }
+  switch (tag) {
+    case RecordTag::MAP: {
+      size_t count = reader.varint();
+      //////////////////////////////////////////
+      // {"object":...} / {"object-ref":...}
+      //////////////////////////////////////////
+      if (count == 1) {
+        BinaryReader peek = reader;
+        const auto& key   = _strings[peek.varint()];
+        if (key == "object") {
+          reader = peek;
+          switch (reader.tag()) {
+            case RecordTag::OBJECT: {
+              auto instance_out           = _parseObjectRecord(child_node, reader);
+              child_node->_deser_instance = instance_out;
+              child_node->_value.set<object_ptr_t>(instance_out);
+              trackObject(instance_out->_uuid, instance_out);
+              break;
+            }
+            case RecordTag::STRING: {
+              OrkAssert(_strings[reader.varint()] == "nil");
+              auto nil                    = object_ptr_t(nullptr);
+              child_node->_deser_instance = nil;
+              child_node->_value.set<object_ptr_t>(nil);
+              break;
+            }
+            default:
+              OrkAssert(false);
+              break;
+          }
+          break;
+        } else if (key == "object-ref") {
+          reader = peek;
+          OrkAssert(reader.tag() == RecordTag::OBJECT_REF);
+          auto instance_out           = findTrackedObject(reader.uuid());
+          child_node->_deser_instance = instance_out;
+          child_node->_value.set<object_ptr_t>(instance_out);
+          break;
+        }
+      }
+      //////////////////////////////////////////
+      // "blind data" (pass-thru to custom deserializer)
+      //////////////////////////////////////////
+      for (size_t i = 0; i < count; i++) {
+        const auto& propname     = _strings[reader.varint()];
+        auto propnode_serdes     = pushNode(propname, NodeType::OBJECT);
+        propnode_serdes->_parent = child_node;
+        auto propnode_child      = _parseRecord(propnode_serdes, reader);
+        propnode_serdes->_value  = propnode_child->_value;
+        popNode();
+        child_node->_deser_blind_children.push_back(propnode_serdes);
+      }
+      break;
+    }
+    case RecordTag::ARRAY: {
+      size_t count = reader.varint();
+      serdes::var_array_t vec;
+      for (size_t i = 0; i < count; i++) {
+        svar64_t vv;
+        RecordTag elemtag = reader.tag();
+        var_t elemvalue;
+        bool is_leaf = readLeaf(elemtag, reader, _strings, elemvalue);
+        OrkAssert(is_leaf and elemvalue.isA<double>()); // numeric elements only
+        vv.set<double>(elemvalue.get<double>());
+        vec.push_back(vv);
+      }
+      child_node->_value.set<serdes::var_array_t>(vec);
+      break;
+    }
+    case RecordTag::PACKED_INT32:
+    case RecordTag::PACKED_FLOAT:
+    case RecordTag::PACKED_DOUBLE: {
+      size_t count = reader.varint();
+      serdes::var_array_t vec;
+      for (size_t i = 0; i < count; i++) {
+        svar64_t vv;
+        vv.set<double>(readPackedElement(tag, reader));
+        vec.push_back(vv);
+      }
+      child_node->_value.set<serdes::var_array_t>(vec);
+      break;
+    }
+    default:
+      OrkAssert(false);
+      break;
+  }
+  popNode();
+  return child_node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+object_ptr_t BinaryDeserializer::_parseObjectRecord(node_ptr_t dsernode, BinaryReader& reader) {
+  size_t schemaindex = reader.varint();
+  OrkAssert(schemaindex < _schemas.size());
+  const auto& schema = _schemas[schemaindex];
+  const auto& props  = _schemaprops[schemaindex];
+  auto uuid          = reader.uuid();
+  auto objclazz      = dynamic_cast<object::ObjectClass*>(rtti::Class::FindClass(schema._classname));
+  OrkAssert(objclazz);
+
+  object_ptr_t instance_out = nullptr;
+
+  //////////////////////////////////////////////
+  // "reflect.no_instantiate" : pre-instantiated,
+  //  lifetime managed by parent (see JsonDeserializer)
+  //////////////////////////////////////////////
+
+  auto top_prop = _property_stack.top();
+  auto has_anno = top_prop //
+                      ? top_prop->annotation("reflect.no_instantiate").tryAs<bool>()
+                      : false;
+
+  if (has_anno) {
+    auto parnode = dsernode->_parent;
+    OrkAssert(parnode->_type == NodeType::ARRAY_ELEMENT_LEAF);
+    auto arynode               = parnode->_parent;
+    auto aryobj                = arynode->_deser_instance;
+    auto top_prop_as_obj_array = dynamic_cast<const ITypedArray<object_ptr_t>*>(top_prop);
+    top_prop_as_obj_array->get(instance_out, aryobj, int(arynode->_index));
+    OrkAssert(instance_out != nullptr);
+  }
+
+  if (instance_out == nullptr) {
+    instance_out = objclazz->createShared();
+  }
+
+  instance_out->_uuid = uuid;
+  instance_out->preDeserialize(*this);
+
+  ///////////////////////////////////
+  // properties, by dense id
+  ///////////////////////////////////
+
+  size_t numprops = reader.varint();
+  for (size_t i = 0; i < numprops; i++) {
+    size_t propid = reader.varint();
+    OrkAssert(propid < props.size());
+    auto prop = props[propid];
+    if (nullptr == prop) { // drop property, no longer registered
+      logchan_bds->log("dropping property<%s>", schema._propnames[propid].c_str());
+      skipRecord(reader);
+      continue;
+    }
+    dsernode->_property = prop;
+    _property_stack.push(prop);
+    auto child_node             = std::make_shared<Node>();
+    child_node->_parent         = dsernode;
+    child_node->_property       = prop;
+    child_node->_deserializer   = this;
+    child_node->_deser_instance = instance_out;
+    _parseProperty(child_node, reader);
+    _property_stack.pop();
+  }
+  instance_out->postDeserialize(*this, instance_out);
+  return instance_out;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// leaves are decoded up front. containers are handed to the property as a
+//  cursor, whatever it did not consume is skipped afterwards
+////////////////////////////////////////////////////////////////////////////////
+
+void BinaryDeserializer::_parseProperty(node_ptr_t propnode, BinaryReader& reader) {
+  BinaryReader record = reader;
+  RecordTag tag       = reader.tag();
+  if (readLeaf(tag, reader, _strings, propnode->_value)) {
+    propnode->_property->deserialize(propnode);
+    return;
+  }
+  OrkAssert(isContainer(tag));
+  auto container         = propnode->_impl.makeShared<BinaryContainerNode>(record);
+  propnode->_numchildren = container->_remaining;
+  propnode->_property->deserialize(propnode);
+  reader = container->_next;
+  for (; container->_remaining; container->_remaining--) {
+    switch (container->_tag) {
+      case RecordTag::MAP:
+        reader.varint();
+        skipRecord(reader);
+        break;
+      case RecordTag::ARRAY:
+        skipRecord(reader);
+        break;
+      default: // packed
+        readPackedElement(container->_tag, reader);
+        break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace ork::reflect::serdes
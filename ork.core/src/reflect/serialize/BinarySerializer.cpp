@@ -0,0 +1,397 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/reflect/serialize/BinarySerializer.h>
+#include <ork/reflect/properties/ObjectProperty.h>
+#include <ork/kernel/datablock.h>
+#include <ork/rtti/Class.h>
+#include <ork/object/Object.h>
+#include <boost/uuid/string_generator.hpp>
+#include <cstring>
+
+namespace ork::reflect::serdes {
+namespace binary {
+////////////////////////////////////////////////////////////////////////////////
+
+void ClassSchema::computeHash() {
+  auto hasher = DataBlock::createHasher();
+  hasher->accumulateString("ClassSchema");
+  hasher->accumulateItem<size_t>(_classname.length());
+  hasher->accumulateString(_classname);
+  for (const auto& propname : _propnames) {
+    hasher->accumulateItem<size_t>(propname.length());
+    hasher->accumulateString(propname);
+  }
+  hasher->finish();
+  _hash = hasher->result();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool liveClassSchema(const std::string& classname, ClassSchema& schema_out) {
+  auto clazz    = rtti::Class::FindClass(classname);
+  auto objclazz = dynamic_cast<object::ObjectClass*>(clazz);
+  if (nullptr == objclazz)
+    return false;
+  schema_out._classname = classname;
+  schema_out._propnames.clear();
+  //////////////////////////////////////////
+  // same walk (and order) as JsonSerializer::serializeObject
+  //////////////////////////////////////////
+  while (objclazz) {
+    auto& desc = objclazz->Description();
+    for (auto prop_item : desc.properties()) {
+      schema_out._propnames.push_back(prop_item.first.c_str());
+    }
+    objclazz = dynamic_cast<object::ObjectClass*>(objclazz->Parent());
+  }
+  schema_out.computeHash();
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool isBinary(const void* data, size_t length) {
+  if (length < 8)
+    return false;
+  uint32_t magic = 0;
+  memcpy(&magic, data, sizeof(magic));
+  return magic == kmagic;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace binary
+
+using namespace binary;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct BinaryWriter {
+
+  void u8(uint8_t value) {
+    _out.push_back(char(value));
+  }
+  void tag(RecordTag t) {
+    u8(uint8_t(t));
+  }
+  void varint(uint64_t value) {
+    while (value >= 0x80) {
+      u8(uint8_t(value | 0x80));
+      value >>= 7;
+    }
+    u8(uint8_t(value));
+  }
+  void bytes(const void* data, size_t length) {
+    _out.append((const char*)data, length);
+  }
+  template <typename T> void pod(const T& value) {
+    bytes(&value, sizeof(T));
+  }
+
+  std::string _out;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// encodes a JsonSerializer document
+//  {"object":{"class","uuid","properties"}} and {"object-ref":{"uuid-ref"}}
+//  are recognized and written as schema'd object records,
+//  homogenous numeric arrays (math types, DirectTypedVector, etc..)
+//  are written as packed blocks.
+////////////////////////////////////////////////////////////////////////////////
+
+struct BinaryEncoder {
+
+  using schemapropmap_t = std::unordered_map<std::string, uint32_t>;
+
+  ////////////////////////////////////////////
+
+  uint32_t stringIndex(const char* str, size_t length) {
+    std::string key(str, length);
+    auto it = _stringindex.find(key);
+    if (it != _stringindex.end())
+      return it->second;
+    uint32_t index = _strings.size();
+    _strings.push_back(key);
+    _stringindex[key] = index;
+    return index;
+  }
+  uint32_t stringIndex(const rapidjson::Value& strval) {
+    return stringIndex(strval.GetString(), strval.GetStringLength());
+  }
+
+  ////////////////////////////////////////////
+
+  uint32_t schemaIndex(const std::string& classname) {
+    auto it = _schemaindex.find(classname);
+    if (it != _schemaindex.end())
+      return it->second;
+    uint32_t index = _schemas.size();
+    ClassSchema schema;
+    if (not liveClassSchema(classname, schema)) {
+      schema._classname = classname; // unregistered class (offline conversion)
+    }
+    schemapropmap_t propmap;
+    for (uint32_t i = 0; i < schema._propnames.size(); i++)
+      propmap[schema._propnames[i]] = i;
+    _schemas.push_back(schema);
+    _schemapropmaps.push_back(propmap);
+    _schemaindex[classname] = index;
+    return index;
+  }
+
+  ////////////////////////////////////////////
+  // dense property id within a schema
+  //  names not known to the live class (blind/dropped data)
+  //  are appended, so the file stays self describing
+  ////////////////////////////////////////////
+
+  uint32_t propertyID(uint32_t schemaindex, const std::string& propname) {
+    auto& propmap = _schemapropmaps[schemaindex];
+    auto it       = propmap.find(propname);
+    if (it != propmap.end())
+      return it->second;
+    auto& schema = _schemas[schemaindex];
+    uint32_t id  = schema._propnames.size();
+    schema._propnames.push_back(propname);
+    propmap[propname] = id;
+    return id;
+  }
+
+  ////////////////////////////////////////////
+
+  static bool isObjectRecord(const rapidjson::Value& value) {
+    return value.IsObject()              //
+           and value.MemberCount() == 3  //
+           and value.HasMember("class")  //
+           and value.HasMember("uuid")   //
+           and value.HasMember("properties") //
+           and value["class"].IsString() //
+           and value["uuid"].IsString()  //
+           and value["properties"].IsObject();
+  }
+  static bool isObjectRef(const rapidjson::Value& value) {
+    return value.IsObject()             //
+           and value.MemberCount() == 1 //
+           and value.HasMember("uuid-ref") //
+           and value["uuid-ref"].IsString();
+  }
+
+  ////////////////////////////////////////////
+
+  void encodeUUID(const rapidjson::Value& strval) {
+    boost::uuids::string_generator gen;
+    auto uuid = gen(std::string(strval.GetString(), strval.GetStringLength()));
+    OrkAssert(uuid.size() == 16);
+    _body.bytes(&(*uuid.begin()), 16);
+  }
+
+  ////////////////////////////////////////////
+
+  void encodeObjectRecord(const rapidjson::Value& objval) {
+    std::string classname = objval["class"].GetString();
+    uint32_t schemaindex  = schemaIndex(classname);
+    const auto& props     = objval["properties"];
+    _body.tag(RecordTag::OBJECT);
+    _body.varint(schemaindex);
+    encodeUUID(objval["uuid"]);
+    _body.varint(props.MemberCount());
+    for (auto it = props.MemberBegin(); it != props.MemberEnd(); ++it) {
+      std::string propname(it->name.GetString(), it->name.GetStringLength());
+      _body.varint(propertyID(schemaindex, propname));
+      encodeValue(it->value);
+    }
+  }
+
+  ////////////////////////////////////////////
+  // POD fast path
+  ////////////////////////////////////////////
+
+  bool encodePackedArray(const rapidjson::Value& aryval) {
+    size_t count = aryval.Size();
+    if (count < 2)
+      return false;
+    ////////////////////////////////
+    // pack only what decodes back to the same json :
+    //  all int32, or all (non integral) doubles, as floats when
+    //  every one survives the narrowing. mixed int/double and
+    //  64 bit / unsigned arrays stay generic ARRAY records
+    ////////////////////////////////
+    bool all_int    = true;
+    bool all_double = true;
+    bool all_float  = true;
+    for (const auto& item : aryval.GetArray()) {
+      all_int    = all_int and item.IsInt();
+      all_double = all_double and item.IsDouble();
+      if (not(all_int or all_double))
+        return false;
+      if (all_double and all_float) {
+        double d  = item.GetDouble();
+        all_float = (double(float(d)) == d);
+      }
+    }
+    if (all_int) {
+      std::vector<int32_t> packed(count);
+      for (size_t i = 0; i < count; i++)
+        packed[i] = aryval[i].GetInt();
+      _body.tag(RecordTag::PACKED_INT32);
+      _body.varint(count);
+      _body.bytes(packed.data(), count * sizeof(int32_t));
+    } else if (all_float) {
+      std::vector<float> packed(count);
+      for (size_t i = 0; i < count; i++)
+        packed[i] = float(aryval[i].GetDouble());
+      _body.tag(RecordTag::PACKED_FLOAT);
+      _body.varint(count);
+      _body.bytes(packed.data(), count * sizeof(float));
+    } else {
+      std::vector<double> packed(count);
+      for (size_t i = 0; i < count; i++)
+        packed[i] = aryval[i].GetDouble();
+      _body.tag(RecordTag::PACKED_DOUBLE);
+      _body.varint(count);
+      _body.bytes(packed.data(), count * sizeof(double));
+    }
+    return true;
+  }
+
+  ////////////////////////////////////////////
+
+  void encodeValue(const rapidjson::Value& value) {
+    switch (value.GetType()) {
+      case rapidjson::kNullType:
+        _body.tag(RecordTag::NIL);
+        break;
+      case rapidjson::kFalseType:
+        _body.tag(RecordTag::FALSE_);
+        break;
+      case rapidjson::kTrueType:
+        _body.tag(RecordTag::TRUE_);
+        break;
+      case rapidjson::kNumberType:
+        if (value.IsInt()) {
+          _body.tag(RecordTag::INT32);
+          _body.pod<int32_t>(value.GetInt());
+        } else if (value.IsUint()) {
+          _body.tag(RecordTag::UINT32);
+          _body.pod<uint32_t>(value.GetUint());
+        } else if (value.IsInt64()) {
+          _body.tag(RecordTag::INT64);
+          _body.pod<int64_t>(value.GetInt64());
+        } else if (value.IsUint64()) {
+          _body.tag(RecordTag::UINT64);
+          _body.pod<uint64_t>(value.GetUint64());
+        } else {
+          _body.tag(RecordTag::DOUBLE);
+          _body.pod<double>(value.GetDouble());
+        }
+        break;
+      case rapidjson::kStringType:
+        _body.tag(RecordTag::STRING);
+        _body.varint(stringIndex(value));
+        break;
+      case rapidjson::kArrayType:
+        if (not encodePackedArray(value)) {
+          _body.tag(RecordTag::ARRAY);
+          _body.varint(value.Size());
+          for (const auto& item : value.GetArray())
+            encodeValue(item);
+        }
+        break;
+      case rapidjson::kObjectType:
+        _body.tag(RecordTag::MAP);
+        _body.varint(value.MemberCount());
+        for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+          _body.varint(stringIndex(it->name));
+          const auto& child = it->value;
+          std::string key(it->name.GetString(), it->name.GetStringLength());
+          if (key == "object" and isObjectRecord(child)) {
+            encodeObjectRecord(child);
+          } else if (key == "object-ref" and isObjectRef(child)) {
+            _body.tag(RecordTag::OBJECT_REF);
+            encodeUUID(child["uuid-ref"]);
+          } else {
+            encodeValue(child);
+          }
+        }
+        break;
+      default:
+        OrkAssert(false);
+        break;
+    }
+  }
+
+  ////////////////////////////////////////////
+
+  std::string finish() {
+    //////////////////////////////////////////
+    // schema names go into the shared string table too
+    //////////////////////////////////////////
+    for (auto& schema : _schemas) {
+      schema.computeHash();
+      stringIndex(schema._classname.c_str(), schema._classname.length());
+      for (const auto& propname : schema._propnames)
+        stringIndex(propname.c_str(), propname.length());
+    }
+    //////////////////////////////////////////
+    BinaryWriter header;
+    header.pod<uint32_t>(kmagic);
+    header.pod<uint32_t>(kversion);
+    header.varint(_strings.size());
+    for (const auto& str : _strings) {
+      header.varint(str.length());
+      header.bytes(str.data(), str.length());
+    }
+    header.varint(_schemas.size());
+    for (const auto& schema : _schemas) {
+      header.varint(_stringindex[schema._classname]);
+      header.pod<uint64_t>(schema._hash);
+      header.varint(schema._propnames.size());
+      for (const auto& propname : schema._propnames)
+        header.varint(_stringindex[propname]);
+    }
+    header.bytes(_body._out.data(), _body._out.size());
+    return header._out;
+  }
+
+  ////////////////////////////////////////////
+
+  BinaryWriter _body;
+  std::vector<std::string> _strings;
+  std::unordered_map<std::string, uint32_t> _stringindex;
+  std::vector<ClassSchema> _schemas;
+  std::vector<schemapropmap_t> _schemapropmaps;
+  std::unordered_map<std::string, uint32_t> _schemaindex;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string encodeBinary(const rapidjson::Value& document) {
+  BinaryEncoder encoder;
+  encoder.encodeValue(document);
+  return encoder.finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string jsonToBinary(const std::string& jsondata) {
+  rapidjson::Document document;
+  document.Parse(jsondata.c_str());
+  OrkAssert(document.IsObject());
+  OrkAssert(document.HasMember("root"));
+  return encodeBinary(document);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string BinarySerializer::output() {
+  popNode(); // pop objects
+  return encodeBinary(*_document);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+} // namespace ork::reflect::serdes
@@ -63,6 +63,11 @@ JsonDeserializer::JsonDeserializer(const std::string& jsondata)
   _property_stack.push(nullptr);
 }
 
+JsonDeserializer::JsonDeserializer()
+    : _document() {
+  _property_stack.push(nullptr);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 node_ptr_t JsonDeserializer::pushNode(std::string named, NodeType type) {
@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/util/lz4block.h>
+#include <vector>
+#include <cstring>
+
+namespace ork::lz4 {
+///////////////////////////////////////////////////////////////////////////////
+
+static constexpr size_t kminmatch    = 4;
+static constexpr size_t kmaxoffset   = 65535;
+static constexpr size_t klastliterals = 5;  // block must end with >= 5 literals
+static constexpr size_t kmflimit      = 12; // last match must start >= 12 bytes before end
+static constexpr int khashbits        = 16;
+
+static inline uint32_t _read32(const uint8_t* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+static inline uint32_t _hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - khashbits);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t compressBound(size_t srclen) {
+  return srclen + (srclen / 255) + 16;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t compress(const void* src, size_t srclen, void* dst, size_t dstcapacity) {
+  auto inp = (const uint8_t*)src;
+  auto out = (uint8_t*)dst;
+  size_t op = 0;
+  bool overflow = false;
+
+  auto put = [&](uint8_t byte) {
+    if (op < dstcapacity)
+      out[op] = byte;
+    else
+      overflow = true;
+    op++;
+  };
+  auto putLength = [&](size_t len) { // extension bytes of a 15+ length
+    while (len >= 255) {
+      put(255);
+      len -= 255;
+    }
+    put(uint8_t(len));
+  };
+  auto emit = [&](size_t anchor, size_t litlen, size_t offset, size_t matchlen) {
+    size_t mcode  = (matchlen >= kminmatch) ? (matchlen - kminmatch) : 0;
+    uint8_t token = uint8_t(((litlen < 15) ? litlen : 15) << 4);
+    if (matchlen)
+      token |= uint8_t((mcode < 15) ? mcode : 15);
+    put(token);
+    if (litlen >= 15)
+      putLength(litlen - 15);
+    if (op + litlen <= dstcapacity)
+      memcpy(out + op, inp + anchor, litlen);
+    else
+      overflow = true;
+    op += litlen;
+    if (matchlen) {
+      put(uint8_t(offset & 0xff));
+      put(uint8_t(offset >> 8));
+      if (mcode >= 15)
+        putLength(mcode - 15);
+    }
+  };
+
+  size_t anchor = 0;
+  if (srclen > kmflimit) {
+    std::vector<int64_t> table(size_t(1) << khashbits, -1);
+    size_t ip         = 0;
+    size_t matchend   = srclen - klastliterals;
+    size_t matchstart = srclen - kmflimit;
+    while (ip < matchstart and not overflow) {
+      uint32_t sequence = _read32(inp + ip);
+      uint32_t h        = _hash(sequence);
+      int64_t ref       = table[h];
+      table[h]          = int64_t(ip);
+      if (ref < 0 or (ip - size_t(ref)) > kmaxoffset or _read32(inp + ref) != sequence) {
+        ip++;
+        continue;
+      }
+      size_t matchlen = kminmatch;
+      while ((ip + matchlen) < matchend and inp[ref + matchlen] == inp[ip + matchlen])
+        matchlen++;
+      emit(anchor, ip - anchor, ip - size_t(ref), matchlen);
+      ip += matchlen;
+      anchor = ip;
+    }
+  }
+  emit(anchor, srclen - anchor, 0, 0); // trailing literals
+  return overflow ? 0 : op;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool decompress(const void* src, size_t srclen, void* dst, size_t dstlen) {
+  auto inp  = (const uint8_t*)src;
+  auto out  = (uint8_t*)dst;
+  size_t ip = 0;
+  size_t op = 0;
+
+  auto getLength = [&](size_t& len) -> bool {
+    uint8_t byte = 0;
+    do {
+      if (ip >= srclen)
+        return false;
+      byte = inp[ip++];
+      len += byte;
+    } while (byte == 255);
+    return true;
+  };
+
+  while (ip < srclen) {
+    uint8_t token = inp[ip++];
+    ////////////////////////////////
+    // literals
+    ////////////////////////////////
+    size_t litlen = token >> 4;
+    if (litlen == 15 and not getLength(litlen))
+      return false;
+    if ((ip + litlen) > srclen or (op + litlen) > dstlen)
+      return false;
+    memcpy(out + op, inp + ip, litlen);
+    ip += litlen;
+    op += litlen;
+    if (ip == srclen)
+      break; // last sequence has no match
+    ////////////////////////////////
+    // match
+    ////////////////////////////////
+    if ((ip + 2) > srclen)
+      return false;
+    size_t offset = size_t(inp[ip]) | (size_t(inp[ip + 1]) << 8);
+    ip += 2;
+    if (offset == 0 or offset > op)
+      return false;
+    size_t matchlen = token & 15;
+    if (matchlen == 15 and not getLength(matchlen))
+      return false;
+    matchlen += kminmatch;
+    if ((op + matchlen) > dstlen)
+      return false;
+    const uint8_t* ref = out + op - offset;
+    if (offset >= matchlen) {
+      memcpy(out + op, ref, matchlen);
+    } else { // overlapping (run) copy
+      for (size_t i = 0; i < matchlen; i++)
+        out[op + i] = ref[i];
+    }
+    op += matchlen;
+  }
+  return op == dstlen;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::lz4
@@ -8,6 +8,8 @@
 #include <regex>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <chrono>
+#include <algorithm>
 #include <ork/pch.h>
 #include <ork/file/file.h>
 #include <ork/util/parser.h>
@@ -182,6 +184,14 @@ Match::Match(match_attempt_constptr_t attempt)
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 
+MatchArena::MatchArena()
+    : _resource(kInitialBlockSize) {
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////
+
 Matcher::Matcher(matcher_fn_t match_fn)
     : _attempt_match_fn(match_fn) {
 }
@@ -271,20 +281,39 @@ void Parser::link() {
 
 //////////////////////////////////////////////////////////////////////
 
+match_attempt_ptr_t Parser::_newMatchAttempt() {
+  if (not _arena) {
+    return std::make_shared<MatchAttempt>();
+  }
+  return std::allocate_shared<MatchAttempt>(MatchArenaAllocator<MatchAttempt>(_arena));
+}
+
+//////////////////////////////////////////////////////////////////////
+
+match_ptr_t Parser::_newMatch(match_attempt_constptr_t attempt) {
+  if (not _arena) {
+    return std::make_shared<Match>(attempt);
+  }
+  return std::allocate_shared<Match>(MatchArenaAllocator<Match>(_arena), attempt);
+}
+
+//////////////////////////////////////////////////////////////////////
+
 match_attempt_ptr_t Parser::leafMatch(matcher_ptr_t matcher){
 
   match_attempt_ptr_t parent;
   if(not  _match_stack.empty() ){
     parent = _match_stack.back();
   }
-  auto rval = std::make_shared<MatchAttempt>();
-  rval->_parent = parent;
+  auto rval = _newMatchAttempt();
+  rval->_parent = parent.get();
   rval->_matcher = matcher;
   if(parent){
     parent->_children.push_back(rval);
-    printf( "xxx : LEAFMATCH parent<%p:%s> rval<%p:%s>\n", (void*)parent.get(), parent->_matcher->_name.c_str(), (void*)rval.get(), matcher->_name.c_str() );
+    if (_DEBUG_MATCH)
+      printf( "xxx : LEAFMATCH parent<%p:%s> rval<%p:%s>\n", (void*)parent.get(), parent->_matcher->_name.c_str(), (void*)rval.get(), matcher->_name.c_str() );
   }
-  else{
+  else if (_DEBUG_MATCH) {
     printf( "xxx : LEAFMATCH noparent rval<%p:%s>\n", (void*)rval.get(), matcher->_name.c_str() );
   }
   rval->_terminal = true;
@@ -302,26 +331,15 @@ match_attempt_ptr_t Parser::pushMatch(matcher_ptr_t matcher){
 
   //////////////////////////////////////////////////////
 
-  auto rval = std::make_shared<MatchAttempt>();
+  auto rval = _newMatchAttempt();
   rval->_matcher = matcher;
-  rval->_parent = parent;
+  rval->_parent = parent.get();
   if(parent){
     parent->_children.push_back(rval);
-    if(parent->_matcher->_name == "sequence-6"){
-      printf( "xxx : YO\n");
-      //OrkBreak();
-    }
-    if(parent->_matcher->_name == "datatype"){
-      printf( "xxx : YO\n");
-      static int icount = 0;
-      icount++;
-      if(icount==2){
-        OrkBreak();
-      }
-    }
-    printf( "xxx : PUSHMATCH parent<%p:%s> rval<%p:%s>\n", (void*)parent.get(), parent->_matcher->_name.c_str(), (void*)rval.get(), matcher->_name.c_str() );
+    if (_DEBUG_MATCH)
+      printf( "xxx : PUSHMATCH parent<%p:%s> rval<%p:%s>\n", (void*)parent.get(), parent->_matcher->_name.c_str(), (void*)rval.get(), matcher->_name.c_str() );
   }
-  else{
+  else if (_DEBUG_MATCH) {
     printf( "xxx : PUSHMATCH noparent rval<%p:%s>\n", (void*)rval.get(), matcher->_name.c_str() );
   }
 
@@ -339,6 +357,12 @@ void Parser::popMatch(){
     _match_stack.pop_back();
 }
 
+//////////////////////////////////////////////////////////////////////
+// all sub matches funnel through here
+//  with _packrat set (off by default), the result (including failure) of each
+//  (matcher, token range) pair is memoized for the duration of
+//  the current match() call, so backtracking alternatives never
+//  re-parse a range a second time.
 //////////////////////////////////////////////////////////////////////
 
 match_attempt_ptr_t Parser::_tryMatch(MatchAttemptContextItem& mci) {
@@ -351,12 +375,55 @@ match_attempt_ptr_t Parser::_tryMatch(MatchAttemptContextItem& mci) {
     logerrchannel()->log("matcher<%s> has no match function", matcher->_name.c_str());
     OrkAssert(false);
   }
+  auto& stats = matcher->_stats;
+  stats._numattempts++;
+  //////////////////////////////////
+  PackratKey key{matcher.get(), inp_view->_start, inp_view->_end};
+  if (_packrat) {
+    auto it = _packrat_memo.find(key);
+    if (it != _packrat_memo.end()) {
+      _cache_hits++;
+      stats._nummemohits++;
+      auto memoized = it->second;
+      if (memoized) {
+        stats._nummatches++;
+        // graft onto the current parent, as pushMatch/leafMatch
+        //  would have, so the attempt tree stays complete
+        if (not _match_stack.empty())
+          _match_stack.back()->_children.push_back(memoized);
+      }
+      return memoized;
+    }
+    _cache_misses++;
+  }
+  //////////////////////////////////
+  std::chrono::steady_clock::time_point t0;
+  if (_collect_stats) {
+    t0 = std::chrono::steady_clock::now();
+    _stats_child_nanos.push_back(0);
+  }
+  //////////////////////////////////
   _matchattemptctx._stack.push_back(mci);
   inp_view->validate();
   auto match_attempt = matcher->_attempt_match_fn(matcher, inp_view);
   //////////////////////////////////
   _matchattemptctx._stack.pop_back();
   //////////////////////////////////
+  if (_collect_stats) {
+    // exclusive : a recursive matcher would otherwise count
+    //  the same time once per level
+    auto t1          = std::chrono::steady_clock::now();
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    uint64_t nested  = _stats_child_nanos.back();
+    _stats_child_nanos.pop_back();
+    stats._nanos += (elapsed > nested) ? (elapsed - nested) : 0;
+    if (not _stats_child_nanos.empty())
+      _stats_child_nanos.back() += elapsed;
+  }
+  if (match_attempt)
+    stats._nummatches++;
+  if (_packrat)
+    _packrat_memo[key] = match_attempt;
   return match_attempt;
 }
 
@@ -370,17 +437,27 @@ match_ptr_t Parser::match(matcher_ptr_t topmatcher, scannerlightview_constptr_t
   _matchattemptctx._stack.clear();
   _matchattemptctx._topmatcher = topmatcher;
   _matchattemptctx._topview    = topview;
+  /////////////////////////////////////
+  // fresh arena per parse, previous parse's nodes
+  //  keep their own arena alive as long as referenced
+  /////////////////////////////////////
+  _arena = std::make_shared<MatchArena>();
+  _packrat_memo.clear();
+  _stats_child_nanos.clear();
   MatchAttemptContextItem mci { topmatcher, topview };
   auto root_match_attempt = _tryMatch(mci);
+  _packrat_memo.clear();
 
   if(root_match_attempt) {
     auto root_match = MatchAttempt::genmatch(root_match_attempt);
+    _arena = nullptr;
 
     /////////////////////////////////////
     // visit matchattempt tree
     /////////////////////////////////////
 
-    printf( "xxx : #############################################################\n" );
+    if (_DEBUG_MATCH)
+      printf( "xxx : #############################################################\n" );
     //printf( "xxx : matchattempt tree\n" );
     //printf( "xxx : #############################################################\n" );
 
@@ -407,18 +484,61 @@ match_ptr_t Parser::match(matcher_ptr_t topmatcher, scannerlightview_constptr_t
 
     _visitMatch(root_match);
 
-    printf( "xxx : #############################################################\n" );
+    if (_DEBUG_MATCH)
+      printf( "xxx : #############################################################\n" );
 
 
     /////////////////////////////////////
     return root_match;
   }
 
+  _arena = nullptr;
   return nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////
 
+void Parser::resetStats() {
+  for (auto matcher : _matchers) {
+    matcher->_stats.reset();
+  }
+  _cache_hits   = 0;
+  _cache_misses = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void Parser::dumpStats(size_t maxlines) const {
+  std::vector<matcher_ptr_t> sorted(_matchers.begin(), _matchers.end());
+  std::sort(sorted.begin(), sorted.end(), [](matcher_ptr_t a, matcher_ptr_t b) { //
+    if (a->_stats._nanos != b->_stats._nanos)
+      return a->_stats._nanos > b->_stats._nanos;
+    return a->_stats._numattempts > b->_stats._numattempts;
+  });
+  logchan_parser->log(
+      "parser<%s> matchers<%zu> memo_hits<%zu> memo_misses<%zu>", //
+      _name.c_str(),
+      _matchers.size(),
+      _cache_hits,
+      _cache_misses);
+  size_t numlines = std::min(maxlines, sorted.size());
+  for (size_t i = 0; i < numlines; i++) {
+    const auto& stats = sorted[i]->_stats;
+    if (stats._numattempts == 0)
+      break;
+    logchan_parser->log(
+        "  matcher<%s:%s> attempts<%zu> matches<%zu> memohits<%zu> msec<%g>", //
+        sorted[i]->_name.c_str(),
+        sorted[i]->_info.c_str(),
+        stats._numattempts,
+        stats._nummatches,
+        stats._nummemohits,
+        double(stats._nanos) * 1e-6);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+
 void Parser::_visitMatch(match_ptr_t m){
 
   auto indentstr = std::string(_visit_depth * 2, ' ');
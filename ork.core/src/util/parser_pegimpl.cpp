@@ -384,6 +384,7 @@ static constexpr const char* block_regex = "(function|yo|xxx)";
 
 PegImpl::PegImpl() {
   _peg_parser        = std::make_shared<Parser>();
+  _ast_arena         = std::make_shared<MatchArena>();
   _peg_parser->_DEBUG_MATCH = true;
   _peg_parser->_DEBUG_INFO = true;
   _peg_parser->_name = "gramr";
@@ -431,7 +432,7 @@ size_t indent = 0;
 AST::oneormore_ptr_t PegImpl::_onOOM(match_ptr_t match) {
   auto indentstr = std::string(indent * 2, ' ');
   // our output AST node
-  auto oom_out     = std::make_shared<AST::OneOrMore>(_user_parser);
+  auto oom_out     = _newAstNode<AST::OneOrMore>(_user_parser);
   oom_out->_parent = _ast_buildstack.back();
   _ast_buildstack.push_back(oom_out);
 
@@ -450,7 +451,7 @@ AST::oneormore_ptr_t PegImpl::_onOOM(match_ptr_t match) {
 AST::zeroormore_ptr_t PegImpl::_onZOM(match_ptr_t match) {
   auto indentstr = std::string(indent * 2, ' ');
   // our output AST node
-  auto zom_out     = std::make_shared<AST::ZeroOrMore>(_user_parser);
+  auto zom_out     = _newAstNode<AST::ZeroOrMore>(_user_parser);
   zom_out->_parent = _ast_buildstack.back();
   _ast_buildstack.push_back(zom_out);
   // our parser DSL input node (containing user language spec)
@@ -470,7 +471,7 @@ AST::zeroormore_ptr_t PegImpl::_onZOM(match_ptr_t match) {
 AST::select_ptr_t PegImpl::_onSEL(match_ptr_t match) {
   auto indentstr = std::string(indent * 2, ' ');
   // our output AST node
-  auto sel_out     = std::make_shared<AST::Select>(_user_parser);
+  auto sel_out     = _newAstNode<AST::Select>(_user_parser);
   sel_out->_parent = _ast_buildstack.back();
   _ast_buildstack.push_back(sel_out);
   // our parser DSL input node (containing user language spec)
@@ -491,7 +492,7 @@ AST::select_ptr_t PegImpl::_onSEL(match_ptr_t match) {
 AST::optional_ptr_t PegImpl::_onOPT(match_ptr_t match) {
   auto indentstr = std::string(indent * 2, ' ');
   // our output AST node
-  auto opt_out     = std::make_shared<AST::Optional>(_user_parser);
+  auto opt_out     = _newAstNode<AST::Optional>(_user_parser);
   opt_out->_parent = _ast_buildstack.back();
   _ast_buildstack.push_back(opt_out);
   // our parser DSL input node (containing user language spec)
@@ -506,7 +507,7 @@ AST::optional_ptr_t PegImpl::_onOPT(match_ptr_t match) {
 }
 /////////////////////////////////////////////////////////
 AST::sequence_ptr_t PegImpl::_onSEQ(match_ptr_t match) {
-  auto seq_out     = std::make_shared<AST::Sequence>(_user_parser);
+  auto seq_out     = _newAstNode<AST::Sequence>(_user_parser);
   seq_out->_parent = _ast_buildstack.back();
   _ast_buildstack.push_back(seq_out);
   auto nom = match->asShared<NOrMore>();
@@ -525,7 +526,7 @@ AST::sequence_ptr_t PegImpl::_onSEQ(match_ptr_t match) {
 }
 /////////////////////////////////////////////////////////
 AST::group_ptr_t PegImpl::_onGRP(match_ptr_t match) {
-  auto grp_out     = std::make_shared<AST::Group>(_user_parser);
+  auto grp_out     = _newAstNode<AST::Group>(_user_parser);
   grp_out->_parent = _ast_buildstack.back();
   _ast_buildstack.push_back(grp_out);
   auto nom = match->asShared<NOrMore>();
@@ -544,7 +545,7 @@ AST::group_ptr_t PegImpl::_onGRP(match_ptr_t match) {
 }
 /////////////////////////////////////////////////////////
 AST::expr_kwid_ptr_t PegImpl::_onEXPRKWID(match_ptr_t match) {
-  auto kwid_out     = std::make_shared<AST::ExprKWID>(_user_parser);
+  auto kwid_out     = _newAstNode<AST::ExprKWID>(_user_parser);
   kwid_out->_parent = _ast_buildstack.back();
   _ast_buildstack.push_back(kwid_out);
 
@@ -558,7 +559,7 @@ AST::expr_kwid_ptr_t PegImpl::_onEXPRKWID(match_ptr_t match) {
 }
 /////////////////////////////////////////////////////////
 AST::expression_ptr_t PegImpl::_onExpression(match_ptr_t match, std::string named) {
-  auto expr_out     = std::make_shared<AST::Expression>(_user_parser);
+  auto expr_out     = _newAstNode<AST::Expression>(_user_parser);
   expr_out->_parent = _ast_buildstack.back();
   _ast_buildstack.push_back(expr_out);
   auto indentstr = std::string(indent * 2, ' ');
@@ -684,7 +685,7 @@ void PegImpl::loadPEGGrammar() { //
     if (auto as_classmatch = rule_key_item->tryAsShared<ClassMatch>()) {
       auto match_str = as_classmatch.value()->_token->text;
       auto rule_name = match_str; // + "_scrule";
-      auto rule      = std::make_shared<AST::ScannerRule>();
+      auto rule      = _newAstNode<AST::ScannerRule>();
       rule->_name    = rule_name;
       rule->_regex   = rx;
       auto item = std::pair(rule_name, rule);
@@ -699,7 +700,7 @@ void PegImpl::loadPEGGrammar() { //
       auto macro_str = sub_seq->_items[0]->asShared<WordMatch>()->_token->text;
       OrkAssert(macro_str == "macro");
       auto macro_name = sub_seq->_items[2]->asShared<ClassMatch>()->_token->text;
-      auto macro      = std::make_shared<AST::ScannerMacro>();
+      auto macro      = _newAstNode<AST::ScannerMacro>();
       macro->_name    = macro_name;
       macro->_regex   = rx;
       auto it         = this->_user_scanner_macros.find(macro_name);
@@ -777,7 +778,7 @@ void PegImpl::loadPEGGrammar() { //
     auto rulename = match->asShared<Sequence>()->_items[0]->asShared<ClassMatch>()->_token->text;
     auto ruleseq = match->asShared<Sequence>()->_items[2];
 
-    auto ast_rule = std::make_shared<AST::ParserRule>(_user_parser, rulename);
+    auto ast_rule = _newAstNode<AST::ParserRule>(_user_parser, rulename);
     _current_rule = ast_rule;
     _ast_buildstack.push_back(ast_rule);
     auto expr_ast_node = _onExpression(ruleseq, rulename);
@@ -795,11 +796,12 @@ void PegImpl::loadPEGGrammar() { //
 /////////////////////////////////////////////////////////
 match_ptr_t PegImpl::parseUserScannerSpec(std::string inp_string) {
   auto peg_scanner = _peg_parser->_scanner;
+  _ast_arena       = std::make_shared<MatchArena>(); // see _newAstNode
   try {
     peg_scanner->clear();
+    peg_scanner->ignoreTokensOfClass(uint64_t(TokenClass::WHITESPACE));
+    peg_scanner->ignoreTokensOfClass(uint64_t(TokenClass::NEWLINE));
     peg_scanner->scanString(inp_string);
-    peg_scanner->discardTokensOfClass(uint64_t(TokenClass::WHITESPACE));
-    peg_scanner->discardTokensOfClass(uint64_t(TokenClass::NEWLINE));
   } catch (std::exception& e) {
     logerrchannel()->log("EXCEPTION<%s>", e.what());
     OrkAssert(false);
@@ -816,6 +818,7 @@ match_ptr_t PegImpl::parseUserScannerSpec(std::string inp_string) {
 /////////////////////////////////////////////////////////
 match_ptr_t PegImpl::parseUserParserSpec(std::string inp_string) {
   auto peg_scanner = _peg_parser->_scanner;
+  _ast_arena       = std::make_shared<MatchArena>(); // see _newAstNode
   /////////////////////////////////////////////////
   // add user scanner matchers to user matcher
   /////////////////////////////////////////////////
@@ -842,9 +845,9 @@ match_ptr_t PegImpl::parseUserParserSpec(std::string inp_string) {
   /////////////////////////////////////////////////
   try {
     peg_scanner->clear();
+    peg_scanner->ignoreTokensOfClass(uint64_t(TokenClass::WHITESPACE));
+    peg_scanner->ignoreTokensOfClass(uint64_t(TokenClass::NEWLINE));
     peg_scanner->scanString(inp_string);
-    peg_scanner->discardTokensOfClass(uint64_t(TokenClass::WHITESPACE));
-    peg_scanner->discardTokensOfClass(uint64_t(TokenClass::NEWLINE));
   } catch (std::exception& e) {
     logchan_rulespec->log("EXCEPTION<%s>", e.what());
     OrkAssert(false);
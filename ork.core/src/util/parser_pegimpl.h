@@ -33,10 +33,17 @@ struct PegImpl {
   void attachUser(Parser* user_parser);
   svar64_t findKWORID(std::string kworid);
 
+  // AST nodes of one spec parse share an arena. each parse starts a fresh
+  //  one, an arena is released with the last node allocated from it
+  template <typename node_t, typename... args_t> std::shared_ptr<node_t> _newAstNode(args_t&&... args) {
+    return std::allocate_shared<node_t>(MatchArenaAllocator<node_t>(_ast_arena), std::forward<args_t>(args)...);
+  }
+
   size_t indent = 0;
   scanner_ptr_t _user_scanner;
   Parser* _user_parser = nullptr;
   parser_ptr_t _peg_parser;
+  matcharena_ptr_t _ast_arena;
   matcher_ptr_t _rsi_scanner_matcher;
   matcher_ptr_t _rsi_parser_matcher;
 
@@ -41,7 +41,7 @@ void Parser::_proxy(matcher_ptr_t par_matcher, matcher_ptr_t sub_matcher){
   par_matcher->_genmatch_fn = [=](match_attempt_ptr_t attempt) -> match_ptr_t {
     auto the_proxy_attempt = attempt->asShared<ProxyAttempt>();
     if (the_proxy_attempt->_selected) {
-      auto the_match            = std::make_shared<Match>(attempt);
+      auto the_match            = _newMatch(attempt);
       auto the_proxy_inst       = the_match->makeShared<Proxy>();
       the_proxy_inst->_selected = MatchAttempt::genmatch(the_proxy_attempt->_selected);
       the_match->_children.push_back(the_proxy_inst->_selected);
@@ -86,7 +86,7 @@ matcher_ptr_t Parser::optional(matcher_ptr_t sub_matcher, std::string name) {
   ///////////////////////////////////////////////////////
   matcher->_genmatch_fn = [=](match_attempt_ptr_t attempt) -> match_ptr_t {
     auto the_opt_attempt = attempt->asShared<OptionalAttempt>();
-    auto the_match       = std::make_shared<Match>(attempt);
+    auto the_match       = _newMatch(attempt);
     auto the_opt_inst    = the_match->makeShared<Optional>();
     if (the_opt_attempt->_subitem) {
       the_opt_inst->_subitem = MatchAttempt::genmatch(the_opt_attempt->_subitem);
@@ -136,7 +136,7 @@ void Parser::_sequence(matcher_ptr_t matcher, std::vector<matcher_ptr_t> sub_mat
   ///////////////////////////////////////////////////////
   matcher->_genmatch_fn = [=](match_attempt_ptr_t attempt) -> match_ptr_t {
     auto the_seq_attempt = attempt->asShared<SequenceAttempt>();
-    auto the_match       = std::make_shared<Match>(attempt);
+    auto the_match       = _newMatch(attempt);
     auto the_seq_inst    = the_match->makeShared<Sequence>();
     for (auto item : the_seq_attempt->_items) {
       auto sub_match = MatchAttempt::genmatch(item);
@@ -284,7 +284,7 @@ matcher_ptr_t Parser::group(std::vector<matcher_ptr_t> matchers, std::string nam
   ///////////////////////////////////////////////////////
   matcher->_genmatch_fn = [=](match_attempt_ptr_t attempt) -> match_ptr_t {
     auto the_grp_attempt = attempt->asShared<GroupAttempt>();
-    auto the_match       = std::make_shared<Match>(attempt);
+    auto the_match       = _newMatch(attempt);
     auto the_grp_inst    = the_match->makeShared<Group>();
     for (auto item : the_grp_attempt->_items) {
       auto sub_match = MatchAttempt::genmatch(item);
@@ -335,7 +335,7 @@ matcher_ptr_t Parser::oneOf(std::vector<matcher_ptr_t> matchers, std::string nam
   ///////////////////////////////////////////////////////
   matcher->_genmatch_fn = [=](match_attempt_ptr_t attempt) -> match_ptr_t {
     auto the_oof_attempt    = attempt->asShared<OneOfAttempt>();
-    auto the_match          = std::make_shared<Match>(attempt);
+    auto the_match          = _newMatch(attempt);
     auto the_oof_inst       = the_match->makeShared<OneOf>();
     the_oof_inst->_selected = MatchAttempt::genmatch(the_oof_attempt->_selected);
     the_match->_children.push_back(the_oof_inst->_selected);
@@ -385,7 +385,7 @@ matcher_ptr_t Parser::nOrMore(matcher_ptr_t sub_matcher, size_t minMatches, std:
   //////////////////////////////////////////////////////
   matcher->_genmatch_fn = [=](match_attempt_ptr_t attempt) -> match_ptr_t {
     auto the_nom_attempt          = attempt->asShared<NOrMoreAttempt>();
-    auto the_match                = std::make_shared<Match>(attempt);
+    auto the_match                = _newMatch(attempt);
     auto the_nom_inst             = the_match->makeShared<NOrMore>();
     the_nom_inst->_minmatches     = the_nom_attempt->_minmatches;
     the_nom_inst->_mustConsumeAll = the_nom_attempt->_mustConsumeAll;
@@ -498,7 +498,7 @@ matcher_ptr_t Parser::matcherForTokenClassID(uint64_t tokclass, std::string name
   ///////////////////////////////////////////////////////
   matcher->_genmatch_fn = [=](match_attempt_ptr_t attempt) -> match_ptr_t {
     auto class_match_attempt = attempt->asShared<ClassMatchAttempt>();
-    auto the_match           = std::make_shared<Match>(attempt);
+    auto the_match           = _newMatch(attempt);
     auto cm_inst             = the_match->makeShared<ClassMatch>();
     cm_inst->_tokclass       = class_match_attempt->_tokclass;
     cm_inst->_token          = class_match_attempt->_token;
@@ -544,7 +544,7 @@ matcher_ptr_t Parser::matcherForWord(std::string word, std::string name) {
   ///////////////////////////////////////////////////////
   matcher->_genmatch_fn = [=](match_attempt_ptr_t attempt) -> match_ptr_t {
     auto word_match_attempt = attempt->asShared<WordMatchAttempt>();
-    auto the_match          = std::make_shared<Match>(attempt);
+    auto the_match          = _newMatch(attempt);
     auto wm_inst            = the_match->makeShared<WordMatch>();
     wm_inst->_token         = word_match_attempt->_token;
     return the_match;
@@ -10,6 +10,8 @@
 #include <ork/pch.h>
 #include <ork/file/file.h>
 #include <ork/util/scanner.h>
+#include <ork/kernel/datacache.h>
+#include <ork/kernel/mutex.h>
 #include <ork/kernel/string/deco.inl>
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -29,6 +31,9 @@ const Token* Scanner::token(size_t i) const {
 void Scanner::addRule(std::string rule, id_t state) {
   auto& r = _str_hold.emplace_back(rule);
   _rules.push(r.c_str(), state);
+  _grammarkeys.push_back("rule");
+  _grammarkeys.push_back(rule);
+  _grammarkeys.push_back(std::to_string(state));
 }
 
 void Scanner::addMacro(std::string macro, std::string value) {
@@ -36,13 +41,136 @@ void Scanner::addMacro(std::string macro, std::string value) {
   auto& item = _macros.emplace_back(pr);
 
   _rules.insert_macro(item.first.c_str(), item.second.c_str());
+  _grammarkeys.push_back("macro");
+  _grammarkeys.push_back(macro);
+  _grammarkeys.push_back(value);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// DFA table (de)serialization
+//  layout : magic, version, eoi, features, alphabet, lookup[], dfa[]
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+constexpr uint32_t kDFAMAGIC   = 0x4c584446; // 'LXDF'
+constexpr uint32_t kDFAVERSION = 1;
+
+using statemachine_t = Scanner::statemachine_t;
+using sm_id_t        = Scanner::id_t;
+using idvec_t        = std::vector<sm_id_t>;
+
+void _writeIdVec(datablock_ptr_t out, const idvec_t& vec) {
+  out->addItem<uint64_t>(vec.size());
+  out->addData(vec.data(), vec.size() * sizeof(sm_id_t));
+}
 
+idvec_t _readIdVec(DataBlockInputStream& inp) {
+  size_t count = inp.getItem<uint64_t>();
+  idvec_t rval(count);
+  memcpy(rval.data(), inp.current(), count * sizeof(sm_id_t));
+  inp.advance(count * sizeof(sm_id_t));
+  return rval;
+}
+
+datablock_ptr_t _serializeStateMachine(const statemachine_t& sm) {
+  const auto& internals = sm.data();
+  auto out              = std::make_shared<DataBlock>();
+  out->addItem<uint32_t>(kDFAMAGIC);
+  out->addItem<uint32_t>(kDFAVERSION);
+  out->addItem<uint64_t>(internals._eoi);
+  out->addItem<uint64_t>(internals._features);
+  _writeIdVec(out, internals._dfa_alphabet);
+  out->addItem<uint64_t>(internals._lookup.size());
+  for (const auto& item : internals._lookup)
+    _writeIdVec(out, item);
+  out->addItem<uint64_t>(internals._dfa.size());
+  for (const auto& item : internals._dfa)
+    _writeIdVec(out, item);
+  return out;
+}
+
+std::shared_ptr<statemachine_t> _deserializeStateMachine(datablock_ptr_t inpblock) {
+  DataBlockInputStream inp(inpblock);
+  if (inp.getItem<uint32_t>() != kDFAMAGIC or inp.getItem<uint32_t>() != kDFAVERSION)
+    return nullptr;
+  auto sm              = std::make_shared<statemachine_t>();
+  auto& internals      = sm->data();
+  internals._eoi       = inp.getItem<uint64_t>();
+  internals._features  = inp.getItem<uint64_t>();
+  internals._dfa_alphabet = _readIdVec(inp);
+  internals._lookup.resize(inp.getItem<uint64_t>());
+  for (auto& item : internals._lookup)
+    item = _readIdVec(inp);
+  internals._dfa.resize(inp.getItem<uint64_t>());
+  for (auto& item : internals._dfa)
+    item = _readIdVec(inp);
+  return sm;
 }
 
+using smcache_t = std::unordered_map<uint64_t, Scanner::statemachine_constptr_t>;
+LockedResource<smcache_t>& _statemachineCache() {
+  static LockedResource<smcache_t> _cache;
+  return _cache;
+}
+
+} // namespace
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 void Scanner::buildStateMachine() {
-  gen_t::build(_rules, _statemachine);
+
+  ///////////////////////////////////
+  // fresh hasher per build : the grammar may have
+  //  grown since a previous buildStateMachine()
+  ///////////////////////////////////
+
+  auto hasher = DataBlock::createHasher();
+  hasher->accumulateString("ork::Scanner-v1");
+  for (const auto& key : _grammarkeys)
+    hasher->accumulateString(key);
+  hasher->finish();
+  _grammarhash  = hasher->result();
+  _statemachine = nullptr;
+
+  ///////////////////////////////////
+  // already built in this process ?
+  ///////////////////////////////////
+
+  _statemachineCache().atomicOp([this](smcache_t& cache) {
+    auto it = cache.find(_grammarhash);
+    if (it != cache.end())
+      _statemachine = it->second;
+  });
+  if (_statemachine)
+    return;
+
+  ///////////////////////////////////
+  // previously serialized ?
+  ///////////////////////////////////
+
+  std::shared_ptr<statemachine_t> sm;
+  if (auto dblock = DataBlockCache::findDataBlock(_grammarhash)) {
+    sm = _deserializeStateMachine(dblock);
+  }
+
+  ///////////////////////////////////
+  // build from rules
+  ///////////////////////////////////
+
+  if (nullptr == sm) {
+    sm = std::make_shared<statemachine_t>();
+    gen_t::build(_rules, *sm);
+    sm->minimise();
+    DataBlockCache::setDataBlock(_grammarhash, _serializeStateMachine(*sm));
+  }
+
+  _statemachineCache().atomicOp([this, sm](smcache_t& cache) { //
+    auto it = cache.find(_grammarhash);
+    if (it == cache.end())
+      cache[_grammarhash] = sm;
+    _statemachine = cache[_grammarhash];
+  });
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -67,6 +195,14 @@ void Scanner::clear() {
   cur_token = Token("", 0, 0);
 }
 /////////////////////////////////////////////////////////////////////////////////////////////////
+void Scanner::ignoreTokensOfClass(uint64_t tokclass) {
+  _ignoredclasses.insert(tokclass);
+}
+/////////////////////////////////////////////////////////////////////////////////////////////////
+std::string_view Scanner::tokenView(const Token& tok) const {
+  return std::string_view(_fxbuffer.data() + tok._offset, tok._length);
+}
+/////////////////////////////////////////////////////////////////////////////////////////////////
 void Scanner::scanString(std::string str) {
   resize(str.length() + 1);
   memcpy(_fxbuffer.data(), str.c_str(), str.length());
@@ -74,24 +210,41 @@ void Scanner::scanString(std::string str) {
   scan();
 }
 /////////////////////////////////////////////////////////////////////////////////////////////////
+// scans directly out of _fxbuffer (no intermediate copy)
+//  line/column are tracked incrementally from the newlines
+//  within each matched span
+/////////////////////////////////////////////////////////////////////////////////////////////////
 void Scanner::scan() {
-  std::string as_str = _fxbuffer.data();
-  // printf( "scan<%s>\n", as_str.c_str() );
-  iter_t iter(as_str.begin(), as_str.end(), _statemachine);
-  iter_t end;
-
-  int index = 0;
-  int iline = 0;
-  for (; iter != end; ++iter) {
-    auto tok   = Token(iter->str(), iline, 0);
-    tok._class = iter->id;
-    tokens.push_back(tok);
-    int line_count = std::count(tok.text.begin(), tok.text.end(), '\n');
-    iline+=line_count;
-    // std::cout << "index<" << index << "> Id: " << iter->id << ", Token: '" << iter->str() << "'\n";
-    index++;
+  OrkAssert(_statemachine);
+  const char* base = _fxbuffer.data();
+  const char* end  = base + strnlen(base, _fxbuffer.size());
+  iter_t iter(base, end, *_statemachine);
+  iter_t iter_end;
+
+  tokens.reserve(tokens.size() + (end - base) / kBytesPerTokenEstimate);
+
+  bool check_ignored    = not _ignoredclasses.empty();
+  int iline             = 0;
+  const char* linestart = base;
+  for (; iter != iter_end; ++iter) {
+    const char* tok_beg = iter->first;
+    const char* tok_end = iter->second;
+    if (not(check_ignored and _ignoredclasses.contains(iter->id))) {
+      auto& tok = tokens.emplace_back(
+          tok_beg, //
+          size_t(tok_beg - base),
+          size_t(tok_end - tok_beg),
+          iline,
+          int(tok_beg - linestart));
+      tok._class = iter->id;
+    }
+    auto nl = (const char*)memchr(tok_beg, '\n', tok_end - tok_beg);
+    while (nl) {
+      iline++;
+      linestart = nl + 1;
+      nl        = (const char*)memchr(linestart, '\n', tok_end - linestart);
+    }
   }
-  // OrkAssert(false);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
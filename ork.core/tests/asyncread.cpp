@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <utpp/UnitTest++.h>
+#include <ork/file/asyncread.h>
+#include <boost/filesystem.hpp>
+#include <atomic>
+#include <thread>
+#include <stdio.h>
+
+using namespace ork;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t _pattern(size_t index, size_t fileno) {
+  return uint8_t((index * 7 + fileno) & 0xff);
+}
+
+static std::vector<std::string> _writeTestFiles(const std::vector<size_t>& sizes) {
+  auto tmpdir = boost::filesystem::temp_directory_path();
+  std::vector<std::string> names;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    auto name = (tmpdir / ("ork_test_asyncread_" + std::to_string(i) + ".bin")).string();
+    std::vector<uint8_t> bytes(sizes[i]);
+    for (size_t k = 0; k < sizes[i]; k++)
+      bytes[k] = _pattern(k, i);
+    FILE* fout = fopen(name.c_str(), "wb");
+    fwrite(bytes.data(), bytes.size(), 1, fout);
+    fclose(fout);
+    names.push_back(name);
+  }
+  return names;
+}
+
+static bool _checkPattern(const uint8_t* data, size_t length, size_t offset, size_t fileno) {
+  for (size_t k = 0; k < length; k++)
+    if (data[k] != _pattern(offset + k, fileno))
+      return false;
+  return true;
+}
+
+static void _testBatch(file::AsyncReadBackend backend) {
+  file::setAsyncReadBackend(backend);
+  std::vector<size_t> sizes = {1, 4095, 4096, 70000, file::kDIRECT_THRESHOLD + 17, 3 << 20};
+  auto names                = _writeTestFiles(sizes);
+
+  std::atomic<int> numcompleted = 0;
+  file::AsyncReadBatch batch;
+  for (auto& name : names)
+    batch.add(name, [&](file::asyncreadreq_ptr_t req) { numcompleted++; });
+  // partial read at an unaligned offset
+  auto partial = batch.add(names.back(), 12345, 1 << 20);
+  batch.add("/nonexistent/ork_test_asyncread.bin");
+  batch.submitAndWait();
+
+  CHECK_EQUAL(numcompleted.load(), int(names.size()));
+  for (size_t i = 0; i < names.size(); i++) {
+    auto req = batch._requests[i];
+    CHECK(req->ok());
+    CHECK_EQUAL(req->_bytesRead, sizes[i]);
+    CHECK_EQUAL(req->_data->length(), sizes[i]);
+    CHECK(_checkPattern(req->_data->data(), sizes[i], 0, i));
+  }
+  CHECK(partial->ok());
+  CHECK_EQUAL(partial->_data->length(), size_t(1 << 20));
+  CHECK(_checkPattern(partial->_data->data(), 1 << 20, 12345, names.size() - 1));
+  CHECK_EQUAL(batch._requests.back()->ok(), false);
+
+  for (auto& name : names)
+    boost::filesystem::remove(name);
+  file::setAsyncReadBackend(file::AsyncReadBackend::IO_URING);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(asyncread_uring) {
+  _testBatch(file::AsyncReadBackend::IO_URING);
+}
+
+TEST(asyncread_threadpool) {
+  _testBatch(file::AsyncReadBackend::THREADPOOL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(asyncread_destination) {
+  size_t size = 2 << 20;
+  auto names  = _writeTestFiles({size});
+  auto dest   = (uint8_t*)aligned_alloc(file::kDIRECT_ALIGN, size);
+  file::AsyncReadBatch batch(nullptr);
+  auto req = batch.add(names[0], 0, size, dest);
+  batch.submitAndWait();
+  CHECK(req->ok());
+  CHECK_EQUAL(req->_bytesRead, size);
+  CHECK(req->_data == nullptr);
+  CHECK(_checkPattern(dest, size, 0, 0));
+  free(dest);
+  auto whole = file::readFileDirect(names[0]);
+  CHECK(whole != nullptr);
+  CHECK_EQUAL(whole->length(), size);
+  boost::filesystem::remove(names[0]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(asyncread_batched_concurrent) {
+  std::vector<size_t> sizes = {100, 8192, file::kDIRECT_THRESHOLD + 1, 5000};
+  auto names                = _writeTestFiles(sizes);
+  std::atomic<int> numgood  = 0;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 16; t++)
+    threads.emplace_back([&, t]() {
+      size_t fileno = t % names.size();
+      auto block    = file::readFileBatched(names[fileno]);
+      if (block and block->length() == sizes[fileno] and _checkPattern(block->data(), sizes[fileno], 0, fileno))
+        numgood++;
+    });
+  for (auto& thr : threads)
+    thr.join();
+  CHECK_EQUAL(numgood.load(), 16);
+  CHECK(file::readFileBatched("/nonexistent/ork_test_asyncread.bin") == nullptr);
+  for (auto& name : names)
+    boost::filesystem::remove(name);
+}
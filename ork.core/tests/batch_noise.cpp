@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <utpp/UnitTest++.h>
+#include <ork/math/batch_noise.h>
+#include <random>
+#include <vector>
+
+using namespace ork;
+using namespace ork::math;
+
+namespace {
+
+struct Positions {
+  Positions(size_t count, float extent) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-extent, extent);
+    for (size_t i = 0; i < count; i++) {
+      _xs.push_back(dist(rng));
+      _ys.push_back(dist(rng));
+      _zs.push_back(dist(rng));
+    }
+  }
+  std::vector<float> _xs, _ys, _zs;
+};
+
+constexpr NoiseBasis kBases[]      = {NoiseBasis::VALUE, NoiseBasis::GRADIENT, NoiseBasis::SIMPLEX};
+constexpr NoiseFractal kFractals[] = {NoiseFractal::NONE, NoiseFractal::FBM, NoiseFractal::RIDGED};
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// simd batches must agree with the scalar kernels (odd count : exercises tails)
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(BatchNoiseMatchesScalar) {
+  constexpr size_t kCount = 1003;
+  Positions pos(kCount, 100.0f);
+  std::vector<float> out(kCount);
+  int mismatches = 0;
+  float minval   = 1.0e9f;
+  float maxval   = -1.0e9f;
+  for (auto basis : kBases) {
+    for (auto fractal : kFractals) {
+      NoiseParams params;
+      params._basis     = basis;
+      params._fractal   = fractal;
+      params._octaves   = 5;
+      params._frequency = 0.37f;
+      params._seed      = 11;
+      noise::batch2(pos._xs.data(), pos._ys.data(), out.data(), kCount, params);
+      for (size_t i = 0; i < kCount; i++) {
+        float expect = noise::sample2(fvec2(pos._xs[i], pos._ys[i]), params);
+        if (fabsf(out[i] - expect) > 1.0e-4f)
+          mismatches++;
+        minval = std::min(minval, out[i]);
+        maxval = std::max(maxval, out[i]);
+      }
+      noise::batch3(pos._xs.data(), pos._ys.data(), pos._zs.data(), out.data(), kCount, params);
+      for (size_t i = 0; i < kCount; i++) {
+        float expect = noise::sample3(fvec3(pos._xs[i], pos._ys[i], pos._zs[i]), params);
+        if (fabsf(out[i] - expect) > 1.0e-4f)
+          mismatches++;
+        minval = std::min(minval, out[i]);
+        maxval = std::max(maxval, out[i]);
+      }
+    }
+  }
+  CHECK_EQUAL(0, mismatches);
+  CHECK(minval >= -1.1f and maxval <= 1.1f);
+  CHECK(minval < -0.2f and maxval > 0.2f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// basic noise properties : zero at gradient lattice points, continuous,
+//  seeds decorrelate
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(BatchNoiseProperties) {
+  int bad = 0;
+  for (int i = -4; i <= 4; i++) {
+    if (fabsf(noise::gradient2(float(i), float(i * 3))) > 1.0e-6f)
+      bad++;
+    if (fabsf(noise::gradient3(float(i), float(-i), float(i * 2))) > 1.0e-6f)
+      bad++;
+  }
+  CHECK_EQUAL(0, bad);
+
+  float maxstep = 0.0f;
+  int differ    = 0;
+  for (int i = 0; i < 1000; i++) {
+    float x = float(i) * 0.0137f - 5.0f;
+    float y = float(i) * 0.0071f + 2.0f;
+    maxstep = std::max(maxstep, fabsf(noise::simplex2(x + 1.0e-3f, y) - noise::simplex2(x, y)));
+    maxstep = std::max(maxstep, fabsf(noise::value3(x, y + 1.0e-3f, x) - noise::value3(x, y, x)));
+    if (fabsf(noise::gradient2(x, y, 1) - noise::gradient2(x, y, 2)) > 1.0e-3f)
+      differ++;
+  }
+  CHECK(maxstep < 0.02f);
+  CHECK(differ > 900);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// grids are the same field as batches over the same positions
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(BatchNoiseGrid) {
+  constexpr int kW = 37;
+  constexpr int kH = 5;
+  NoiseParams params;
+  params._basis = NoiseBasis::SIMPLEX;
+  fvec3 origin(-3.0f, 1.5f, 0.25f);
+  fvec2 step(0.173f, 0.31f);
+  std::vector<float> grid(kW * kH);
+  noise::grid3(grid.data(), kW, kH, origin, step, params);
+  int mismatches = 0;
+  for (int j = 0; j < kH; j++) {
+    for (int i = 0; i < kW; i++) {
+      fvec3 p(origin.x + float(i) * step.x, origin.y + float(j) * step.y, origin.z);
+      if (fabsf(grid[j * kW + i] - noise::sample3(p, params)) > 1.0e-4f)
+        mismatches++;
+    }
+  }
+  noise::grid2(grid.data(), kW, kH, fvec2(origin.x, origin.y), step, params);
+  for (int j = 0; j < kH; j++) {
+    for (int i = 0; i < kW; i++) {
+      fvec2 p(origin.x + float(i) * step.x, origin.y + float(j) * step.y);
+      if (fabsf(grid[j * kW + i] - noise::sample2(p, params)) > 1.0e-4f)
+        mismatches++;
+    }
+  }
+  CHECK_EQUAL(0, mismatches);
+}
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <utpp/UnitTest++.h>
+#include <ork/gfx/envprefilter.h>
+#include <cmath>
+
+using namespace ork;
+using namespace ork::envprefilter;
+
+namespace {
+
+// radiance as a function of direction, filled into a source image
+template <typename F> EnvImage makeEnv(int w, int h, bool zpole, F fn) {
+  EnvImage img(w, h);
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) {
+      fvec3 d          = sourceDirection((float(x) + 0.5f) / float(w), (float(y) + 0.5f) / float(h), zpole);
+      img.texel(x, y) = fvec4(fn(d), 1.0f);
+    }
+  return img;
+}
+
+// standard deviation of the red channel (lower is smoother)
+float spreadOf(const EnvImage& img) {
+  double sum = 0.0, sumsq = 0.0;
+  for (const auto& t : img._texels) {
+    sum += t.x;
+    sumsq += double(t.x) * double(t.x);
+  }
+  double n    = double(img._texels.size());
+  double mean = sum / n;
+  return float(sqrt(std::max(0.0, sumsq / n - mean * mean)));
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(EnvPrefilterDirections) {
+  for (bool zpole : {false, true}) {
+    for (int i = 0; i < 64; i++) {
+      float u  = (float(i % 8) + 0.5f) / 8.0f;
+      float v  = (float(i / 8) + 0.5f) / 8.0f;
+      fvec3 d  = sourceDirection(u, v, zpole);
+      fvec2 uv = sourceUV(d, zpole);
+      CHECK_CLOSE(u, uv.x, 1.0e-4f);
+      CHECK_CLOSE(v, uv.y, 1.0e-4f);
+    }
+  }
+  fvec3 up = texelDirection(0.5f, 0.0f);
+  CHECK_CLOSE(1.0f, up.y, 1.0e-6f);
+  CHECK_EQUAL(6, numSpecularLevels(512, 256));
+  CHECK_EQUAL(1, numSpecularLevels(4, 2));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// a constant environment stays constant in every output
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(EnvPrefilterConstant) {
+  auto src = makeEnv(64, 32, true, [](const fvec3&) { return fvec3(0.25f, 0.5f, 1.0f); });
+  Params params;
+  params._sourceZPole   = true;
+  params._diffuseFlipYZ = true;
+  params._diffuseWidth  = 32;
+  auto result           = prefilter(src, params);
+  CHECK_EQUAL(size_t(numSpecularLevels(64, 32)), result._specularLevels.size());
+  CHECK_EQUAL(size_t(5), result._diffuseLevels.size()); // 32x16 .. 2x1
+  int errors = 0;
+  auto check = [&](const EnvImage& img) {
+    for (const auto& t : img._texels)
+      if (fabsf(t.x - 0.25f) > 2.0e-3f or fabsf(t.y - 0.5f) > 2.0e-3f or fabsf(t.z - 1.0f) > 4.0e-3f)
+        errors++;
+  };
+  for (const auto& level : result._specularLevels)
+    check(level);
+  for (const auto& level : result._diffuseLevels)
+    check(level);
+  CHECK_EQUAL(0, errors);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SH irradiance vs brute force cosine integration (band limited input,
+//  so SH9 is exact up to discretization)
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(EnvPrefilterIrradiance) {
+  auto radiance = [](const fvec3& d) { return fvec3(1.0f + 0.5f * d.y, 0.5f + 0.3f * d.x * d.z, 0.4f + 0.2f * d.x); };
+  auto src      = makeEnv(128, 64, false, radiance);
+  fvec3 sh9[9];
+  projectSH9(src, false, sh9);
+  const fvec3 normals[] = {
+      fvec3(0, 1, 0), //
+      fvec3(0, -1, 0),
+      fvec3(1, 0, 0),
+      fvec3(0.57735f, 0.57735f, 0.57735f)};
+  for (const auto& n : normals) {
+    double acc[3] = {0.0, 0.0, 0.0};
+    for (int y = 0; y < src._height; y++) {
+      float v       = (float(y) + 0.5f) / float(src._height);
+      double domega = (2.0 * M_PI / src._width) * (M_PI / src._height) * sin(double(v) * M_PI);
+      for (int x = 0; x < src._width; x++) {
+        fvec3 d      = sourceDirection((float(x) + 0.5f) / float(src._width), v, false);
+        double ndotl = std::max(0.0, double(d.x * n.x + d.y * n.y + d.z * n.z));
+        const auto& t = src.texel(x, y);
+        acc[0] += t.x * ndotl * domega;
+        acc[1] += t.y * ndotl * domega;
+        acc[2] += t.z * ndotl * domega;
+      }
+    }
+    fvec3 e = irradianceSH9(sh9, n);
+    CHECK_CLOSE(float(acc[0] / M_PI), e.x, 1.0e-2f);
+    CHECK_CLOSE(float(acc[1] / M_PI), e.y, 1.0e-2f);
+    CHECK_CLOSE(float(acc[2] / M_PI), e.z, 1.0e-2f);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// rougher levels are blurrier, and tiling does not change the result
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(EnvPrefilterSpecular) {
+  auto src = makeEnv(128, 64, false, [](const fvec3& d) {
+    float stripes = (sinf(d.x * 6.0f) > 0.0f) ? 1.0f : 0.0f;
+    return fvec3(stripes, stripes, stripes);
+  });
+  Params params;
+  auto levels = specularChain(src, params);
+  CHECK_EQUAL(size_t(4), levels.size());
+  CHECK_EQUAL(16, levels[3]._width);
+  CHECK_EQUAL(8, levels[3]._height);
+  for (size_t l = 1; l < levels.size(); l++)
+    CHECK(spreadOf(levels[l]) < spreadOf(levels[l - 1]));
+
+  params._rowsPerTile = 3;
+  auto retiled        = specularChain(src, params);
+  int mismatches      = 0;
+  for (size_t l = 0; l < levels.size(); l++)
+    for (size_t i = 0; i < levels[l]._texels.size(); i++)
+      if (levels[l]._texels[i].x != retiled[l]._texels[i].x)
+        mismatches++;
+  CHECK_EQUAL(0, mismatches);
+}
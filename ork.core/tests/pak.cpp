@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <utpp/UnitTest++.h>
+#include <ork/file/filedevpak.h>
+#include <ork/util/lz4block.h>
+#include <boost/filesystem.hpp>
+#include <string.h>
+
+using namespace ork;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static datablock_ptr_t _block(const std::string& str) {
+  return std::make_shared<DataBlock>(str.data(), str.length());
+}
+
+static std::string _str(datablock_constptr_t block) {
+  return std::string((const char*)block->data(), block->length());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(pak_lz4) {
+  std::string inp;
+  for (int i = 0; i < 4096; i++)
+    inp += (i & 1) ? "orkid " : std::to_string(i % 17);
+  std::vector<uint8_t> compressed(lz4::compressBound(inp.length()));
+  size_t clen = lz4::compress(inp.data(), inp.length(), compressed.data(), compressed.size());
+  CHECK(clen > 0);
+  CHECK(clen < inp.length());
+  std::string out;
+  out.resize(inp.length());
+  CHECK(lz4::decompress(compressed.data(), clen, out.data(), out.length()));
+  CHECK(out == inp);
+  CHECK_EQUAL(lz4::decompress(compressed.data(), clen - 1, out.data(), out.length()), false);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(pak_overlay) {
+  auto tmpdir    = boost::filesystem::temp_directory_path();
+  auto base_name = (tmpdir / "ork_test_base.pak").string();
+  auto ptch_name = (tmpdir / "ork_test_patch.pak").string();
+
+  std::string bigtext;
+  for (int i = 0; i < 1000; i++)
+    bigtext += "the quick brown fox ";
+
+  pak::Writer base;
+  base.addEntry("testpak://a.txt", _block("base-a"));
+  base.addEntry("testpak://b.txt", _block(bigtext), pak::Codec::LZ4);
+  CHECK(base.write(base_name));
+
+  pak::Writer patch;
+  patch.addEntry("testpak://a.txt", _block("patched-a"));
+  CHECK(patch.write(ptch_name));
+
+  auto base_archive = pak::openArchive(base_name.c_str());
+  auto ptch_archive = pak::openArchive(ptch_name.c_str());
+  CHECK(base_archive != nullptr);
+  CHECK(ptch_archive != nullptr);
+  CHECK_EQUAL(base_archive->numEntries(), 2);
+
+  FileDevPak pakdev(nullptr);
+  pakdev.mount(base_archive);
+  CHECK_EQUAL(_str(pakdev.loadDataBlock("testpak://a.txt")), "base-a");
+  pakdev.mount(ptch_archive);
+
+  /////////////////////////////////////
+  // patch overrides base, zero copy
+  /////////////////////////////////////
+  auto a = pakdev.loadDataBlock("testpak://a.txt");
+  CHECK_EQUAL(_str(a), "patched-a");
+  CHECK(a->isExternal());
+
+  /////////////////////////////////////
+  // compressed entry from base
+  /////////////////////////////////////
+  auto b_entry = base_archive->find("testpak://b.txt");
+  CHECK(b_entry->_codec == uint32_t(pak::Codec::LZ4));
+  CHECK(b_entry->_size < b_entry->_rawsize);
+  CHECK_EQUAL(_str(pakdev.loadDataBlock("testpak://b.txt")), bigtext);
+  CHECK(pakdev.loadDataBlock("testpak://c.txt") == nullptr);
+
+  /////////////////////////////////////
+  // through the File interface
+  /////////////////////////////////////
+  File file("testpak://a.txt", EFM_READ, &pakdev);
+  size_t length = 0;
+  file.GetLength(length);
+  CHECK_EQUAL(length, 9);
+  char readback[10] = {0};
+  file.Read(readback, length);
+  CHECK_EQUAL(std::string(readback), "patched-a");
+  file.Close();
+
+  /////////////////////////////////////
+  pakdev.unmount(ptch_archive);
+  CHECK_EQUAL(_str(pakdev.loadDataBlock("testpak://a.txt")), "base-a");
+  boost::filesystem::remove(base_name);
+  boost::filesystem::remove(ptch_name);
+}
@@ -6,6 +6,7 @@
 ////////////////////////////////////////////////////////////////
 
 #include "parser_lang.inl"
+#include <chrono>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -323,4 +324,88 @@ TEST(parser1) {
       "PARSER PACKRAT cache_hits<%zu> cache_misses<%zu>\n", //
       the_parser._cache_hits,                               //
       the_parser._cache_misses);                            //
-}
\ No newline at end of file
+}
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(parser1_packrat) {
+
+  std::string parse_str;
+  for (int i = 0; i < 16; i++) {
+    parse_str += FormatString(
+        "function fn%d(int x, float y) {\n"
+        "  float a = (1.0+x)*(y+2.0);\n"
+        "  float b = ((a+1.0)*(a+2.0))*((a+3.0)*(a+4.0));\n"
+        "}\n",
+        i);
+  }
+
+  /////////////////////////////////////
+  // reference parse, no memo
+  /////////////////////////////////////
+
+  MyParser the_parser;
+  the_parser._packrat       = false;
+  the_parser._collect_stats = true;
+  auto t0                   = std::chrono::steady_clock::now();
+  auto match_nomemo         = the_parser.parseString(parse_str);
+  auto t1                   = std::chrono::steady_clock::now();
+  CHECK(match_nomemo != nullptr);
+  size_t attempts_nomemo = 0;
+  uint64_t matcher_nanos = 0;
+  for (auto m : the_parser._matchers) {
+    attempts_nomemo += m->_stats._numattempts;
+    matcher_nanos += m->_stats._nanos;
+  }
+  // matcher times are exclusive, so they never add up to more than the parse
+  CHECK(matcher_nanos <= uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+
+  /////////////////////////////////////
+  // packrat parse must produce the same result
+  /////////////////////////////////////
+
+  the_parser.resetStats();
+  the_parser._packrat = true;
+  auto match_memo     = the_parser.parseString(parse_str);
+  CHECK(match_memo != nullptr);
+  CHECK_EQUAL(match_nomemo->_view->_start, match_memo->_view->_start);
+  CHECK_EQUAL(match_nomemo->_view->_end, match_memo->_view->_end);
+  size_t attempts_memo = 0;
+  for (auto m : the_parser._matchers)
+    attempts_memo += m->_stats._numattempts - m->_stats._nummemohits;
+  CHECK(attempts_memo <= attempts_nomemo);
+
+  /////////////////////////////////////
+  // memo hits are grafted into the attempt tree :
+  //  every match node's attempt is reachable from the root attempt
+  /////////////////////////////////////
+
+  std::unordered_set<const MatchAttempt*> reachable;
+  std::vector<match_attempt_constptr_t> attempt_stack{match_memo->_attempt};
+  while (not attempt_stack.empty()) {
+    auto attempt = attempt_stack.back();
+    attempt_stack.pop_back();
+    if (reachable.insert(attempt.get()).second)
+      for (auto child : attempt->_children)
+        attempt_stack.push_back(child);
+  }
+  size_t numunreachable = 0;
+  std::vector<match_ptr_t> match_stack{match_memo};
+  while (not match_stack.empty()) {
+    auto m = match_stack.back();
+    match_stack.pop_back();
+    if (reachable.find(m->_attempt.get()) == reachable.end())
+      numunreachable++;
+    for (auto child : m->_children)
+      match_stack.push_back(child);
+  }
+  CHECK(the_parser._cache_hits > 0);
+  CHECK_EQUAL(size_t(0), numunreachable);
+
+  the_parser.dumpStats();
+  printf(
+      "PARSER PACKRAT attempts_nomemo<%zu> attempts_memo<%zu> cache_hits<%zu> cache_misses<%zu>\n", //
+      attempts_nomemo,
+      attempts_memo,
+      the_parser._cache_hits,
+      the_parser._cache_misses);
+}
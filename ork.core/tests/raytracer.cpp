@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <utpp/UnitTest++.h>
+#include <ork/math/raytracer.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace ork;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// procedural bake scene : rolling heightfield plus a few spheres
+//  (the baker's .rgm inputs are exporter output, none ship in ork.data)
+///////////////////////////////////////////////////////////////////////////////
+
+struct TestScene {
+
+  TestScene(int gridsize, int numspheres) {
+    auto height = [](float x, float z) { return sinf(x * 0.35f) * cosf(z * 0.27f) * 3.0f; };
+    _vertices.reserve((gridsize + 1) * (gridsize + 1));
+    for (int iz = 0; iz <= gridsize; iz++) {
+      for (int ix = 0; ix <= gridsize; ix++) {
+        float x = float(ix) - float(gridsize) * 0.5f;
+        float z = float(iz) - float(gridsize) * 0.5f;
+        RgmVertex vtx;
+        vtx.pos = fvec3(x, height(x, z), z);
+        vtx.nrm = fvec3(0, 1, 0);
+        vtx.uv  = fvec2(float(ix) / float(gridsize), float(iz) / float(gridsize));
+        _vertices.push_back(vtx);
+      }
+    }
+    _tris.resize(gridsize * gridsize * 2);
+    _geoset = std::make_unique<RgmGeoSet>();
+    int itri = 0;
+    for (int iz = 0; iz < gridsize; iz++) {
+      for (int ix = 0; ix < gridsize; ix++) {
+        RgmVertex* v00 = &_vertices[iz * (gridsize + 1) + ix];
+        RgmVertex* v10 = v00 + 1;
+        RgmVertex* v01 = v00 + (gridsize + 1);
+        RgmVertex* v11 = v01 + 1;
+        addTriangle(_tris[itri++], v00, v10, v11);
+        addTriangle(_tris[itri++], v00, v11, v01);
+      }
+    }
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> pos(-float(gridsize) * 0.4f, float(gridsize) * 0.4f);
+    std::uniform_real_distribution<float> rad(1.0f, 4.0f);
+    for (int i = 0; i < numspheres; i++) {
+      fvec3 ctr(pos(rng), 6.0f, pos(rng));
+      auto sphere = std::make_unique<RaytSphere>(ctr, rad(rng));
+      _geoset->AddPrimitive(sphere.get());
+      _spheres.push_back(std::move(sphere));
+    }
+    _bounds = AABox();
+    _bounds.BeginGrow();
+    for (auto prim : _geoset->GetPrims()) {
+      AABox box = prim->GetAABox();
+      _bounds.Grow(box.Min());
+      _bounds.Grow(box.Max());
+    }
+    _bounds.EndGrow();
+    _bounds = AABox(_bounds.Min() - fvec3(1, 1, 1), _bounds.Max() + fvec3(1, 1, 1));
+  }
+
+  void addTriangle(RgmTri& tri, RgmVertex* a, RgmVertex* b, RgmVertex* c) {
+    tri.mpv0 = a;
+    tri.mpv1 = b;
+    tri.mpv2 = c;
+    tri.Compute();
+    auto prim      = std::make_unique<RaytTriangle>(a, b, c);
+    prim->mRgmPoly = &tri;
+    _geoset->AddPrimitive(prim.get());
+    _triprims.push_back(std::move(prim));
+  }
+
+  void attach(Scene& scene) {
+    scene.AddGeoset("caster_terrain", _geoset.get());
+    scene.InitScene(_bounds);
+  }
+  void detach(Scene& scene) {
+    scene.ExitScene();
+    scene.ClearGeoSets();
+  }
+
+  // what the grid does per cell, over every primitive
+  float bruteForce(const fray3& ray, float maxdist, const Primitive*& hitprim) const {
+    float best = maxdist;
+    hitprim    = nullptr;
+    for (auto prim : _geoset->GetPrims()) {
+      fvec3 isect;
+      float t = best;
+      if (prim->Intersect(ray, isect, t) and t > 0.0f and t < best) {
+        best    = t;
+        hitprim = prim;
+      }
+    }
+    return best;
+  }
+
+  std::vector<RgmVertex> _vertices;
+  std::vector<RgmTri> _tris;
+  std::vector<std::unique_ptr<RaytTriangle>> _triprims;
+  std::vector<std::unique_ptr<RaytSphere>> _spheres;
+  std::unique_ptr<RgmGeoSet> _geoset;
+  AABox _bounds;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+fray3 cameraRay(int x, int y, int w, int h) {
+  fvec3 eye(0.0f, 40.0f, -90.0f);
+  fvec3 target(float(x - w / 2) / float(w) * 80.0f, 0.0f, float(h / 2 - y) / float(h) * 80.0f);
+  return fray3(eye, (target - eye).normalized());
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// BVH closest hit must agree with a linear scan (triangles and spheres)
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RaytraceBvhMatchesBruteForce) {
+  TestScene ts(64, 8);
+  Scene scene;
+  ts.attach(scene);
+  CHECK(not scene.GetBvh().empty());
+
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  int mismatches = 0;
+  int numhits    = 0;
+  for (int i = 0; i < 500; i++) {
+    fvec3 from(unit(rng) * 40.0f, 30.0f + unit(rng) * 10.0f, unit(rng) * 40.0f);
+    fvec3 to(unit(rng) * 32.0f, unit(rng) * 4.0f, unit(rng) * 32.0f);
+    fray3 ray(from, (to - from).normalized());
+    const Primitive* expect_prim = nullptr;
+    float expect                 = ts.bruteForce(ray, 100000.0f, expect_prim);
+    float dist                   = 100000.0f;
+    const Primitive* prim        = nullptr;
+    bool bhit                    = scene.FindNearest(ray, dist, prim);
+    if (bhit != (expect_prim != nullptr))
+      mismatches++;
+    else if (bhit) {
+      numhits++;
+      if (fabsf(dist - expect) > 1.0e-3f)
+        mismatches++;
+    }
+    // any hit agrees with closest hit
+    if (scene.Occluded(ray, 100000.0f) != bhit)
+      mismatches++;
+  }
+  CHECK_EQUAL(0, mismatches);
+  CHECK(numhits > 250);
+  ts.detach(scene);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// 4x2 primary ray packets must agree with single rays
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RaytracePacketsMatchSingleRays) {
+  TestScene ts(64, 8);
+  Scene scene;
+  ts.attach(scene);
+
+  constexpr int kW = 64;
+  constexpr int kH = 64;
+  int mismatches   = 0;
+  for (int y = 0; y < kH; y += 2) {
+    for (int x = 0; x < kW; x += 4) {
+      BVH4Packet packet;
+      for (int lane = 0; lane < BVH4Packet::kSize; lane++) {
+        if (lane == 5 and x == 8) // a partial packet
+          continue;
+        fray3 ray = cameraRay(x + lane % 4, y + lane / 4, kW, kH);
+        packet.setRay(lane, ray.mOrigin, ray.mDirection, 0.0f, 100000.0f);
+      }
+      const Primitive* prims[BVH4Packet::kSize];
+      scene.FindNearest(packet, prims);
+      for (int lane = 0; lane < BVH4Packet::kSize; lane++) {
+        if (0 == (packet._active & (1u << lane))) {
+          if (prims[lane] != nullptr)
+            mismatches++;
+          continue;
+        }
+        fray3 ray             = cameraRay(x + lane % 4, y + lane / 4, kW, kH);
+        float dist            = 100000.0f;
+        const Primitive* prim = nullptr;
+        bool bhit             = scene.FindNearest(ray, dist, prim);
+        if (bhit != (prims[lane] != nullptr))
+          mismatches++;
+        else if (bhit and fabsf(dist - packet._tmax[lane]) > 1.0e-3f)
+          mismatches++;
+      }
+    }
+  }
+  CHECK_EQUAL(0, mismatches);
+  ts.detach(scene);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// FixedGrid vs BVH : the grid walk stops in the first leaf cell it reaches,
+//  so it may miss, but whatever it hits the BVH must hit no farther away
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RaytraceBvhCoversFixedGrid) {
+  TestScene ts(64, 8);
+  constexpr int kW = 64;
+  constexpr int kH = 64;
+
+  auto trace = [&](Scene& scene, std::vector<float>& dists) -> int {
+    int numhits = 0;
+    for (int y = 0; y < kH; y++) {
+      for (int x = 0; x < kW; x++) {
+        float dist            = 100000.0f;
+        const Primitive* prim = nullptr;
+        bool bhit             = scene.FindNearest(cameraRay(x, y, kW, kH), dist, prim);
+        dists.push_back(bhit ? dist : -1.0f);
+        numhits += bhit ? 1 : 0;
+      }
+    }
+    return numhits;
+  };
+
+  std::vector<float> griddists, bvhdists;
+  Scene grid;
+  grid.SetUseFixedGrid(true);
+  ts.attach(grid);
+  int gridhits = trace(grid, griddists);
+  ts.detach(grid);
+
+  Scene bvh;
+  ts.attach(bvh);
+  int bvhhits = trace(bvh, bvhdists);
+  ts.detach(bvh);
+
+  int mismatches = 0;
+  for (size_t i = 0; i < griddists.size(); i++) {
+    if (griddists[i] >= 0.0f and not(bvhdists[i] >= 0.0f and bvhdists[i] <= griddists[i] + 1.0e-3f))
+      mismatches++;
+  }
+  CHECK_EQUAL(0, mismatches);
+  CHECK(gridhits > 0);
+  CHECK(bvhhits >= gridhits);
+}
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <utpp/UnitTest++.h>
+#include <ork/util/scanner.h>
+#include <ork/file/path.h>
+#include <ork/kernel/timer.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+
+using namespace ork;
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+enum class ScanClass : uint64_t {
+  MULTI_LINE_COMMENT = 1,
+  SINGLE_LINE_COMMENT,
+  WHITESPACE,
+  NEWLINE,
+  NUMBER,
+  STRING,
+  KW_OR_ID,
+  PUNCTUATION,
+};
+
+scanner_ptr_t makeShaderScanner() {
+  auto scanner = std::make_shared<Scanner>("");
+  scanner->addEnumClass("\\/\\*([^*]|\\*+[^/*])*\\*+\\/", ScanClass::MULTI_LINE_COMMENT);
+  scanner->addEnumClass("\\/\\/.*[\\n\\r]", ScanClass::SINGLE_LINE_COMMENT);
+  scanner->addEnumClass("\\s+", ScanClass::WHITESPACE);
+  scanner->addEnumClass("[\\n\\r]+", ScanClass::NEWLINE);
+  scanner->addEnumClass("-?(\\d*\\.?)(\\d+)([eE][-+]?\\d+)?u?", ScanClass::NUMBER);
+  scanner->addEnumClass("[\"][^\"]*[\"]", ScanClass::STRING);
+  scanner->addEnumClass("[a-zA-Z_][a-zA-Z0-9_]*", ScanClass::KW_OR_ID);
+  scanner->addEnumClass("[{}()\\[\\]?:;<>&|*/%!+\\-=,.\\^#~]", ScanClass::PUNCTUATION);
+  scanner->buildStateMachine();
+  scanner->ignoreTokensOfClass(uint64_t(ScanClass::WHITESPACE));
+  scanner->ignoreTokensOfClass(uint64_t(ScanClass::NEWLINE));
+  scanner->ignoreTokensOfClass(uint64_t(ScanClass::SINGLE_LINE_COMMENT));
+  scanner->ignoreTokensOfClass(uint64_t(ScanClass::MULTI_LINE_COMMENT));
+  return scanner;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(scanner_tokens) {
+  auto scanner = makeShaderScanner();
+  scanner->scanString("uniform vec4 color; // comment\n"
+                      "  float x = 1.5e3;\n"
+                      "/* a\n b */ y");
+  CHECK_EQUAL(scanner->tokens.size(), 10);
+  auto tok_x = scanner->token(5);
+  CHECK_EQUAL(tok_x->text, "x");
+  CHECK_EQUAL(tok_x->iline, 1);
+  CHECK_EQUAL(tok_x->icol, 8);
+  auto tok_y = scanner->token(9);
+  CHECK_EQUAL(tok_y->text, "y");
+  CHECK_EQUAL(tok_y->iline, 3);
+  CHECK_EQUAL(tok_y->icol, 6);
+  for (const auto& tok : scanner->tokens) {
+    CHECK(scanner->tokenView(tok) == tok.text);
+  }
+  /////////////////////////////////////
+  // same grammar, shared tables
+  /////////////////////////////////////
+  auto scanner2 = makeShaderScanner();
+  CHECK_EQUAL(scanner->_grammarhash, scanner2->_grammarhash);
+  CHECK(scanner->_statemachine == scanner2->_statemachine);
+  /////////////////////////////////////
+  // a grown grammar rebuilds with its own hash,
+  //  rebuilding an unchanged one keeps it
+  /////////////////////////////////////
+  auto oldhash = scanner2->_grammarhash;
+  scanner2->buildStateMachine();
+  CHECK_EQUAL(oldhash, scanner2->_grammarhash);
+  scanner2->clear();
+  scanner2->addRule("@[a-z]+", 100);
+  scanner2->buildStateMachine();
+  CHECK(oldhash != scanner2->_grammarhash);
+  CHECK(scanner->_statemachine != scanner2->_statemachine);
+  scanner2->scanString("@tag x");
+  CHECK_EQUAL(scanner2->tokens.size(), 2);
+  CHECK_EQUAL(scanner2->tokens[0].text, "@tag");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// scan throughput over the glfx shader corpus
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(scanner_throughput) {
+  using namespace boost::filesystem;
+  auto shader_dir = (file::Path::data_dir() / "platform_lev2" / "shaders" / "glfx").toBFS();
+  if (not exists(shader_dir)) {
+    printf("scanner_throughput: no shader corpus at <%s>\n", shader_dir.c_str());
+    return;
+  }
+  std::vector<std::string> corpus;
+  size_t numbytes = 0;
+  for (auto& entry : directory_iterator(shader_dir)) {
+    auto ext = entry.path().extension().string();
+    if (ext != ".glfx" and ext != ".i")
+      continue;
+    std::ifstream inp(entry.path().string());
+    std::stringstream ss;
+    ss << inp.rdbuf();
+    corpus.push_back(ss.str());
+    numbytes += corpus.back().length();
+  }
+  /////////////////////////////////////
+  double t0    = ork::get_sync_time();
+  auto scanner = makeShaderScanner();
+  double t1    = ork::get_sync_time();
+  /////////////////////////////////////
+  constexpr int knumpasses = 8;
+  size_t numtokens         = 0;
+  for (int pass = 0; pass < knumpasses; pass++) {
+    for (const auto& text : corpus) {
+      scanner->clear();
+      scanner->scanString(text);
+      numtokens += scanner->tokens.size();
+    }
+  }
+  double t2      = ork::get_sync_time();
+  double elapsed = t2 - t1;
+  double mbytes  = double(numbytes * knumpasses) / double(1 << 20);
+  printf(
+      "scanner_throughput files<%zu> bytes<%zu> tokens<%zu> dfa_setup<%g> elapsed<%g> MBpersec<%g>\n",
+      corpus.size(),
+      numbytes,
+      numtokens / knumpasses,
+      t1 - t0,
+      elapsed,
+      mbytes / elapsed);
+  CHECK(numtokens > 0);
+}
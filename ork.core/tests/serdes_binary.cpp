@@ -10,75 +10,135 @@
 #include <limits>
 #include <string.h>
 
-//#include <ork/reflect/serialize/BinaryDeserializer.h>
-//#include <ork/reflect/serialize/BinarySerializer.h>
-#include <ork/stream/FileInputStream.h>
-#include <ork/stream/FileOutputStream.h>
-#include <ork/stream/StringInputStream.h>
-#include <ork/stream/StringOutputStream.h>
-#include <ork/kernel/string/ArrayString.h>
+#include <ork/reflect/serialize/BinaryDeserializer.h>
+#include <ork/reflect/serialize/BinarySerializer.h>
+#include <ork/reflect/serialize/JsonSerializer.h>
 #include <ork/util/hotkey.h>
 #include "reflectionclasses.inl"
 #include <boost/uuid/uuid_io.hpp>
-#include <ork/util/hexdump.inl>
+#include <ork/util/logger.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 using namespace ork;
-using namespace ork::file;
 using namespace ork::reflect;
-using namespace ork::rtti;
-using namespace ork::stream;
-using storage_type = ArrayString<65536>;
-/*
+
+std::string svp_generate();  // serdes_vector.cpp
+std::string math_generate(); // serdes_math.cpp
+
 ///////////////////////////////////////////////////////////////////////////////
 
-std::shared_ptr<storage_type> hkeyToStorage() {
-  ork::HotKeyConfiguration hkeys;
-  hkeys.Default();
-  auto resultdata = std::make_shared<storage_type>();
-  stream::StringOutputStream out_stream(*resultdata);
-  serdes::BinarySerializer ser(out_stream);
-  bool serok = ser.serializeObject(&hkeys);
-  OrkAssert(serok);
-  return resultdata;
+TEST(SerdesBinaryHotKeys) {
+  auto hkeys = std::make_shared<ork::HotKeyConfiguration>();
+  hkeys->Default();
+  ///////////////////////////////////////////
+  serdes::JsonSerializer jser;
+  jser.serializeRoot(hkeys);
+  auto jsondata = jser.output();
+  serdes::BinarySerializer bser;
+  bser.serializeRoot(hkeys);
+  auto bindata = bser.output();
+  CHECK(serdes::binary::isBinary(bindata.data(), bindata.length()));
+  CHECK(bindata.length() < jsondata.length());
+  ///////////////////////////////////////////
+  // lossless conversion back to json
+  ///////////////////////////////////////////
+  CHECK_EQUAL(serdes::binaryToJson(bindata), jsondata);
+  CHECK(serdes::jsonToBinary(jsondata) == bindata);
+  ///////////////////////////////////////////
+  object_ptr_t instance_out;
+  serdes::BinaryDeserializer deser(bindata);
+  deser.deserializeTop(instance_out);
+  CHECK(deser._numSchemaMatches > 0);
+  CHECK_EQUAL(deser._numSchemaMismatches, 0);
+  auto as_hkc = std::dynamic_pointer_cast<HotKeyConfiguration>(instance_out);
+  CHECK(as_hkc != nullptr);
+  CHECK_EQUAL(boost::uuids::to_string(as_hkc->_uuid), boost::uuids::to_string(hkeys->_uuid));
+  auto save_a = hkeys->GetHotKey("save");
+  auto save_b = as_hkc->GetHotKey("save");
+  CHECK_EQUAL(save_a->miKeyCode, save_b->miKeyCode);
+  CHECK_EQUAL(save_a->mbCtrl, save_b->mbCtrl);
+  CHECK_EQUAL(save_a->mbAlt, save_b->mbAlt);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-TEST(SerializeObjectBinary) {
-  auto resultdata = hkeyToStorage();
-  printf("////////////////////////////////////////////////////////////////////////\n");
-  printf("SerializeObjectBinary dump\n");
-  hexdumpbytes((const uint8_t*)resultdata->data(), resultdata->length());
-  printf("////////////////////////////////////////////////////////////////////////\n");
+TEST(SerdesBinaryVector) {
+  auto bindata = serdes::jsonToBinary(svp_generate());
+  object_ptr_t instance_out;
+  serdes::BinaryDeserializer deser(bindata);
+  deser.deserializeTop(instance_out);
+  auto typed = std::dynamic_pointer_cast<VectorTest>(instance_out);
+  CHECK_EQUAL(typed->_directintvect.size(), 4);
+  CHECK_EQUAL(typed->_directintvect[3], 42);
+  CHECK_EQUAL(typed->_directstrvect[2], "three");
+  CHECK_EQUAL(typed->_directobjvect[1]->_strvalue, "two");
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// math types go through the packed (memcpy) path
 ///////////////////////////////////////////////////////////////////////////////
 
-TEST(SerializeSharedObjectBinary) {
-  auto hkeys = std::make_shared<ork::HotKeyConfiguration>();
-  hkeys->Default();
-  auto resultdata = std::make_shared<storage_type>();
-  stream::StringOutputStream out_stream(*resultdata);
-  serdes::BinarySerializer ser(out_stream);
-  bool serok = ser.serializeSharedObject(hkeys);
-  printf("////////////////////////////////////////////////////////////////////////\n");
-  printf("SerializeSharedObjectBinary dump\n");
-  hexdumpbytes((const uint8_t*)resultdata->data(), resultdata->length());
-  printf("////////////////////////////////////////////////////////////////////////\n");
+TEST(SerdesBinaryMath) {
+  float this_EPSILON = 0.0001;
+  auto bindata       = serdes::jsonToBinary(math_generate());
+  object_ptr_t instance_out;
+  serdes::BinaryDeserializer deser(bindata);
+  deser.deserializeTop(instance_out);
+  auto clone = std::dynamic_pointer_cast<MathTest>(instance_out);
+  CHECK_CLOSE(clone->_fvec3.z, 6.0f, this_EPSILON);
+  CHECK_CLOSE(clone->_fvec4.w, 10.0f, this_EPSILON);
+  CHECK_CLOSE(clone->_fquat.x, 11.0f, this_EPSILON);
+  const float* mtx4e = clone->_fmtx4.asArray();
+  CHECK_CLOSE(mtx4e[0], 1.0f, this_EPSILON);
+  CHECK_CLOSE(mtx4e[15], 1.0f, this_EPSILON);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// only int32 or all-double arrays are packed, anything else
+//  (mixed, 64 bit, large unsigned) must come back bit exact
 ///////////////////////////////////////////////////////////////////////////////
 
-TEST(DeserializeObjectBinary) {
-  auto resultdata = hkeyToStorage();
-  auto pstr       = PieceString(resultdata->data(), resultdata->length());
-  stream::StringInputStream inp_stream(pstr);
-  serdes::BinaryDeserializer deser(inp_stream);
-  rtti::castable_rawptr_t pcastable = nullptr;
-  bool serok                        = deser.deserializeObject(pcastable);
-  CHECK(serok);
+TEST(SerdesBinaryArrayKinds) {
+  std::string jsondata = R"({"root":{
+    "ints":[1,-2,3],
+    "floats":[0.5,1.25,-3.0],
+    "doubles":[0.1,0.2],
+    "mixed":[1,2.5],
+    "wideint":[1,16777217],
+    "uint32":[1,4294967295],
+    "int64":[-1,-5000000000],
+    "uint64":[1,18446744073709551615]
+  }})";
+  auto roundtrip = serdes::binaryToJson(serdes::jsonToBinary(jsondata));
+  rapidjson::Document src, dst;
+  src.Parse(jsondata.c_str());
+  dst.Parse(roundtrip.c_str());
+  CHECK(dst.IsObject() and dst.HasMember("root"));
+  const auto& srcroot = src["root"];
+  const auto& dstroot = dst["root"];
+  size_t nummismatches = 0;
+  for (auto it = srcroot.MemberBegin(); it != srcroot.MemberEnd(); ++it) {
+    const auto& a = it->value;
+    const auto& b = dstroot[it->name];
+    CHECK_EQUAL(a.Size(), b.Size());
+    for (rapidjson::SizeType i = 0; i < a.Size(); i++) {
+      bool same = (a[i].IsInt() == b[i].IsInt())         //
+                  and (a[i].IsUint() == b[i].IsUint())     //
+                  and (a[i].IsInt64() == b[i].IsInt64())   //
+                  and (a[i].IsUint64() == b[i].IsUint64()) //
+                  and (a[i].IsDouble() == b[i].IsDouble());
+      if (a[i].IsUint64())
+        same = same and (a[i].GetUint64() == b[i].GetUint64());
+      else if (a[i].IsInt64())
+        same = same and (a[i].GetInt64() == b[i].GetInt64());
+      else
+        same = same and (a[i].GetDouble() == b[i].GetDouble());
+      if (not same) {
+        logerrchannel()->log("array<%s> item<%u> changed kind or value", it->name.GetString(), i);
+        nummismatches++;
+      }
+    }
+  }
+  CHECK_EQUAL(nummismatches, 0);
 }
-*/
-///////////////////////////////////////////////////////////////////////////////
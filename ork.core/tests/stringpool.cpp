@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <utpp/UnitTest++.h>
+#include <ork/kernel/string/StringPool.h>
+#include <ork/kernel/opq.h>
+#include <ork/kernel/timer.h>
+#include <ork/kernel/string/string.h>
+#include <string.h>
+#include <unordered_set>
+
+using namespace ork;
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(stringpool_basic) {
+  StringPool pool;
+  auto a  = pool.String("hello");
+  auto b  = pool.String(PieceString("hello world", 5));
+  auto c  = pool.Literal("world");
+  auto nf = pool.Find("nothere");
+  CHECK(a.c_str() == b.c_str());
+  CHECK(a == b);
+  CHECK(a != c);
+  CHECK(a < c);
+  CHECK_EQUAL(a.length(), size_t(5));
+  CHECK_EQUAL(a.hash(), StringPool::hashString("hello", 5));
+  CHECK(std::hash<PoolString>()(a) == std::hash<PoolString>()(b));
+  CHECK(pool.Find("world") == c);
+  CHECK_EQUAL(bool(nf), false);
+  CHECK_EQUAL(pool.Size(), 2);
+  CHECK(pool.FromIndex(pool.FindIndex("world")) == c);
+  // same text from an independent pool still compares equal
+  StringPool other;
+  auto d = other.String("hello");
+  CHECK(d.c_str() != a.c_str());
+  CHECK(d == a);
+  // child pools resolve through the parent
+  StringPool child(&pool);
+  CHECK(child.String("hello").c_str() == a.c_str());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// contention benchmark :
+//  every opq worker interns the same (overlapping) name set,
+//  all of them must agree on a single pointer per string.
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(stringpool_contention) {
+  constexpr int knumnames = 1 << 14;
+  constexpr int knumtasks = 64;
+  std::vector<std::string> names;
+  for (int i = 0; i < knumnames; i++)
+    names.push_back(FormatString("reflect.class<%d>.property<%d>", i % 97, i));
+
+  StringPool pool;
+  std::vector<std::vector<const char*>> results(knumtasks);
+  auto q = opq::concurrentQueue();
+
+  ork::Timer timer;
+  timer.Start();
+  for (int t = 0; t < knumtasks; t++) {
+    q->enqueue([&, t]() {
+      auto& out = results[t];
+      out.resize(knumnames);
+      // walk in a task dependant order so inserts collide
+      for (int i = 0; i < knumnames; i++) {
+        int n  = (i * 7919 + t * 131) % knumnames;
+        out[n] = pool.String(names[n].c_str()).c_str();
+      }
+    });
+  }
+  q->drain();
+  float elapsed = timer.SecsSinceStart();
+  printf(
+      "stringpool_contention: %d interns in %g sec (%g M/sec)\n", //
+      knumnames * knumtasks,
+      elapsed,
+      double(knumnames * knumtasks) / double(elapsed) * 1e-6);
+
+  CHECK_EQUAL(pool.Size(), knumnames);
+  std::unordered_set<const char*> unique;
+  for (int i = 0; i < knumnames; i++) {
+    const char* first = results[0][i];
+    CHECK(0 == strcmp(first, names[i].c_str()));
+    for (int t = 1; t < knumtasks; t++)
+      CHECK(results[t][i] == first);
+    unique.insert(first);
+  }
+  CHECK_EQUAL(unique.size(), size_t(knumnames));
+}
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/math/batch_noise.h>
+#include <ork/math/perlin_noise.h>
+#include <ork/kernel/timer.h>
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace po = ::boost::program_options;
+
+using namespace ork;
+using namespace ork::math;
+
+///////////////////////////////////////////////////////////////////////////////
+// throughput in samples/sec : fbm, per point vs batch vs grid,
+//  with the legacy cached PerlinNoiseGenerator for reference
+///////////////////////////////////////////////////////////////////////////////
+
+static int _bench(int dim, int octaves) {
+  size_t count = size_t(dim) * size_t(dim);
+  std::vector<float> xs, ys, zs;
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(-64.0f, 64.0f);
+  for (size_t i = 0; i < count; i++) {
+    xs.push_back(dist(rng));
+    ys.push_back(dist(rng));
+    zs.push_back(dist(rng));
+  }
+  std::vector<float> out(count);
+  ork::Timer timer;
+
+  printf("batchnoise simd<%s> width<%d> samples<%zu> octaves<%d>\n", noise::simdName(), noise::simdWidth(), count, octaves);
+
+  PerlinNoiseGenerator legacy;
+  for (int o = 0; o < octaves; o++)
+    legacy.AddOctave(float(1 << o) * 0.25f, 1.0f / float(1 << o), fvec2(0, 0), o, 64);
+  timer.Start();
+  float legacysum = 0.0f;
+  for (size_t i = 0; i < count; i++)
+    legacysum += legacy.ValueAt(fvec2(fabsf(xs[i]), fabsf(ys[i])));
+  double legacytime = timer.SecsSinceStart();
+  printf("batchnoise legacy perlin fbm : %g Msamples/s (%g)\n", double(count) / legacytime * 1.0e-6, legacysum);
+
+  for (auto basis : {NoiseBasis::VALUE, NoiseBasis::GRADIENT, NoiseBasis::SIMPLEX}) {
+    NoiseParams params;
+    params._basis     = basis;
+    params._octaves   = octaves;
+    params._frequency = 0.25f;
+    const char* name  = (basis == NoiseBasis::VALUE)      ? "value"
+                        : (basis == NoiseBasis::GRADIENT) ? "gradient"
+                                                          : "simplex";
+
+    timer.Start();
+    for (size_t i = 0; i < count; i++)
+      out[i] = noise::sample2(fvec2(xs[i], ys[i]), params);
+    double scalartime = timer.SecsSinceStart();
+
+    timer.Start();
+    noise::batch2(xs.data(), ys.data(), out.data(), count, params);
+    double batchtime = timer.SecsSinceStart();
+
+    timer.Start();
+    noise::grid2(out.data(), dim, dim, fvec2(-64.0f, -64.0f), fvec2(0.25f, 0.25f), params);
+    double gridtime = timer.SecsSinceStart();
+
+    timer.Start();
+    noise::batch3(xs.data(), ys.data(), zs.data(), out.data(), count, params);
+    double batch3time = timer.SecsSinceStart();
+
+    printf(
+        "batchnoise %s fbm Msamples/s : scalar2d<%g> batch2d<%g> grid2d<%g> batch3d<%g> (x%g)\n",
+        name,
+        double(count) / scalartime * 1.0e-6,
+        double(count) / batchtime * 1.0e-6,
+        double(count) / gridtime * 1.0e-6,
+        double(count) / batch3time * 1.0e-6,
+        scalartime / batchtime);
+  }
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+  po::options_description desc("orkid batch noise benchmark");
+
+  desc.add_options()                                                        //
+      ("help", "produce help message")                                      //
+      ("dim", po::value<int>()->default_value(512), "samples per side")     //
+      ("octaves", po::value<int>()->default_value(5), "fbm octave count");
+
+  po::variables_map vars;
+  po::store(po::parse_command_line(argc, argv, desc), vars);
+  po::notify(vars);
+  if (vars.count("help")) {
+    std::cout << desc << "\n";
+    return 0;
+  }
+
+  return _bench(vars["dim"].as<int>(), vars["octaves"].as<int>());
+}
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/file/filedevpak.h>
+#include <ork/file/path.h>
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+#include <iostream>
+#include <fstream>
+#include <set>
+
+namespace po = ::boost::program_options;
+namespace bfs = ::boost::filesystem;
+
+///////////////////////////////////////////////////////////////////////////////
+
+int list_pak(const std::string& pakname) {
+  using namespace ork;
+  auto archive = pak::openArchive(file::Path(pakname.c_str()));
+  if (nullptr == archive) {
+    printf("could not open pak<%s>\n", pakname.c_str());
+    return -1;
+  }
+  for (size_t i = 0; i < archive->numEntries(); i++) {
+    auto entry = archive->entry(i);
+    printf(
+        "offset<%10zu> size<%10zu> raw<%10zu> codec<%u> hash<%016zx> %s\n", //
+        size_t(entry->_offset),
+        size_t(entry->_size),
+        size_t(entry->_rawsize),
+        entry->_codec,
+        size_t(entry->_pathhash),
+        archive->pathOf(entry));
+  }
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv, char** envp) {
+
+  auto desc = std::make_shared<po::options_description>("orkid pak tool");
+
+  ////////////////////////////////////
+
+  auto rval =                          //
+      desc->add_options()              //
+      ("help", "produce help message") //
+      ("root", po::value<std::string>()->default_value(""), "folder to pack") //
+      ("uriproto", po::value<std::string>()->default_value("data://"), "uri protocol of packed paths") //
+      ("order", po::value<std::string>()->default_value(""), "recorded load order (one path per line)") //
+      ("out", po::value<std::string>()->default_value(""), "output pak") //
+      ("lz4", "lz4 compress entries (when it saves space)") //
+      ("list", po::value<std::string>()->default_value(""), "list entries of a pak");
+
+  ////////////////////////////////////
+
+  auto vars = std::make_shared<po::variables_map>();
+  if (desc) {
+    auto cmdline = po::parse_command_line(argc, argv, *desc);
+    po::store(cmdline, *vars);
+    po::notify(*vars);
+  }
+  if (vars->count("help")) {
+    std::cout << (*desc) << "\n";
+    exit(0);
+  }
+
+  //////////////////////////////////////////////////////////////
+
+  using namespace ork;
+
+  auto listname = (*vars)["list"].as<std::string>();
+  if (listname.length())
+    return list_pak(listname);
+
+  auto root     = bfs::path((*vars)["root"].as<std::string>());
+  auto uriproto = (*vars)["uriproto"].as<std::string>();
+  auto outname  = (*vars)["out"].as<std::string>();
+  auto codec    = vars->count("lz4") ? pak::Codec::LZ4 : pak::Codec::NONE;
+
+  if (outname.empty() or not bfs::is_directory(root)) {
+    std::cout << (*desc) << "\n";
+    return -1;
+  }
+
+  //////////////////////////////////////////////////////////////
+  // gather files : key -> disk path
+  //////////////////////////////////////////////////////////////
+
+  std::map<std::string, bfs::path> files;
+  for (auto& item : bfs::recursive_directory_iterator(root)) {
+    if (not bfs::is_regular_file(item.path()))
+      continue;
+    auto relpath = bfs::relative(item.path(), root).generic_string();
+    files[uriproto + relpath] = item.path();
+  }
+
+  //////////////////////////////////////////////////////////////
+  // layout : recorded load order first, then the rest by path
+  //////////////////////////////////////////////////////////////
+
+  std::vector<std::string> layout;
+  std::set<std::string> placed;
+  auto ordername = (*vars)["order"].as<std::string>();
+  if (ordername.length()) {
+    std::ifstream order(ordername);
+    std::string line;
+    while (std::getline(order, line)) {
+      if (files.count(line) and placed.insert(line).second)
+        layout.push_back(line);
+    }
+  }
+  for (const auto& item : files) {
+    if (placed.insert(item.first).second)
+      layout.push_back(item.first);
+  }
+
+  //////////////////////////////////////////////////////////////
+
+  pak::Writer writer;
+  size_t numbytes = 0;
+  for (const auto& key : layout) {
+    const auto& diskpath = files[key];
+    std::ifstream inp(diskpath.string(), std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(inp)), std::istreambuf_iterator<char>());
+    auto block = std::make_shared<DataBlock>(bytes.data(), bytes.size());
+    writer.addEntry(file::Path(key.c_str()), block, codec);
+    numbytes += bytes.size();
+  }
+  bool OK = writer.write(outname);
+  printf("pak<%s> entries<%zu> rawbytes<%zu> ok<%d>\n", outname.c_str(), layout.size(), numbytes, int(OK));
+  return OK ? 0 : -1;
+}
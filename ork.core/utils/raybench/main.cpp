@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/math/raytracer.h>
+#include <ork/kernel/timer.h>
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <memory>
+#include <random>
+
+namespace po = ::boost::program_options;
+
+using namespace ork;
+
+///////////////////////////////////////////////////////////////////////////////
+// procedural bake scene : rolling heightfield plus a few spheres
+//  (same as the raytracer unit tests, the baker's .rgm inputs are
+//  exporter output, none ship in ork.data)
+///////////////////////////////////////////////////////////////////////////////
+
+struct BenchScene {
+
+  BenchScene(int gridsize, int numspheres) {
+    auto height = [](float x, float z) { return sinf(x * 0.35f) * cosf(z * 0.27f) * 3.0f; };
+    _vertices.reserve((gridsize + 1) * (gridsize + 1));
+    for (int iz = 0; iz <= gridsize; iz++) {
+      for (int ix = 0; ix <= gridsize; ix++) {
+        float x = float(ix) - float(gridsize) * 0.5f;
+        float z = float(iz) - float(gridsize) * 0.5f;
+        RgmVertex vtx;
+        vtx.pos = fvec3(x, height(x, z), z);
+        vtx.nrm = fvec3(0, 1, 0);
+        vtx.uv  = fvec2(float(ix) / float(gridsize), float(iz) / float(gridsize));
+        _vertices.push_back(vtx);
+      }
+    }
+    _tris.resize(gridsize * gridsize * 2);
+    _geoset  = std::make_unique<RgmGeoSet>();
+    int itri = 0;
+    for (int iz = 0; iz < gridsize; iz++) {
+      for (int ix = 0; ix < gridsize; ix++) {
+        RgmVertex* v00 = &_vertices[iz * (gridsize + 1) + ix];
+        RgmVertex* v10 = v00 + 1;
+        RgmVertex* v01 = v00 + (gridsize + 1);
+        RgmVertex* v11 = v01 + 1;
+        addTriangle(_tris[itri++], v00, v10, v11);
+        addTriangle(_tris[itri++], v00, v11, v01);
+      }
+    }
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> pos(-float(gridsize) * 0.4f, float(gridsize) * 0.4f);
+    std::uniform_real_distribution<float> rad(1.0f, 4.0f);
+    for (int i = 0; i < numspheres; i++) {
+      fvec3 ctr(pos(rng), 6.0f, pos(rng));
+      auto sphere = std::make_unique<RaytSphere>(ctr, rad(rng));
+      _geoset->AddPrimitive(sphere.get());
+      _spheres.push_back(std::move(sphere));
+    }
+    _bounds = AABox();
+    _bounds.BeginGrow();
+    for (auto prim : _geoset->GetPrims()) {
+      AABox box = prim->GetAABox();
+      _bounds.Grow(box.Min());
+      _bounds.Grow(box.Max());
+    }
+    _bounds.EndGrow();
+    _bounds = AABox(_bounds.Min() - fvec3(1, 1, 1), _bounds.Max() + fvec3(1, 1, 1));
+  }
+
+  void addTriangle(RgmTri& tri, RgmVertex* a, RgmVertex* b, RgmVertex* c) {
+    tri.mpv0 = a;
+    tri.mpv1 = b;
+    tri.mpv2 = c;
+    tri.Compute();
+    auto prim      = std::make_unique<RaytTriangle>(a, b, c);
+    prim->mRgmPoly = &tri;
+    _geoset->AddPrimitive(prim.get());
+    _triprims.push_back(std::move(prim));
+  }
+
+  void attach(Scene& scene) {
+    scene.AddGeoset("caster_terrain", _geoset.get());
+    scene.InitScene(_bounds);
+  }
+  void detach(Scene& scene) {
+    scene.ExitScene();
+    scene.ClearGeoSets();
+  }
+
+  std::vector<RgmVertex> _vertices;
+  std::vector<RgmTri> _tris;
+  std::vector<std::unique_ptr<RaytTriangle>> _triprims;
+  std::vector<std::unique_ptr<RaytSphere>> _spheres;
+  std::unique_ptr<RgmGeoSet> _geoset;
+  AABox _bounds;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static fray3 cameraRay(int x, int y, int w, int h) {
+  fvec3 eye(0.0f, 40.0f, -90.0f);
+  fvec3 target(float(x - w / 2) / float(w) * 80.0f, 0.0f, float(h / 2 - y) / float(h) * 80.0f);
+  return fray3(eye, (target - eye).normalized());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// FixedGrid vs BVH build and trace timing
+//  (keep the grid small, it allocates a list node per covered cell)
+//  (the grid walk stops in the first leaf cell it reaches, so its hit
+//   count is lower, the raytracer unit tests check what it does hit)
+///////////////////////////////////////////////////////////////////////////////
+
+static int _bench(int gridsize, int numspheres, int w, int h) {
+  BenchScene bs(gridsize, numspheres);
+
+  auto trace_single = [&](Scene& scene) -> int {
+    int numhits = 0;
+    for (int y = 0; y < h; y++) {
+      for (int x = 0; x < w; x++) {
+        float dist            = 100000.0f;
+        const Primitive* prim = nullptr;
+        numhits += scene.FindNearest(cameraRay(x, y, w, h), dist, prim) ? 1 : 0;
+      }
+    }
+    return numhits;
+  };
+
+  ork::Timer timer;
+
+  Scene grid;
+  grid.SetUseFixedGrid(true);
+  timer.Start();
+  bs.attach(grid);
+  double gridbuild = timer.SecsSinceStart();
+  timer.Start();
+  int gridhits     = trace_single(grid);
+  double gridtrace = timer.SecsSinceStart();
+  bs.detach(grid);
+
+  Scene bvh;
+  timer.Start();
+  bs.attach(bvh);
+  double bvhbuild = timer.SecsSinceStart();
+  timer.Start();
+  int bvhhits     = trace_single(bvh);
+  double bvhtrace = timer.SecsSinceStart();
+
+  timer.Start();
+  int packethits = 0;
+  for (int y = 0; y < h; y += 2) {
+    for (int x = 0; x < w; x += 4) {
+      BVH4Packet packet;
+      for (int lane = 0; lane < BVH4Packet::kSize; lane++) {
+        fray3 ray = cameraRay(x + lane % 4, y + lane / 4, w, h);
+        packet.setRay(lane, ray.mOrigin, ray.mDirection, 0.0f, 100000.0f);
+      }
+      const Primitive* prims[BVH4Packet::kSize];
+      bvh.FindNearest(packet, prims);
+      for (int lane = 0; lane < BVH4Packet::kSize; lane++)
+        packethits += (prims[lane] != nullptr) ? 1 : 0;
+    }
+  }
+  double packettrace = timer.SecsSinceStart();
+  bs.detach(bvh);
+
+  double numrays = double(w * h);
+  printf(
+      "raytracer prims<%zu> grid: build<%g ms> trace<%g us/ray> hits<%d>\n",
+      bs._geoset->GetPrims().size(),
+      gridbuild * 1000.0,
+      gridtrace * 1.0e6 / numrays,
+      gridhits);
+  printf(
+      "raytracer bvh: build<%g ms> single<%g us/ray> packet<%g us/ray> hits<%d> packethits<%d>\n",
+      bvhbuild * 1000.0,
+      bvhtrace * 1.0e6 / numrays,
+      packettrace * 1.0e6 / numrays,
+      bvhhits,
+      packethits);
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+  po::options_description desc("orkid bake raytracer benchmark");
+
+  desc.add_options()                                                                        //
+      ("help", "produce help message")                                                      //
+      ("grid", po::value<int>()->default_value(96), "heightfield cells per side (2 tris each)") //
+      ("spheres", po::value<int>()->default_value(16), "number of spheres")                 //
+      ("res", po::value<int>()->default_value(256), "camera rays per side");
+
+  po::variables_map vars;
+  po::store(po::parse_command_line(argc, argv, desc), vars);
+  po::notify(vars);
+  if (vars.count("help")) {
+    std::cout << desc << "\n";
+    return 0;
+  }
+
+  int res = vars["res"].as<int>();
+  return _bench(vars["grid"].as<int>(), vars["spheres"].as<int>(), res, res);
+}
@@ -3,6 +3,7 @@ import "brdftools.i";
 import "deftools.i";
 import "fwdtools.i";
 import "skintools.i";
+import "vtxquant.i";
 ///////////////////////////////////////////////////////////////
 // Interfaces
 ///////////////////////////////////////////////////////////////
@@ -1097,3 +1098,183 @@ fragment_shader ps_pick //
   out_uv  = vec4(frg_uv, 0, 0);
 }
 ///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+// QUANTIZED VERTEX STREAMS (xgm V8N4B4T8 / V8N4B4T4I4W4)
+//  mono only, stereo techniques have no _Q variants yet
+///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+vertex_interface iface_vgbuffer_q : ub_vtx : ub_vtx_dequant {
+  inputs {
+    vec4 qposition : POSITION;
+    vec2 qnormal : NORMAL;
+    vec2 qbinormal : BINORMAL;
+    vec2 uv0 : TEXCOORD0;
+  }
+  outputs {
+    vec4 frg_wpos;
+    vec4 frg_clr;
+    vec2 frg_uv0;
+    mat3 frg_tbn;
+    float frg_camdist;
+    vec3 frg_camz;
+  }
+}
+///////////////////////////////////////////////////////////////
+vertex_interface iface_vgbuffer_instanced_q : iface_vgbuffer_q {
+  outputs {
+    vec4 frg_modcolor;
+  }
+}
+///////////////////////////////////////////////////////////////
+vertex_interface iface_vgbuffer_skinned_q : iface_vgbuffer_q : iface_skintools {
+}
+///////////////////////////////////////////////////////////////
+vertex_interface iface_vdprepass_q : ub_vtx : ub_vtx_dequant {
+  inputs {
+    vec4 qposition : POSITION;
+  }
+  outputs {
+    float frg_depth;
+  }
+}
+///////////////////////////////////////////////////////////////
+vertex_interface iface_vdprepass_skinned_q : iface_vdprepass_q : iface_skintools {
+}
+///////////////////////////////////////////////////////////////
+vertex_interface iface_vtx_pick_rigid_q : ub_vtx_dequant {
+  inputs {
+    vec4 qposition : POSITION;
+    vec2 qnormal : NORMAL;
+    uvec3 pickSUBID : TEXCOORD1;
+  }
+  outputs {
+    vec3 frg_wpos;
+    vec3 frg_wnrm;
+    vec2 frg_uv;
+    flat uvec3 frg_pickSUBID;
+  }
+}
+///////////////////////////////////////////////////////////////
+vertex_interface iface_vtx_pick_skinned_q : ub_vtx_dequant : iface_skintools {
+  inputs {
+    vec4 qposition : POSITION;
+    vec2 qnormal : NORMAL;
+    vec2 uv0 : TEXCOORD0;
+    uvec3 pickSUBID : TEXCOORD1;
+  }
+  outputs {
+    vec3 frg_wpos;
+    vec3 frg_wnrm;
+    vec2 frg_uv;
+    flat uvec3 frg_pickSUBID;
+  }
+}
+///////////////////////////////////////////////////////////////
+libblock lib_pbr_vtx_q : lib_vtx_dequant {
+  void vs_common_q(vec4 pos, vec3 nrm, vec3 bin) {
+    vec4 cpos       = mv * pos;
+    vec3 wnormal    = normalize(mrot * nrm);
+    vec3 wbitangent = normalize(mrot * bin); // technically binormal is a bitangent
+    vec3 wtangent   = cross(wbitangent, wnormal);
+    frg_wpos        = m * pos;
+    frg_clr         = vec4(1, 1, 1, 1);
+    frg_uv0         = uv0 * vec2(1, -1);
+    frg_tbn         = mat3(wtangent, wbitangent, wnormal);
+    frg_camz        = wnormal.xyz;
+    frg_camdist     = -cpos.z;
+  }
+}
+///////////////////////////////////////////////////////////////
+libblock lib_vtx_instance_matrix {
+  mat4 instanceMatrix() {
+    int matrix_v = (gl_InstanceID >> 10);
+    int matrix_u = (gl_InstanceID & 0x3ff) << 2;
+    return mat4(
+        texelFetch(InstanceMatrices, ivec2(matrix_u + 0, matrix_v), 0),
+        texelFetch(InstanceMatrices, ivec2(matrix_u + 1, matrix_v), 0),
+        texelFetch(InstanceMatrices, ivec2(matrix_u + 2, matrix_v), 0),
+        texelFetch(InstanceMatrices, ivec2(matrix_u + 3, matrix_v), 0));
+  }
+}
+///////////////////////////////////////////////////////////////
+// deferred / forward
+///////////////////////////////////////////////////////////////
+vertex_shader vs_rigid_gbuffer_q : iface_vgbuffer_q : lib_pbr_vtx_q {
+  vec4 pos = dequantPosition(qposition);
+  vs_common_q(pos, octDecode(qnormal), octDecode(qbinormal));
+  gl_Position = mvp * pos;
+}
+///////////////////////////////////////////////////////////////
+vertex_shader vs_rigid_gbuffer_instanced_q : iface_vgbuffer_instanced_q : lib_pbr_vtx_q : lib_vtx_instance_matrix {
+  mat4 instancemtx  = instanceMatrix();
+  mat3 instance_rot = mat3(instancemtx);
+  vec4 instanced_pos = instancemtx * dequantPosition(qposition);
+  vs_common_q(instanced_pos, instance_rot * octDecode(qnormal), instance_rot * octDecode(qbinormal));
+  ////////////////////////////////
+  int modcolor_u = (gl_InstanceID & 0xfff);
+  int modcolor_v = (gl_InstanceID >> 12);
+  frg_modcolor   = texelFetch(InstanceColors, ivec2(modcolor_u, modcolor_v), 0);
+  ////////////////////////////////
+  gl_Position = mvp * instanced_pos;
+}
+///////////////////////////////////////////////////////////////
+vertex_shader vs_skinned_gbuffer_q : iface_vgbuffer_skinned_q : skin_tools : lib_pbr_vtx_q {
+  vec4 skn_pos = vec4(SkinPosition(dequantPosition(qposition).xyz), 1);
+  vec3 skn_nrm = SkinNormal(octDecode(qnormal));
+  vec3 skn_bit = SkinNormal(octDecode(qbinormal));
+  vs_common_q(skn_pos, skn_nrm, skn_bit);
+  gl_Position = mvp * skn_pos;
+}
+///////////////////////////////////////////////////////////////
+// depth prepass
+///////////////////////////////////////////////////////////////
+vertex_shader vs_forward_depthprepass_mono_q : iface_vdprepass_q : lib_vtx_dequant {
+  vec4 hpos   = mvp * dequantPosition(qposition);
+  gl_Position = hpos;
+  frg_depth   = (hpos.z) / (hpos.w);
+}
+vertex_shader vs_forward_depthprepass_skinned_mono_q : iface_vdprepass_skinned_q : skin_tools : lib_vtx_dequant {
+  vec4 skn_pos = vec4(SkinPosition(dequantPosition(qposition).xyz), 1);
+  vec4 hpos    = mvp * skn_pos;
+  gl_Position  = hpos;
+  frg_depth    = (hpos.z) / (hpos.w);
+}
+vertex_shader vs_forward_depthprepass_instanced_mono_q : iface_vdprepass_q : lib_vtx_dequant : lib_vtx_instance_matrix {
+  vec4 hpos   = mvp * (instanceMatrix() * dequantPosition(qposition));
+  gl_Position = hpos;
+  frg_depth   = (hpos.z) / (hpos.w);
+}
+///////////////////////////////////////////////////////////////
+// picking
+///////////////////////////////////////////////////////////////
+vertex_shader vs_pick_rigid_mono_q : iface_vtx_pick_rigid_q : ub_vtx : lib_vtx_dequant {
+  vec4 pos      = dequantPosition(qposition);
+  gl_Position   = mvp * pos;
+  frg_wpos      = (m * pos).xyz;
+  frg_wnrm      = normalize(mrot * octDecode(qnormal));
+  frg_uv        = vec2(0, 0);
+  frg_pickSUBID = pickSUBID;
+}
+vertex_shader vs_pick_skinned_mono_q : iface_vtx_pick_skinned_q : skin_tools : ub_vtx : lib_vtx_dequant {
+  vec4 skn_pos  = vec4(SkinPosition(dequantPosition(qposition).xyz), 1);
+  vec3 skn_nrm  = SkinNormal(octDecode(qnormal));
+  gl_Position   = mvp * skn_pos;
+  frg_wpos      = (m * skn_pos).xyz;
+  frg_wnrm      = normalize(mrot * skn_nrm);
+  frg_uv        = uv0;
+  frg_pickSUBID = pickSUBID;
+}
+vertex_shader vs_pick_rigid_instanced_mono_q : iface_vtx_pick_rigid_q : ub_vtx : lib_vtx_dequant : lib_vtx_instance_matrix {
+  mat4 instance_matrix = instanceMatrix();
+  vec4 pos             = dequantPosition(qposition);
+  gl_Position          = mvp * instance_matrix * pos;
+  frg_wpos             = (m * pos).xyz;
+  frg_wnrm             = normalize(mrot * octDecode(qnormal));
+  frg_uv               = vec2(0, 0);
+  frg_pickSUBID.x      = gl_InstanceID;
+  frg_pickSUBID.y      = 2;
+  frg_pickSUBID.z      = 3;
+}
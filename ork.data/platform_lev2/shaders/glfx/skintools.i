@@ -32,7 +32,14 @@ libblock skin_tools {
 
     return normalize(WeightedNormal);
   }
+}
+
+///////////////////////////////////////////////////////////////
+// LitSkinned reads the float position/normal attributes,
+//  kept apart so quantized streams can use skin_tools
+///////////////////////////////////////////////////////////////
 
+libblock skin_tools_lit : skin_tools {
   struct SkinOut {
     vec3 skn_pos;
     vec3 skn_col;
@@ -0,0 +1,26 @@
+///////////////////////////////////////////////////////////////
+// quantized vertex stream decode
+//  (encoders : ork/lev2/gfx/gfxvtxquant.h)
+//
+//  POSITION  : unorm16x4, xyz relative to the cluster bounds
+//  NORMAL    : octahedral snorm16x2
+//  BINORMAL  : octahedral snorm16x2
+//  TEXCOORDn : half2
+///////////////////////////////////////////////////////////////
+uniform_set ub_vtx_dequant {
+  vec3 QuantPosScale;
+  vec3 QuantPosBias;
+}
+///////////////////////////////////////////////////////////////
+libblock lib_vtx_dequant {
+  vec4 dequantPosition(vec4 qpos) {
+    return vec4(QuantPosBias + qpos.xyz * QuantPosScale, 1.0);
+  }
+  vec3 octDecode(vec2 e) {
+    vec3 n  = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += (n.x >= 0.0) ? -t : t;
+    n.y += (n.y >= 0.0) ? -t : t;
+    return normalize(n);
+  }
+}
@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2022, Michael T. Mayers.
+// Distributed under the Boost Software License - Version 1.0 - August 17, 2003
+// see http://www.boost.org/LICENSE_1_0.txt
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/kernel/opq.h>
+#include <ork/kernel/timer.h>
+#include <ork/lev2/gfx/renderer/drawable.h>
+
+#include "physics/bullet_impl.h"
+
+using namespace ork;
+using namespace ork::ecs;
+
+///////////////////////////////////////////////////////////////////////////////
+// rigid body step + writeback timing (single vs opq) :
+//  spheres dropped onto a static floor, stepped at 60hz,
+//  poses written back to instance matrices through BulletTransformSync
+//
+//  usage : ork.example.ecs.physicsperf.exe [numbodies] [numsteps]
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct BenchResult {
+  double _stepSecs       = 0.0;
+  double _syncSecs       = 0.0;
+  int _numPublished      = 0;
+  bool _writebackMatches = true;
+};
+
+BenchResult runRigidBodyBench(bool multithreaded, int numbodies, int numsteps) {
+  BenchResult rval;
+
+  auto config     = new btDefaultCollisionConfiguration;
+  auto broadphase = new btDbvtBroadphase;
+  btCollisionDispatcher* dispatcher = nullptr;
+  btConstraintSolver* solver        = nullptr;
+  btConstraintSolverPoolMt* pool    = nullptr;
+  btDiscreteDynamicsWorld* world    = nullptr;
+  if (multithreaded) {
+    btSetTaskScheduler(opqTaskScheduler());
+    dispatcher = new btCollisionDispatcherMt(config, 40);
+    pool       = new btConstraintSolverPoolMt(opqTaskScheduler()->getNumThreads());
+    solver     = new btSequentialImpulseConstraintSolverMt;
+    world      = new btDiscreteDynamicsWorldMt(dispatcher, broadphase, pool, solver, config);
+  } else {
+    dispatcher = new btCollisionDispatcher(config);
+    solver     = new btSequentialImpulseConstraintSolver;
+    world      = new btDiscreteDynamicsWorld(dispatcher, broadphase, solver, config);
+  }
+  world->setGravity(btVector3(0, -9.8, 0));
+
+  auto floorshape = new btStaticPlaneShape(btVector3(0, 1, 0), 0);
+  auto floorbody  = new btRigidBody(0.0f, nullptr, floorshape);
+  world->addRigidBody(floorbody);
+
+  auto idata = std::make_shared<lev2::InstancedDrawableInstanceData>();
+  idata->resize(numbodies);
+
+  auto sphere = new btSphereShape(0.5f);
+  btVector3 inertia(0, 0, 0);
+  sphere->calculateLocalInertia(1.0f, inertia);
+  int side = int(ceilf(cbrtf(float(numbodies))));
+  std::vector<btRigidBody*> bodies;
+  std::vector<EntMotionState*> motionstates;
+  for (int i = 0; i < numbodies; i++) {
+    int ix = i % side;
+    int iy = (i / side) % side;
+    int iz = i / (side * side);
+    btTransform start;
+    start.setIdentity();
+    start.setOrigin(btVector3(ix * 1.1f, 2.0f + iy * 1.1f, iz * 1.1f));
+    auto motionstate          = new EntMotionState(start, nullptr);
+    motionstate->_idata       = idata;
+    motionstate->_instance_id = i;
+    btRigidBody::btRigidBodyConstructionInfo cinfo(1.0f, motionstate, sphere, inertia);
+    auto body = new btRigidBody(cinfo);
+    body->setActivationState(DISABLE_DEACTIVATION);
+    world->addRigidBody(body);
+    bodies.push_back(body);
+    motionstates.push_back(motionstate);
+  }
+
+  BulletTransformSync sync;
+  ork::Timer timer;
+  for (int istep = 0; istep < numsteps; istep++) {
+    timer.Start();
+    world->stepSimulation(1.0f / 60.0f, 1, 1.0f / 60.0f);
+    rval._stepSecs += timer.SecsSinceStart();
+    timer.Start();
+    sync.clear();
+    for (auto motionstate : motionstates)
+      sync.gather(motionstate);
+    sync.publish(multithreaded ? 256 : 0);
+    rval._syncSecs += timer.SecsSinceStart();
+    rval._numPublished += int(sync._motionstates.size());
+  }
+
+  for (int i = 0; i < numbodies; i++) {
+    const auto& xf = bodies[i]->getWorldTransform();
+    fvec3 published = idata->_worldmatrices[i].translation();
+    if ((published - btv3toorkv3(xf.getOrigin())).magnitude() > 1.0e-4f)
+      rval._writebackMatches = false;
+  }
+
+  for (size_t i = 0; i < bodies.size(); i++) {
+    world->removeRigidBody(bodies[i]);
+    delete bodies[i];
+    delete motionstates[i];
+  }
+  world->removeRigidBody(floorbody);
+  delete floorbody;
+  delete floorshape;
+  delete sphere;
+  delete world;
+  delete solver;
+  delete pool;
+  delete dispatcher;
+  delete broadphase;
+  delete config;
+  return rval;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  int numbodies = (argc > 1) ? atoi(argv[1]) : 10000;
+  int numsteps  = (argc > 2) ? atoi(argv[2]) : 120;
+  if (numbodies <= 0 or numsteps <= 0) {
+    printf("usage : %s [numbodies] [numsteps]\n", argv[0]);
+    return -1;
+  }
+
+  bool ok     = true;
+  auto report = [&](const char* label, const BenchResult& result) {
+    printf(
+        "physicsperf<%s>: bodies<%d> step<%g ms/frame> writeback<%g ms/frame> published<%d>\n",
+        label,
+        numbodies,
+        result._stepSecs * 1000.0 / double(numsteps),
+        result._syncSecs * 1000.0 / double(numsteps),
+        result._numPublished);
+    if (not result._writebackMatches)
+      printf("physicsperf<%s>: writeback does not match the body poses\n", label);
+    ok = ok and result._writebackMatches;
+  };
+
+  report("single", runRigidBodyBench(false, numbodies, numsteps));
+#if BT_THREADSAFE
+  report("opq", runRigidBodyBench(true, numbodies, numsteps));
+#else
+  printf("physicsperf<opq>: skipped, bullet not built with BT_THREADSAFE\n");
+#endif
+  return ok ? 0 : -1;
+}
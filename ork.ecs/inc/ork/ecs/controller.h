@@ -47,20 +47,33 @@ struct Controller {
 
 	///////////////////////////////////////////////////////////////////////////////
 
-	using evq_t = std::deque<svar32_t>;
 	using delayed_opq_t = std::multimap<float, void_lambda_t>;
   using delayed_opv_t = std::vector<void_lambda_t>;
 
-	struct Event {
-	  EventID _eventID;
-	  svar160_t _payload;
+	enum struct CommandKind : uint32_t {
+	  EVENT = 0,
+	  REQUEST,
 	};
-	struct Request {
-	  RequestID _requestID;
+
+	///////////////////////////////////////////////////////////////////////////////
+	// one slot of a producer command ring
+	//  events and requests share the slot layout, the payload lives inline
+	//  _sequence orders commands across producer threads
+	///////////////////////////////////////////////////////////////////////////////
+
+	struct Command {
+	  CommandKind _kind = CommandKind::EVENT;
+	  union {
+	    EventID _eventID = EventID(0);
+	    RequestID _requestID;
+	  };
+	  uint64_t _sequence = 0;
 	  svar160_t _payload;
 	};
-	using event_ptr_t = std::shared_ptr<Event>;
-	using request_ptr_t = std::shared_ptr<Request>;
+	using Event = Command;
+	using Request = Command;
+	using command_batch_t = std::vector<const Command*>;
+	using commandbuffer_ptr_t = std::shared_ptr<impl::CommandBuffer>;
 
 	struct Transaction{
 		std::vector<svar256_t> _items;
@@ -72,6 +85,7 @@ struct Controller {
 		TraceWriter(Controller* c, file::Path path);
 		~TraceWriter();
 		FILE* _output_file = nullptr;
+		void _traceCommand(const Command& command);
 		void _traceEvent(const Event& event);
 		void _traceRequest(const Request& request);
 		std::string _traceVar128(const svar160_t& var);
@@ -163,13 +177,16 @@ private:
 	friend struct TraceReader;
 	friend struct LuaContext;
 
-	void _enqueueEvent(event_ptr_t event);
-	void _enqueueRequest(request_ptr_t request);
+	Event& _beginEvent(EventID id);
+	Request& _beginRequest(RequestID id);
+	void _commitCommand(Command& command);
 
   void _mutateObject(std::function<void(id2obj_map_t&)> operation);
 
   void _pollDelayedOps(Simulation* unlocked_sim, delayed_opv_t& opvect);
-  bool _pollEvents(Simulation* unlocked_sim, evq_t& evect);
+  bool _pollEvents(Simulation* unlocked_sim, command_batch_t& out_commands);
+  void _retireEvents();
+  void _discardEvents();
 
 	///////////////////////////////////////////////////////////////////////////////
 
@@ -185,7 +202,7 @@ private:
 	scenedata_constptr_t _scenedata;
 	
 
-	LockedResource<evq_t> _eventQueue;
+	commandbuffer_ptr_t _commands;
 
 	std::atomic<uint64_t> _objectIdCounter;
 	LockedResource<id2obj_map_t> _id2objmap;
@@ -200,7 +217,6 @@ private:
 	std::vector<std::shared_ptr<std::string>> _retained_strings;
 	
 	tsl::robin_map<uint64_t,comp_ref_t> _component_cache;
-  evq_t _temp_evq;
 
 };
 
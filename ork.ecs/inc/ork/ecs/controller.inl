@@ -21,20 +21,21 @@ template <typename T> sys_ref_t Controller::findSystem() {
   // notify sim to update reference
   //////////////////////////////////////////////////////
 
-  auto simevent = std::make_shared<Event>();
-  simevent->_eventID   = EventID::FIND_SYSTEM;
-  auto& FSYS          = simevent->_payload.make<impl::_FindSystem>();
+  auto sysref = SystemRef{._sysID = ID};
 
-  FSYS._sysref = SystemRef{._sysID = ID};
+  auto& simevent = _beginEvent(EventID::FIND_SYSTEM);
+  auto& FSYS     = simevent._payload.make<impl::_FindSystem>();
+
+  FSYS._sysref = sysref;
   FSYS._syskey = T::SystemType;
 
-  _enqueueEvent(simevent);
+  _commitCommand(simevent);
 
   //////////////////////////////////////////////////////
   // return opaque handle
   //////////////////////////////////////////////////////
 
-  return FSYS._sysref;
+  return sysref;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -47,22 +48,23 @@ template <typename T> comp_ref_t Controller::findEntityComponent(ent_ref_t ent)
   // notify sim to update reference
   //////////////////////////////////////////////////////
 
-  auto simevent = std::make_shared<Event>();
-  simevent->_eventID   = EventID::FIND_COMPONENT;
-  auto& FCOMP          = simevent->_payload.make<impl::_FindComponent>();
+  auto compref = ComponentRef({._compID=ID});
+
+  auto& simevent = _beginEvent(EventID::FIND_COMPONENT);
+  auto& FCOMP    = simevent._payload.make<impl::_FindComponent>();
 
   FCOMP._entref = ent;
   FCOMP._compclazz = T::componentClass();
-  FCOMP._compref = ComponentRef({._compID=ID});
+  FCOMP._compref = compref;
 
-  _enqueueEvent(simevent);
+  _commitCommand(simevent);
 
   //////////////////////////////////////////////////////
   // return opaque handle
   //////////////////////////////////////////////////////
 
 
-  return FCOMP._compref;
+  return compref;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
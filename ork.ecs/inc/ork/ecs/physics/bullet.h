@@ -105,6 +105,7 @@ struct BulletSystemData : public SystemData {
   fvec3 _lingravity;
   fvec3 _expgravity;
   bool _test_deactivation = false;
+  bool _multithreaded = false; // btDiscreteDynamicsWorldMt on opq workers
 
 public:
   BulletSystemData();
@@ -299,7 +299,7 @@ private:
 
   //////////////////////////////////////////////////////////
 
-  Controller::evq_t _current_events;
+  Controller::command_batch_t _current_commands;
 
   bool _needsGpuInit = false;
   bool _needsGpuExit = false;
@@ -258,6 +258,8 @@ namespace impl {
   struct _ComponentEvent;
   struct _ComponentRequest;
   struct _ComponentResponse;
+  struct CommandRing;
+  struct CommandBuffer;
 
   using sys_response_ptr_t = std::shared_ptr<_SystemResponse>;
   using comp_response_ptr_t = std::shared_ptr<_ComponentResponse>;
@@ -0,0 +1,273 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2022, Michael T. Mayers.
+// Distributed under the Boost Software License - Version 1.0 - August 17, 2003
+// see http://www.boost.org/LICENSE_1_0.txt
+////////////////////////////////////////////////////////////////
+
+#include "command_buffer.h"
+#include <unordered_set>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace ork::ecs::impl {
+///////////////////////////////////////////////////////////////////////////////
+
+CommandRing::CommandRing() {
+  _tailBlock = new Block;
+  _peekBlock = _tailBlock;
+  _headBlock = _tailBlock;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+CommandRing::~CommandRing() {
+  auto block = _headBlock;
+  while (block) {
+    auto next = block->_next.load();
+    delete block;
+    block = next;
+  }
+  delete _spare.load();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// producer: the returned slot is owned by the caller until publish()
+///////////////////////////////////////////////////////////////////////////////
+
+Command& CommandRing::reserve() {
+  OrkAssert(not _reserved); // one command in flight per producer thread
+  if (_tailIndex == kBlockSize) {
+    Block* block = _spare.exchange(nullptr, std::memory_order_acquire);
+    if (block == nullptr)
+      block = new Block;
+    // linked before the publish of its first slot, which the consumer acquires
+    _tailBlock->_next.store(block, std::memory_order_release);
+    _tailBlock = block;
+    _tailIndex = 0;
+  }
+  _reserved = true;
+  return _tailBlock->_slots[_tailIndex];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CommandRing::publish() {
+  OrkAssert(_reserved);
+  _reserved = false;
+  _tailIndex++;
+  _published.store(_published.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// consumer
+///////////////////////////////////////////////////////////////////////////////
+
+void CommandRing::snapshot() {
+  _peekLimit = _published.load(std::memory_order_acquire);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const Command* CommandRing::peek() {
+  if (_peekCount == _peekLimit)
+    return nullptr;
+  if (_peekIndex == kBlockSize) {
+    _peekBlock = _peekBlock->_next.load(std::memory_order_acquire);
+    _peekIndex = 0;
+  }
+  return &_peekBlock->_slots[_peekIndex];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CommandRing::advance() {
+  OrkAssert(_peekCount < _peekLimit);
+  _peekIndex++;
+  _peekCount++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// drop payload references of polled slots,
+//  hand drained blocks back to the producer
+///////////////////////////////////////////////////////////////////////////////
+
+void CommandRing::retire() {
+  while (_retireCount < _peekCount) {
+    if (_headIndex == kBlockSize) {
+      Block* drained = _headBlock;
+      _headBlock     = drained->_next.load(std::memory_order_acquire);
+      _headIndex     = 0;
+      drained->_next.store(nullptr, std::memory_order_relaxed);
+      Block* expected = nullptr;
+      if (not _spare.compare_exchange_strong(expected, drained, std::memory_order_release))
+        delete drained;
+    }
+    _headBlock->_slots[_headIndex]._payload._destroy();
+    _headIndex++;
+    _retireCount++;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<uint64_t> _commandBufferSerial = 1;
+
+///////////////////////////////////////////////////////////////////////////////
+// serials of live buffers, so thread exit and cache purges never
+//  touch a destroyed buffer
+///////////////////////////////////////////////////////////////////////////////
+
+static std::mutex& _liveBuffersMutex() {
+  static std::mutex _mutex;
+  return _mutex;
+}
+static std::unordered_set<uint64_t>& _liveBuffers() {
+  static std::unordered_set<uint64_t> _serials;
+  return _serials;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// per thread ring cache, keyed on the buffer serial.
+//  on thread exit the rings go back to their (live) buffers
+///////////////////////////////////////////////////////////////////////////////
+
+struct ProducerRingCache {
+  struct Item {
+    uint64_t _serial;
+    CommandBuffer* _buffer;
+    CommandRing* _ring;
+  };
+  ~ProducerRingCache() {
+    std::lock_guard<std::mutex> lock(_liveBuffersMutex());
+    for (const auto& item : _items) {
+      if (_liveBuffers().count(item._serial))
+        item._buffer->releaseRing(item._ring);
+    }
+  }
+  // drop entries of destroyed buffers
+  void purge() {
+    std::lock_guard<std::mutex> lock(_liveBuffersMutex());
+    const auto& live = _liveBuffers();
+    std::erase_if(_items, [&live](const Item& item) { return live.count(item._serial) == 0; });
+  }
+  std::vector<Item> _items;
+};
+
+static thread_local ProducerRingCache _tl_rings;
+
+///////////////////////////////////////////////////////////////////////////////
+
+CommandBuffer::CommandBuffer() {
+  _serial = _commandBufferSerial.fetch_add(1);
+  for (auto& ring : _rings)
+    ring.store(nullptr);
+  std::lock_guard<std::mutex> lock(_liveBuffersMutex());
+  _liveBuffers().insert(_serial);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+CommandBuffer::~CommandBuffer() {
+  {
+    std::lock_guard<std::mutex> lock(_liveBuffersMutex());
+    _liveBuffers().erase(_serial);
+  }
+  int numrings = _numRings.load();
+  for (int i = 0; i < numrings; i++)
+    delete _rings[i].load();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// only the first command from a given thread takes the registration lock,
+//  it reuses the ring of an exited producer if there is one
+///////////////////////////////////////////////////////////////////////////////
+
+CommandRing* CommandBuffer::producerRing() {
+  for (const auto& item : _tl_rings._items) {
+    if (item._serial == _serial)
+      return item._ring;
+  }
+  _tl_rings.purge();
+  CommandRing* ring = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(_registrationMutex);
+    if (_freeRings.size()) {
+      ring = _freeRings.back();
+      _freeRings.pop_back();
+    } else {
+      int index = _numRings.load(std::memory_order_relaxed);
+      OrkAssert(index < kMaxProducers); // concurrently live producer threads
+      ring = new CommandRing;
+      _rings[index].store(ring, std::memory_order_relaxed);
+      _numRings.store(index + 1, std::memory_order_release);
+    }
+  }
+  _tl_rings._items.push_back(ProducerRingCache::Item{_serial, this, ring});
+  return ring;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// the ring stays registered (the consumer still drains what it holds),
+//  the registration lock hands its producer side to the next thread.
+//  a thread that exits between begin() and commit() leaves its slot
+//  reserved, that ring is not reused.
+///////////////////////////////////////////////////////////////////////////////
+
+void CommandBuffer::releaseRing(CommandRing* ring) {
+  if (ring->_reserved)
+    return;
+  std::lock_guard<std::mutex> lock(_registrationMutex);
+  _freeRings.push_back(ring);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t CommandBuffer::numCachedRings() {
+  return _tl_rings._items.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Command& CommandBuffer::begin(CommandKind kind) {
+  auto& command = producerRing()->reserve();
+  command._kind = kind;
+  return command;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// the reservation goes up before the sequence is taken, so a poll that
+//  sees a later sequence already published also sees this reservation
+//  (or this command's publish, which comes before the reservation drops)
+///////////////////////////////////////////////////////////////////////////////
+
+void CommandBuffer::commit(Command& command) {
+  auto ring = producerRing();
+  ring->_reservedSequence.store(_sequence.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+  command._sequence = _sequence.fetch_add(1, std::memory_order_seq_cst);
+  ring->publish();
+  ring->_reservedSequence.store(CommandRing::kNoSequence, std::memory_order_seq_cst);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// anything committed before this call is dropped by the next poll
+///////////////////////////////////////////////////////////////////////////////
+
+void CommandBuffer::discardPending() {
+  uint64_t below   = _sequence.load(std::memory_order_relaxed);
+  uint64_t current = _discardBelow.load(std::memory_order_relaxed);
+  while (current < below and not _discardBelow.compare_exchange_weak(current, below, std::memory_order_release)) {
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CommandBuffer::retire() {
+  int numrings = _numRings.load(std::memory_order_acquire);
+  for (int i = 0; i < numrings; i++) {
+    _rings[i].load(std::memory_order_relaxed)->retire();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::ecs::impl
+///////////////////////////////////////////////////////////////////////////////
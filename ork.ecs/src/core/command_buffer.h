@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2022, Michael T. Mayers.
+// Distributed under the Boost Software License - Version 1.0 - August 17, 2003
+// see http://www.boost.org/LICENSE_1_0.txt
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ork/ecs/controller.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// ECS Controller -> Simulation command buffer
+//
+//  every producer thread gets its own single producer / single consumer ring,
+//   so enqueueing a command takes no lock and allocates nothing
+//   (ring storage grows in fixed size blocks, retired blocks are recycled)
+//   when a producer thread exits, its ring is handed to the next new producer
+//
+//  commands are constructed in place in the ring slot:
+//    auto& cmd = buffer.begin(kind);   // reserve a slot
+//    cmd._payload.make<...>();         // fill it in
+//    buffer.commit(cmd);               // stamp sequence, publish to consumer
+//
+//  the simulation (the only consumer) polls once per tick,
+//   merging all rings by sequence number, dispatches the batch
+//   directly from the ring slots, then retires it.
+//   a sequence number is taken before its command is published, so each
+//   ring advertises a lower bound of the sequence it is committing, and
+//   the poll holds back everything at or above the lowest one.
+//   (consumer calls are serialized by the Controller's simulation lock)
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::ecs::impl {
+
+using Command     = Controller::Command;
+using CommandKind = Controller::CommandKind;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct CommandRing {
+
+  static constexpr size_t kBlockSize    = 128;
+  static constexpr uint64_t kNoSequence = ~uint64_t(0);
+
+  struct Block {
+    std::array<Command, kBlockSize> _slots;
+    std::atomic<Block*> _next = nullptr;
+  };
+
+  CommandRing();
+  ~CommandRing();
+
+  ////////////////////////////////////
+  // producer side
+  ////////////////////////////////////
+
+  Command& reserve();
+  void publish();
+
+  ////////////////////////////////////
+  // consumer side
+  ////////////////////////////////////
+
+  void snapshot();              // latch the published count for this poll
+  const Command* peek();        // next unpolled command below the snapshot
+  void advance();               // step over the peeked command
+  void retire();                // release everything polled so far
+
+  ////////////////////////////////////
+
+  Block* _tailBlock   = nullptr;
+  size_t _tailIndex   = 0;
+  bool _reserved      = false;
+  std::atomic<size_t> _published = 0;
+  std::atomic<uint64_t> _reservedSequence = kNoSequence; // lower bound of the sequence being committed
+
+  Block* _peekBlock   = nullptr;
+  size_t _peekIndex   = 0;
+  size_t _peekCount   = 0;
+  size_t _peekLimit   = 0;
+
+  Block* _headBlock   = nullptr;
+  size_t _headIndex   = 0;
+  size_t _retireCount = 0;
+
+  std::atomic<Block*> _spare = nullptr;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct CommandBuffer {
+
+  static constexpr int kMaxProducers = 64;
+
+  CommandBuffer();
+  ~CommandBuffer();
+
+  Command& begin(CommandKind kind);
+  void commit(Command& command);
+  void discardPending();
+
+  template <typename blocked_pred_t> //
+  bool poll(const blocked_pred_t& is_blocked, Controller::command_batch_t& out_commands);
+  void retire();
+
+  CommandRing* producerRing();
+  void releaseRing(CommandRing* ring); // producer thread exit
+  static size_t numCachedRings();      // calling thread's ring cache entries
+
+  uint64_t _serial = 0;
+  std::atomic<uint64_t> _sequence    = 0;
+  std::atomic<uint64_t> _discardBelow = 0;
+  std::array<std::atomic<CommandRing*>, kMaxProducers> _rings;
+  std::atomic<int> _numRings = 0;
+  std::mutex _registrationMutex;
+  std::vector<CommandRing*> _freeRings; // registered, no producer thread (under _registrationMutex)
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// gather commands in sequence order until is_blocked says stop
+//  returns true if stopped at a blocking command, which stays queued
+//  (along with everything after it) for the next poll
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename blocked_pred_t> //
+bool CommandBuffer::poll(const blocked_pred_t& is_blocked, Controller::command_batch_t& out_commands) {
+  int numrings          = _numRings.load(std::memory_order_acquire);
+  uint64_t discardbelow = _discardBelow.load(std::memory_order_acquire);
+  ////////////////////////////////////
+  // every sequence below the watermark is either published (and so
+  //  caught by the snapshot taken after it) or in a ring's reservation,
+  //  which pulls the watermark down to it. order matters here :
+  //  sequence, then reservations, then snapshots.
+  ////////////////////////////////////
+  uint64_t watermark = _sequence.load(std::memory_order_seq_cst);
+  for (int i = 0; i < numrings; i++) {
+    auto ring = _rings[i].load(std::memory_order_acquire);
+    watermark = std::min(watermark, ring->_reservedSequence.load(std::memory_order_seq_cst));
+  }
+  for (int i = 0; i < numrings; i++) {
+    _rings[i].load(std::memory_order_relaxed)->snapshot();
+  }
+  while (true) {
+    CommandRing* next_ring  = nullptr;
+    const Command* next_cmd = nullptr;
+    for (int i = 0; i < numrings; i++) {
+      auto ring = _rings[i].load(std::memory_order_relaxed);
+      auto cmd  = ring->peek();
+      while (cmd and cmd->_sequence < discardbelow) {
+        ring->advance();
+        cmd = ring->peek();
+      }
+      if (cmd and (next_cmd == nullptr or cmd->_sequence < next_cmd->_sequence)) {
+        next_ring = ring;
+        next_cmd  = cmd;
+      }
+    }
+    if (next_cmd == nullptr or next_cmd->_sequence >= watermark)
+      return false; // anything at or above the watermark goes next poll
+    if (is_blocked(*next_cmd))
+      return true;
+    out_commands.push_back(next_cmd);
+    next_ring->advance();
+  }
+}
+
+} // namespace ork::ecs::impl
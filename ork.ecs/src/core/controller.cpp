@@ -17,6 +17,7 @@
 #include <ork/lev2/ui/event.h>
 
 #include "message_private.h"
+#include "command_buffer.h"
 #include <ork/util/logger.h>
 #include <ork/python/pycodec.h>
 
@@ -39,6 +40,7 @@ Controller::Controller(stringpoolctx_ptr_t strpoolctx)
 
   ork::opq::assertOnQueue(opq::mainSerialQueue());
   _objectIdCounter.store(0);
+  _commands = std::make_shared<impl::CommandBuffer>();
 }
 
 void Controller::forceRetain(const svar64_t& item) {
@@ -102,7 +104,7 @@ void Controller::gpuExit(lev2::Context* ctx) {
 void Controller::updateExit() {
   auto op = [this] {
     _delopq.atomicOp([=](delayed_opq_t& unlocked) { unlocked.clear(); });
-    _eventQueue.atomicOp([&](Controller::evq_t& unlocked) { unlocked.clear(); });
+    _discardEvents();
     _simulation.atomicOp([](simulation_ptr_t& unlocked) { unlocked->_serviceEventQueues(); });
     _simulation.atomicOp([](simulation_ptr_t& unlocked) { unlocked->updateExit(); });
   };
@@ -130,14 +132,36 @@ void Controller::renderWithStandardCompositorFrame(lev2::standardcompositorframe
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Controller::_enqueueEvent(event_ptr_t event) {
-  _eventQueue.atomicOp([&](evq_t& unlocked) { unlocked.push_back(event); });
+// commands are built in place in the calling thread's ring slot,
+//  nothing is visible to the simulation until _commitCommand.
+//  results handed back to the caller must be copied out before the commit,
+//  once committed the slot belongs to the simulation.
+///////////////////////////////////////////////////////////////////////////////
+
+Controller::Event& Controller::_beginEvent(EventID id) {
+  auto& event    = _commands->begin(CommandKind::EVENT);
+  event._eventID = id;
+  return event;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Controller::Request& Controller::_beginRequest(RequestID id) {
+  auto& request      = _commands->begin(CommandKind::REQUEST);
+  request._requestID = id;
+  return request;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Controller::_commitCommand(Command& command) {
+  _commands->commit(command);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Controller::_enqueueRequest(request_ptr_t request) {
-  _eventQueue.atomicOp([&](evq_t& unlocked) { unlocked.push_back(request); });
+void Controller::_discardEvents() {
+  _commands->discardPending();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -184,68 +208,38 @@ void Controller::_pollDelayedOps(Simulation* unlocked_sim, delayed_opv_t& opvect
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool Controller::_pollEvents(Simulation* unlocked_sim, evq_t& out_events) {
-
-  bool in_barrier = false;
-
-  this->_eventQueue.atomicOp([&](Controller::evq_t& unlocked) {
-    bool events_finished = false;
-
-    int eventindex = 0;
-
-    while (not events_finished) {
-      events_finished = true;
-      
-      auto it         = unlocked.begin();
-      if(it==unlocked.end())
-        continue; // break out of while loop
-
-      ////////////////////////////////////
-      // first respect barriers
-      ////////////////////////////////////
-
-      auto& evreq = *it;
+bool Controller::_pollEvents(Simulation* unlocked_sim, command_batch_t& out_commands) {
 
-      if (auto as_ev = evreq.tryAs<Controller::event_ptr_t>()) {
+  ////////////////////////////////////
+  // barriers hold back themselves and
+  //  everything sequenced after them
+  ////////////////////////////////////
 
-        auto& payload = as_ev.value()->_payload;
-
-        if (auto as_barrier = payload.tryAs<impl::entbarrier_ptr_t>()) {
-          auto entref = as_barrier.value()->_entref;
-          auto ent    = unlocked_sim->_findEntityFromRef(entref);
-          if (ent == nullptr) {
-            in_barrier      = true;
-            events_finished = true;
-            continue;
-          } else {
-            // OrkAssert(false);
-          }
-
-        } else if (auto as_barrier = payload.tryAs<impl::transportbarrier_ptr_t>()) {
-          auto desired_state = as_barrier.value()->_waitForState;
-          // barrier condition exists so long as
-          //  the actual transport state does not match the desired transport state
-          in_barrier = (desired_state != unlocked_sim->_transportState);
-          if (in_barrier) {
-            events_finished = true;
-            continue;
-          }
-        }
-      }
+  auto is_blocked = [unlocked_sim](const Command& command) -> bool {
+    if (command._kind != CommandKind::EVENT)
+      return false;
+    auto& payload = command._payload;
+    if (auto as_barrier = payload.tryAs<impl::entbarrier_ptr_t>()) {
+      auto entref = as_barrier.value()->_entref;
+      return unlocked_sim->_findEntityFromRef(entref) == nullptr;
+    } else if (auto as_barrier = payload.tryAs<impl::transportbarrier_ptr_t>()) {
+      // barrier condition exists so long as
+      //  the actual transport state does not match the desired transport state
+      auto desired_state = as_barrier.value()->_waitForState;
+      return (desired_state != unlocked_sim->_transportState);
+    }
+    return false;
+  };
 
-      ////////////////////////////////////
-      // then respect timestamps
-      ////////////////////////////////////
+  return _commands->poll(is_blocked, out_commands);
+}
 
-      out_events.push_back(evreq);
-      unlocked.erase(it);
-      events_finished = false; // try again
+///////////////////////////////////////////////////////////////////////////////
+// release the slots of the last polled batch back to their producers
+///////////////////////////////////////////////////////////////////////////////
 
-      ////////////////////////////////////
-      eventindex++;
-    }
-  });
-  return in_barrier;
+void Controller::_retireEvents() {
+  _commands->retire();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -285,13 +279,11 @@ ent_ref_t Controller::spawnNamedDynamicEntity(const SpawnNamedDynamic& SND) {
 ///////////////////////////////////////////////////////////////////////////////
 
 ent_ref_t Controller::spawnAnonDynamicEntity(sad_ptr_t SAD) {
-  auto req = std::make_shared<Request>();
-
-  req->_requestID = RequestID::SPAWN_DYNAMIC_ANON;
+  auto& req = _beginRequest(RequestID::SPAWN_DYNAMIC_ANON);
 
   uint64_t objID = _objectIdCounter.fetch_add(1);
 
-  auto& IMPL = req->_payload.make<impl::_SpawnAnonDynamic>();
+  auto& IMPL = req._payload.make<impl::_SpawnAnonDynamic>();
   IMPL._SAD  = SAD;
 
   if (SAD->_userspawndata) {
@@ -303,39 +295,37 @@ ent_ref_t Controller::spawnAnonDynamicEntity(sad_ptr_t SAD) {
 
   OrkAssert(IMPL._spawn_rec);
 
-  ent_ref_t eref;
   IMPL._entref._entID = objID;
+  ent_ref_t eref      = IMPL._entref;
 
-  _enqueueRequest(req);
+  _commitCommand(req);
 
   // printf( "SPAWNANONDYNAMIC<%zu>\n", objID );
 
-  return IMPL._entref;
+  return eref;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Controller::despawnEntity(const ent_ref_t& EREF) {
-  auto simevent      = std::make_shared<Event>();
-  simevent->_eventID = EventID::DESPAWN;
-  auto& DEV          = simevent->_payload.make<impl::_Despawn>();
+  auto& simevent = _beginEvent(EventID::DESPAWN);
+  auto& DEV      = simevent._payload.make<impl::_Despawn>();
 
   DEV._entref = EREF;
 
   // printf( "DESPAWN<%zu>\n", EREF._entID );
 
-  _enqueueEvent(simevent);
+  _commitCommand(simevent);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Controller::entBarrier(ent_ref_t EREF) {
-  auto simevent      = std::make_shared<Event>();
-  simevent->_eventID = EventID::ENTITY_BARRIER;
-  auto BEV           = std::make_shared<impl::_EntBarrier>();
-  BEV->_entref       = EREF;
-  simevent->_payload.make<impl::entbarrier_ptr_t>(BEV);
-  _enqueueEvent(simevent);
+  auto BEV       = std::make_shared<impl::_EntBarrier>();
+  BEV->_entref   = EREF;
+  auto& simevent = _beginEvent(EventID::ENTITY_BARRIER);
+  simevent._payload.make<impl::entbarrier_ptr_t>(BEV);
+  _commitCommand(simevent);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -350,7 +340,7 @@ void Controller::entBarrier(ent_ref_t EREF) {
 // auto BEV = std::make_shared<impl::_EntBarrier>();
 // BEV->_entref = EREF;
 // simevent->_payload.make<impl::entbarrier_ptr_t>(BEV);
-//_enqueueEvent(simevent);
+//_commitCommand(simevent);
 //_currentXact = nullptr;
 
 //}
@@ -359,35 +349,33 @@ void Controller::entBarrier(ent_ref_t EREF) {
 
 void Controller::systemNotify(sys_ref_t sys, token_t evID, svar64_t data) {
 
-  auto simevent      = std::make_shared<Event>();
-  simevent->_eventID = EventID::SYSTEM_EVENT;
-  auto& SEV          = simevent->_payload.make<impl::_SystemEvent>();
+  auto& simevent = _beginEvent(EventID::SYSTEM_EVENT);
+  auto& SEV      = simevent._payload.make<impl::_SystemEvent>();
 
   SEV._sysref    = sys;
   SEV._eventID   = evID;
   SEV._eventData = data;
 
-  _enqueueEvent(simevent);
+  _commitCommand(simevent);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 response_ref_t Controller::systemRequest(sys_ref_t sys, token_t reqID, svar64_t data) {
-  auto simrequest        = std::make_shared<Request>();
-  simrequest->_requestID = RequestID::SYSTEM_REQUEST;
+  auto& simrequest = _beginRequest(RequestID::SYSTEM_REQUEST);
 
   uint64_t objID = _objectIdCounter.fetch_add(1);
 
   auto rref = ResponseRef{._responseID = objID};
 
-  auto& SRQ = simrequest->_payload.make<impl::_SystemRequest>();
+  auto& SRQ = simrequest._payload.make<impl::_SystemRequest>();
 
   SRQ._sysref    = sys;
   SRQ._requestID = reqID;
   SRQ._eventData = data;
   SRQ._respref   = rref;
 
-  _enqueueRequest(simrequest);
+  _commitCommand(simrequest);
 
   return rref;
 }
@@ -396,24 +384,22 @@ response_ref_t Controller::systemRequest(sys_ref_t sys, token_t reqID, svar64_t
 
 void Controller::componentNotify(comp_ref_t comp, token_t evID, svar64_t data) {
 
-  auto simevent      = std::make_shared<Event>();
-  simevent->_eventID = EventID::COMPONENT_EVENT;
-  auto& CEV          = simevent->_payload.make<impl::_ComponentEvent>();
+  auto& simevent = _beginEvent(EventID::COMPONENT_EVENT);
+  auto& CEV      = simevent._payload.make<impl::_ComponentEvent>();
 
   CEV._compref   = comp;
   CEV._eventID   = evID;
   CEV._eventData = data;
 
-  _enqueueEvent(simevent);
+  _commitCommand(simevent);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 response_ref_t Controller::componentRequest(comp_ref_t comp, token_t reqID, svar64_t data) {
 
-  auto simrequest        = std::make_shared<Request>();
-  simrequest->_requestID = RequestID::COMPONENT_REQUEST;
-  auto& CRQ              = simrequest->_payload.make<impl::_ComponentRequest>();
+  auto& simrequest = _beginRequest(RequestID::COMPONENT_REQUEST);
+  auto& CRQ        = simrequest._payload.make<impl::_ComponentRequest>();
 
   uint64_t objID = _objectIdCounter.fetch_add(1);
 
@@ -424,7 +410,7 @@ response_ref_t Controller::componentRequest(comp_ref_t comp, token_t reqID, svar
   CRQ._eventData = data;
   CRQ._respref   = rref;
 
-  _enqueueRequest(simrequest);
+  _commitCommand(simrequest);
 
   return rref;
 }
@@ -433,9 +419,8 @@ response_ref_t Controller::componentRequest(comp_ref_t comp, token_t reqID, svar
 
 response_ref_t Controller::simulationRequest(token_t reqID, svar64_t data) {
 
-  auto simrequest        = std::make_shared<Request>();
-  simrequest->_requestID = RequestID::SIMULATION_REQUEST;
-  auto& SRQ              = simrequest->_payload.make<impl::_SimulationRequest>();
+  auto& simrequest = _beginRequest(RequestID::SIMULATION_REQUEST);
+  auto& SRQ        = simrequest._payload.make<impl::_SimulationRequest>();
 
   uint64_t objID = _objectIdCounter.fetch_add(1);
 
@@ -445,7 +430,7 @@ response_ref_t Controller::simulationRequest(token_t reqID, svar64_t data) {
   SRQ._eventData = data;
   SRQ._respref   = rref;
 
-  _enqueueRequest(simrequest);
+  _commitCommand(simrequest);
 
   return rref;
 }
@@ -503,12 +488,11 @@ void Controller::startSimulation() {
     });
   };
   opq::updateSerialQueue()->enqueue(op);
-  auto simevent      = std::make_shared<Event>();
-  simevent->_eventID = EventID::TRANSPORT_BARRIER;
   auto TEV           = std::make_shared<impl::_TransportBarrier>();
   TEV->_waitForState = ESimulationTransport::ACTIVATED;
-  simevent->_payload.make<impl::transportbarrier_ptr_t>(TEV);
-  _enqueueEvent(simevent);
+  auto& simevent     = _beginEvent(EventID::TRANSPORT_BARRIER);
+  simevent._payload.make<impl::transportbarrier_ptr_t>(TEV);
+  _commitCommand(simevent);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -517,17 +501,16 @@ void Controller::stopSimulation() {
   // ork::opq::assertOnQueue2(opq::mainSerialQueue());
   logchan_controller->log("STOPPING SIMULATION");
   _delopq.atomicOp([=](delayed_opq_t& unlocked) { unlocked.clear(); });
-  _eventQueue.atomicOp([&](Controller::evq_t& unlocked) { unlocked.clear(); });
+  _discardEvents();
   _simulation.atomicOp([](simulation_ptr_t& unlocked) {
     unlocked->SetSimulationMode(ESimulationMode::EDIT);
     unlocked->_serviceEventQueues();
   });
-  auto simevent      = std::make_shared<Event>();
-  simevent->_eventID = EventID::TRANSPORT_BARRIER;
   auto TEV           = std::make_shared<impl::_TransportBarrier>();
   TEV->_waitForState = ESimulationTransport::TERMINATED;
-  simevent->_payload.make<impl::transportbarrier_ptr_t>(TEV);
-  _enqueueEvent(simevent);
+  auto& simevent     = _beginEvent(EventID::TRANSPORT_BARRIER);
+  simevent._payload.make<impl::transportbarrier_ptr_t>(TEV);
+  _commitCommand(simevent);
 }
 void Controller::endSimulation() {
   updateExit();
@@ -565,23 +548,22 @@ sys_ref_t Controller::findSystemWithClassName(std::string clazzname) {
   // notify sim to update reference
   //////////////////////////////////////////////////////
 
-  auto simevent      = std::make_shared<Event>();
-  simevent->_eventID = EventID::FIND_SYSTEM;
-  auto& FSYS         = simevent->_payload.make<impl::_FindSystem>();
-
   auto retain_str = std::make_shared<std::string>(clazzname);
   _retained_strings.push_back(retain_str);
 
-  FSYS._sysref = SystemRef{._sysID = ID};
-  FSYS._syskey = *retain_str;
+  auto sysref = SystemRef{._sysID = ID};
 
-  _enqueueEvent(simevent);
+  auto& simevent = _beginEvent(EventID::FIND_SYSTEM);
+  auto& FSYS     = simevent._payload.make<impl::_FindSystem>();
+  FSYS._sysref   = sysref;
+  FSYS._syskey   = *retain_str;
+  _commitCommand(simevent);
 
   //////////////////////////////////////////////////////
   // return opaque handle
   //////////////////////////////////////////////////////
 
-  return FSYS._sysref;
+  return sysref;
 }
 
 comp_ref_t Controller::findComponentWithClassName(ent_ref_t ent, std::string clazzname) {
@@ -603,25 +585,24 @@ comp_ref_t Controller::findComponentWithClassName(ent_ref_t ent, std::string cla
   // notify sim to update reference
   //////////////////////////////////////////////////////
 
-  auto simevent      = std::make_shared<Event>();
-  simevent->_eventID = EventID::FIND_COMPONENT;
-  auto& FCOMP        = simevent->_payload.make<impl::_FindComponent>();
-
   auto clazz = ::ork::rtti::Class::FindClass(clazzname);
   // printf( "find class<%s> -> %p\n", clazzname.c_str(), (void*) clazz );
+  auto compref = ComponentRef({._compID = ID});
+
+  auto& simevent   = _beginEvent(EventID::FIND_COMPONENT);
+  auto& FCOMP      = simevent._payload.make<impl::_FindComponent>();
   FCOMP._entref    = ent;
   FCOMP._compclazz = clazz;
-  FCOMP._compref   = ComponentRef({._compID = ID});
-
-  _enqueueEvent(simevent);
+  FCOMP._compref   = compref;
+  _commitCommand(simevent);
 
   //////////////////////////////////////////////////////
   // write to cache and return opaque handle
   //////////////////////////////////////////////////////
 
-  _component_cache[cache_key] = FCOMP._compref;
+  _component_cache[cache_key] = compref;
 
-  return FCOMP._compref;
+  return compref;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
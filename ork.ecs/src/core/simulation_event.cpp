@@ -35,36 +35,37 @@ void Simulation::_serviceEventQueues() {
   }
 
   //////////////////////////////////////////////////////////
-  // poll current events from controller
+  // poll current commands from controller
+  //  (batched once per tick, dispatched in place from the
+  //   producer rings, retired after dispatch)
   //////////////////////////////////////////////////////////
 
-  _current_events.clear();
-  bool in_barrier = _controller->_pollEvents(this,_current_events);
+  _current_commands.clear();
+  _controller->_pollEvents(this,_current_commands);
 
   //////////////////////////////////////////////////////////
-  // process events
+  // process commands
   //////////////////////////////////////////////////////////
-  if( not in_barrier ) {
-    for (const auto& e : _current_events) {
-      bool do_continue = true;
-      if( auto as_ev = e.tryAs<Controller::event_ptr_t>() ){
-        if(_controller->_tracewriter)
-          _controller->_tracewriter->_traceEvent(*as_ev.value());
-
-        do_continue = _onControllerEvent(*(as_ev.value()));
-      }
-      else if( auto as_req = e.tryAs<Controller::request_ptr_t>() ){
-        if(_controller->_tracewriter)
-          _controller->_tracewriter->_traceRequest(*as_req.value());
-        do_continue = _onControllerRequest(*(as_req.value()));
-      }
-      else{
+  for (auto command : _current_commands) {
+    if(_controller->_tracewriter)
+      _controller->_tracewriter->_traceCommand(*command);
+    bool do_continue = true;
+    switch(command->_kind){
+      case Controller::CommandKind::EVENT:
+        do_continue = _onControllerEvent(*command);
+        break;
+      case Controller::CommandKind::REQUEST:
+        do_continue = _onControllerRequest(*command);
+        break;
+      default:
         OrkAssert(false);
-      }
-      if(not do_continue)
-        return;
+        break;
     }
+    if(not do_continue)
+      break;
   }
+  _current_commands.clear();
+  _controller->_retireEvents();
 
   //////////////////////////////////////////////////////////
 
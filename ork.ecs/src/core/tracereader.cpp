@@ -302,17 +302,16 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
       const auto& value = as_typed.value();
 
       auto op = [=]() {
-        auto req = std::make_shared<Request>();
-        req->_requestID = RequestID::SPAWN_DYNAMIC_ANON;
+        auto& req = _controller->_beginRequest(RequestID::SPAWN_DYNAMIC_ANON);
         uint64_t objID = _controller->_objectIdCounter.fetch_add(1);
         OrkAssert(objID == value._entref._entID);
-        auto& IMPL      = req->_payload.make<impl::_SpawnAnonDynamic>();
+        auto& IMPL      = req._payload.make<impl::_SpawnAnonDynamic>();
         IMPL._SAD       = value._SAD;
         IMPL._spawn_rec = _controller->_scenedata->findTypedObject<SpawnData>(value._SAD->_edataname);
         OrkAssert(IMPL._spawn_rec);
         ent_ref_t eref;
         IMPL._entref._entID = objID;
-        _controller->_enqueueRequest(req);
+        _controller->_commitCommand(req);
       };
 
       _controller->presimDelayedOperation(timestamp, op);
@@ -322,11 +321,10 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
     else if (auto as_typed = data.tryAs<impl::_Despawn>()) {
       const auto& value = as_typed.value();
       auto op           = [=]() {
-        auto simevent = std::make_shared<Event>();
-        simevent->_eventID = EventID::DESPAWN;
-        auto& DEV         = simevent->_payload.make<impl::_Despawn>();
+        auto& simevent = _controller->_beginEvent(EventID::DESPAWN);
+        auto& DEV         = simevent._payload.make<impl::_Despawn>();
         DEV._entref       = value._entref;
-        _controller->_enqueueEvent(simevent);
+        _controller->_commitCommand(simevent);
       };
       _controller->presimDelayedOperation(timestamp, op);
     }
@@ -344,14 +342,13 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
         // notify sim to update reference
         //////////////////////////////////////////////////////
 
-        auto simevent = std::make_shared<Event>();
-        simevent->_eventID = EventID::FIND_SYSTEM;
-        auto& FSYS        = simevent->_payload.make<impl::_FindSystem>();
+        auto& simevent = _controller->_beginEvent(EventID::FIND_SYSTEM);
+        auto& FSYS        = simevent._payload.make<impl::_FindSystem>();
 
         FSYS._sysref = SystemRef{._sysID = ID};
         FSYS._syskey = value._syskey;
 
-        _controller->_enqueueEvent(simevent);
+        _controller->_commitCommand(simevent);
       };
       _controller->presimDelayedOperation(timestamp, op);
     }
@@ -369,15 +366,14 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
         // notify sim to update reference
         //////////////////////////////////////////////////////
 
-        auto simevent = std::make_shared<Event>();
-        simevent->_eventID = EventID::FIND_COMPONENT;
-        auto& FCOMP       = simevent->_payload.make<impl::_FindComponent>();
+        auto& simevent = _controller->_beginEvent(EventID::FIND_COMPONENT);
+        auto& FCOMP       = simevent._payload.make<impl::_FindComponent>();
 
         FCOMP._entref    = value._entref;
         FCOMP._compclazz = value._compclazz; // T::GetClassStatic();
         FCOMP._compref   = value._compref;   // ComponentRef({._compID=ID});
 
-        _controller->_enqueueEvent(simevent);
+        _controller->_commitCommand(simevent);
       };
       _controller->presimDelayedOperation(timestamp, op);
     }
@@ -385,15 +381,14 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
     else if (auto as_typed = data.tryAs<impl::_SystemEvent>()) {
       const auto& value = as_typed.value();
       auto op           = [=]() {
-        auto simevent = std::make_shared<Event>();
-        simevent->_eventID = EventID::SYSTEM_EVENT;
-        auto& SEV         = simevent->_payload.make<impl::_SystemEvent>();
+        auto& simevent = _controller->_beginEvent(EventID::SYSTEM_EVENT);
+        auto& SEV         = simevent._payload.make<impl::_SystemEvent>();
 
         SEV._sysref    = value._sysref;
         SEV._eventID   = value._eventID;
         SEV._eventData = value._eventData;
 
-        _controller->_enqueueEvent(simevent);
+        _controller->_commitCommand(simevent);
       };
       _controller->presimDelayedOperation(timestamp, op);
     }
@@ -401,8 +396,7 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
     else if (auto as_typed = data.tryAs<impl::_SystemRequest>()) {
       const auto& value = as_typed.value();
       auto op           = [=]() {
-        auto simrequest = std::make_shared<Request>();
-        simrequest->_requestID = RequestID::SYSTEM_REQUEST;
+        auto& simrequest = _controller->_beginRequest(RequestID::SYSTEM_REQUEST);
 
         uint64_t objID = _controller->_objectIdCounter.fetch_add(1);
 
@@ -412,14 +406,14 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
 
         auto rref = ResponseRef{._responseID = objID};
 
-        auto& SRQ = simrequest->_payload.make<impl::_SystemRequest>();
+        auto& SRQ = simrequest._payload.make<impl::_SystemRequest>();
 
         SRQ._sysref    = value._sysref;
         SRQ._requestID = value._requestID;
         SRQ._eventData = value._eventData;
         SRQ._respref   = value._respref;
 
-        _controller->_enqueueRequest(simrequest);
+        _controller->_commitCommand(simrequest);
       };
       _controller->presimDelayedOperation(timestamp, op);
 
@@ -428,15 +422,14 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
     else if (auto as_typed = data.tryAs<impl::_ComponentEvent>()) {
       const auto& value = as_typed.value();
       auto op           = [=]() {
-        auto simevent = std::make_shared<Event>();
-        simevent->_eventID = EventID::COMPONENT_EVENT;
-        auto& CEV         = simevent->_payload.make<impl::_ComponentEvent>();
+        auto& simevent = _controller->_beginEvent(EventID::COMPONENT_EVENT);
+        auto& CEV         = simevent._payload.make<impl::_ComponentEvent>();
 
         CEV._compref   = value._compref;
         CEV._eventID   = value._eventID;
         CEV._eventData = value._eventData;
 
-        _controller->_enqueueEvent(simevent);
+        _controller->_commitCommand(simevent);
       };
       _controller->presimDelayedOperation(timestamp, op);
     }
@@ -444,9 +437,8 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
     else if (auto as_typed = data.tryAs<impl::_ComponentRequest>()) {
       const auto& value = as_typed.value();
       auto op           = [=]() {
-        auto simrequest = std::make_shared<Request>();
-        simrequest->_requestID = RequestID::COMPONENT_REQUEST;
-        auto& CRQ             = simrequest->_payload.make<impl::_ComponentRequest>();
+        auto& simrequest = _controller->_beginRequest(RequestID::COMPONENT_REQUEST);
+        auto& CRQ             = simrequest._payload.make<impl::_ComponentRequest>();
 
         uint64_t objID = _controller->_objectIdCounter.fetch_add(1);
         OrkAssert(objID == value._respref._responseID);
@@ -459,7 +451,7 @@ Controller::TraceReader::TraceReader(Controller* c, file::Path path)
         CRQ._eventData = value._eventData;
         CRQ._respref   = value._respref;
 
-        _controller->_enqueueRequest(simrequest);
+        _controller->_commitCommand(simrequest);
       };
       _controller->presimDelayedOperation(timestamp, op);
 
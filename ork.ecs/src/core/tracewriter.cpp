@@ -295,6 +295,19 @@ std::string Controller::TraceWriter::_traceVar128(const svar160_t& var){
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void Controller::TraceWriter::_traceCommand(const Command& command){
+	switch(command._kind){
+		case CommandKind::EVENT:
+			_traceEvent(command);
+			break;
+		case CommandKind::REQUEST:
+			_traceRequest(command);
+			break;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void Controller::TraceWriter::_traceEvent(const Event& event){
 
 	float timestamp_offset = _outtimer.SecsSinceStart();
@@ -191,30 +191,6 @@ void BulletObjectComponent::_onDeactivate(Simulation* sim) {
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void BulletObjectComponent::updateDynamic(Simulation* sim, float time_step) {
-
-  //////////////////////////////////////////////////
-  // copy motion state to entity transform
-  //////////////////////////////////////////////////
-
-  auto ecs_xform = GetEntity()->transform();
-
-  const btMotionState* motionState = _rigidbody->getMotionState();
-  btTransform xf;
-  motionState->getWorldTransform(xf);
-
-  ork::fvec3 position = btv3toorkv3(xf.getOrigin());
-  ork::fquat rotation = btqtoorkq(xf.getRotation());
-
-  ecs_xform->_translation = position;
-  ecs_xform->_rotation = rotation;
-
-  // apply BulletSystem's expgravity
-
-}
-
-///////////////////////////////////////////////////////////////////////////////////////
-
 void BulletObjectComponent::updateKinematic(Simulation* sim, float time_step){
   auto ecs_xform = GetEntity()->transform();
   btMotionState* motionState = _rigidbody->getMotionState();
@@ -62,6 +62,7 @@ void BulletSystemData::describeX(SystemDataClass* clazz) {
   clazz->directProperty("LinGravity", &BulletSystemData::_lingravity);
   clazz->directProperty("ExpGravity", &BulletSystemData::_expgravity);
   clazz->directProperty("Debug", &BulletSystemData::_debug);
+  clazz->directProperty("Multithreaded", &BulletSystemData::_multithreaded);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -107,6 +108,8 @@ BulletSystem::~BulletSystem() {
     delete mDynamicsWorld;
   if (mSolver)
     delete mSolver;
+  if (mSolverPool)
+    delete mSolverPool;
   if (mBtConfig)
     delete mBtConfig;
   if (mDispatcher)
@@ -440,15 +443,40 @@ void BulletSystem::InitWorld() {
   // collision configuration contains default setup for memory, collision setup
   mBtConfig = new btDefaultCollisionConfiguration(cinfo);
 
-  // use the default collision dispatcher. For parallel processing you can use a diffent dispatcher (see Extras/BulletMultiThreaded)
-  mDispatcher = new btCollisionDispatcher(mBtConfig);
+  ////////////////////////////////////////
+  // multithreaded world (opt in) :
+  //  narrowphase, island solving and integration fan out over
+  //  opq workers through the bullet task scheduler.
+  //  requires bullet built with BT_THREADSAFE
+  ////////////////////////////////////////
+
+  _multithreaded = false;
+  if (_systemData._multithreaded) {
+#if BT_THREADSAFE
+    btSetTaskScheduler(opqTaskScheduler());
+    _multithreaded = true;
+    logchan_bull->log("BulletSystem<%p> multithreaded numthreads<%d>", (void*)this, opqTaskScheduler()->getNumThreads());
+#else
+    logchan_bull->log("WARNING: bullet was not built with BT_THREADSAFE, using the single threaded world");
+#endif
+  }
+
+  if (_multithreaded) {
+    mDispatcher = new btCollisionDispatcherMt(mBtConfig, 40);
+  } else {
+    mDispatcher = new btCollisionDispatcher(mBtConfig);
+  }
 
   if (USE_GIMPACT) {
     btGImpactCollisionAlgorithm::registerAlgorithm(mDispatcher);
   }
 
-  // the default constraint solver. For parallel processing you can use a different solver (see Extras/BulletMultiThreaded)
-  mSolver = new btSequentialImpulseConstraintSolver;
+  if (_multithreaded) {
+    mSolverPool = new btConstraintSolverPoolMt(opqTaskScheduler()->getNumThreads());
+    mSolver     = new btSequentialImpulseConstraintSolverMt;
+  } else {
+    mSolver = new btSequentialImpulseConstraintSolver;
+  }
 
   auto broadphase = new btDbvtBroadphase();
   // OR
@@ -458,7 +486,11 @@ void BulletSystem::InitWorld() {
 
   mBroadPhase = broadphase;
 
-  mDynamicsWorld = new btDiscreteDynamicsWorld(mDispatcher, mBroadPhase, mSolver, mBtConfig);
+  if (_multithreaded) {
+    mDynamicsWorld = new btDiscreteDynamicsWorldMt(mDispatcher, mBroadPhase, mSolverPool, mSolver, mBtConfig);
+  } else {
+    mDynamicsWorld = new btDiscreteDynamicsWorld(mDispatcher, mBroadPhase, mSolver, mBtConfig);
+  }
   // mDynamicsWorld->getSolverInfo().m_solverMode &= ~SOLVER_RANDMIZE_ORDER;
   mDynamicsWorld->getSolverInfo().m_solverMode |= SOLVER_CACHE_FRIENDLY;
   mDynamicsWorld->getSolverInfo().m_solverMode |= SOLVER_SIMD;
@@ -559,11 +591,6 @@ void BulletSystem::_onUpdate(Simulation* inst) {
         component->updateKinematic(_simulation, dt);
       }
       EASY_END_BLOCK;
-      EASY_BLOCK("dynamic", profiler::colors::Cyan);
-      for (BulletObjectComponent* component : _updateDynamicComponents._linear) {
-        component->updateDynamic(_simulation, dt);
-      }
-      EASY_END_BLOCK;
       EASY_BLOCK("forces", profiler::colors::Cyan);
       for (BulletObjectComponent* component : _updateForceComponents._linear) {
         component->updateForces(_simulation, dt);
@@ -654,6 +681,18 @@ void BulletSystem::_onUpdate(Simulation* inst) {
       mNumSubStepsTaken += m;
       EASY_END_BLOCK;
 
+      /////////////////////////////////////////
+      // publish poses bullet moved this step
+      /////////////////////////////////////////
+
+      EASY_BLOCK("writeback", profiler::colors::Cyan);
+      _transformSync.clear();
+      for (BulletObjectComponent* component : _updateDynamicComponents._linear) {
+        _transformSync.gather((EntMotionState*)component->_rigidbody->getMotionState());
+      }
+      _transformSync.publish(_multithreaded ? 256 : 0);
+      EASY_END_BLOCK;
+
       EASY_BLOCK("collisions", profiler::colors::Cyan);
       for (auto callback : _collisionCallbacks) {
         auto body = callback->monitoredBody;
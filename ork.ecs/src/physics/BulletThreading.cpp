@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2022, Michael T. Mayers.
+// Distributed under the Boost Software License - Version 1.0 - August 17, 2003
+// see http://www.boost.org/LICENSE_1_0.txt
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/kernel/opq.h>
+#include <ork/ecs/physics/bullet.h>
+
+#include "bullet_impl.h"
+
+#include <thread>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace ork::ecs {
+///////////////////////////////////////////////////////////////////////////////
+
+static int _opqMaxThreads() {
+  // opq workers plus the calling thread
+  return std::max(opq::concurrentQueue()->_numThreadsRunning.load(), 1) + 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// chunks are claimed through an atomic counter, so helpers that start
+//  late (or never, on a saturated queue) just find no work left.
+//  the body is only touched while a claimed chunk is outstanding,
+//  which the caller waits for.
+///////////////////////////////////////////////////////////////////////////////
+
+void opqParallelFor(int ibegin, int iend, int grainsize, int maxthreads, const parallel_for_body_t& body) {
+  int count = iend - ibegin;
+  if (count <= 0)
+    return;
+  grainsize     = std::max(grainsize, 1);
+  int numchunks = (count + grainsize - 1) / grainsize;
+  if (maxthreads <= 0)
+    maxthreads = _opqMaxThreads();
+  int numhelpers = std::min(numchunks, maxthreads) - 1;
+  if (numhelpers <= 0) {
+    body(ibegin, iend);
+    return;
+  }
+  struct ChunkState {
+    std::atomic<int> _next = 0;
+    std::atomic<int> _done = 0;
+  };
+  auto state      = std::make_shared<ChunkState>();
+  auto run_chunks = [state, ibegin, iend, grainsize, numchunks, &body]() {
+    int ichunk = state->_next.fetch_add(1);
+    while (ichunk < numchunks) {
+      int chunk_begin = ibegin + ichunk * grainsize;
+      int chunk_end   = std::min(chunk_begin + grainsize, iend);
+      body(chunk_begin, chunk_end);
+      state->_done.fetch_add(1, std::memory_order_release);
+      ichunk = state->_next.fetch_add(1);
+    }
+  };
+  auto q = opq::concurrentQueue();
+  for (int i = 0; i < numhelpers; i++) {
+    q->enqueue(run_chunks, "bullet.parallelFor");
+  }
+  run_chunks();
+  while (state->_done.load(std::memory_order_acquire) < numchunks) {
+    std::this_thread::yield();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// btITaskScheduler on top of opqParallelFor
+//  (bullet hands out per thread indices on first use, all opq workers
+//   plus the update thread must stay below BT_MAX_THREAD_COUNT)
+///////////////////////////////////////////////////////////////////////////////
+
+struct OpqTaskScheduler final : public btITaskScheduler {
+
+  OpqTaskScheduler()
+      : btITaskScheduler("OrkOpq") {
+    _numThreads = std::min(_opqMaxThreads(), int(BT_MAX_THREAD_COUNT));
+  }
+
+  int getMaxNumThreads() const final {
+    return std::min(_opqMaxThreads(), int(BT_MAX_THREAD_COUNT));
+  }
+  int getNumThreads() const final {
+    return _numThreads;
+  }
+  void setNumThreads(int numthreads) final {
+    _numThreads = std::clamp(numthreads, 1, getMaxNumThreads());
+  }
+
+  void parallelFor(int ibegin, int iend, int grainsize, const btIParallelForBody& body) final {
+    opqParallelFor(ibegin, iend, grainsize, _numThreads, [&body](int chunk_begin, int chunk_end) { //
+      body.forLoop(chunk_begin, chunk_end);
+    });
+  }
+
+  btScalar parallelSum(int ibegin, int iend, int grainsize, const btIParallelSumBody& body) final {
+    // per chunk partials, summed in chunk order so results do not depend on scheduling
+    grainsize     = std::max(grainsize, 1);
+    int numchunks = std::max((iend - ibegin + grainsize - 1) / grainsize, 0);
+    std::vector<btScalar> partials(numchunks, btScalar(0));
+    opqParallelFor(ibegin, iend, grainsize, _numThreads, [&](int chunk_begin, int chunk_end) {
+      partials[(chunk_begin - ibegin) / grainsize] = body.sumLoop(chunk_begin, chunk_end);
+    });
+    btScalar sum = 0;
+    for (auto item : partials)
+      sum += item;
+    return sum;
+  }
+
+  int _numThreads = 1;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+btITaskScheduler* opqTaskScheduler() {
+  static OpqTaskScheduler _scheduler;
+  return &_scheduler;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::ecs
@@ -14,6 +14,11 @@
 //#include <Extras/GIMPACTUtils/btGImpactConvexDecompositionShape.h>
 #include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 
+#include <LinearMath/btThreads.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+
 #pragma GCC diagnostic pop
 
 #include <ork/kernel/mutex.h>
@@ -140,9 +145,39 @@ public:
 
   int _instance_id = -1;
   lev2::instanceddrawinstancedata_ptr_t _idata;
+  bool _dirty = false; // moved by bullet since the last BulletTransformSync
 
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// batched rigid body -> ecs transform writeback
+//  bullet only stores poses in EntMotionState during stepSimulation,
+//  BulletTransformSync then converts every moved pose into SoA arrays
+//  and publishes them (entity transforms or instance matrices) in one pass
+///////////////////////////////////////////////////////////////////////////////
+
+struct BulletTransformSync {
+
+  void clear();
+  void gather(EntMotionState* motionstate);
+  void publish(int grainsize); // grainsize <= 0 : single threaded
+
+  std::vector<EntMotionState*> _motionstates;
+  std::vector<fvec3> _positions;
+  std::vector<fquat> _rotations;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// opq backed parallel for / bullet task scheduler
+//  body(ibegin,iend) runs on the opq concurrent queue,
+//  the calling thread works on chunks too and returns when all are done
+///////////////////////////////////////////////////////////////////////////////
+
+using parallel_for_body_t = std::function<void(int ibegin, int iend)>;
+
+void opqParallelFor(int ibegin, int iend, int grainsize, int maxthreads, const parallel_for_body_t& body);
+btITaskScheduler* opqTaskScheduler();
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct BulletObjectForceControllerInst {
@@ -201,7 +236,6 @@ public:
 
   BulletObjectForceControllerInst* getForceController(std::string named) const;
 
-  void updateDynamic(Simulation* sim, float time_step);
   void updateForces(Simulation* sim, float time_step);
   void updateKinematic(Simulation* sim, float time_step);
 
@@ -274,7 +308,8 @@ public:
   btDefaultCollisionConfiguration* mBtConfig;
   btBroadphaseInterface* mBroadPhase;
   btCollisionDispatcher* mDispatcher;
-  btSequentialImpulseConstraintSolver* mSolver;
+  btConstraintSolver* mSolver;
+  btConstraintSolverPoolMt* mSolverPool = nullptr; // multithreaded world only
   const BulletSystemData& _systemData;
   std::string _dbgdrawlayername;
   lev2::DrawQueueTransferData _dbgdrawXF;
@@ -294,6 +329,8 @@ public:
   fast_set<BulletObjectComponent*> _sleptDynamicComponents;
   tsl::robin_set<orkcontactcallback_ptr_t> _collisionCallbacks;
   tsl::robin_pg_set<BulletObjectComponent*> _deactivation_queue;
+  BulletTransformSync _transformSync;
+  bool _multithreaded = false;
 };
 
 
@@ -110,34 +110,69 @@ void EntMotionState::getWorldTransform(btTransform& transform) const {
 }
 
 void EntMotionState::setWorldTransform(const btTransform& transform) {
-
+  // published later by BulletTransformSync
+  mTransform = transform;
+  _dirty     = true;
   _counter++;
-  
-  if (mEntity) {
+}
 
-    ork::fvec3 position = btv3toorkv3(transform.getOrigin());
-    ork::fquat rotation = btqtoorkq(transform.getRotation());
+///////////////////////////////////////////////////////////////////////////////
 
-    if (_idata) {
+void BulletTransformSync::clear() {
+  _motionstates.clear();
+}
 
-      fmtx4 c;
-      c.compose(position, rotation);
-      _idata->_worldmatrices[_instance_id] = c;
-      auto dpos = ork::fvec3_to_dvec3(position);
-      auto delta = (dpos-_prevpos).absolute();
-      _energy += delta;
-      _energy = _energy * 0.99;
-      _prevpos = dpos;
-    } else {
+///////////////////////////////////////////////////////////////////////////////
 
-      auto out_xform          = mEntity->transform();
-      out_xform->_translation = position;
-      out_xform->_rotation    = rotation;
-      mTransform = transform;
+void BulletTransformSync::gather(EntMotionState* motionstate) {
+  if (motionstate->_dirty) {
+    motionstate->_dirty = false;
+    _motionstates.push_back(motionstate);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
+void BulletTransformSync::publish(int grainsize) {
+  int count = int(_motionstates.size());
+  _positions.resize(count);
+  _rotations.resize(count);
+  if (grainsize <= 0)
+    grainsize = std::max(count, 1);
+  int maxthreads = 0; // all opq workers
+  ////////////////////////////////////////
+  // btTransform -> SoA
+  ////////////////////////////////////////
+  opqParallelFor(0, count, grainsize, maxthreads, [this](int ibegin, int iend) {
+    for (int i = ibegin; i < iend; i++) {
+      const btTransform& xf = _motionstates[i]->mTransform;
+      _positions[i]         = btv3toorkv3(xf.getOrigin());
+      _rotations[i]         = btqtoorkq(xf.getRotation());
     }
-    // compute 4x4 matrix from btTransform
-  }
+  });
+  ////////////////////////////////////////
+  // SoA -> instance matrices / entity transforms
+  ////////////////////////////////////////
+  opqParallelFor(0, count, grainsize, maxthreads, [this](int ibegin, int iend) {
+    for (int i = ibegin; i < iend; i++) {
+      auto motionstate      = _motionstates[i];
+      const fvec3& position = _positions[i];
+      const fquat& rotation = _rotations[i];
+      if (motionstate->_idata) {
+        fmtx4 c;
+        c.compose(position, rotation);
+        motionstate->_idata->_worldmatrices[motionstate->_instance_id] = c;
+        auto dpos             = ork::fvec3_to_dvec3(position);
+        auto delta            = (dpos - motionstate->_prevpos).absolute();
+        motionstate->_energy  = (motionstate->_energy + delta) * 0.99;
+        motionstate->_prevpos = dpos;
+      } else if (motionstate->mEntity) {
+        auto out_xform          = motionstate->mEntity->transform();
+        out_xform->_translation = position;
+        out_xform->_rotation    = rotation;
+      }
+    }
+  });
 }
 
 }} // namespace ork::ecs
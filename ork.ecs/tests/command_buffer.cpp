@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2022, Michael T. Mayers.
+// Distributed under the Boost Software License - Version 1.0 - August 17, 2003
+// see http://www.boost.org/LICENSE_1_0.txt
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <utpp/UnitTest++.h>
+#include <thread>
+
+#include "core/command_buffer.h"
+
+using namespace ork;
+using namespace ork::ecs;
+
+///////////////////////////////////////////////////////////////////////////////
+// several producer threads hammer the buffer while the consumer
+//  polls batches, every producer's commands must come out in
+//  submission order and each batch must be sequence ordered
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(CommandBufferMultiProducer) {
+  constexpr int knumproducers = 4;
+  constexpr int knumcommands  = 20000;
+
+  impl::CommandBuffer buffer;
+  std::atomic<int> producers_done = 0;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < knumproducers; p++) {
+    producers.emplace_back([&buffer, &producers_done, p]() {
+      for (int i = 0; i < knumcommands; i++) {
+        auto& command = buffer.begin(Controller::CommandKind::EVENT);
+        command._payload.make<uint64_t>((uint64_t(p) << 32) | uint64_t(i));
+        buffer.commit(command);
+      }
+      producers_done.fetch_add(1);
+    });
+  }
+
+  std::vector<int> next_expected(knumproducers, 0);
+  bool in_order   = true;
+  bool batch_sorted = true;
+  int numreceived = 0;
+  Controller::command_batch_t batch;
+  auto never_blocked = [](const Controller::Command&) -> bool { return false; };
+  while (numreceived < knumproducers * knumcommands) {
+    bool all_done = (producers_done.load() == knumproducers);
+    batch.clear();
+    buffer.poll(never_blocked, batch);
+    uint64_t prev_sequence = 0;
+    for (size_t i = 0; i < batch.size(); i++) {
+      auto command   = batch[i];
+      uint64_t value = command->_payload.get<uint64_t>();
+      int producer   = int(value >> 32);
+      int index      = int(value & 0xffffffff);
+      if (index != next_expected[producer])
+        in_order = false;
+      next_expected[producer] = index + 1;
+      if (i > 0 and command->_sequence <= prev_sequence)
+        batch_sorted = false;
+      prev_sequence = command->_sequence;
+    }
+    numreceived += int(batch.size());
+    buffer.retire();
+    if (all_done and batch.empty())
+      break;
+  }
+  for (auto& thr : producers)
+    thr.join();
+
+  CHECK(in_order);
+  CHECK(batch_sorted);
+  CHECK_EQUAL(knumproducers * knumcommands, numreceived);
+  CHECK_EQUAL(knumproducers, buffer._numRings.load());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// a blocked command holds back itself and everything after it,
+//  discardPending drops what was committed before the call
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(CommandBufferBarrierAndDiscard) {
+  impl::CommandBuffer buffer;
+  for (int i = 0; i < 300; i++) {
+    auto& command = buffer.begin(Controller::CommandKind::REQUEST);
+    command._payload.make<int>(i);
+    buffer.commit(command);
+  }
+
+  int barrier_at = 200;
+  auto is_blocked = [&barrier_at](const Controller::Command& command) -> bool { //
+    return command._payload.get<int>() == barrier_at;
+  };
+
+  Controller::command_batch_t batch;
+  CHECK(buffer.poll(is_blocked, batch));
+  CHECK_EQUAL(200, int(batch.size()));
+  CHECK_EQUAL(199, batch.back()->_payload.get<int>());
+  buffer.retire();
+
+  batch.clear();
+  CHECK(buffer.poll(is_blocked, batch));
+  CHECK_EQUAL(0, int(batch.size()));
+
+  barrier_at = -1;
+  batch.clear();
+  CHECK(not buffer.poll(is_blocked, batch));
+  CHECK_EQUAL(100, int(batch.size()));
+  CHECK_EQUAL(200, batch.front()->_payload.get<int>());
+  buffer.retire();
+
+  for (int i = 0; i < 10; i++) {
+    auto& command = buffer.begin(Controller::CommandKind::EVENT);
+    command._payload.make<int>(1000 + i);
+    buffer.commit(command);
+  }
+  buffer.discardPending();
+  auto& command = buffer.begin(Controller::CommandKind::EVENT);
+  command._payload.make<int>(2000);
+  buffer.commit(command);
+
+  batch.clear();
+  buffer.poll(is_blocked, batch);
+  CHECK_EQUAL(1, int(batch.size()));
+  CHECK_EQUAL(2000, batch.front()->_payload.get<int>());
+  buffer.retire();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// short lived producer threads hand their rings on, so thread churn
+//  never runs out of producer slots, and a thread's ring cache drops
+//  the entries of destroyed buffers
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(CommandBufferProducerChurn) {
+  constexpr int knumthreads = 4 * impl::CommandBuffer::kMaxProducers;
+
+  impl::CommandBuffer buffer;
+  for (int t = 0; t < knumthreads; t++) {
+    std::thread producer([&buffer, t]() {
+      auto& command = buffer.begin(Controller::CommandKind::EVENT);
+      command._payload.make<int>(t);
+      buffer.commit(command);
+    });
+    producer.join();
+  }
+  CHECK_EQUAL(1, buffer._numRings.load());
+
+  Controller::command_batch_t batch;
+  auto never_blocked = [](const Controller::Command&) -> bool { return false; };
+  buffer.poll(never_blocked, batch);
+  CHECK_EQUAL(knumthreads, int(batch.size()));
+  bool in_order = true;
+  for (int i = 0; i < int(batch.size()); i++) {
+    if (batch[i]->_payload.get<int>() != i)
+      in_order = false;
+  }
+  CHECK(in_order);
+  buffer.retire();
+
+  size_t numcached = impl::CommandBuffer::numCachedRings();
+  for (int i = 0; i < 100; i++) {
+    impl::CommandBuffer transient;
+    auto& command = transient.begin(Controller::CommandKind::EVENT);
+    command._payload.make<int>(i);
+    transient.commit(command);
+  }
+  CHECK(impl::CommandBuffer::numCachedRings() <= numcached + 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// a producer that has taken its sequence but not yet published holds
+//  back every later command, even ones already published by other rings
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(CommandBufferReservedSequence) {
+  impl::CommandBuffer buffer;
+  auto stalled_ring = buffer.producerRing();
+  stalled_ring->_reservedSequence.store(buffer._sequence.load()); // mid commit()
+
+  std::thread producer([&buffer]() {
+    auto& command = buffer.begin(Controller::CommandKind::EVENT);
+    command._payload.make<int>(1);
+    buffer.commit(command);
+  });
+  producer.join();
+
+  Controller::command_batch_t batch;
+  auto never_blocked = [](const Controller::Command&) -> bool { return false; };
+  CHECK(not buffer.poll(never_blocked, batch));
+  CHECK_EQUAL(0, int(batch.size()));
+
+  stalled_ring->_reservedSequence.store(impl::CommandRing::kNoSequence);
+  CHECK(not buffer.poll(never_blocked, batch));
+  CHECK_EQUAL(1, int(batch.size()));
+  CHECK_EQUAL(1, batch.front()->_payload.get<int>());
+  buffer.retire();
+}
@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2022, Michael T. Mayers.
+// Distributed under the Boost Software License - Version 1.0 - August 17, 2003
+// see http://www.boost.org/LICENSE_1_0.txt
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/kernel/opq.h>
+#include <ork/lev2/gfx/renderer/drawable.h>
+#include <utpp/UnitTest++.h>
+
+#include "physics/bullet_impl.h"
+
+using namespace ork;
+using namespace ork::ecs;
+
+// timing : ork.example.ecs.physicsperf.exe
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// a few spheres dropped onto a static floor (single threaded world),
+//  poses written back to instance matrices through BulletTransformSync
+///////////////////////////////////////////////////////////////////////////////
+
+struct SphereDrop {
+
+  SphereDrop(int numbodies) {
+    _config     = new btDefaultCollisionConfiguration;
+    _broadphase = new btDbvtBroadphase;
+    _dispatcher = new btCollisionDispatcher(_config);
+    _solver     = new btSequentialImpulseConstraintSolver;
+    _world      = new btDiscreteDynamicsWorld(_dispatcher, _broadphase, _solver, _config);
+    _world->setGravity(btVector3(0, -9.8, 0));
+    _floorshape = new btStaticPlaneShape(btVector3(0, 1, 0), 0);
+    _floorbody  = new btRigidBody(0.0f, nullptr, _floorshape);
+    _world->addRigidBody(_floorbody);
+    _idata = std::make_shared<lev2::InstancedDrawableInstanceData>();
+    _idata->resize(numbodies);
+    _sphere = new btSphereShape(0.5f);
+    btVector3 inertia(0, 0, 0);
+    _sphere->calculateLocalInertia(1.0f, inertia);
+    for (int i = 0; i < numbodies; i++) {
+      btTransform start;
+      start.setIdentity();
+      start.setOrigin(btVector3(i * 1.1f, 2.0f, 0.0f));
+      auto motionstate          = new EntMotionState(start, nullptr);
+      motionstate->_idata       = _idata;
+      motionstate->_instance_id = i;
+      btRigidBody::btRigidBodyConstructionInfo cinfo(1.0f, motionstate, _sphere, inertia);
+      auto body = new btRigidBody(cinfo);
+      body->setActivationState(DISABLE_DEACTIVATION);
+      _world->addRigidBody(body);
+      _bodies.push_back(body);
+      _motionstates.push_back(motionstate);
+    }
+  }
+
+  ~SphereDrop() {
+    for (size_t i = 0; i < _bodies.size(); i++) {
+      _world->removeRigidBody(_bodies[i]);
+      delete _bodies[i];
+      delete _motionstates[i];
+    }
+    _world->removeRigidBody(_floorbody);
+    delete _floorbody;
+    delete _floorshape;
+    delete _sphere;
+    delete _world;
+    delete _solver;
+    delete _dispatcher;
+    delete _broadphase;
+    delete _config;
+  }
+
+  // returns the number of poses published
+  size_t gatherAndPublish(int grainsize) {
+    _sync.clear();
+    for (auto motionstate : _motionstates)
+      _sync.gather(motionstate);
+    _sync.publish(grainsize);
+    return _sync._motionstates.size();
+  }
+
+  size_t step(int grainsize) {
+    _world->stepSimulation(1.0f / 60.0f, 1, 1.0f / 60.0f);
+    return gatherAndPublish(grainsize);
+  }
+
+  btDefaultCollisionConfiguration* _config = nullptr;
+  btBroadphaseInterface* _broadphase       = nullptr;
+  btCollisionDispatcher* _dispatcher       = nullptr;
+  btConstraintSolver* _solver              = nullptr;
+  btDiscreteDynamicsWorld* _world          = nullptr;
+  btCollisionShape* _floorshape            = nullptr;
+  btRigidBody* _floorbody                  = nullptr;
+  btSphereShape* _sphere                   = nullptr;
+  std::vector<btRigidBody*> _bodies;
+  std::vector<EntMotionState*> _motionstates;
+  lev2::instanceddrawinstancedata_ptr_t _idata;
+  BulletTransformSync _sync;
+};
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// only bodies bullet moved are published, each once per step,
+//  and the published matrices match the body poses
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(BulletTransformSyncWriteback) {
+  constexpr int knumbodies = 8;
+  SphereDrop drop(knumbodies);
+  auto parked = drop._bodies[knumbodies - 1];
+  parked->forceActivationState(DISABLE_SIMULATION);
+
+  for (int istep = 0; istep < 30; istep++) {
+    int grainsize = (istep & 1) ? 2 : 0; // alternate parallel / single threaded publish
+    CHECK_EQUAL(size_t(knumbodies - 1), drop.step(grainsize));
+  }
+  // nothing moved since the last publish
+  CHECK_EQUAL(size_t(0), drop.gatherAndPublish(0));
+
+  for (int i = 0; i < knumbodies - 1; i++) {
+    const auto& xf  = drop._bodies[i]->getWorldTransform();
+    fvec3 published = drop._idata->_worldmatrices[i].translation();
+    CHECK((published - btv3toorkv3(xf.getOrigin())).magnitude() < 1.0e-4f);
+    CHECK(published.y < 2.0f);
+  }
+  fvec3 parked_pos = drop._idata->_worldmatrices[knumbodies - 1].translation();
+  CHECK(parked_pos.magnitude() < 1.0e-6f);
+  CHECK_CLOSE(2.0f, float(parked->getWorldTransform().getOrigin().y()), 1.0e-6f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// every index is handed out exactly once, whatever the grain size
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(BulletOpqParallelFor) {
+  constexpr int kcount = 1000;
+  for (int grainsize : {0, 1, 7, kcount, 2 * kcount}) {
+    std::vector<std::atomic<int>> visits(kcount);
+    opqParallelFor(0, kcount, grainsize, 0, [&](int ibegin, int iend) {
+      for (int i = ibegin; i < iend; i++)
+        visits[i]++;
+    });
+    bool once = true;
+    for (const auto& v : visits)
+      once = once and (v.load() == 1);
+    CHECK(once);
+  }
+  bool called = false;
+  opqParallelFor(5, 5, 1, 0, [&](int, int) { called = true; });
+  CHECK(not called);
+}
@@ -169,6 +169,158 @@ struct VerilogBackEnd final : public IBackEnd {
   int _column      = 0;
 };
 
+///////////////////////////////////////////////////
+// SimBackEnd :
+//  compiles the elaborated module tree into flat
+//  schedules of 64 bit word ops and runs them
+//  natively, one posedge of sysclock per step()
+///////////////////////////////////////////////////
+
+enum class SimOpCode : uint8_t {
+  MOV,
+  AND,
+  OR,
+  ADD,
+  SUB,
+  MUL,
+  DIV,
+  SHL,
+  SHR,
+  SHLI,
+  SLICE,
+  CONCAT,
+  EQ,
+  NE,
+  NEZ,
+  LNOT,
+  LTU,
+  GTU,
+  LTS,
+  GTS,
+  SELECT,
+  INSERT,
+  PMOV,
+  PINSERT,
+  MEMREAD,
+  MEMCAPTURE,
+  MEMCOMMIT,
+};
+
+struct SimOp {
+  SimOpCode _opcode = SimOpCode::MOV;
+  uint32_t _dst     = 0;
+  uint32_t _a       = 0;
+  uint32_t _b       = 0;
+  uint32_t _c       = 0;
+  uint64_t _imm     = 0;
+  uint64_t _mask    = ~uint64_t(0);
+};
+
+struct SimSignal {
+  Module* _module = nullptr;
+  std::string _key;
+  std::string _name;
+  size_t _width      = 0;
+  size_t _depth      = 0;
+  bool _signed       = false;
+  bool _register     = false;
+  uint32_t _slot     = 0;
+  uint32_t _nextslot = 0;
+};
+
+struct SimPredTerm {
+  expr_t _cond      = nullptr;
+  bool _negate      = false;
+  expr_t _switchsel = nullptr;
+  uint64_t _caseval = 0;
+};
+
+struct SimCombNode {
+  std::vector<SimOp> _ops;
+  std::set<size_t> _reads;
+  std::set<size_t> _writes;
+};
+
+struct SimBackEnd final : public IBackEnd {
+
+  SimBackEnd();
+  ~SimBackEnd();
+  void flush() final;
+
+  void beginModule(Module* m) final {
+  }
+  void endModule(Module* m) final {
+  }
+  void visitRootModule(Module& m) final;
+
+  void reset();
+  void step();
+  void run(size_t numcycles);
+  uint64_t read(const Module* m, const std::string& key) const;
+  void write(const Module* m, const std::string& key, uint64_t value);
+  void openVcd(const std::string& path);
+  void closeVcd();
+
+  uint64_t cycle() const {
+    return _cycle;
+  }
+
+  //////////////////////////////
+
+  void _collectModule(Module* m, const std::string& path);
+  void _compilePorts(Module* m);
+  void _compileSegment(Segment* s, bool sync, std::vector<SimPredTerm> terms, uint32_t pred);
+  void _compileWrite(const Ref& lhs, uint32_t value, uint32_t pred, bool sync);
+  uint32_t _compilePredicate(const std::vector<SimPredTerm>& terms);
+  uint32_t _compileExpression(expr_t e);
+  uint32_t _compileRvalue(const Rvalue& r);
+  uint32_t _compileRefRead(const Ref& r);
+  bool _isSigned(const Rvalue& r) const;
+  void _beginCombNode();
+  void _endCombNode();
+  void _levelize();
+  void _execute(const std::vector<SimOp>& schedule);
+  void _traceVcd(uint64_t timestamp, bool clocklevel);
+  uint32_t _allocSlots(size_t count);
+  uint32_t _constSlot(uint64_t value);
+  size_t _signalIndex(const Module* m, const std::string& key) const;
+  void _emit(SimOpCode opc, uint32_t dst, uint32_t a, uint32_t b, uint32_t c, uint64_t imm, uint64_t mask);
+  uint32_t _emitTemp(SimOpCode opc, uint32_t a, uint32_t b, uint32_t c, uint64_t imm, size_t width);
+
+  //////////////////////////////
+
+  Module* _root = nullptr;
+  std::vector<Module*> _modules;
+  std::map<Module*, std::string> _modulepaths;
+  std::vector<SimSignal> _signals;
+  std::map<std::pair<const Module*, std::string>, size_t> _signalmap;
+  std::map<uint64_t, uint32_t> _constslots;
+  size_t _numslots  = 0;
+  uint32_t _truslot = 0;
+
+  std::vector<SimCombNode> _combnodes;
+  std::vector<SimOp> _combschedule;
+  std::vector<SimOp> _syncschedule;
+  std::vector<SimOp> _commitschedule;
+  std::vector<SimOp> _commitmem;
+  size_t _numlevels = 0;
+
+  std::vector<SimOp>* _curops     = nullptr;
+  std::set<size_t>* _curreads     = nullptr;
+  std::set<size_t>* _curwrites    = nullptr;
+  std::set<size_t> _scratchreads;
+  std::set<size_t> _scratchwrites;
+
+  std::vector<uint64_t> _state;
+  uint64_t _cycle     = 0;
+  size_t _clocksignal = size_t(-1);
+
+  FILE* _vcdout         = nullptr;
+  uint64_t _vcdtimebase = 0; // vcd time of cycle 0, advanced by reset() so time stays monotonic
+  std::vector<std::string> _vcdids;
+  std::vector<uint64_t> _vcdvalues;
+};
+
 ///////////////////////////////////////////////////
 
 struct Unknown {
@@ -600,4 +752,5 @@ struct Module {
 #include "mem.inl"
 
 #include "verilogbackend.inl"
+#include "simbackend.inl"
 #include "testbench.inl"
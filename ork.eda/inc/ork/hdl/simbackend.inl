@@ -0,0 +1,858 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2022, Michael T. Mayers.
+// Distributed under the Boost Software License - Version 1.0 - August 17, 2003
+// see http://www.boost.org/LICENSE_1_0.txt
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+namespace ork { namespace hdl {
+
+///////////////////////////////////////////////////
+
+inline uint64_t simWidthMask(size_t width) {
+  return (width >= 64) ? ~uint64_t(0) : ((uint64_t(1) << width) - 1);
+}
+
+///////////////////////////////////////////////////
+
+SimBackEnd::SimBackEnd() {
+}
+SimBackEnd::~SimBackEnd() {
+  closeVcd();
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::flush() {
+  if (_vcdout)
+    fflush(_vcdout);
+}
+
+///////////////////////////////////////////////////
+
+uint32_t SimBackEnd::_allocSlots(size_t count) {
+  uint32_t rval = uint32_t(_numslots);
+  _numslots += count;
+  return rval;
+}
+
+///////////////////////////////////////////////////
+
+uint32_t SimBackEnd::_constSlot(uint64_t value) {
+  auto it = _constslots.find(value);
+  if (it != _constslots.end())
+    return it->second;
+  uint32_t slot      = _allocSlots(1);
+  _constslots[value] = slot;
+  return slot;
+}
+
+///////////////////////////////////////////////////
+
+size_t SimBackEnd::_signalIndex(const Module* m, const std::string& key) const {
+  auto it = _signalmap.find(std::make_pair(m, key));
+  if (it == _signalmap.end()) {
+    printf("SimBackEnd: unresolved signal<%s> in module<%s>\n", key.c_str(), m->_name.c_str());
+    assert(false);
+  }
+  return it->second;
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::_emit(SimOpCode opc, uint32_t dst, uint32_t a, uint32_t b, uint32_t c, uint64_t imm, uint64_t mask) {
+  SimOp op;
+  op._opcode = opc;
+  op._dst    = dst;
+  op._a      = a;
+  op._b      = b;
+  op._c      = c;
+  op._imm    = imm;
+  op._mask   = mask;
+  _curops->push_back(op);
+}
+
+///////////////////////////////////////////////////
+
+uint32_t SimBackEnd::_emitTemp(SimOpCode opc, uint32_t a, uint32_t b, uint32_t c, uint64_t imm, size_t width) {
+  uint32_t dst = _allocSlots(1);
+  _emit(opc, dst, a, b, c, imm, simWidthMask(width));
+  return dst;
+}
+
+///////////////////////////////////////////////////
+// flatten the instance hierarchy
+///////////////////////////////////////////////////
+
+void SimBackEnd::_collectModule(Module* m, const std::string& path) {
+
+  _modules.push_back(m);
+  _modulepaths[m] = path;
+
+  for (auto item : m->_io) {
+    const auto& key = item.first;
+    const auto& var = item.second;
+
+    SimSignal sig;
+    sig._module = m;
+    sig._key    = key;
+    sig._name   = path + "." + key;
+
+    if (auto as = var.tryAs<Input>()) {
+      sig._width  = as.value()._size;
+      sig._signed = as.value()._signed;
+    } else if (auto as = var.tryAs<Output>()) {
+      sig._width    = as.value()._size;
+      sig._signed   = as.value()._signed;
+      sig._register = as.value()._register;
+    } else if (auto as = var.tryAs<Wire>()) {
+      sig._width  = as.value()._size;
+      sig._signed = as.value()._signed;
+    } else if (auto as = var.tryAs<Reg>()) {
+      sig._width    = as.value()._size;
+      sig._signed   = as.value()._signed;
+      sig._depth    = as.value()._depth;
+      sig._register = (sig._depth <= 1);
+    } else {
+      assert(false);
+    }
+
+    if (sig._width > 64) {
+      printf("SimBackEnd: signal<%s> width<%zu> exceeds 64 bits\n", sig._name.c_str(), sig._width);
+      assert(false);
+    }
+
+    if (sig._depth > 1) {
+      sig._slot = _allocSlots(sig._depth);
+    } else {
+      sig._slot = _allocSlots(1);
+      if (sig._register)
+        sig._nextslot = _allocSlots(1);
+    }
+
+    _signalmap[std::make_pair((const Module*)m, key)] = _signals.size();
+    _signals.push_back(sig);
+  }
+
+  for (auto c : m->_children)
+    _collectModule(c, path + "." + c->_name);
+}
+
+///////////////////////////////////////////////////
+
+bool SimBackEnd::_isSigned(const Rvalue& r) const {
+  if (auto as = r._payload.tryAs<Ref>())
+    return as.value().is_signed();
+  return r._payload.isA<KSIntC>();
+}
+
+///////////////////////////////////////////////////
+
+uint32_t SimBackEnd::_compileRefRead(const Ref& r) {
+
+  size_t isig     = _signalIndex(r._module, r._key);
+  const auto& sig = _signals[isig];
+  _curreads->insert(isig);
+
+  uint32_t slot = sig._slot;
+
+  ///////////////////////////
+  // addressed memory read
+  ///////////////////////////
+
+  if (auto addras = r._address.tryAs<ref_t>()) {
+    assert(sig._depth > 1);
+    uint32_t addr = _compileRefRead(*addras.value());
+    slot          = _emitTemp(SimOpCode::MEMREAD, addr, sig._slot, 0, sig._depth, sig._width);
+  }
+
+  ///////////////////////////
+  // sliced read
+  ///////////////////////////
+
+  if (r._slice_start >= 0 and r._slice_end >= 0) {
+    size_t width = 1 + (r._slice_end - r._slice_start);
+    slot         = _emitTemp(SimOpCode::SLICE, slot, 0, 0, uint64_t(r._slice_start), width);
+  }
+
+  return slot;
+}
+
+///////////////////////////////////////////////////
+
+uint32_t SimBackEnd::_compileRvalue(const Rvalue& r) {
+  if (auto as = r._payload.tryAs<expr_t>())
+    return _compileExpression(as.value());
+  if (auto as = r._payload.tryAs<Ref>())
+    return _compileRefRead(as.value());
+  if (auto as = r._payload.tryAs<KUIntC>())
+    return _constSlot(as.value()._value & simWidthMask(as.value()._size));
+  if (auto as = r._payload.tryAs<KSIntC>())
+    return _constSlot(uint64_t(as.value()._value) & simWidthMask(as.value()._size));
+  assert(false);
+  return 0;
+}
+
+///////////////////////////////////////////////////
+// AST -> word ops
+//  node types are resolved here, once, at compile time
+///////////////////////////////////////////////////
+
+uint32_t SimBackEnd::_compileExpression(expr_t e) {
+
+  auto as_node = e->_child.tryAs<astnode_t>();
+  assert(as_node);
+  AstNode* node = as_node.value().get();
+  size_t width  = node->bitwidth();
+
+  if (auto n = dynamic_cast<RefAstNode*>(node))
+    return _compileRefRead(n->_ref);
+
+  if (auto n = dynamic_cast<BinaryOp*>(node)) {
+    uint32_t a  = _compileRvalue(n->_lhs);
+    uint32_t b  = _compileRvalue(n->_rhs);
+    bool sgn    = _isSigned(n->_lhs) and _isSigned(n->_rhs);
+    uint64_t sw = n->_lhs.bitwidth();
+    if (dynamic_cast<OperationPlus*>(node))
+      return _emitTemp(SimOpCode::ADD, a, b, 0, 0, width);
+    if (dynamic_cast<OperationMinus*>(node))
+      return _emitTemp(SimOpCode::SUB, a, b, 0, 0, width);
+    if (dynamic_cast<OperationTimes*>(node))
+      return _emitTemp(SimOpCode::MUL, a, b, 0, 0, width);
+    if (dynamic_cast<OperationDividedBy*>(node))
+      return _emitTemp(SimOpCode::DIV, a, b, 0, 0, width);
+    if (dynamic_cast<OperationBitwiseAnd*>(node))
+      return _emitTemp(SimOpCode::AND, a, b, 0, 0, width);
+    if (dynamic_cast<OperationBitwiseOr*>(node))
+      return _emitTemp(SimOpCode::OR, a, b, 0, 0, width);
+    if (dynamic_cast<OperationShiftLeft*>(node))
+      return _emitTemp(SimOpCode::SHL, a, b, 0, 0, width);
+    if (dynamic_cast<OperationShiftRight*>(node))
+      return _emitTemp(SimOpCode::SHR, a, b, 0, 0, width);
+    if (dynamic_cast<OperationIsEqualTo*>(node))
+      return _emitTemp(SimOpCode::EQ, a, b, 0, 0, 1);
+    if (dynamic_cast<OperationNotEqualsTo*>(node))
+      return _emitTemp(SimOpCode::NE, a, b, 0, 0, 1);
+    if (dynamic_cast<OperationLessThan*>(node))
+      return _emitTemp(sgn ? SimOpCode::LTS : SimOpCode::LTU, a, b, 0, sw, 1);
+    if (dynamic_cast<OperationGreaterThan*>(node))
+      return _emitTemp(sgn ? SimOpCode::GTS : SimOpCode::GTU, a, b, 0, sw, 1);
+    printf("SimBackEnd: unsupported binary operator<%s>\n", n->_opname.c_str());
+    assert(false);
+  }
+
+  if (auto n = dynamic_cast<OperationNot*>(node)) {
+    uint32_t a = _compileRvalue(n->_inp);
+    return _emitTemp(SimOpCode::LNOT, a, 0, 0, 0, 1);
+  }
+
+  if (auto n = dynamic_cast<OperationSlice*>(node)) {
+    uint32_t a = _compileRvalue(n->_input);
+    return _emitTemp(SimOpCode::SLICE, a, 0, 0, n->_start, n->_width);
+  }
+
+  if (auto n = dynamic_cast<OperationLeftExtend*>(node)) {
+    uint32_t a = _compileRvalue(n->_input);
+    return _emitTemp(SimOpCode::MOV, a, 0, 0, 0, n->_width);
+  }
+
+  if (auto n = dynamic_cast<OperationRightExtend*>(node)) {
+    uint32_t a = _compileRvalue(n->_input);
+    return _emitTemp(SimOpCode::SHLI, a, 0, 0, n->_width - n->_input.bitwidth(), n->_width);
+  }
+
+  if (auto n = dynamic_cast<WrapNode*>(node)) {
+    uint32_t a = _compileExpression(n->_expr);
+    return _emitTemp(SimOpCode::MOV, a, 0, 0, 0, width);
+  }
+
+  if (auto n = dynamic_cast<SelectAstNode*>(node)) {
+    uint32_t s = _compileRvalue(n->_s);
+    uint32_t a = _compileRvalue(n->_a);
+    uint32_t b = _compileRvalue(n->_b);
+    return _emitTemp(SimOpCode::SELECT, s, a, b, 0, width);
+  }
+
+  if (auto n = dynamic_cast<ConcatAstNode*>(node)) {
+    uint32_t acc = _constSlot(0);
+    for (const auto& item : n->_input) {
+      uint32_t v = _compileRvalue(item);
+      acc        = _emitTemp(SimOpCode::CONCAT, acc, v, 0, item.bitwidth(), width);
+    }
+    return acc;
+  }
+
+  printf("SimBackEnd: unsupported expression node\n");
+  assert(false);
+  return 0;
+}
+
+///////////////////////////////////////////////////
+// AND of all enclosing if/case conditions
+///////////////////////////////////////////////////
+
+uint32_t SimBackEnd::_compilePredicate(const std::vector<SimPredTerm>& terms) {
+  uint32_t pred = _truslot;
+  for (const auto& term : terms) {
+    uint32_t t = 0;
+    if (term._switchsel) {
+      uint32_t sel = _compileExpression(term._switchsel);
+      t            = _emitTemp(SimOpCode::EQ, sel, _constSlot(term._caseval), 0, 0, 1);
+    } else {
+      uint32_t c = _compileExpression(term._cond);
+      t          = _emitTemp(term._negate ? SimOpCode::LNOT : SimOpCode::NEZ, c, 0, 0, 0, 1);
+    }
+    pred = (pred == _truslot) ? t : _emitTemp(SimOpCode::AND, pred, t, 0, 0, 1);
+  }
+  return pred;
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::_compileWrite(const Ref& lhs, uint32_t value, uint32_t pred, bool sync) {
+
+  size_t isig     = _signalIndex(lhs._module, lhs._key);
+  const auto& sig = _signals[isig];
+  bool sliced     = (lhs._slice_start >= 0 and lhs._slice_end >= 0);
+
+  ///////////////////////////
+  // memory writes are captured, then applied at commit
+  ///////////////////////////
+
+  if (auto addras = lhs._address.tryAs<ref_t>()) {
+    assert(sync and not sliced and sig._depth > 1);
+    uint32_t addr    = _compileRefRead(*addras.value());
+    uint32_t capture = _allocSlots(3);
+    _emit(SimOpCode::MEMCAPTURE, capture, addr, value, pred, 0, simWidthMask(sig._width));
+    SimOp commit;
+    commit._opcode = SimOpCode::MEMCOMMIT;
+    commit._dst    = sig._slot;
+    commit._a      = capture;
+    commit._imm    = sig._depth;
+    _commitmem.push_back(commit);
+    return;
+  }
+
+  ///////////////////////////
+  // registers take their value at the clock edge,
+  //  everything else is written in place
+  ///////////////////////////
+
+  uint32_t dst = (sync and sig._register) ? sig._nextslot : sig._slot;
+  if (sliced) {
+    size_t width = 1 + (lhs._slice_end - lhs._slice_start);
+    _emit(pred == _truslot ? SimOpCode::INSERT : SimOpCode::PINSERT, dst, value, 0, pred, lhs._slice_start, simWidthMask(width));
+  } else {
+    _emit(pred == _truslot ? SimOpCode::MOV : SimOpCode::PMOV, dst, value, 0, pred, 0, simWidthMask(sig._width));
+  }
+  if (not sync)
+    _curwrites->insert(isig);
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::_compileSegment(Segment* s, bool sync, std::vector<SimPredTerm> terms, uint32_t pred) {
+
+  for (auto expr : s->_exprs) {
+
+    auto as_node = expr->_child.tryAs<astnode_t>();
+    if (not as_node)
+      continue;
+    AstNode* node = as_node.value().get();
+
+    ///////////////////////////
+    if (auto n = dynamic_cast<AlwaysBlockNode*>(node)) {
+      _compileSegment(n->_seg.get(), true, {}, _truslot);
+    }
+    ///////////////////////////
+    else if (auto n = dynamic_cast<SyncAssignNode*>(node)) {
+      assert(sync);
+      uint32_t v = _compileRvalue(n->_rhs);
+      _compileWrite(n->_lhs, v, pred, true);
+    }
+    ///////////////////////////
+    else if (auto n = dynamic_cast<CombAssignNode*>(node)) {
+      if (sync) {
+        uint32_t v = _compileRvalue(n->_rhs);
+        _compileWrite(n->_lhs, v, pred, false);
+      } else {
+        _beginCombNode();
+        uint32_t p = _compilePredicate(terms);
+        uint32_t v = _compileRvalue(n->_rhs);
+        _compileWrite(n->_lhs, v, p, false);
+        _endCombNode();
+      }
+    }
+    ///////////////////////////
+    else if (auto n = dynamic_cast<IfNode*>(node)) {
+      std::vector<SimPredTerm> negated;
+      auto branch = [&](segment_t seg, expr_t cond) {
+        auto bterms = terms;
+        for (auto& item : negated)
+          bterms.push_back(item);
+        if (cond)
+          bterms.push_back(SimPredTerm{cond, false});
+        uint32_t bpred = sync ? _compilePredicate(bterms) : _truslot;
+        _compileSegment(seg.get(), sync, bterms, bpred);
+        if (cond)
+          negated.push_back(SimPredTerm{cond, true});
+      };
+      branch(n->_seg, n->_conditional);
+      for (auto& item : n->_elifitems)
+        branch(item._seg, item._conditional);
+      if (n->_elseseg)
+        branch(n->_elseseg, nullptr);
+    }
+    ///////////////////////////
+    else if (auto n = dynamic_cast<SwitchNode*>(node)) {
+      for (auto c : n->_casenodes) {
+        auto bterms = terms;
+        SimPredTerm term;
+        term._switchsel = n->_selector;
+        term._caseval   = c->_caseval._value & simWidthMask(c->_bitw);
+        bterms.push_back(term);
+        uint32_t bpred = sync ? _compilePredicate(bterms) : _truslot;
+        _compileSegment(c->_seg.get(), sync, bterms, bpred);
+      }
+    }
+    ///////////////////////////
+    // anything else (testbench stimulus, etc..)
+    //  is implied by the simulator itself
+    ///////////////////////////
+  }
+
+  for (auto c : s->_children) {
+    if (c->_noautoemit == false)
+      _compileSegment(c.get(), sync, terms, pred);
+  }
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::_beginCombNode() {
+  _combnodes.emplace_back();
+  auto& cn  = _combnodes.back();
+  _curops   = &cn._ops;
+  _curreads = &cn._reads;
+  _curwrites = &cn._writes;
+}
+void SimBackEnd::_endCombNode() {
+  _curops    = &_syncschedule;
+  _curreads  = &_scratchreads;
+  _curwrites = &_scratchwrites;
+}
+
+///////////////////////////////////////////////////
+// instance ports become combinational assignments
+///////////////////////////////////////////////////
+
+void SimBackEnd::_compilePorts(Module* m) {
+  for (auto c : m->_children) {
+    std::vector<std::string> portkeys;
+    for (auto var : c->_ios_ordered) {
+      if (auto as = var.tryAs<Input>())
+        portkeys.push_back(as.value()._key);
+      else if (auto as = var.tryAs<Output>())
+        portkeys.push_back(as.value()._key);
+    }
+    if (portkeys.size() != c->_instanceargs.size()) {
+      printf("Module<%s> Child<%s> Failed to connect all instance ports\n", m->_name.c_str(), c->_name.c_str());
+      assert(false);
+    }
+    for (size_t i = 0; i < portkeys.size(); i++) {
+      const auto& arg = c->_instanceargs[i];
+      Ref port(c, portkeys[i], &c->_io[portkeys[i]]);
+      _beginCombNode();
+      if (c->_io[portkeys[i]].isA<Input>()) {
+        uint32_t v = _compileRefRead(arg);
+        _compileWrite(port, v, _truslot, false);
+      } else {
+        uint32_t v = _compileRefRead(port);
+        _compileWrite(arg, v, _truslot, false);
+      }
+      _endCombNode();
+    }
+  }
+}
+
+///////////////////////////////////////////////////
+// order combinational nodes so every node runs
+//  after all the nodes that drive its inputs
+///////////////////////////////////////////////////
+
+void SimBackEnd::_levelize() {
+
+  size_t numnodes = _combnodes.size();
+  std::map<size_t, std::vector<size_t>> writers;
+  for (size_t i = 0; i < numnodes; i++)
+    for (auto isig : _combnodes[i]._writes)
+      writers[isig].push_back(i);
+
+  std::vector<std::vector<size_t>> fanout(numnodes);
+  std::vector<size_t> numdeps(numnodes, 0);
+  for (size_t i = 0; i < numnodes; i++) {
+    std::set<size_t> deps;
+    for (auto isig : _combnodes[i]._reads) {
+      auto it = writers.find(isig);
+      if (it == writers.end())
+        continue;
+      for (auto w : it->second)
+        if (w != i)
+          deps.insert(w);
+    }
+    numdeps[i] = deps.size();
+    for (auto d : deps)
+      fanout[d].push_back(i);
+  }
+
+  std::vector<size_t> ready;
+  for (size_t i = 0; i < numnodes; i++)
+    if (numdeps[i] == 0)
+      ready.push_back(i);
+
+  size_t numscheduled = 0;
+  while (not ready.empty()) {
+    std::vector<size_t> nextlevel;
+    for (auto i : ready) {
+      for (const auto& op : _combnodes[i]._ops)
+        _combschedule.push_back(op);
+      numscheduled++;
+      for (auto f : fanout[i])
+        if (--numdeps[f] == 0)
+          nextlevel.push_back(f);
+    }
+    _numlevels++;
+    ready = nextlevel;
+  }
+
+  if (numscheduled != numnodes) {
+    printf("SimBackEnd: combinational loop detected (%zu of %zu nodes levelized)\n", numscheduled, numnodes);
+    assert(false);
+  }
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::visitRootModule(Module& root) {
+
+  _root = &root;
+  _curops    = &_syncschedule;
+  _curreads  = &_scratchreads;
+  _curwrites = &_scratchwrites;
+
+  _collectModule(&root, root._name);
+  _truslot = _constSlot(1);
+
+  ///////////////////////////
+  // registers sample their current value at the start
+  //  of each cycle, conditional writes override it
+  ///////////////////////////
+
+  for (const auto& sig : _signals) {
+    if (sig._register) {
+      _emit(SimOpCode::MOV, sig._nextslot, sig._slot, 0, 0, 0, simWidthMask(sig._width));
+      SimOp commit;
+      commit._opcode = SimOpCode::MOV;
+      commit._dst    = sig._slot;
+      commit._a      = sig._nextslot;
+      commit._mask   = simWidthMask(sig._width);
+      _commitschedule.push_back(commit);
+    }
+  }
+
+  for (auto m : _modules) {
+    _compilePorts(m);
+    _compileSegment(m->_rootsegment.get(), false, {}, _truslot);
+  }
+
+  for (const auto& op : _commitmem)
+    _commitschedule.push_back(op);
+
+  _levelize();
+
+  ///////////////////////////
+  // the testbench clock register is driven by the simulator
+  ///////////////////////////
+
+  auto itclk = _signalmap.find(std::make_pair((const Module*)&root, std::string("sysclock")));
+  if (itclk != _signalmap.end())
+    _clocksignal = itclk->second;
+
+  printf(
+      "SimBackEnd<%s> signals<%zu> slots<%zu> combops<%zu> comblevels<%zu> syncops<%zu> commitops<%zu>\n",
+      root._name.c_str(),
+      _signals.size(),
+      _numslots,
+      _combschedule.size(),
+      _numlevels,
+      _syncschedule.size(),
+      _commitschedule.size());
+
+  reset();
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::reset() {
+
+  _state.assign(_numslots, 0);
+  for (auto item : _constslots)
+    _state[item.second] = item.first;
+
+  ///////////////////////////
+  // memory initializers
+  ///////////////////////////
+
+  for (auto m : _modules) {
+    for (auto item : m->_initialAsts) {
+      auto meminit = dynamic_cast<MemInit*>(item.get());
+      if (nullptr == meminit)
+        continue;
+      auto storage    = meminit->_storage;
+      const auto& sig = _signals[_signalIndex(storage->_storage->_module, storage->_storage->_key)];
+      size_t count    = std::min(storage->_initdatalength, sig._depth);
+      for (size_t i = 0; i < count; i++)
+        _state[sig._slot + i] = uint64_t(uint8_t(storage->_initdata[i])) & simWidthMask(sig._width);
+    }
+  }
+
+  ///////////////////////////
+  // an open VCD keeps going : cycle 0 of the new run
+  //  is placed one cycle after the last traced time
+  ///////////////////////////
+
+  if (_vcdout)
+    _vcdtimebase += _cycle * 10 + 10;
+  _cycle = 0;
+  _execute(_combschedule);
+  if (_vcdout)
+    _traceVcd(_vcdtimebase, true);
+}
+
+///////////////////////////////////////////////////
+// the entire simulation runs through this loop
+///////////////////////////////////////////////////
+
+void SimBackEnd::_execute(const std::vector<SimOp>& schedule) {
+  uint64_t* st   = _state.data();
+  for (const SimOp& op : schedule) {
+    uint64_t a = st[op._a];
+    uint64_t b = st[op._b];
+    switch (op._opcode) {
+      case SimOpCode::MOV:
+        st[op._dst] = a & op._mask;
+        break;
+      case SimOpCode::AND:
+        st[op._dst] = (a & b) & op._mask;
+        break;
+      case SimOpCode::OR:
+        st[op._dst] = (a | b) & op._mask;
+        break;
+      case SimOpCode::ADD:
+        st[op._dst] = (a + b) & op._mask;
+        break;
+      case SimOpCode::SUB:
+        st[op._dst] = (a - b) & op._mask;
+        break;
+      case SimOpCode::MUL:
+        st[op._dst] = (a * b) & op._mask;
+        break;
+      case SimOpCode::DIV:
+        st[op._dst] = (b ? (a / b) : 0) & op._mask;
+        break;
+      case SimOpCode::SHL:
+        st[op._dst] = ((b < 64) ? (a << b) : 0) & op._mask;
+        break;
+      case SimOpCode::SHR:
+        st[op._dst] = ((b < 64) ? (a >> b) : 0) & op._mask;
+        break;
+      case SimOpCode::SHLI:
+        st[op._dst] = (a << op._imm) & op._mask;
+        break;
+      case SimOpCode::SLICE:
+        st[op._dst] = (a >> op._imm) & op._mask;
+        break;
+      case SimOpCode::CONCAT:
+        st[op._dst] = ((a << op._imm) | b) & op._mask;
+        break;
+      case SimOpCode::EQ:
+        st[op._dst] = (a == b);
+        break;
+      case SimOpCode::NE:
+        st[op._dst] = (a != b);
+        break;
+      case SimOpCode::NEZ:
+        st[op._dst] = (a != 0);
+        break;
+      case SimOpCode::LNOT:
+        st[op._dst] = (a == 0);
+        break;
+      case SimOpCode::LTU:
+        st[op._dst] = (a < b);
+        break;
+      case SimOpCode::GTU:
+        st[op._dst] = (a > b);
+        break;
+      case SimOpCode::LTS:
+      case SimOpCode::GTS: {
+        int shift = 64 - int(op._imm);
+        int64_t sa = int64_t(a << shift) >> shift;
+        int64_t sb = int64_t(b << shift) >> shift;
+        st[op._dst] = (op._opcode == SimOpCode::LTS) ? (sa < sb) : (sa > sb);
+        break;
+      }
+      case SimOpCode::SELECT:
+        st[op._dst] = (a ? b : st[op._c]) & op._mask;
+        break;
+      case SimOpCode::INSERT:
+        st[op._dst] = (st[op._dst] & ~(op._mask << op._imm)) | ((a & op._mask) << op._imm);
+        break;
+      case SimOpCode::PMOV:
+        if (st[op._c])
+          st[op._dst] = a & op._mask;
+        break;
+      case SimOpCode::PINSERT:
+        if (st[op._c])
+          st[op._dst] = (st[op._dst] & ~(op._mask << op._imm)) | ((a & op._mask) << op._imm);
+        break;
+      case SimOpCode::MEMREAD:
+        st[op._dst] = st[op._b + (a % op._imm)] & op._mask;
+        break;
+      case SimOpCode::MEMCAPTURE:
+        st[op._dst + 0] = st[op._c];
+        st[op._dst + 1] = a;
+        st[op._dst + 2] = b & op._mask;
+        break;
+      case SimOpCode::MEMCOMMIT:
+        if (st[op._a]) {
+          st[op._dst + (st[op._a + 1] % op._imm)] = st[op._a + 2];
+          st[op._a]                               = 0;
+        }
+        break;
+    }
+  }
+}
+
+///////////////////////////////////////////////////
+// one sysclock posedge
+///////////////////////////////////////////////////
+
+void SimBackEnd::step() {
+  _execute(_syncschedule);
+  _execute(_commitschedule);
+  _execute(_combschedule);
+  _cycle++;
+  if (_vcdout) {
+    _traceVcd(_vcdtimebase + _cycle * 10 - 5, true);
+    _traceVcd(_vcdtimebase + _cycle * 10, false);
+  }
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::run(size_t numcycles) {
+  for (size_t i = 0; i < numcycles; i++)
+    step();
+}
+
+///////////////////////////////////////////////////
+
+uint64_t SimBackEnd::read(const Module* m, const std::string& key) const {
+  return _state[_signals[_signalIndex(m, key)]._slot];
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::write(const Module* m, const std::string& key, uint64_t value) {
+  const auto& sig    = _signals[_signalIndex(m, key)];
+  _state[sig._slot] = value & simWidthMask(sig._width);
+  _execute(_combschedule);
+}
+
+///////////////////////////////////////////////////
+// direct VCD output
+///////////////////////////////////////////////////
+
+void SimBackEnd::openVcd(const std::string& path) {
+  closeVcd();
+  _vcdout = fopen(path.c_str(), "wt");
+  assert(_vcdout != nullptr);
+
+  auto vcdid = [](size_t index) -> std::string {
+    std::string rval;
+    do {
+      rval.push_back(char('!' + (index % 94)));
+      index /= 94;
+    } while (index);
+    return rval;
+  };
+
+  fprintf(_vcdout, "$timescale 1ns $end\n");
+  _vcdids.clear();
+  _vcdids.resize(_signals.size());
+  for (auto m : _modules) {
+    auto path = _modulepaths[m];
+    std::replace(path.begin(), path.end(), '.', '_');
+    fprintf(_vcdout, "$scope module %s $end\n", path.c_str());
+    for (size_t i = 0; i < _signals.size(); i++) {
+      const auto& sig = _signals[i];
+      if (sig._module != m or sig._depth > 1)
+        continue;
+      _vcdids[i] = vcdid(i);
+      fprintf(
+          _vcdout, //
+          "$var %s %zu %s %s $end\n",
+          sig._register ? "reg" : "wire",
+          sig._width,
+          _vcdids[i].c_str(),
+          sig._key.c_str());
+    }
+    fprintf(_vcdout, "$upscope $end\n");
+  }
+  fprintf(_vcdout, "$enddefinitions $end\n");
+  _vcdvalues.assign(_signals.size(), ~uint64_t(0));
+  _traceVcd(_vcdtimebase + _cycle * 10, true);
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::closeVcd() {
+  if (_vcdout) {
+    fclose(_vcdout);
+    _vcdout = nullptr;
+  }
+}
+
+///////////////////////////////////////////////////
+
+void SimBackEnd::_traceVcd(uint64_t timestamp, bool clocklevel) {
+  if (_clocksignal != size_t(-1))
+    _state[_signals[_clocksignal]._slot] = clocklevel ? 1 : 0;
+  bool stamped = false;
+  for (size_t i = 0; i < _signals.size(); i++) {
+    if (_vcdids[i].empty())
+      continue;
+    const auto& sig = _signals[i];
+    uint64_t value  = _state[sig._slot];
+    if (value == _vcdvalues[i])
+      continue;
+    if (not stamped) {
+      fprintf(_vcdout, "#%zu\n", size_t(timestamp));
+      stamped = true;
+    }
+    _vcdvalues[i] = value;
+    if (sig._width == 1) {
+      fprintf(_vcdout, "%c%s\n", (value & 1) ? '1' : '0', _vcdids[i].c_str());
+    } else {
+      char bits[65];
+      for (size_t b = 0; b < sig._width; b++)
+        bits[b] = ((value >> (sig._width - 1 - b)) & 1) ? '1' : '0';
+      bits[sig._width] = 0;
+      fprintf(_vcdout, "b%s %s\n", bits, _vcdids[i].c_str());
+    }
+  }
+}
+
+}} // namespace ork::hdl
@@ -8,8 +8,8 @@
 #pragma once
 
 #include <ork/file/path.h>
-#include <ork/util/scanner.h>
 #include <unordered_map>
+#include <string_view>
 
 namespace ork::hdl::vcd {
 ////////////////////////////////////////////////////////////////////////////////
@@ -17,6 +17,7 @@ struct Signal;
 struct Scope;
 struct File;
 struct Sample;
+struct SampleStore;
 ////////////////////////////////////////////////////////////////////////////////
 using signal_ptr_t = std::shared_ptr<Signal>;
 using scope_ptr_t  = std::shared_ptr<Scope>;
@@ -28,7 +29,7 @@ enum class LineState { FALSE, TRUE, X, Z };
 ////////////////////////////////////////////////////////////////////////////////
 struct Sample {
   Sample() {
-    for (int i = 0; i < kmaxbitlen; i++)
+    for (size_t i = 0; i < kmaxbitlen; i++)
       _bits[i] = LineState::FALSE;
   }
   void left_extend(int width);
@@ -39,6 +40,101 @@ struct Sample {
   int _numbits = 0;
 };
 ////////////////////////////////////////////////////////////////////////////////
+// 4-state value as two bit planes
+//  FALSE : value=0 unknown=0
+//  TRUE  : value=1 unknown=0
+//  X     : value=0 unknown=1
+//  Z     : value=1 unknown=1
+////////////////////////////////////////////////////////////////////////////////
+struct PackedValue {
+  static PackedValue fromSample(const Sample& s);
+  Sample toSample(int width) const;
+  LineState read(int bit) const;
+  bool operator==(const PackedValue& rhs) const {
+    return (_value == rhs._value) and (_unknown == rhs._unknown);
+  }
+  uint64_t _value   = 0;
+  uint64_t _unknown = 0;
+};
+////////////////////////////////////////////////////////////////////////////////
+// summary of all transitions within a span of time
+//  used both for pyramid buckets and for rendered bins
+////////////////////////////////////////////////////////////////////////////////
+struct EnvelopeBucket {
+  uint64_t _time           = 0; // time of first transition in span
+  uint64_t _minval         = 0; // min/max of value plane
+  uint64_t _maxval         = 0;
+  PackedValue _last;            // value in effect at end of span
+  uint32_t _numtransitions = 0;
+  bool _unknown            = false; // any X/Z seen within span
+};
+////////////////////////////////////////////////////////////////////////////////
+struct EnvelopeLevel {
+  int _shift = 0; // bucket width is (1<<_shift) time units
+  std::vector<EnvelopeBucket> _buckets;
+};
+////////////////////////////////////////////////////////////////////////////////
+// columnar storage of a single signal's transitions
+//  timestamps : LEB128 delta encoded, absolute checkpoint every
+//               kTimeCheckpointInterval samples for random access
+//  values     : bit packed, 2*width bits per sample (value, unknown planes)
+//  pyramid    : sparse min/max envelope levels, fanout of 4 per level,
+//               built by finalize(). envelope() queries are O(bins)
+////////////////////////////////////////////////////////////////////////////////
+struct SampleStore {
+
+  static constexpr size_t kTimeCheckpointInterval = 64;
+  static constexpr size_t kMinSamplesPerBucket    = 32;
+  static constexpr int kLevelFanoutShift          = 2;
+  static constexpr size_t NOINDEX                 = ~size_t(0);
+
+  void init(int bit_width);
+  void append(uint64_t timestamp, const PackedValue& value);
+  void finalize();
+
+  size_t size() const {
+    return _numsamples;
+  }
+  bool empty() const {
+    return _numsamples == 0;
+  }
+  uint64_t firstTime() const;
+  uint64_t lastTime() const {
+    return _lasttime;
+  }
+
+  uint64_t timeAt(size_t index) const;
+  PackedValue valueAt(size_t index) const;
+  Sample sampleAt(size_t index) const;
+
+  size_t indexAtOrBefore(uint64_t timestamp) const; // NOINDEX if before first sample
+  size_t nearestIndex(uint64_t timestamp) const;
+
+  // summarize [t0,t1) into numbins equal width bins
+  void envelope(uint64_t t0, uint64_t t1, size_t numbins, std::vector<EnvelopeBucket>& bins_out) const;
+
+  size_t memoryFootprint() const;
+
+  int _bit_width     = 0;
+  size_t _numsamples = 0;
+  uint64_t _lasttime = 0;
+
+  struct TimeCheckpoint {
+    uint64_t _time       = 0;
+    uint64_t _byteoffset = 0;
+  };
+
+  std::vector<uint8_t> _timedeltas;
+  std::vector<TimeCheckpoint> _checkpoints;
+  std::vector<uint64_t> _valuebits;
+  std::vector<EnvelopeLevel> _levels;
+
+private:
+  template <typename fn_t> void _visit(size_t first, size_t last, fn_t fn) const;
+  void _writeBits(size_t bitoffset, int numbits, uint64_t value);
+  uint64_t _readBits(size_t bitoffset, int numbits) const;
+};
+////////////////////////////////////////////////////////////////////////////////
 struct Signal {
 
   std::string _type      = "none";
@@ -46,7 +142,7 @@ struct Signal {
   std::string _longname  = "";
   int _bit_width         = 0;
   int _word_width        = 0;
-  std::map<uint64_t, sample_ptr_t> _samples;
+  SampleStore _samples;
 };
 ////////////////////////////////////////////////////////////////////////////////
 struct Scope {
@@ -56,14 +152,23 @@ struct Scope {
   std::map<std::string, scope_ptr_t> _child_scopes;
 };
 ////////////////////////////////////////////////////////////////////////////////
+// streaming VCD reader
+//  the input is consumed in fixed size chunks, memory use is
+//  proportional to the number of transitions, not the file size
+////////////////////////////////////////////////////////////////////////////////
 struct File {
+  static constexpr size_t kReadChunkSize = 4 << 20;
   File();
   void parse(ork::file::Path& path);
-  Scanner _scanner;
+  void parseBuffer(const char* data, size_t length);
   scope_ptr_t _root;
   std::map<std::string, scope_ptr_t> _child_scopes;
   std::map<std::string, signal_ptr_t> _signals_by_shortname;
-  std::set<size_t> _timestamps;
+  std::string _timescale;
+  uint64_t _min_timestamp = 0;
+  uint64_t _max_timestamp = 0;
+  size_t _numtimestamps   = 0;
+  size_t _numtransitions  = 0;
 };
 ////////////////////////////////////////////////////////////////////////////////
 } // namespace ork::hdl::vcd
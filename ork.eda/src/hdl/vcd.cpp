@@ -8,327 +8,282 @@
 #include <ork/hdl/vcd.h>
 #include <ork/file/file.h>
 #include <stack>
-#include <ork/util/crc.h>
-
 
 namespace ork::hdl::vcd {
 ////////////////////////////////////////////////////////////////////////////////
-File::File()
-    : _scanner("") {
+File::File() {
 }
 ////////////////////////////////////////////////////////////////////////////////
-enum class TokenClass : uint64_t {
-  CrcEnum(SECTION),
-  CrcEnum(IDENTIFIER),
-  CrcEnum(TIMESTAMP),
-  CrcEnum(BITVECTOR),
-  CrcEnum(NUMBER),
-  CrcEnum(OPENBRACKET),
-  CrcEnum(CLOSEBRACKET),
-  CrcEnum(COLON),
-  CrcEnum(WHITESPACE),
-  CrcEnum(NEWLINE),
-  CrcEnum(PRINTABLE),
-  CrcEnum(UNKNOWN),
-};
+// streaming tokenizer / parser state
+//  VCD is whitespace delimited, so tokens are split directly out of
+//  each input chunk. only a token straddling a chunk boundary is copied.
 ////////////////////////////////////////////////////////////////////////////////
-enum class ParseState {
-  INIT = 0, //
-  SECTION,
-  TIMESTAMP,
-  VALUE,
-  KEY
+namespace {
+enum class PendingValue {
+  NONE = 0, //
+  VECTOR,
+  REAL
 };
 ////////////////////////////////////////////////////////////////////////////////
-void File::parse(ork::file::Path& inppath) {
-
-  _root = std::make_shared<Scope>();
-
-  ::ork::File vcdfile(inppath, EFM_READ);
-  size_t length = 0;
-  vcdfile.GetLength(length);
-  std::string vcdstr;
-  vcdstr.resize(length + 1);
+inline bool is_vcd_space(char ch) {
+  return (ch == ' ') or (ch == '\t') or (ch == '\n') or (ch == '\r');
+}
+////////////////////////////////////////////////////////////////////////////////
+struct Ingestor {
 
-  _scanner.resize(length + 1);
-  vcdfile.Read(_scanner._fxbuffer.data(), length);
-  _scanner._fxbuffer.data()[length] = 0;
-  _scanner.ifilelen                 = length;
-  _scanner._quotedstrings           = false;
+  Ingestor(File& file)
+      : _file(file) {
+    _file._root = std::make_shared<Scope>();
+    _scope_stack.push(_file._root);
+  }
 
-  _scanner.addRule("$[a-z]+", uint64_t(TokenClass::SECTION));
-  _scanner.addRule("[bB][0-1xz]+", uint64_t(TokenClass::BITVECTOR));
-  _scanner.addRule("#[0-9]+", uint64_t(TokenClass::TIMESTAMP));
-  _scanner.addRule("\\s+", uint64_t(TokenClass::WHITESPACE));
-  _scanner.addRule("\\n+", uint64_t(TokenClass::NEWLINE));
-  //_scanner.addRule("[a-zA-Z_]+[a-zA-Z0-9_]+", uint64_t(TokenClass::IDENTIFIER));
-  _scanner.addRule("[!-~]+", uint64_t(TokenClass::PRINTABLE));
-  _scanner.addRule("[0-9]+", uint64_t(TokenClass::NUMBER));
-  _scanner.addRule("\\[", uint64_t(TokenClass::OPENBRACKET));
-  _scanner.addRule("\\]", uint64_t(TokenClass::CLOSEBRACKET));
-  _scanner.addRule(":", uint64_t(TokenClass::COLON));
-  _scanner.buildStateMachine();
+  //////////////////////////////////////////////////////////
+  void feed(const char* data, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+      while (i < length and is_vcd_space(data[i])) {
+        if (not _partial.empty()) {
+          onToken(_partial);
+          _partial.clear();
+        }
+        i++;
+      }
+      size_t start = i;
+      while (i < length and not is_vcd_space(data[i]))
+        i++;
+      if (i == start)
+        continue;
+      std::string_view tok(data + start, i - start);
+      if (i == length) // may continue in next chunk
+        _partial.append(tok);
+      else if (_partial.empty())
+        onToken(tok);
+      else {
+        _partial.append(tok);
+        onToken(_partial);
+        _partial.clear();
+      }
+    }
+  }
 
-  _scanner.scan();
+  //////////////////////////////////////////////////////////
+  void finish() {
+    if (not _partial.empty()) {
+      onToken(_partial);
+      _partial.clear();
+    }
+    for (auto item : _file._signals_by_shortname)
+      item.second->_samples.finalize();
+    OrkAssert(_scope_stack.top() == _file._root);
+  }
 
-  size_t numtoks = _scanner.tokens.size();
-  ////////////////////////////////////
-  auto find_end = [&](size_t start) -> size_t {
-    size_t index = start;
-    while (index < numtoks) {
-      auto& tok = _scanner.tokens[index].text;
+  //////////////////////////////////////////////////////////
+  void onToken(std::string_view tok) {
+    ///////////////////////////////
+    // header sections collect tokens until $end
+    ///////////////////////////////
+    if (not _section.empty()) {
       if (tok == "$end") {
-        return index + 1;
+        _endSection();
+        _section.clear();
+        _sectargs.clear();
+      } else
+        _sectargs.emplace_back(tok);
+      return;
+    }
+    ///////////////////////////////
+    // vector/real value awaiting its identifier
+    ///////////////////////////////
+    if (_pending != PendingValue::NONE) {
+      if (_pending == PendingValue::VECTOR) {
+        _applyVector(_pendingvalue, tok);
       }
-      index++;
+      _pending = PendingValue::NONE;
+      return;
     }
-    return 0;
-  };
-  std::map<std::string, std::string> varmap;
-  ////////////////////////////////////
-  ParseState parse_state = ParseState::INIT;
-  size_t cur_timestamp   = 0;
-  std::stack<scope_ptr_t> scope_stack;
-  scope_stack.push(_root);
-  ////////////////////////////////////
-  sample_ptr_t cursample;
-  ////////////////////////////////////
-  size_t index               = 0;
-  std::string __prev_section = "";
-  while (index < numtoks) {
-    auto& tok     = _scanner.tokens[index];
-    auto& toktext = tok.text;
-    auto tokclass = TokenClass(tok._class);
-    switch (tokclass) {
-      case TokenClass::SECTION: {
-        parse_state = ParseState::SECTION;
-        ///////////////////////////////
-        if (toktext == "$date") {
-          printf("DATE\n");
-        }
-        ///////////////////////////////
-        else if (toktext == "$version") {
-          printf("VERSION\n");
-        }
-        ///////////////////////////////
-        else if (toktext == "$timescale") {
-          auto val  = _scanner.tokens[index + 2].text;
-          auto unit = _scanner.tokens[index + 3].text;
-          int ival  = atoi(val.c_str());
-          printf("index<%zu> TIMESCALE %s %s\n", index, val.c_str(), unit.c_str());
-        }
-        ///////////////////////////////
-        else if (toktext == "$scope") {
-
-          auto top = scope_stack.top();
-
-          auto type    = _scanner.tokens[index + 2].text;
-          auto named   = _scanner.tokens[index + 4].text;
-          auto scope   = std::make_shared<Scope>();
-          scope->_type = type;
-          scope->_name = named;
-
-          top->_child_scopes[named] = scope;
-          scope_stack.push(scope);
-
-          printf("index<%zu> SCOPE\n", index);
-        }
-        ///////////////////////////////
-        else if (toktext == "$upscope") {
-          printf("index<%zu> UPSCOPE\n", index);
-          scope_stack.pop();
-        }
-        ///////////////////////////////
-        else if (toktext == "$var") {
-          auto vartype  = _scanner.tokens[index + 2];
-          auto varwidth = _scanner.tokens[index + 4];
-          auto varshort = _scanner.tokens[index + 6];
-          auto varlong  = _scanner.tokens[index + 8];
-          printf(
-              "index<%zu> VARDECL: %s -> %s\n", //
-              index,
-              varshort.text.c_str(),
-              varlong.text.c_str());
-          varmap[varshort.text] = varlong.text;
-
-          auto sig         = std::make_shared<Signal>();
-          sig->_shortname  = varshort.text;
-          sig->_longname   = varlong.text;
-          sig->_type       = vartype.text;
-          sig->_bit_width  = atoi(varwidth.text.c_str());
-          sig->_word_width = sig->_bit_width >> 6;
-
-          _signals_by_shortname[varshort.text] = sig;
-
-          auto top                    = scope_stack.top();
-          top->_signals[varlong.text] = sig;
-
-          OrkAssert(sig->_bit_width <= kmaxbitlen);
-        }
-        ///////////////////////////////
-        else if (toktext == "$enddefinitions") {
-          printf("index<%zu> ENDDEFINITIONS\n", index);
-        }
-        ///////////////////////////////
-        else if (toktext == "$dumpvars") {
-          printf("index<%zu> DUMPVARS\n", index);
-          index++;
-          parse_state = ParseState::VALUE;
+    ///////////////////////////////
+    switch (tok[0]) {
+      case '$':
+        if (tok == "$end" or tok == "$dumpvars" or tok == "$dumpall" or tok == "$dumpon" or tok == "$dumpoff")
           break;
+        _section = tok;
+        break;
+      case '#': {
+        uint64_t timeval = 0;
+        for (size_t i = 1; i < tok.length(); i++) {
+          OrkAssert(tok[i] >= '0' and tok[i] <= '9');
+          timeval = timeval * 10 + uint64_t(tok[i] - '0');
         }
-        ///////////////////////////////
-        else if (toktext == "$end") {
-          if (__prev_section == "$dumpvars") {
-            index++;
-            break;
-          }
-        }
-        ///////////////////////////////
-        else {
-          OrkAssert(false);
-        }
-        __prev_section = toktext;
-        size_t end     = find_end(index);
-        if (end)
-          index = end;
-        parse_state = ParseState::VALUE;
+        if (_file._numtimestamps == 0)
+          _file._min_timestamp = timeval;
+        _file._max_timestamp = std::max(_file._max_timestamp, timeval);
+        _file._numtimestamps++;
+        _curtime = timeval;
         break;
       }
-      case TokenClass::WHITESPACE:
-        index++;
+      case 'b':
+      case 'B':
+        _pending = PendingValue::VECTOR;
+        _pendingvalue.assign(tok.substr(1));
         break;
-      case TokenClass::NEWLINE:
-        index++;
+      case 'r':
+      case 'R':
+        // real valued signals are not supported, skip its identifier
+        _pending = PendingValue::REAL;
         break;
-      case TokenClass::PRINTABLE: {
-        switch (parse_state) {
-          case ParseState::KEY: {
-            auto top = scope_stack.top();
-
-            auto it = _signals_by_shortname.find(toktext);
-            OrkAssert(it != _signals_by_shortname.end());
-            auto sig = it->second;
-            printf("index<%zu> SIG<%s:%d:%s>\n", index, sig->_type.c_str(), sig->_bit_width, sig->_longname.c_str());
-            cursample->left_extend(sig->_bit_width);
-            sig->_samples[cur_timestamp] = cursample;
-            cursample                    = nullptr;
-            parse_state                  = ParseState::VALUE;
-            break;
-          }
-          case ParseState::VALUE: {
-            parse_state = ParseState::KEY;
-
-            bool starts_bool =
-                (toktext[0] == '0'    //
-                 or toktext[0] == '1' //
-                 or toktext[0] == 'x' //
-                 or toktext[0] == 'z');
-
-            OrkAssert(starts_bool);
-
-            char ch = toktext[0];
-
-            printf("mushed VALUE: %c\n", ch);
-            LineState lstate;
-            switch (ch) {
-              case '0':
-                lstate = LineState::FALSE;
-                break;
-              case '1':
-                lstate = LineState::TRUE;
-                break;
-              case 'x':
-                lstate = LineState::X;
-                break;
-              case 'z':
-                lstate = LineState::Z;
-                break;
-              default:
-                lstate = LineState::FALSE;
-                OrkAssert(false);
-                break;
-            }
-
-            auto key = toktext.substr(1);
-            auto it  = _signals_by_shortname.find(key);
-            OrkAssert(it != _signals_by_shortname.end());
-            auto sig            = it->second;
-            cursample           = std::make_shared<Sample>();
-            cursample->_numbits = 1;
-            cursample->write(0, lstate);
-            cursample->left_extend(sig->_bit_width);
-
-            printf(
-                "mushed SIG<%s:%d:%s>\n", //
-                sig->_type.c_str(),
-                sig->_bit_width,
-                sig->_longname.c_str());
-
-            sig->_samples[cur_timestamp] = cursample;
-            cursample                    = nullptr;
-            parse_state                  = ParseState::VALUE;
-
-            break;
-          }
-          default: {
-            OrkAssert(false);
-            break;
-          }
-        }
-        index++;
+      case '0':
+      case '1':
+      case 'x':
+      case 'X':
+      case 'z':
+      case 'Z':
+        _applyVector(tok.substr(0, 1), tok.substr(1));
         break;
+      default:
+        OrkAssert(false);
+        break;
+    }
+  }
+
+  //////////////////////////////////////////////////////////
+  void _endSection() {
+    if (_section == "$timescale") {
+      _file._timescale.clear();
+      for (auto& item : _sectargs)
+        _file._timescale += item;
+    } else if (_section == "$scope") {
+      OrkAssert(_sectargs.size() >= 2);
+      auto top     = _scope_stack.top();
+      auto scope   = std::make_shared<Scope>();
+      scope->_type = _sectargs[0];
+      scope->_name = _sectargs[1];
+      top->_child_scopes[scope->_name] = scope;
+      _scope_stack.push(scope);
+    } else if (_section == "$upscope") {
+      _scope_stack.pop();
+    } else if (_section == "$var") {
+      OrkAssert(_sectargs.size() >= 4);
+      const auto& varshort = _sectargs[2];
+      const auto& varlong  = _sectargs[3];
+      auto top             = _scope_stack.top();
+      /////////////////////////////
+      // multiple vars may alias one identifier
+      /////////////////////////////
+      auto it = _file._signals_by_shortname.find(varshort);
+      if (it != _file._signals_by_shortname.end()) {
+        top->_signals[varlong] = it->second;
+        return;
       }
-      case TokenClass::BITVECTOR: {
-        OrkAssert(parse_state == ParseState::VALUE);
-        int numbitsinsample = toktext.length() - 1;
-        printf("index<%zu> BITVECTOR<%d:%s>\n", index, numbitsinsample, toktext.c_str());
-        cursample           = std::make_shared<Sample>();
-        cursample->_numbits = numbitsinsample;
-        for (int ibit = 0; ibit < numbitsinsample; ibit++) {
-          char bitval = toktext[ibit + 1];
-          int abit    = (numbitsinsample - 1) - ibit;
-          switch (bitval) {
-            case '0':
-              cursample->write(abit, LineState::FALSE);
-              break;
-            case '1': {
-              cursample->write(abit, LineState::TRUE);
-              break;
-            }
-            case 'x': {
-              cursample->write(abit, LineState::X);
-              break;
-            }
-            case 'z': {
-              cursample->write(abit, LineState::Z);
-              break;
-            }
-            default:
-              OrkAssert(false);
-              break;
-          }
-        }
+      auto sig         = std::make_shared<Signal>();
+      sig->_shortname  = varshort;
+      sig->_longname   = varlong;
+      sig->_type       = _sectargs[0];
+      sig->_bit_width  = atoi(_sectargs[1].c_str());
+      sig->_word_width = sig->_bit_width >> 6;
+      OrkAssert(size_t(sig->_bit_width) <= kmaxbitlen);
+      sig->_samples.init(sig->_bit_width);
+      _file._signals_by_shortname[varshort] = sig;
+      _signals_by_id[varshort]              = sig.get();
+      top->_signals[varlong]                = sig;
+    }
+    // $date, $version, $comment, $enddefinitions : nothing to retain
+  }
 
-        index++;
-        parse_state = ParseState::KEY;
-        break;
+  //////////////////////////////////////////////////////////
+  // bits are msb first, left extended to the signal width
+  //  https://www.eg.bucknell.edu/~csci320/2016-fall/wp-content/uploads/2015/08/verilog-std-1364-2005.pdf
+  //  page 331
+  //////////////////////////////////////////////////////////
+  void _applyVector(std::string_view bits, std::string_view id) {
+    _idbuf.assign(id);
+    auto it = _signals_by_id.find(_idbuf);
+    OrkAssert(it != _signals_by_id.end());
+    auto sig = it->second;
+
+    int numbits = int(bits.length());
+    OrkAssert(numbits > 0 and size_t(numbits) <= kmaxbitlen);
+    PackedValue v;
+    for (int i = 0; i < numbits; i++) {
+      uint64_t mask = uint64_t(1) << ((numbits - 1) - i);
+      switch (bits[i]) {
+        case '0':
+          break;
+        case '1':
+          v._value |= mask;
+          break;
+        case 'x':
+        case 'X':
+          v._unknown |= mask;
+          break;
+        case 'z':
+        case 'Z':
+          v._value |= mask;
+          v._unknown |= mask;
+          break;
+        default:
+          OrkAssert(false);
+          break;
       }
-      case TokenClass::TIMESTAMP: {
-        auto timestr  = toktext.substr(1);
-        auto timeval  = size_t(atol(timestr.c_str()));
-        cur_timestamp = timeval;
-        _timestamps.insert(timeval);
-        printf("index<%zu> TIMESTAMP<%zu>\n", index, cur_timestamp);
-        parse_state = ParseState::VALUE;
-        index++;
-        break;
+    }
+    if (numbits < sig->_bit_width) {
+      uint64_t msb = uint64_t(1) << (numbits - 1);
+      if (v._unknown & msb) {
+        uint64_t widthmask = (sig->_bit_width == 64) ? ~uint64_t(0) : ((uint64_t(1) << sig->_bit_width) - 1);
+        uint64_t extmask   = widthmask & ~((msb << 1) - 1);
+        v._unknown |= extmask;
+        if (v._value & msb)
+          v._value |= extmask;
       }
-      default:
-        OrkAssert(false);
-        break;
     }
+    sig->_samples.append(_curtime, v);
+    _file._numtransitions++;
+  }
+
+  //////////////////////////////////////////////////////////
+
+  File& _file;
+  std::string _partial;
+  std::string _section;
+  std::vector<std::string> _sectargs;
+  std::stack<scope_ptr_t> _scope_stack;
+  std::unordered_map<std::string, Signal*> _signals_by_id;
+  std::string _idbuf;
+  std::string _pendingvalue;
+  PendingValue _pending = PendingValue::NONE;
+  uint64_t _curtime     = 0;
+};
+} // namespace
+////////////////////////////////////////////////////////////////////////////////
+void File::parse(ork::file::Path& inppath) {
+
+  ::ork::File vcdfile(inppath, EFM_READ);
+  size_t length = 0;
+  vcdfile.GetLength(length);
+
+  Ingestor ingestor(*this);
+  std::vector<char> chunk;
+  chunk.resize(kReadChunkSize);
+  size_t remaining = length;
+  while (remaining) {
+    size_t thisread = std::min(remaining, kReadChunkSize);
+    vcdfile.Read(chunk.data(), thisread);
+    ingestor.feed(chunk.data(), thisread);
+    remaining -= thisread;
   }
-  OrkAssert(scope_stack.top() == _root);
+  ingestor.finish();
+
+  printf(
+      "vcd<%s> numsignals<%zu> numtimestamps<%zu> numtransitions<%zu>\n", //
+      inppath.c_str(),
+      _signals_by_shortname.size(),
+      _numtimestamps,
+      _numtransitions);
+}
+////////////////////////////////////////////////////////////////////////////////
+void File::parseBuffer(const char* data, size_t length) {
+  Ingestor ingestor(*this);
+  ingestor.feed(data, length);
+  ingestor.finish();
 }
 ////////////////////////////////////////////////////////////////////////////////
 void Sample::write(int bit, LineState value) {
@@ -0,0 +1,371 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2022, Michael T. Mayers.
+// Distributed under the Boost Software License - Version 1.0 - August 17, 2003
+// see http://www.boost.org/LICENSE_1_0.txt
+////////////////////////////////////////////////////////////////
+
+#include <ork/hdl/vcd.h>
+#include <ork/kernel/debug.h>
+#include <algorithm>
+
+namespace ork::hdl::vcd {
+////////////////////////////////////////////////////////////////////////////////
+static inline uint64_t _widthMask(int numbits) {
+  return (numbits >= 64) ? ~uint64_t(0) : ((uint64_t(1) << numbits) - 1);
+}
+////////////////////////////////////////////////////////////////////////////////
+static inline void _mergeBucket(EnvelopeBucket& dst, const EnvelopeBucket& src) {
+  dst._minval = std::min(dst._minval, src._minval);
+  dst._maxval = std::max(dst._maxval, src._maxval);
+  dst._last   = src._last;
+  dst._numtransitions += src._numtransitions;
+  dst._unknown = dst._unknown or src._unknown;
+}
+////////////////////////////////////////////////////////////////////////////////
+PackedValue PackedValue::fromSample(const Sample& s) {
+  PackedValue rval;
+  for (int i = 0; i < s._numbits; i++) {
+    uint64_t mask = uint64_t(1) << i;
+    switch (s.read(i)) {
+      case LineState::FALSE:
+        break;
+      case LineState::TRUE:
+        rval._value |= mask;
+        break;
+      case LineState::X:
+        rval._unknown |= mask;
+        break;
+      case LineState::Z:
+        rval._value |= mask;
+        rval._unknown |= mask;
+        break;
+    }
+  }
+  return rval;
+}
+////////////////////////////////////////////////////////////////////////////////
+LineState PackedValue::read(int bit) const {
+  bool v = (_value >> bit) & 1;
+  bool u = (_unknown >> bit) & 1;
+  if (u)
+    return v ? LineState::Z : LineState::X;
+  return v ? LineState::TRUE : LineState::FALSE;
+}
+////////////////////////////////////////////////////////////////////////////////
+Sample PackedValue::toSample(int width) const {
+  Sample rval;
+  rval._numbits = width;
+  for (int i = 0; i < width; i++)
+    rval.write(i, read(i));
+  return rval;
+}
+////////////////////////////////////////////////////////////////////////////////
+void SampleStore::init(int bit_width) {
+  OrkAssert(bit_width > 0 and size_t(bit_width) <= kmaxbitlen);
+  _bit_width  = bit_width;
+  _numsamples = 0;
+  _lasttime   = 0;
+  _timedeltas.clear();
+  _checkpoints.clear();
+  _valuebits.clear();
+  _levels.clear();
+}
+////////////////////////////////////////////////////////////////////////////////
+void SampleStore::_writeBits(size_t bitoffset, int numbits, uint64_t value) {
+  size_t word   = bitoffset >> 6;
+  int shift     = int(bitoffset & 63);
+  uint64_t mask = _widthMask(numbits);
+  value &= mask;
+  _valuebits[word] = (_valuebits[word] & ~(mask << shift)) | (value << shift);
+  if (shift + numbits > 64) {
+    uint64_t himask      = _widthMask(shift + numbits - 64);
+    _valuebits[word + 1] = (_valuebits[word + 1] & ~himask) | (value >> (64 - shift));
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+uint64_t SampleStore::_readBits(size_t bitoffset, int numbits) const {
+  size_t word    = bitoffset >> 6;
+  int shift      = int(bitoffset & 63);
+  uint64_t rval  = _valuebits[word] >> shift;
+  if (shift + numbits > 64)
+    rval |= _valuebits[word + 1] << (64 - shift);
+  return rval & _widthMask(numbits);
+}
+////////////////////////////////////////////////////////////////////////////////
+void SampleStore::append(uint64_t timestamp, const PackedValue& value) {
+  OrkAssert(_bit_width > 0);
+  size_t stride = size_t(_bit_width) << 1;
+  ///////////////////////////////
+  // a later value at the same timestamp replaces the earlier one
+  ///////////////////////////////
+  if (_numsamples and (timestamp == _lasttime)) {
+    size_t bitoffset = (_numsamples - 1) * stride;
+    _writeBits(bitoffset, _bit_width, value._value);
+    _writeBits(bitoffset + _bit_width, _bit_width, value._unknown);
+    return;
+  }
+  OrkAssert(_numsamples == 0 or timestamp > _lasttime);
+  ///////////////////////////////
+  if ((_numsamples % kTimeCheckpointInterval) == 0) {
+    _checkpoints.push_back({timestamp, _timedeltas.size()});
+  } else {
+    uint64_t delta = timestamp - _lasttime;
+    do {
+      uint8_t byte = uint8_t(delta & 0x7f);
+      delta >>= 7;
+      if (delta)
+        byte |= 0x80;
+      _timedeltas.push_back(byte);
+    } while (delta);
+  }
+  ///////////////////////////////
+  size_t bitoffset = _numsamples * stride;
+  size_t numwords  = (bitoffset + stride + 63) >> 6;
+  if (_valuebits.size() < numwords)
+    _valuebits.resize(numwords, 0);
+  _writeBits(bitoffset, _bit_width, value._value);
+  _writeBits(bitoffset + _bit_width, _bit_width, value._unknown);
+  ///////////////////////////////
+  _numsamples++;
+  _lasttime = timestamp;
+}
+////////////////////////////////////////////////////////////////////////////////
+// sequentially decode timestamps of samples [first,last)
+//  fn(index,timestamp) returns false to stop early
+////////////////////////////////////////////////////////////////////////////////
+template <typename fn_t> void SampleStore::_visit(size_t first, size_t last, fn_t fn) const {
+  last = std::min(last, _numsamples);
+  if (first >= last)
+    return;
+  size_t icp      = first / kTimeCheckpointInterval;
+  size_t index    = icp * kTimeCheckpointInterval;
+  uint64_t time   = _checkpoints[icp]._time;
+  size_t byteoffs = _checkpoints[icp]._byteoffset;
+  while (true) {
+    if (index >= first and not fn(index, time))
+      return;
+    if (++index >= last)
+      return;
+    if ((index % kTimeCheckpointInterval) == 0) {
+      const auto& cp = _checkpoints[index / kTimeCheckpointInterval];
+      time           = cp._time;
+      byteoffs       = cp._byteoffset;
+    } else {
+      uint64_t delta = 0;
+      int shift      = 0;
+      uint8_t byte   = 0;
+      do {
+        byte = _timedeltas[byteoffs++];
+        delta |= uint64_t(byte & 0x7f) << shift;
+        shift += 7;
+      } while (byte & 0x80);
+      time += delta;
+    }
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+uint64_t SampleStore::firstTime() const {
+  return _checkpoints.empty() ? 0 : _checkpoints[0]._time;
+}
+////////////////////////////////////////////////////////////////////////////////
+uint64_t SampleStore::timeAt(size_t index) const {
+  OrkAssert(index < _numsamples);
+  uint64_t rval = 0;
+  _visit(index, index + 1, [&](size_t i, uint64_t t) -> bool {
+    rval = t;
+    return false;
+  });
+  return rval;
+}
+////////////////////////////////////////////////////////////////////////////////
+PackedValue SampleStore::valueAt(size_t index) const {
+  OrkAssert(index < _numsamples);
+  size_t bitoffset = index * (size_t(_bit_width) << 1);
+  PackedValue rval;
+  rval._value   = _readBits(bitoffset, _bit_width);
+  rval._unknown = _readBits(bitoffset + _bit_width, _bit_width);
+  return rval;
+}
+////////////////////////////////////////////////////////////////////////////////
+Sample SampleStore::sampleAt(size_t index) const {
+  return valueAt(index).toSample(_bit_width);
+}
+////////////////////////////////////////////////////////////////////////////////
+size_t SampleStore::indexAtOrBefore(uint64_t timestamp) const {
+  if (_numsamples == 0 or timestamp < firstTime())
+    return NOINDEX;
+  if (timestamp >= _lasttime)
+    return _numsamples - 1;
+  auto it = std::upper_bound(
+      _checkpoints.begin(), //
+      _checkpoints.end(),
+      timestamp,
+      [](uint64_t t, const TimeCheckpoint& cp) -> bool { return t < cp._time; });
+  size_t icp  = size_t(it - _checkpoints.begin()) - 1;
+  size_t rval = icp * kTimeCheckpointInterval;
+  _visit(rval, rval + kTimeCheckpointInterval, [&](size_t i, uint64_t t) -> bool {
+    if (t > timestamp)
+      return false;
+    rval = i;
+    return true;
+  });
+  return rval;
+}
+////////////////////////////////////////////////////////////////////////////////
+size_t SampleStore::nearestIndex(uint64_t timestamp) const {
+  if (_numsamples == 0)
+    return NOINDEX;
+  size_t index = indexAtOrBefore(timestamp);
+  if (index == NOINDEX)
+    return 0;
+  if (index + 1 < _numsamples) {
+    uint64_t tlo = timeAt(index);
+    uint64_t thi = timeAt(index + 1);
+    if ((thi - timestamp) < (timestamp - tlo))
+      return index + 1;
+  }
+  return index;
+}
+////////////////////////////////////////////////////////////////////////////////
+// build the transition pyramid
+//  level 0 is sized to hold ~kMinSamplesPerBucket samples per bucket,
+//  finer zoom levels are served directly from the sample columns
+////////////////////////////////////////////////////////////////////////////////
+void SampleStore::finalize() {
+  _levels.clear();
+  if (_numsamples < kMinSamplesPerBucket)
+    return;
+  ///////////////////////////////
+  uint64_t range  = _lasttime - firstTime() + 1;
+  uint64_t target = _numsamples / kMinSamplesPerBucket;
+  int shift       = 0;
+  while ((range >> shift) > target)
+    shift++;
+  ///////////////////////////////
+  EnvelopeLevel base;
+  base._shift = shift;
+  _visit(0, _numsamples, [&](size_t i, uint64_t t) -> bool {
+    auto v = valueAt(i);
+    EnvelopeBucket sb;
+    sb._time           = t;
+    sb._minval         = v._value;
+    sb._maxval         = v._value;
+    sb._last           = v;
+    sb._numtransitions = 1;
+    sb._unknown        = (v._unknown != 0);
+    if (base._buckets.empty() or ((base._buckets.back()._time >> shift) != (t >> shift)))
+      base._buckets.push_back(sb);
+    else
+      _mergeBucket(base._buckets.back(), sb);
+    return true;
+  });
+  _levels.push_back(std::move(base));
+  ///////////////////////////////
+  while (_levels.back()._buckets.size() > 1 and (_levels.back()._shift + kLevelFanoutShift) < 64) {
+    EnvelopeLevel next;
+    next._shift = _levels.back()._shift + kLevelFanoutShift;
+    for (const auto& sb : _levels.back()._buckets) {
+      if (next._buckets.empty() or ((next._buckets.back()._time >> next._shift) != (sb._time >> next._shift)))
+        next._buckets.push_back(sb);
+      else
+        _mergeBucket(next._buckets.back(), sb);
+    }
+    _levels.push_back(std::move(next));
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void SampleStore::envelope(
+    uint64_t t0, //
+    uint64_t t1,
+    size_t numbins,
+    std::vector<EnvelopeBucket>& bins_out) const {
+  bins_out.clear();
+  if (numbins == 0 or t1 <= t0)
+    return;
+  bins_out.resize(numbins);
+  double binwidth = double(t1 - t0) / double(numbins);
+  ///////////////////////////////
+  auto accumulate = [&](const EnvelopeBucket& b) {
+    size_t ibin = (b._time < t0) ? 0 : size_t(double(b._time - t0) / binwidth);
+    ibin        = std::min(ibin, numbins - 1);
+    auto& bin   = bins_out[ibin];
+    if (bin._numtransitions == 0)
+      bin = b;
+    else
+      _mergeBucket(bin, b);
+  };
+  ///////////////////////////////
+  // coarsest pyramid level whose buckets fit in one bin
+  ///////////////////////////////
+  const EnvelopeLevel* level = nullptr;
+  for (const auto& l : _levels) {
+    if (double(uint64_t(1) << l._shift) <= binwidth)
+      level = &l;
+  }
+  if (level) {
+    int shift = level->_shift;
+    auto it   = std::lower_bound(
+        level->_buckets.begin(), //
+        level->_buckets.end(),
+        t0 >> shift,
+        [shift](const EnvelopeBucket& b, uint64_t key) -> bool { return (b._time >> shift) < key; });
+    for (; it != level->_buckets.end() and it->_time < t1; it++)
+      accumulate(*it);
+  } else {
+    size_t first = indexAtOrBefore(t0);
+    if (first == NOINDEX)
+      first = 0;
+    else if (timeAt(first) < t0)
+      first++;
+    _visit(first, _numsamples, [&](size_t i, uint64_t t) -> bool {
+      if (t >= t1)
+        return false;
+      auto v = valueAt(i);
+      EnvelopeBucket sb;
+      sb._time           = t;
+      sb._minval         = v._value;
+      sb._maxval         = v._value;
+      sb._last           = v;
+      sb._numtransitions = 1;
+      sb._unknown        = (v._unknown != 0);
+      accumulate(sb);
+      return true;
+    });
+  }
+  ///////////////////////////////
+  // carry values across bins, undriven before the first sample is X
+  ///////////////////////////////
+  PackedValue carry;
+  size_t icarry = (t0 == 0) ? NOINDEX : indexAtOrBefore(t0 - 1);
+  if (icarry == NOINDEX)
+    carry._unknown = _widthMask(_bit_width);
+  else
+    carry = valueAt(icarry);
+  for (size_t i = 0; i < numbins; i++) {
+    auto& bin = bins_out[i];
+    if (bin._numtransitions == 0) {
+      bin._time    = t0 + uint64_t(double(i) * binwidth);
+      bin._minval  = carry._value;
+      bin._maxval  = carry._value;
+      bin._last    = carry;
+      bin._unknown = (carry._unknown != 0);
+    } else {
+      bin._minval  = std::min(bin._minval, carry._value);
+      bin._maxval  = std::max(bin._maxval, carry._value);
+      bin._unknown = bin._unknown or (carry._unknown != 0);
+      carry        = bin._last;
+    }
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+size_t SampleStore::memoryFootprint() const {
+  size_t rval = _timedeltas.capacity()                          //
+                + _checkpoints.capacity() * sizeof(TimeCheckpoint) //
+                + _valuebits.capacity() * sizeof(uint64_t);
+  for (const auto& l : _levels)
+    rval += l._buckets.capacity() * sizeof(EnvelopeBucket);
+  return rval;
+}
+////////////////////////////////////////////////////////////////////////////////
+} // namespace ork::hdl::vcd
@@ -8,6 +8,8 @@
 #include <utpp/UnitTest++.h>
 #include <ork/hdl/hdl.inl>
 #include <ork/kernel/spawner.h>
+#include <ork/kernel/timer.h>
+#include <fstream>
 using namespace ork;
 using namespace ork::hdl;
 extern char** environ;
@@ -156,21 +158,22 @@ struct TOP : public Module {
   Ref romaddr, romdatain, romdataout, romwe;
 };
 ///////////////////////////////////////////////////
+struct TB : public TestBench {
+  TB()
+      : TestBench("MyTB")
+      , initref(wirebool, lineout)
+      , _top(this, {lineout}) {
+  }
+  Ref lineout;
+  TOP _top;
+};
+///////////////////////////////////////////////////
 TEST(hdl1) {
   /////////////////////////////////////
   auto e = std::make_shared<VerilogBackEnd>();
   e->outputline("`timescale 1ns / 1ns");
   e->outputline("/* verilator lint_off INITIALDLY */");
   /////////////////////////////////////
-  struct TB : public TestBench {
-    TB()
-        : TestBench("MyTB")
-        , initref(wirebool, lineout)
-        , _top(this, {lineout}) {
-    }
-    Ref lineout;
-    TOP _top;
-  };
   TB _dut;
   /////////////////////////////////////
   FrontEnd::get().generate(e, _dut);
@@ -187,3 +190,58 @@ TEST(hdl1) {
   }
   /////////////////////////////////////
 }
+///////////////////////////////////////////////////
+// native cycle simulation of the same design,
+//  no verilog toolchain involved
+///////////////////////////////////////////////////
+TEST(hdl_sim) {
+  /////////////////////////////////////
+  auto sim = std::make_shared<SimBackEnd>();
+  TB _dut;
+  FrontEnd::get().generate(sim, _dut);
+  /////////////////////////////////////
+  sim->openVcd("test_sim.vcd");
+  sim->run(100);
+  CHECK_EQUAL(sim->read(&_dut._top, "counter"), 100);
+  sim->reset();
+  sim->run(10);
+  sim->closeVcd();
+  CHECK_EQUAL(sim->read(&_dut._top, "counter"), 10);
+  /////////////////////////////////////
+  // vcd time keeps increasing across the reset
+  /////////////////////////////////////
+  std::ifstream vcdin("test_sim.vcd");
+  std::string line;
+  int64_t prevtime  = -1;
+  int numstamps     = 0;
+  int numbackwards  = 0;
+  while (std::getline(vcdin, line)) {
+    if (line.empty() or line[0] != '#')
+      continue;
+    int64_t t = std::stoll(line.substr(1));
+    if (t <= prevtime)
+      numbackwards++;
+    prevtime = t;
+    numstamps++;
+  }
+  CHECK(numstamps > 110);
+  CHECK_EQUAL(0, numbackwards);
+  /////////////////////////////////////
+  constexpr size_t knumcycles = 1 << 20;
+  sim->reset();
+  double t0 = ork::get_sync_time();
+  sim->run(knumcycles);
+  double t1       = ork::get_sync_time();
+  double elapsed  = t1 - t0;
+  double persec   = double(knumcycles) / elapsed;
+  printf("hdl_sim elapsed<%g> cycles<%zu> cyclespersec<%g>\n", elapsed, knumcycles, persec);
+  /////////////////////////////////////
+  const char rominit[TOP::ROMD] = "0123456789abcdef0123456789ABCDE";
+  uint64_t romdata = uint8_t(rominit[(knumcycles - 2) % TOP::ROMD]);
+  CHECK_EQUAL(sim->read(&_dut._top, "counter"), knumcycles);
+  CHECK_EQUAL(sim->read(&_dut._top, "o2"), uint64_t(-3 * int64_t(knumcycles)) & 0xffffffff);
+  CHECK_EQUAL(sim->read(&_dut._top, "gcdX"), knumcycles);
+  CHECK_EQUAL(sim->read(&_dut._top, "romdataout"), romdata);
+  uint64_t lineout = uint8_t(rominit[(knumcycles - 3) % TOP::ROMD]) & 1;
+  CHECK_EQUAL(sim->read(&_dut, "lineout"), lineout);
+}
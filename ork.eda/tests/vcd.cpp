@@ -24,3 +24,84 @@ TEST(vcd_load) {
 
   vcdfile.parse(inppath);
 }
+
+TEST(vcd_parse_buffer) {
+
+  std::string text = "$timescale 1 ns $end\n"
+                     "$scope module top $end\n"
+                     "$var wire 1 ! clk $end\n"
+                     "$var wire 8 \" data [7:0] $end\n"
+                     "$upscope $end\n"
+                     "$enddefinitions $end\n"
+                     "#0\n"
+                     "$dumpvars\n"
+                     "0!\n"
+                     "bx \"\n"
+                     "$end\n"
+                     "#5\n"
+                     "1!\n"
+                     "b101 \"\n"
+                     "#10\n"
+                     "0!\n";
+
+  vcd::File vcdfile;
+  vcdfile.parseBuffer(text.c_str(), text.length());
+
+  CHECK_EQUAL(vcdfile._timescale, "1ns");
+  CHECK_EQUAL(vcdfile._min_timestamp, 0);
+  CHECK_EQUAL(vcdfile._max_timestamp, 10);
+
+  auto clk  = vcdfile._signals_by_shortname["!"];
+  auto data = vcdfile._signals_by_shortname["\""];
+  CHECK_EQUAL(clk->_samples.size(), 3);
+  CHECK_EQUAL(data->_samples.size(), 2);
+  CHECK_EQUAL(data->_samples.sampleAt(0).strvalue(), "xx");
+  CHECK_EQUAL(data->_samples.sampleAt(1).strvalue(), "05");
+  CHECK(clk->_samples.valueAt(1).read(0) == vcd::LineState::TRUE);
+}
+
+TEST(vcd_sample_store) {
+
+  vcd::SampleStore store;
+  store.init(5);
+
+  std::vector<uint64_t> times;
+  std::vector<vcd::PackedValue> values;
+  uint64_t t = 3;
+  for (int i = 0; i < 10000; i++) {
+    t += 1 + (i % 7) * 13;
+    vcd::PackedValue v;
+    v._value   = i & 31;
+    v._unknown = (i % 97) == 0 ? 1 : 0;
+    store.append(t, v);
+    times.push_back(t);
+    values.push_back(v);
+  }
+  store.finalize();
+
+  CHECK(store._levels.size() > 0);
+  for (size_t i = 0; i < times.size(); i += 37) {
+    CHECK_EQUAL(store.timeAt(i), times[i]);
+    CHECK(store.valueAt(i) == values[i]);
+    CHECK_EQUAL(store.indexAtOrBefore(times[i]), i);
+  }
+  CHECK_EQUAL(store.indexAtOrBefore(0), vcd::SampleStore::NOINDEX);
+
+  ///////////////////////////////////
+  // every transition lands in exactly one bin, from the pyramid (coarse)
+  //  or from the sample columns (fine)
+  ///////////////////////////////////
+
+  std::vector<vcd::EnvelopeBucket> bins;
+  store.envelope(times.front(), times.back() + 1, 100, bins);
+  size_t total = 0;
+  for (auto& bin : bins)
+    total += bin._numtransitions;
+  CHECK_EQUAL(total, times.size());
+
+  store.envelope(times[500], times[600], 1000, bins);
+  total = 0;
+  for (auto& bin : bins)
+    total += bin._numtransitions;
+  CHECK_EQUAL(total, 100);
+}
@@ -91,8 +91,8 @@ int main(int argc, char** argv, char** envp) {
   }
   //////////////////////////////////////
   auto viewparams            = ViewParams::instance();
-  viewparams->_min_timestamp = *vcdfile._timestamps.begin();
-  viewparams->_max_timestamp = *vcdfile._timestamps.rbegin();
+  viewparams->_min_timestamp = vcdfile._min_timestamp;
+  viewparams->_max_timestamp = vcdfile._max_timestamp;
   printf("min_timestamp<%lu>\n", viewparams->_min_timestamp);
   printf("max_timestamp<%lu>\n", viewparams->_max_timestamp);
   //////////////////////////////////////
@@ -28,7 +28,8 @@ void SignalTrackWidget::setTimeStamp(uint64_t timestep) {
   auto viewparams             = ViewParams::instance();
   viewparams->_cursor_actual  = timestep;
   viewparams->_curtrack       = this;
-  uint64_t closest            = nearestItem(_signal->_samples, timestep)->first;
+  auto& samples               = _signal->_samples;
+  uint64_t closest            = samples.timeAt(samples.nearestIndex(timestep));
   viewparams->_cursor_nearest = closest;
   ////////////////////////////////
   // update all tracks
@@ -38,15 +39,17 @@ void SignalTrackWidget::setTimeStamp(uint64_t timestep) {
 
     auto sig = track->_signal;
 
-    closest                  = nearestItem(sig->_samples, timestep)->first;
+    auto& trksamples         = sig->_samples;
+    size_t index             = trksamples.nearestIndex(timestep);
+    closest                  = trksamples.timeAt(index);
     track->_nearest_timestep = closest;
-    auto sample              = sig->_samples[closest];
+    auto sample              = trksamples.sampleAt(index);
     bool is_1bit             = sig->_bit_width == 1;
     if (is_1bit) {
       track->_label       = "";
       track->_stringwidth = 0;
     } else {
-      track->_label = sample->strvalue();
+      track->_label = sample.strvalue();
       int lablen    = track->_label.length();
 
       track->_stringwidth = lev2::FontMan::stringWidth(lablen);
@@ -70,22 +73,18 @@ HandlerResult SignalTrackWidget::DoOnUiEvent(event_constptr_t evptr) {
     case EventCode::KEY_REPEAT:
       switch (evptr->miKeyCode) {
         case ETRIG_RAW_KEY_LEFT: {
-          auto it = nearestItem(_signal->_samples, _nearest_timestep);
-          if (it != _signal->_samples.end()) {
-            it--;
-            if (it != _signal->_samples.end()) {
-              setTimeStamp(it->first);
-            }
+          auto& samples = _signal->_samples;
+          size_t index  = samples.nearestIndex(_nearest_timestep);
+          if (index != SampleStore::NOINDEX and index > 0) {
+            setTimeStamp(samples.timeAt(index - 1));
           }
           break;
         }
         case ETRIG_RAW_KEY_RIGHT: {
-          auto it = nearestItem(_signal->_samples, _nearest_timestep);
-          if (it != _signal->_samples.end()) {
-            it++;
-            if (it != _signal->_samples.end()) {
-              setTimeStamp(it->first);
-            }
+          auto& samples = _signal->_samples;
+          size_t index  = samples.nearestIndex(_nearest_timestep);
+          if (index != SampleStore::NOINDEX and (index + 1) < samples.size()) {
+            setTimeStamp(samples.timeAt(index + 1));
           }
           break;
         }
@@ -140,9 +139,13 @@ void SignalTrackWidget::DoDraw(ui::drawevent_constptr_t drwev) {
   bool is_1bit = _signal->_bit_width == 1;
 
   ////////////////////////////////
-  if (_vbdirty) {
+  // the vertex buffer is regenerated from the signal's
+  //  transition pyramid, one envelope bin per pixel column
+  ////////////////////////////////
+  if (_vbdirty or (_vbwidth != _geometry._w)) {
     _numsamples = _signal->_samples.size();
     _vbdirty    = false;
+    _vbwidth    = _geometry._w;
     VtxWriter<vtx_t> vw;
     vw.Lock(
         tgt, //
@@ -157,74 +160,15 @@ void SignalTrackWidget::DoDraw(ui::drawevent_constptr_t drwev) {
       vw.AddVertex(vtx);
       _numvertices++;
     };
-
-    uint64_t prevtimest     = _signal->_samples.begin()->first;
-    sample_ptr_t prevsample = _signal->_samples.begin()->second;
-
-    for (auto sitem : _signal->_samples) {
-
-      uint64_t nexttimest     = sitem.first;
-      sample_ptr_t nextsample = sitem.second;
-
-      if (is_1bit) {
-        float prevvalue = 0.5f;
-        float nextvalue = 0.5f;
-        uint32_t color  = 0xff00c000;
-        switch (prevsample->read(0)) {
-          case LineState::FALSE:
-            prevvalue = 0.9f;
-            break;
-          case LineState::TRUE:
-            prevvalue = 0.1f;
-            break;
-          case LineState::X:
-            color = 0xff0000c0;
-            break;
-          case LineState::Z:
-            color = 0xff00c0c0;
-            break;
-        }
-        switch (nextsample->read(0)) {
-          case LineState::FALSE:
-            nextvalue = 0.9f;
-            break;
-          case LineState::TRUE:
-            nextvalue = 0.1f;
-            break;
-          case LineState::X:
-            color = 0xff0000c0;
-            break;
-          case LineState::Z:
-            color = 0xff00c0c0;
-            break;
-        }
-        add_vtx(prevtimest, prevvalue, color);
-        add_vtx(nexttimest, prevvalue, color);
-        add_vtx(nexttimest, prevvalue, color);
-        add_vtx(nexttimest, nextvalue, color);
-      } else {
-        add_vtx(sitem.first, 0.0f, 0xff404040);
-        add_vtx(sitem.first, 1.0f, 0xff404040);
-      }
-      prevtimest = sitem.first;
-      prevsample = sitem.second;
-    }
-    //////////////////////////////////////////////
-    // extend signal trace to end of session
-    //////////////////////////////////////////////
-    if (is_1bit) {
-      auto enditem           = _signal->_samples.rbegin();
-      uint64_t endtimest     = enditem->first;
-      sample_ptr_t endsample = enditem->second;
-
-      float endvalue = 0.5f;
-      uint32_t color = 0xff00c000;
-      switch (endsample->read(0)) {
+    auto linestate = [](LineState state, float& value, uint32_t& color) {
+      value = 0.5f;
+      color = 0xff00c000;
+      switch (state) {
         case LineState::FALSE:
-          endvalue = 0.9f;
+          value = 0.9f;
           break;
         case LineState::TRUE:
-          endvalue = 0.1f;
+          value = 0.1f;
           break;
         case LineState::X:
           color = 0xff0000c0;
@@ -233,9 +177,33 @@ void SignalTrackWidget::DoDraw(ui::drawevent_constptr_t drwev) {
           color = 0xff00c0c0;
           break;
       }
+    };
 
-      add_vtx(endtimest, endvalue, color);
-      add_vtx(viewparams->_max_timestamp, endvalue, color);
+    uint64_t t0     = viewparams->_min_timestamp;
+    uint64_t t1     = viewparams->_max_timestamp + 1;
+    size_t numbins  = size_t(std::max(_geometry._w, 1));
+    double binwidth = double(t1 - t0) / double(numbins);
+    _signal->_samples.envelope(t0, t1, numbins, _bins);
+
+    for (size_t i = 0; i < _bins.size(); i++) {
+      const auto& bin = _bins[i];
+      uint64_t bt0    = t0 + uint64_t(double(i) * binwidth);
+      uint64_t bt1    = t0 + uint64_t(double(i + 1) * binwidth);
+      if (is_1bit) {
+        float value    = 0.5f;
+        uint32_t color = 0xff00c000;
+        linestate(bin._last.read(0), value, color);
+        if (bin._numtransitions) {
+          add_vtx(bt0, 0.1f, color);
+          add_vtx(bt0, 0.9f, color);
+        }
+        add_vtx(bt0, value, color);
+        add_vtx(bt1, value, color);
+      } else if (bin._numtransitions) {
+        uint32_t color = bin._unknown ? 0xff000080 : 0xff404040;
+        add_vtx(bt0, 0.0f, color);
+        add_vtx(bt0, 1.0f, color);
+      }
     }
     //////////////////////////////////////////////
     vw.UnLock(tgt);
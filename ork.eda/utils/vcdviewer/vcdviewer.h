@@ -82,6 +82,8 @@ struct SignalTrackWidget final : public Widget {
   size_t _numsamples;
   std::string _font          = "i14";
   bool _vbdirty              = true;
+  int _vbwidth               = 0;
+  std::vector<EnvelopeBucket> _bins;
   uint64_t _nearest_timestep = 0xffffffffffffffff;
   DynamicVertexBuffer<vtx_t> _vtxbuf;
   int _numvertices = 0;
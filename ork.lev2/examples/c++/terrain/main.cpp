@@ -39,7 +39,8 @@ int main(int argc, char** argv, char** envp) {
       ("help", "produce help message") //
       ("msaa", po::value<int>()->default_value(1), "msaa samples(*1,4,9,16,25)")
       ("ssaa", po::value<int>()->default_value(1), "ssaa samples(*1,4,9,16,25)")
-      ("forward", po::bool_switch()->default_value(false), "forward renderer");
+      ("forward", po::bool_switch()->default_value(false), "forward renderer")
+      ("streaming", po::bool_switch()->default_value(false), "streaming (CDLOD) terrain");
 
   auto vars = *init_data->parse();
 
@@ -51,6 +52,7 @@ int main(int argc, char** argv, char** envp) {
   init_data->_ssaa_samples = vars["ssaa"].as<int>();
 
   bool use_forward = vars["forward"].as<bool>();
+  bool use_streaming = vars["streaming"].as<bool>();
 
   auto ezapp        = OrkEzApp::create(init_data);
   auto ezwin        = ezapp->_mainWindow;
@@ -101,6 +103,7 @@ int main(int argc, char** argv, char** envp) {
     (*cameras)["spawncam"] = camdata;
     //////////////////////////////////////////////////////////
     _terrainData->_rock1 = fvec3(1, 1, 1);
+    _terrainData->_streaming = use_streaming;
     _terrainData->_writeHmapPath("src://terrain/testhmap2_2048.png");
 
     _terrainDrawable          = dcache.fetch(_terrainData);
@@ -13,6 +13,23 @@
 /// ////////////////////////////////////////////////////////////////////////////
 /// ////////////////////////////////////////////////////////////////////////////
 
+/// dynamic vertex buffer streaming counters, kept by backends that stream
+///  dynamic vertex buffers through a shared ring (see GLStreamRing)
+
+struct GeometryStreamStats {
+  size_t _bytesStreamed = 0; // bytes written through the ring
+  size_t _numRotations  = 0; // ring segment switches
+  size_t _stallsAvoided = 0; // segment switches whose fence had already signaled
+  size_t _stalls        = 0; // segment switches that had to wait on the gpu
+  size_t _windowCopies  = 0; // gpu side copies (rewind prefixes, windows moved off a reclaimed segment)
+  size_t _bytesCopied   = 0;
+  void reset() {
+    *this = GeometryStreamStats();
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 class GeometryBufferInterface {
 
 public:
@@ -22,6 +39,13 @@ public:
   void BeginFrame();
   void EndFrame();
 
+  const GeometryStreamStats& streamStats() const {
+    return _streamStats;
+  }
+  void resetStreamStats() {
+    _streamStats.reset();
+  }
+
   ///////////////////////////////////////////////////////////////////////
   // VtxBuf Interface
 
@@ -135,6 +159,7 @@ public:
 protected:
   int miTrianglesRendered;
   Context& _context;
+  GeometryStreamStats _streamStats;
 
 private:
   virtual void _doBeginFrame() {
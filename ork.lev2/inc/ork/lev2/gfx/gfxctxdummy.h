@@ -236,6 +236,28 @@ protected:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+class DuReadbackInterface final : public ReadbackInterface {
+public:
+  DuReadbackInterface(Context& target)
+      : ReadbackInterface(target) {
+    _minLatency = 0; // delivered by the next poll, even in the submit frame
+  }
+
+private:
+  // nothing to wait on, results are zero filled
+  void _doSubmit(int slot, const ReadbackRequest& req) final {
+  }
+  bool _doPoll(int slot) final {
+    return true;
+  }
+  void _doWait(int slot) final {
+  }
+  void _doFetch(int slot, ReadbackResult& result) final {
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 class DuTextureInterface : public TextureInterface {
 public:
   void TexManInit(void) final {
@@ -299,6 +321,9 @@ public:
   DrawingInterface* DWI() final {
     return &mDWI;
   }
+  ReadbackInterface* RBI() final {
+    return &mRbI;
+  }
 
 #if defined(ENABLE_COMPUTE_SHADERS)
   ComputeInterface* CI() final {
@@ -332,6 +357,7 @@ private:
   DuTextureInterface mTxI;
   DuFrameBufferInterface mFbI;
   DummyDrawingInterface mDWI;
+  DuReadbackInterface mRbI;
 
 #if defined(ENABLE_COMPUTE_SHADERS)
   DuComputeInterface mCI;
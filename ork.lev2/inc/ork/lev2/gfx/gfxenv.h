@@ -154,6 +154,7 @@ public:
   virtual FrameBufferInterface* FBI()    = 0; // FrameBuffer/Control Interface
   virtual TextureInterface* TXI()        = 0; // Texture Interface
   virtual DrawingInterface* DWI()        = 0; // Drawing Interface
+  virtual ReadbackInterface* RBI()       = 0; // Asynchronous Readback Interface
 #if defined(ENABLE_COMPUTE_SHADERS)
   virtual ComputeInterface* CI() = 0; // ComputeShader Interface
 #endif
@@ -247,6 +247,9 @@ enum struct EVtxStreamFormat : crc_enum_t {
 
   CrcEnum(V12N6I1T4),       // 24 BPV	3D Textured hard skinned w/normals  (gamecube/wii basic)
   CrcEnum(V12N6C2T4),       // 24 BPV	3D Textured colored rigid w/normals (gamecube/wii basic)
+  CrcEnum(V8N4B4T8),        // 24 BPV	quantized rigid, bounds relative pos, oct normals, half 2UV
+
+  CrcEnum(V8N4B4T4I4W4),    // 28 BPV	quantized skinned, bounds relative pos, oct normals, half UV
 
   CrcEnum(V12C4N6I2T8),     // 32 BPV	I2 = Bone Index (SKINNED)
   CrcEnum(V12I4N6W4T4),     // 32 BPV	I4 = Bone Index, W4 = Bone Weights
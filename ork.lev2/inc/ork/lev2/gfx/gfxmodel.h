@@ -83,6 +83,34 @@ public:
   }
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// XgmMeshlet : small fixed size slice of a cluster's (optimized) triangle list
+//  with bounds for per meshlet frustum and backface cone culling.
+//  generated at export time (meshutil::buildMeshlets), stored per cluster
+//  in the xgm file (v3).
+///////////////////////////////////////////////////////////////////////////////
+
+struct XgmMeshlet {
+
+  static constexpr size_t kMAXVERTICES  = 64;
+  static constexpr size_t kMAXTRIANGLES = 124;
+
+  // cone test, true if every triangle faces away from eye
+  bool isBackfacing(const fvec3& eye) const {
+    if (_coneCutoff >= 1.0f)
+      return false;
+    return (_coneApex - eye).normalized().dotWith(_coneAxis) >= _coneCutoff;
+  }
+
+  std::vector<uint32_t> _vertices; // cluster vertex indices
+  std::vector<uint8_t> _triangles; // 3 local (_vertices) indices per triangle
+  fvec3 _center;
+  float _radius = 0.0f;
+  fvec3 _coneApex;
+  fvec3 _coneAxis;
+  float _coneCutoff = 1.0f; // 1 : cone culling disabled
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct XgmCluster final { // Run Time Cluster
@@ -117,6 +145,7 @@ struct XgmCluster final { // Run Time Cluster
 
   AABox mBoundingBox;
   Sphere mBoundingSphere;
+  std::vector<XgmMeshlet> _meshlets;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -126,6 +155,7 @@ struct XgmSubMesh final // Run Time Cluster Set
 
   material_ptr_t _material;
   xgmcluster_ptr_list_t _clusters;
+  std::vector<xgmcluster_ptr_list_t> _lodClusters; // [i] is LOD i+1, LOD 0 is _clusters
   XgmMesh* _parentmesh = nullptr;
 
   XgmSubMesh()
@@ -143,6 +173,12 @@ struct XgmSubMesh final // Run Time Cluster Set
   material_ptr_t GetMaterial(void) const {
     return _material;
   }
+  // clamps to the coarsest available level
+  const xgmcluster_ptr_list_t& lodClusters(int lod) const {
+    if (lod <= 0 or _lodClusters.empty())
+      return _clusters;
+    return _lodClusters[std::min(lod, int(_lodClusters.size())) - 1];
+  }
 
   void dump() const;
 }; // namespace ork::lev2
@@ -322,6 +358,17 @@ struct XgmModel final {
     return miBonesPerCluster;
   }
 
+  /////////////////////////////////////
+  // LOD selection by projected size
+  //  (bounding sphere diameter / viewport height)
+  //  LOD i+1 is used below _lodScreenSizes[i] (descending)
+  /////////////////////////////////////
+
+  int numLods() const {
+    return int(_lodScreenSizes.size()) + 1;
+  }
+  int selectLod(float screen_size) const;
+
   /////////////////////////////////////
 
   void SetBoundingCenter(const fvec3& v) {
@@ -403,6 +450,8 @@ struct XgmModel final {
   fvec3 mBoundingCenter;
   float mBoundingRadius;
   bool mbSkinned;
+  std::vector<float> _lodScreenSizes;
+  pickmesh_ptr_t _pickMesh; // CPU ray picking (LOD 0, bind pose), see raypick.h
   asset::vars_t _varmap;
   XgmModelAsset* _asset = nullptr;
 };
@@ -302,6 +302,70 @@ struct SVtxV12N6C2T4 // 24BPV WII rigid format
   constexpr static EVtxStreamFormat meFormat = EVtxStreamFormat::V12N6C2T4;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// quantized xgm formats (see gfxvtxquant.h)
+//  position : unorm16 relative to the cluster bounding box (w unused)
+//  normal/binormal : octahedral snorm16x2
+//  uvs : half float
+///////////////////////////////////////////////////////////////////////////////
+
+struct SVtxV8N4B4T8 { // 24BPV quantized rigid
+  U16 mPosition[4];  // 0  8
+  S16 mNormal[2];    // 8  12
+  S16 mBiNormal[2];  // 12 16
+  U16 mUV0[2];       // 16 20
+  U16 mUV1[2];       // 20 24
+
+  SVtxV8N4B4T8() {
+    memset(this, 0, sizeof(*this));
+  }
+
+  void EndianSwap() {
+    for (int i = 0; i < 4; i++)
+      swapbytes_dynamic(mPosition[i]);
+    for (int i = 0; i < 2; i++) {
+      swapbytes_dynamic(mNormal[i]);
+      swapbytes_dynamic(mBiNormal[i]);
+      swapbytes_dynamic(mUV0[i]);
+      swapbytes_dynamic(mUV1[i]);
+    }
+  }
+
+  constexpr static EVtxStreamFormat meFormat = EVtxStreamFormat::V8N4B4T8;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct SVtxV8N4B4T4I4W4 { // 28BPV quantized skinned
+  U16 mPosition[4];  // 0  8
+  S16 mNormal[2];    // 8  12
+  S16 mBiNormal[2];  // 12 16
+  U16 mUV0[2];       // 16 20
+  U32 mBoneIndices;  // 20 24
+  U32 mBoneWeights;  // 24 28
+
+  SVtxV8N4B4T4I4W4() {
+    memset(this, 0, sizeof(*this));
+  }
+
+  void EndianSwap() {
+    for (int i = 0; i < 4; i++)
+      swapbytes_dynamic(mPosition[i]);
+    for (int i = 0; i < 2; i++) {
+      swapbytes_dynamic(mNormal[i]);
+      swapbytes_dynamic(mBiNormal[i]);
+      swapbytes_dynamic(mUV0[i]);
+    }
+    swapbytes_dynamic(mBoneIndices);
+    swapbytes_dynamic(mBoneWeights);
+  }
+
+  constexpr static EVtxStreamFormat meFormat = EVtxStreamFormat::V8N4B4T4I4W4;
+};
+
+static_assert(sizeof(SVtxV8N4B4T8) == 24);
+static_assert(sizeof(SVtxV8N4B4T4I4W4) == 28);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct SVtxV12C4T16 { // 32 BPV{
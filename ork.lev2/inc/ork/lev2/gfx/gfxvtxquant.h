@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// vertex stream quantization helpers
+//
+//  positions : unorm16 per axis, normalized to the cluster bounding box
+//               (the box is already stored per cluster in xgm files,
+//                so dequantization needs no extra file data)
+//  normals   : octahedral snorm16x2
+//  uvs       : half floats
+//
+//  the glfx side of these lives in vtxquant.i (lib_vtx_dequant)
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ork/orktypes.h>
+#include <ork/lev2/gfx/gfxenv_enum.h>
+#include <ork/math/cvector2.h>
+#include <ork/math/cvector3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ork::lev2::vtxquant {
+
+inline bool isQuantizedFormat(EVtxStreamFormat fmt) {
+  return (fmt == EVtxStreamFormat::V8N4B4T8) or (fmt == EVtxStreamFormat::V8N4B4T4I4W4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// IEEE 754 binary16, round to nearest even
+///////////////////////////////////////////////////////////////////////////////
+
+inline U16 floatToHalf(float f) {
+  uint32_t x;
+  memcpy(&x, &f, sizeof(x));
+  uint32_t sign = (x >> 16) & 0x8000;
+  uint32_t absx = x & 0x7fffffff;
+  if (absx >= 0x7f800000) // inf / nan
+    return U16(sign | 0x7c00 | ((absx > 0x7f800000) ? 0x200 : 0));
+  if (absx >= 0x477ff000) // rounds past 65504
+    return U16(sign | 0x7c00);
+  if (absx < 0x38800000) { // half subnormal (or zero)
+    float af;
+    memcpy(&af, &absx, sizeof(af));
+    return U16(sign | uint32_t(std::nearbyint(af * 16777216.0f)));
+  }
+  uint32_t mant_odd = (absx >> 13) & 1;
+  absx += 0xc8000fff + mant_odd; // rebias exponent, round
+  return U16(sign | (absx >> 13));
+}
+
+inline float halfToFloat(U16 h) {
+  uint32_t sign = uint32_t(h & 0x8000) << 16;
+  uint32_t expo = (h >> 10) & 0x1f;
+  uint32_t mant = h & 0x3ff;
+  uint32_t bits = 0;
+  if (expo == 0) {
+    float f = float(mant) * (1.0f / 16777216.0f);
+    return sign ? -f : f;
+  } else if (expo == 31)
+    bits = sign | 0x7f800000 | (mant << 13);
+  else
+    bits = sign | ((expo + 112) << 23) | (mant << 13);
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// octahedral unit vector encoding
+///////////////////////////////////////////////////////////////////////////////
+
+inline S16 _snorm16(float v) {
+  return S16(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+}
+
+inline void octEncode(const fvec3& n, S16& out_x, S16& out_y) {
+  float l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+  if (l1 <= 0.0f) {
+    out_x = 0;
+    out_y = 0;
+    return;
+  }
+  float x = n.x / l1;
+  float y = n.y / l1;
+  if (n.z < 0.0f) {
+    float ox = (1.0f - fabsf(y)) * ((x >= 0.0f) ? 1.0f : -1.0f);
+    float oy = (1.0f - fabsf(x)) * ((y >= 0.0f) ? 1.0f : -1.0f);
+    x        = ox;
+    y        = oy;
+  }
+  out_x = _snorm16(x);
+  out_y = _snorm16(y);
+}
+
+inline fvec3 octDecode(S16 ix, S16 iy) {
+  // matches GL snorm conversion : max(c/32767,-1)
+  float x = std::max(float(ix) / 32767.0f, -1.0f);
+  float y = std::max(float(iy) / 32767.0f, -1.0f);
+  fvec3 n(x, y, 1.0f - fabsf(x) - fabsf(y));
+  float t = std::max(-n.z, 0.0f);
+  n.x += (n.x >= 0.0f) ? -t : t;
+  n.y += (n.y >= 0.0f) ? -t : t;
+  return n.normalized();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// bounds relative unorm16 positions
+//  _bias/_scale are exactly what the vertex shader gets (QuantPosBias/Scale)
+///////////////////////////////////////////////////////////////////////////////
+
+struct PositionQuantizer {
+
+  PositionQuantizer(const fvec3& bbmin, const fvec3& bbmax)
+      : _bias(bbmin) {
+    // flat clusters still need a non zero range
+    auto extent = [](float lo, float hi) { return std::max(hi - lo, 1.0e-6f); };
+    _scale      = fvec3(extent(bbmin.x, bbmax.x), extent(bbmin.y, bbmax.y), extent(bbmin.z, bbmax.z));
+  }
+
+  void encode(const fvec3& pos, U16 out[3]) const {
+    for (int i = 0; i < 3; i++) {
+      float n = std::clamp((pos[i] - _bias[i]) / _scale[i], 0.0f, 1.0f);
+      out[i]  = U16(std::lround(n * 65535.0f));
+    }
+  }
+
+  fvec3 decode(const U16 inp[3]) const {
+    return fvec3(
+        _bias.x + (float(inp[0]) / 65535.0f) * _scale.x,
+        _bias.y + (float(inp[1]) / 65535.0f) * _scale.y,
+        _bias.z + (float(inp[2]) / 65535.0f) * _scale.z);
+  }
+
+  fvec3 _bias;
+  fvec3 _scale;
+};
+
+} // namespace ork::lev2::vtxquant
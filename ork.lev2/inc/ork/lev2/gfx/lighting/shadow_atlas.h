@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ork/math/cvector4.h>
+#include <ork/lev2/gfx/rtgroup.h>
+#include <unordered_map>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// shared shadow atlas for shadowed lights
+//
+//  ShadowAtlasLayout : (cpu only) sizes one power of 2 tile per light from
+//                      its screen coverage, packs the tiles (largest first,
+//                      morton order, so every tile is aligned to its size)
+//                      and tracks which tiles hold valid static caster depth.
+//  ShadowAtlas       : two depth atlases with the same layout :
+//                      _staticRTG  : static casters, only redrawn per tile
+//                                    when the tile, its light or the static
+//                                    casters changed.
+//                      _dynamicRTG : dynamic casters, cleared and redrawn
+//                                    every frame.
+//                      the lighting shader takes the nearer of the two
+//                      depths, so static depth is never copied around.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::lev2 {
+
+struct DrawQueue;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct ShadowAtlasTile {
+  int _x    = 0;
+  int _y    = 0;
+  int _size = 0;
+
+  bool operator==(const ShadowAtlasTile& oth) const {
+    return _x == oth._x and _y == oth._y and _size == oth._size;
+  }
+  //! (u offset, v offset, u scale, v scale) of the tile in the atlas
+  fvec4 uvRect(int atlasdim) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct ShadowAtlasLayout {
+
+  using key_t = const void*;
+
+  struct Request {
+    key_t _key           = nullptr;
+    float _screenSize    = 0.0f; // projected size of what the light covers (pixels)
+    int _maxSize         = 1024; // eg. LightData::shadowMapSize()
+    uint64_t _lightState = 0;    // hash of whatever places the light's shadow camera
+  };
+
+  struct Slot {
+    ShadowAtlasTile _tile;
+    int _wantSize        = 0;
+    uint64_t _lightState = 0;
+    bool _staticValid    = false;
+  };
+
+  ShadowAtlasLayout(int atlasdim = 4096, int mintile = 128);
+
+  //! size in texels for a light covering screensize pixels
+  int desiredSize(float screensize, int maxsize) const;
+
+  //! once per frame : resize (with hysteresis), repack when the set of lights
+  //!  or any tile size changed, invalidate static depth that moved or went stale
+  void update(const std::vector<Request>& requests, uint64_t staticsignature);
+
+  const Slot* slot(key_t key) const;
+  bool needsStaticRender(key_t key) const;
+  void markStaticRendered(key_t key);
+
+  int _atlasDim;
+  int _minTile;
+  float _texelsPerPixel = 1.0f; // quality knob for desiredSize
+  std::unordered_map<key_t, Slot> _slots;
+  uint64_t _staticSignature = 0;
+
+  size_t _numRepacks       = 0;
+  size_t _numStaticRenders = 0;
+
+private:
+  void _pack();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct ShadowAtlas {
+
+  ShadowAtlas(int atlasdim = 4096, int mintile = 128);
+
+  void gpuInit(Context* ctx);
+
+  //! hash of every static caster (drawable, world matrix) in the given layers,
+  //!  also counts the dynamic casters found along the way
+  static uint64_t staticCasterSignature(
+      const DrawQueue* DB, //
+      const std::vector<std::string>& layers,
+      size_t& numdynamic);
+
+  ShadowAtlasLayout _layout;
+  rtgroup_ptr_t _staticRTG;
+  rtgroup_ptr_t _dynamicRTG;
+  std::shared_ptr<RtGroupRenderTarget> _staticIRT;
+  std::shared_ptr<RtGroupRenderTarget> _dynamicIRT;
+  bool _dynamicClear = false; // whole dynamic atlas is at far depth (nothing to redraw)
+};
+
+using shadowatlas_ptr_t = std::shared_ptr<ShadowAtlas>;
+
+} // namespace ork::lev2
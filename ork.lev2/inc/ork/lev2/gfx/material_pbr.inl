@@ -16,6 +16,8 @@
 #include <ork/file/chunkfile.h>
 #include <ork/file/chunkfile.inl>
 #include <ork/kernel/varmap.inl>
+#include <ork/math/box.h>
+#include <ork/gfx/envprefilter.h>
 
 //using namespace boost::filesystem;
 
@@ -43,6 +45,13 @@ struct FilteredEnvMap {
   Texture* _texture = nullptr;
 };
 typedef std::shared_ptr<FilteredEnvMap> filtenvmapptr_t;
+
+// cpu prefiltered (PBRMaterial::prefilterEnvMap)
+struct PrefilteredEnvMaps {
+  texture_ptr_t _specularMap;
+  texture_ptr_t _diffuseMap;
+  fvec3 _sh9[9]; // radiance SH coefficients (bands 0-2)
+};
 ///////////////////////////////////////////////////////////////////////////////
 
 class PBRMaterial final : public GfxMaterial {
@@ -83,6 +92,10 @@ public:
   static texture_ptr_t brdfIntegrationMap(Context* targ);
   static texture_ptr_t filterSpecularEnvMap(texture_ptr_t rawenvmap, Context* targ, bool equirectangular);
   static texture_ptr_t filterDiffuseEnvMap(texture_ptr_t rawenvmap, Context* targ, bool equirectangular);
+  //! specular + diffuse maps of an env map in one pass (cpu, cached)
+  static PrefilteredEnvMaps prefilterEnvMap(texture_ptr_t rawenvmap, Context* targ, bool equirectangular);
+  static uint64_t envPrefilterCacheKey(uint64_t contenthash, bool equirectangular);
+  static datablock_ptr_t bakeEnvPrefilterBundle(const envprefilter::EnvImage& src, bool equirectangular);
 
   ////////////////////////////////////////////
 
@@ -104,6 +117,7 @@ public:
   void UpdateMMatrix(Context* pTARG) final;
 
   void forceEmissive();
+  void bindVertexDequant(Context* context, const AABox& bounds) const; // quantized (_Q) clusters
 
   ////////////////////////////////////////////
   fxpipelinecache_constptr_t _doFxPipelineCache(fxpipelinepermutation_set_constptr_t perms) const final;
@@ -149,6 +163,8 @@ public:
   fxparam_constptr_t _parModColor        = nullptr;
   fxparam_constptr_t _parPickID          = nullptr;
   fxparamblock_constptr_t _parBoneBlock  = nullptr;
+  fxparam_constptr_t _parQuantPosScale  = nullptr;
+  fxparam_constptr_t _parQuantPosBias   = nullptr;
 
   // fwd
 
@@ -221,6 +237,7 @@ public:
   texture_ptr_t _texCubeBlack;
   std::string _textureBaseName;
   std::string _shader_suffix;
+  bool _quantizedVertices = false; // mono techniques resolve to their "_Q" variants
   ///////////////////////////////////////////
 
   // PIK: Picking
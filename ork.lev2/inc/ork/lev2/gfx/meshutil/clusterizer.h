@@ -23,6 +23,7 @@
 #include <ork/lev2/gfx/gfxmaterial.h>
 #include <unordered_map>
 #include <ork/lev2/gfx/meshutil/meshutil.h>
+#include <ork/lev2/gfx/meshutil/meshutil_optimize.h>
 
 namespace ork::meshutil {
 
@@ -56,11 +57,26 @@ struct XgmClusterBuilder {
   //////////////////////////////////////////////////
   void Dump(void);
   ///////////////////////////////////////////////////////////////////
+  // optional, call before buildVertexBuffer :
+  //  reorders triangles (vertex cache, overdraw) and output
+  //  vertices (fetch locality), see meshutil_optimize.h
+  ///////////////////////////////////////////////////////////////////
+  void optimize();
+  bool isOptimized() const {
+    return not _outputIndices.empty();
+  }
+  size_t numOutputVertices() const;
+  const vertex& outputVertex(int iv) const;
+  ///////////////////////////////////////////////////////////////////
   // Build Vertex Buffers
   ///////////////////////////////////////////////////////////////////
   submesh _submesh;
   lev2::vtxbufferbase_ptr_t _vertexBuffer;
   const XgmClusterizer& _clusterizer;
+  index_vect_t _outputOrder;   // output vertex -> _submesh vertex (empty : pool order)
+  index_vect_t _outputIndices; // optimized triangle list (output vertex space)
+  VertexCacheStats _preOptimizeStats;
+  VertexCacheStats _postOptimizeStats;
 };
 
 typedef std::shared_ptr<XgmClusterBuilder> clusterbuilder_ptr_t;
@@ -81,6 +97,8 @@ struct XgmSkinnedClusterBuilder : public XgmClusterBuilder {
   void BuildVertexBuffer_V12N12T8I4W4(lev2::Context& context);
   void BuildVertexBuffer_V12N12B12T8I4W4(lev2::Context& context);
   void BuildVertexBuffer_V12N6I1T4(lev2::Context& context);
+  void BuildVertexBuffer_V8N4B4T4I4W4(lev2::Context& context);
+  void packJointInfluences(const vertex& inpvtx, U32& out_indices, U32& out_weights);
 
   orkmap<std::string, int> _jointRegisterMapX;
 };
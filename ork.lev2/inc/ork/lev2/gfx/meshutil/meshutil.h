@@ -179,6 +179,27 @@ struct MaterialGroup {
   ork::file::Path mLightMapPath;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// skinning influence pruning (used by the assimp importer)
+//  keeps the 4 largest influences (weights clamped to >= 0.001),
+//  renormalized, ordered largest first. equal weights keep input order
+//  exactly as the former multimap based selection did.
+///////////////////////////////////////////////////////////////////////////////
+
+struct RawInfluence {
+  const std::string* _jointpath = nullptr;
+  float _weight                 = 0.0f;
+};
+
+struct PrunedInfluences {
+  int _count                        = 0;
+  const std::string* _jointpaths[4] = {nullptr, nullptr, nullptr, nullptr};
+  float _weights[4]                 = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+/// does not allocate (scratch space is per thread)
+PrunedInfluences pruneInfluences(const RawInfluence* influences, size_t count);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct Mesh {
@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// index buffer optimization for the xgm export path
+//
+//  all passes operate on indexed triangle lists (3 indices per triangle)
+//   and keep the set of triangles (and their winding) intact.
+//
+//  typical order : optimizeVertexCache -> optimizeOverdraw
+//                   -> optimizeVertexFetch -> buildMeshlets
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ork/math/cvector3.h>
+#include <ork/lev2/gfx/gfxmodel.h>
+#include <vector>
+
+namespace ork::meshutil {
+
+using index_vect_t = std::vector<uint32_t>;
+
+///////////////////////////////////////////////////////////////////////////////
+// post transform cache simulation (FIFO)
+//  acmr : average cache miss ratio, transformed vertices per triangle
+//          (0.5 is the limit for large regular grids, 3.0 is no reuse)
+//  atvr : average transform to vertex ratio, transformed vertices per
+//          referenced vertex (1.0 is ideal)
+///////////////////////////////////////////////////////////////////////////////
+
+struct VertexCacheStats {
+  size_t _numTriangles = 0;
+  size_t _numVertices  = 0;
+  size_t _numMisses    = 0;
+  float _acmr          = 0.0f;
+  float _atvr          = 0.0f;
+};
+
+VertexCacheStats analyzeVertexCache(const index_vect_t& indices, size_t numverts, size_t cachesize = 16);
+
+///////////////////////////////////////////////////////////////////////////////
+// Forsyth "linear speed vertex cache optimisation" triangle ordering
+///////////////////////////////////////////////////////////////////////////////
+
+void optimizeVertexCache(index_vect_t& indices, size_t numverts);
+
+///////////////////////////////////////////////////////////////////////////////
+// overdraw aware cluster sort (Sander/Nehab/Barczak, "tipsify" style)
+//  splits the cache ordered list into runs whose local acmr stays within
+//  threshold of the run it came from, then draws outward facing runs first.
+///////////////////////////////////////////////////////////////////////////////
+
+void optimizeOverdraw(index_vect_t& indices, const std::vector<fvec3>& positions, float threshold = 1.05f);
+
+///////////////////////////////////////////////////////////////////////////////
+// renumber vertices in first use order (unreferenced vertices are dropped)
+//  out_order[new_index] = old_index
+//  returns the new vertex count
+///////////////////////////////////////////////////////////////////////////////
+
+size_t optimizeVertexFetch(index_vect_t& indices, index_vect_t& out_order, size_t numverts);
+
+///////////////////////////////////////////////////////////////////////////////
+// greedy meshlet partition in index order (run after the passes above)
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<lev2::XgmMeshlet> buildMeshlets(
+    const index_vect_t& indices,
+    const std::vector<fvec3>& positions,
+    size_t maxverts = lev2::XgmMeshlet::kMAXVERTICES,
+    size_t maxtris  = lev2::XgmMeshlet::kMAXTRIANGLES);
+
+} // namespace ork::meshutil
@@ -351,6 +351,9 @@ void submeshClipWithPlane(
     bool debug = false);
 
 void submeshPrune(const submesh& inpsubmesh, submesh& outsmesh);
+// QEM decimation to target_ratio of the input triangle count
+//  (stops early once the cheapest collapse costs more than max_error, if > 0)
+void submeshSimplify(const submesh& inpsubmesh, submesh& outsubmesh, float target_ratio, double max_error = 0.0);
 void submeshWithTextureBasis(const submesh& inpsubmesh, submesh& outsmesh);
 void submeshWithTextureUnwrap(const submesh& inpsubmesh, submesh& outsmesh);
 
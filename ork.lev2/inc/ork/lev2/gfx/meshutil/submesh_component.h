@@ -208,6 +208,34 @@ struct vertex {
 using vertex_set_t = unique_set<vertex>;
 using vertexconst_set_t = unique_set<const vertex>;
 
+///////////////////////////////////////////////////////////////////////////////
+// VertexWeldTable : flat open addressing (linear probe) map
+//   of vertex hash -> vertexpool index, no per entry allocations
+///////////////////////////////////////////////////////////////////////////////
+
+struct VertexWeldTable {
+
+  static constexpr uint32_t kEMPTY = 0xffffffff;
+
+  /// pool index for hash, or kEMPTY
+  uint32_t find(uint64_t hash) const;
+  /// insert a hash which is not yet present
+  void insert(uint64_t hash, uint32_t index);
+  void reserve(size_t count);
+  void clear();
+  size_t size() const {
+    return _count;
+  }
+
+private:
+  void _resize(size_t capacity);
+
+  std::vector<uint64_t> _hashes;
+  std::vector<uint32_t> _indices;
+  size_t _mask  = 0;
+  size_t _count = 0;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct vertexpool {
@@ -230,7 +258,7 @@ struct vertexpool {
 
   static const vertexpool EmptyPool;
 
-  std::unordered_map<uint64_t, vertex_ptr_t> _vtxmap;
+  VertexWeldTable _weldtable;
   orkvector<vertex_ptr_t> _orderedVertices;
 };
 
@@ -44,6 +44,15 @@ struct PixelFetchContext {
   pickvariant_t decodePixel(fvec4 fv4_pixel);
   pickvariant_t decodePixel(u32vec4 u32v4_pixel);
 
+  // raw texel <-> pick value, shared by synchronous and readback fetches
+  EBufferFormat readbackFormat(int mrtindex) const;
+  void decodeTexel(int mrtindex, EBufferFormat fmt, const void* texel);
+
+  // FBI::GetPixel through _gfxContext's readback ring : the values land in
+  //  a snapshot of this context, handed to callback on the main serial queue
+  using fetch_callback_t = std::function<void(pixelfetchctx_ptr_t)>;
+  void fetchPixelAsync(const fvec4& rAt, fetch_callback_t callback) const;
+
   //////////////////////
 
   enum EPixelUsage {
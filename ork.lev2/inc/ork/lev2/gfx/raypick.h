@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ork/math/bvh.h>
+#include <ork/math/line.h>
+#include <ork/math/cmatrix4.h>
+#include <ork/lev2/lev2_types.h>
+#include <ork/lev2/gfx/gfxenv_enum.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// CPU ray picking
+//
+//  PickMesh  : triangle soup + BVH4 in model space,
+//              one per XgmModel (LOD 0, bind pose), built at load time
+//  PickScene : BVH4 over instance world bounds, rebuilt per query batch,
+//              rays are moved into model space per instance
+//
+//  hits carry what the pick buffer MRTs carry : position, normal, uv
+//  (the caller maps _instance back to a pick id)
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::lev2 {
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct RayPickHit {
+  float _distance = std::numeric_limits<float>::infinity(); // ray parameter
+  int _instance   = -1;
+  int _triangle   = -1;
+  fvec3 _position;
+  fvec3 _normal;
+  fvec2 _uv;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct PickMesh {
+
+  struct Triangle { // moller trumbore layout
+    fvec3 _p0;
+    fvec3 _e1;
+    fvec3 _e2;
+  };
+  struct Attributes {
+    fvec3 _normal[3];
+    fvec2 _uv[3];
+  };
+
+  void addTriangle(const fvec3* positions, const fvec3* normals, const fvec2* uvs);
+
+  //! decode an xgm cluster's vertex/index data (false if the format is not pickable)
+  bool addCluster(
+      EVtxStreamFormat format,
+      const void* vertices,
+      int numvertices,
+      const fvec3& boxmin,
+      const fvec3& boxmax,
+      PrimitiveType primtype,
+      const U16* indices,
+      int numindices);
+
+  void build();
+
+  //! model space, hit._distance is the current tmax
+  bool intersect(const fray3& ray, RayPickHit& hit) const;
+
+  datablock_ptr_t serialize() const;
+  bool deserialize(datablock_ptr_t datablock);
+
+  size_t numTriangles() const {
+    return _triangles.size();
+  }
+
+  BVH4 _bvh;
+  std::vector<Triangle> _triangles;   // BVH order after build()
+  std::vector<Attributes> _attributes; // parallel to _triangles
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct PickScene {
+
+  struct Instance {
+    pickmesh_constptr_t _mesh;
+    fmtx4 _world;
+    fmtx4 _invworld;
+    fmtx4 _normalmatrix; // inverse transpose of _world
+    uint64_t _userdata = 0;
+  };
+
+  void clear();
+  int addInstance(pickmesh_constptr_t mesh, const fmtx4& world, uint64_t userdata = 0);
+  void build();
+
+  //! world space closest hit
+  bool intersect(const fray3& ray, RayPickHit& hit) const;
+
+  std::vector<Instance> _instances;
+  BVH4 _bvh;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::lev2
+///////////////////////////////////////////////////////////////////////////////
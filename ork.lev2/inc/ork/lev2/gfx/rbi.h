@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/// ////////////////////////////////////////////////////////////////////////////
+/// ////////////////////////////////////////////////////////////////////////////
+/// Asynchronous Readback Interface
+///  a readback copies a rect of a render target into a slot of a ring of
+///  pixel pack buffers and fences it. the oldest fences are polled once per
+///  frame (Context::beginFrame), and finished readbacks are handed to their
+///  callback on an opq queue, typically a frame or two after the request.
+///  the render thread only waits on the gpu when every slot is in flight.
+/// ////////////////////////////////////////////////////////////////////////////
+/// ////////////////////////////////////////////////////////////////////////////
+
+struct ReadbackResult {
+
+  template <typename T> const T& texel(int x, int y) const {
+    OrkAssert(sizeof(T) == _bytesPerTexel);
+    OrkAssert(x >= 0 and x < _width and y >= 0 and y < _height);
+    return *((const T*)(_bytes.data() + (size_t(y) * size_t(_width) + size_t(x)) * _bytesPerTexel));
+  }
+
+  uint64_t _ticket      = 0;
+  EBufferFormat _format = EBufferFormat::NONE;
+  int _x                = 0;
+  int _y                = 0;
+  int _width            = 0;
+  int _height           = 0;
+  size_t _bytesPerTexel = 0;
+  int _submitFrame      = 0;
+  int _completeFrame    = 0;
+  std::vector<uint8_t> _bytes; // rows bottom to top, as the gpu stores them
+};
+
+using readbackresult_ptr_t = std::shared_ptr<ReadbackResult>;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct ReadbackRequest {
+
+  using callback_t = std::function<void(readbackresult_ptr_t)>;
+
+  static size_t bytesPerTexel(EBufferFormat fmt);
+  size_t length() const {
+    return bytesPerTexel(_format) * size_t(_width) * size_t(_height);
+  }
+
+  const RtBuffer* _source = nullptr; // nullptr : main surface back buffer
+  int _x                  = 0;
+  int _y                  = 0;
+  int _width              = 1;
+  int _height             = 1;
+  EBufferFormat _format   = EBufferFormat::RGBA8; // destination format (the gpu converts)
+  callback_t _onComplete;
+  opq::opq_ptr_t _queue; // nullptr : opq::concurrentQueue()
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct ReadbackStats {
+  size_t _numRequests   = 0;
+  size_t _numCompleted  = 0;
+  size_t _numPolls      = 0; // fence tests
+  size_t _numNotReady   = 0; // fence tests that found the gpu still busy
+  size_t _numStalls     = 0; // ring full : waited on the oldest slot
+  size_t _latencyFrames = 0; // sum of (complete frame - submit frame)
+  size_t _bytesRead     = 0;
+  float averageLatency() const {
+    return _numCompleted ? float(_latencyFrames) / float(_numCompleted) : 0.0f;
+  }
+  void reset() {
+    *this = ReadbackStats();
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class ReadbackInterface {
+public:
+  static constexpr int knumslots = 8;
+
+  ReadbackInterface(Context& ctx, int numslots = knumslots);
+  virtual ~ReadbackInterface();
+
+  uint64_t enqueue(const ReadbackRequest& req); // returns the result's ticket
+  void poll(int frame);                          // deliver what the gpu has finished
+  void flush();                                  // wait on and deliver everything in flight
+
+  size_t numInFlight() const;
+  ReadbackStats stats() const;
+  void resetStats();
+
+  int _minLatency = 1; // frames before a slot's fence is first tested
+
+protected:
+  ///////////////////////////////////////////////////////
+  // backend : one pack buffer and fence per slot
+  ///////////////////////////////////////////////////////
+
+  virtual void _doSubmit(int slot, const ReadbackRequest& req) = 0; // copy to the slot and fence it
+  virtual bool _doPoll(int slot)                               = 0; // non blocking fence test
+  virtual void _doWait(int slot)                               = 0; // blocking fence wait
+  virtual void _doFetch(int slot, ReadbackResult& result)      = 0; // copy out, release the fence
+
+  Context& _target;
+
+private:
+  struct Slot {
+    ReadbackRequest _request;
+    uint64_t _ticket = 0;
+    int _submitFrame = 0;
+  };
+
+  void _retireOldest(int frame);
+
+  mutable std::mutex _mutex;
+  std::vector<Slot> _slots;
+  int _oldest      = 0; // slots are submitted and retired in ring order
+  int _numInFlight = 0;
+  int _frame       = 0;
+  uint64_t _ticket = 0;
+  ReadbackStats _stats;
+};
@@ -53,6 +53,7 @@ struct IrradianceMaps {
   texture_ptr_t _filtenvSpecularMap;
   texture_ptr_t _filtenvDiffuseMap;
   texture_ptr_t _brdfIntegrationMap;
+  fvec3 _sh9[9]; // radiance SH of the environment (bands 0-2)
   asset::loadrequest_ptr_t _loadRequest;
 
 };
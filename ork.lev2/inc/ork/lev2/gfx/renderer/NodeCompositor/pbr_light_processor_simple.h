@@ -13,6 +13,7 @@
 #include <ork/lev2/gfx/renderer/compositor.h>
 #include <ork/lev2/gfx/renderer/irendertarget.h>
 #include <ork/lev2/gfx/lighting/gfx_lighting.h>
+#include <ork/lev2/gfx/lighting/shadow_atlas.h>
 
 namespace ork::lev2::pbr::deferrednode {
 
@@ -58,6 +59,7 @@ struct SimpleLightProcessor {
   FxShaderParamBuffer* _lightbuffer = nullptr;
   DeferredContext& _deferredContext;
   DeferredCompositingNodePbr* _defcompnode;
+  shadowatlas_ptr_t _shadowAtlas; // shadowed spot lights
 };
 
 } // namespace ork::lev2::deferrednode
@@ -131,6 +131,7 @@ struct DeferredContext {
   const FxShaderParam* _parMapDepth            = nullptr;
   const FxShaderParam* _parMapDepthCluster     = nullptr;
   const FxShaderParam* _parMapShadowDepth      = nullptr;
+  const FxShaderParam* _parMapShadowDepthDynamic = nullptr;
   const FxShaderParam* _parMapSpecularEnv      = nullptr;
   const FxShaderParam* _parMapDiffuseEnv       = nullptr;
   const FxShaderParam* _parMapBrdfIntegration  = nullptr;
@@ -163,6 +164,7 @@ struct DeferredContext {
   const FxShaderParamBlock* _lightblock        = nullptr;
   const FxShaderParam* _parLightCookieTexture  = nullptr;
   const FxShaderParam* _parShadowParams        = nullptr;
+  const FxShaderParam* _parShadowAtlasRect     = nullptr;
 
   ////////////////////////////////////////////////////////////////////
 
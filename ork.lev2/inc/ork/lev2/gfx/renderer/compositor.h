@@ -163,6 +163,7 @@ struct CompositingPassData {
   uint32_t _passID = 0;
   float _time = 0.0f;
   bool _ispicking = false;
+  bool _isAuxiliaryView = false; // shadow / probe views (not the primary camera)
   std::vector<std::string> _layernames;
   std::unordered_set<std::string> _layernameset;
   int _width = 0;
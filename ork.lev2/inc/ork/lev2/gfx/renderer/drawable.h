@@ -19,6 +19,7 @@
 #include <ork/object/ObjectClass.h>
 #include <ork/rtti/RTTI.h>
 #include <ork/util/tsl/robin_map.h>
+#include <memory_resource>
 //#include <ork/util/triple_buffer.h>
 
 #include <ork/lev2/gfx/camera/cameradata.h>
@@ -86,15 +87,104 @@ struct DrawQueueTransferData {
   bool _use_modcolor = false;
 };
 
+///////////////////////////////////////////////////////////////////////////
+// DrawQueueArena
+//  frame-linear memory backing a DrawQueue's items and their usermaps.
+//  allocation is a lock free bump within the current block (a mutex is
+//   only taken to move to another block), frees only drop a live count.
+//  blocks are recycled when the owning DrawQueue is Reset() by the next
+//   writer of its concurrent_triple_buffer slot. a block an item is still
+//   held in stays pinned (skipped) until its last allocation is freed.
+//  items hold a reference on the arena (DrawQueueArenaAllocator), so an
+//   item that outlives its DrawQueue keeps the arena, and its blocks,
+//   alive until it is freed.
+///////////////////////////////////////////////////////////////////////////
+
+struct DrawQueueArena final : public std::pmr::memory_resource {
+
+  static constexpr size_t kblocksize = 256 << 10;
+
+  struct Block {
+    Block(size_t size);
+    ~Block();
+    uint8_t* _base = nullptr;
+    size_t _size   = 0;
+    std::atomic<size_t> _offset;
+    std::atomic<size_t> _numlive;
+  };
+
+  struct Stats {
+    size_t _numallocs = 0;
+    size_t _numbytes  = 0;
+    size_t _numblocks = 0;
+    size_t _numpinned = 0; // blocks not recycled, still holding live allocations
+  };
+
+  DrawQueueArena();
+  ~DrawQueueArena();
+
+  bool recycle(); // false if some blocks stayed pinned by live allocations
+
+  const Stats& lastFrameStats() const {
+    return _lastframe;
+  }
+
+  std::atomic<Block*> _current;
+  std::vector<Block*> _blocks; // guarded by _mutex
+  size_t _blockindex = 0;
+  ork::mutex _mutex;
+  std::atomic<size_t> _numallocs;
+  std::atomic<size_t> _numbytes;
+  std::atomic<size_t> _numlive;
+  size_t _numdeferred = 0; // recycles that left pinned blocks behind
+  Stats _lastframe;
+
+private:
+  void _nextBlock(Block* exhausted, size_t minsize);
+  void* do_allocate(size_t bytes, size_t alignment) final;
+  void do_deallocate(void* p, size_t bytes, size_t alignment) final;
+  bool do_is_equal(const std::pmr::memory_resource& oth) const noexcept final {
+    return this == &oth;
+  }
+};
+
+using drawqueuearena_ptr_t = std::shared_ptr<DrawQueueArena>;
+
+template <typename T> struct DrawQueueArenaAllocator {
+  using value_type = T;
+  DrawQueueArenaAllocator(drawqueuearena_ptr_t arena)
+      : _arena(arena) {
+  }
+  template <typename U>
+  DrawQueueArenaAllocator(const DrawQueueArenaAllocator<U>& oth)
+      : _arena(oth._arena) {
+  }
+  T* allocate(size_t n) {
+    return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* p, size_t n) {
+    _arena->deallocate(p, n * sizeof(T), alignof(T));
+  }
+  template <typename U> bool operator==(const DrawQueueArenaAllocator<U>& oth) const {
+    return _arena == oth._arena;
+  }
+  template <typename U> bool operator!=(const DrawQueueArenaAllocator<U>& oth) const {
+    return _arena != oth._arena;
+  }
+  drawqueuearena_ptr_t _arena;
+};
+
 ///////////////////////////////////////////////////////////////////////////
 
 struct DrawQueueItem {
 public:
   typedef ork::lev2::IRenderable::var_t var_t;
 
-  using usermap_t = std::unordered_map<uint32_t, rendervar_t>;
+  using usermap_t = std::pmr::unordered_map<uint32_t, rendervar_t>;
 
-  DrawQueueItem();
+  DrawQueueItem(
+      const DrawQueueTransferData& xfdata, //
+      std::pmr::memory_resource* mem = std::pmr::get_default_resource());
   ~DrawQueueItem();
 
   void terminate();
@@ -127,6 +217,7 @@ struct DrawQueueLayer {
 
   std::string _name;
   LockedResource<itemvect_t> _items;
+  drawqueuearena_ptr_t _arena;
   int _itemIndex;
   int miBufferIndex;
   std::atomic<int> _state;
@@ -142,6 +233,32 @@ struct DrawQueueLayer {
 
 }; // ~ 100K
 
+///////////////////////////////////////////////////////////////////////////
+// DrawQueueSlab - private item staging for one enqueue worker
+//  while bound to a thread, DrawQueueLayer::enqueueDrawable lands items
+//  in the slab instead of the layer's locked item vector.
+//  DrawQueue::mergeSlabs appends them to their layers in slab order,
+//  so the result does not depend on which worker filled which slab.
+///////////////////////////////////////////////////////////////////////////
+
+struct DrawQueueSlab {
+
+  using itemvect_t = std::vector<drawqueueitem_ptr_t>;
+
+  struct LayerItems {
+    DrawQueueLayer* _layer = nullptr;
+    itemvect_t _items;
+  };
+
+  void bindToThread();
+  void unbindFromThread();
+  static DrawQueueSlab* boundToThread();
+
+  void _append(DrawQueueLayer* layer, drawqueueitem_ptr_t item);
+
+  std::vector<LayerItems> _layers; // few layers per frame, linear lookup
+};
+
 ///////////////////////////////////////////////////////////////////////////
 // DrawQueue - multi-buffered queue of drawables
 //  used for transferring drawables from update-thread to render-thread
@@ -161,6 +278,7 @@ public:
   typedef ork::fixedlut<int, prerendercallback_t, 32> CallbackLut_t;
 
   LockedResource<cameradatalut_ptr_t> _cameraDataLUT;
+  drawqueuearena_ptr_t _arena; // shared with the items allocated from it
   DrawQueueLayer mRawLayers[kmaxlayers];
   LayerLut mLayerLut;
   orkset<std::string> mLayers;
@@ -224,6 +342,10 @@ public:
 
   static ork::atomic<bool> gbInsideClearAndSync;
 
+  const DrawQueueArena::Stats& arenaStats() const {
+    return _arena->lastFrameStats();
+  }
+
   void copyCameras(const CameraDataLut& cameras);
   void Reset();
   void terminate();
@@ -248,8 +370,15 @@ public:
   cameradata_constptr_t cameraData(const std::string& named) const;
 
   DrawQueueLayer* MergeLayer(const std::string& layername);
+  void mergeSlabs(std::vector<DrawQueueSlab>& slabs);
+
+  using itemfilter_t = std::function<bool(const DrawQueueItem&)>;
 
-  void enqueueLayerToRenderQueue(const std::string& LayerName, lev2::IRenderer* renderer) const;
+  //! filter (optional) picks which of the layer's items get enqueued
+  void enqueueLayerToRenderQueue(
+      const std::string& LayerName, //
+      lev2::IRenderer* renderer,
+      const itemfilter_t& filter = nullptr) const;
 
 }; // ~1MiB
 
@@ -334,6 +463,10 @@ struct Drawable {
   virtual bool isInstanced() const {
     return false;
   }
+  // may enqueueOnLayer run on an opq worker (concurrently with other drawables) ?
+  virtual bool canEnqueueConcurrently() const {
+    return true;
+  }
 
   pickvariant_t _pickID;
   var_t mDataA;
@@ -345,6 +478,7 @@ struct Drawable {
   on_render_rcid_t _rendercb_user;
   bool mEnabled;
   bool _pickable = true;
+  bool _staticShadowCaster = false; // never moves : its shadow depth is cached (see ShadowAtlas)
   std::string _name;
   scenegraph::scene_ptr_t _sg;
   scenegraph::node_ptr_t _sgnode;
@@ -690,6 +824,10 @@ struct CallbackDrawable : public Drawable {
   }
   void enqueueToRenderQueue(drawqueueitem_constptr_t item, lev2::IRenderer* renderer) const final;
   drawqueueitem_ptr_t enqueueOnLayer(const DrawQueueTransferData& xfdata, DrawQueueLayer& buffer) const final;
+  // user enqueue callbacks (python/lua included) stay on the update thread
+  bool canEnqueueConcurrently() const final {
+    return (_enqueueOnLayerCallback == nullptr) and (not _enqueueOnLayerLambda);
+  }
 
   ICallbackDrawableDataDestroyer* mDataDestroyer;
   lev2::CallbackRenderable::cbtype_t mRenderCallback;
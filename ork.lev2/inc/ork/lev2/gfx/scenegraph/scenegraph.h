@@ -172,10 +172,21 @@ struct SgPickBuffer {
 
   using callback_t = std::function<void(pixelfetchctx_ptr_t)>;
 
+  // render thread time spent per gpu pick, readback included
+  struct FetchTimings {
+    size_t _numPicks = 0;
+    double _seconds  = 0.0;
+    double averageMsec() const {
+      return _numPicks ? (_seconds * 1000.0 / double(_numPicks)) : 0.0;
+    }
+  };
+
   SgPickBuffer(ork::lev2::Context* ctx, Scene& scene);
-  void mydraw(fray3_constptr_t ray);
+  bool mydraw(fray3_constptr_t ray, callback_t callback);
   void pickWithRay(fray3_constptr_t ray, callback_t callback);
+  void pickWithRayCPU(fray3_constptr_t ray, callback_t callback);
   void pickWithScreenCoord(cameradata_ptr_t cam, fvec2 screencoord, callback_t callback);
+  void _gatherPickScene();
   lev2::Context* _context    = nullptr;
   CompositingData* _compdata = nullptr;
 
@@ -188,6 +199,10 @@ struct SgPickBuffer {
   const ork::lev2::Texture* _pickPOStexture = nullptr;
   const ork::lev2::Texture* _pickNRMtexture = nullptr;
   const ork::lev2::Texture* _pickUVtexture = nullptr;
+  pickscene_ptr_t _pickScene;
+  std::vector<drawable_ptr_t> _pickDrawables; // PickScene instance userdata : drawable index<<32 | instance index
+  FetchTimings _syncTimings;
+  FetchTimings _asyncTimings;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -281,6 +296,8 @@ struct Scene {
   synchro_ptr_t _synchro;
   float _currentTime = 0.0f;
   uint32_t _pickFormat = 0;
+  bool _cpuPicking = false; // ray pick against model pick meshes instead of rendering the pick buffer
+  bool _asyncPickReadback = true; // pick buffer texels come back through Context::RBI(), not FBI::GetPixel
   bool _doResizeFromMainSurface = false;
   using layer_map_t = std::map<std::string, layer_ptr_t>;
 
@@ -295,9 +312,13 @@ struct Scene {
   struct DrawItem{
     ork::lev2::DrawQueueLayer * _layer;
     drawable_node_ptr_t _drwnode;
+    bool _concurrent = true;
   };
 
   std::vector<DrawItem> _nodes2draw;
+  std::vector<DrawQueueSlab> _enqueueSlabs; // one per chunk of _nodes2draw
+  std::vector<uint8_t> _enqueueSlabDeferred;
+  int _enqueueGrainSize = 256; // nodes per chunk, 0 : serial enqueue
   bool _enable_pick_hud = false;
 
 };
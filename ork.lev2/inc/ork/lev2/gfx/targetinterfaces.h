@@ -26,6 +26,7 @@
 #include <ork/file/chunkfile.inl>
 #include <ork/kernel/datablock.h>
 #include <ork/kernel/mutex.h>
+#include <ork/kernel/opq.h>
 #include <ork/lev2/gfx/gfxenv_enum.h>
 #include <ork/lev2/gfx/gfxrasterstate.h>
 #include <ork/lev2/gfx/gfxvtxbuf.h>
@@ -112,6 +113,7 @@ struct CaptureBuffer {
 #include "rsi.h"
 #include "ci.h"
 #include "dwi.h"
+#include "rbi.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 }} // namespace ork::lev2
@@ -36,6 +36,13 @@ public:
 
   file::Path _hfpath;
   fvec3 _visualOffset;
+
+  // streaming (CDLOD) mode : tiles paged from a baked tile file,
+  //  for heightfields too large to keep whole (see terrain_streaming.h)
+  bool _streaming           = false;
+  int _streamTileSize       = 64;
+  int _streamResidentBudget = 512;  // tiles
+  float _streamLodDistance  = 0.0f; // level 0 range, <= 0 : derived from tile size
 };
 
 using terraindrawabledata_ptr_t = std::shared_ptr<TerrainDrawableData>;
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <ork/lev2/gfx/terrain/heightmap.h>
+#include <ork/lev2/gfx/gfxvtxbuf_structs.h>
+#include <ork/kernel/mutex.h>
+#include <ork/file/asyncread.h>
+#include <ork/math/frustum.h>
+#include <ork/math/box.h>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+
+///////////////////////////////////////////////////////////////////////////////
+// streaming terrain (CDLOD)
+//
+//  TerrainTileFile : heightfield baked into a quadtree of fixed size tiles.
+//                    level 0 is the finest, each level up point samples at
+//                    twice the stride (so coarse vertices sit on fine ones).
+//                    16 bit heights with a 1 texel apron for normals,
+//                    plus a per node min/max table which stays in memory.
+//  TerrainStreamer : per camera quadtree selection (CDLOD ranges + frustum),
+//                    missing tiles read in one AsyncReadBatch per frame,
+//                    meshes and normals built in the read completions
+//                    (opq workers), resident tiles capped by a budget
+//                    with LRU eviction.
+//
+//  a node only refines once the children it needs are resident,
+//   until then it draws whole : streaming can pop, but never opens holes
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::lev2 {
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct TerrainTileFile {
+
+  static constexpr uint32_t kMagic   = 0x5454524f; // "ORTT"
+  static constexpr uint32_t kVersion = 0;
+
+  struct Header {
+    uint32_t _magic    = kMagic;
+    uint32_t _version  = kVersion;
+    int32_t _dim       = 0;    // level 0 texels per side (power of 2)
+    int32_t _tilesize  = 0;    // quads per tile side (power of 2)
+    int32_t _numlevels = 0;    // root is level _numlevels-1 (1 tile)
+    float _hmin        = 0.0f; // normalized heights (as HeightMap stores them)
+    float _hmax        = 0.0f;
+  };
+
+  //! point sampled pyramid of hmap (uses the largest power of 2 square that fits)
+  static bool bake(const HeightMap& hmap, const std::string& path, int tilesize);
+
+  //! reads the header and min/max table, tiles are paged in by TerrainStreamer
+  bool open(const std::string& path);
+
+  int tilesAcross(int level) const {
+    return (_header._dim / _header._tilesize) >> level;
+  }
+  int samplesPerSide() const {
+    return _header._tilesize + 3;
+  }
+  size_t tileBytes() const {
+    return size_t(samplesPerSide()) * size_t(samplesPerSide()) * sizeof(uint16_t);
+  }
+  size_t nodeIndex(int level, int tx, int tz) const {
+    return _levelbase[level] + size_t(tz) * size_t(tilesAcross(level)) + size_t(tx);
+  }
+  size_t tileOffset(int level, int tx, int tz) const {
+    return _tiledataoffset + nodeIndex(level, tx, tz) * tileBytes();
+  }
+  //! normalized (min,max) height over everything the node covers
+  const fvec2& nodeMinMax(int level, int tx, int tz) const {
+    return _minmax[nodeIndex(level, tx, tz)];
+  }
+  float decodeHeight(uint16_t q) const {
+    return _header._hmin + float(q) * (_header._hmax - _header._hmin) * (1.0f / 65535.0f);
+  }
+
+  std::string _path;
+  Header _header;
+  std::vector<size_t> _levelbase; // first node index of each level
+  std::vector<fvec2> _minmax;     // per node, all levels
+  size_t _tiledataoffset = 0;
+};
+
+using terraintilefile_ptr_t = std::shared_ptr<TerrainTileFile>;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct TerrainTile {
+  // position, normal, uv.xyz : position on the next coarser level (morph target)
+  using vertex_t = SVtxV12N12T16;
+
+  int _level = 0;
+  int _tx    = 0;
+  int _tz    = 0;
+  AABox _bounds;
+  std::vector<vertex_t> _vertices;     // released once uploaded
+  vtxbufferbase_ptr_t _gpuvertices;    // owned by the renderer
+  uint64_t _lastframe = 0;
+  std::list<uint64_t>::iterator _lruit;
+};
+
+using terraintile_ptr_t = std::shared_ptr<TerrainTile>;
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct TerrainSelection {
+  terraintile_ptr_t _tile;
+  uint32_t _quadmask = 0xf; // quadrants to draw, bit (qz*2+qx)
+  float _morphStart  = 0.0f;
+  float _morphEnd    = 0.0f;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct TerrainStreamer {
+
+  using completed_t = LockedResource<std::vector<terraintile_ptr_t>>;
+
+  TerrainStreamer(terraintilefile_ptr_t file, float worldsize, float worldheight);
+  ~TerrainStreamer();
+
+  static uint64_t tileKey(int level, int tx, int tz) {
+    return (uint64_t(level) << 48) | (uint64_t(uint32_t(tz)) << 24) | uint64_t(uint32_t(tx));
+  }
+  //! mesh + normals + morph targets of one node from its samples (runs on opq workers)
+  static terraintile_ptr_t generateTile(
+      const TerrainTileFile& file, //
+      const uint16_t* samples,
+      float worldsize,
+      float worldheight,
+      int level,
+      int tx,
+      int tz);
+
+  //! once per frame : collect finished tiles, select, request, evict
+  //!  campos and frustum in terrain space, frustum may be null
+  void update(const fvec3& campos, const Frustum* frustum = nullptr);
+  //! block until every tile read (and its mesh) has completed
+  void waitIdle() const;
+
+  int topLevel() const {
+    return _file->_header._numlevels - 1;
+  }
+  float nodeWorldSize(int level) const;
+  AABox nodeBounds(int level, int tx, int tz) const;
+  float lodRange(int level) const;
+  size_t numInFlight() const {
+    return _requested.size();
+  }
+
+  terraintilefile_ptr_t _file;
+  float _worldSize   = 1.0f;
+  float _worldHeight = 1.0f;
+
+  float _lodDistance    = 0.0f; // level 0 range, <= 0 : 2.5 level 0 nodes
+  float _morphFraction  = 0.3f; // outer part of each range spent morphing
+  size_t _residentBudget = 512; // tiles (exceeded only by tiles in use)
+  size_t _maxInFlight    = 16;
+
+  uint64_t _frame = 0;
+  std::vector<TerrainSelection> _selection;
+  std::vector<terraintile_ptr_t> _uploads; // became resident this frame
+  std::vector<terraintile_ptr_t> _evicted; // left residency this frame
+
+  std::unordered_map<uint64_t, terraintile_ptr_t> _resident;
+  std::list<uint64_t> _lru; // front : most recently used
+  std::unordered_set<uint64_t> _requested; // not yet collected
+  std::shared_ptr<completed_t> _completed; // written by read completions
+  std::vector<file::asyncreadbatch_ptr_t> _batches;
+
+  size_t _numLoaded  = 0;
+  size_t _numEvicted = 0;
+
+private:
+  bool _selectNode(int level, int tx, int tz);
+  bool _wantsNode(int level, int tx, int tz) const;
+  void _emit(terraintile_ptr_t tile, uint32_t quadmask);
+  terraintile_ptr_t _touch(int level, int tx, int tz);
+  void _request(int level, int tx, int tz);
+  void _evict();
+
+  file::asyncreadbatch_ptr_t _batch; // this frame's requests
+
+  fvec3 _campos;
+  const Frustum* _frustum = nullptr;
+};
+
+using terrainstreamer_ptr_t = std::shared_ptr<TerrainStreamer>;
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::lev2
+///////////////////////////////////////////////////////////////////////////////
@@ -393,6 +393,17 @@ using xgmmodelinst_ptr_t      = std::shared_ptr<XgmModelInst>;
 using xgmmodelinst_constptr_t = std::shared_ptr<const XgmModelInst>;
 using xgmmaterial_override_map_ptr_t = std::shared_ptr<XgmMaterialOverrideMap>;
 
+///////////////////////////////////////////////////////////////////////////////
+// CPU ray picking
+///////////////////////////////////////////////////////////////////////////////
+
+struct PickMesh;
+struct PickScene;
+
+using pickmesh_ptr_t      = std::shared_ptr<PickMesh>;
+using pickmesh_constptr_t = std::shared_ptr<const PickMesh>;
+using pickscene_ptr_t     = std::shared_ptr<PickScene>;
+
 ///////////////////////////////////////////////////////////////////////////////
 // XgmAnimation
 ///////////////////////////////////////////////////////////////////////////////
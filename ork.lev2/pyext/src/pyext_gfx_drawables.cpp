@@ -320,6 +320,10 @@ void pyinit_gfx_drawables(py::module& module_lev2) {
               "rock1",
               [](terraindrawabledata_ptr_t drw) -> fvec3 { return drw->_rock1; },
               [](terraindrawabledata_ptr_t drw, fvec3 val) { drw->_rock1 = val; })
+          .def_property(
+              "streaming",
+              [](terraindrawabledata_ptr_t drw) -> bool { return drw->_streaming; },
+              [](terraindrawabledata_ptr_t drw, bool val) { drw->_streaming = val; })
           .def("writeHmapPath", [](terraindrawabledata_ptr_t drw, std::string path) { drw->_writeHmapPath(path); });
   type_codec->registerStdCodec<terraindrawabledata_ptr_t>(terdrawdata_type);
   /////////////////////////////////////////////////////////////////////////////////
@@ -96,6 +96,14 @@ void pyinit_scenegraph(py::module& module_lev2) {
               [](drawable_node_ptr_t node, int key) { //
                 node->_drawable->_sortkey = key;
               })
+          .def_property(
+              "staticShadowCaster",
+              [](drawable_node_ptr_t node) -> bool { //
+                return node->_drawable->_staticShadowCaster;
+              },
+              [](drawable_node_ptr_t node, bool ena) { //
+                node->_drawable->_staticShadowCaster = ena;
+              })
           .def_property_readonly(
               "instanceData",
               [](drawable_node_ptr_t drwnode) -> instanceddrawinstancedata_ptr_t {
@@ -422,6 +430,14 @@ void pyinit_scenegraph(py::module& module_lev2) {
               [](scene_ptr_t SG, int time) { //
                 SG->_pickFormat = int(time);
               })
+          .def_property(
+              "asyncPickReadback",
+              [](scene_ptr_t SG) -> bool { //
+                return SG->_asyncPickReadback;
+              },
+              [](scene_ptr_t SG, bool value) { //
+                SG->_asyncPickReadback = value;
+              })
           .def_property_readonly(
               "layers",
               [](scene_ptr_t SG) -> py::dict { //
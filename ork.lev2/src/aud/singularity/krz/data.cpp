@@ -80,7 +80,7 @@ bankdata_ptr_t KrzSynthData::baseObjects() {
   KrzBankDataParser parser;
   parser._parsingROM = true;
   parser._sampledata = SOUNDBLOCKS;
-  auto as_str = std::string(dblock->_storage.begin(), dblock->_storage.end());
+  auto as_str = std::string((const char*)dblock->data(), dblock->length());
   parser.loadKrzJsonFromString(as_str, 0);
   return parser._objdb;
 }
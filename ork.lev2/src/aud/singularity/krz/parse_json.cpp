@@ -10,6 +10,7 @@
 #include <ork/lev2/aud/singularity/krzobjects.h>
 #include <ork/lev2/aud/singularity/krzdata.h>
 #include <ork/kernel/string/string.h>
+#include <ork/file/asyncread.h>
 #include <ork/lev2/aud/singularity/alg_oscil.h>
 #include <ork/lev2/aud/singularity/alg_filters.h>
 #include <ork/lev2/aud/singularity/alg_nonlin.h>
@@ -25,24 +26,28 @@ namespace ork::audio::singularity {
 struct SoundBlockData {
 
   SoundBlockData() {
-    _romDATA       = (s16*)malloc(24 << 20);
-    auto data_read = _romDATA;
+    // page aligned so the blocks can be read with O_DIRECT
+    _romDATA       = (s16*)aligned_alloc(file::kDIRECT_ALIGN, 24 << 20);
+    auto data_read = (uint8_t*)_romDATA;
     ///////////////////////////////////////////////////////////////////////////////////////////
+    // all three blocks are read concurrently, straight into the rom image
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    file::AsyncReadBatch batch(nullptr);
     auto load_sound_block = [&](file::Path filename, size_t numbytes) {
       // printf("Loading Soundblock<%s>\n", filename.c_str());
-      FILE* fin = fopen(filename.toAbsolute().c_str(), "rb");
-      if (fin == nullptr) {
-        printf("You will need the K2000 ROM sampledata at <%s> to use this method!\n", filename.c_str());
-        OrkAssert(false);
-      }
-      fread(data_read, numbytes, 1, fin);
-      data_read += (numbytes >> 1);
-      fclose(fin);
+      batch.add(filename, 0, numbytes, data_read, [](file::asyncreadreq_ptr_t req) {
+        if (not req->ok()) {
+          printf("You will need the K2000 ROM sampledata at <%s> to use this method!\n", req->_path.c_str());
+          OrkAssert(false);
+        }
+      });
+      data_read += numbytes;
     };
     ///////////////////////////////////////////////////////////////////////////////////////////
     load_sound_block(basePath() / "kurzweil" / "k2vx_samples_base.bin", 8 << 20);
     load_sound_block(basePath() / "kurzweil" / "k2vx_samples_ext1.bin", 8 << 20);
     load_sound_block(basePath() / "kurzweil" / "k2vx_samples_ext2.bin", 8 << 20);
+    batch.submitAndWait();
   }
   s16* _romDATA = nullptr;
 };
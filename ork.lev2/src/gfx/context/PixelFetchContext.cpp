@@ -17,6 +17,7 @@
 #include <ork/lev2/gfx/gfxprimitives.h>
 #include <ork/lev2/gfx/pickbuffer.h>
 #include <ork/lev2/gfx/renderer/renderable.h>
+#include <ork/lev2/gfx/rtgroup.h>
 #include <ork/lev2/gfx/shadman.h>
 #include <ork/lev2/gfx/texman.h>
 #include <ork/lev2/ui/ui.h>
@@ -113,6 +114,108 @@ pickvariant_t PixelFetchContext::decodePixel(u32vec4 raw_pixel){
   //as_out->w = raw_pixel.w;
   return rval;
 }
+/////////////////////////////////////////////////////////////////////////
+// format an MRT's texel is read back as, given how the channel is used
+/////////////////////////////////////////////////////////////////////////
+
+EBufferFormat PixelFetchContext::readbackFormat(int mrtindex) const {
+  auto srcformat = _rtgroup->GetMrt(mrtindex)->mFormat;
+  switch (_usage[mrtindex]) {
+    case EPU_SVARIANT:
+      OrkAssert(srcformat == EBufferFormat::RGBA32F or srcformat == EBufferFormat::RGBA32UI);
+      return srcformat;
+    case EPU_PTR64:
+      OrkAssert(srcformat == EBufferFormat::RGBA16UI or srcformat == EBufferFormat::RGBA32F);
+      return srcformat;
+    case EPU_FVEC4:
+      return EBufferFormat::RGBA32F;
+    default:
+      OrkAssert(false);
+      break;
+  }
+  return EBufferFormat::NONE;
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+void PixelFetchContext::decodeTexel(int mrtindex, EBufferFormat fmt, const void* texel) {
+  if (mrtindex >= int(_pickvalues.size()))
+    return;
+  auto& value = _pickvalues[mrtindex];
+  switch (_usage[mrtindex]) {
+    case EPU_SVARIANT: {
+      if (fmt == EBufferFormat::RGBA32UI)
+        value = decodePixel(*(const u32vec4*)texel);
+      else
+        value = decodePixel(*(const fvec4*)texel);
+      break;
+    }
+    case EPU_PTR64: {
+      uint64_t a = 0, b = 0, c = 0, d = 0;
+      if (fmt == EBufferFormat::RGBA16UI) {
+        auto rgba = (const uint16_t*)texel;
+        a         = uint64_t(rgba[0]);
+        b         = uint64_t(rgba[1]);
+        c         = uint64_t(rgba[2]);
+        d         = uint64_t(rgba[3]);
+      } else {
+        auto rgba = (const float*)texel;
+        a         = uint64_t(rgba[0]);
+        b         = uint64_t(rgba[1]);
+        c         = uint64_t(rgba[2]);
+        d         = uint64_t(rgba[3]);
+      }
+      // swizzle so hex appears as xxxxyyyyzzzzwwww
+      value.set<uint64_t>((d << 48) | (c << 32) | (b << 16) | a);
+      break;
+    }
+    case EPU_FVEC4:
+      value.set<fvec4>(*(const fvec4*)texel);
+      break;
+    default:
+      OrkAssert(false);
+      break;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////
+// one readback per MRT. the snapshot keeps the id tables the texels were
+//  encoded with, the next pick render is free to reset ours.
+/////////////////////////////////////////////////////////////////////////
+
+void PixelFetchContext::fetchPixelAsync(const fvec4& rAt, fetch_callback_t callback) const {
+  OrkAssert(_gfxContext != nullptr);
+  OrkAssert(_rtgroup != nullptr);
+  OrkAssert(rAt.x >= 0.0f and rAt.x < 1.0f and rAt.y >= 0.0f and rAt.y < 1.0f);
+  auto snapshot = std::make_shared<PixelFetchContext>(*this);
+  int W         = _rtgroup->width();
+  int H         = _rtgroup->height();
+  int sx        = int((rAt.x) * float(W)); // same texel as GetPixel
+  int sy        = int((1.0f - rAt.y) * float(H));
+  std::vector<int> mrts;
+  for (int i = 0; i < int(_pickvalues.size()); i++) {
+    if (miMrtMask & (1 << i))
+      mrts.push_back(i);
+  }
+  OrkAssert(mrts.size());
+  auto remaining = std::make_shared<std::atomic<int>>(int(mrts.size()));
+  for (int i : mrts) {
+    snapshot->_pickvalues[i] = nullptr;
+    ReadbackRequest req;
+    req._source     = _rtgroup->GetMrt(i).get();
+    req._x          = sx;
+    req._y          = sy;
+    req._format     = readbackFormat(i);
+    req._queue      = opq::mainSerialQueue();
+    req._onComplete = [snapshot, i, remaining, callback](readbackresult_ptr_t result) {
+      snapshot->decodeTexel(i, result->_format, result->_bytes.data());
+      if (remaining->fetch_sub(1) == 1)
+        callback(snapshot);
+    };
+    _gfxContext->RBI()->enqueue(req);
+  }
+}
+
 /////////////////////////////////////////////////////////////////////////
 
 ork::rtti::ICastable* PixelFetchContext::GetObject(PickBuffer* pb, int ichan) const {
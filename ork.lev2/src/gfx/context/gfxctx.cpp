@@ -81,6 +81,7 @@ void Context::beginFrame(void) {
   FBI()->BeginFrame();
   GBI()->BeginFrame();
   FXI()->BeginFrame();
+  RBI()->poll(miTargetFrame);
 
   PushModColor(fcolor4::White());
   MTXI()->PushMMatrix(fmtx4::Identity());
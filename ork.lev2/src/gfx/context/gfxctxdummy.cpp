@@ -79,7 +79,8 @@ ContextDummy::ContextDummy()
     , mRsI(*this)
     , mGbI(*this)
     , mFbI(*this)
-    , mDWI(*this) {
+    , mDWI(*this)
+    , mRbI(*this) {
   DummyContextInit();
   static bool binit = true;
 
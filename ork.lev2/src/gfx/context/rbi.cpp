@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/kernel/opq.h>
+#include <ork/lev2/gfx/gfxenv.h>
+
+namespace ork::lev2 {
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t ReadbackRequest::bytesPerTexel(EBufferFormat fmt) {
+  switch (fmt) {
+    case EBufferFormat::RGBA8:
+    case EBufferFormat::R32F:
+    case EBufferFormat::R32UI:
+      return 4;
+    case EBufferFormat::RGBA16F:
+    case EBufferFormat::RGBA16UI:
+    case EBufferFormat::RG32F:
+      return 8;
+    case EBufferFormat::RGBA32F:
+    case EBufferFormat::RGBA32UI:
+      return 16;
+    default:
+      OrkAssert(false);
+      break;
+  }
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ReadbackInterface::ReadbackInterface(Context& ctx, int numslots)
+    : _target(ctx) {
+  OrkAssert(numslots > 0);
+  _slots.resize(numslots);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ReadbackInterface::~ReadbackInterface() {
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t ReadbackInterface::enqueue(const ReadbackRequest& req) {
+  OrkAssert(req._width > 0 and req._height > 0);
+  OrkAssert(req._onComplete);
+  std::lock_guard<std::mutex> lock(_mutex);
+  int numslots = int(_slots.size());
+  /////////////////////////////////////////
+  // ring full : the oldest slot is recycled
+  //  after waiting on it
+  /////////////////////////////////////////
+  if (_numInFlight == numslots) {
+    _stats._numStalls++;
+    _doWait(_oldest);
+    _retireOldest(_frame);
+  }
+  /////////////////////////////////////////
+  int index         = (_oldest + _numInFlight) % numslots;
+  auto& slot        = _slots[index];
+  slot._request     = req;
+  slot._ticket      = ++_ticket;
+  slot._submitFrame = _frame;
+  _doSubmit(index, req);
+  _numInFlight++;
+  _stats._numRequests++;
+  return slot._ticket;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// fences signal in submission order, so polling stops at the first slot
+//  the gpu has not finished
+///////////////////////////////////////////////////////////////////////////////
+
+void ReadbackInterface::poll(int frame) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _frame = frame;
+  while (_numInFlight) {
+    const auto& slot = _slots[_oldest];
+    if ((frame - slot._submitFrame) < _minLatency)
+      break;
+    _stats._numPolls++;
+    if (not _doPoll(_oldest)) {
+      _stats._numNotReady++;
+      break;
+    }
+    _retireOldest(frame);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ReadbackInterface::flush() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  while (_numInFlight) {
+    _doWait(_oldest);
+    _retireOldest(_frame);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ReadbackInterface::_retireOldest(int frame) {
+  auto& slot             = _slots[_oldest];
+  const auto& req        = slot._request;
+  auto result            = std::make_shared<ReadbackResult>();
+  result->_ticket        = slot._ticket;
+  result->_format        = req._format;
+  result->_x             = req._x;
+  result->_y             = req._y;
+  result->_width         = req._width;
+  result->_height        = req._height;
+  result->_bytesPerTexel = ReadbackRequest::bytesPerTexel(req._format);
+  result->_submitFrame   = slot._submitFrame;
+  result->_completeFrame = frame;
+  result->_bytes.resize(req.length());
+  _doFetch(_oldest, *result);
+  /////////////////////////////////////////
+  _stats._numCompleted++;
+  _stats._latencyFrames += size_t(frame - slot._submitFrame);
+  _stats._bytesRead += result->_bytes.size();
+  auto queue = req._queue ? req._queue : opq::concurrentQueue();
+  auto cb    = req._onComplete;
+  queue->enqueue([cb, result]() { cb(result); });
+  slot._request = ReadbackRequest(); // drop captures
+  _oldest       = (_oldest + 1) % int(_slots.size());
+  _numInFlight--;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t ReadbackInterface::numInFlight() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return size_t(_numInFlight);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ReadbackStats ReadbackInterface::stats() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ReadbackInterface::resetStats() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _stats.reset();
+}
+
+} // namespace ork::lev2
@@ -88,6 +88,12 @@ vtxbufferbase_ptr_t VertexBufferBase::CreateVertexBuffer(EVtxStreamFormat eforma
     case EVtxStreamFormat::V12N12B12T16:
       pvb = _createvb<SVtxV12N12B12T16>(inumverts, bstatic);
       break;
+    case EVtxStreamFormat::V8N4B4T8:
+      pvb = _createvb<SVtxV8N4B4T8>(inumverts, bstatic);
+      break;
+    case EVtxStreamFormat::V8N4B4T4I4W4:
+      pvb = _createvb<SVtxV8N4B4T4I4W4>(inumverts, bstatic);
+      break;
     case EVtxStreamFormat::V12N12T16C4:
       pvb = _createvb<SVtxV12N12T16C4>(inumverts, bstatic);
       break;
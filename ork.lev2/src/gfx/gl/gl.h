@@ -173,10 +173,15 @@ public:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+struct GLStreamRing;
+
+///////////////////////////////////////////////////////////////////////////////
+
 class GlGeometryBufferInterface final : public GeometryBufferInterface {
 
 public:
   GlGeometryBufferInterface(ContextGL& target);
+  ~GlGeometryBufferInterface();
 
 private:
   ///////////////////////////////////////////////////////////////////////
@@ -248,10 +253,11 @@ private:
   ContextGL& mTargetGL;
 
   uint32_t mLastComponentMask;
+  GLStreamRing* _streamRing = nullptr; // dynamic vertex buffers (see glgbi.cpp)
 
-  void _doBeginFrame() final {
-    mLastComponentMask = 0;
-  }
+  int _streamBaseVertex(const VertexBufferBase& VBuf) const;
+
+  void _doBeginFrame() final;
   // virtual void _doEndFrame() {}
 };
 
@@ -311,6 +317,37 @@ protected:
   int miCurScissorH;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// asynchronous readbacks (see ReadbackInterface in rbi.h)
+//  each ring slot owns a GL_PIXEL_PACK_BUFFER, grown on demand, and the
+//  fence issued right after glReadPixels into it
+///////////////////////////////////////////////////////////////////////////////
+
+class GlReadbackInterface final : public ReadbackInterface {
+public:
+  GlReadbackInterface(ContextGL& target);
+  ~GlReadbackInterface();
+
+private:
+  struct PackSlot {
+    GLuint _pbo      = 0;
+    size_t _capacity = 0;
+    size_t _length   = 0;
+    GLsync _fence    = nullptr;
+  };
+
+  void _doSubmit(int slot, const ReadbackRequest& req) final;
+  bool _doPoll(int slot) final;
+  void _doWait(int slot) final;
+  void _doFetch(int slot, ReadbackResult& result) final;
+
+  ContextGL& mTargetGL;
+  std::vector<PackSlot> _packSlots;
+};
+
+// glReadPixels format/type producing texels of a readback destination format
+void readbackPixelFormat(EBufferFormat fmt, GLenum& glformat, GLenum& gltype);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class VdsTextureAnimation : public TextureAnimationBase {
@@ -536,6 +573,9 @@ public:
   DrawingInterface* DWI() final {
     return &mDWI;
   }
+  ReadbackInterface* RBI() final {
+    return &mRbI;
+  }
 
   ///////////////////////////////////////////////////////////////////////
 
@@ -584,6 +624,7 @@ public:
   bool _SUPPORTS_BUFFER_STORAGE = true;
   bool _SUPPORTS_PERSISTENT_MAP = true;
   bool _SUPPORTS_EXTERNAL_MEMORY_OBJECT = true;
+  bool _SUPPORTS_PARALLEL_SHADER_COMPILE = false;
   std::string _GL_RENDERER;
   
   std::stack<void*> mDCStack;
@@ -614,6 +655,7 @@ public:
   GlFrameBufferInterface mFbI;
   GlTextureInterface mTxI;
   GlDrawingInterface mDWI;
+  GlReadbackInterface mRbI;
 
 #if defined(ENABLE_COMPUTE_SHADERS)
   glslfx::ComputeInterface mCI;
@@ -673,8 +673,6 @@ void GlFrameBufferInterface::GetPixel(const fvec4& rAt, PixelFetchContext& pfc)
                 pfc._pickvalues[MrtIndex] = nullptr;
               }
 
-              auto rtbuffer = pfc._rtgroup->GetMrt(MrtIndex);
-
               OrkAssert(MrtIndex < pfc._rtgroup->GetNumTargets());
 
               //GL_ERRORCHECK();
@@ -684,89 +682,19 @@ void GlFrameBufferInterface::GetPixel(const fvec4& rAt, PixelFetchContext& pfc)
               glReadBuffer(GL_COLOR_ATTACHMENT0 + MrtIndex);
               GL_ERRORCHECK();
 
-              switch (pfc._usage[MrtIndex]) {
-                case PixelFetchContext::EPU_SVARIANT: {
-                  switch(rtbuffer->mFormat){
-                    case EBufferFormat::RGBA32F: {
-                      fvec4 rgba;
-                      glReadPixels(sx, sy, 1, 1, GL_RGBA, GL_FLOAT, (void*) & rgba );
-                      if(MrtIndex<pfc_size){
-                        pfc._pickvalues[MrtIndex] = pfc.decodePixel(rgba);
-                      }
-                      break;
-                    }
-                    case EBufferFormat::RGBA32UI: {
-                      u32vec4 value;
-                      glReadPixels(sx, sy, 1, 1, GL_RGBA_INTEGER, GL_UNSIGNED_INT, (void*) & value );
-                      if(MrtIndex<pfc_size){
-                        pfc._pickvalues[MrtIndex] = pfc.decodePixel(value);
-                      }
-                      break;
-                    }
-                    default:
-                      OrkAssert(false);
-                      break;
-                  }
-                  break;
-                }
-                case PixelFetchContext::EPU_PTR64: {
-                  switch(rtbuffer->mFormat){
-                    case EBufferFormat::RGBA16UI: {
-                      uint16_t rgba[4] = {0,0,0,0};
-                      glReadPixels(sx, sy, 1, 1, GL_RGBA, GL_UNSIGNED_SHORT, (void*)rgba);
-                      /////////////////////////////////////////////////////////////////
-                      // swizzle so hex appears as xxxxyyyyzzzzwwww
-                      /////////////////////////////////////////////////////////////////
-                      uint64_t a             = uint64_t(rgba[0]);
-                      uint64_t b             = uint64_t(rgba[1]);
-                      uint64_t c             = uint64_t(rgba[2]);
-                      uint64_t d             = uint64_t(rgba[3]);
-                      uint64_t value = (d << 48) | (c << 32) | (b << 16) | a;
-                      /////////////////////////////////////////////////////////////////
-                      pfc._pickvalues[MrtIndex].set<uint64_t>(value);
-                      logchan_glfbi->log("getpix MrtIndex<%d> rx<%d> ry<%d> rgba(u16)<%u %u %u %u> value<0x%zx>", 
-                                          MrtIndex, sx, sy, 
-                                          rgba[0], rgba[1], rgba[2], rgba[3],
-                                          value);
-                      break;
-                    }                    
-                    case EBufferFormat::RGBA32F: {
-                      float rgba[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-                      glReadPixels(sx, sy, 1, 1, GL_RGBA, GL_FLOAT, (void*)rgba);
-                      /////////////////////////////////////////////////////////////////
-                      // swizzle so hex appears as xxxxyyyyzzzzwwww
-                      /////////////////////////////////////////////////////////////////
-                      uint64_t a             = uint64_t(rgba[0]);
-                      uint64_t b             = uint64_t(rgba[1]);
-                      uint64_t c             = uint64_t(rgba[2]);
-                      uint64_t d             = uint64_t(rgba[3]);
-                      uint64_t value = (d << 48) | (c << 32) | (b << 16) | a;
-                      /////////////////////////////////////////////////////////////////
-                      pfc._pickvalues[MrtIndex].set<uint64_t>(value);
-                      logchan_glfbi->log("getpix MrtIndex<%d> rx<%d> ry<%d> rgba(f32)<%g %g %g %g> value<0x%zx>", 
-                                          MrtIndex, sx, sy, 
-                                          rgba[0], rgba[1], rgba[2], rgba[3],
-                                          value);
-                      break;
-                    }
-                    default:
-                      OrkAssert(false);
-                      break;
-                  }
-                  /////////////////////////////////////////////////////////////////
-                  break;
-                }
-                case PixelFetchContext::EPU_FVEC4: {
-                  fvec4 rv;
-                  glReadPixels(sx, sy, 1, 1, GL_RGBA, GL_FLOAT, (void*)rv.asArray());
-                  pfc._pickvalues[MrtIndex].set<fvec4>(rv);
-                  // printf("getpix MrtIndex<%d> rx<%d> ry<%d> <%g %g %g %g>\n", MrtIndex, sx, sy, rv.x, rv.y, rv.z, rv.w);
-                  break;
-                }
-                default:
-                  OrkAssert(false);
-                  break;
-              }
+              EBufferFormat fmt = pfc.readbackFormat(MrtIndex);
+              GLenum glformat   = GL_RGBA;
+              GLenum gltype     = GL_FLOAT;
+              readbackPixelFormat(fmt, glformat, gltype);
+              fvec4 texel; // 16 bytes, room for any readback format
+              glReadPixels(sx, sy, 1, 1, glformat, gltype, (void*)&texel);
+              pfc.decodeTexel(MrtIndex, fmt, (const void*)&texel);
+              logchan_glfbi->log(
+                  "getpix MrtIndex<%d> rx<%d> ry<%d> fmt<%s>", //
+                  MrtIndex,
+                  sx,
+                  sy,
+                  EBufferFormatToName(fmt).c_str());
               GL_ERRORCHECK();
             }
           }
@@ -26,12 +26,9 @@ void Shader::dumpFinalText() const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool Shader::Compile() {
+void Shader::beginCompile() {
   GL_ERRORCHECK();
 
-  Timer ctimer;
-  ctimer.Start();
-
   mShaderObjectId = glCreateShader(mShaderType);
 
 #if defined(ENABLE_COMPUTE_SHADERS)
@@ -60,6 +57,21 @@ bool Shader::Compile() {
   GL_NF_ERRORCHECK();
   glCompileShader(mShaderObjectId);
   GL_NF_ERRORCHECK();
+  _compileIssued = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Shader::Compile() {
+  Timer ctimer;
+  ctimer.Start();
+
+  /////////////////////////////////////////
+  // already issued by compileAllPipelines ?
+  //  then the status query below just waits on the driver
+  /////////////////////////////////////////
+  if (not _compileIssued)
+    beginCompile();
 
   GLint compiledOk = 0;
   glGetShaderiv(mShaderObjectId, GL_COMPILE_STATUS, &compiledOk);
@@ -91,13 +103,23 @@ bool Shader::Compile() {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool Interface::compilePipelineVTG(rootcontainer_ptr_t container) {
+  auto pass = const_cast<Pass*>(container->_activePass);
+  bool OK   = _beginPipelineVTG(container, pass);
+  return _endPipelineVTG(container, pass, OK);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// first half of a VTG pipeline build: compile, attach, bind and issue the link
+//  (or load the program binary). no program status is queried here, so many
+//  passes can be in flight at once when the driver compiles in parallel.
+////////////////////////////////////////////////////////////////////////////////
+
+bool Interface::_beginPipelineVTG(rootcontainer_ptr_t container, Pass* pass) {
 
   bool OK = true;
   GL_ERRORCHECK();
   GLuint prgo = glCreateProgram();
 
-  auto pass = const_cast<Pass*>(container->_activePass);
-
   auto& pipeVTG = pass->_primpipe.get<PrimPipelineVTG>();
 
   Shader* pvtxshader = pipeVTG._vertexShader;
@@ -155,6 +177,8 @@ bool Interface::compilePipelineVTG(rootcontainer_ptr_t container) {
   
   pipeline_hasher->finish();
   uint64_t pipeline_hash = pipeline_hasher->result();
+  pass->_pipelineHash    = pipeline_hash;
+  pass->_linkFromBinary  = false;
 
   auto pipeline_datablock = DataBlockCache::findDataBlock(pipeline_hash);
   if(true) { //_debugDrawCall){
@@ -193,6 +217,7 @@ bool Interface::compilePipelineVTG(rootcontainer_ptr_t container) {
     auto binary_data = shader_input_stream->GetDataAt(0);
     glProgramBinary(prgo, binary_format, binary_data, binary_length);
     GL_ERRORCHECK();
+    pass->_linkFromBinary = true;
     double precompiled_load_time = load_timer.SecsSinceStart();
     //printf( "SHADERPROGRAM TOTAL PRECOMPILED LOADTIME<%f>\n", precompiled_load_time );
   }
@@ -200,14 +225,6 @@ bool Interface::compilePipelineVTG(rootcontainer_ptr_t container) {
   // not cached..
   ////////////////////////////////////////////////////////////
   else{ 
-    /////////////////////////////////////////
-    chunkfile::Writer chunkwriter("xfx-gl");
-    auto header_stream   = chunkwriter.AddStream("header");
-    auto shader_stream   = chunkwriter.AddStream("shaders");
-    /////////////////////////////////////////
-    Timer ctimer;
-    ctimer.Start();
-
     auto l_compile = [&](Shader* psh) -> bool {
       bool compile_ok = true;
       if (psh && psh->IsCompiled() == false)
@@ -226,8 +243,6 @@ bool Interface::compilePipelineVTG(rootcontainer_ptr_t container) {
     OK &= l_compile(pgeoshader);
     OK &= l_compile(pfrgshader);
 
-    container->mShaderCompileFailed = (false == OK);
-
     if (OK) {
 
       //////////////
@@ -313,18 +328,9 @@ bool Interface::compilePipelineVTG(rootcontainer_ptr_t container) {
       // Bind Vertex Attributes
       //////////////////////////
 
-      // printf( "	binding vertex attributes count<%d>\n",
-      // int(vtx_iface->mAttributes.size()) );
-
-      static int counter = 0;
-
-      header_stream->AddIndexedString("begin-attributes",chunkwriter);
-      header_stream->AddItem<size_t>(vtx_iface->_inputAttributes.size());
-
       for (const auto& itp : vtx_iface->_inputAttributes) {
         Attribute* pattr = itp.second;
         int iloc         = pattr->mLocation;
-        header_stream->AddItem<int>(iloc);
         //printf( "	vtxattr<%s> loc<%d> dir<%s> sem<%s>\n",
         //pattr->mName.c_str(), iloc, pattr->mDirection.c_str(),
         //pattr->mSemantic.c_str() );
@@ -332,86 +338,118 @@ bool Interface::compilePipelineVTG(rootcontainer_ptr_t container) {
         GL_ERRORCHECK();
         pass->_vtxAttributeById[iloc]                    = pattr;
         pass->_vtxAttributesBySemantic[pattr->mSemantic] = pattr;
-        counter++;
-        header_stream->AddIndexedString(pattr->mName,chunkwriter);
-        header_stream->AddIndexedString(pattr->mSemantic,chunkwriter);
       }
-      header_stream->AddIndexedString("end-attributes",chunkwriter);
 
       //////////////////////////
-
-      bool dump_and_exit = false;
-      //if(pass->_technique->_name=="tflatparticle_streaks_stereo")
-        //dump_and_exit = true;
-
-      double link_start_time = ctimer.SecsSinceStart();
+      // issue link, status is collected in _endPipelineVTG
+      //////////////////////////
 
       GL_ERRORCHECK();
       glLinkProgram(prgo);
       GL_ERRORCHECK();
-      GLint linkstat = 0;
-      glGetProgramiv(prgo, GL_LINK_STATUS, &linkstat);
-      if (linkstat != GL_TRUE or dump_and_exit or _debugDrawCall) {
-        if (pvtxshader)
-          pvtxshader->dumpFinalText();
-        if (ptecshader)
-          ptecshader->dumpFinalText();
-        if (pteeshader)
-          pteeshader->dumpFinalText();
-        if (pgeoshader)
-          pgeoshader->dumpFinalText();
-        if (pfrgshader)
-          pfrgshader->dumpFinalText();
-        char infoLog[1 << 16];
-        glGetProgramInfoLog(prgo, sizeof(infoLog), NULL, infoLog);
-        printf("\n\n//////////////////////////////////\n");
-        printf("program VTG InfoLog<%s>\n", infoLog);
-        printf("//////////////////////////////////\n\n");
-        OrkAssert(not dump_and_exit);
-      }
-      OrkAssert(linkstat == GL_TRUE);
-      double link_time = ctimer.SecsSinceStart()-link_start_time;
-      //printf( "SHADER LINK TIME<%f>\n", link_time );
+    }
+  } // not cached
 
-      // printf( "} // linking complete..\n" );
+  pass->_pendingProgramObjectId = prgo;
+  return OK;
+}
 
+////////////////////////////////////////////////////////////////////////////////
+// second half of a VTG pipeline build: wait for the link, cache the binary,
+//  query attributes and post process the pass
+////////////////////////////////////////////////////////////////////////////////
 
-      // printf( "//////////////////////////////////\n");
+bool Interface::_endPipelineVTG(rootcontainer_ptr_t container, Pass* pass, bool begin_ok) {
 
-      ///////////////////////////////////
-      // fetch shader binary
-      ///////////////////////////////////
+  bool OK     = begin_ok;
+  GLuint prgo = pass->_pendingProgramObjectId;
+  pass->_pendingProgramObjectId = 0;
 
-      if(mTarget._SUPPORTS_BINARY_PIPELINE){
-        GLint binaryLength = 0;
-        GL_ERRORCHECK();
-        glGetProgramiv(prgo, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
-        GL_ERRORCHECK();
-        std::vector<GLubyte> binary_bytes;
-        binary_bytes.resize(binaryLength);
-        GLenum binaryFormat;
-        glGetProgramBinary(prgo, binaryLength, NULL, &binaryFormat, binary_bytes.data());
-        header_stream->AddItem<GLenum>(binaryFormat);
-        header_stream->AddItem<size_t>(binary_bytes.size());
-        shader_stream->AddData(binary_bytes.data(),binary_bytes.size());
-        GL_ERRORCHECK();
+  auto& pipeVTG = pass->_primpipe.get<PrimPipelineVTG>();
 
-        ///////////////////////////////////
-        // write to datablock cache
-        ///////////////////////////////////
+  Shader* pvtxshader = pipeVTG._vertexShader;
+  Shader* ptecshader = pipeVTG._tessCtrlShader;
+  Shader* pteeshader = pipeVTG._tessEvalShader;
+  Shader* pgeoshader = pipeVTG._geometryShader;
+  Shader* pfrgshader = pipeVTG._fragmentShader;
+  StreamInterface* vtx_iface = pvtxshader->_inputInterface;
 
-        printf( "WRITING SHADER hash<%016zx> TO CACHE\n", pipeline_hash );
+  if (OK and not pass->_linkFromBinary) {
 
-        pipeline_datablock = std::make_shared<DataBlock>();
-        chunkwriter.writeToDataBlock(pipeline_datablock);
-        DataBlockCache::setDataBlock(pipeline_hash, pipeline_datablock);
+    Timer ctimer;
+    ctimer.Start();
+
+    bool dump_and_exit = false;
+    //if(pass->_technique->_name=="tflatparticle_streaks_stereo")
+      //dump_and_exit = true;
+
+    GLint linkstat = 0;
+    glGetProgramiv(prgo, GL_LINK_STATUS, &linkstat);
+    if (linkstat != GL_TRUE or dump_and_exit or _debugDrawCall) {
+      if (pvtxshader)
+        pvtxshader->dumpFinalText();
+      if (ptecshader)
+        ptecshader->dumpFinalText();
+      if (pteeshader)
+        pteeshader->dumpFinalText();
+      if (pgeoshader)
+        pgeoshader->dumpFinalText();
+      if (pfrgshader)
+        pfrgshader->dumpFinalText();
+      char infoLog[1 << 16];
+      glGetProgramInfoLog(prgo, sizeof(infoLog), NULL, infoLog);
+      printf("\n\n//////////////////////////////////\n");
+      printf("program VTG InfoLog<%s>\n", infoLog);
+      printf("//////////////////////////////////\n\n");
+      OrkAssert(not dump_and_exit);
+    }
+    OrkAssert(linkstat == GL_TRUE);
+    double link_time = ctimer.SecsSinceStart();
+    //printf( "SHADER LINK TIME<%f>\n", link_time );
+
+    ///////////////////////////////////
+    // fetch shader binary
+    ///////////////////////////////////
+
+    if(mTarget._SUPPORTS_BINARY_PIPELINE){
+      chunkfile::Writer chunkwriter("xfx-gl");
+      auto header_stream   = chunkwriter.AddStream("header");
+      auto shader_stream   = chunkwriter.AddStream("shaders");
+
+      header_stream->AddIndexedString("begin-attributes",chunkwriter);
+      header_stream->AddItem<size_t>(vtx_iface->_inputAttributes.size());
+      for (const auto& itp : vtx_iface->_inputAttributes) {
+        Attribute* pattr = itp.second;
+        header_stream->AddItem<int>(pattr->mLocation);
+        header_stream->AddIndexedString(pattr->mName,chunkwriter);
+        header_stream->AddIndexedString(pattr->mSemantic,chunkwriter);
       }
+      header_stream->AddIndexedString("end-attributes",chunkwriter);
 
+      GLint binaryLength = 0;
+      GL_ERRORCHECK();
+      glGetProgramiv(prgo, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+      GL_ERRORCHECK();
+      std::vector<GLubyte> binary_bytes;
+      binary_bytes.resize(binaryLength);
+      GLenum binaryFormat;
+      glGetProgramBinary(prgo, binaryLength, NULL, &binaryFormat, binary_bytes.data());
+      header_stream->AddItem<GLenum>(binaryFormat);
+      header_stream->AddItem<size_t>(binary_bytes.size());
+      shader_stream->AddData(binary_bytes.data(),binary_bytes.size());
+      GL_ERRORCHECK();
+
+      ///////////////////////////////////
+      // write to datablock cache
+      ///////////////////////////////////
+
+      printf( "WRITING SHADER hash<%016zx> TO CACHE\n", pass->_pipelineHash );
+
+      auto pipeline_datablock = std::make_shared<DataBlock>();
+      chunkwriter.writeToDataBlock(pipeline_datablock);
+      DataBlockCache::setDataBlock(pass->_pipelineHash, pipeline_datablock);
     }
-    double compile_time = ctimer.SecsSinceStart();
-    //printf( "SHADERPROGRAM TOTAL COMPILE/LINK TIME<%f>\n", compile_time );
-  
-  } // not cached
+  }
 
   if(OK){
     pass->_programObjectId = prgo;
@@ -485,7 +523,6 @@ bool Interface::compilePipelineNVTM(rootcontainer_ptr_t container) {
   OK &= l_compile(ptaskshader);
   OK &= l_compile(pmeshhader);
   OK &= l_compile(pfragshader);
-  container->mShaderCompileFailed = (false == OK);
   if (OK) {
     GL_ERRORCHECK();
     GLuint prgo            = glCreateProgram();
@@ -541,4 +578,98 @@ bool Interface::compileAndLink(rootcontainer_ptr_t container) {
   return OK;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// build every VTG pass of a container up front, in three sweeps:
+//  issue all shader compiles, then all links, then collect all results.
+//  with (ARB|KHR)_parallel_shader_compile the driver overlaps the work,
+//  otherwise this is equivalent to lazily compiling each pass in BindPass.
+// a pass whose shaders fail to compile or whose program fails to link is
+//  left unbuilt, so its error is only reported (and asserted on) if its
+//  technique is ever bound, same as the lazy path.
+///////////////////////////////////////////////////////////////////////////////
+
+bool Interface::compileAllPipelines(rootcontainer_ptr_t container) {
+  Timer ctimer;
+  ctimer.Start();
+  std::vector<Pass*> vtg_passes;
+  for (const auto& ittek : container->_techniqueMap) {
+    for (Pass* pass : ittek.second->mPasses) {
+      if (pass->_programObjectId == 0 and pass->_primpipe.isA<PrimPipelineVTG>())
+        vtg_passes.push_back(pass);
+    }
+  }
+  /////////////////////////////////////
+  auto l_issue = [](Shader* psh) {
+    if (psh and not psh->_compileIssued)
+      psh->beginCompile();
+  };
+  for (Pass* pass : vtg_passes) {
+    auto& pipeVTG = pass->_primpipe.get<PrimPipelineVTG>();
+    l_issue(pipeVTG._vertexShader);
+    l_issue(pipeVTG._tessCtrlShader);
+    l_issue(pipeVTG._tessEvalShader);
+    l_issue(pipeVTG._geometryShader);
+    l_issue(pipeVTG._fragmentShader);
+  }
+  /////////////////////////////////////
+  // compile status, without Shader::Compile's error path
+  /////////////////////////////////////
+  auto l_compiled = [](Shader* psh) -> bool {
+    if (nullptr == psh or psh->IsCompiled())
+      return true;
+    GLint compiledOk = 0;
+    glGetShaderiv(psh->mShaderObjectId, GL_COMPILE_STATUS, &compiledOk);
+    return (GL_TRUE == compiledOk);
+  };
+  std::set<const Technique*> deferred_teks;
+  std::vector<Pass*> linking_passes;
+  for (Pass* pass : vtg_passes) {
+    auto& pipeVTG = pass->_primpipe.get<PrimPipelineVTG>();
+    bool compiled = l_compiled(pipeVTG._vertexShader);
+    compiled &= l_compiled(pipeVTG._tessCtrlShader);
+    compiled &= l_compiled(pipeVTG._tessEvalShader);
+    compiled &= l_compiled(pipeVTG._geometryShader);
+    compiled &= l_compiled(pipeVTG._fragmentShader);
+    if (compiled)
+      linking_passes.push_back(pass);
+    else
+      deferred_teks.insert(pass->_technique);
+  }
+  /////////////////////////////////////
+  bool OK = deferred_teks.empty();
+  std::vector<bool> begin_ok;
+  for (Pass* pass : linking_passes)
+    begin_ok.push_back(_beginPipelineVTG(container, pass));
+  for (size_t i = 0; i < linking_passes.size(); i++) {
+    Pass* pass = linking_passes[i];
+    if (begin_ok[i] and not pass->_linkFromBinary) {
+      GLint linkstat = 0;
+      glGetProgramiv(pass->_pendingProgramObjectId, GL_LINK_STATUS, &linkstat);
+      if (linkstat != GL_TRUE) {
+        glDeleteProgram(pass->_pendingProgramObjectId);
+        pass->_pendingProgramObjectId = 0;
+        deferred_teks.insert(pass->_technique);
+        OK = false;
+        continue;
+      }
+    }
+    OK &= _endPipelineVTG(container, pass, begin_ok[i]);
+  }
+  /////////////////////////////////////
+  for (auto tek : deferred_teks) {
+    printf(
+        "Effect<%s> technique<%s> failed to build, deferred until bound\n",
+        container->mEffectName.c_str(),
+        tek->_name.c_str());
+  }
+  if (_DEBUG_SHADER_COMPILE) {
+    printf(
+        "Effect<%s> compileAllPipelines numpasses<%zu> time<%f>\n",
+        container->mEffectName.c_str(),
+        vtg_passes.size(),
+        ctimer.SecsSinceStart());
+  }
+  return OK;
+}
+
 } // namespace ork::lev2::glslfx
@@ -0,0 +1,534 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+//  compiled container cache
+//   binary image of a generated RootContainer, so a warm load
+//   skips scanning, parsing and code generation entirely.
+////////////////////////////////////////////////////////////////
+
+#include "../gl.h"
+#include "glslfxi.h"
+#include <ork/file/file.h>
+#include <ork/kernel/string/string.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ork::lev2::glslfx {
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+constexpr uint32_t kCONTAINERMAGIC   = 0x43584647; // 'GFXC'
+constexpr uint32_t kCONTAINERVERSION = 1;
+
+//////////////////////////////////////////////////////
+// container layout depends on which shader stages are compiled in
+//////////////////////////////////////////////////////
+
+constexpr uint32_t kFEATUREBITS = 0
+#if defined(ENABLE_NVMESH_SHADERS)
+                                  | 1
+#endif
+#if defined(ENABLE_COMPUTE_SHADERS)
+                                  | 2
+#endif
+    ;
+
+using interface_map_t = std::unordered_map<std::string, StreamInterface*>;
+using iface_index_t   = std::unordered_map<const StreamInterface*, uint32_t>;
+constexpr uint32_t NOINTERFACE = 0xffffffff;
+
+//////////////////////////////////////////////////////
+
+std::vector<interface_map_t*> _interfaceMaps(RootContainer* c) {
+  std::vector<interface_map_t*> rval = {
+      &c->_vertexInterfaces,
+      &c->_tessCtrlInterfaces,
+      &c->_tessEvalInterfaces,
+      &c->_geometryInterfaces,
+      &c->_fragmentInterfaces,
+  };
+#if defined(ENABLE_NVMESH_SHADERS)
+  rval.push_back(&c->_nvTaskInterfaces);
+  rval.push_back(&c->_nvMeshInterfaces);
+#endif
+#if defined(ENABLE_COMPUTE_SHADERS)
+  rval.push_back(&c->_computeInterfaces);
+#endif
+  return rval;
+}
+
+//////////////////////////////////////////////////////
+
+void _writeString(datablock_ptr_t out, const std::string& str) {
+  out->addItem<uint32_t>(uint32_t(str.length()));
+  out->addData(str.c_str(), str.length());
+}
+
+std::string _readString(DataBlockInputStream& inp) {
+  size_t length = inp.getItem<uint32_t>();
+  std::string rval((const char*)inp.current(), length);
+  inp.advance(length);
+  return rval;
+}
+
+//////////////////////////////////////////////////////
+
+void _writeUniform(datablock_ptr_t out, const Uniform* uni) {
+  _writeString(out, uni->_name);
+  _writeString(out, uni->_typeName);
+  _writeString(out, uni->_semantic);
+  out->addItem<GLenum>(uni->_type);
+  out->addItem<int32_t>(uni->_arraySize);
+}
+
+Uniform* _readUniform(DataBlockInputStream& inp) {
+  auto name        = _readString(inp);
+  auto uni         = new Uniform(name);
+  uni->_typeName   = _readString(inp);
+  uni->_semantic   = _readString(inp);
+  uni->_type       = inp.getItem<GLenum>();
+  uni->_arraySize  = inp.getItem<int32_t>();
+  return uni;
+}
+
+//////////////////////////////////////////////////////
+
+void _writeAttributes(datablock_ptr_t out, const StreamInterface::attrmap_t& attrs) {
+  out->addItem<uint32_t>(uint32_t(attrs.size()));
+  for (const auto& item : attrs) {
+    const Attribute* attr = item.second;
+    _writeString(out, item.first);
+    _writeString(out, attr->mName);
+    _writeString(out, attr->mSemantic);
+    out->addItem<GLenum>(attr->meType);
+    out->addItem<GLint>(attr->mLocation);
+    out->addItem<int32_t>(attr->mArraySize);
+    _writeString(out, attr->mTypeName);
+    _writeString(out, attr->mDirection);
+    _writeString(out, attr->mLayout);
+    _writeString(out, attr->mInlineStruct);
+    _writeString(out, attr->mComment);
+    out->addItem<uint8_t>(attr->_typeIsInlineStruct);
+    out->addItem<uint8_t>(attr->_isInteger);
+    out->addItem<uint32_t>(uint32_t(attr->_inlineStructToks.size()));
+    for (const auto& tok : attr->_inlineStructToks)
+      _writeString(out, tok);
+    out->addItem<uint32_t>(uint32_t(attr->_typequalifier.size()));
+    for (const auto& qual : attr->_typequalifier)
+      _writeString(out, qual);
+  }
+}
+
+void _readAttributes(DataBlockInputStream& inp, StreamInterface::attrmap_t& attrs) {
+  size_t count = inp.getItem<uint32_t>();
+  for (size_t i = 0; i < count; i++) {
+    auto key                  = _readString(inp);
+    auto name                 = _readString(inp);
+    auto semantic             = _readString(inp);
+    auto attr                 = new Attribute(name, semantic);
+    attr->meType              = inp.getItem<GLenum>();
+    attr->mLocation           = inp.getItem<GLint>();
+    attr->mArraySize          = inp.getItem<int32_t>();
+    attr->mTypeName           = _readString(inp);
+    attr->mDirection          = _readString(inp);
+    attr->mLayout             = _readString(inp);
+    attr->mInlineStruct       = _readString(inp);
+    attr->mComment            = _readString(inp);
+    attr->_typeIsInlineStruct = inp.getItem<uint8_t>();
+    attr->_isInteger          = inp.getItem<uint8_t>();
+    size_t numtoks            = inp.getItem<uint32_t>();
+    for (size_t t = 0; t < numtoks; t++)
+      attr->_inlineStructToks.push_back(_readString(inp));
+    size_t numquals = inp.getItem<uint32_t>();
+    for (size_t q = 0; q < numquals; q++)
+      attr->_typequalifier.insert(_readString(inp));
+    attrs[key] = attr;
+  }
+}
+
+//////////////////////////////////////////////////////
+
+template <typename shader_t>
+void _writeShaders(datablock_ptr_t out, const std::unordered_map<std::string, shader_t*>& shaders, const iface_index_t& ifaces) {
+  out->addItem<uint32_t>(uint32_t(shaders.size()));
+  for (const auto& item : shaders) {
+    const Shader* sh = item.second;
+    _writeString(out, sh->mName);
+    _writeString(out, sh->mShaderText);
+    uint32_t iface_index = NOINTERFACE;
+    if (sh->_inputInterface) {
+      auto it = ifaces.find(sh->_inputInterface);
+      OrkAssert(it != ifaces.end());
+      iface_index = it->second;
+    }
+    out->addItem<uint32_t>(iface_index);
+    out->addItem<uint32_t>(uint32_t(sh->_unisets.size()));
+    for (auto uset : sh->_unisets)
+      _writeString(out, uset->_name);
+    out->addItem<uint32_t>(uint32_t(sh->_uniblocks.size()));
+    for (auto ublk : sh->_uniblocks)
+      _writeString(out, ublk->_name);
+  }
+}
+
+template <typename shader_t>
+void _readShaders(
+    DataBlockInputStream& inp,
+    rootcontainer_ptr_t c,
+    std::unordered_map<std::string, shader_t*>& shaders,
+    const std::vector<StreamInterface*>& ifaces) {
+  size_t count = inp.getItem<uint32_t>();
+  for (size_t i = 0; i < count; i++) {
+    auto sh            = new shader_t(_readString(inp));
+    sh->mShaderText    = _readString(inp);
+    sh->_rootcontainer = c;
+    uint32_t iface_index = inp.getItem<uint32_t>();
+    if (iface_index != NOINTERFACE)
+      sh->_inputInterface = ifaces[iface_index];
+    size_t numsets = inp.getItem<uint32_t>();
+    for (size_t s = 0; s < numsets; s++)
+      sh->_unisets.push_back(c->uniformset(_readString(inp)));
+    size_t numblocks = inp.getItem<uint32_t>();
+    for (size_t b = 0; b < numblocks; b++)
+      sh->_uniblocks.push_back(c->uniformBlock(_readString(inp)));
+    shaders[sh->mName] = sh;
+  }
+}
+
+//////////////////////////////////////////////////////
+
+template <typename shader_t> std::string _shaderName(const shader_t* sh) {
+  return sh ? sh->mName : std::string();
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// the generated #version follows the context version the driver
+//  granted, so the driver strings identify what the code was generated for
+///////////////////////////////////////////////////////////////////////////////
+
+std::string driverIdentity() {
+  auto l_str = [](GLenum item) -> std::string {
+    auto str = (const char*)glGetString(item);
+    return str ? str : "";
+  };
+  return l_str(GL_VENDOR) + "|" + l_str(GL_RENDERER) + "|" + l_str(GL_VERSION) + "|" + l_str(GL_SHADING_LANGUAGE_VERSION);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t containerCacheKey(const std::string& driverid, const std::string& name, const void* text, size_t length) {
+  auto hasher = DataBlock::createHasher();
+  hasher->accumulateString("glfx_container"); // identifier
+  hasher->accumulateItem<uint32_t>(kCONTAINERVERSION);
+  hasher->accumulateItem<uint32_t>(kFEATUREBITS);
+  hasher->accumulateString(driverid);
+  hasher->accumulateString(name);
+  hasher->accumulate(text, length);
+  hasher->finish();
+  return hasher->result();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t fileContentHash(const std::string& path) {
+  File inp_file(path.c_str(), EFM_READ);
+  if (not inp_file.IsOpen())
+    return 0;
+  size_t length = 0;
+  inp_file.GetLength(length);
+  std::vector<uint8_t> bytes(length);
+  inp_file.Read(bytes.data(), length);
+  auto hasher = DataBlock::createHasher();
+  hasher->accumulate(bytes.data(), length);
+  hasher->finish();
+  return hasher->result();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+datablock_ptr_t serializeContainer(rootcontainer_ptr_t c, const containerdeps_t& deps) {
+  auto out = std::make_shared<DataBlock>();
+  out->addItem<uint32_t>(kCONTAINERMAGIC);
+  out->addItem<uint32_t>(kCONTAINERVERSION);
+  out->addItem<uint32_t>(kFEATUREBITS);
+  /////////////////////////////////////
+  // dependencies
+  /////////////////////////////////////
+  out->addItem<uint32_t>(uint32_t(deps.size()));
+  for (const auto& dep : deps) {
+    _writeString(out, dep._path);
+    out->addItem<uint64_t>(dep._contenthash);
+  }
+  /////////////////////////////////////
+  // configs, uniforms, uniform sets/blocks
+  /////////////////////////////////////
+  out->addItem<uint32_t>(uint32_t(c->mConfigs.size()));
+  for (const auto& item : c->mConfigs)
+    _writeString(out, item.first);
+  out->addItem<uint32_t>(uint32_t(c->_uniforms.size()));
+  for (const auto& item : c->_uniforms)
+    _writeUniform(out, item.second);
+  out->addItem<uint32_t>(uint32_t(c->_uniformSets.size()));
+  for (const auto& item : c->_uniformSets) {
+    const UniformSet* uset = item.second;
+    _writeString(out, uset->_name);
+    out->addItem<uint32_t>(uint32_t(uset->_uniforms.size()));
+    for (const auto& uitem : uset->_uniforms) {
+      _writeString(out, uitem.first);
+      _writeString(out, uitem.second->_name); // merged, lives in _uniforms
+    }
+  }
+  out->addItem<uint32_t>(uint32_t(c->_uniformBlocks.size()));
+  for (const auto& item : c->_uniformBlocks) {
+    const UniformBlock* ublk = item.second;
+    _writeString(out, ublk->_name);
+    out->addItem<uint32_t>(uint32_t(ublk->_subuniforms.size()));
+    for (auto sub : ublk->_subuniforms)
+      _writeUniform(out, sub);
+  }
+  /////////////////////////////////////
+  // state blocks
+  /////////////////////////////////////
+  out->addItem<uint32_t>(uint32_t(c->_stateBlocks.size()));
+  for (const auto& item : c->_stateBlocks) {
+    const StateBlock* sb = item.second;
+    _writeString(out, sb->mName);
+    out->addItem<uint32_t>(uint32_t(sb->_stateitems.size()));
+    for (const auto& sitem : sb->_stateitems) {
+      _writeString(out, sitem.first);
+      _writeString(out, sitem.second);
+    }
+  }
+  /////////////////////////////////////
+  // interfaces
+  /////////////////////////////////////
+  iface_index_t iface_index;
+  for (auto ifmap : _interfaceMaps(c.get())) {
+    out->addItem<uint32_t>(uint32_t(ifmap->size()));
+    for (const auto& item : *ifmap) {
+      const StreamInterface* sif = item.second;
+      iface_index[sif]           = uint32_t(iface_index.size());
+      _writeString(out, sif->mName);
+      out->addItem<GLenum>(sif->mInterfaceType);
+      out->addItem<int32_t>(sif->_gspriminpsize);
+      out->addItem<int32_t>(sif->_gsprimoutsize);
+      out->addItem<uint32_t>(uint32_t(sif->_uniformSets.size()));
+      for (auto uset : sif->_uniformSets)
+        _writeString(out, uset->_name);
+      out->addItem<uint32_t>(uint32_t(sif->_uniformBlocks.size()));
+      for (auto ublk : sif->_uniformBlocks)
+        _writeString(out, ublk->_name);
+      _writeAttributes(out, sif->_inputAttributes);
+      _writeAttributes(out, sif->_outputAttributes);
+    }
+  }
+  /////////////////////////////////////
+  // shaders
+  /////////////////////////////////////
+  _writeShaders(out, c->_vertexShaders, iface_index);
+  _writeShaders(out, c->_tessCtrlShaders, iface_index);
+  _writeShaders(out, c->_tessEvalShaders, iface_index);
+  _writeShaders(out, c->_geometryShaders, iface_index);
+  _writeShaders(out, c->_fragmentShaders, iface_index);
+#if defined(ENABLE_NVMESH_SHADERS)
+  _writeShaders(out, c->_nvTaskShaders, iface_index);
+  _writeShaders(out, c->_nvMeshShaders, iface_index);
+#endif
+#if defined(ENABLE_COMPUTE_SHADERS)
+  _writeShaders(out, c->_computeShaders, iface_index);
+#endif
+  /////////////////////////////////////
+  // techniques / passes
+  /////////////////////////////////////
+  out->addItem<uint32_t>(uint32_t(c->_techniqueMap.size()));
+  for (const auto& item : c->_techniqueMap) {
+    const Technique* tek = item.second;
+    _writeString(out, tek->_name);
+    out->addItem<uint32_t>(uint32_t(tek->mPasses.size()));
+    for (const Pass* pass : tek->mPasses) {
+      _writeString(out, pass->_name);
+      _writeString(out, pass->_stateBlock ? pass->_stateBlock->mName : std::string());
+      if (auto as_vtg = pass->_primpipe.tryAs<PrimPipelineVTG>()) {
+        const auto& vtg = as_vtg.value();
+        out->addItem<uint8_t>(1);
+        _writeString(out, _shaderName(vtg._vertexShader));
+        _writeString(out, _shaderName(vtg._tessCtrlShader));
+        _writeString(out, _shaderName(vtg._tessEvalShader));
+        _writeString(out, _shaderName(vtg._geometryShader));
+        _writeString(out, _shaderName(vtg._fragmentShader));
+      }
+#if defined(ENABLE_NVMESH_SHADERS)
+      else if (auto as_nvtm = pass->_primpipe.tryAs<PrimPipelineNVTM>()) {
+        const auto& nvtm = as_nvtm.value();
+        out->addItem<uint8_t>(2);
+        _writeString(out, _shaderName(nvtm._nvTaskShader));
+        _writeString(out, _shaderName(nvtm._nvMeshShader));
+        _writeString(out, _shaderName(nvtm._fragmentShader));
+      }
+#endif
+      else {
+        out->addItem<uint8_t>(0);
+      }
+    }
+  }
+  return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+rootcontainer_ptr_t deserializeContainer(datablock_ptr_t block, const std::string& name) {
+  DataBlockInputStream inp(block);
+  if (inp.getItem<uint32_t>() != kCONTAINERMAGIC)
+    return nullptr;
+  if (inp.getItem<uint32_t>() != kCONTAINERVERSION)
+    return nullptr;
+  if (inp.getItem<uint32_t>() != kFEATUREBITS)
+    return nullptr;
+  /////////////////////////////////////
+  // stale if any imported file changed
+  /////////////////////////////////////
+  size_t numdeps = inp.getItem<uint32_t>();
+  for (size_t i = 0; i < numdeps; i++) {
+    auto path     = _readString(inp);
+    uint64_t hash = inp.getItem<uint64_t>();
+    if (fileContentHash(path) != hash)
+      return nullptr;
+  }
+  auto c = std::make_shared<RootContainer>(name);
+  /////////////////////////////////////
+  size_t numconfigs = inp.getItem<uint32_t>();
+  for (size_t i = 0; i < numconfigs; i++) {
+    auto cfg   = new Config;
+    cfg->mName = _readString(inp);
+    c->addConfig(cfg);
+  }
+  size_t numunis = inp.getItem<uint32_t>();
+  for (size_t i = 0; i < numunis; i++) {
+    auto uni                  = _readUniform(inp);
+    c->_uniforms[uni->_name] = uni;
+  }
+  size_t numsets = inp.getItem<uint32_t>();
+  for (size_t i = 0; i < numsets; i++) {
+    auto uset          = new UniformSet;
+    uset->_name        = _readString(inp);
+    size_t numsetunis  = inp.getItem<uint32_t>();
+    for (size_t u = 0; u < numsetunis; u++) {
+      auto key             = _readString(inp);
+      auto uniname         = _readString(inp);
+      uset->_uniforms[key] = c->GetUniform(uniname);
+    }
+    c->addUniformSet(uset);
+  }
+  size_t numblocks = inp.getItem<uint32_t>();
+  for (size_t i = 0; i < numblocks; i++) {
+    auto ublk       = new UniformBlock;
+    ublk->_name     = _readString(inp);
+    size_t numsubs  = inp.getItem<uint32_t>();
+    for (size_t u = 0; u < numsubs; u++)
+      ublk->_subuniforms.push_back(_readUniform(inp));
+    c->addUniformBlock(ublk);
+  }
+  /////////////////////////////////////
+  size_t numstateblocks = inp.getItem<uint32_t>();
+  for (size_t i = 0; i < numstateblocks; i++) {
+    auto sbname       = _readString(inp);
+    StateBlock* sb    = c->GetStateBlock(sbname); // "default" pre-exists
+    bool is_new       = (sb == nullptr);
+    if (is_new) {
+      sb        = new StateBlock;
+      sb->mName = sbname;
+    }
+    size_t numitems = inp.getItem<uint32_t>();
+    for (size_t s = 0; s < numitems; s++) {
+      auto key   = _readString(inp);
+      auto value = _readString(inp);
+      // written by a build that knows other states : rebuild from source
+      if (not sb->addStateItem(key, value)) {
+        if (is_new)
+          delete sb;
+        return nullptr;
+      }
+    }
+    if (is_new)
+      c->addStateBlock(sb);
+  }
+  /////////////////////////////////////
+  std::vector<StreamInterface*> ifaces;
+  for (auto ifmap : _interfaceMaps(c.get())) {
+    size_t numifaces = inp.getItem<uint32_t>();
+    for (size_t i = 0; i < numifaces; i++) {
+      auto sif            = new StreamInterface;
+      sif->mName          = _readString(inp);
+      sif->mInterfaceType = inp.getItem<GLenum>();
+      sif->_gspriminpsize = inp.getItem<int32_t>();
+      sif->_gsprimoutsize = inp.getItem<int32_t>();
+      size_t numsifsets   = inp.getItem<uint32_t>();
+      for (size_t s = 0; s < numsifsets; s++)
+        sif->_uniformSets.push_back(c->uniformset(_readString(inp)));
+      size_t numsifblocks = inp.getItem<uint32_t>();
+      for (size_t b = 0; b < numsifblocks; b++)
+        sif->_uniformBlocks.push_back(c->uniformBlock(_readString(inp)));
+      _readAttributes(inp, sif->_inputAttributes);
+      _readAttributes(inp, sif->_outputAttributes);
+      (*ifmap)[sif->mName] = sif;
+      ifaces.push_back(sif);
+    }
+  }
+  /////////////////////////////////////
+  _readShaders(inp, c, c->_vertexShaders, ifaces);
+  _readShaders(inp, c, c->_tessCtrlShaders, ifaces);
+  _readShaders(inp, c, c->_tessEvalShaders, ifaces);
+  _readShaders(inp, c, c->_geometryShaders, ifaces);
+  _readShaders(inp, c, c->_fragmentShaders, ifaces);
+#if defined(ENABLE_NVMESH_SHADERS)
+  _readShaders(inp, c, c->_nvTaskShaders, ifaces);
+  _readShaders(inp, c, c->_nvMeshShaders, ifaces);
+#endif
+#if defined(ENABLE_COMPUTE_SHADERS)
+  _readShaders(inp, c, c->_computeShaders, ifaces);
+#endif
+  /////////////////////////////////////
+  size_t numteks = inp.getItem<uint32_t>();
+  for (size_t i = 0; i < numteks; i++) {
+    auto tek         = new Technique(_readString(inp));
+    size_t numpasses = inp.getItem<uint32_t>();
+    for (size_t p = 0; p < numpasses; p++) {
+      auto pass   = new Pass(_readString(inp));
+      auto sbname = _readString(inp);
+      if (sbname.length())
+        pass->_stateBlock = c->GetStateBlock(sbname);
+      uint8_t pipetype = inp.getItem<uint8_t>();
+      if (pipetype == 1) {
+        auto& vtg           = pass->_primpipe.make<PrimPipelineVTG>();
+        vtg._vertexShader   = c->vertexShader(_readString(inp));
+        vtg._tessCtrlShader = c->tessCtrlShader(_readString(inp));
+        vtg._tessEvalShader = c->tessEvalShader(_readString(inp));
+        vtg._geometryShader = c->geometryShader(_readString(inp));
+        vtg._fragmentShader = c->fragmentShader(_readString(inp));
+      }
+#if defined(ENABLE_NVMESH_SHADERS)
+      else if (pipetype == 2) {
+        auto& nvtm           = pass->_primpipe.make<PrimPipelineNVTM>();
+        nvtm._nvTaskShader   = c->nvTaskShader(_readString(inp));
+        nvtm._nvMeshShader   = c->nvMeshShader(_readString(inp));
+        nvtm._fragmentShader = c->fragmentShader(_readString(inp));
+      }
+#endif
+      tek->addPass(pass);
+    }
+    c->addTechnique(tek);
+  }
+  OrkAssert(inp._cursor == inp.length());
+  return c;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ork::lev2::glslfx
+/////////////////////////////////////////////////////////////////////////////////////////////////
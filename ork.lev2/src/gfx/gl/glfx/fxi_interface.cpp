@@ -57,6 +57,8 @@ bool Interface::LoadFxShader(const AssetPath& pth, FxShader* pfxshader) {
 
   if (bok) {
     BindContainerToAbstract(container, pfxshader);
+    if (mTarget._SUPPORTS_PARALLEL_SHADER_COMPILE)
+      compileAllPipelines(container);
   }
   GL_ERRORCHECK();
 
@@ -76,6 +78,8 @@ FxShader* Interface::shaderFromShaderText(const std::string& name, const std::st
 
   if (bok) {
     BindContainerToAbstract(container, pfxshader);
+    if (mTarget._SUPPORTS_PARALLEL_SHADER_COMPILE)
+      compileAllPipelines(container);
   }
   GL_ERRORCHECK();
 
@@ -14,6 +14,7 @@
 #include "glslfxi.h"
 #include "glslfxi_parser.h"
 #include <ork/file/file.h>
+#include <ork/kernel/datacache.h>
 #include <ork/lev2/gfx/gfxenv.h>
 #include <ork/pch.h>
 #include <ork/kernel/string/string.h>
@@ -25,43 +26,23 @@
 namespace ork::lev2::glslfx {
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
-rootcontainer_ptr_t LoadFxFromFile(const AssetPath& pth) {
-  auto scanner = std::make_shared<Scanner>(block_regex);
-  ///////////////////////////////////
-  File fx_file(pth, EFM_READ);
-  OrkAssert(fx_file.IsOpen());
-  EFileErrCode eFileErr = fx_file.GetLength(scanner->ifilelen);
-  scanner->resize(scanner->ifilelen + 1);
-  eFileErr = fx_file.Read(scanner->_fxbuffer.data(), 
-                          scanner->ifilelen);
-  scanner->_fxbuffer[scanner->ifilelen] = 0;
-  ///////////////////////////////////
-  parser::performScan(scanner);
-  auto program = std::make_shared<parser::Program>(pth.c_str());
-  auto parser = std::make_shared<parser::GlSlFxParser>(pth.c_str(), 
-                                               program,
-                                               scanner);
-  ///////////////////////////////////
-  auto topnode = parser->_topNode;
-  auto pcont = std::make_shared<RootContainer>(pth.c_str());
-  shaderbuilder::BackEnd backend(parser, pcont);
-  bool ok = backend.generate();
-  assert(ok);
-  ///////////////////////////////////
-  return pcont;
-}
-
+///////////////////////////////////////////////////////////////////////////////
+// scan/parse/generate, or pull the generated container from the
+//  DataBlockCache when neither the source nor its imports changed
 ///////////////////////////////////////////////////////////////////////////////
 
-rootcontainer_ptr_t LoadFxFromText(const std::string& name, const std::string& shadertext) {
-  auto scanner = std::make_shared<Scanner>(block_regex);
+static rootcontainer_ptr_t _loadFx(const std::string& name, const char* text, size_t length) {
+  uint64_t cache_key = containerCacheKey(driverIdentity(), name, text, length);
+  if (auto cached = DataBlockCache::findDataBlock(cache_key)) {
+    if (auto pcont = deserializeContainer(cached, name))
+      return pcont;
+  }
   ///////////////////////////////////
-  scanner->ifilelen = shadertext.length();
-  scanner->resize(scanner->ifilelen + 1);
-  memcpy(scanner->_fxbuffer.data(), 
-         shadertext.c_str(), 
-         scanner->ifilelen);
-  scanner->_fxbuffer[scanner->ifilelen] = 0;
+  auto scanner      = std::make_shared<Scanner>(block_regex);
+  scanner->ifilelen = length;
+  scanner->resize(length + 1);
+  memcpy(scanner->_fxbuffer.data(), text, length);
+  scanner->_fxbuffer[length] = 0;
   ///////////////////////////////////
   parser::performScan(scanner);
   auto program = std::make_shared<parser::Program>(name);
@@ -69,15 +50,34 @@ rootcontainer_ptr_t LoadFxFromText(const std::string& name, const std::string& s
                                                program,
                                                scanner);
   ///////////////////////////////////
-  auto topnode = parser->_topNode;
   auto pcont = std::make_shared<RootContainer>(name);
   shaderbuilder::BackEnd backend(parser, pcont);
   bool ok = backend.generate();
   assert(ok);
   ///////////////////////////////////
+  DataBlockCache::setDataBlock(cache_key, serializeContainer(pcont, program->_dependencies));
   return pcont;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+rootcontainer_ptr_t LoadFxFromFile(const AssetPath& pth) {
+  File fx_file(pth, EFM_READ);
+  OrkAssert(fx_file.IsOpen());
+  size_t length = 0;
+  EFileErrCode eFileErr = fx_file.GetLength(length);
+  std::vector<char> buffer(length);
+  eFileErr = fx_file.Read(buffer.data(), length);
+  ///////////////////////////////////
+  return _loadFx(pth.c_str(), buffer.data(), length);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+rootcontainer_ptr_t LoadFxFromText(const std::string& name, const std::string& shadertext) {
+  return _loadFx(name, shadertext.c_str(), shadertext.length());
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 } //namespace ork::lev2::glslfx {
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -10,6 +10,8 @@
 #include <ork/file/file.h>
 #include <ork/kernel/prop.h>
 #include <ork/kernel/string/string.h>
+#include <ork/util/logger.h>
+#include <map>
 
 namespace ork::lev2::glslfx {
 
@@ -24,4 +26,76 @@ namespace ork::lev2::glslfx {
     return rval;
   }
 
+  ///////////////////////////////////////////////////////////////////////////////
+  // state items are kept as text so a cached container can rebuild
+  //  its applicators without the parser. this table is the one list of
+  //  known keys and values, the stateblock parser node checks keys
+  //  against it too. a null applicator is a known value that leaves the
+  //  inherited state alone.
+  ///////////////////////////////////////////////////////////////////////////////
+
+  using statevalues_t = std::map<std::string, state_applicator_t>;
+
+  static const std::map<std::string, statevalues_t>& _stateItemTable() {
+    static const std::map<std::string, statevalues_t> _table = {
+        {"CullTest",
+         {
+             {"OFF", [](Context* t) { t->RSI()->SetCullTest(lev2::ECullTest::OFF); }},
+             {"PASS_FRONT", [](Context* t) { t->RSI()->SetCullTest(lev2::ECullTest::PASS_FRONT); }},
+             {"PASS_BACK", [](Context* t) { t->RSI()->SetCullTest(lev2::ECullTest::PASS_BACK); }},
+         }},
+        {"DepthMask",
+         {
+             {"true", [](Context* t) { t->RSI()->SetZWriteMask(true); }},
+             {"false", [](Context* t) { t->RSI()->SetZWriteMask(false); }},
+             {"ON", [](Context* t) { t->RSI()->SetZWriteMask(false); }}, // only "true" ever enabled it
+         }},
+        {"DepthTest",
+         {
+             {"OFF", [](Context* t) { t->RSI()->SetDepthTest(lev2::EDepthTest::OFF); }},
+             {"LESS", [](Context* t) { t->RSI()->SetDepthTest(lev2::EDepthTest::LESS); }},
+             {"LEQUALS", [](Context* t) { t->RSI()->SetDepthTest(lev2::EDepthTest::LEQUALS); }},
+             {"GREATER", [](Context* t) { t->RSI()->SetDepthTest(lev2::EDepthTest::GREATER); }},
+             {"GEQUALS", [](Context* t) { t->RSI()->SetDepthTest(lev2::EDepthTest::GEQUALS); }},
+             {"EQUALS", [](Context* t) { t->RSI()->SetDepthTest(lev2::EDepthTest::EQUALS); }},
+         }},
+        {"BlendMode",
+         {
+             {"OFF", nullptr},
+             {"ADDITIVE", [](Context* t) { t->RSI()->SetBlending(lev2::Blending::ADDITIVE); }},
+             {"ALPHA_ADDITIVE", [](Context* t) { t->RSI()->SetBlending(lev2::Blending::ALPHA_ADDITIVE); }},
+             {"SUBTRACTIVE", [](Context* t) { t->RSI()->SetBlending(lev2::Blending::SUBTRACTIVE); }},
+             {"ALPHA_SUBTRACTIVE", [](Context* t) { t->RSI()->SetBlending(lev2::Blending::ALPHA_SUBTRACTIVE); }},
+             {"ALPHA", [](Context* t) { t->RSI()->SetBlending(lev2::Blending::ALPHA); }},
+         }},
+    };
+    return _table;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool StateBlock::isStateKey(const std::string& key) {
+    return _stateItemTable().count(key) != 0;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////
+
+  bool StateBlock::addStateItem(const std::string& key, const std::string& value) {
+    const auto& table = _stateItemTable();
+    auto itk          = table.find(key);
+    if (itk == table.end()) {
+      logerrchannel()->log("StateBlock<%s> unknown state key<%s>", mName.c_str(), key.c_str());
+      return false;
+    }
+    auto itv = itk->second.find(value);
+    if (itv == itk->second.end()) {
+      logerrchannel()->log("StateBlock<%s> unknown value<%s> for state key<%s>", mName.c_str(), value.c_str(), key.c_str());
+      return false;
+    }
+    _stateitems.push_back(stateitem_t(key, value));
+    if (itv->second)
+      addStateFn(itv->second);
+    return true;
+  }
+
 } // namespace ork::lev2::glslfx {
@@ -14,6 +14,7 @@
 #include <ork/lev2/gfx/texman.h>
 #include <ork/pch.h>
 #include <ork/util/scanner.h>
+#include <ork/kernel/datablock.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -218,12 +219,16 @@ typedef std::function<void(Context*)> state_applicator_t;
 ///////////////////////////////////////////////////////////////////////////////
 
 struct StateBlock {
+  using stateitem_t = std::pair<std::string, std::string>;
   std::string mName;
   std::vector<state_applicator_t> mApplicators;
+  std::vector<stateitem_t> _stateitems; // source of mApplicators, for the container cache
 
   void addStateFn(const state_applicator_t& f) {
     mApplicators.push_back(f);
   }
+  bool addStateItem(const std::string& key, const std::string& value); // false (logged) : unknown key or value
+  static bool isStateKey(const std::string& key);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -235,6 +240,7 @@ struct Shader {
       , mShaderType(etyp) {
   }
 
+  void beginCompile(); // issue only, status is collected by Compile()
   bool Compile();
   bool IsCompiled() const;
   void addUniformSet(UniformSet*);
@@ -250,8 +256,9 @@ struct Shader {
   rootcontainer_ptr_t _rootcontainer;
   GLuint mShaderObjectId           = 0;
   GLenum mShaderType;
-  bool mbCompiled = false;
-  bool mbError    = false;
+  bool mbCompiled     = false;
+  bool mbError        = false;
+  bool _compileIssued = false;
   std::vector<UniformBlock*> _uniblocks;
   std::vector<UniformSet*> _unisets;
 };
@@ -378,6 +385,12 @@ struct Pass {
   Attribute* _vtxAttributeById[kmaxattrID];
   Technique* _technique = nullptr;
   std::unordered_map<int,int> _samplerBindingMap;
+  ////////////////////////////////////
+  // in flight link (see Interface::compileAllPipelines)
+  ////////////////////////////////////
+  GLuint _pendingProgramObjectId = 0;
+  uint64_t _pipelineHash         = 0;
+  bool _linkFromBinary           = false;
 
   int assignSampler(int loc);
 
@@ -582,6 +595,10 @@ public:
   bool compileAndLink(rootcontainer_ptr_t container);
   bool compilePipelineVTG(rootcontainer_ptr_t container);
   bool compilePipelineNVTM(rootcontainer_ptr_t container);
+  bool compileAllPipelines(rootcontainer_ptr_t container);
+
+  bool _beginPipelineVTG(rootcontainer_ptr_t container, Pass* pass);
+  bool _endPipelineVTG(rootcontainer_ptr_t container, Pass* pass, bool begin_ok);
 
   // ubo
   FxShaderParamBuffer* createParamBuffer(size_t length) final;
@@ -626,6 +643,29 @@ struct ComputeInterface : public lev2::ComputeInterface {
 #endif
 
 rootcontainer_ptr_t LoadFxFromFile(const AssetPath& pth);
+rootcontainer_ptr_t LoadFxFromText(const std::string& name, const std::string& shadertext);
+
+///////////////////////////////////////////////////////////////////////////////
+// compiled container cache
+//  the generated RootContainer (techniques, passes, interfaces,
+//  uniforms, final shader text) is persisted in the DataBlockCache
+//  keyed by source content and driverIdentity(), so a warm load does
+//  no scanning or parsing.
+//  imported files are recorded as dependencies and revalidated on load.
+///////////////////////////////////////////////////////////////////////////////
+
+struct ContainerDependency {
+  std::string _path;
+  uint64_t _contenthash = 0;
+};
+
+using containerdeps_t = std::vector<ContainerDependency>;
+
+std::string driverIdentity(); // GL vendor, renderer and version strings
+uint64_t containerCacheKey(const std::string& driverid, const std::string& name, const void* text, size_t length);
+uint64_t fileContentHash(const std::string& path);
+datablock_ptr_t serializeContainer(rootcontainer_ptr_t container, const containerdeps_t& deps);
+rootcontainer_ptr_t deserializeContainer(datablock_ptr_t block, const std::string& name);
 
 } // namespace ork::lev2::glslfx
 
@@ -132,6 +132,7 @@ struct Program {
   std::unordered_map<std::string, decoblocknode_ptr_t> _blockNodes;
   std::vector<decoblocknode_ptr_t> _orderedBlockNodes;
   std::string _name;
+  containerdeps_t _dependencies; // imported files, for the container cache
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -996,10 +997,7 @@ struct StateBlockNode : public DecoBlockNode {
   }
   void parse(GlSlFxParser* parser, const ScannerView& view);
   void _generate2(shaderbuilder::BackEnd& backend) const final;
-  std::string _culltest;
-  std::string _depthmask;
-  std::string _depthtest;
-  std::string _blendmode;
+  std::vector<StateBlock::stateitem_t> _stateitems; // source order
 };
 
 struct VertexShaderNode : public ShaderNode {
@@ -44,11 +44,11 @@ void performScan(scanner_ptr_t scanner) {
   loadScannerRules(_rr);
 
   scanner->buildStateMachine();
+  scanner->ignoreTokensOfClass(id_t(TokenClass::SINGLE_LINE_COMMENT));
+  scanner->ignoreTokensOfClass(id_t(TokenClass::MULTI_LINE_COMMENT));
+  scanner->ignoreTokensOfClass(id_t(TokenClass::WHITESPACE));
+  scanner->ignoreTokensOfClass(id_t(TokenClass::NEWLINE));
   scanner->scan();
-  scanner->discardTokensOfClass(id_t(TokenClass::SINGLE_LINE_COMMENT));
-  scanner->discardTokensOfClass(id_t(TokenClass::MULTI_LINE_COMMENT));
-  scanner->discardTokensOfClass(id_t(TokenClass::WHITESPACE));
-  scanner->discardTokensOfClass(id_t(TokenClass::NEWLINE));
 }
 
 void checktoken(const ScannerView& view, int actual_index, std::string expected) {
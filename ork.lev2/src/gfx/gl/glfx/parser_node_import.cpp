@@ -63,6 +63,12 @@ void ImportNode::load(){
     importscanner->resize(importscanner->ifilelen + 1);
     eFileErr                                          = fx_file.Read(importscanner->_fxbuffer.data(), importscanner->ifilelen);
     importscanner->_fxbuffer[importscanner->ifilelen] = 0;
+    ///////////////////////////////////
+    auto content_hasher = DataBlock::createHasher();
+    content_hasher->accumulate(importscanner->_fxbuffer.data(), importscanner->ifilelen);
+    content_hasher->finish();
+    program->_dependencies.push_back(ContainerDependency{imppath.c_str(), content_hasher->result()});
+    ///////////////////////////////////
     performScan(importscanner);
     _parser = std::make_shared<GlSlFxParser>(imppath.c_str(),program,importscanner);
 }
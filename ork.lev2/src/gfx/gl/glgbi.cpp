@@ -127,6 +127,71 @@ struct GLIdxBufHandle {
   }
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// persistent mapped streaming ring for dynamic vertex buffers
+//  (GL_ARB_buffer_storage). one ring per context, split into knumsegments
+//  per frame segments and mapped once. each dynamic vertex buffer owns a
+//  window (its full capacity) suballocated from the active segment, draws
+//  select it via base vertex. writes within a window only ever move forward
+//  (VtxWriter appends, or ring locks), so the gpu never reads what is being
+//  written. a lock that rewinds gets a fresh window, the live prefix below
+//  the lock is copied over on the gpu. at each frame the active segment is
+//  fenced and the next one is claimed, waiting on its fence only if the gpu
+//  has not caught up yet. windows still living in the segment reclaimed
+//  after that are copied forward first, so buffers that are not rewritten
+//  every frame keep their contents.
+///////////////////////////////////////////////////////////////////////////////
+
+struct GLVtxBufHandle;
+
+struct GLStreamWindow {
+  size_t _offset    = 0;     // bytes from the start of the ring (multiple of _vtxsize)
+  size_t _bytes     = 0;     // window capacity
+  int _vtxsize      = 0;
+  int _segment      = -1;    // -1 : not placed yet
+  int _writecursor  = 0;     // vertex high water mark
+  bool _locked      = false;
+  bool _pending     = false; // moved while locked, copy from _movedFrom at unlock
+  size_t _movedFrom = 0;
+  int baseVertex() const {
+    return (_segment < 0) ? 0 : int(_offset / _vtxsize);
+  }
+};
+
+struct GLStreamRing {
+  static constexpr int knumsegments       = 3;
+  static constexpr size_t ksegmentbytes   = 16 << 20;
+  static constexpr size_t kmaxwindowbytes = ksegmentbytes / 4; // larger buffers keep their own vbo
+  static constexpr GLuint64 kfencewait    = 1000000;           // 1 ms per wait slice
+
+  GLStreamRing();
+  ~GLStreamRing();
+
+  void attach(GLVtxBufHandle* hbuf);
+  void lock(GLVtxBufHandle* hbuf, int ibase, int icount, GeometryStreamStats& stats);
+  void unlock(GLVtxBufHandle* hbuf, GeometryStreamStats& stats);
+  void rotate(GeometryStreamStats& stats);
+  void release(GLVtxBufHandle* hbuf);
+
+  GLuint _vbo      = 0;
+  uint8_t* _mapped = nullptr;
+  int _segment     = 0;
+  size_t _cursor   = 0; // bytes used in the active segment
+  GLsync _fences[knumsegments];
+  std::vector<GLVtxBufHandle*> _residents[knumsegments]; // handles placed in each segment
+  std::set<GLVtxBufHandle*> _attached;
+  std::vector<GLVtxBufHandle*> _pendingMoves;
+
+private:
+  void _reserve(size_t bytes, int vtxsize, GeometryStreamStats& stats);
+  void _place(GLVtxBufHandle* hbuf, size_t bytes, int vtxsize);
+  void _copy(size_t src, size_t dst, size_t bytes, GeometryStreamStats& stats);
+  size_t _alignedCursor(int vtxsize) const;
+  void _waitFence(GLsync& fence, GeometryStreamStats& stats);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 struct GLVaoHandle {
   const GLIdxBufHandle* mIBO = nullptr;
 
@@ -151,6 +216,8 @@ struct GLVtxBufHandle {
   int miLockCount;
   bool mbSetupSource;
   GlVtxBufMapData* mMappedRegion;
+  GLStreamRing* _streamRing = nullptr; // shared, owned by the gbi
+  GLStreamWindow _streamWindow;
 
   std::map<size_t, GLVaoHandle*> mVaoMap;
 
@@ -163,7 +230,9 @@ struct GLVtxBufHandle {
       , mMappedRegion(nullptr) {
   }
   ~GLVtxBufHandle() {
-    if (mVBO) {
+    if (_streamRing) {
+      _streamRing->release(this);
+    } else if (mVBO) {
       glDeleteBuffers(1, &mVBO);
     }
     for( auto item : mVaoMap ){
@@ -191,9 +260,24 @@ struct GLVtxBufHandle {
     glBindVertexArray(r->mVAO);
     return r;
   }
-  void CreateVbo(VertexBufferBase& VBuf) {
+  void CreateVbo(VertexBufferBase& VBuf, GLStreamRing* ring) {
     VertexBufferBase* pnonconst = const_cast<VertexBufferBase*>(&VBuf);
 
+    //////////////////////////////////////////////
+    // dynamic, suballocated from the streaming ring ?
+    //////////////////////////////////////////////
+
+    size_t windowbytes = size_t(VBuf.GetVtxSize()) * size_t(VBuf.GetMax());
+    if (ring and (false == VBuf.IsStatic()) and (windowbytes <= GLStreamRing::kmaxwindowbytes)) {
+      _streamRing            = ring;
+      _streamWindow._bytes   = windowbytes;
+      _streamWindow._vtxsize = VBuf.GetVtxSize();
+      mVBO                   = ring->_vbo;
+      mBufSize               = windowbytes;
+      ring->attach(this);
+      return;
+    }
+
     // printf( "CreateVBO()\n");
 
     // Create A VBO and copy data into it
@@ -250,12 +334,228 @@ struct GLVtxBufHandle {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+GLStreamRing::GLStreamRing() {
+  for (int i = 0; i < knumsegments; i++)
+    _fences[i] = nullptr;
+  size_t ringlen = ksegmentbytes * knumsegments;
+  glGenBuffers(1, &_vbo);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, _vbo);
+  ///////////////////////////////////////
+  // upload only : write-only storage, and the segment
+  //  fences already order cpu writes against gpu reads,
+  //  so the driver need not synchronize the mapping
+  ///////////////////////////////////////
+  u32 storageflags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  u32 mapflags     = storageflags | GL_MAP_UNSYNCHRONIZED_BIT;
+  glBufferStorage(GL_COPY_WRITE_BUFFER, ringlen, nullptr, storageflags);
+  GL_ERRORCHECK();
+  _mapped = (uint8_t*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, ringlen, mapflags);
+  GL_ERRORCHECK();
+  OrkAssert(_mapped != nullptr);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+GLStreamRing::~GLStreamRing() {
+  for (int i = 0; i < knumsegments; i++)
+    if (_fences[i])
+      glDeleteSync(_fences[i]);
+  for (auto hbuf : _attached) { // their vbo is ours
+    hbuf->_streamRing = nullptr;
+    hbuf->mVBO        = 0;
+  }
+  glDeleteBuffers(1, &_vbo); // also unmaps it
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GLStreamRing::attach(GLVtxBufHandle* hbuf) {
+  _attached.insert(hbuf);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GLStreamRing::release(GLVtxBufHandle* hbuf) {
+  _attached.erase(hbuf);
+  std::erase(_pendingMoves, hbuf);
+  for (auto& residents : _residents)
+    std::erase(residents, hbuf);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t GLStreamRing::_alignedCursor(int vtxsize) const {
+  size_t abs = (_segment * ksegmentbytes) + _cursor;
+  return ((abs + vtxsize - 1) / vtxsize) * vtxsize; // base vertex addressable
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// make room in the active segment, claiming the next one early
+//  if this frame has outgrown it
+///////////////////////////////////////////////////////////////////////////////
+
+void GLStreamRing::_reserve(size_t bytes, int vtxsize, GeometryStreamStats& stats) {
+  size_t segend = (_segment + 1) * ksegmentbytes;
+  if ((_alignedCursor(vtxsize) + bytes) > segend)
+    rotate(stats);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GLStreamRing::_place(GLVtxBufHandle* hbuf, size_t bytes, int vtxsize) {
+  size_t offset = _alignedCursor(vtxsize);
+  OrkAssert((offset + bytes) <= ((_segment + 1) * ksegmentbytes));
+  auto& window        = hbuf->_streamWindow;
+  window._offset      = offset;
+  window._segment     = _segment;
+  window._writecursor = 0;
+  _cursor             = (offset + bytes) - (_segment * ksegmentbytes);
+  _residents[_segment].push_back(hbuf);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// gpu side copy within the ring, ordered after the draws already
+//  submitted, and visible to the ones that follow
+///////////////////////////////////////////////////////////////////////////////
+
+void GLStreamRing::_copy(size_t src, size_t dst, size_t bytes, GeometryStreamStats& stats) {
+  if (0 == bytes)
+    return;
+  glBindBuffer(GL_COPY_WRITE_BUFFER, _vbo);
+  glCopyBufferSubData(GL_COPY_WRITE_BUFFER, GL_COPY_WRITE_BUFFER, src, dst, bytes);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  GL_ERRORCHECK();
+  stats._windowCopies++;
+  stats._bytesCopied += bytes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GLStreamRing::_waitFence(GLsync& fence, GeometryStreamStats& stats) {
+  if (nullptr == fence)
+    return;
+  GLenum status = glClientWaitSync(fence, 0, 0);
+  if (status == GL_ALREADY_SIGNALED or status == GL_CONDITION_SATISFIED)
+    stats._stallsAvoided++;
+  else {
+    stats._stalls++;
+    do {
+      status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kfencewait);
+    } while (status == GL_TIMEOUT_EXPIRED);
+    OrkAssert(status != GL_WAIT_FAILED);
+  }
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// fence the active segment, claim the next one, then move the windows
+//  still living in the segment after it (the next to be reclaimed) into
+//  the claimed one. that segment's fence is re-issued after the copies,
+//  so its reclaim also waits for them. a window that is locked (only
+//  possible on an early rotation) is still being written through the old
+//  mapping, its copy waits for the unlock.
+///////////////////////////////////////////////////////////////////////////////
+
+void GLStreamRing::rotate(GeometryStreamStats& stats) {
+  if (_fences[_segment])
+    glDeleteSync(_fences[_segment]);
+  _fences[_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  _segment          = (_segment + 1) % knumsegments;
+  _cursor           = 0;
+  stats._numRotations++;
+  for (auto hbuf : _pendingMoves) // locked across two rotations ?
+    OrkAssert(int(hbuf->_streamWindow._movedFrom / ksegmentbytes) != _segment);
+  _waitFence(_fences[_segment], stats);
+  _residents[_segment].clear(); // moved out at the previous rotation
+  int next       = (_segment + 1) % knumsegments;
+  auto residents = std::move(_residents[next]);
+  _residents[next].clear();
+  bool copied = false;
+  for (auto hbuf : residents) {
+    const auto& window = hbuf->_streamWindow;
+    if (window._segment != next)
+      continue; // already moved on
+    size_t src = window._offset;
+    int live   = window._writecursor;
+    _place(hbuf, window._bytes, window._vtxsize);
+    hbuf->_streamWindow._writecursor = live;
+    if (window._locked) {
+      hbuf->_streamWindow._pending   = true;
+      hbuf->_streamWindow._movedFrom = src;
+      _pendingMoves.push_back(hbuf);
+    } else {
+      _copy(src, window._offset, size_t(live) * window._vtxsize, stats);
+      copied = true;
+    }
+  }
+  if (copied) {
+    if (_fences[next])
+      glDeleteSync(_fences[next]);
+    _fences[next] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// a forward lock writes in place. a rewind (ring wrap or Reset())
+//  gets a fresh window, so the gpu may still read the old one.
+///////////////////////////////////////////////////////////////////////////////
+
+void GLStreamRing::lock(GLVtxBufHandle* hbuf, int ibase, int icount, GeometryStreamStats& stats) {
+  auto& window = hbuf->_streamWindow;
+  if (window._segment < 0 or ibase < window._writecursor) {
+    _reserve(window._bytes, window._vtxsize, stats); // may move this window too
+    size_t src = window._offset;
+    bool keep  = (window._segment >= 0) and (ibase > 0);
+    _place(hbuf, window._bytes, window._vtxsize);
+    if (keep) // live prefix below the lock
+      _copy(src, window._offset, size_t(ibase) * window._vtxsize, stats);
+  }
+  window._writecursor = ibase + icount;
+  window._locked      = true;
+  stats._bytesStreamed += size_t(icount) * window._vtxsize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GLStreamRing::unlock(GLVtxBufHandle* hbuf, GeometryStreamStats& stats) {
+  auto& window   = hbuf->_streamWindow;
+  window._locked = false;
+  if (window._pending) {
+    window._pending = false;
+    std::erase(_pendingMoves, hbuf);
+    _copy(window._movedFrom, window._offset, size_t(window._writecursor) * window._vtxsize, stats);
+    GLsync& fence = _fences[window._movedFrom / ksegmentbytes];
+    if (fence)
+      glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 GlGeometryBufferInterface::GlGeometryBufferInterface(ContextGL& target)
     : GeometryBufferInterface(target)
     , mTargetGL(target)
     , mLastComponentMask(0) {
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+GlGeometryBufferInterface::~GlGeometryBufferInterface() {
+  if (_streamRing)
+    delete _streamRing;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GlGeometryBufferInterface::_doBeginFrame() {
+  mLastComponentMask = 0;
+  if (_streamRing)
+    _streamRing->rotate(_streamStats);
+}
+
 static void ClearVao() {
   GL_ERRORCHECK();
   glBindVertexArray(0);
@@ -281,7 +581,12 @@ void* GlGeometryBufferInterface::LockVB(VertexBufferBase& VBuf, int ibase, int i
     hBuf = new GLVtxBufHandle;
     VBuf.SetHandle(reinterpret_cast<void*>(hBuf));
 
-    hBuf->CreateVbo(VBuf);
+#if defined(OPENGL_46)
+    bool persistent = mTargetGL._SUPPORTS_BUFFER_STORAGE and mTargetGL._SUPPORTS_PERSISTENT_MAP;
+    if (persistent and (false == VBuf.IsStatic()) and (nullptr == _streamRing))
+      _streamRing = new GLStreamRing;
+#endif
+    hBuf->CreateVbo(VBuf, _streamRing);
   }
 
   int iMax = VBuf.GetMax();
@@ -291,6 +596,21 @@ void* GlGeometryBufferInterface::LockVB(VertexBufferBase& VBuf, int ibase, int i
 
   GL_ERRORCHECK();
 
+  //////////////////////////////////////////////////////////
+  // streaming ring: write straight into the persistent
+  //  mapping (gl calls only when a rewind copies a prefix)
+  //////////////////////////////////////////////////////////
+
+  if (auto ring = hBuf->_streamRing) {
+    OrkAssert(isizebytes);
+    OrkAssert((ibase + icount) <= iMax);
+    ring->lock(hBuf, ibase, icount, _streamStats);
+    hBuf->miLockBase  = ibase;
+    hBuf->miLockCount = icount;
+    VBuf.Lock();
+    return ring->_mapped + hBuf->_streamWindow._offset + ibasebytes;
+  }
+
   ClearVao();
 
   //////////////////////////////////////////////////////////
@@ -387,6 +707,27 @@ const void* GlGeometryBufferInterface::LockVB(const VertexBufferBase& VBuf, int
 
   // printf( "ibasebytes<%d> isizebytes<%d> icount<%d> \n", ibasebytes, isizebytes, icount );
 
+  //////////////////////////////////////////////////////////
+  // streaming ring : its mapping is write-only,
+  //  so reads go through a copy of the window
+  //////////////////////////////////////////////////////////
+
+  if (hBuf->_streamRing) {
+    OrkAssert(hBuf->_streamWindow._segment >= 0);
+    GlVtxBufMapPool* pool = GetBufMapPool();
+    hBuf->mMappedRegion   = pool->GetVbmd(isizebytes);
+    RetBufMapPool(pool);
+    OrkAssert(hBuf->mMappedRegion != nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, hBuf->mVBO);
+    glGetBufferSubData(GL_ARRAY_BUFFER, hBuf->_streamWindow._offset + ibasebytes, isizebytes, hBuf->mMappedRegion->mpData);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL_ERRORCHECK();
+    hBuf->miLockBase  = ibase;
+    hBuf->miLockCount = icount;
+    VBuf.Lock();
+    return hBuf->mMappedRegion->mpData;
+  }
+
   ClearVao();
 
   //////////////////////////////////////////////////////////
@@ -423,6 +764,12 @@ void GlGeometryBufferInterface::UnLockVB(VertexBufferBase& VBuf) {
 
   GLVtxBufHandle* hBuf = reinterpret_cast<GLVtxBufHandle*>(VBuf.GetHandle());
 
+  if (auto ring = hBuf->_streamRing) { // coherent mapping, nothing to flush
+    ring->unlock(hBuf, _streamStats);
+    VBuf.Unlock();
+    return;
+  }
+
   if (VBuf.IsStatic()) {
     GL_ERRORCHECK();
 
@@ -475,6 +822,13 @@ void GlGeometryBufferInterface::UnLockVB(const VertexBufferBase& VBuf) {
   GLVtxBufHandle* hBuf = reinterpret_cast<GLVtxBufHandle*>(VBuf.GetHandle());
   GL_ERRORCHECK();
 
+  if (hBuf->_streamRing) {
+    hBuf->mMappedRegion->ReturnToPool();
+    hBuf->mMappedRegion = nullptr;
+    VBuf.Unlock();
+    return;
+  }
+
   GL_ERRORCHECK();
   glBindBuffer(GL_ARRAY_BUFFER, hBuf->mVBO);
   GL_ERRORCHECK();
@@ -630,6 +984,18 @@ static bool EnableVtxBufComponents(const VertexBufferBase& VBuf, const svarp_t p
       _setConfig(cfgs);
       break;
     }
+    case lev2::EVtxStreamFormat::V8N4B4T8: {
+      // quantized : dequantized in the vertex shader (lib_vtx_dequant)
+      static vtx_config cfgs[] = {
+          {"POSITION", 4, GL_UNSIGNED_SHORT, AttrType::FLOAT_NORMALIZED, 0, 0, 0},
+          {"NORMAL", 2, GL_SHORT, AttrType::FLOAT_NORMALIZED, 8, 0, 0},
+          {"BINORMAL", 2, GL_SHORT, AttrType::FLOAT_NORMALIZED, 12, 0, 0},
+          {"TEXCOORD0", 2, GL_HALF_FLOAT, AttrType::FLOAT, 16, 0, 0},
+          {"TEXCOORD1", 2, GL_HALF_FLOAT, AttrType::FLOAT, 20, 0, 0},
+      };
+      _setConfig(cfgs);
+      break;
+    }
     case lev2::EVtxStreamFormat::V12N12T8DF12C4: {
       static vtx_config cfgs[] = {
           {"POSITION",  3, GL_FLOAT, AttrType::FLOAT,         0, 0, 0},
@@ -664,6 +1030,19 @@ static bool EnableVtxBufComponents(const VertexBufferBase& VBuf, const svarp_t p
       _setConfig(cfgs);
       break;
     }
+    case lev2::EVtxStreamFormat::V8N4B4T4I4W4: {
+      // quantized : dequantized in the vertex shader (lib_vtx_dequant)
+      static vtx_config cfgs[] = {
+          {"POSITION", 4, GL_UNSIGNED_SHORT, AttrType::FLOAT_NORMALIZED, 0, 0, 0},
+          {"NORMAL", 2, GL_SHORT, AttrType::FLOAT_NORMALIZED, 8, 0, 0},
+          {"BINORMAL", 2, GL_SHORT, AttrType::FLOAT_NORMALIZED, 12, 0, 0},
+          {"TEXCOORD0", 2, GL_HALF_FLOAT, AttrType::FLOAT, 16, 0, 0},
+          {"BONEINDICES", 4, GL_UNSIGNED_BYTE, AttrType::FLOAT, 20, 0, 0},
+          {"BONEWEIGHTS", 4, GL_UNSIGNED_BYTE, AttrType::FLOAT_NORMALIZED, 24, 0, 0},
+      };
+      _setConfig(cfgs);
+      break;
+    }
     case lev2::EVtxStreamFormat::V12N12T8I4W4: {
       static vtx_config cfgs[] = {
           {"POSITION", 3, GL_FLOAT, AttrType::FLOAT, 0, 0, 0},
@@ -748,6 +1127,13 @@ static bool EnableVtxBufComponents(const VertexBufferBase& VBuf, const svarp_t p
 
 ///////////////////////////////////////////////////////////////////////////////
 
+int GlGeometryBufferInterface::_streamBaseVertex(const VertexBufferBase& VBuf) const {
+  auto hBuf = reinterpret_cast<const GLVtxBufHandle*>(VBuf.GetHandle());
+  return (hBuf and hBuf->_streamRing) ? hBuf->_streamWindow.baseVertex() : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 bool GlGeometryBufferInterface::BindVertexStreamSource(const VertexBufferBase& VBuf) {
   svarp_t evb_priv;
   ////////////////////////////////////////////////////////////////////
@@ -856,6 +1242,8 @@ void GlGeometryBufferInterface::DrawPrimitiveEML(const VertexBufferBase& VBuf, P
 
   int inum = (ivcount == 0) ? VBuf.GetNumVertices() : ivcount;
 
+  ivbase += _streamBaseVertex(VBuf);
+
   if (inum) {
     GL_ERRORCHECK();
     switch (eType) {
@@ -983,6 +1371,8 @@ void GlGeometryBufferInterface::DrawIndexedPrimitiveEML(
   int imin = plat_handle->mMinIndex;
   int imax = plat_handle->mMaxIndex;
 
+  ivbase += _streamBaseVertex(VBuf);
+
   // GLint maxidx = 0;
   // glGetIntegerv( GL_MAX_ELEMENTS_INDICES, & maxidx );
   // printf( "iminidx<%d> maxidx<%d> iNum<%d>\n", imin, imax, iNum );
@@ -1066,7 +1456,11 @@ void GlGeometryBufferInterface::DrawInstancedIndexedPrimitiveEML(
         break;
     }
     if (glprimtype != 0) {
-      glDrawElementsInstanced(glprimtype, iNum, GL_UNSIGNED_SHORT, nullptr, instance_count);
+      int ivbase = _streamBaseVertex(VBuf);
+      if (ivbase != 0)
+        glDrawElementsInstancedBaseVertex(glprimtype, iNum, GL_UNSIGNED_SHORT, nullptr, instance_count, ivbase);
+      else
+        glDrawElementsInstanced(glprimtype, iNum, GL_UNSIGNED_SHORT, nullptr, instance_count);
     }
     GL_ERRORCHECK();
   }
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include "gl.h"
+#include <ork/pch.h>
+#include <ork/lev2/gfx/gfxenv.h>
+#include <ork/lev2/gfx/rtgroup.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// asynchronous readbacks through pixel pack buffers
+//
+//  glReadPixels into a bound GL_PIXEL_PACK_BUFFER returns as soon as the copy
+//   is queued. the fence behind it is polled without waiting
+//   (glClientWaitSync with a zero timeout), and only a signaled slot is
+//   mapped, so mapping never blocks either.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::lev2 {
+
+static constexpr GLuint64 kfencewait = 1000000; // 1 ms per wait slice
+
+///////////////////////////////////////////////////////////////////////////////
+
+void readbackPixelFormat(EBufferFormat fmt, GLenum& glformat, GLenum& gltype) {
+  switch (fmt) {
+    case EBufferFormat::RGBA8:
+      glformat = GL_RGBA;
+      gltype   = GL_UNSIGNED_BYTE;
+      break;
+    case EBufferFormat::RGBA16F:
+      glformat = GL_RGBA;
+      gltype   = GL_HALF_FLOAT;
+      break;
+    case EBufferFormat::RGBA16UI:
+      glformat = GL_RGBA_INTEGER;
+      gltype   = GL_UNSIGNED_SHORT;
+      break;
+    case EBufferFormat::RGBA32F:
+      glformat = GL_RGBA;
+      gltype   = GL_FLOAT;
+      break;
+    case EBufferFormat::RGBA32UI:
+      glformat = GL_RGBA_INTEGER;
+      gltype   = GL_UNSIGNED_INT;
+      break;
+    case EBufferFormat::RG32F:
+      glformat = GL_RG;
+      gltype   = GL_FLOAT;
+      break;
+    case EBufferFormat::R32F:
+      glformat = GL_RED;
+      gltype   = GL_FLOAT;
+      break;
+    case EBufferFormat::R32UI:
+      glformat = GL_RED_INTEGER;
+      gltype   = GL_UNSIGNED_INT;
+      break;
+    default:
+      OrkAssert(false);
+      break;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+GlReadbackInterface::GlReadbackInterface(ContextGL& target)
+    : ReadbackInterface(target)
+    , mTargetGL(target) {
+  _packSlots.resize(knumslots);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+GlReadbackInterface::~GlReadbackInterface() {
+  for (auto& slot : _packSlots) {
+    if (slot._fence)
+      glDeleteSync(slot._fence);
+    if (slot._pbo)
+      glDeleteBuffers(1, &slot._pbo);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GlReadbackInterface::_doSubmit(int slot_index, const ReadbackRequest& req) {
+  auto& slot = _packSlots[slot_index];
+  OrkAssert(slot._fence == nullptr);
+  mTargetGL.makeCurrentContext();
+  GL_ERRORCHECK();
+  /////////////////////////////////////////
+  // readbacks are enqueued mid frame,
+  //  leave the caller's bindings as found
+  /////////////////////////////////////////
+  GLint prev_readfbo = 0;
+  GLint prev_drawfbo = 0;
+  GLint prev_readbuf = 0;
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prev_readfbo);
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_drawfbo);
+  glGetIntegerv(GL_READ_BUFFER, &prev_readbuf);
+  slot._length = req.length();
+  if (0 == slot._pbo) {
+    glGenBuffers(1, &slot._pbo);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot._pbo);
+  if (slot._capacity < slot._length) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, slot._length, nullptr, GL_STREAM_READ);
+    slot._capacity = slot._length;
+  }
+  GL_ERRORCHECK();
+  /////////////////////////////////////////
+  // source
+  /////////////////////////////////////////
+  if (req._source) {
+    auto as_impl = req._source->_rtgroup->_impl.tryAs<glrtgroupimpl_ptr_t>();
+    OrkAssert(as_impl);
+    auto fboobj = as_impl.value()->_standard;
+    OrkAssert(fboobj->_fbo != 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fboobj->_fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0 + req._source->_slot);
+  } else {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glReadBuffer(GL_BACK);
+  }
+  GL_ERRORCHECK();
+  /////////////////////////////////////////
+  // copy into the pack buffer and fence it
+  /////////////////////////////////////////
+  GLenum glformat = GL_RGBA;
+  GLenum gltype   = GL_UNSIGNED_BYTE;
+  readbackPixelFormat(req._format, glformat, gltype);
+  glReadPixels(req._x, req._y, req._width, req._height, glformat, gltype, nullptr);
+  GL_ERRORCHECK();
+  slot._fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, GLuint(prev_readfbo));
+  glReadBuffer(GLenum(prev_readbuf));
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GLuint(prev_drawfbo));
+  GL_ERRORCHECK();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool GlReadbackInterface::_doPoll(int slot_index) {
+  auto& slot = _packSlots[slot_index];
+  OrkAssert(slot._fence != nullptr);
+  // the flush bit makes sure an unsignaled fence gets to the gpu at all
+  GLenum status = glClientWaitSync(slot._fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  OrkAssert(status != GL_WAIT_FAILED);
+  return (status == GL_ALREADY_SIGNALED or status == GL_CONDITION_SATISFIED);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GlReadbackInterface::_doWait(int slot_index) {
+  auto& slot = _packSlots[slot_index];
+  OrkAssert(slot._fence != nullptr);
+  GLenum status = GL_TIMEOUT_EXPIRED;
+  do {
+    status = glClientWaitSync(slot._fence, GL_SYNC_FLUSH_COMMANDS_BIT, kfencewait);
+  } while (status == GL_TIMEOUT_EXPIRED);
+  OrkAssert(status != GL_WAIT_FAILED);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GlReadbackInterface::_doFetch(int slot_index, ReadbackResult& result) {
+  auto& slot = _packSlots[slot_index];
+  OrkAssert(result._bytes.size() == slot._length);
+  mTargetGL.makeCurrentContext();
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot._pbo);
+  auto mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot._length, GL_MAP_READ_BIT);
+  OrkAssert(mapped != nullptr);
+  memcpy(result._bytes.data(), mapped, slot._length);
+  glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  GL_ERRORCHECK();
+  glDeleteSync(slot._fence);
+  slot._fence = nullptr;
+}
+
+} // namespace ork::lev2
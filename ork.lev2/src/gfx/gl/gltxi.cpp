@@ -6,6 +6,7 @@
 ////////////////////////////////////////////////////////////////
 
 #include <ork/file/file.h>
+#include <ork/file/asyncread.h>
 #include <ork/gfx/dds.h>
 #include <ork/kernel/debug.h>
 #include <ork/kernel/opq.h>
@@ -198,7 +199,12 @@ bool GlTextureInterface::LoadTexture(const AssetPath& infname, texture_ptr_t pte
   // printf("infname<%s>\n", infname.c_str());
   // printf("final_fname<%s>\n", final_fname.c_str());
 
-  if (auto dblock = datablockFromFileAtPath(final_fname))
+  // xtx mip chains are large, read them with O_DIRECT
+  //  (batched with whatever other loads are in flight)
+  auto dblock = (final_fname == XtxFilename) //
+                    ? file::readFileBatched(final_fname)
+                    : datablockFromFileAtPath(final_fname);
+  if (dblock)
     return LoadTexture(ptex, dblock);
   else
     return false;
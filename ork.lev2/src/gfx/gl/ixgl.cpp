@@ -280,6 +280,7 @@ ContextGL::ContextGL()
     , mFbI(*this)
     , mTxI(*this)
     , mDWI(*this)
+    , mRbI(*this)
 #if defined(ENABLE_COMPUTE_SHADERS)
     , mCI(*this)
 #endif
@@ -295,11 +296,34 @@ ContextGL::~ContextGL() {
 
 /////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// GL_ARB_parallel_shader_compile (not in our glad profile, so resolved here)
+//  lets the driver compile and link on its own worker threads as long as
+//  we do not query status right after issuing.
+///////////////////////////////////////////////////////////////////////////////
+
+static bool _ixEnableParallelShaderCompile(){
+  bool has_ext = glfwExtensionSupported("GL_ARB_parallel_shader_compile") //
+              or glfwExtensionSupported("GL_KHR_parallel_shader_compile");
+  if(not has_ext)
+    return false;
+  using maxthreads_fn_t = void (*)(GLuint);
+  auto fn = (maxthreads_fn_t) glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+  if(nullptr == fn)
+    fn = (maxthreads_fn_t) glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+  if(fn)
+    fn(0xffffffff); // implementation chosen thread count
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////
+
 static void _ixDisableVIRGL(ContextGL* cgl){
     cgl->_SUPPORTS_BINARY_PIPELINE = false;
     cgl->_SUPPORTS_BUFFER_STORAGE = false;
     cgl->_SUPPORTS_PERSISTENT_MAP = false;
     cgl->_SUPPORTS_EXTERNAL_MEMORY_OBJECT = false;
+    cgl->_SUPPORTS_PARALLEL_SHADER_COMPILE = false;
     GfxEnv::disableBC7();
 }
 
@@ -331,6 +355,9 @@ void ContextGL::initializeWindowContext(Window* pWin, CTXBASE* pctxbase) {
   if(is_virgl or is_wsl or is_force){
     _ixDisableVIRGL(this);
   }
+  else{
+    _SUPPORTS_PARALLEL_SHADER_COMPILE = _ixEnableParallelShaderCompile();
+  }
 
 }
 
@@ -201,6 +201,7 @@ ContextGL::ContextGL()
 	, mTxI( *this )
 	, mMtxI( *this )
 	, mDWI(*this)
+	, mRbI(*this)
 	, mTargetDrawableSizeDirty(true)
 {
   ContextGL::GLinit();
@@ -0,0 +1,249 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/kernel/datablock.h>
+#include <ork/math/TransformNode.h>
+#include <ork/lev2/gfx/gfxenv.h>
+#include <ork/lev2/gfx/renderer/drawable.h>
+#include <ork/lev2/gfx/renderer/irendertarget.h>
+#include <ork/lev2/gfx/lighting/shadow_atlas.h>
+#include <algorithm>
+#include <unordered_set>
+
+namespace ork::lev2 {
+
+///////////////////////////////////////////////////////////////////////////////
+
+fvec4 ShadowAtlasTile::uvRect(int atlasdim) const {
+  float inv = 1.0f / float(atlasdim);
+  return fvec4(float(_x) * inv, float(_y) * inv, float(_size) * inv, float(_size) * inv);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ShadowAtlasLayout::ShadowAtlasLayout(int atlasdim, int mintile)
+    : _atlasDim(atlasdim)
+    , _minTile(mintile) {
+  OrkAssert(isPowerOfTwo(atlasdim) and isPowerOfTwo(mintile));
+  OrkAssert(mintile <= atlasdim / 2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int ShadowAtlasLayout::desiredSize(float screensize, int maxsize) const {
+  int cap = _minTile;
+  while (cap * 2 <= maxsize and cap * 2 <= _atlasDim / 2)
+    cap *= 2;
+  float texels = screensize * _texelsPerPixel;
+  int size     = _minTile;
+  while (size < cap and float(size) < texels)
+    size *= 2;
+  return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ShadowAtlasLayout::update(const std::vector<Request>& requests, uint64_t staticsignature) {
+  bool repack = false;
+
+  std::unordered_set<key_t> requested;
+  for (const auto& req : requests)
+    requested.insert(req._key);
+  for (auto it = _slots.begin(); it != _slots.end();) {
+    if (requested.count(it->first) == 0) {
+      it     = _slots.erase(it);
+      repack = true;
+    } else
+      ++it;
+  }
+
+  for (const auto& req : requests) {
+    int want = desiredSize(req._screenSize, req._maxSize);
+    int cap  = desiredSize(float(_atlasDim), req._maxSize);
+    auto it  = _slots.find(req._key);
+    if (it == _slots.end()) {
+      Slot slot;
+      slot._wantSize   = want;
+      slot._lightState = req._lightState;
+      _slots[req._key] = slot;
+      repack           = true;
+      continue;
+    }
+    auto& slot = it->second;
+    // grow right away, shrink only once 4x too big (coverage jitters with the camera)
+    int cur = slot._wantSize;
+    if (want > cur or want * 4 <= cur or cur > cap) {
+      slot._wantSize = want;
+      repack         = true;
+    }
+    if (slot._lightState != req._lightState) {
+      slot._lightState  = req._lightState;
+      slot._staticValid = false;
+    }
+  }
+
+  if (staticsignature != _staticSignature) {
+    _staticSignature = staticsignature;
+    for (auto& item : _slots)
+      item.second._staticValid = false;
+  }
+
+  if (repack) {
+    _pack();
+    _numRepacks++;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// largest first in morton order : every tile lands aligned to its own size
+//  and the tiles cover the atlas without gaps, so packing only fails when
+//  the area does. on overflow the biggest tiles are halved until it fits.
+///////////////////////////////////////////////////////////////////////////////
+
+void ShadowAtlasLayout::_pack() {
+
+  struct Entry {
+    key_t _key;
+    Slot* _slot;
+    int _size;
+  };
+  std::vector<Entry> entries;
+  int64_t area = 0;
+  for (auto& item : _slots) {
+    entries.push_back(Entry{item.first, &item.second, item.second._wantSize});
+    area += int64_t(item.second._wantSize) * int64_t(item.second._wantSize);
+  }
+  const int64_t capacity = int64_t(_atlasDim) * int64_t(_atlasDim);
+  while (area > capacity) {
+    Entry* biggest = nullptr;
+    for (auto& e : entries)
+      if (e._size > _minTile and (biggest == nullptr or e._size > biggest->_size))
+        biggest = &e;
+    OrkAssert(biggest != nullptr); // more lights than min tiles
+    area -= int64_t(biggest->_size) * int64_t(biggest->_size) * 3 / 4;
+    biggest->_size /= 2;
+  }
+
+  // ties keep their previous order, so unchanged lights tend to stay put
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    if (a._size != b._size)
+      return a._size > b._size;
+    const auto& ta = a._slot->_tile;
+    const auto& tb = b._slot->_tile;
+    if (ta._size != tb._size)
+      return ta._size > tb._size;
+    if (ta._y != tb._y)
+      return ta._y < tb._y;
+    if (ta._x != tb._x)
+      return ta._x < tb._x;
+    return a._key < b._key;
+  });
+
+  auto deinterleave = [](uint32_t m) -> uint32_t {
+    m &= 0x55555555u;
+    m = (m | (m >> 1)) & 0x33333333u;
+    m = (m | (m >> 2)) & 0x0f0f0f0fu;
+    m = (m | (m >> 4)) & 0x00ff00ffu;
+    m = (m | (m >> 8)) & 0x0000ffffu;
+    return m;
+  };
+
+  uint32_t cursor = 0; // in min tiles, morton order
+  for (auto& e : entries) {
+    uint32_t span  = uint32_t(e._size / _minTile);
+    ShadowAtlasTile tile;
+    tile._x        = int(deinterleave(cursor)) * _minTile;
+    tile._y        = int(deinterleave(cursor >> 1)) * _minTile;
+    tile._size     = e._size;
+    cursor += span * span;
+    if (not(tile == e._slot->_tile))
+      e._slot->_staticValid = false;
+    e._slot->_tile = tile;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const ShadowAtlasLayout::Slot* ShadowAtlasLayout::slot(key_t key) const {
+  auto it = _slots.find(key);
+  return (it == _slots.end()) ? nullptr : &it->second;
+}
+
+bool ShadowAtlasLayout::needsStaticRender(key_t key) const {
+  auto s = slot(key);
+  return s and not s->_staticValid;
+}
+
+void ShadowAtlasLayout::markStaticRendered(key_t key) {
+  auto it = _slots.find(key);
+  OrkAssert(it != _slots.end());
+  it->second._staticValid = true;
+  _numStaticRenders++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ShadowAtlas::ShadowAtlas(int atlasdim, int mintile)
+    : _layout(atlasdim, mintile) {
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ShadowAtlas::gpuInit(Context* ctx) {
+  if (_staticRTG)
+    return;
+  int dim                 = _layout._atlasDim;
+  _staticRTG              = std::make_shared<RtGroup>(ctx, dim, dim);
+  _staticRTG->_depthOnly  = true;
+  _staticRTG->_autoclear  = false; // tiles are cleared one by one
+  _staticRTG->_name       = "ShadowAtlasStatic";
+  _dynamicRTG             = std::make_shared<RtGroup>(ctx, dim, dim);
+  _dynamicRTG->_depthOnly = true;
+  _dynamicRTG->_autoclear = false;
+  _dynamicRTG->_name      = "ShadowAtlasDynamic";
+  _staticIRT              = std::make_shared<RtGroupRenderTarget>(_staticRTG.get());
+  _dynamicIRT             = std::make_shared<RtGroupRenderTarget>(_dynamicRTG.get());
+  ctx->FBI()->validateRtGroup(_staticRTG);
+  ctx->FBI()->validateRtGroup(_dynamicRTG);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t ShadowAtlas::staticCasterSignature(
+    const DrawQueue* DB, //
+    const std::vector<std::string>& layers,
+    size_t& numdynamic) {
+  numdynamic  = 0;
+  bool do_all = std::find(layers.begin(), layers.end(), "All") != layers.end();
+  auto hasher = DataBlock::createHasher();
+  hasher->accumulateString("shadow-static-casters");
+  for (const auto& layer_item : DB->mLayerLut) {
+    if (not do_all and std::find(layers.begin(), layers.end(), layer_item.first) == layers.end())
+      continue;
+    const DrawQueueLayer* player = layer_item.second;
+    player->_items.atomicOp([&](const DrawQueueLayer::itemvect_t& unlocked) {
+      int max_index = player->_itemIndex;
+      for (int id = 0; id < max_index; id++) {
+        auto item = unlocked[id];
+        auto pdrw = item->_drawable;
+        if (nullptr == pdrw)
+          continue;
+        if (not pdrw->_staticShadowCaster) {
+          numdynamic++;
+          continue;
+        }
+        hasher->accumulateItem<const void*>(pdrw);
+        hasher->accumulateItem<fmtx4>(item->_dqxferdata._worldTransform->composed());
+      }
+    });
+  }
+  hasher->finish();
+  return hasher->result();
+}
+
+} // namespace ork::lev2
@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/kernel/opq.h>
+#include <ork/kernel/datacache.h>
+#include <ork/kernel/tempstring.h>
+#include <ork/lev2/gfx/gfxenv.h>
+#include <ork/lev2/gfx/material_pbr.inl>
+#include <ork/lev2/gfx/material_freestyle.h>
+#include <ork/lev2/gfx/rtgroup.h>
+#include <ork/lev2/gfx/image.h>
+#include <ork/util/logger.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// cpu prefiltered environment maps (see ork/gfx/envprefilter.h)
+//
+//  the source is read back from the gpu once, then prefiltered and
+//  compressed on the opq concurrent queue. the specular chain, the diffuse
+//  chain and the SH9 coefficients go into one cached bundle :
+//
+//   u32 magic ("envp"), u32 version
+//   fvec3 sh9[9]
+//   u64 length, specular XTX bytes
+//   u64 length, diffuse XTX bytes
+//
+//  the cache key only depends on the source file's content hash, so
+//   ork.envbake.exe can fill the cache offline.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::lev2 {
+
+static logchannel_ptr_t logchan_envpref = logger()->createChannel("ENVPREFILTER", fvec3(0.8, 0.8, 0.5), true);
+
+static constexpr uint32_t kENVBUNDLEVERSION = 1;
+
+static envprefilter::Params _prefilterParams(bool equirectangular) {
+  envprefilter::Params params;
+  // equirectangular sources are read with env_equirectangularN2UV (pole on z),
+  //  and the diffuse map is faced like tek_filterDiffuseMapEquirectangular's
+  params._sourceZPole   = equirectangular;
+  params._diffuseFlipYZ = equirectangular;
+  return params;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t PBRMaterial::envPrefilterCacheKey(uint64_t contenthash, bool equirectangular) {
+  auto params = _prefilterParams(equirectangular);
+  auto hasher = DataBlock::createHasher();
+  hasher->accumulateString("envprefilter-bundle");
+  hasher->accumulateItem<uint32_t>(kENVBUNDLEVERSION);
+  hasher->accumulateItem<uint32_t>(uint32_t(equirectangular));
+  hasher->accumulateItem<int>(params._specularSamples);
+  hasher->accumulateItem<int>(params._diffuseWidth);
+  hasher->accumulateItem<uint64_t>(contenthash);
+  hasher->finish();
+  return hasher->result();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void _appendMipChain(
+    const std::vector<envprefilter::EnvImage>& levels, //
+    datablock_ptr_t bundle) {
+
+  std::vector<compressedimg_ptr_t> cimgs;
+  auto group = opq::createCompletionGroup(opq::concurrentQueue(), "ENVCOMPRESS");
+  for (const auto& level : levels) {
+    auto cimg = std::make_shared<CompressedImage>();
+    cimgs.push_back(cimg);
+    group->enqueue([&level, cimg]() {
+      // clamp : the 8 bit conversion would wrap hdr values
+      std::vector<float> clamped(level._texels.size() * 4);
+      for (size_t i = 0; i < level._texels.size(); i++) {
+        const auto& t      = level._texels[i];
+        clamped[i * 4 + 0] = std::clamp(t.x, 0.0f, 1.0f);
+        clamped[i * 4 + 1] = std::clamp(t.y, 0.0f, 1.0f);
+        clamped[i * 4 + 2] = std::clamp(t.z, 0.0f, 1.0f);
+        clamped[i * 4 + 3] = 1.0f;
+      }
+      Image im;
+      im.initRGBA8WithNormalizedFloatBuffer(level._width, level._height, 4, clamped.data());
+      im.compressDefault(*cimg);
+    });
+  }
+  group->join();
+
+  CompressedImageMipChain::miplevels_t compressed_levels;
+  for (auto cimg : cimgs)
+    compressed_levels.push_back(*cimg);
+  CompressedImageMipChain mipchain;
+  mipchain.initWithPrecompressedMipLevels(compressed_levels);
+  auto xtx = std::make_shared<DataBlock>();
+  mipchain.writeXTX(xtx);
+  bundle->addItem<uint64_t>(uint64_t(xtx->length()));
+  bundle->addData(xtx->data(), xtx->length());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+datablock_ptr_t PBRMaterial::bakeEnvPrefilterBundle(const envprefilter::EnvImage& src, bool equirectangular) {
+  auto result = envprefilter::prefilter(src, _prefilterParams(equirectangular));
+  auto bundle = std::make_shared<DataBlock>();
+  bundle->addItem<uint32_t>(Char4("envp").GetU32());
+  bundle->addItem<uint32_t>(kENVBUNDLEVERSION);
+  for (int i = 0; i < 9; i++)
+    bundle->addItem<fvec3>(result._sh9[i]);
+  _appendMipChain(result._specularLevels, bundle);
+  _appendMipChain(result._diffuseLevels, bundle);
+  return bundle;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static datablock_ptr_t _readSubBlock(DataBlockInputStream& stream) {
+  size_t length = size_t(stream.getItem<uint64_t>());
+  OrkAssert(stream._cursor + length <= stream.length());
+  auto rval = std::make_shared<DataBlock>(stream.current(), length);
+  stream.advance(length);
+  return rval;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// rawenvmap as float rgba texels (row 0 is v=0)
+///////////////////////////////////////////////////////////////////////////////
+
+static envprefilter::EnvImage _readbackEnvMap(texture_ptr_t rawenvmap, Context* targ) {
+  auto fbi = targ->FBI();
+  auto dwi = targ->DWI();
+  int w    = rawenvmap->_width;
+  int h    = rawenvmap->_height;
+  ///////////////////////////////////////////////
+  static std::shared_ptr<FreestyleMaterial> mtl;
+  static const FxShaderTechnique* tek_copy = nullptr;
+  static const FxShaderParam* param_mvp    = nullptr;
+  static const FxShaderParam* param_pfm    = nullptr;
+  static const FxShaderParam* param_imgdim = nullptr;
+  if (not mtl) {
+    mtl = std::make_shared<FreestyleMaterial>();
+    mtl->gpuInit(targ, file::Path("orkshader://pbr_filterenv.glfx"));
+    tek_copy     = mtl->technique("tek_copyEnvMap");
+    param_mvp    = mtl->param("mvp");
+    param_pfm    = mtl->param("prefiltmap");
+    param_imgdim = mtl->param("imgdim");
+    OrkAssert(tek_copy != nullptr);
+  }
+  ///////////////////////////////////////////////
+  auto RCFD            = std::make_shared<RenderContextFrameData>(targ);
+  auto outgroup        = std::make_shared<RtGroup>(targ, w, h, MsaaSamples::MSAA_1X);
+  auto outbuffr        = outgroup->createRenderTarget(EBufferFormat::RGBA32F);
+  auto captureb        = std::make_shared<CaptureBuffer>();
+  outgroup->_autoclear = true;
+  outbuffr->_debugName = "envprefilter-source";
+  fbi->PushRtGroup(outgroup.get());
+  mtl->begin(tek_copy, RCFD);
+  mtl->bindParamMatrix(param_mvp, fmtx4::Identity());
+  mtl->bindParamCTex(param_pfm, rawenvmap.get());
+  mtl->bindParamVec2(param_imgdim, fvec2(w, h));
+  mtl->commit();
+  dwi->quad2DEML(fvec4(-1, -1, 2, 2), fvec4(0, 0, 1, 1), fvec4(0, 0, 0, 0));
+  mtl->end(RCFD);
+  fbi->PopRtGroup();
+  fbi->capture(outbuffr.get(), captureb.get());
+  ///////////////////////////////////////////////
+  envprefilter::EnvImage rval(w, h);
+  auto texels = (const fvec4*)captureb->_data;
+  std::copy(texels, texels + size_t(w) * size_t(h), rval._texels.begin());
+  return rval;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+PrefilteredEnvMaps PBRMaterial::prefilterEnvMap(texture_ptr_t rawenvmap, Context* targ, bool equirectangular) {
+  targ->makeCurrentContext();
+  targ->debugPushGroup("PBRMaterial::prefilterEnvMap");
+  uint64_t cachekey = envPrefilterCacheKey(rawenvmap->_contentHash, equirectangular);
+  auto bundle       = DataBlockCache::findDataBlock(cachekey);
+  logchan_envpref->log(
+      "tex<%p> hash<0x%zx> w<%d> h<%d> equirectangular<%d> cached<%d>",
+      (void*)rawenvmap.get(),
+      rawenvmap->_contentHash,
+      rawenvmap->_width,
+      rawenvmap->_height,
+      int(equirectangular),
+      int(bundle != nullptr));
+  if (not bundle) {
+    auto source = _readbackEnvMap(rawenvmap, targ);
+    bundle      = bakeEnvPrefilterBundle(source, equirectangular);
+    DataBlockCache::setDataBlock(cachekey, bundle);
+  }
+  ///////////////////////////////////////////////
+  DataBlockInputStream stream(bundle);
+  uint32_t magic   = stream.getItem<uint32_t>();
+  uint32_t version = stream.getItem<uint32_t>();
+  OrkAssert(magic == Char4("envp").GetU32());
+  OrkAssert(version == kENVBUNDLEVERSION);
+  PrefilteredEnvMaps rval;
+  for (int i = 0; i < 9; i++)
+    rval._sh9[i] = stream.getItem<fvec3>();
+  auto specxtx = _readSubBlock(stream);
+  auto diffxtx = _readSubBlock(stream);
+  ///////////////////////////////////////////////
+  auto txi                      = targ->TXI();
+  rval._specularMap             = std::make_shared<Texture>();
+  rval._specularMap->_debugName = rawenvmap->_debugName + "[filtenvmap-processed-specular]";
+  txi->LoadTexture(rval._specularMap, specxtx);
+  rval._diffuseMap             = std::make_shared<Texture>();
+  rval._diffuseMap->_debugName = rawenvmap->_debugName + "[filtenvmap-processed-diffuse]";
+  txi->LoadTexture(rval._diffuseMap, diffxtx);
+  rawenvmap->_vars->makeValueForKey<texture_ptr_t>("alt-tex-specenv") = rval._specularMap;
+  targ->debugPopGroup();
+  return rval;
+}
+
+} // namespace ork::lev2
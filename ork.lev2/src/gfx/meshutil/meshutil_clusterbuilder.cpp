@@ -55,6 +55,49 @@ void XgmClusterBuilder::Dump(void) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+size_t XgmClusterBuilder::numOutputVertices() const {
+  return _outputOrder.empty() ? size_t(_submesh.numVertices()) : _outputOrder.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const vertex& XgmClusterBuilder::outputVertex(int iv) const {
+  return _outputOrder.empty() ? *_submesh.vertex(iv) : *_submesh.vertex(int(_outputOrder[iv]));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void XgmClusterBuilder::optimize() {
+  _outputOrder.clear();
+  _outputIndices.clear();
+
+  std::vector<int> ToolMeshTriangles;
+  _submesh.FindNSidedPolys(ToolMeshTriangles, 3);
+  if (ToolMeshTriangles.empty())
+    return;
+
+  size_t numverts = _submesh.numVertices();
+  index_vect_t indices;
+  indices.reserve(ToolMeshTriangles.size() * 3);
+  for (int itri : ToolMeshTriangles) {
+    const auto& tri = _submesh.RefPoly(itri);
+    for (int k = 0; k < 3; k++)
+      indices.push_back(uint32_t(tri.vertexID(k)));
+  }
+  std::vector<fvec3> positions(numverts);
+  for (size_t iv = 0; iv < numverts; iv++)
+    positions[iv] = dvec3_to_fvec3(_submesh.vertex(int(iv))->mPos);
+
+  _preOptimizeStats = analyzeVertexCache(indices, numverts);
+  optimizeVertexCache(indices, numverts);
+  optimizeOverdraw(indices, positions);
+  size_t numout      = optimizeVertexFetch(indices, _outputOrder, numverts);
+  _postOptimizeStats = analyzeVertexCache(indices, numout);
+  _outputIndices     = std::move(indices);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void BuildXgmClusterPrimGroups(
     lev2::Context& context,
     lev2::xgmcluster_ptr_t xgm_cluster,
@@ -198,26 +241,46 @@ void buildXgmCluster( lev2::Context& context,
   // triangle indices come from the ClusterBuilder
 
   std::vector<unsigned int> TriangleIndices;
-  std::vector<int> ToolMeshTriangles;
 
-  clusterbuilder->_submesh.FindNSidedPolys(ToolMeshTriangles, 3);
+  if (clusterbuilder->isOptimized()) {
+    // already in output vertex space
+    const auto& optimized = clusterbuilder->_outputIndices;
+    TriangleIndices.assign(optimized.begin(), optimized.end());
+    // stripping would throw away the optimized order
+    enable_tristrips = false;
+  } else {
+    std::vector<int> ToolMeshTriangles;
 
-  int inumtriangles = int(ToolMeshTriangles.size());
+    clusterbuilder->_submesh.FindNSidedPolys(ToolMeshTriangles, 3);
 
-  for (int i = 0; i < inumtriangles; i++) {
-    int itri_i = ToolMeshTriangles[i];
+    int inumtriangles = int(ToolMeshTriangles.size());
 
-    const ork::meshutil::Polygon& ClusTri = clusterbuilder->_submesh.RefPoly(itri_i);
+    for (int i = 0; i < inumtriangles; i++) {
+      int itri_i = ToolMeshTriangles[i];
 
-    TriangleIndices.push_back(ClusTri.vertexID(0));
-    TriangleIndices.push_back(ClusTri.vertexID(1));
-    TriangleIndices.push_back(ClusTri.vertexID(2));
+      const ork::meshutil::Polygon& ClusTri = clusterbuilder->_submesh.RefPoly(itri_i);
+
+      TriangleIndices.push_back(ClusTri.vertexID(0));
+      TriangleIndices.push_back(ClusTri.vertexID(1));
+      TriangleIndices.push_back(ClusTri.vertexID(2));
+    }
   }
 
   /////////////////////////////////////////////////////////////
 
   BuildXgmClusterPrimGroups(context, xgm_cluster, TriangleIndices,enable_tristrips);
 
+  /////////////////////////////////////////////////////////////
+  // meshlets (optimized clusters only, they rely on the index order)
+
+  if (clusterbuilder->isOptimized()) {
+    size_t numout = clusterbuilder->numOutputVertices();
+    std::vector<fvec3> positions(numout);
+    for (size_t iv = 0; iv < numout; iv++)
+      positions[iv] = dvec3_to_fvec3(clusterbuilder->outputVertex(int(iv)).mPos);
+    xgm_cluster->_meshlets = buildMeshlets(clusterbuilder->_outputIndices, positions);
+  }
+
   xgm_cluster->mBoundingBox    = clusterbuilder->_submesh.aabox();
   xgm_cluster->mBoundingSphere = Sphere(xgm_cluster->mBoundingBox.Min(), xgm_cluster->mBoundingBox.Max());
 
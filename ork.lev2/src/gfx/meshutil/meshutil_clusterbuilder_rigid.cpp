@@ -11,6 +11,7 @@
 #include <ork/lev2/gfx/meshutil/meshutil_stripper.h>
 #include <ork/lev2/gfx/meshutil/meshutil_fixedgrid.h>
 #include <ork/lev2/gfx/gfxvtxbuf.inl>
+#include <ork/lev2/gfx/gfxvtxquant.h>
 
 const bool gbFORCEDICE = true;
 const int kDICESIZE    = 512;
@@ -52,15 +53,15 @@ bool XgmRigidClusterBuilder::addTriangle(const XgmClusterTri& Triangle) {
 template <typename vtx_t>
 lev2::vtxbufferbase_ptr_t buildTypedVertexBuffer(
     lev2::Context& context,
-    const meshutil::submesh& inp_submesh,
+    const XgmClusterBuilder& builder,
     std::function<vtx_t(const meshutil::vertex&)> genOutVertex) {
   using vtxbuf_t       = lev2::StaticVertexBuffer<vtx_t>;
-  int NumVertexIndices = inp_submesh.numVertices();
+  int NumVertexIndices = int(builder.numOutputVertices());
   auto out_vbuf        = std::make_shared<vtxbuf_t>(NumVertexIndices, 0);
   lev2::VtxWriter<vtx_t> vwriter;
   vwriter.Lock(&context, out_vbuf.get(), NumVertexIndices);
   for (int iv = 0; iv < NumVertexIndices; iv++)
-    vwriter.AddVertex(genOutVertex(*inp_submesh.vertex(iv)));
+    vwriter.AddVertex(genOutVertex(builder.outputVertex(iv)));
   vwriter.UnLock(&context);
   out_vbuf->SetNumVertices(NumVertexIndices);
   return std::static_pointer_cast<lev2::VertexBufferBase>(out_vbuf);
@@ -72,14 +73,14 @@ void XgmRigidClusterBuilder::buildVertexBuffer(lev2::Context& context, lev2::EVt
   switch (format) {
     ////////////////////////////////////////////////////////////////////////////
     case lev2::EVtxStreamFormat::V12: {
-      _vertexBuffer = buildTypedVertexBuffer<lev2::VtxV12>(context, _submesh, [](const meshutil::vertex& inpvtx) {
+      _vertexBuffer = buildTypedVertexBuffer<lev2::VtxV12>(context, *this, [](const meshutil::vertex& inpvtx) {
         return lev2::VtxV12( inpvtx.mPos.x, inpvtx.mPos.y, inpvtx.mPos.z );
       });
       break;
     }
     ////////////////////////////////////////////////////////////////////////////
     case lev2::EVtxStreamFormat::V12T8: {
-      _vertexBuffer = buildTypedVertexBuffer<lev2::VtxV12T8>(context, _submesh, [](const meshutil::vertex& inpvtx) {
+      _vertexBuffer = buildTypedVertexBuffer<lev2::VtxV12T8>(context, *this, [](const meshutil::vertex& inpvtx) {
         const auto& POS = inpvtx.mPos;
         const auto& UV0 = inpvtx.mUV[0].mMapTexCoord;
         return lev2::VtxV12T8( POS.x, POS.y, POS.z, 
@@ -89,7 +90,7 @@ void XgmRigidClusterBuilder::buildVertexBuffer(lev2::Context& context, lev2::EVt
     }
     ////////////////////////////////////////////////////////////////////////////
     case lev2::EVtxStreamFormat::V12C4T16: {
-      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12C4T16>(context, _submesh, [](const meshutil::vertex& inpvtx) {
+      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12C4T16>(context, *this, [](const meshutil::vertex& inpvtx) {
         lev2::SVtxV12C4T16 out_vtx;
         const auto& pos     = inpvtx.mPos;
         out_vtx._position = fvec3(pos.x, pos.y, pos.z);
@@ -101,7 +102,7 @@ void XgmRigidClusterBuilder::buildVertexBuffer(lev2::Context& context, lev2::EVt
     }
     ////////////////////////////////////////////////////////////////////////////
     case lev2::EVtxStreamFormat::V12N6C2T4: {
-      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N6C2T4>(context, _submesh, [](const meshutil::vertex& inpvtx) {
+      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N6C2T4>(context, *this, [](const meshutil::vertex& inpvtx) {
         lev2::SVtxV12N6C2T4 out_vtx;
         out_vtx.mX = inpvtx.mPos.x;
         out_vtx.mY = inpvtx.mPos.y;
@@ -125,7 +126,7 @@ void XgmRigidClusterBuilder::buildVertexBuffer(lev2::Context& context, lev2::EVt
     }
     ////////////////////////////////////////////////////////////////////////////
     case lev2::EVtxStreamFormat::V12N12T16C4: {
-      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N12T16C4>(context, _submesh, [](const meshutil::vertex& inpvtx) {
+      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N12T16C4>(context, *this, [](const meshutil::vertex& inpvtx) {
         lev2::SVtxV12N12T16C4 out_vtx;
         const auto& pos     = inpvtx.mPos;
         const auto& nrm     = inpvtx.mNrm;
@@ -140,7 +141,7 @@ void XgmRigidClusterBuilder::buildVertexBuffer(lev2::Context& context, lev2::EVt
     }
     ////////////////////////////////////////////////////////////////////////////
     case lev2::EVtxStreamFormat::V12N12B12T8C4: {
-      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N12B12T8C4>(context, _submesh, [](const meshutil::vertex& inpvtx) {
+      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N12B12T8C4>(context, *this, [](const meshutil::vertex& inpvtx) {
         lev2::SVtxV12N12B12T8C4 out_vtx;
         const auto& pos     = inpvtx.mPos;
         const auto& nrm     = inpvtx.mNrm;
@@ -155,7 +156,7 @@ void XgmRigidClusterBuilder::buildVertexBuffer(lev2::Context& context, lev2::EVt
     }
     ////////////////////////////////////////////////////////////////////////////
     case lev2::EVtxStreamFormat::V12N12B12T16: {
-      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N12B12T16>(context, _submesh, [](const meshutil::vertex& inpvtx) {
+      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N12B12T16>(context, *this, [](const meshutil::vertex& inpvtx) {
         lev2::SVtxV12N12B12T16 out_vtx;
         const auto& pos     = inpvtx.mPos;
         const auto& nrm     = inpvtx.mNrm;
@@ -169,8 +170,31 @@ void XgmRigidClusterBuilder::buildVertexBuffer(lev2::Context& context, lev2::EVt
       break;
     }
     ////////////////////////////////////////////////////////////////////////////
+    case lev2::EVtxStreamFormat::V8N4B4T8: {
+      // positions are relative to the same box the xgm writer stores per cluster
+      const auto& bbox = _submesh.aabox();
+      lev2::vtxquant::PositionQuantizer quantizer(bbox.Min(), bbox.Max());
+      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV8N4B4T8>(context, *this, [&quantizer](const meshutil::vertex& inpvtx) {
+        using namespace lev2::vtxquant;
+        lev2::SVtxV8N4B4T8 out_vtx;
+        const auto& pos = inpvtx.mPos;
+        const auto& nrm = inpvtx.mNrm;
+        const auto& uv0 = inpvtx.mUV[0].mMapTexCoord;
+        const auto& uv1 = inpvtx.mUV[1].mMapTexCoord;
+        quantizer.encode(fvec3(pos.x, pos.y, pos.z), out_vtx.mPosition);
+        octEncode(fvec3(nrm.x, nrm.y, nrm.z), out_vtx.mNormal[0], out_vtx.mNormal[1]);
+        octEncode(inpvtx.mUV[0].mMapBiNormal, out_vtx.mBiNormal[0], out_vtx.mBiNormal[1]);
+        out_vtx.mUV0[0] = floatToHalf(uv0.x);
+        out_vtx.mUV0[1] = floatToHalf(uv0.y);
+        out_vtx.mUV1[0] = floatToHalf(uv1.x);
+        out_vtx.mUV1[1] = floatToHalf(uv1.y);
+        return out_vtx;
+      });
+      break;
+    }
+    ////////////////////////////////////////////////////////////////////////////
     case lev2::EVtxStreamFormat::V12N12T16: {
-      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N12T16>(context, _submesh, [](const meshutil::vertex& inpvtx) {
+      _vertexBuffer = buildTypedVertexBuffer<lev2::SVtxV12N12T16>(context, *this, [](const meshutil::vertex& inpvtx) {
         lev2::SVtxV12N12T16 out_vtx;
         const auto& pos     = inpvtx.mPos;
         const auto& nrm     = inpvtx.mNrm;
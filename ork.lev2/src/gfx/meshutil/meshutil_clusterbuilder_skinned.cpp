@@ -12,6 +12,7 @@
 #include <ork/lev2/gfx/meshutil/meshutil_fixedgrid.h>
 #include <ork/util/logger.h>
 #include <ork/lev2/gfx/gfxvtxbuf.inl>
+#include <ork/lev2/gfx/gfxvtxquant.h>
 
 const bool gbFORCEDICE = true;
 const int kDICESIZE    = 512;
@@ -112,6 +113,11 @@ void XgmSkinnedClusterBuilder::buildVertexBuffer(lev2::Context& context, lev2::E
       BuildVertexBuffer_V12N12B12T8I4W4(context);
       break;
     }
+    case lev2::EVtxStreamFormat::V8N4B4T4I4W4: // PC quantized skinned format
+    {
+      BuildVertexBuffer_V8N4B4T4I4W4(context);
+      break;
+    }
     case lev2::EVtxStreamFormat::V12N6I1T4: // WII skinned format
     {
       BuildVertexBuffer_V12N6I1T4(context);
@@ -133,75 +139,116 @@ void XgmSkinnedClusterBuilder::BuildVertexBuffer_V12N12B12T8I4W4(lev2::Context&
   lev2::VtxWriter<vtx_t> vwriter;
   const double kVertexScale(1.0f);
   const fvec2 UVScale(1.0f, 1.0f);
-  int NumVertexIndices = _submesh.numVertices();
+  int NumVertexIndices = int(numOutputVertices());
   _vertexBuffer        = std::make_shared<vtxbuf_t>(NumVertexIndices, 0);
   vwriter.Lock(&context, _vertexBuffer.get(), NumVertexIndices);
 
   for (int iv = 0; iv < NumVertexIndices; iv++) {
     vtx_t OutVtx;
-    auto InVtx = *_submesh.vertex(iv);
+    auto InVtx = outputVertex(iv);
     const auto pos     = InVtx.mPos * kVertexScale;
     const auto nrm     = InVtx.mNrm;
     OutVtx.mPosition              = fvec3(pos.x, pos.y, pos.z);
     OutVtx.mNormal                = fvec3(nrm.x, nrm.y, nrm.z);
     OutVtx.mUV0                   = InVtx.mUV[0].mMapTexCoord * UVScale;
     OutVtx.mBiNormal              = InVtx.mUV[0].mMapBiNormal;
+    packJointInfluences(InVtx, OutVtx.mBoneIndices, OutVtx.mBoneWeights);
 
-    const std::string& jn0 = InVtx._jointpaths[0];
-    const std::string& jn1 = InVtx._jointpaths[1];
-    const std::string& jn2 = InVtx._jointpaths[2];
-    const std::string& jn3 = InVtx._jointpaths[3];
-
-    int index0 = findNewJointIndex(jn0);
-    int index1 = findNewJointIndex(jn1);
-    int index2 = findNewJointIndex(jn2);
-    int index3 = findNewJointIndex(jn3);
+    vwriter.AddVertex(OutVtx);
+  }
+  vwriter.UnLock(&context);
+  _vertexBuffer->SetNumVertices(NumVertexIndices);
+}
 
-    index0 = (index0 == -1) ? 0 : index0;
-    index1 = (index1 == -1) ? 0 : index1;
-    index2 = (index2 == -1) ? 0 : index2;
-    index3 = (index3 == -1) ? 0 : index3;
+///////////////////////////////////////////////////////////////////////////////
+// 4 influences -> 4 x u8 joint registers + 4 x unorm8 weights (summing to 255)
+///////////////////////////////////////////////////////////////////////////////
 
-    int W0 = round(InVtx.mJointWeights[0] * 256.0f);
-    int W1 = round(InVtx.mJointWeights[1] * 256.0f);
-    int W2 = round(InVtx.mJointWeights[2] * 256.0f);
-    int W3 = round(InVtx.mJointWeights[3] * 256.0f);
-
-    // printf("W0<%f>\n", InVtx.mJointWeights[0]);
-    // printf("W1<%f>\n", InVtx.mJointWeights[1]);
-    // printf("W2<%f>\n", InVtx.mJointWeights[2]);
-    // printf("W3<%f>\n", InVtx.mJointWeights[3]);
-
-    typedef std::pair<int, int> intpair_t;
-    std::vector<intpair_t> wvec;
-    wvec.push_back(std::make_pair(W0, index0));
-    wvec.push_back(std::make_pair(W1, index1));
-    wvec.push_back(std::make_pair(W2, index2));
-    wvec.push_back(std::make_pair(W3, index3));
-
-    int points_remaining = 255;
-    int sequence         = 0;
-    for (auto item : wvec) {
-      int w     = item.first;
-      int index = item.second;
-      // printf("seq<%d> w<%d>\n", sequence, w);
-      if (w) {
-        if (w > points_remaining) {
-          w = points_remaining;
-        }
-        if ((points_remaining - w) >= 0) {
-          int shift = sequence * 8;
-          OutVtx.mBoneIndices |= (index << shift);
-          OutVtx.mBoneWeights |= (w << shift);
-          points_remaining -= w;
-        }
+void XgmSkinnedClusterBuilder::packJointInfluences(const vertex& inpvtx, U32& out_indices, U32& out_weights) {
+  out_indices = 0;
+  out_weights = 0;
+
+  const std::string& jn0 = inpvtx._jointpaths[0];
+  const std::string& jn1 = inpvtx._jointpaths[1];
+  const std::string& jn2 = inpvtx._jointpaths[2];
+  const std::string& jn3 = inpvtx._jointpaths[3];
+
+  int index0 = findNewJointIndex(jn0);
+  int index1 = findNewJointIndex(jn1);
+  int index2 = findNewJointIndex(jn2);
+  int index3 = findNewJointIndex(jn3);
+
+  index0 = (index0 == -1) ? 0 : index0;
+  index1 = (index1 == -1) ? 0 : index1;
+  index2 = (index2 == -1) ? 0 : index2;
+  index3 = (index3 == -1) ? 0 : index3;
+
+  int W0 = round(inpvtx.mJointWeights[0] * 256.0f);
+  int W1 = round(inpvtx.mJointWeights[1] * 256.0f);
+  int W2 = round(inpvtx.mJointWeights[2] * 256.0f);
+  int W3 = round(inpvtx.mJointWeights[3] * 256.0f);
+
+  // printf("W0<%f>\n", inpvtx.mJointWeights[0]);
+  // printf("W1<%f>\n", inpvtx.mJointWeights[1]);
+  // printf("W2<%f>\n", inpvtx.mJointWeights[2]);
+  // printf("W3<%f>\n", inpvtx.mJointWeights[3]);
+
+  typedef std::pair<int, int> intpair_t;
+  std::vector<intpair_t> wvec;
+  wvec.push_back(std::make_pair(W0, index0));
+  wvec.push_back(std::make_pair(W1, index1));
+  wvec.push_back(std::make_pair(W2, index2));
+  wvec.push_back(std::make_pair(W3, index3));
+
+  int points_remaining = 255;
+  int sequence         = 0;
+  for (auto item : wvec) {
+    int w     = item.first;
+    int index = item.second;
+    // printf("seq<%d> w<%d>\n", sequence, w);
+    if (w) {
+      if (w > points_remaining) {
+        w = points_remaining;
+      }
+      if ((points_remaining - w) >= 0) {
+        int shift = sequence * 8;
+        out_indices |= (index << shift);
+        out_weights |= (w << shift);
+        points_remaining -= w;
       }
-      sequence++;
-    }
-    if(points_remaining > 0){
-      logerrchannel()->log(" skinned cluster points_remaining<%d> (check numweights < 4)\n", points_remaining);
     }
+    sequence++;
+  }
+  if(points_remaining > 0){
+    logerrchannel()->log(" skinned cluster points_remaining<%d> (check numweights < 4)\n", points_remaining);
+  }
+}
 
+///////////////////////////////////////////////////////////////////////////////
+
+void XgmSkinnedClusterBuilder::BuildVertexBuffer_V8N4B4T4I4W4(lev2::Context& context) // quantized pc skinned
+{
+  using vtx_t    = lev2::SVtxV8N4B4T4I4W4;
+  using vtxbuf_t = lev2::StaticVertexBuffer<vtx_t>;
+  const auto& bbox = _submesh.aabox();
+  lev2::vtxquant::PositionQuantizer quantizer(bbox.Min(), bbox.Max());
+  lev2::VtxWriter<vtx_t> vwriter;
+  int NumVertexIndices = int(numOutputVertices());
+  _vertexBuffer        = std::make_shared<vtxbuf_t>(NumVertexIndices, 0);
+  vwriter.Lock(&context, _vertexBuffer.get(), NumVertexIndices);
+
+  for (int iv = 0; iv < NumVertexIndices; iv++) {
+    vtx_t OutVtx;
+    auto InVtx     = outputVertex(iv);
+    const auto pos = InVtx.mPos;
+    const auto nrm = InVtx.mNrm;
+    const auto& uv = InVtx.mUV[0].mMapTexCoord;
+    quantizer.encode(fvec3(pos.x, pos.y, pos.z), OutVtx.mPosition);
+    lev2::vtxquant::octEncode(fvec3(nrm.x, nrm.y, nrm.z), OutVtx.mNormal[0], OutVtx.mNormal[1]);
+    lev2::vtxquant::octEncode(InVtx.mUV[0].mMapBiNormal, OutVtx.mBiNormal[0], OutVtx.mBiNormal[1]);
+    OutVtx.mUV0[0] = lev2::vtxquant::floatToHalf(uv.x);
+    OutVtx.mUV0[1] = lev2::vtxquant::floatToHalf(uv.y);
+    packJointInfluences(InVtx, OutVtx.mBoneIndices, OutVtx.mBoneWeights);
     vwriter.AddVertex(OutVtx);
   }
   vwriter.UnLock(&context);
@@ -217,13 +264,13 @@ void XgmSkinnedClusterBuilder::BuildVertexBuffer_V12N12T8I4W4(lev2::Context& con
   lev2::VtxWriter<vtx_t> vwriter;
   const double kVertexScale(1.0);
   const fvec2 UVScale(1.0f, 1.0f);
-  int NumVertexIndices = _submesh.numVertices();
+  int NumVertexIndices = int(numOutputVertices());
 
   _vertexBuffer = std::make_shared<vtxbuf_t>(NumVertexIndices, 0);
   vwriter.Lock(&context, _vertexBuffer.get(), NumVertexIndices);
   for (int iv = 0; iv < NumVertexIndices; iv++) {
     vtx_t OutVtx;
-    const meshutil::vertex& InVtx = *_submesh.vertex(iv);
+    const meshutil::vertex& InVtx = outputVertex(iv);
     const auto pos     = InVtx.mPos * kVertexScale;
     const auto nrm     = InVtx.mNrm;
     OutVtx.mPosition              = fvec3(pos.x, pos.y, pos.z);
@@ -268,12 +315,12 @@ void XgmSkinnedClusterBuilder::BuildVertexBuffer_V12N6I1T4(lev2::Context& contex
   lev2::VtxWriter<vtx_t> vwriter;
   const float kVertexScale(1.0f);
   const fvec2 UVScale(1.0f, 1.0f);
-  int NumVertexIndices = _submesh.numVertices();
+  int NumVertexIndices = int(numOutputVertices());
   _vertexBuffer        = std::make_shared<vtxbuf_t>(NumVertexIndices, 0);
   vwriter.Lock(&context, _vertexBuffer.get(), NumVertexIndices);
   for (int iv = 0; iv < NumVertexIndices; iv++) {
     vtx_t OutVtx;
-    const meshutil::vertex& InVtx = *_submesh.vertex(iv);
+    const meshutil::vertex& InVtx = outputVertex(iv);
 
     OutVtx.mX = InVtx.mPos.x * kVertexScale;
     OutVtx.mY = InVtx.mPos.y * kVertexScale;
@@ -56,6 +56,82 @@ void Mesh::readFromAssimp(const file::Path& BasePath) {
   readFromAssimp(dblock);
 }
 ///////////////////////////////////////////////////////////////////////////////
+// keys (1-weight) and the float math mirror the multimaps this replaced,
+//  the partial sort tie breaks on input order like multimap insertion did.
+///////////////////////////////////////////////////////////////////////////////
+PrunedInfluences pruneInfluences(const RawInfluence* influences, size_t count) {
+  struct Candidate {
+    float _key;
+    size_t _order;
+    const std::string* _jointpath;
+  };
+  thread_local std::vector<Candidate> candidates;
+  candidates.clear();
+  for (size_t inf = 0; inf < count; inf++) {
+    float fw = influences[inf]._weight;
+    if (fw < 0.001)
+      fw = 0.001;
+    candidates.push_back(Candidate{1.0f - fw, inf, influences[inf]._jointpath});
+  }
+  size_t numkept = std::min(count, size_t(4));
+  std::partial_sort(
+      candidates.begin(), //
+      candidates.begin() + numkept,
+      candidates.end(),
+      [](const Candidate& a, const Candidate& b) { //
+        return (a._key < b._key) or ((a._key == b._key) and (a._order < b._order));
+      });
+  ///////////////////////////////////////////////////
+  float totweight = 0.0f;
+  for (size_t i = 0; i < numkept; i++)
+    totweight += (1.0f - candidates[i]._key);
+  if (totweight == 0.0f)
+    totweight = 1.0f;
+  float jointweights[4];
+  float newtotweight = 0.0f;
+  for (size_t i = 0; i < numkept; i++) {
+    // normalize pruned weights
+    float w         = 1.0f - candidates[i]._key;
+    jointweights[i] = w / totweight;
+    newtotweight += jointweights[i];
+  }
+  float fwtest = fabs(1.0f - newtotweight);
+  if (fwtest >= 0.001f) { // ensure within tolerable error limit
+    logchan_meshutilassimp->log(
+        "WARNING weight pruning tolerance: fwtest<%f> icount<%zu>", //
+        fwtest,
+        numkept);
+    OrkAssert(false);
+  }
+  ///////////////////////////////////////////////////
+  // largest normalized weight first,
+  //  equal weights in reverse input order
+  ///////////////////////////////////////////////////
+  size_t order[4] = {0, 1, 2, 3};
+  std::stable_sort(order, order + numkept, [&](size_t a, size_t b) { //
+    return jointweights[a] < jointweights[b];
+  });
+  if (newtotweight == 0.0f)
+    newtotweight = 1.0f;
+  PrunedInfluences rval;
+  rval._count = int(numkept);
+  float totw  = 0.0f;
+  for (size_t k = 0; k < numkept; k++) {
+    size_t i = order[numkept - 1 - k];
+    float w  = jointweights[i] / newtotweight;
+    OrkAssert(w >= 0.0f);
+    OrkAssert(w <= 1.0f);
+    rval._jointpaths[k] = candidates[i]._jointpath;
+    rval._weights[k]    = w;
+    totw += w;
+  }
+  fwtest = fabs(1.0f - totw);
+  if (fwtest >= 0.01f) { // ensure within tolerable error limit
+    OrkAssert(false);
+  }
+  return rval;
+}
+///////////////////////////////////////////////////////////////////////////////
 void Mesh::readFromAssimp(datablock_ptr_t datablock) {
   auto& extension = datablock->_vars->typedValueForKey<std::string>("file-extension").value();
   //logchan_meshutilassimp->log("BEGIN: importing scene from datablock length<%zu> extension<%s>\n", datablock->length(), extension.c_str());
@@ -309,16 +385,12 @@ void Mesh::readFromAssimp(datablock_ptr_t datablock) {
 
     //////////////////////////////////////////////
     // visit meshes, marking dagnodes as bones and fetching joint matrices
+    //  weights are gathered per assimp vertex id,
+    //  joint paths are interned, influences point at them
     //////////////////////////////////////////////
 
-    struct XgmAssimpVertexWeightItem {
-      std::string _jointpath;
-      float _weight = 0.0f;
-    };
-    struct XgmAssimpVertexWeights {
-      std::vector<XgmAssimpVertexWeightItem> _items;
-    };
-    std::map<int, XgmAssimpVertexWeights*> assimpweightlut;
+    std::set<std::string> jointpath_set;
+    std::unordered_map<int, std::vector<RawInfluence>> assimpweightlut;
 
     nodestack = std::queue<aiNode*>();
     nodestack.push(scene->mRootNode);
@@ -353,20 +425,10 @@ void Mesh::readFromAssimp(datablock_ptr_t datablock) {
               // remember effected verts
               /////////////////////////////
               xgmnode->_numBoundVertices += numvertsaffected;
+              const std::string* jointpath = &(*jointpath_set.insert(bone_path).first);
               for (int v = 0; v < numvertsaffected; v++) {
-                const aiVertexWeight& vw                   = bone->mWeights[v];
-                int vertexID                               = vw.mVertexId;
-                float weight                               = vw.mWeight;
-                XgmAssimpVertexWeights* weights_for_vertex = nullptr;
-                auto itw                                   = assimpweightlut.find(vertexID);
-                if (itw != assimpweightlut.end()) {
-                  weights_for_vertex = itw->second;
-                } else {
-                  weights_for_vertex        = new XgmAssimpVertexWeights;
-                  assimpweightlut[vertexID] = weights_for_vertex;
-                }
-                auto xgmw = XgmAssimpVertexWeightItem{bone_path, weight};
-                weights_for_vertex->_items.push_back(xgmw);
+                const aiVertexWeight& vw = bone->mWeights[v];
+                assimpweightlut[vw.mVertexId].push_back(RawInfluence{jointpath, vw.mWeight});
               }
             }
           }
@@ -391,9 +453,27 @@ void Mesh::readFromAssimp(datablock_ptr_t datablock) {
     ork::lev2::xgmskelnode_ptr_t root_skelnode = (it_root_skelnode != parsedskel->_xgmskelmap_by_path.end()) ? it_root_skelnode->second : nullptr;
 
     //////////////////////////////////////////////
-    // parse nodes
+    // parse nodes (serial)
+    //  gathers mesh work items, grouped per output submesh
+    //  in visitation order, the geometry itself is merged below
     //////////////////////////////////////////////
 
+    struct MeshWorkItem {
+      const aiMesh* _mesh = nullptr;
+      GltfMaterial* _material = nullptr;
+      fmtx4 _modelMatrix;
+      fmtx3 _normalMatrix;
+    };
+    struct SubMeshWork {
+      submesh* _submesh = nullptr;
+      std::vector<MeshWorkItem> _items;
+      AABox _extents;
+      int _numTriangles = 0;
+      bonename_set_t _deformerBones;
+    };
+    std::vector<SubMeshWork> submesh_work;
+    std::map<std::string, size_t> submesh_work_index;
+
     //logchan_meshutilassimp->log("parsing nodes for meshdata\n");
 
     while (not nodestack.empty()) {
@@ -431,246 +511,195 @@ void Mesh::readFromAssimp(datablock_ptr_t datablock) {
       fmtx4 ork_model_mtx;
       fmtx3 ork_normal_mtx;
       if (false == is_skinned) {
-        //deco::logchan_meshutilassimp->log(fvec3(1, 0, 0), "/////////////////////////////\n");
-        std::deque<aiNode*> nodehier;
-        bool done = false;
-        auto walk = n;
-        while (not done) {
-          nodehier.push_back(n);
-          fmtx4 test = convertMatrix44(walk->mTransformation);
-          //auto test_str = test.dump4x3cn();
-          //logchan_meshutilassimp->log("NODE<%s> : %s\n", walk->mName.data, test_str.c_str() );
-          walk = walk->mParent;
-          done = (walk == nullptr);
-        }
-        //for (auto item : nodehier) {
-          //ork_model_mtx = convertMatrix44(item->mTransformation) * ork_model_mtx;
-        //}
-
         ork_model_mtx = convertMatrix44(n->mTransformation);
         //auto test_str = ork_model_mtx.dump4x3cn();
         //logchan_meshutilassimp->log("NODE<%s> : %s\n", n->mName.data, test_str.c_str() );
-        // ork_model_mtx  = ork_model_mtx.dump(n->mName.data);
         ork_normal_mtx = ork_model_mtx.rotMatrix33();
-        //deco::logchan_meshutilassimp->log(fvec3(1, 0, 0), "/////////////////////////////\n");
       }
 
       //////////////////////////////////////////////
       // visit node
       //////////////////////////////////////////////
 
-      auto& deformer_bones = _varmap->makeValueForKey<bonename_set_t>("deformer_bones");
-
       for (int i = 0; i < n->mNumMeshes; ++i) {
         const aiMesh* mesh = scene->mMeshes[n->mMeshes[i]];
-        /////////////////////////////////////////////
-        // query which input data is available
-        /////////////////////////////////////////////
-        bool has_normals    = mesh->mNormals != nullptr;
-        bool has_tangents   = mesh->mTangents != nullptr;
-        bool has_bitangents = mesh->mBitangents != nullptr;
-        bool has_colors     = mesh->mColors[0] != nullptr;
-        bool has_uvs        = mesh->mTextureCoords[0] != nullptr;
-        bool has_bones      = mesh->mNumBones != 0;
-        OrkAssert(has_normals);
-        // OrkAssert(has_tangents);
-        // OrkAssert(has_bitangents);
+        OrkAssert(mesh->mNormals != nullptr);
         /////////////////////////////////////////////
         const char* name = mesh->mName.data;
         /////////////////////////////////////////////
         GltfMaterial* outmtl = materialmap[mesh->mMaterialIndex];
         /////////////////////////////////////////////
-        // merge geometry
+        // submeshes are created here, on this thread
         /////////////////////////////////////////////
         auto& out_submesh = MergeSubMesh(name);
         auto& mtlref = out_submesh.typedAnnotation<GltfMaterial*>("gltfmaterial");
         mtlref       = outmtl;
+        auto itw     = submesh_work_index.find(name);
+        if (itw == submesh_work_index.end()) {
+          itw = submesh_work_index.insert(std::make_pair(std::string(name), submesh_work.size())).first;
+          submesh_work.emplace_back();
+          submesh_work.back()._submesh = &out_submesh;
+        }
+        submesh_work[itw->second]._items.push_back(MeshWorkItem{mesh, outmtl, ork_model_mtx, ork_normal_mtx});
+      }
 
+      //////////////////////////////////////////////
+      // enqueue children
+      //////////////////////////////////////////////
 
+      for (int i = 0; i < n->mNumChildren; ++i) {
+        nodestack.push(n->mChildren[i]);
+      }
+    }
 
+    //////////////////////////////////////////////
+    // merge geometry
+    //  one task per output submesh, meshes sharing a submesh
+    //  are merged in node visitation order, so the output
+    //  is identical to a serial import.
+    //////////////////////////////////////////////
 
-
-
-        ork::meshutil::vertex muverts[4];
-        logchan_meshutilassimp->log("processing numfaces<%d> %s", mesh->mNumFaces, outmtl->_name.c_str() );
-        int numinputtriangles = 0;
-        for (int t = 0; t < mesh->mNumFaces; ++t) {
-          const aiFace* face = &mesh->mFaces[t];
-          bool is_triangle   = (face->mNumIndices == 3);
-
-          if (is_triangle) {
-            numinputtriangles++;
-            for (int facevert_index = 0; facevert_index < 3; facevert_index++) {
-              int index = face->mIndices[facevert_index];
-              /////////////////////////////////////////////
-              const auto& v  = mesh->mVertices[index];
-              const auto& n  = mesh->mNormals[index];
-              const auto& uv = (mesh->mTextureCoords[0])[index];
-              const auto& b  = (mesh->mBitangents)[index];
-              auto& muvtx    = muverts[facevert_index];
-              auto pos = fvec3(v.x, v.y, v.z).transform(ork_model_mtx).xyz();
-              auto nrm = fvec3(n.x, n.y, n.z).transform(ork_normal_mtx);
-              muvtx.mPos     = fvec3_to_dvec3(pos);
-              muvtx.mNrm     = fvec3_to_dvec3(nrm);
-
-              _vertexExtents.Grow(dvec3_to_fvec3(muvtx.mPos));
-
-              // logchan_meshutilassimp->log("v<%g %g %g>\n", v.x, v.y, v.z);
-              // logchan_meshutilassimp->log("norm<%g %g %g>\n", muvtx.mNrm.x, muvtx.mNrm.y, muvtx.mNrm.z);
-              if (has_colors)
-                muvtx.mCol[0] = fvec4(1, 1, 1, 1);
-              if (has_uvs) {
-                muvtx.miNumUvs = 1;
-                muvtx.mUV[0].mMapTexCoord = fvec2(uv.x, uv.y);
-                muvtx.mUV[0].mMapBiNormal = fvec3(b.x, b.y, b.z).transform(ork_normal_mtx);
-              }
-              /////////////////////////////////////////////
-              // yuk -- assimp is not like gltf, or collada...
-              // https://github.com/assimp/assimp/blob/master/code/glTF2/glTF2Importer.cpp#L904
-              /////////////////////////////////////////////
-              if (is_skinned) {
-                auto itw = assimpweightlut.find(index);
-                // OrkAssert(itw != assimpweightlut.end());
-                if (itw != assimpweightlut.end()) {
-                  auto influences = itw->second;
-                  int numinf      = influences->_items.size();
-                  OrkAssert(numinf > 0);
-                  // logchan_meshutilassimp->log("vertex<%d> raw_numweights<%d>\n", index, numinf);
-                  ///////////////////////////////////////////////////
-                  // prune to no more than 4 weights
-                  ///////////////////////////////////////////////////
-                  std::multimap<float, XgmAssimpVertexWeightItem> largestWeightMap;
-                  std::multimap<float, std::string> prunedWeightMap;
-                  std::map<std::string, float> rawweightMap;
-                  for (int inf = 0; inf < numinf; inf++) {
-                    auto infl = influences->_items[inf];
-                    float fw  = infl._weight;
-                    if (fw < 0.001)
-                      fw = 0.001;
-                    rawweightMap[infl._jointpath] = fw;
-                    /*if (fw != 0.0f)*/ {
-                      auto xgminfl = XgmAssimpVertexWeightItem(infl);
-                      auto pr      = std::make_pair(1.0f - fw, xgminfl);
-                      largestWeightMap.insert(pr);
-                    }
-                    deformer_bones.insert(infl._jointpath);
-                    logchan_meshutilassimp->log(" xxx inf<%d> bone<%s> weight<%g>\n", inf, infl._jointpath.c_str(), fw);
-                  }
-                  int icount      = 0;
-                  float totweight = 0.0f;
-                  for (auto it : largestWeightMap) {
-                    if (icount < 4) {
-                      totweight += (1.0f - it.first);
-                      icount++;
-                    }
-                  }
-                  if (totweight == 0.0f)
-                    totweight = 1.0f;
-                  icount             = 0;
-                  float newtotweight = 0.0f;
-                  for (auto item : largestWeightMap) {
-                    if (icount < 4) {
-                      // normalize pruned weights
-                      float w            = 1.0f - item.first;
-                      float fjointweight = w / totweight;
-                      newtotweight += fjointweight;
-                      prunedWeightMap.insert(std::make_pair(fjointweight,item.second._jointpath));
-                      ++icount;
-                    }
-                  }
-                  // logchan_meshutilassimp->log("newtotweight<%f>\n", newtotweight);
-                  float fwtest = fabs(1.0f - newtotweight);
-                  if (fwtest >= 0.001f) // ensure within tolerable error limit
-                  {
-                    logchan_meshutilassimp->log(
-                        "WARNING weight pruning tolerance: vertex<%d> fwtest<%f> icount<%d> prunedWeightMapSize<%zu>",
-                        index,
-                        fwtest,
-                        icount,
-                        prunedWeightMap.size());
-                    OrkAssert(false);
-                    // orkerrorlog( "ERROR: <%s> vertex<%d> fwtest<%f> numpairs<%d> largestWeightMap<%d>\n",
-                    // policy->mColladaOutName.c_str(), im, fwtest, inumpairs, largestWeightMap.size() ); orkerrorlog( "ERROR:
-                    // <%s> cannot prune weight, out of tolerance. You must prune it manually\n", policy->mColladaOutName.c_str()
-                    // ); return false;
-                  }
-                  ///////////////////////////////////////////////////
-                  muvtx.miNumWeights = prunedWeightMap.size();
-                  OrkAssert(muvtx.miNumWeights >= 0);
-                  OrkAssert(muvtx.miNumWeights <= 4);
-                  int windex = 0;
-                  /////////////////////////////////
-                  // init vertex with no influences
-                  /////////////////////////////////
-                  for (int iw = 0; iw < 4; iw++) {
-                    muvtx._jointpaths[iw]   = root_skelnode->_path;
-                    muvtx.mJointWeights[iw] = 0.0f;
-                  }
-                  /////////////////////////////////
-                  float totw = 0.0f;
-                  if (newtotweight == 0.0f)
-                    newtotweight = 1.0f;
-                  for (auto it = prunedWeightMap.rbegin(); it != prunedWeightMap.rend(); it++) {
-                    float w = it->first / newtotweight;
-                    OrkAssert(w >= 0.0f);
-                    OrkAssert(w <= 1.0f);
-                    muvtx._jointpaths[windex]   = it->second;
-                    muvtx.mJointWeights[windex] = w;
-                    // logchan_meshutilassimp->log("inf<%s:%g> ", it->second.c_str(), w);
-                    totw += w;
-                    windex++;
-                  }
-                  // logchan_meshutilassimp->log("numw<%d> totw<%g>\n", muvtx.miNumWeights, totw);
-                  fwtest = fabs(1.0f - totw);
-                  if (fwtest >= 0.01f) { // ensure within tolerable error limit
-                    OrkAssert(false);
-                    // logchan_meshutilassimp->log( "\n");
-                  }
+    auto process_mesh = [&](SubMeshWork& work, const MeshWorkItem& item) {
+      const aiMesh* mesh  = item._mesh;
+      auto& out_submesh   = *work._submesh;
+      auto& extents       = work._extents;
+      auto& deformer_bones = work._deformerBones;
+      const auto& ork_model_mtx  = item._modelMatrix;
+      const auto& ork_normal_mtx = item._normalMatrix;
+      /////////////////////////////////////////////
+      // query which input data is available
+      /////////////////////////////////////////////
+      bool has_colors = mesh->mColors[0] != nullptr;
+      bool has_uvs    = mesh->mTextureCoords[0] != nullptr;
+      /////////////////////////////////////////////
+      GltfMaterial* outmtl = item._material;
+      ork::meshutil::vertex muverts[4];
+      logchan_meshutilassimp->log("processing numfaces<%d> %s", mesh->mNumFaces, outmtl->_name.c_str() );
+      int numinputtriangles = 0;
+      for (int t = 0; t < mesh->mNumFaces; ++t) {
+        const aiFace* face = &mesh->mFaces[t];
+        bool is_triangle   = (face->mNumIndices == 3);
+
+        if (is_triangle) {
+          numinputtriangles++;
+          for (int facevert_index = 0; facevert_index < 3; facevert_index++) {
+            int index = face->mIndices[facevert_index];
+            /////////////////////////////////////////////
+            const auto& v  = mesh->mVertices[index];
+            const auto& n  = mesh->mNormals[index];
+            const auto& uv = (mesh->mTextureCoords[0])[index];
+            const auto& b  = (mesh->mBitangents)[index];
+            auto& muvtx    = muverts[facevert_index];
+            auto pos = fvec3(v.x, v.y, v.z).transform(ork_model_mtx).xyz();
+            auto nrm = fvec3(n.x, n.y, n.z).transform(ork_normal_mtx);
+            muvtx.mPos     = fvec3_to_dvec3(pos);
+            muvtx.mNrm     = fvec3_to_dvec3(nrm);
+
+            extents.Grow(dvec3_to_fvec3(muvtx.mPos));
+
+            if (has_colors)
+              muvtx.mCol[0] = fvec4(1, 1, 1, 1);
+            if (has_uvs) {
+              muvtx.miNumUvs = 1;
+              muvtx.mUV[0].mMapTexCoord = fvec2(uv.x, uv.y);
+              muvtx.mUV[0].mMapBiNormal = fvec3(b.x, b.y, b.z).transform(ork_normal_mtx);
+            }
+            /////////////////////////////////////////////
+            // yuk -- assimp is not like gltf, or collada...
+            // https://github.com/assimp/assimp/blob/master/code/glTF2/glTF2Importer.cpp#L904
+            /////////////////////////////////////////////
+            if (is_skinned) {
+              auto itw = assimpweightlut.find(index);
+              if (itw != assimpweightlut.end()) {
+                const auto& influences = itw->second;
+                OrkAssert(influences.size() > 0);
+                for (const auto& infl : influences)
+                  deformer_bones.insert(*infl._jointpath);
+                ///////////////////////////////////////////////////
+                // prune to no more than 4 weights
+                ///////////////////////////////////////////////////
+                auto pruned        = pruneInfluences(influences.data(), influences.size());
+                muvtx.miNumWeights = pruned._count;
+                /////////////////////////////////
+                // init vertex with no influences
+                /////////////////////////////////
+                for (int iw = 0; iw < 4; iw++) {
+                  muvtx._jointpaths[iw]   = root_skelnode->_path;
+                  muvtx.mJointWeights[iw] = 0.0f;
+                }
+                for (int iw = 0; iw < pruned._count; iw++) {
+                  muvtx._jointpaths[iw]   = *pruned._jointpaths[iw];
+                  muvtx.mJointWeights[iw] = pruned._weights[iw];
                 }
               }
             }
-            ork::meshutil::vertex_ptr_t outvtx[3] = {nullptr, nullptr, nullptr};
-            outvtx[0]                             = out_submesh.mergeVertex(muverts[0]);
-            outvtx[1]                             = out_submesh.mergeVertex(muverts[1]);
-            outvtx[2]                             = out_submesh.mergeVertex(muverts[2]);
-            ork::meshutil::Polygon new_poly(outvtx[0],outvtx[1],outvtx[2]);
-            out_submesh.mergePoly(new_poly);
-          } else {
-            logchan_meshutilassimp->log("non triangle");
           }
-        } //  for (int t = 0; t < mesh->mNumFaces; ++t) {
-
-        logchan_meshutilassimp->log("done processing numfaces<%d> ..", mesh->mNumFaces);
-        logchan_meshutilassimp->log("numinputtriangles<%d>", numinputtriangles );
-        logchan_meshutilassimp->log("xxx num deformer bones<%zu>", deformer_bones.size() );
-        for( auto b : deformer_bones ){
-          logchan_meshutilassimp->log("xxx defbone<%s>", b.c_str() );
+          ork::meshutil::vertex_ptr_t outvtx[3] = {nullptr, nullptr, nullptr};
+          outvtx[0]                             = out_submesh.mergeVertex(muverts[0]);
+          outvtx[1]                             = out_submesh.mergeVertex(muverts[1]);
+          outvtx[2]                             = out_submesh.mergeVertex(muverts[2]);
+          ork::meshutil::Polygon new_poly(outvtx[0],outvtx[1],outvtx[2]);
+          out_submesh.mergePoly(new_poly);
+        } else {
+          logchan_meshutilassimp->log("non triangle");
         }
-        /////////////////////////////////////////////
-        // stats
-        /////////////////////////////////////////////
-        int meshout_numtris = out_submesh.numPolys(3);
-        int meshout_numquads = out_submesh.numPolys(4);
-        int meshout_numverts = out_submesh.numVertices();
-        logchan_meshutilassimp->log( "meshout_numtris<%d>", meshout_numtris );
-        logchan_meshutilassimp->log( "meshout_numquads<%d>", meshout_numquads );
-        logchan_meshutilassimp->log( "meshout_numverts<%d>", meshout_numverts );
-        /////////////////////////////////////////////
-      }
+      } //  for (int t = 0; t < mesh->mNumFaces; ++t) {
+
+      work._numTriangles += numinputtriangles;
+      logchan_meshutilassimp->log("done processing numfaces<%d> ..", mesh->mNumFaces);
+      logchan_meshutilassimp->log("numinputtriangles<%d>", numinputtriangles );
+      /////////////////////////////////////////////
+      // stats
+      /////////////////////////////////////////////
+      int meshout_numtris = out_submesh.numPolys(3);
+      int meshout_numquads = out_submesh.numPolys(4);
+      int meshout_numverts = out_submesh.numVertices();
+      logchan_meshutilassimp->log( "meshout_numtris<%d>", meshout_numtris );
+      logchan_meshutilassimp->log( "meshout_numquads<%d>", meshout_numquads );
+      logchan_meshutilassimp->log( "meshout_numverts<%d>", meshout_numverts );
+    };
 
-      //////////////////////////////////////////////
-      // enqueue children
-      //////////////////////////////////////////////
+    auto process_submesh = [&](SubMeshWork& work) {
+      work._extents.BeginGrow();
+      for (const auto& item : work._items)
+        process_mesh(work, item);
+    };
 
-      for (int i = 0; i < n->mNumChildren; ++i) {
-        auto child     = n->mChildren[i];
-        auto child_mtx = child->mTransformation;
+    //////////////////////////////////////////////
+    // "assimp.serial_import" forces everything onto this thread
+    //////////////////////////////////////////////
 
-        // fmtx4 orkmtx = convertMatrix44(child_mtx);
-        // ork_mtxstack.push_back(orkmtx);
+    bool run_serial = (submesh_work.size() < 2);
+    if (auto as_bool = _varmap->typedValueForKey<bool>("assimp.serial_import"))
+      run_serial |= as_bool.value();
+    if (run_serial) {
+      for (auto& work : submesh_work)
+        process_submesh(work);
+    } else {
+      auto group = opq::createCompletionGroup(opq::concurrentQueue(), "assimp.submeshes");
+      for (auto& work : submesh_work) {
+        auto pwork = &work;
+        group->enqueue([pwork, &process_submesh]() { process_submesh(*pwork); });
+      }
+      group->join();
+    }
 
-        nodestack.push(child);
+    //////////////////////////////////////////////
+    // fold per submesh results back in
+    //////////////////////////////////////////////
+
+    auto& deformer_bones = _varmap->makeValueForKey<bonename_set_t>("deformer_bones");
+    for (auto& work : submesh_work) {
+      work._extents.EndGrow();
+      if (work._numTriangles != 0) {
+        _vertexExtents.Grow(work._extents.Min());
+        _vertexExtents.Grow(work._extents.Max());
       }
+      deformer_bones.insert(work._deformerBones.begin(), work._deformerBones.end());
+    }
+    logchan_meshutilassimp->log("xxx num deformer bones<%zu>", deformer_bones.size() );
+    for( auto b : deformer_bones ){
+      logchan_meshutilassimp->log("xxx defbone<%s>", b.c_str() );
     }
     // logchan_meshutilassimp->log("done parsing nodes for meshdata\n");
     //logchan_meshutilassimp->log("/////////////////////////////////////////////////////////////////\n");
@@ -713,14 +742,49 @@ void clusterizeToolMeshToXgmMesh(const ork::meshutil::Mesh& inp_model, ork::lev2
   out_mesh->SetMeshName("Mesh1"_pool);
   out_model.AddMesh("Mesh1"_pool, out_mesh);
 
-  auto VertexFormat = is_skinned //
-                          ? ork::lev2::EVtxStreamFormat::V12N12B12T8I4W4
-                          : ork::lev2::EVtxStreamFormat::V12N12B12T16;
+  /////////////////////////////////////////////
+  // "xgm.quantize_vertices" selects the compact streams
+  //  (bounds relative unorm16 positions, octahedral normals, half uvs)
+  /////////////////////////////////////////////
+  bool quantize = false;
+  if (auto as_bool = inp_model._varmap->typedValueForKey<bool>("xgm.quantize_vertices")) {
+    quantize = as_bool.value();
+  }
+  auto FloatVertexFormat = is_skinned //
+                               ? ork::lev2::EVtxStreamFormat::V12N12B12T8I4W4
+                               : ork::lev2::EVtxStreamFormat::V12N12B12T16;
+  auto QuantVertexFormat = is_skinned //
+                               ? ork::lev2::EVtxStreamFormat::V8N4B4T4I4W4
+                               : ork::lev2::EVtxStreamFormat::V8N4B4T8;
+  auto VertexFormat = quantize ? QuantVertexFormat : FloatVertexFormat;
+  /////////////////////////////////////////////
+  // "xgm.optimize_indices" (default on) reorders each cluster for
+  //  vertex cache reuse, overdraw and vertex fetch locality
+  //  (replaces tristripping) and generates meshlets
+  /////////////////////////////////////////////
+  bool optimize_indices = true;
+  if (auto as_bool = inp_model._varmap->typedValueForKey<bool>("xgm.optimize_indices")) {
+    optimize_indices = as_bool.value();
+  }
+  /////////////////////////////////////////////
+  // "xgm.lod_count" (default 1, LOD 0 only) and "xgm.lod_ratio"
+  //  (default 0.5) : each LOD keeps lod_ratio of the previous
+  //  LOD's triangles (QEM, see submeshSimplify)
+  /////////////////////////////////////////////
+  int lod_count   = 1;
+  float lod_ratio = 0.5f;
+  if (auto try_count = inp_model._varmap->tryKeyAsInteger("xgm.lod_count")) {
+    lod_count = std::max(try_count.value(), 1);
+  }
+  if (auto try_ratio = inp_model._varmap->tryKeyAsNumber("xgm.lod_ratio")) {
+    lod_ratio = std::clamp(try_ratio.value(), 0.01f, 1.0f);
+  }
   struct SubRec {
     ork::meshutil::submesh_ptr_t _toolsub;
     ork::meshutil::MaterialGroup* _toolmgrp     = nullptr;
     ork::meshutil::XgmClusterizer* _clusterizer = nullptr;
     ork::lev2::pbrmaterial_ptr_t _pbrmaterial;
+    ork::lev2::xgmsubmesh_ptr_t _xgmsubmesh;
   };
 
   typedef std::vector<SubRec> xgmsubvect_t;
@@ -830,6 +894,10 @@ void clusterizeToolMeshToXgmMesh(const ork::meshutil::Mesh& inp_model, ork::lev2
   out_mesh->ReserveSubMeshes(count_subs);
   subindex = 0;
 
+  ork::meshutil::VertexCacheStats pre_optimize_stats;
+  ork::meshutil::VertexCacheStats post_optimize_stats;
+  size_t num_meshlets = 0;
+
   logchan_meshutilassimp->log("generating %d submeshes\n", (int)count_subs);
 
   for (auto item : mtlsubmap) {
@@ -842,6 +910,7 @@ void clusterizeToolMeshToXgmMesh(const ork::meshutil::Mesh& inp_model, ork::lev2
       auto xgm_submesh       = std::make_shared<ork::lev2::XgmSubMesh>();
       xgm_submesh->_material = pbr_material;
       out_mesh->AddSubMesh(xgm_submesh);
+      subrec._xgmsubmesh = xgm_submesh;
       subindex++;
 
       int inumclus = clusterizer->GetNumClusters();
@@ -851,10 +920,12 @@ void clusterizeToolMeshToXgmMesh(const ork::meshutil::Mesh& inp_model, ork::lev2
         auto xgm_cluster = std::make_shared<lev2::XgmCluster>();
         xgm_submesh->_clusters.push_back(xgm_cluster);
         op_counter.fetch_add(1);
-        auto op = [&op_counter,xgm_cluster,clusterbuilder,VertexFormat](){
+        auto op = [&op_counter,xgm_cluster,clusterbuilder,VertexFormat,optimize_indices](){
 
           lev2::ContextDummy DummyTarget;
           //logchan_meshutilassimp->log("building tristrip cluster<%d>\n", icluster);
+          if (optimize_indices)
+            clusterbuilder->optimize();
           clusterbuilder->buildVertexBuffer(DummyTarget, VertexFormat);
           buildXgmCluster(DummyTarget, xgm_cluster, clusterbuilder,true);
           op_counter.fetch_add(-1);
@@ -876,8 +947,129 @@ void clusterizeToolMeshToXgmMesh(const ork::meshutil::Mesh& inp_model, ork::lev2
 
         usleep(100000);
       }
+
+      for (int icluster = 0; icluster < inumclus; icluster++) {
+        auto clusterbuilder = clusterizer->GetCluster(icluster);
+        if (not clusterbuilder->isOptimized())
+          continue;
+        auto accumulate = [](ork::meshutil::VertexCacheStats& total, const ork::meshutil::VertexCacheStats& stats) {
+          total._numTriangles += stats._numTriangles;
+          total._numVertices += stats._numVertices;
+          total._numMisses += stats._numMisses;
+        };
+        accumulate(pre_optimize_stats, clusterbuilder->_preOptimizeStats);
+        accumulate(post_optimize_stats, clusterbuilder->_postOptimizeStats);
+        num_meshlets += xgm_submesh->_clusters[icluster]->_meshlets.size();
+      }
     }
   }
+
+  //////////////////////////////////////////////////////////////////
+  // LOD chain : LOD n is simplified from LOD n-1, then clusterized
+  //  and built exactly like LOD 0. one op per submesh.
+  //////////////////////////////////////////////////////////////////
+
+  if (lod_count > 1) {
+    std::atomic<int> lod_op_counter = 0;
+    for (auto& item : mtlsubmap) {
+      for (auto& subrec : item.second) {
+        lod_op_counter.fetch_add(1);
+        auto op = [&lod_op_counter, subrec, lod_count, lod_ratio, is_skinned, VertexFormat, optimize_indices]() {
+          const auto& flags = subrec._toolmgrp->mMeshConfigurationFlags;
+          auto prev_lod     = subrec._toolsub;
+          for (int ilod = 1; ilod < lod_count; ilod++) {
+            auto lod_submesh = std::make_shared<ork::meshutil::submesh>();
+            submeshSimplify(*prev_lod, *lod_submesh, lod_ratio);
+
+            ClusterizerType clusterizer;
+            clusterizer._policy._skinned = is_skinned;
+            clusterizer.Begin();
+            ork::meshutil::XgmClusterTri clustertri;
+            lod_submesh->visitAllPolys([&](merged_poly_const_ptr_t p) {
+              if (p->numVertices() != 3)
+                return;
+              for (int i = 0; i < 3; i++)
+                clustertri._vertex[i] = *lod_submesh->vertex(p->vertexID(i));
+              clusterizer.addTriangle(clustertri, flags);
+            });
+            clusterizer.End();
+
+            lev2::ContextDummy DummyTarget;
+            ork::lev2::xgmcluster_ptr_list_t lod_clusters;
+            for (int icluster = 0; icluster < int(clusterizer.GetNumClusters()); icluster++) {
+              auto clusterbuilder = clusterizer.GetCluster(icluster);
+              auto xgm_cluster    = std::make_shared<lev2::XgmCluster>();
+              if (optimize_indices)
+                clusterbuilder->optimize();
+              clusterbuilder->buildVertexBuffer(DummyTarget, VertexFormat);
+              buildXgmCluster(DummyTarget, xgm_cluster, clusterbuilder, true);
+              lod_clusters.push_back(xgm_cluster);
+            }
+            logchan_meshutilassimp->log(
+                "lod<%d> numtris<%zu> -> <%zu> numclusters<%zu>",
+                ilod,
+                prev_lod->numPolys(),
+                lod_submesh->numPolys(),
+                lod_clusters.size());
+            subrec._xgmsubmesh->_lodClusters.push_back(lod_clusters);
+            prev_lod = lod_submesh;
+          }
+          lod_op_counter.fetch_add(-1);
+        };
+        opq::concurrentQueue()->enqueue(op);
+      }
+    }
+    while (lod_op_counter.load() > 0) {
+      usleep(100000);
+    }
+    //////////////////////////////////////////////
+    // switch distances : projected size scales with sqrt(triangle count)
+    //  at constant on screen triangle density
+    //////////////////////////////////////////////
+    out_model._lodScreenSizes.clear();
+    for (int ilod = 1; ilod < lod_count; ilod++) {
+      out_model._lodScreenSizes.push_back(0.25f * powf(sqrtf(lod_ratio), float(ilod - 1)));
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////
+  // post transform cache efficiency (FIFO16), before and after
+  //////////////////////////////////////////////////////////////////
+
+  if (optimize_indices) {
+    auto report = [](const char* label, const ork::meshutil::VertexCacheStats& stats) {
+      logchan_meshutilassimp->log(
+          "index order<%s> numtris<%zu> acmr<%.3f> atvr<%.3f>",
+          label,
+          stats._numTriangles,
+          stats._numTriangles ? float(stats._numMisses) / float(stats._numTriangles) : 0.0f,
+          stats._numVertices ? float(stats._numMisses) / float(stats._numVertices) : 0.0f);
+    };
+    report("source", pre_optimize_stats);
+    report("optimized", post_optimize_stats);
+    logchan_meshutilassimp->log("meshlets<%zu>", num_meshlets);
+  }
+
+  //////////////////////////////////////////////////////////////////
+  // vertex stream footprint (memory == per frame fetch bandwidth)
+  //////////////////////////////////////////////////////////////////
+
+  size_t num_verts = 0;
+  size_t num_bytes = 0;
+  for (int isub = 0; isub < out_mesh->numSubMeshes(); isub++) {
+    for (auto cluster : out_mesh->subMesh(isub)->_clusters) {
+      num_verts += cluster->_vertexBuffer->GetNumVertices();
+      num_bytes += size_t(cluster->_vertexBuffer->GetNumVertices()) * cluster->_vertexBuffer->GetVtxSize();
+    }
+  }
+  size_t float_bytes = num_verts * (is_skinned ? sizeof(lev2::SVtxV12N12B12T8I4W4) : sizeof(lev2::SVtxV12N12B12T16));
+  logchan_meshutilassimp->log(
+      "vertex streams quantized<%d> numverts<%zu> bytes<%zu> float_bytes<%zu> saved<%.1f%%>",
+      int(quantize),
+      num_verts,
+      num_bytes,
+      float_bytes,
+      float_bytes ? (100.0 * double(float_bytes - num_bytes) / double(float_bytes)) : 0.0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -885,6 +1077,17 @@ datablock_ptr_t assimpToXgm(datablock_ptr_t inp_datablock) {
 
   Mesh tmesh;
   tmesh.readFromAssimp(inp_datablock);
+  for (auto key : {"xgm.quantize_vertices", "xgm.optimize_indices"}) {
+    if (auto try_opt = inp_datablock->_vars->typedValueForKey<bool>(key)) {
+      tmesh._varmap->makeValueForKey<bool>(key) = try_opt.value();
+    }
+  }
+  if (auto try_count = inp_datablock->_vars->tryKeyAsInteger("xgm.lod_count")) {
+    tmesh._varmap->makeValueForKey<int>("xgm.lod_count") = try_count.value();
+  }
+  if (auto try_ratio = inp_datablock->_vars->tryKeyAsNumber("xgm.lod_ratio")) {
+    tmesh._varmap->makeValueForKey<float>("xgm.lod_ratio") = try_ratio.value();
+  }
 
   ork::lev2::XgmModel xgmmdlout;
   bool is_skinned = false;
@@ -0,0 +1,417 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/lev2/gfx/meshutil/meshutil_optimize.h>
+#include <algorithm>
+#include <cmath>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace ork::meshutil {
+///////////////////////////////////////////////////////////////////////////////
+
+VertexCacheStats analyzeVertexCache(const index_vect_t& indices, size_t numverts, size_t cachesize) {
+  VertexCacheStats rval;
+  rval._numTriangles = indices.size() / 3;
+  // a vertex is resident while (time - stamp) <= cachesize
+  std::vector<uint32_t> stamp(numverts, 0);
+  std::vector<bool> referenced(numverts, false);
+  uint32_t time = uint32_t(cachesize) + 1;
+  for (auto index : indices) {
+    OrkAssert(index < numverts);
+    if ((time - stamp[index]) > cachesize) {
+      stamp[index] = time++;
+      rval._numMisses++;
+    }
+    if (not referenced[index]) {
+      referenced[index] = true;
+      rval._numVertices++;
+    }
+  }
+  if (rval._numTriangles)
+    rval._acmr = float(rval._numMisses) / float(rval._numTriangles);
+  if (rval._numVertices)
+    rval._atvr = float(rval._numMisses) / float(rval._numVertices);
+  return rval;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Forsyth vertex scoring (constants from the original paper)
+///////////////////////////////////////////////////////////////////////////////
+
+static constexpr int kFORSYTHCACHESIZE    = 32;
+static constexpr float kCACHEDECAYPOWER   = 1.5f;
+static constexpr float kLASTTRISCORE      = 0.75f;
+static constexpr float kVALENCEBOOSTSCALE = 2.0f;
+static constexpr float kVALENCEBOOSTPOWER = 0.5f;
+
+static float _forsythVertexScore(int cachepos, uint32_t numremaining) {
+  if (numremaining == 0)
+    return -1.0f;
+  float score = 0.0f;
+  if (cachepos >= 0) {
+    if (cachepos < 3) // used by the last triangle
+      score = kLASTTRISCORE;
+    else {
+      float scaler = 1.0f - float(cachepos - 3) / float(kFORSYTHCACHESIZE - 3);
+      score        = powf(scaler, kCACHEDECAYPOWER);
+    }
+  }
+  // favor vertices with few triangles left, so they get finished off
+  score += kVALENCEBOOSTSCALE * powf(float(numremaining), -kVALENCEBOOSTPOWER);
+  return score;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void optimizeVertexCache(index_vect_t& indices, size_t numverts) {
+  size_t numtris = indices.size() / 3;
+  if (numtris == 0)
+    return;
+
+  /////////////////////////////////////////
+  // vertex -> live triangle adjacency (packed)
+  /////////////////////////////////////////
+
+  std::vector<uint32_t> numremaining(numverts, 0);
+  for (auto index : indices)
+    numremaining[index]++;
+  std::vector<uint32_t> adjoffset(numverts + 1, 0);
+  for (size_t v = 0; v < numverts; v++)
+    adjoffset[v + 1] = adjoffset[v] + numremaining[v];
+  std::vector<uint32_t> adjtris(indices.size());
+  {
+    std::vector<uint32_t> fill(adjoffset.begin(), adjoffset.end() - 1);
+    for (size_t t = 0; t < numtris; t++)
+      for (int k = 0; k < 3; k++)
+        adjtris[fill[indices[t * 3 + k]]++] = uint32_t(t);
+  }
+
+  /////////////////////////////////////////
+
+  std::vector<int> cachepos(numverts, -1);
+  std::vector<float> vtxscore(numverts);
+  for (size_t v = 0; v < numverts; v++)
+    vtxscore[v] = _forsythVertexScore(-1, numremaining[v]);
+
+  std::vector<bool> emitted(numtris, false);
+  index_vect_t output;
+  output.reserve(indices.size());
+  std::vector<uint32_t> cache, newcache;
+  cache.reserve(kFORSYTHCACHESIZE + 3);
+  newcache.reserve(kFORSYTHCACHESIZE + 3);
+
+  size_t scan = 0;
+  int best    = -1;
+  for (size_t n = 0; n < numtris; n++) {
+    if (best < 0) {
+      // nothing adjacent to the cache is left,
+      //  restart from the first unemitted triangle in input order
+      while (emitted[scan])
+        scan++;
+      best = int(scan);
+    }
+    emitted[best]       = true;
+    const uint32_t* tri = &indices[size_t(best) * 3];
+    newcache.clear();
+    for (int k = 0; k < 3; k++) {
+      uint32_t v = tri[k];
+      output.push_back(v);
+      if (std::find(newcache.begin(), newcache.end(), v) == newcache.end())
+        newcache.push_back(v);
+      // detach triangle from the vertex
+      uint32_t* adj  = &adjtris[adjoffset[v]];
+      uint32_t count = numremaining[v];
+      for (uint32_t i = 0; i < count; i++) {
+        if (adj[i] == uint32_t(best)) {
+          adj[i] = adj[count - 1];
+          break;
+        }
+      }
+      numremaining[v]--;
+    }
+    for (auto v : cache) {
+      if (v != tri[0] and v != tri[1] and v != tri[2])
+        newcache.push_back(v);
+    }
+    // rescore every vertex which moved (or fell out of the cache)
+    for (size_t i = 0; i < newcache.size(); i++) {
+      uint32_t v  = newcache[i];
+      cachepos[v] = (i < kFORSYTHCACHESIZE) ? int(i) : -1;
+      vtxscore[v] = _forsythVertexScore(cachepos[v], numremaining[v]);
+    }
+    // rescore their triangles, next triangle is the best of those
+    best            = -1;
+    float bestscore = -1.0f;
+    for (auto v : newcache) {
+      const uint32_t* adj = &adjtris[adjoffset[v]];
+      for (uint32_t i = 0; i < numremaining[v]; i++) {
+        uint32_t t  = adj[i];
+        float score = vtxscore[indices[t * 3 + 0]] + vtxscore[indices[t * 3 + 1]] + vtxscore[indices[t * 3 + 2]];
+        if (score > bestscore) {
+          bestscore = score;
+          best      = int(t);
+        }
+      }
+    }
+    if (newcache.size() > kFORSYTHCACHESIZE)
+      newcache.resize(kFORSYTHCACHESIZE);
+    std::swap(cache, newcache);
+  }
+  indices.swap(output);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void optimizeOverdraw(index_vect_t& indices, const std::vector<fvec3>& positions, float threshold) {
+  size_t numtris = indices.size() / 3;
+  if (numtris < 2)
+    return;
+
+  constexpr uint32_t kcachesize = 16;
+  std::vector<uint32_t> stamp(positions.size(), 0);
+  uint32_t time = kcachesize + 1;
+  auto simulate = [&](size_t t) -> int {
+    int misses = 0;
+    for (int k = 0; k < 3; k++) {
+      uint32_t v = indices[t * 3 + k];
+      if ((time - stamp[v]) > kcachesize) {
+        stamp[v] = time++;
+        misses++;
+      }
+    }
+    return misses;
+  };
+  auto flush = [&]() { time += kcachesize + 1; };
+
+  /////////////////////////////////////////
+  // hard boundaries : the cache ordering restarted (all 3 vertices missed)
+  /////////////////////////////////////////
+
+  std::vector<size_t> hard;
+  for (size_t t = 0; t < numtris; t++) {
+    int misses = simulate(t);
+    if (t == 0 or misses == 3)
+      hard.push_back(t);
+  }
+  hard.push_back(numtris);
+
+  /////////////////////////////////////////
+  // soft boundaries : split a run as soon as its
+  //  local acmr gets within threshold of the whole run
+  /////////////////////////////////////////
+
+  std::vector<size_t> runs;
+  for (size_t h = 0; (h + 1) < hard.size(); h++) {
+    size_t start = hard[h];
+    size_t end   = hard[h + 1];
+    flush();
+    size_t runmisses = 0;
+    for (size_t t = start; t < end; t++)
+      runmisses += simulate(t);
+    float runacmr = float(runmisses) / float(end - start);
+    flush();
+    runs.push_back(start);
+    size_t segstart  = start;
+    size_t segmisses = 0;
+    for (size_t t = start; t < end; t++) {
+      segmisses += simulate(t);
+      float segacmr = float(segmisses) / float(t + 1 - segstart);
+      if ((t + 1) < end and segacmr <= runacmr * threshold) {
+        runs.push_back(t + 1);
+        segstart  = t + 1;
+        segmisses = 0;
+        flush();
+      }
+    }
+  }
+  runs.push_back(numtris);
+
+  /////////////////////////////////////////
+  // sort runs, outward facing (likely occluders) first
+  /////////////////////////////////////////
+
+  auto triangleCross = [&](size_t t) -> fvec3 {
+    const auto& p0 = positions[indices[t * 3 + 0]];
+    const auto& p1 = positions[indices[t * 3 + 1]];
+    const auto& p2 = positions[indices[t * 3 + 2]];
+    return (p1 - p0).crossWith(p2 - p0);
+  };
+  auto triangleCenter = [&](size_t t) -> fvec3 {
+    return (positions[indices[t * 3 + 0]] + positions[indices[t * 3 + 1]] + positions[indices[t * 3 + 2]]) * (1.0f / 3.0f);
+  };
+
+  fvec3 meshcenter(0, 0, 0);
+  float meshweight = 0.0f;
+  for (size_t t = 0; t < numtris; t++) {
+    float area = triangleCross(t).magnitude();
+    meshcenter += triangleCenter(t) * area;
+    meshweight += area;
+  }
+  if (meshweight > 0.0f)
+    meshcenter = meshcenter * (1.0f / meshweight);
+
+  struct Run {
+    size_t _start  = 0;
+    size_t _end    = 0;
+    float _sortkey = 0.0f;
+  };
+  std::vector<Run> sorted;
+  for (size_t r = 0; (r + 1) < runs.size(); r++) {
+    Run run;
+    run._start = runs[r];
+    run._end   = runs[r + 1];
+    fvec3 center(0, 0, 0);
+    fvec3 normal(0, 0, 0);
+    float weight = 0.0f;
+    for (size_t t = run._start; t < run._end; t++) {
+      fvec3 cross = triangleCross(t);
+      float area  = cross.magnitude();
+      center += triangleCenter(t) * area;
+      normal += cross;
+      weight += area;
+    }
+    float nlen = normal.magnitude();
+    if (weight > 0.0f and nlen > 0.0f)
+      run._sortkey = (center * (1.0f / weight) - meshcenter).dotWith(normal * (1.0f / nlen));
+    sorted.push_back(run);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), [](const Run& a, const Run& b) { return a._sortkey > b._sortkey; });
+
+  index_vect_t output;
+  output.reserve(indices.size());
+  for (const auto& run : sorted)
+    output.insert(output.end(), indices.begin() + run._start * 3, indices.begin() + run._end * 3);
+  indices.swap(output);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t optimizeVertexFetch(index_vect_t& indices, index_vect_t& out_order, size_t numverts) {
+  constexpr uint32_t kUNUSED = 0xffffffff;
+  std::vector<uint32_t> remap(numverts, kUNUSED);
+  out_order.clear();
+  for (auto& index : indices) {
+    if (remap[index] == kUNUSED) {
+      remap[index] = uint32_t(out_order.size());
+      out_order.push_back(index);
+    }
+    index = remap[index];
+  }
+  return out_order.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void _computeMeshletBounds(lev2::XgmMeshlet& meshlet, const std::vector<fvec3>& positions) {
+
+  /////////////////////////////////////////
+  // bounding sphere (box centered)
+  /////////////////////////////////////////
+
+  fvec3 bmin = positions[meshlet._vertices[0]];
+  fvec3 bmax = bmin;
+  for (auto v : meshlet._vertices) {
+    const auto& p = positions[v];
+    bmin          = fvec3(std::min(bmin.x, p.x), std::min(bmin.y, p.y), std::min(bmin.z, p.z));
+    bmax          = fvec3(std::max(bmax.x, p.x), std::max(bmax.y, p.y), std::max(bmax.z, p.z));
+  }
+  meshlet._center = (bmin + bmax) * 0.5f;
+  meshlet._radius = 0.0f;
+  for (auto v : meshlet._vertices)
+    meshlet._radius = std::max(meshlet._radius, (positions[v] - meshlet._center).magnitude());
+
+  /////////////////////////////////////////
+  // normal cone
+  /////////////////////////////////////////
+
+  meshlet._coneApex   = meshlet._center;
+  meshlet._coneAxis   = fvec3(0, 0, 0);
+  meshlet._coneCutoff = 1.0f;
+
+  std::vector<fvec3> normals;
+  std::vector<fvec3> origins;
+  fvec3 axis(0, 0, 0);
+  size_t numtris = meshlet._triangles.size() / 3;
+  for (size_t t = 0; t < numtris; t++) {
+    const auto& p0 = positions[meshlet._vertices[meshlet._triangles[t * 3 + 0]]];
+    const auto& p1 = positions[meshlet._vertices[meshlet._triangles[t * 3 + 1]]];
+    const auto& p2 = positions[meshlet._vertices[meshlet._triangles[t * 3 + 2]]];
+    fvec3 n        = (p1 - p0).crossWith(p2 - p0);
+    float len      = n.magnitude();
+    if (len <= 0.0f) // degenerate
+      continue;
+    n = n * (1.0f / len);
+    axis += n;
+    normals.push_back(n);
+    origins.push_back(p0);
+  }
+  float axislen = axis.magnitude();
+  if (normals.empty() or axislen <= 0.0f)
+    return;
+  axis         = axis * (1.0f / axislen);
+  float mindot = 1.0f;
+  for (const auto& n : normals)
+    mindot = std::min(mindot, n.dotWith(axis));
+  // wider than (about) a hemisphere, cone culling would never succeed
+  if (mindot <= 0.1f)
+    return;
+  // move the apex back until every triangle plane is in front of it
+  float maxt = 0.0f;
+  for (size_t i = 0; i < normals.size(); i++) {
+    float t = (meshlet._center - origins[i]).dotWith(normals[i]) / axis.dotWith(normals[i]);
+    maxt    = std::max(maxt, t);
+  }
+  meshlet._coneAxis   = axis;
+  meshlet._coneApex   = meshlet._center - axis * maxt;
+  meshlet._coneCutoff = sqrtf(1.0f - mindot * mindot);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::vector<lev2::XgmMeshlet> buildMeshlets(
+    const index_vect_t& indices,
+    const std::vector<fvec3>& positions,
+    size_t maxverts,
+    size_t maxtris) {
+  OrkAssert(maxverts >= 3 and maxverts <= 256);
+  OrkAssert(maxtris >= 1);
+  std::vector<lev2::XgmMeshlet> meshlets;
+  std::vector<int> localindex(positions.size(), -1);
+  lev2::XgmMeshlet current;
+  auto finish = [&]() {
+    if (current._triangles.empty())
+      return;
+    for (auto v : current._vertices)
+      localindex[v] = -1;
+    _computeMeshletBounds(current, positions);
+    meshlets.push_back(std::move(current));
+    current = lev2::XgmMeshlet();
+  };
+  size_t numtris = indices.size() / 3;
+  for (size_t t = 0; t < numtris; t++) {
+    const uint32_t* tri = &indices[t * 3];
+    size_t newverts     = 0;
+    for (int k = 0; k < 3; k++)
+      newverts += (localindex[tri[k]] < 0) ? 1 : 0;
+    if ((current._vertices.size() + newverts) > maxverts or (current._triangles.size() / 3) >= maxtris)
+      finish();
+    for (int k = 0; k < 3; k++) {
+      uint32_t v = tri[k];
+      if (localindex[v] < 0) {
+        localindex[v] = int(current._vertices.size());
+        current._vertices.push_back(v);
+      }
+      current._triangles.push_back(uint8_t(localindex[v]));
+    }
+  }
+  finish();
+  return meshlets;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::meshutil
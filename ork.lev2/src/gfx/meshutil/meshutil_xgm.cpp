@@ -14,6 +14,7 @@
 #include <ork/lev2/gfx/gfxmodel.h>
 #include <ork/lev2/gfx/gfxmaterial_test.h>
 #include <ork/lev2/gfx/gfxctxdummy.h>
+#include <ork/lev2/gfx/gfxvtxquant.h>
 #include <ork/file/chunkfile.h>
 #include <ork/application/application.h>
 
@@ -138,6 +139,35 @@ void Mesh::ReadFromXGM(const file::Path& BasePath) {
                     break;
                   }
                   //////////////////////////////////////////////////////////////////
+                  case lev2::EVtxStreamFormat::V8N4B4T8:
+                  case lev2::EVtxStreamFormat::V8N4B4T4I4W4: {
+                    // both quantized layouts share the leading pos/nrm/binrm/uv0 block
+                    using namespace lev2::vtxquant;
+                    static_assert(offsetof(lev2::SVtxV8N4B4T8, mUV0) == offsetof(lev2::SVtxV8N4B4T4I4W4, mUV0));
+                    auto ptypedsource = (const uint8_t*)pvertbase;
+                    size_t stride     = pvb->GetVtxSize();
+                    const auto& bbox  = clus->mBoundingBox;
+                    PositionQuantizer quantizer(bbox.Min(), bbox.Max());
+                    OrkAssert(0 == (inumidx % 3));
+                    vertex_ptr_t vertexcache[3];
+                    for (int ii = 0; ii < inumidx; ii++) {
+                      U16 uidx                      = pidx16[ii];
+                      const auto& InVtx             = *(const lev2::SVtxV8N4B4T8*)(ptypedsource + stride * uidx);
+                      vertex ToolVertex;
+                      ToolVertex.mPos                = fvec3_to_dvec3(quantizer.decode(InVtx.mPosition));
+                      ToolVertex.mNrm                = fvec3_to_dvec3(octDecode(InVtx.mNormal[0], InVtx.mNormal[1]));
+                      ToolVertex.mUV[0].mMapBiNormal = octDecode(InVtx.mBiNormal[0], InVtx.mBiNormal[1]);
+                      ToolVertex.mUV[0].mMapTexCoord = fvec2(halfToFloat(InVtx.mUV0[0]), halfToFloat(InVtx.mUV0[1]));
+                      ToolVertex.mCol[0]             = fcolor4::White();
+                      vertexcache[(ii % 3)]          = outsub.mergeVertex(ToolVertex);
+                      if (2 == (ii % 3)) {
+                        Polygon ToolPoly(vertexcache[0], vertexcache[1], vertexcache[2]);
+                        outsub.mergePoly(ToolPoly);
+                      }
+                    }
+                    break;
+                  }
+                  //////////////////////////////////////////////////////////////////
                   case lev2::EVtxStreamFormat::V12N12T16C4: {
                     printf( "V12N12T16C4\n");
                     auto ptypedsource = (const lev2::SVtxV12N12T16C4*)pvertbase;
@@ -0,0 +1,399 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/math/plane.hpp>
+#include <ork/lev2/gfx/meshutil/submesh.h>
+#include <ork/lev2/gfx/meshutil/meshutil.h>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <queue>
+
+///////////////////////////////////////////////////////////////////////////////
+// quadric error metric simplification (Garland/Heckbert)
+//
+//  half edge collapses only : a vertex is merged into one of its neighbors,
+//   so every surviving vertex keeps its exact attributes (normals, uvs,
+//   colors, skin weights). no new vertices are ever generated.
+//
+//  locked (never removed, but may be collapsed into) :
+//   - attribute seams (more than one pool vertex at a position)
+//   - open borders and non manifold edges
+//   - vertices of non triangle polys (those are passed through)
+///////////////////////////////////////////////////////////////////////////////
+
+namespace ork::meshutil {
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Quadric {
+
+  void addPlane(const dvec3& n, double d, double w) {
+    _a2 += w * n.x * n.x;
+    _ab += w * n.x * n.y;
+    _ac += w * n.x * n.z;
+    _ad += w * n.x * d;
+    _b2 += w * n.y * n.y;
+    _bc += w * n.y * n.z;
+    _bd += w * n.y * d;
+    _c2 += w * n.z * n.z;
+    _cd += w * n.z * d;
+    _d2 += w * d * d;
+  }
+  void add(const Quadric& o) {
+    _a2 += o._a2;
+    _ab += o._ab;
+    _ac += o._ac;
+    _ad += o._ad;
+    _b2 += o._b2;
+    _bc += o._bc;
+    _bd += o._bd;
+    _c2 += o._c2;
+    _cd += o._cd;
+    _d2 += o._d2;
+  }
+  // sum of weighted squared distances from p to the accumulated planes
+  double evaluate(const dvec3& p) const {
+    double x = p.x, y = p.y, z = p.z;
+    double r = _a2 * x * x + 2.0 * _ab * x * y + 2.0 * _ac * x * z + 2.0 * _ad * x //
+               + _b2 * y * y + 2.0 * _bc * y * z + 2.0 * _bd * y                   //
+               + _c2 * z * z + 2.0 * _cd * z + _d2;
+    return std::max(r, 0.0);
+  }
+
+  double _a2 = 0.0, _ab = 0.0, _ac = 0.0, _ad = 0.0;
+  double _b2 = 0.0, _bc = 0.0, _bd = 0.0;
+  double _c2 = 0.0, _cd = 0.0, _d2 = 0.0;
+};
+
+struct Collapse {
+  double _cost      = 0.0;
+  uint32_t _source  = 0;
+  uint32_t _target  = 0;
+  uint32_t _version = 0;
+  bool operator<(const Collapse& rhs) const { // min heap
+    return _cost > rhs._cost;
+  }
+};
+
+// L1 distance between two skin influence sets (0 : identical, 2 : disjoint)
+double _influenceDistance(const vertex& a, const vertex& b) {
+  if (a.miNumWeights == 0 and b.miNumWeights == 0)
+    return 0.0;
+  double rval = 0.0;
+  for (int i = 0; i < a.miNumWeights; i++) {
+    double wb = 0.0;
+    for (int j = 0; j < b.miNumWeights; j++) {
+      if (a._jointpaths[i] == b._jointpaths[j])
+        wb = b.mJointWeights[j];
+    }
+    rval += fabs(a.mJointWeights[i] - wb);
+  }
+  for (int j = 0; j < b.miNumWeights; j++) {
+    bool found = false;
+    for (int i = 0; i < a.miNumWeights; i++)
+      found |= (a._jointpaths[i] == b._jointpaths[j]);
+    if (not found)
+      rval += b.mJointWeights[j];
+  }
+  return rval;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+void submeshSimplify(const submesh& inpsubmesh, submesh& outsubmesh, float target_ratio, double max_error) {
+
+  constexpr double kSKINPENALTY   = 1.0; // scaled by squared edge length
+  constexpr double kNORMALPENALTY = 0.5; // scaled by squared edge length
+  constexpr double kMINFLIPDOT    = 0.2; // reject collapses which tilt a face more than ~78 degrees
+
+  size_t numverts = inpsubmesh.numVertices();
+  std::vector<vertex_ptr_t> vertices(numverts);
+  for (size_t iv = 0; iv < numverts; iv++)
+    vertices[iv] = inpsubmesh.vertex(int(iv));
+
+  std::vector<uint32_t> tris;
+  std::vector<std::vector<uint32_t>> passthru;
+  inpsubmesh.visitAllPolys([&](merged_poly_const_ptr_t p) {
+    if (p->numVertices() == 3) {
+      for (int k = 0; k < 3; k++)
+        tris.push_back(uint32_t(p->vertexID(k)));
+    } else {
+      std::vector<uint32_t> poly;
+      for (size_t k = 0; k < p->numVertices(); k++)
+        poly.push_back(uint32_t(p->vertexID(int(k))));
+      passthru.push_back(poly);
+    }
+  });
+  size_t numtris = tris.size() / 3;
+
+  /////////////////////////////////////////
+  // weld positions, attribute seams are positions with > 1 pool vertex
+  /////////////////////////////////////////
+
+  std::map<std::array<double, 3>, uint32_t> poslut;
+  std::vector<uint32_t> posid(numverts);
+  std::vector<uint32_t> numsiblings;
+  for (size_t iv = 0; iv < numverts; iv++) {
+    const auto& p = vertices[iv]->mPos;
+    auto it       = poslut.find({p.x, p.y, p.z});
+    if (it == poslut.end()) {
+      it = poslut.insert({{p.x, p.y, p.z}, uint32_t(numsiblings.size())}).first;
+      numsiblings.push_back(0);
+    }
+    posid[iv] = it->second;
+    numsiblings[it->second]++;
+  }
+  size_t numpos = numsiblings.size();
+
+  /////////////////////////////////////////
+  // locks, quadrics, adjacency
+  /////////////////////////////////////////
+
+  std::vector<bool> locked(numverts, false);
+  for (size_t iv = 0; iv < numverts; iv++)
+    locked[iv] = numsiblings[posid[iv]] > 1;
+  for (const auto& poly : passthru)
+    for (auto iv : poly)
+      locked[iv] = true;
+
+  std::map<std::pair<uint32_t, uint32_t>, int> posedges;
+  std::vector<Quadric> quadrics(numpos);
+  std::vector<std::vector<uint32_t>> vtxtris(numverts);
+  for (size_t t = 0; t < numtris; t++) {
+    const uint32_t* tri = &tris[t * 3];
+    for (int k = 0; k < 3; k++) {
+      uint32_t pa = posid[tri[k]];
+      uint32_t pb = posid[tri[(k + 1) % 3]];
+      posedges[{std::min(pa, pb), std::max(pa, pb)}]++;
+      vtxtris[tri[k]].push_back(uint32_t(t));
+    }
+    const auto& p0 = vertices[tri[0]]->mPos;
+    dvec3 n        = (vertices[tri[1]]->mPos - p0).crossWith(vertices[tri[2]]->mPos - p0);
+    double len     = n.magnitude();
+    if (len <= 0.0)
+      continue;
+    n = n * (1.0 / len);
+    for (int k = 0; k < 3; k++)
+      quadrics[posid[tri[k]]].addPlane(n, -n.dotWith(p0), len * 0.5);
+  }
+  std::vector<bool> poslocked(numpos, false);
+  for (const auto& item : posedges) {
+    if (item.second != 2) { // border or non manifold
+      poslocked[item.first.first]  = true;
+      poslocked[item.first.second] = true;
+    }
+  }
+  for (size_t iv = 0; iv < numverts; iv++)
+    locked[iv] = locked[iv] or poslocked[posid[iv]];
+
+  /////////////////////////////////////////
+
+  std::vector<bool> tridead(numtris, false);
+  auto triContains = [&](uint32_t t, uint32_t v) -> bool {
+    return tris[t * 3 + 0] == v or tris[t * 3 + 1] == v or tris[t * 3 + 2] == v;
+  };
+  auto faceNormal = [&](const dvec3& p0, const dvec3& p1, const dvec3& p2) -> dvec3 { //
+    return (p1 - p0).crossWith(p2 - p0);
+  };
+
+  /////////////////////////////////////////
+  // collapse source into target, cost or -1 if not allowed
+  /////////////////////////////////////////
+
+  auto evaluateCollapse = [&](uint32_t source, uint32_t target) -> double {
+    const auto& ptarget = vertices[target]->mPos;
+    const auto& psource = vertices[source]->mPos;
+    uint32_t tpos       = posid[target];
+    size_t numshared    = 0;
+    std::vector<uint32_t> ring_s, ring_t;
+    for (auto t : vtxtris[source]) {
+      const uint32_t* tri = &tris[t * 3];
+      bool has_tpos       = false;
+      for (int k = 0; k < 3; k++) {
+        if (posid[tri[k]] == tpos) {
+          // the source side of the edge must agree on the target's attributes
+          if (tri[k] != target)
+            return -1.0;
+          has_tpos = true;
+        }
+        if (tri[k] != source)
+          ring_s.push_back(posid[tri[k]]);
+      }
+      if (has_tpos) {
+        numshared++;
+        continue; // this triangle goes away
+      }
+      // flip / sliver test on the surviving triangles
+      dvec3 p[3];
+      for (int k = 0; k < 3; k++)
+        p[k] = vertices[tri[k]]->mPos;
+      dvec3 before = faceNormal(p[0], p[1], p[2]);
+      for (int k = 0; k < 3; k++)
+        if (tri[k] == source)
+          p[k] = ptarget;
+      dvec3 after  = faceNormal(p[0], p[1], p[2]);
+      double lenb  = before.magnitude();
+      double lena  = after.magnitude();
+      if (lena <= 1.0e-12 * std::max(lenb, 1.0e-30))
+        return -1.0;
+      if (lenb > 0.0 and before.dotWith(after) < kMINFLIPDOT * lena * lenb)
+        return -1.0;
+    }
+    if (numshared == 0)
+      return -1.0;
+    // link condition : the only common neighbors are the shared triangles' apexes
+    for (auto t : vtxtris[target]) {
+      const uint32_t* tri = &tris[t * 3];
+      for (int k = 0; k < 3; k++)
+        if (tri[k] != target)
+          ring_t.push_back(posid[tri[k]]);
+    }
+    std::sort(ring_s.begin(), ring_s.end());
+    ring_s.erase(std::unique(ring_s.begin(), ring_s.end()), ring_s.end());
+    std::sort(ring_t.begin(), ring_t.end());
+    ring_t.erase(std::unique(ring_t.begin(), ring_t.end()), ring_t.end());
+    size_t numcommon = 0;
+    for (auto p : ring_s)
+      if (p != tpos and p != posid[source] and std::binary_search(ring_t.begin(), ring_t.end(), p))
+        numcommon++;
+    if (numcommon > numshared)
+      return -1.0;
+    /////////////////////////////////////////
+    double edgelen2 = (ptarget - psource).magnitudeSquared();
+    double cost     = quadrics[posid[source]].evaluate(ptarget);
+    cost += kSKINPENALTY * edgelen2 * _influenceDistance(*vertices[source], *vertices[target]);
+    dvec3 ns = vertices[source]->mNrm;
+    dvec3 nt = vertices[target]->mNrm;
+    if (ns.magnitude() > 0.0 and nt.magnitude() > 0.0)
+      cost += kNORMALPENALTY * edgelen2 * (1.0 - ns.normalized().dotWith(nt.normalized()));
+    return cost;
+  };
+
+  /////////////////////////////////////////
+
+  std::vector<uint32_t> versions(numverts, 0);
+  std::vector<bool> vtxdead(numverts, false);
+  std::priority_queue<Collapse> heap;
+
+  auto scheduleVertex = [&](uint32_t source) {
+    versions[source]++;
+    if (locked[source] or vtxdead[source])
+      return;
+    Collapse best;
+    best._cost = -1.0;
+    for (auto t : vtxtris[source]) {
+      for (int k = 0; k < 3; k++) {
+        uint32_t target = tris[t * 3 + k];
+        if (target == source)
+          continue;
+        double cost = evaluateCollapse(source, target);
+        if (cost >= 0.0 and (best._cost < 0.0 or cost < best._cost)) {
+          best._cost   = cost;
+          best._target = target;
+        }
+      }
+    }
+    if (best._cost < 0.0)
+      return;
+    best._source  = source;
+    best._version = versions[source];
+    heap.push(best);
+  };
+
+  for (size_t iv = 0; iv < numverts; iv++)
+    scheduleVertex(uint32_t(iv));
+
+  /////////////////////////////////////////
+  // collapse cheapest first
+  /////////////////////////////////////////
+
+  size_t target_tris = size_t(double(numtris) * std::clamp(double(target_ratio), 0.0, 1.0));
+  size_t live_tris   = numtris;
+  while (live_tris > target_tris and not heap.empty()) {
+    auto collapse = heap.top();
+    heap.pop();
+    uint32_t source = collapse._source;
+    uint32_t target = collapse._target;
+    if (collapse._version != versions[source] or vtxdead[source] or vtxdead[target])
+      continue;
+    if (max_error > 0.0 and collapse._cost > max_error)
+      break;
+    // neighborhood may have changed since scheduling
+    if (evaluateCollapse(source, target) < 0.0) {
+      scheduleVertex(source);
+      continue;
+    }
+    ///////////////////////////////
+    std::vector<uint32_t> touched;
+    for (auto t : vtxtris[source]) {
+      uint32_t* tri = &tris[t * 3];
+      if (triContains(t, target)) {
+        tridead[t] = true;
+        live_tris--;
+        for (int k = 0; k < 3; k++) {
+          auto& adj = vtxtris[tri[k]];
+          if (tri[k] != source)
+            adj.erase(std::remove(adj.begin(), adj.end(), t), adj.end());
+        }
+      } else {
+        for (int k = 0; k < 3; k++)
+          if (tri[k] == source)
+            tri[k] = target;
+        vtxtris[target].push_back(t);
+      }
+    }
+    vtxtris[source].clear();
+    vtxdead[source] = true;
+    quadrics[posid[target]].add(quadrics[posid[source]]);
+    ///////////////////////////////
+    // rescore the new one ring (and its neighbors' view of it)
+    for (auto t : vtxtris[target])
+      for (int k = 0; k < 3; k++)
+        touched.push_back(tris[t * 3 + k]);
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (auto v : touched)
+      scheduleVertex(v);
+  }
+
+  /////////////////////////////////////////
+  // emit (surviving vertices keep pool order)
+  /////////////////////////////////////////
+
+  std::vector<bool> used(numverts, false);
+  for (size_t t = 0; t < numtris; t++)
+    if (not tridead[t])
+      for (int k = 0; k < 3; k++)
+        used[tris[t * 3 + k]] = true;
+  for (const auto& poly : passthru)
+    for (auto iv : poly)
+      used[iv] = true;
+  std::vector<vertex_ptr_t> merged(numverts);
+  for (size_t iv = 0; iv < numverts; iv++)
+    if (used[iv])
+      merged[iv] = outsubmesh.mergeVertex(*vertices[iv]);
+  for (size_t t = 0; t < numtris; t++) {
+    if (tridead[t])
+      continue;
+    const uint32_t* tri = &tris[t * 3];
+    outsubmesh.mergePoly(Polygon(merged[tri[0]], merged[tri[1]], merged[tri[2]]));
+  }
+  for (const auto& poly : passthru) {
+    std::vector<vertex_ptr_t> polyverts;
+    for (auto iv : poly)
+      polyverts.push_back(merged[iv]);
+    outsubmesh.mergePoly(polyverts);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::meshutil
+///////////////////////////////////////////////////////////////////////////////
@@ -82,35 +82,94 @@ vertexpool::vertexpool() {
 ///////////////////////////////////////////////////////////////////////////////
 
 vertex_ptr_t vertexpool::mergeVertex(const vertex& vtx) {
-  vertex_ptr_t rval;
-  U64 vhash = vtx.hash();
-  auto it   = _vtxmap.find(vhash);
-  if (_vtxmap.end() != it) {
-    rval = it->second;
-  } else {
-    rval             = std::make_shared<vertex>(vtx);
-    rval->_poolindex = uint32_t(_orderedVertices.size());
-    _orderedVertices.push_back(rval);
-    _vtxmap[vhash] = rval;
-  }
+  U64 vhash      = vtx.hash();
+  uint32_t index = _weldtable.find(vhash);
+  if (index != VertexWeldTable::kEMPTY)
+    return _orderedVertices[index];
+  auto rval        = std::make_shared<vertex>(vtx);
+  rval->_poolindex = uint32_t(_orderedVertices.size());
+  _orderedVertices.push_back(rval);
+  _weldtable.insert(vhash, rval->_poolindex);
   return rval;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void vertexpool::rehash(){
-  //auto copy_of_ordered = _orderedVertices;
-  //_orderedVertices.clear();
-  _vtxmap.clear();
+  _weldtable.clear();
+  _weldtable.reserve(_orderedVertices.size());
   for( auto v : _orderedVertices ){
     uint64_t h = v->hash();
-    auto it = _vtxmap.find(h);
-    OrkAssert(it==_vtxmap.end());
-    _vtxmap[h] = v;
+    OrkAssert(_weldtable.find(h)==VertexWeldTable::kEMPTY);
+    _weldtable.insert(h,v->_poolindex);
   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static inline size_t _weldSlot(uint64_t hash) {
+  return size_t(hash ^ (hash >> 29));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t VertexWeldTable::find(uint64_t hash) const {
+  if (_count == 0)
+    return kEMPTY;
+  for (size_t slot = _weldSlot(hash) & _mask;; slot = (slot + 1) & _mask) {
+    uint32_t index = _indices[slot];
+    if (index == kEMPTY)
+      return kEMPTY;
+    if (_hashes[slot] == hash)
+      return index;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
+void VertexWeldTable::insert(uint64_t hash, uint32_t index) {
+  // keep load factor <= 1/2
+  if (((_count + 1) * 2) > _indices.size())
+    _resize(std::max(size_t(64), _indices.size() * 2));
+  size_t slot = _weldSlot(hash) & _mask;
+  while (_indices[slot] != kEMPTY)
+    slot = (slot + 1) & _mask;
+  _hashes[slot]  = hash;
+  _indices[slot] = index;
+  _count++;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+void VertexWeldTable::reserve(size_t count) {
+  size_t capacity = 64;
+  while (capacity < (count * 2))
+    capacity <<= 1;
+  if (capacity > _indices.size())
+    _resize(capacity);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VertexWeldTable::clear() {
+  std::fill(_indices.begin(), _indices.end(), kEMPTY);
+  _count = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VertexWeldTable::_resize(size_t capacity) {
+  auto old_hashes  = std::move(_hashes);
+  auto old_indices = std::move(_indices);
+  _hashes.assign(capacity, 0);
+  _indices.assign(capacity, kEMPTY);
+  _mask  = capacity - 1;
+  _count = 0;
+  for (size_t i = 0; i < old_indices.size(); i++) {
+    if (old_indices[i] != kEMPTY)
+      insert(old_hashes[i], old_indices[i]);
+  }
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 }} // namespace ork::meshutil
@@ -43,6 +43,18 @@ int XgmModel::meshIndex(const PoolString& name) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+int XgmModel::selectLod(float screen_size) const {
+  int lod = 0;
+  for (float threshold : _lodScreenSizes) {
+    if (screen_size >= threshold)
+      break;
+    lod++;
+  }
+  return lod;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 XgmModelInst::XgmModelInst(const XgmModel* Model)
     : mXgmModel(Model)
     , mMaterialStateInst(*this)
@@ -166,6 +166,7 @@ bool XgmModel::_loaderSelect(XgmModel* mdl, datablock_ptr_t datablock) {
   if (check_magic.muVal32 == 0x736d656f) { // its encrypted
     printf("aaa: decrypting datablock hash<%zx> length<%zu>\n", datablock->hash(), datablock->length());
     uint32_t codecID = datablockstream.getItem<uint32_t>();
+    datablock->materialize();
     auto& storage    = datablock->_storage;
     storage.erase(storage.begin(), storage.begin() + 8);
     printf("aaa: decrypting datablock rehash<%zx> relength<%zu>\n", datablock->hash(), datablock->length());
@@ -189,7 +190,7 @@ bool XgmModel::_loadAssimp(XgmModel* mdl, datablock_ptr_t inp_datablock) {
   auto basehasher = DataBlock::createHasher();
   basehasher->accumulateString("assimp2xgm");
 
-  basehasher->accumulateString("version-x042423");
+  basehasher->accumulateString("version-x101927");
 
   inp_datablock->accumlateHash(basehasher);
   /////////////////////////////////////
@@ -207,6 +208,10 @@ bool XgmModel::_loadAssimp(XgmModel* mdl, datablock_ptr_t inp_datablock) {
       basehasher->accumulateItem<bool>(as_bool.value());
     } else if (auto as_dbl = v.tryAs<double>()) {
       basehasher->accumulateItem<double>(as_dbl.value());
+    } else if (auto as_flt = v.tryAs<float>()) {
+      basehasher->accumulateItem<float>(as_flt.value());
+    } else if (auto as_int = v.tryAs<int>()) {
+      basehasher->accumulateItem<int>(as_int.value());
     } else {
       //OrkAssert(false);
     }
@@ -220,6 +225,18 @@ bool XgmModel::_loadAssimp(XgmModel* mdl, datablock_ptr_t inp_datablock) {
   }
   logchan_mioR->log("xgm_datablock<%p>", (void*)xgm_datablock.get());
   if (not xgm_datablock) {
+    // writer options travel with the source datablock
+    for (auto key : {"xgm.quantize_vertices", "xgm.optimize_indices"}) {
+      if (auto try_opt = mdl->_varmap.typedValueForKey<bool>(key)) {
+        inp_datablock->_vars->makeValueForKey<bool>(key) = try_opt.value();
+      }
+    }
+    if (auto try_count = mdl->_varmap.tryKeyAsInteger("xgm.lod_count")) {
+      inp_datablock->_vars->makeValueForKey<int>("xgm.lod_count") = try_count.value();
+    }
+    if (auto try_ratio = mdl->_varmap.tryKeyAsNumber("xgm.lod_ratio")) {
+      inp_datablock->_vars->makeValueForKey<float>("xgm.lod_ratio") = try_ratio.value();
+    }
     xgm_datablock = meshutil::assimpToXgm(inp_datablock);
     DataBlockCache::setDataBlock(hashkey, xgm_datablock);
   }
@@ -245,7 +262,7 @@ datablock_ptr_t writeXgmToDatablock(const lev2::XgmModel* mdl) {
   ///////////////////////////////////
   // write out new VERSION code
   int32_t iVERSIONTAG = 0x01234567;
-  int32_t iVERSION    = 1;
+  int32_t iVERSION    = 3; // 2 : LOD section after meshes, 3 : meshlets per cluster
   HeaderStream->AddItem(iVERSIONTAG);
   HeaderStream->AddItem(iVERSION);
   logchan_mioW->log("WriteXgm: VERSION<%d>", iVERSION);
@@ -421,6 +438,122 @@ datablock_ptr_t writeXgmToDatablock(const lev2::XgmModel* mdl) {
     }
   }
 
+  ///////////////////////////////////////////////////////////////////////////////////////////
+  // cluster writer (LOD 0 and the LOD section)
+  ///////////////////////////////////////////////////////////////////////////////////////////
+
+  auto write_cluster = [&](lev2::xgmcluster_ptr_t cluster, int32_t ic) {
+    auto VB                   = cluster->_vertexBuffer;
+    const Sphere& clus_sphere = cluster->mBoundingSphere;
+    const AABox& clus_box     = cluster->mBoundingBox;
+
+    if (VB->GetNumVertices() == 0)
+      return;
+
+    int32_t inumpg = cluster->numPrimGroups();
+    int32_t inumjb = (int)cluster->numJointBindings();
+
+    logchan_mioW->log("VB<%p> NumVerts<%d>", (void*)VB.get(), VB->GetNumVertices());
+    logchan_mioW->log("clus<%d> numjb<%d>", ic, inumjb);
+
+    int32_t ivbufoffset = ModelDataStream->GetSize();
+    const u8* VBdata    = (const u8*)DummyTarget.GBI()->LockVB(*VB);
+    OrkAssert(VBdata != 0);
+    {
+
+      int VBlen = VB->GetNumVertices() * VB->GetVtxSize();
+
+      logchan_mioW->log("WriteVB VB<%p> NumVerts<%d> VtxSize<%d>", (void*)VB.get(), VB->GetNumVertices(), VB->GetVtxSize());
+
+      HeaderStream->AddItem(ic);
+      HeaderStream->AddItem(inumpg);
+      HeaderStream->AddItem(inumjb);
+      HeaderStream->AddItem<lev2::EVtxStreamFormat>(VB->GetStreamFormat());
+      HeaderStream->AddItem(ivbufoffset);
+      HeaderStream->AddItem(VB->GetNumVertices());
+      HeaderStream->AddItem(VB->GetVtxSize());
+
+      HeaderStream->AddItem(clus_box.Min());
+      HeaderStream->AddItem(clus_box.Max());
+
+      // VBNC->EndianSwap();
+
+      ModelDataStream->Write(VBdata, VBlen);
+    }
+    DummyTarget.GBI()->UnLockVB(*VB);
+
+    for (int32_t ipg = 0; ipg < inumpg; ipg++) {
+      auto PG = cluster->primgroup(ipg);
+
+      int32_t inumidx = PG->GetNumIndices();
+
+      logchan_mioW->log("WritePG<%d> NumIndices<%d>", ipg, inumidx);
+
+      HeaderStream->AddItem(ipg);
+      HeaderStream->AddItem<PrimitiveType>(PG->GetPrimType());
+      HeaderStream->AddItem<int32_t>(inumidx);
+      HeaderStream->AddItem<int32_t>(ModelDataStream->GetSize());
+
+      //////////////////////////////////////////////////
+      U16* pidx = (U16*)DummyTarget.GBI()->LockIB(*PG->GetIndexBuffer()); //->GetDataPointer();
+      OrkAssert(pidx != 0);
+      for (int32_t ii = 0; ii < inumidx; ii++) {
+        int32_t iv = int32_t(pidx[ii]);
+        if (iv >= VB->GetNumVertices()) {
+          logchan_mioW->log("index id<%d> val<%d> is > vertex count<%d>", ii, iv, VB->GetNumVertices());
+        }
+        OrkAssert(iv < VB->GetNumVertices());
+
+        // swapbytes_dynamic<U16>( pidx[ii] );
+      }
+      DummyTarget.GBI()->UnLockIB(*PG->GetIndexBuffer());
+      //////////////////////////////////////////////////
+
+      ModelDataStream->Write((const unsigned char*)pidx, inumidx * sizeof(U16));
+    }
+    // write cluster bindings
+    for (int32_t ij = 0; ij < inumjb; ij++) {
+      const std::string& bound_path = cluster->jointBinding(ij);
+      OrkAssert(bound_path != "");
+      HeaderStream->AddItem(ij);
+      istring = chunkwriter.stringIndex(bound_path.c_str());
+      logchan_mioW->log("bound_path<%s> istring<%d>", bound_path.c_str(), istring);
+      HeaderStream->AddItem(istring);
+    }
+    // meshlets (v3) : bounds in the header, index data in modeldata
+    int32_t inummeshlets = int32_t(cluster->_meshlets.size());
+    HeaderStream->AddItem(inummeshlets);
+    for (const auto& meshlet : cluster->_meshlets) {
+      HeaderStream->AddItem<int32_t>(int32_t(meshlet._vertices.size()));
+      HeaderStream->AddItem<int32_t>(int32_t(meshlet._triangles.size()));
+      HeaderStream->AddItem<int32_t>(ModelDataStream->GetSize());
+      HeaderStream->AddItem(meshlet._center);
+      HeaderStream->AddItem(meshlet._radius);
+      HeaderStream->AddItem(meshlet._coneApex);
+      HeaderStream->AddItem(meshlet._coneAxis);
+      HeaderStream->AddItem(meshlet._coneCutoff);
+      ModelDataStream->Write((const unsigned char*)meshlet._vertices.data(), meshlet._vertices.size() * sizeof(uint32_t));
+      ModelDataStream->Write(meshlet._triangles.data(), meshlet._triangles.size());
+    }
+  };
+
+  auto count_enabled_clusters = [&](const lev2::xgmcluster_ptr_list_t& clusters, material_ptr_t pmat) -> int32_t {
+    int32_t inumenabledclus = 0;
+    for (size_t ic = 0; ic < clusters.size(); ic++) {
+      auto VB = clusters[ic]->_vertexBuffer;
+      OrkAssert(VB);
+      if (VB->GetNumVertices() > 0) {
+        inumenabledclus++;
+      } else {
+        logchan_mioW->log(
+            "WARNING: material<%s> cluster<%zu> has a zero length vertex buffer, skipping",
+            pmat ? pmat->GetName().c_str() : "None",
+            ic);
+      }
+    }
+    return inumenabledclus;
+  };
+
   ///////////////////////////////////////////////////////////////////////////////////////////
   // meshes
   ///////////////////////////////////////////////////////////////////////////////////////////
@@ -468,83 +601,32 @@ datablock_ptr_t writeXgmToDatablock(const lev2::XgmModel* mdl) {
       HeaderStream->AddItem(istring);
       ////////////////////////////////////////////////////////////
       for (int32_t ic = 0; ic < inumclus; ic++) {
-        auto cluster              = xgm_sub_mesh.cluster(ic);
-        auto VB                   = cluster->_vertexBuffer;
-        const Sphere& clus_sphere = cluster->mBoundingSphere;
-        const AABox& clus_box     = cluster->mBoundingBox;
-
-        if (VB->GetNumVertices() == 0)
-          continue;
-
-        int32_t inumpg = cluster->numPrimGroups();
-        int32_t inumjb = (int)cluster->numJointBindings();
-
-        logchan_mioW->log("VB<%p> NumVerts<%d>", (void*)VB.get(), VB->GetNumVertices());
-        logchan_mioW->log("clus<%d> numjb<%d>", ic, inumjb);
-
-        int32_t ivbufoffset = ModelDataStream->GetSize();
-        const u8* VBdata    = (const u8*)DummyTarget.GBI()->LockVB(*VB);
-        OrkAssert(VBdata != 0);
-        {
-
-          int VBlen = VB->GetNumVertices() * VB->GetVtxSize();
-
-          logchan_mioW->log("WriteVB VB<%p> NumVerts<%d> VtxSize<%d>", (void*)VB.get(), VB->GetNumVertices(), VB->GetVtxSize());
-
-          HeaderStream->AddItem(ic);
-          HeaderStream->AddItem(inumpg);
-          HeaderStream->AddItem(inumjb);
-          HeaderStream->AddItem<lev2::EVtxStreamFormat>(VB->GetStreamFormat());
-          HeaderStream->AddItem(ivbufoffset);
-          HeaderStream->AddItem(VB->GetNumVertices());
-          HeaderStream->AddItem(VB->GetVtxSize());
-
-          HeaderStream->AddItem(clus_box.Min());
-          HeaderStream->AddItem(clus_box.Max());
-
-          // VBNC->EndianSwap();
-
-          ModelDataStream->Write(VBdata, VBlen);
-        }
-        DummyTarget.GBI()->UnLockVB(*VB);
-
-        for (int32_t ipg = 0; ipg < inumpg; ipg++) {
-          auto PG = cluster->primgroup(ipg);
-
-          int32_t inumidx = PG->GetNumIndices();
-
-          logchan_mioW->log("WritePG<%d> NumIndices<%d>", ipg, inumidx);
-
-          HeaderStream->AddItem(ipg);
-          HeaderStream->AddItem<PrimitiveType>(PG->GetPrimType());
-          HeaderStream->AddItem<int32_t>(inumidx);
-          HeaderStream->AddItem<int32_t>(ModelDataStream->GetSize());
-
-          //////////////////////////////////////////////////
-          U16* pidx = (U16*)DummyTarget.GBI()->LockIB(*PG->GetIndexBuffer()); //->GetDataPointer();
-          OrkAssert(pidx != 0);
-          for (int32_t ii = 0; ii < inumidx; ii++) {
-            int32_t iv = int32_t(pidx[ii]);
-            if (iv >= VB->GetNumVertices()) {
-              logchan_mioW->log("index id<%d> val<%d> is > vertex count<%d>", ii, iv, VB->GetNumVertices());
-            }
-            OrkAssert(iv < VB->GetNumVertices());
-
-            // swapbytes_dynamic<U16>( pidx[ii] );
-          }
-          DummyTarget.GBI()->UnLockIB(*PG->GetIndexBuffer());
-          //////////////////////////////////////////////////
-
-          ModelDataStream->Write((const unsigned char*)pidx, inumidx * sizeof(U16));
-        }
-        // write cluster bindings
-        for (int32_t ij = 0; ij < inumjb; ij++) {
-          const std::string& bound_path = cluster->jointBinding(ij);
-          OrkAssert(bound_path != "");
-          HeaderStream->AddItem(ij);
-          istring = chunkwriter.stringIndex(bound_path.c_str());
-          logchan_mioW->log("bound_path<%s> istring<%d>", bound_path.c_str(), istring);
-          HeaderStream->AddItem(istring);
+        write_cluster(xgm_sub_mesh.cluster(ic), ic);
+      }
+    }
+  }
+  ///////////////////////////////////////////////////////////////////////////////////////////
+  // LODs (v2)
+  //  numlods, then one screen size threshold per LOD past 0,
+  //  then per LOD / mesh / submesh (in the order above) : numenaclus + clusters
+  ///////////////////////////////////////////////////////////////////////////////////////////
+  int32_t inumlods = mdl->numLods();
+  HeaderStream->AddItem(inumlods);
+  for (int32_t ilod = 1; ilod < inumlods; ilod++) {
+    HeaderStream->AddItem<float>(mdl->_lodScreenSizes[ilod - 1]);
+  }
+  logchan_mioW->log("WriteXgm: numlods<%d>", inumlods);
+  for (int32_t ilod = 1; ilod < inumlods; ilod++) {
+    for (int32_t imesh = 0; imesh < inummeshes; imesh++) {
+      const lev2::XgmMesh& Mesh = *mdl->mesh(imesh);
+      for (int32_t ics = 0; ics < Mesh.numSubMeshes(); ics++) {
+        const lev2::XgmSubMesh& xgm_sub_mesh = *Mesh.subMesh(ics);
+        const auto& clusters                 = xgm_sub_mesh.lodClusters(ilod);
+        int32_t inumenabledclus              = count_enabled_clusters(clusters, xgm_sub_mesh.GetMaterial());
+        HeaderStream->AddItem(inumenabledclus);
+        logchan_mioW->log("WriteXgm:  lod<%d> mesh<%d> submesh<%d> numenaclus<%d>", ilod, imesh, ics, inumenabledclus);
+        for (int32_t ic = 0; ic < int32_t(clusters.size()); ic++) {
+          write_cluster(clusters[ic], ic);
         }
       }
     }
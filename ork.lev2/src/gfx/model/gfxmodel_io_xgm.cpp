@@ -1,6 +1,9 @@
 #include <boost/filesystem.hpp>
 #include <ork/lev2/gfx/gfxmodel.h>
 #include <ork/lev2/gfx/meshutil/meshutil.h>
+#include <ork/lev2/gfx/gfxvtxquant.h>
+#include <ork/lev2/gfx/raypick.h>
+#include <ork/kernel/datacache.h>
 #include <rapidjson/reader.h>
 #include <rapidjson/document.h>
 #include <ork/util/logger.h>
@@ -49,8 +52,8 @@ bool XgmModel::_loadXGM(XgmModel* mdl, datablock_ptr_t datablock) {
     /////////////////////////////////////////////////////////
     // test for version tag
     /////////////////////////////////////////////////////////
+    int XGMVERSIONCODE = 0;
     if (inumjoints == kVERSIONTAG) {
-      int XGMVERSIONCODE = 0;
       HeaderStream->GetItem(XGMVERSIONCODE);
       HeaderStream->GetItem(inumjoints);
     }
@@ -210,6 +213,12 @@ bool XgmModel::_loadXGM(XgmModel* mdl, datablock_ptr_t datablock) {
       override_map = try_override_map.value();
     }
 
+    ///////////////////////////////////
+    // xgm materials are gpuInit'd once the clusters are read,
+    //  quantized clusters need the dequantizing technique variants
+    ///////////////////////////////////
+    std::vector<material_ptr_t> pending_gpuinit;
+    std::set<material_ptr_t> quantized_materials;
     ///////////////////////////////////
     for (int imat = 0; imat < inummats; imat++) {
       int iimat = 0, imatname = 0, imatclass = 0;
@@ -253,7 +262,7 @@ bool XgmModel::_loadXGM(XgmModel* mdl, datablock_ptr_t datablock) {
           pmat->SetName(AddPooledString(pmatname));
           mdl->AddMaterial(pmat);
           //printf( "RUNREADER\n");
-          pmat->gpuInit(context);
+          pending_gpuinit.push_back(pmat);
         }
         ///////////////////////////////////////////////////////////
         // material class not supported in XGM
@@ -264,6 +273,180 @@ bool XgmModel::_loadXGM(XgmModel* mdl, datablock_ptr_t datablock) {
       }
     }
     ///////////////////////////////////
+    // CPU pick mesh (LOD 0 triangles + BVH)
+    //  keyed on the xgm content, built from the
+    //  clusters as they are read on a cache miss
+    ///////////////////////////////////
+    bool want_pickmesh = true;
+    if (auto try_pickmesh = mdl->_varmap.typedValueForKey<bool>("xgm.pickmesh")) {
+      want_pickmesh = try_pickmesh.value();
+    }
+    uint64_t pickmesh_hashkey = 0;
+    pickmesh_ptr_t pending_pickmesh;
+    if (want_pickmesh) {
+      auto hasher = DataBlock::createHasher();
+      hasher->accumulateString("xgm-pickmesh");
+      hasher->accumulateString("version-0");
+      datablock->accumlateHash(hasher);
+      hasher->finish();
+      pickmesh_hashkey = hasher->result();
+      auto pickmesh    = std::make_shared<PickMesh>();
+      auto cached      = DataBlockCache::findDataBlock(pickmesh_hashkey);
+      if (cached and pickmesh->deserialize(cached)) {
+        mdl->_pickMesh = pickmesh;
+      } else {
+        pending_pickmesh = pickmesh;
+      }
+    }
+    ///////////////////////////////////
+    // cluster reader (LOD 0 and the LOD section)
+    ///////////////////////////////////
+    auto read_cluster = [&](XgmSubMesh& xgm_sub_mesh, int ic, PickMesh* pickmesh) -> xgmcluster_ptr_t {
+      auto cluster = std::make_shared<XgmCluster>();
+      int iclusindex = -1;
+      int inumbb     = -1;
+      int ivboffset  = -1;
+      int ivbnum     = -1;
+      int ivbsize    = -1;
+      fvec3 boxmin, boxmax;
+      EVtxStreamFormat efmt;
+
+      ////////////////////////////////////////////////////////////////////////
+      HeaderStream->GetItem(iclusindex);
+      OrkAssert(ic == iclusindex);
+      int numprimgroups = 0;
+      HeaderStream->GetItem(numprimgroups);
+      HeaderStream->GetItem(inumbb);
+      HeaderStream->GetItem<EVtxStreamFormat>(efmt);
+      HeaderStream->GetItem(ivboffset);
+      HeaderStream->GetItem(ivbnum);
+      HeaderStream->GetItem(ivbsize);
+      HeaderStream->GetItem(boxmin);
+      HeaderStream->GetItem(boxmax);
+      ////////////////////////////////////////////////////////////////////////
+      cluster->mBoundingBox.SetMinMax(boxmin, boxmax);
+      cluster->mBoundingSphere = Sphere(boxmin, boxmax);
+      if (vtxquant::isQuantizedFormat(efmt) and xgm_sub_mesh._material) {
+        quantized_materials.insert(xgm_sub_mesh._material);
+      }
+      ////////////////////////////////////////////////////////////////////////
+      // logchan_mioRXGM->log( "XGMLOAD vbfmt<%s> efmt<%d>d, vbfmt, int(efmt) );
+      ////////////////////////////////////////////////////////////////////////
+      cluster->_vertexBuffer = VertexBufferBase::CreateVertexBuffer(efmt, ivbnum, true);
+      void* pverts           = (void*)(ModelDataStream->GetDataAt(ivboffset));
+      int ivblen             = ivbnum * ivbsize;
+      // logchan_mioRXGM->log("ReadVB NumVerts<%d> VtxSize<%d>d, ivbnum, pvb->GetVtxSize());
+      void* poutverts = context->GBI()->LockVB(*cluster->_vertexBuffer.get(), 0, ivbnum); // ivblen );
+      {
+
+        if( asset_load_req and asset_load_req->_on_event ){
+          asset_load_req->_on_event("beginCopyVertexBuffer"_crcu,nullptr);
+        }
+        memcpy_fast(poutverts, pverts, ivblen);
+        if( asset_load_req and asset_load_req->_on_event ){
+          asset_load_req->_on_event("endCopyVertexBuffer"_crcu,nullptr);
+        }
+        cluster->_vertexBuffer->SetNumVertices(ivbnum);
+        if (efmt == EVtxStreamFormat::V12N12B12T8I4W4) {
+          auto pv = (const SVtxV12N12B12T8I4W4*)pverts;
+          for (int iv = 0; iv < ivbnum; iv++) {
+            auto& v = pv[iv];
+            auto& p = v.mPosition;
+            auto& n = v.mNormal;
+            OrkAssert(n.length() > 0.95);
+            // logchan_mioRXGM->log( " iv<%d> pos<%f %f %f> bi<%08x> bw<%08x>d, iv, p.x, p.y, p.z, v.mBoneIndices,
+            // v.mBoneWeights );
+          }
+        }
+      }
+      context->GBI()->UnLockVB(*cluster->_vertexBuffer.get());
+      ////////////////////////////////////////////////////////////////////////
+      for (int32_t ipg = 0; ipg < numprimgroups; ipg++) {
+        auto newprimgroup = std::make_shared<XgmPrimGroup>();
+        cluster->_primgroups.push_back(newprimgroup);
+        int32_t ipgindex    = -1;
+        int32_t ipgprimtype = -1;
+        HeaderStream->GetItem<int32_t>(ipgindex);
+        OrkAssert(ipgindex == ipg);
+
+        HeaderStream->GetItem<PrimitiveType>(newprimgroup->mePrimType);
+        HeaderStream->GetItem<int32_t>(newprimgroup->miNumIndices);
+
+        int32_t idxdataoffset = -1;
+        HeaderStream->GetItem<int32_t>(idxdataoffset);
+
+        U16* pidx = (U16*)ModelDataStream->GetDataAt(idxdataoffset);
+
+        auto pidxbuf = new StaticIndexBuffer<U16>(newprimgroup->miNumIndices);
+
+        void* poutidx = (void*)context->GBI()->LockIB(*pidxbuf);
+        { memcpy_fast(poutidx, pidx, newprimgroup->miNumIndices * sizeof(U16)); }
+        context->GBI()->UnLockIB(*pidxbuf);
+
+        newprimgroup->mpIndices = pidxbuf;
+
+        if (pickmesh) {
+          pickmesh->addCluster(efmt, pverts, ivbnum, boxmin, boxmax, newprimgroup->mePrimType, pidx, newprimgroup->miNumIndices);
+        }
+      }
+      ////////////////////////////////////////////////////////////////////////
+      cluster->_jointPaths.resize(inumbb);
+      cluster->mJointSkelIndices.resize(inumbb);
+      for (int ib = 0; ib < inumbb; ib++) {
+        int ibindingindex = -1;
+        int ibindingname  = -1;
+
+        HeaderStream->GetItem(ibindingindex);
+        HeaderStream->GetItem(ibindingname);
+
+        const char* jointpath = chunkreader.GetString(ibindingname);
+        auto itfind           = mdl->_skeleton->_jointsByPath.find(jointpath);
+
+        if (itfind == mdl->_skeleton->_jointsByPath.end()) {
+          logerrchannel()->log("\n\ncannot find joint<%s> in:", jointpath);
+          for (auto it : mdl->_skeleton->_jointsByPath) {
+            logerrchannel()->log("  %s", it.first.c_str());
+          }
+          OrkAssert(false);
+        }
+        int iskelindex                 = (*itfind).second;
+        cluster->_jointPaths[ib]       = jointpath;
+        cluster->mJointSkelIndices[ib] = iskelindex;
+      }
+
+      mdl->mbSkinned |= (inumbb > 0);
+
+      ////////////////////////////////////////////////////////////////////////
+      // meshlets (v3)
+      ////////////////////////////////////////////////////////////////////////
+      if (XGMVERSIONCODE >= 3) {
+        int32_t inummeshlets = 0;
+        HeaderStream->GetItem(inummeshlets);
+        cluster->_meshlets.resize(inummeshlets);
+        for (auto& meshlet : cluster->_meshlets) {
+          int32_t inumverts = 0, inumtribytes = 0, idataoffset = -1;
+          HeaderStream->GetItem(inumverts);
+          HeaderStream->GetItem(inumtribytes);
+          HeaderStream->GetItem(idataoffset);
+          HeaderStream->GetItem(meshlet._center);
+          HeaderStream->GetItem(meshlet._radius);
+          HeaderStream->GetItem(meshlet._coneApex);
+          HeaderStream->GetItem(meshlet._coneAxis);
+          HeaderStream->GetItem(meshlet._coneCutoff);
+          auto pdata = (const uint8_t*)ModelDataStream->GetDataAt(idataoffset);
+          meshlet._vertices.resize(inumverts);
+          meshlet._triangles.resize(inumtribytes);
+          memcpy_fast(meshlet._vertices.data(), pdata, inumverts * sizeof(uint32_t));
+          memcpy_fast(meshlet._triangles.data(), pdata + inumverts * sizeof(uint32_t), inumtribytes);
+        }
+      }
+
+      // logchan_mioRXGM->log("mdl<%p> mbSkinned<%d>d, (void*) mdl, int(mdl->mbSkinned));
+      ////////////////////////////////////////////////////////////////////////
+      return cluster;
+    };
+    std::vector<xgmsubmesh_ptr_t> submeshes_in_file_order;
+    ///////////////////////////////////
     for (int imesh = 0; imesh < inummeshes; imesh++) {
       auto Mesh = std::make_shared<XgmMesh>();
 
@@ -292,6 +475,7 @@ bool XgmModel::_loadXGM(XgmModel* mdl, datablock_ptr_t datablock) {
 
         auto submesh = std::make_shared<XgmSubMesh>();
         Mesh->AddSubMesh(submesh);
+        submeshes_in_file_order.push_back(submesh);
         XgmSubMesh& xgm_sub_mesh = *submesh;
 
         int numclusters = 0;
@@ -310,118 +494,55 @@ bool XgmModel::_loadXGM(XgmModel* mdl, datablock_ptr_t datablock) {
         }
 
         for (int ic = 0; ic < numclusters; ic++) {
-          auto cluster = std::make_shared<XgmCluster>();
-          xgm_sub_mesh._clusters.push_back(cluster);
-          int iclusindex = -1;
-          int inumbb     = -1;
-          int ivboffset  = -1;
-          int ivbnum     = -1;
-          int ivbsize    = -1;
-          fvec3 boxmin, boxmax;
-          EVtxStreamFormat efmt;
-
-          ////////////////////////////////////////////////////////////////////////
-          HeaderStream->GetItem(iclusindex);
-          OrkAssert(ic == iclusindex);
-          int numprimgroups = 0;
-          HeaderStream->GetItem(numprimgroups);
-          HeaderStream->GetItem(inumbb);
-          HeaderStream->GetItem<EVtxStreamFormat>(efmt);
-          HeaderStream->GetItem(ivboffset);
-          HeaderStream->GetItem(ivbnum);
-          HeaderStream->GetItem(ivbsize);
-          HeaderStream->GetItem(boxmin);
-          HeaderStream->GetItem(boxmax);
-          ////////////////////////////////////////////////////////////////////////
-          cluster->mBoundingBox.SetMinMax(boxmin, boxmax);
-          cluster->mBoundingSphere = Sphere(boxmin, boxmax);
-          ////////////////////////////////////////////////////////////////////////
-          // logchan_mioRXGM->log( "XGMLOAD vbfmt<%s> efmt<%d>d, vbfmt, int(efmt) );
-          ////////////////////////////////////////////////////////////////////////
-          cluster->_vertexBuffer = VertexBufferBase::CreateVertexBuffer(efmt, ivbnum, true);
-          void* pverts           = (void*)(ModelDataStream->GetDataAt(ivboffset));
-          int ivblen             = ivbnum * ivbsize;
-          // logchan_mioRXGM->log("ReadVB NumVerts<%d> VtxSize<%d>d, ivbnum, pvb->GetVtxSize());
-          void* poutverts = context->GBI()->LockVB(*cluster->_vertexBuffer.get(), 0, ivbnum); // ivblen );
-          {
-
-            if( asset_load_req and asset_load_req->_on_event ){
-              asset_load_req->_on_event("beginCopyVertexBuffer"_crcu,nullptr);
-            }
-            memcpy_fast(poutverts, pverts, ivblen);
-            if( asset_load_req and asset_load_req->_on_event ){
-              asset_load_req->_on_event("endCopyVertexBuffer"_crcu,nullptr);
-            }
-            cluster->_vertexBuffer->SetNumVertices(ivbnum);
-            if (efmt == EVtxStreamFormat::V12N12B12T8I4W4) {
-              auto pv = (const SVtxV12N12B12T8I4W4*)pverts;
-              for (int iv = 0; iv < ivbnum; iv++) {
-                auto& v = pv[iv];
-                auto& p = v.mPosition;
-                auto& n = v.mNormal;
-                OrkAssert(n.length() > 0.95);
-                // logchan_mioRXGM->log( " iv<%d> pos<%f %f %f> bi<%08x> bw<%08x>d, iv, p.x, p.y, p.z, v.mBoneIndices,
-                // v.mBoneWeights );
-              }
-            }
-          }
-          context->GBI()->UnLockVB(*cluster->_vertexBuffer.get());
-          ////////////////////////////////////////////////////////////////////////
-          for (int32_t ipg = 0; ipg < numprimgroups; ipg++) {
-            auto newprimgroup = std::make_shared<XgmPrimGroup>();
-            cluster->_primgroups.push_back(newprimgroup);
-            int32_t ipgindex    = -1;
-            int32_t ipgprimtype = -1;
-            HeaderStream->GetItem<int32_t>(ipgindex);
-            OrkAssert(ipgindex == ipg);
-
-            HeaderStream->GetItem<PrimitiveType>(newprimgroup->mePrimType);
-            HeaderStream->GetItem<int32_t>(newprimgroup->miNumIndices);
-
-            int32_t idxdataoffset = -1;
-            HeaderStream->GetItem<int32_t>(idxdataoffset);
-
-            U16* pidx = (U16*)ModelDataStream->GetDataAt(idxdataoffset);
-
-            auto pidxbuf = new StaticIndexBuffer<U16>(newprimgroup->miNumIndices);
-
-            void* poutidx = (void*)context->GBI()->LockIB(*pidxbuf);
-            { memcpy_fast(poutidx, pidx, newprimgroup->miNumIndices * sizeof(U16)); }
-            context->GBI()->UnLockIB(*pidxbuf);
-
-            newprimgroup->mpIndices = pidxbuf;
-          }
-          ////////////////////////////////////////////////////////////////////////
-          cluster->_jointPaths.resize(inumbb);
-          cluster->mJointSkelIndices.resize(inumbb);
-          for (int ib = 0; ib < inumbb; ib++) {
-            int ibindingindex = -1;
-            int ibindingname  = -1;
-
-            HeaderStream->GetItem(ibindingindex);
-            HeaderStream->GetItem(ibindingname);
-
-            const char* jointpath = chunkreader.GetString(ibindingname);
-            auto itfind           = mdl->_skeleton->_jointsByPath.find(jointpath);
-
-            if (itfind == mdl->_skeleton->_jointsByPath.end()) {
-              logerrchannel()->log("\n\ncannot find joint<%s> in:", jointpath);
-              for (auto it : mdl->_skeleton->_jointsByPath) {
-                logerrchannel()->log("  %s", it.first.c_str());
-              }
-              OrkAssert(false);
-            }
-            int iskelindex                 = (*itfind).second;
-            cluster->_jointPaths[ib]       = jointpath;
-            cluster->mJointSkelIndices[ib] = iskelindex;
+          xgm_sub_mesh._clusters.push_back(read_cluster(xgm_sub_mesh, ic, pending_pickmesh.get()));
+        }
+      }
+    }
+    ///////////////////////////////////
+    // LODs (v2)
+    ///////////////////////////////////
+    if (XGMVERSIONCODE >= 2) {
+      int inumlods = 0;
+      HeaderStream->GetItem(inumlods);
+      mdl->_lodScreenSizes.resize(inumlods - 1);
+      for (int ilod = 1; ilod < inumlods; ilod++) {
+        HeaderStream->GetItem<float>(mdl->_lodScreenSizes[ilod - 1]);
+      }
+      for (int ilod = 1; ilod < inumlods; ilod++) {
+        for (auto submesh : submeshes_in_file_order) {
+          int numclusters = 0;
+          HeaderStream->GetItem(numclusters);
+          xgmcluster_ptr_list_t lod_clusters;
+          for (int ic = 0; ic < numclusters; ic++) {
+            lod_clusters.push_back(read_cluster(*submesh, ic, nullptr));
           }
-
-          mdl->mbSkinned |= (inumbb > 0);
-
-          // logchan_mioRXGM->log("mdl<%p> mbSkinned<%d>d, (void*) mdl, int(mdl->mbSkinned));
-          ////////////////////////////////////////////////////////////////////////
+          submesh->_lodClusters.push_back(lod_clusters);
         }
       }
+      logchan_mioRXGM->log("XGM: numlods<%d>", inumlods);
+    }
+    ///////////////////////////////////
+    if (pending_pickmesh) {
+      pending_pickmesh->build();
+      DataBlockCache::setDataBlock(pickmesh_hashkey, pending_pickmesh->serialize());
+      mdl->_pickMesh = pending_pickmesh;
+    }
+    if (mdl->_pickMesh) {
+      logchan_mioRXGM->log("XGM: pickmesh numtris<%zu>", mdl->_pickMesh->numTriangles());
+    }
+    ///////////////////////////////////
+    for (auto mtl : quantized_materials) {
+      auto as_pbr = std::dynamic_pointer_cast<PBRMaterial>(mtl);
+      if (nullptr == as_pbr) {
+        logerrchannel()->log("xgm: quantized clusters on non pbr material<%s>", mtl->GetName().c_str());
+      } else if (as_pbr->_initialTarget) {
+        logerrchannel()->log("xgm: material<%s> already initialized, no dequantizing techniques", mtl->GetName().c_str());
+      } else {
+        as_pbr->_quantizedVertices = true;
+      }
+    }
+    for (auto mtl : pending_gpuinit) {
+      mtl->gpuInit(context);
     }
     rval = true;
   } // if( chunkreader.IsOk() )
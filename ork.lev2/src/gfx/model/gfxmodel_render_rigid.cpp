@@ -16,6 +16,7 @@
 #include <ork/kernel/string/deco.inl>
 #include <ork/lev2/gfx/material_pbr.inl>
 #include <ork/lev2/gfx/material_freestyle.h>
+#include <ork/lev2/gfx/gfxvtxquant.h>
 
 namespace ork::lev2 {
 
@@ -54,6 +55,10 @@ void XgmModel::RenderRigid(
     //////////////////////////////////////////////
     pipeline->wrappedDrawCall(RCID, [&]() {
       auto vtxbuffer = cluster->_vertexBuffer;
+      if (vtxquant::isQuantizedFormat(vtxbuffer->GetStreamFormat())) {
+        if (auto as_pbr = std::dynamic_pointer_cast<PBRMaterial>(XgmClusSet._material))
+          as_pbr->bindVertexDequant(context, cluster->mBoundingBox);
+      }
       int inumprim   = cluster->numPrimGroups();
       for (int iprim = 0; iprim < inumprim; iprim++) {
         auto primgroup = cluster->primgroup(iprim);
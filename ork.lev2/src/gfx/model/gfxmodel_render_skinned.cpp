@@ -15,6 +15,7 @@
 #include <ork/kernel/string/deco.inl>
 #include <ork/lev2/gfx/material_pbr.inl>
 #include <ork/lev2/gfx/material_freestyle.h>
+#include <ork/lev2/gfx/gfxvtxquant.h>
 
 namespace ork::lev2 {
 
@@ -121,6 +122,10 @@ void XgmModel::RenderSkinned(
           //////////////////////////////////////////////////////
           auto vtxbuffer = cluster->GetVertexBuffer();
           if (vtxbuffer) {
+            if (vtxquant::isQuantizedFormat(vtxbuffer->GetStreamFormat())) {
+              if (auto as_pbr = std::dynamic_pointer_cast<PBRMaterial>(mtl))
+                as_pbr->bindVertexDequant(context, cluster->mBoundingBox);
+            }
             int inumprim = cluster->numPrimGroups();
             for (int iprim = 0; iprim < inumprim; iprim++) {
               auto primgroup = cluster->primgroup(iprim);
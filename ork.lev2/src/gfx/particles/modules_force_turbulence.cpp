@@ -11,6 +11,7 @@
 #include <ork/lev2/gfx/particle/modular_forces.h>
 #include <ork/dataflow/module.inl>
 #include <ork/dataflow/plug_data.inl>
+#include <ork/math/batch_noise.h>
 
 using namespace ork::dataflow;
 
@@ -31,7 +32,8 @@ struct TurbulenceModuleInst : public ParticleModuleInst {
     // inputs
     /////////////////
 
-    _input_amount = typedInputNamed<Vec3XfPlugTraits>("Amount");
+    _input_amount    = typedInputNamed<Vec3XfPlugTraits>("Amount");
+    _input_frequency = typedInputNamed<FloatXfPlugTraits>("Frequency");
 
   }
 
@@ -40,6 +42,12 @@ struct TurbulenceModuleInst : public ParticleModuleInst {
   void compute(GraphInst* inst, ui::updatedata_ptr_t updata) final {
     fvec3 amt = _input_amount->value();
     float dt  = updata->_dt;
+    float frq = _input_frequency->value();
+
+    if (frq > 0.0f) {
+      _computeNoiseField(amt, frq, dt, float(updata->_abstime));
+      return;
+    }
 
     for (int i = 0; i < _pool->GetNumAlive(); i++) {
       BasicParticle* particle = _pool->GetActiveParticle(i);
@@ -56,9 +64,49 @@ struct TurbulenceModuleInst : public ParticleModuleInst {
     }
   }
 
+  ////////////////////////////////////////////////////
+  // coherent turbulence : 3 decorrelated fbm channels sampled at every
+  //  particle (drifting with time), one batch per channel
+  ////////////////////////////////////////////////////
+
+  void _computeNoiseField(const fvec3& amt, float frq, float dt, float time) {
+    size_t count = size_t(_pool->GetNumAlive());
+    _noiseX.resize(count);
+    _noiseY.resize(count);
+    _noiseZ.resize(count);
+    _noiseOut.resize(count * 3);
+    float drift = time * 0.25f;
+    for (size_t i = 0; i < count; i++) {
+      const auto& pos = _pool->GetActiveParticle(int(i))->mPosition;
+      _noiseX[i]      = pos.x;
+      _noiseY[i]      = pos.y;
+      _noiseZ[i]      = pos.z + drift / frq;
+    }
+    math::NoiseParams params;
+    params._octaves   = 3;
+    params._frequency = frq;
+    for (uint32_t axis = 0; axis < 3; axis++) {
+      params._seed = axis;
+      math::noise::batch3(_noiseX.data(), _noiseY.data(), _noiseZ.data(), _noiseOut.data() + axis * count, count, params);
+    }
+    for (size_t i = 0; i < count; i++) {
+      BasicParticle* particle = _pool->GetActiveParticle(int(i));
+      fvec4 accel(
+          amt.x * _noiseOut[i], //
+          amt.y * _noiseOut[count + i],
+          amt.z * _noiseOut[count * 2 + i]);
+      particle->mVelocity += accel * dt;
+    }
+  }
+
   ////////////////////////////////////////////////////
 
   fvec3xf_inp_pluginst_ptr_t _input_amount;
+  floatxf_inp_pluginst_ptr_t _input_frequency;
+  std::vector<float> _noiseX;
+  std::vector<float> _noiseY;
+  std::vector<float> _noiseZ;
+  std::vector<float> _noiseOut;
 
   RandGen _randgen;
 };
@@ -73,6 +121,8 @@ TurbulenceModuleData::TurbulenceModuleData() {
 static void _reshapeTurbulenceIOs( dataflow::moduledata_ptr_t data ){
   auto typed = std::dynamic_pointer_cast<TurbulenceModuleData>(data);
   ModuleData::createInputPlug<Vec3XfPlugTraits>(data, EPR_UNIFORM, "Amount")->_range = {-1000.0f,1000.0f};
+  // 0 : uncorrelated per particle jitter, > 0 : coherent noise field (cycles per unit)
+  ModuleData::createInputPlug<FloatXfPlugTraits>(data, EPR_UNIFORM, "Frequency")->_range = {0.0f,10.0f};
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,326 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+
+#include <ork/lev2/gfx/raypick.h>
+#include <ork/lev2/gfx/gfxvtxbuf_structs.h>
+#include <ork/lev2/gfx/gfxvtxquant.h>
+#include <ork/util/logger.h>
+
+namespace ork::lev2 {
+static logchannel_ptr_t logchan_raypick = logger()->createChannel("RAYPICK", fvec3(0.8, 0.2, 0.5), true);
+
+static constexpr uint32_t kPICKMESHVERSION = 0x504b4d31; // "PKM1"
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PickMesh::addTriangle(const fvec3* positions, const fvec3* normals, const fvec2* uvs) {
+  Triangle tri;
+  tri._p0 = positions[0];
+  tri._e1 = positions[1] - positions[0];
+  tri._e2 = positions[2] - positions[0];
+  _triangles.push_back(tri);
+  Attributes attrs;
+  for (int i = 0; i < 3; i++) {
+    attrs._normal[i] = normals[i];
+    attrs._uv[i]     = uvs[i];
+  }
+  _attributes.push_back(attrs);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// decode the vertex formats the xgm writers produce
+///////////////////////////////////////////////////////////////////////////////
+
+bool PickMesh::addCluster(
+    EVtxStreamFormat format,
+    const void* vertices,
+    int numvertices,
+    const fvec3& boxmin,
+    const fvec3& boxmax,
+    PrimitiveType primtype,
+    const U16* indices,
+    int numindices) {
+
+  std::vector<fvec3> positions(numvertices);
+  std::vector<fvec3> normals(numvertices);
+  std::vector<fvec2> uvs(numvertices);
+
+  auto decode_float = [&](auto vtxtype_proxy) {
+    using vtx_t = decltype(vtxtype_proxy);
+    auto pv     = (const vtx_t*)vertices;
+    for (int iv = 0; iv < numvertices; iv++) {
+      positions[iv] = pv[iv].mPosition;
+      normals[iv]   = pv[iv].mNormal;
+      uvs[iv]       = fvec2(pv[iv].mUV0.x, pv[iv].mUV0.y);
+    }
+  };
+  auto decode_quantized = [&](auto vtxtype_proxy) {
+    using vtx_t = decltype(vtxtype_proxy);
+    auto pv     = (const vtx_t*)vertices;
+    vtxquant::PositionQuantizer quantizer(boxmin, boxmax);
+    for (int iv = 0; iv < numvertices; iv++) {
+      positions[iv] = quantizer.decode(pv[iv].mPosition);
+      normals[iv]   = vtxquant::octDecode(pv[iv].mNormal[0], pv[iv].mNormal[1]);
+      uvs[iv]       = fvec2(vtxquant::halfToFloat(pv[iv].mUV0[0]), vtxquant::halfToFloat(pv[iv].mUV0[1]));
+    }
+  };
+
+  switch (format) {
+    case EVtxStreamFormat::V12N12B12T8I4W4:
+      decode_float(SVtxV12N12B12T8I4W4());
+      break;
+    case EVtxStreamFormat::V12N12T8I4W4:
+      decode_float(SVtxV12N12T8I4W4());
+      break;
+    case EVtxStreamFormat::V12N12B12T16:
+      decode_float(SVtxV12N12B12T16());
+      break;
+    case EVtxStreamFormat::V12N12T16C4:
+      decode_float(SVtxV12N12T16C4());
+      break;
+    case EVtxStreamFormat::V12N12B12T8C4: {
+      auto pv = (const SVtxV12N12B12T8C4*)vertices;
+      for (int iv = 0; iv < numvertices; iv++) {
+        positions[iv] = pv[iv]._position;
+        normals[iv]   = pv[iv]._normal;
+        uvs[iv]       = pv[iv]._uv;
+      }
+      break;
+    }
+    case EVtxStreamFormat::V8N4B4T8:
+      decode_quantized(SVtxV8N4B4T8());
+      break;
+    case EVtxStreamFormat::V8N4B4T4I4W4:
+      decode_quantized(SVtxV8N4B4T4I4W4());
+      break;
+    default:
+      logchan_raypick->log("addCluster: vertex format<%d> not pickable", int(format));
+      return false;
+  }
+
+  auto emit = [&](int a, int b, int c) {
+    if (a == b or b == c or a == c)
+      return; // strip stitching
+    if (a >= numvertices or b >= numvertices or c >= numvertices)
+      return;
+    fvec3 pos[3] = {positions[a], positions[b], positions[c]};
+    fvec3 nrm[3] = {normals[a], normals[b], normals[c]};
+    fvec2 uv[3]  = {uvs[a], uvs[b], uvs[c]};
+    addTriangle(pos, nrm, uv);
+  };
+
+  switch (primtype) {
+    case PrimitiveType::TRIANGLES:
+      for (int i = 0; i + 2 < numindices; i += 3)
+        emit(indices[i], indices[i + 1], indices[i + 2]);
+      break;
+    case PrimitiveType::TRIANGLESTRIP:
+      for (int i = 2; i < numindices; i++) {
+        if (i & 1)
+          emit(indices[i - 1], indices[i - 2], indices[i]);
+        else
+          emit(indices[i - 2], indices[i - 1], indices[i]);
+      }
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PickMesh::build() {
+  std::vector<BVH4::BuildPrim> prims(_triangles.size());
+  for (size_t i = 0; i < _triangles.size(); i++) {
+    const auto& tri = _triangles[i];
+    fvec3 p1        = tri._p0 + tri._e1;
+    fvec3 p2        = tri._p0 + tri._e2;
+    prims[i]._min   = tri._p0.minXYZ(p1).minXYZ(p2);
+    prims[i]._max   = tri._p0.maxXYZ(p1).maxXYZ(p2);
+  }
+  _bvh.build(prims, 4);
+  ////////////////////////////////
+  // reorder so leaf ranges index triangles directly
+  ////////////////////////////////
+  std::vector<Triangle> triangles(_triangles.size());
+  std::vector<Attributes> attributes(_attributes.size());
+  for (size_t i = 0; i < _bvh._primIndices.size(); i++) {
+    triangles[i]          = _triangles[_bvh._primIndices[i]];
+    attributes[i]         = _attributes[_bvh._primIndices[i]];
+    _bvh._primIndices[i] = uint32_t(i);
+  }
+  _triangles.swap(triangles);
+  _attributes.swap(attributes);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool PickMesh::intersect(const fray3& ray, RayPickHit& hit) const {
+  BVH4Ray bray(ray.mOrigin, ray.mDirection, 0.0f, hit._distance);
+  int besttri = -1;
+  float bestu = 0.0f;
+  float bestv = 0.0f;
+  _bvh.traverse(bray, [&](uint32_t first, uint32_t count, BVH4Ray& r) -> bool {
+    for (uint32_t i = first; i < first + count; i++) {
+      // double sided, the pick pass renders without culling
+      const auto& tri = _triangles[i];
+      fvec3 pvec      = r._direction.crossWith(tri._e2);
+      float det       = tri._e1.dotWith(pvec);
+      if (fabsf(det) < 1.0e-12f)
+        continue;
+      float invdet = 1.0f / det;
+      fvec3 tvec   = r._origin - tri._p0;
+      float u      = tvec.dotWith(pvec) * invdet;
+      if (u < 0.0f or u > 1.0f)
+        continue;
+      fvec3 qvec = tvec.crossWith(tri._e1);
+      float v    = r._direction.dotWith(qvec) * invdet;
+      if (v < 0.0f or (u + v) > 1.0f)
+        continue;
+      float t = tri._e2.dotWith(qvec) * invdet;
+      if (t > r._tmin and t < r._tmax) {
+        r._tmax = t;
+        besttri = int(i);
+        bestu   = u;
+        bestv   = v;
+      }
+    }
+    return false;
+  });
+  if (besttri < 0)
+    return false;
+  const auto& tri   = _triangles[besttri];
+  const auto& attrs = _attributes[besttri];
+  float w           = 1.0f - bestu - bestv;
+  hit._distance     = bray._tmax;
+  hit._triangle     = besttri;
+  hit._position     = tri._p0 + tri._e1 * bestu + tri._e2 * bestv;
+  fvec3 nrm         = attrs._normal[0] * w + attrs._normal[1] * bestu + attrs._normal[2] * bestv;
+  if (nrm.magnitudeSquared() <= 0.0f)
+    nrm = tri._e1.crossWith(tri._e2);
+  hit._normal = nrm.normalized();
+  hit._uv     = attrs._uv[0] * w + attrs._uv[1] * bestu + attrs._uv[2] * bestv;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+datablock_ptr_t PickMesh::serialize() const {
+  auto out = std::make_shared<DataBlock>();
+  out->addItem<uint32_t>(kPICKMESHVERSION);
+  out->addItem<uint64_t>(_triangles.size());
+  out->addData(_triangles.data(), _triangles.size() * sizeof(Triangle));
+  out->addData(_attributes.data(), _attributes.size() * sizeof(Attributes));
+  _bvh.serialize(*out);
+  return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool PickMesh::deserialize(datablock_ptr_t datablock) {
+  DataBlockInputStream inp(datablock);
+  if (inp.length() < sizeof(uint32_t) + sizeof(uint64_t))
+    return false;
+  if (inp.getItem<uint32_t>() != kPICKMESHVERSION)
+    return false;
+  size_t numtris = inp.getItem<uint64_t>();
+  size_t nbytes  = numtris * (sizeof(Triangle) + sizeof(Attributes));
+  if (inp._cursor + nbytes > inp.length())
+    return false;
+  _triangles.resize(numtris);
+  memcpy(_triangles.data(), inp.current(), numtris * sizeof(Triangle));
+  inp.advance(numtris * sizeof(Triangle));
+  _attributes.resize(numtris);
+  memcpy(_attributes.data(), inp.current(), numtris * sizeof(Attributes));
+  inp.advance(numtris * sizeof(Attributes));
+  return _bvh.deserialize(inp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PickScene::clear() {
+  _instances.clear();
+  _bvh.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int PickScene::addInstance(pickmesh_constptr_t mesh, const fmtx4& world, uint64_t userdata) {
+  Instance inst;
+  inst._mesh         = mesh;
+  inst._world        = world;
+  inst._invworld     = world.inverse();
+  inst._normalmatrix = inst._invworld.transposed();
+  inst._userdata     = userdata;
+  _instances.push_back(inst);
+  return int(_instances.size()) - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PickScene::build() {
+  std::vector<BVH4::BuildPrim> prims(_instances.size());
+  for (size_t i = 0; i < _instances.size(); i++) {
+    const auto& inst = _instances[i];
+    const auto& bvh  = inst._mesh->_bvh;
+    auto& prim       = prims[i];
+    prim._min        = fvec3(std::numeric_limits<float>::max());
+    prim._max        = fvec3(-std::numeric_limits<float>::max());
+    if (bvh.empty())
+      continue;
+    for (int c = 0; c < 8; c++) {
+      fvec3 corner(
+          (c & 1) ? bvh._boundsMax.x : bvh._boundsMin.x,
+          (c & 2) ? bvh._boundsMax.y : bvh._boundsMin.y,
+          (c & 4) ? bvh._boundsMax.z : bvh._boundsMin.z);
+      fvec3 wcorner = fvec4(corner, 1.0f).transform(inst._world).xyz();
+      prim._min     = prim._min.minXYZ(wcorner);
+      prim._max     = prim._max.maxXYZ(wcorner);
+    }
+  }
+  _bvh.build(prims, 2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// instance rays are not renormalized, so the ray parameter
+//  means the same thing in model and world space
+///////////////////////////////////////////////////////////////////////////////
+
+bool PickScene::intersect(const fray3& ray, RayPickHit& hit) const {
+  BVH4Ray bray(ray.mOrigin, ray.mDirection, 0.0f, hit._distance);
+  RayPickHit best;
+  _bvh.traverse(bray, [&](uint32_t first, uint32_t count, BVH4Ray& r) -> bool {
+    for (uint32_t i = first; i < first + count; i++) {
+      int index        = int(_bvh._primIndices[i]);
+      const auto& inst = _instances[index];
+      fvec3 o          = fvec4(r._origin, 1.0f).transform(inst._invworld).xyz();
+      fvec3 d          = fvec4(r._direction, 0.0f).transform(inst._invworld).xyz();
+      RayPickHit local;
+      local._distance = r._tmax;
+      if (inst._mesh->intersect(fray3(o, d), local)) {
+        r._tmax         = local._distance;
+        best            = local;
+        best._instance = index;
+      }
+    }
+    return false;
+  });
+  if (best._instance < 0)
+    return false;
+  const auto& inst = _instances[best._instance];
+  hit              = best;
+  hit._position    = fvec4(best._position, 1.0f).transform(inst._world).xyz();
+  hit._normal      = fvec4(best._normal, 0.0f).transform(inst._normalmatrix).xyz().normalized();
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::lev2
+///////////////////////////////////////////////////////////////////////////////
@@ -83,8 +83,9 @@ static asset::vars_ptr_t _irradianceVars() {
       auto equirectangular = load_req->_asset_vars->typedValueForKey<bool>("equirectangular").value();
 
 
-      auto filtenvSpecularMap = PBRMaterial::filterSpecularEnvMap(tex, targ,equirectangular);
-      auto filtenvDiffuseMap  = PBRMaterial::filterDiffuseEnvMap(tex, targ,equirectangular);
+      auto prefiltered        = PBRMaterial::prefilterEnvMap(tex, targ, equirectangular);
+      auto filtenvSpecularMap = prefiltered._specularMap;
+      auto filtenvDiffuseMap  = prefiltered._diffuseMap;
       auto brdfIntegrationMap = PBRMaterial::brdfIntegrationMap(targ);
 
       load_req->_asset_vars->makeValueForKey<texture_ptr_t>("irrmap_spec") = filtenvSpecularMap;
@@ -95,6 +96,7 @@ static asset::vars_ptr_t _irradianceVars() {
       irrmaps->_filtenvSpecularMap = filtenvSpecularMap;
       irrmaps->_filtenvDiffuseMap  = filtenvDiffuseMap;
       irrmaps->_brdfIntegrationMap = brdfIntegrationMap;
+      std::copy(prefiltered._sh9, prefiltered._sh9 + 9, irrmaps->_sh9);
       //_environmentMipScale = _filtenvSpecularMap->_num_mips-1;
       //////////////////////////////////////////////////////////////
       DataBlockCache::setDataBlock(cachekey, irrmapdblock);
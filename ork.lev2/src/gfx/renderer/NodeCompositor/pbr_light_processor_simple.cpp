@@ -20,6 +20,7 @@
 #include <ork/lev2/gfx/renderer/irendertarget.h>
 #include <ork/lev2/gfx/material_freestyle.h>
 #include <ork/kernel/datacache.h>
+#include <ork/kernel/datablock.h>
 #include <ork/gfx/brdf.inl>
 #include <ork/gfx/dds.h>
 #include <ork/lev2/gfx/material_pbr.inl>
@@ -260,41 +261,121 @@ void SimpleLightProcessor::_renderShadowedTexturedSpotLights(
   auto this_buf  = context->FBI()->GetThisBuffer();
 
   /////////////////////////////////////
-  // render depth maps
+  // size and place every shadowed light's tile
+  //  in the shadow atlas (by screen coverage)
   /////////////////////////////////////
-  context->debugPushGroup("SimpleLightProcessor::_renderShadowedTexturedSpotLights::depthmaps");
+
+  if (nullptr == _shadowAtlas)
+    _shadowAtlas = std::make_shared<ShadowAtlas>();
+  _shadowAtlas->gpuInit(context);
+  auto& atlaslayout = _shadowAtlas->_layout;
 
   auto DEPTHRENDERCPD = CIMPL->topCPD();
+  auto DB             = RCFD->GetDB();
+  auto layer_names    = DEPTHRENDERCPD.getLayerNames();
+
+  DEPTHRENDERCPD._isAuxiliaryView = true;
+  size_t numdynamic   = 0;
+  uint64_t staticsig  = DB ? ShadowAtlas::staticCasterSignature(DB, layer_names, numdynamic) : 0;
+
+  std::vector<ShadowAtlasLayout::Request> requests;
+  float screenheight = float(_deferredContext._height);
+  float projscale    = VD.PM.elemXY(1, 1);
   for (auto texture_item : enumlights->_tex2shadowedspotlightmap) {
     for (auto light : texture_item.second) {
-      auto irt              = light->rendertarget(context);
-      auto shadowrect       = ViewportRect(0, 0, light->_shadowmapDim, light->_shadowmapDim);
-      auto shadowmtx        = light->shadowMatrix();
-      auto lightcamdat      = light->shadowCamDat();
-      CameraMatrices cammtc = lightcamdat.computeMatrices(1.0f);
+      fmtx4 matW  = light->worldMatrix();
+      float range = light->getRange();
+      float fovy  = light->getFovy();
+      fvec3 wnx, wny, wnz;
+      matW.toNormalVectors(wnx, wny, wnz);
+      // bounding sphere of the cone, projected
+      float halfrange  = range * 0.5f;
+      float coneradius = range * tanf(fovy * DTOR * 0.5f);
+      fvec3 center     = matW.translation() + wnz * halfrange;
+      float radius     = sqrtf(halfrange * halfrange + coneradius * coneradius);
+      float dist       = (center - VD._camposmono).length();
+      float screensize = screenheight;
+      if (dist > radius)
+        screensize = std::min(screenheight, radius / sqrtf(dist * dist - radius * radius) * projscale * screenheight);
+
+      ShadowAtlasLayout::Request req;
+      req._key        = light;
+      req._screenSize = screensize;
+      req._maxSize    = light->_spdata->shadowMapSize();
+      auto hasher     = DataBlock::createHasher();
+      hasher->accumulateItem<fmtx4>(matW);
+      hasher->accumulateItem<float>(range);
+      hasher->accumulateItem<float>(fovy);
+      hasher->finish();
+      req._lightState = hasher->result();
+      requests.push_back(req);
+    }
+  }
+  atlaslayout.update(requests, staticsig);
+
+  /////////////////////////////////////
+  // render depth maps
+  //  static casters : only tiles whose cached depth went stale
+  //  dynamic casters : every tile, every frame
+  /////////////////////////////////////
+  context->debugPushGroup("SimpleLightProcessor::_renderShadowedTexturedSpotLights::depthmaps");
+
+  auto render_tile = [&](SpotLight* light, RtGroupRenderTarget* irt, const DrawQueue::itemfilter_t& filter) {
+    const auto& tile      = atlaslayout.slot(light)->_tile;
+    auto tilerect         = ViewportRect(tile._x, tile._y, tile._size, tile._size);
+    auto lightcamdat      = light->shadowCamDat();
+    CameraMatrices cammtc = lightcamdat.computeMatrices(1.0f);
 
-      DEPTHRENDERCPD._irendertarget        = irt;
-      DEPTHRENDERCPD._cameraMatrices       = &cammtc;
-      DEPTHRENDERCPD._stereoCameraMatrices = nullptr;
-      DEPTHRENDERCPD._stereo1pass          = false;
-      DEPTHRENDERCPD.SetDstRect(shadowrect);
-      FBI->SetAutoClear(false);
-      CIMPL->pushCPD(DEPTHRENDERCPD); // base lighting
-      FBI->PushRtGroup(irt->_rtgroup);
-      context->beginFrame();
-      FBI->clearDepth(1.0f);
-      auto DB = RCFD->GetDB();
-      if (DB) {
-        for (const auto& layer_name : DEPTHRENDERCPD.getLayerNames()) {
-          context->debugMarker(FormatString("enqshadowlayer<%s>", layer_name.c_str()));
-          DB->enqueueLayerToRenderQueue(layer_name, irenderer);
-        }
-        irenderer->drawEnqueuedRenderables();
+    DEPTHRENDERCPD._irendertarget        = irt;
+    DEPTHRENDERCPD._cameraMatrices       = &cammtc;
+    DEPTHRENDERCPD._stereoCameraMatrices = nullptr;
+    DEPTHRENDERCPD._stereo1pass          = false;
+    DEPTHRENDERCPD.SetDstRect(tilerect);
+    CIMPL->pushCPD(DEPTHRENDERCPD);
+    FBI->PushRtGroup(irt->_rtgroup);
+    context->beginFrame();
+    FBI->pushViewport(tilerect);
+    FBI->pushScissor(tilerect); // clear only this tile
+    FBI->clearDepth(1.0f);
+    if (DB) {
+      for (const auto& layer_name : layer_names) {
+        context->debugMarker(FormatString("enqshadowlayer<%s>", layer_name.c_str()));
+        DB->enqueueLayerToRenderQueue(layer_name, irenderer, filter);
       }
-      CIMPL->popCPD();
-      context->endFrame();
-      FBI->PopRtGroup();
+      irenderer->drawEnqueuedRenderables();
     }
+    FBI->popScissor();
+    FBI->popViewport();
+    CIMPL->popCPD();
+    context->endFrame();
+    FBI->PopRtGroup();
+  };
+
+  auto static_only  = [](const DrawQueueItem& item) -> bool { return item._drawable->_staticShadowCaster; };
+  auto dynamic_only = [](const DrawQueueItem& item) -> bool { return not item._drawable->_staticShadowCaster; };
+
+  FBI->SetAutoClear(false);
+  for (auto texture_item : enumlights->_tex2shadowedspotlightmap) {
+    for (auto light : texture_item.second) {
+      if (atlaslayout.needsStaticRender(light)) {
+        render_tile(light, _shadowAtlas->_staticIRT.get(), static_only);
+        atlaslayout.markStaticRendered(light);
+      }
+    }
+  }
+  if (numdynamic) {
+    for (auto texture_item : enumlights->_tex2shadowedspotlightmap)
+      for (auto light : texture_item.second)
+        render_tile(light, _shadowAtlas->_dynamicIRT.get(), dynamic_only);
+    _shadowAtlas->_dynamicClear = false;
+  } else if (not _shadowAtlas->_dynamicClear) {
+    // no dynamic casters : clear the whole atlas once, then leave it alone
+    FBI->PushRtGroup(_shadowAtlas->_dynamicRTG.get());
+    context->beginFrame();
+    FBI->clearDepth(1.0f);
+    context->endFrame();
+    FBI->PopRtGroup();
+    _shadowAtlas->_dynamicClear = true;
   }
   FBI->SetAutoClear(false);
   context->debugPopGroup();
@@ -304,7 +385,9 @@ void SimpleLightProcessor::_renderShadowedTexturedSpotLights(
   /////////////////////////////////////
 
   context->debugPushGroup("SimpleLightProcessor::_renderShadowedTexturedSpotLights::accum");
-  auto lightmtl = _deferredContext._lightingmtl;
+  auto lightmtl     = _deferredContext._lightingmtl;
+  auto staticdepth  = _shadowAtlas->_staticRTG->_depthBuffer->_texture;
+  auto dynamicdepth = _shadowAtlas->_dynamicRTG->_depthBuffer->_texture;
 
   for (auto texture_item : enumlights->_tex2shadowedspotlightmap) {
     auto cookie  = texture_item.first;
@@ -325,7 +408,7 @@ void SimpleLightProcessor::_renderShadowedTexturedSpotLights(
     OrkAssert(numlights < KMAXLIGHTSPERCHUNK);
     for (auto light : lights) {
       numlights                        = 1;
-      auto shadowtex                   = light->_shadowRTG->_depthBuffer->_texture;
+      const auto& tile                 = atlaslayout.slot(light)->_tile;
       fvec3 color                      = light->color()*light->intensity();
       float dist2cam                   = light->distance(VD._camposmono);
       auto mapping                     = FXI->mapParamBuffer(_lightbuffer, 0, 65536);
@@ -339,9 +422,11 @@ void SimpleLightProcessor::_renderShadowedTexturedSpotLights(
       mapping->ref<fmtx4>(offset_mtx2) = light->shadowMatrix();
       FXI->unmapParamBuffer(mapping.get());
       FXI->bindParamBlockBuffer(_deferredContext._lightblock, _lightbuffer);
-      lightmtl->bindParamCTex(_deferredContext._parMapShadowDepth, shadowtex.get());
+      lightmtl->bindParamCTex(_deferredContext._parMapShadowDepth, staticdepth.get());
+      lightmtl->bindParamCTex(_deferredContext._parMapShadowDepthDynamic, dynamicdepth.get());
+      lightmtl->bindParamVec4(_deferredContext._parShadowAtlasRect, tile.uvRect(atlaslayout._atlasDim));
       fvec4 shadowp;
-      shadowp.x = (1.0f / float(light->_shadowmapDim));
+      shadowp.x = (1.0f / float(tile._size));
       shadowp.y = (1.0f / 9.0f);
       shadowp.z = light->shadowDepthBias();
       lightmtl->bindParamVec4(_deferredContext._parShadowParams, shadowp);
@@ -122,6 +122,7 @@ void DeferredContext::gpuInit(Context* target) {
     _parMapGBuf             = _lightingmtl->param("MapGBuffer");
     _parMapDepth            = _lightingmtl->param("MapDepth");
     _parMapShadowDepth      = _lightingmtl->param("MapShadowDepth");
+    _parMapShadowDepthDynamic = _lightingmtl->param("MapShadowDepthDynamic");
     _parMapDepthCluster     = _lightingmtl->param("MapDepthCluster");
     _parLightCookieTexture  = _lightingmtl->param("MapLightingCookie");
     _parMapSpecularEnv      = _lightingmtl->param("MapSpecularEnv");
@@ -152,6 +153,7 @@ void DeferredContext::gpuInit(Context* target) {
     _parDepthFogDistance    = _lightingmtl->param("DepthFogDistance");
     _parDepthFogPower       = _lightingmtl->param("DepthFogPower");
     _parShadowParams        = _lightingmtl->param("ShadowParams");
+    _parShadowAtlasRect     = _lightingmtl->param("ShadowAtlasRect");
     //////////////////////////////////////////////////////////////
     _rtgs_gbuffer = std::make_shared<RtgSet>(target, MsaaSamples::MSAA_1X, "rtgs-gbuffer", true);
     _rtgs_gbuffer->addBuffer("DeferredGbuffer", EBufferFormat::RGBA32UI);
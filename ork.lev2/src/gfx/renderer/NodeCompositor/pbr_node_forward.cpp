@@ -527,6 +527,7 @@ struct ForwardPbrNodeImpl {
               if (auto as_spotlight = dynamic_cast<SpotLight*>(light)) {
 
                 CompositingPassData shadowCPD = CPD.clone();
+                shadowCPD._isAuxiliaryView    = true;
                 CameraMatrices SHADOWCAM;
                 shadowCPD._cameraMatrices           = &SHADOWCAM;
                 SHADOWCAM._pmatrix                  = as_spotlight->mProjectionMatrix;
@@ -587,6 +588,7 @@ struct ForwardPbrNodeImpl {
                 fvec3 position = CMATRIX.translation();
 
                 CompositingPassData cubemapCPD = CPD.clone();
+                cubemapCPD._isAuxiliaryView    = true;
                 CameraMatrices CUBECAM;
                 // compute projection matrix
                 CUBECAM._pmatrix.perspective(90.0f * DTOR, 1.0f, 0.01f, 1000.0f);
@@ -54,7 +54,10 @@ void DrawQueue::invokePreRenderCallbacks(lev2::rcfd_ptr_t RCFD) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void DrawQueue::enqueueLayerToRenderQueue(const std::string& LayerName, lev2::IRenderer* renderer) const {
+void DrawQueue::enqueueLayerToRenderQueue(
+    const std::string& LayerName, //
+    lev2::IRenderer* renderer,
+    const itemfilter_t& filter) const {
   lev2::Context* target                         = renderer->GetTarget();
   auto RCFD = target->topRenderContextFrameData();
   const auto& topCPD                            = RCFD->topCPD();
@@ -72,14 +75,14 @@ void DrawQueue::enqueueLayerToRenderQueue(const std::string& LayerName, lev2::IR
 
   //printf( "rendering <%s> do_all<%d>\n", LayerName.c_str(), int(do_all) );
   //////////////////////////////////////////////////////////////////////////////////////////////
-  auto do_layer = [target,renderer,&numdrawables,LayerName](const lev2::DrawQueueLayer* player){
-      player->_items.atomicOp([player,target,renderer,&numdrawables,LayerName](const DrawQueueLayer::itemvect_t& unlocked){
+  auto do_layer = [target,renderer,&numdrawables,LayerName,&filter](const lev2::DrawQueueLayer* player){
+      player->_items.atomicOp([player,target,renderer,&numdrawables,LayerName,&filter](const DrawQueueLayer::itemvect_t& unlocked){
         int max_index = player->_itemIndex;
         for (int id = 0; id < max_index; id++) {
           auto item = unlocked[id];
           const lev2::Drawable* pdrw        = item->_drawable;
           target->debugMarker(FormatString("DrawQueue::enqueueLayerToRenderQueue layer item <%d> drw<%p>", id, pdrw));
-          if (pdrw) {
+          if (pdrw and (not filter or filter(*item))) {
             numdrawables++;
             pdrw->enqueueToRenderQueue(item, renderer);
           }
@@ -126,6 +129,7 @@ void DrawQueue::Reset() {
   for (int il = 0; il < kmaxlayers; il++) {
     mRawLayers[il].Reset(*this);
   }
+  _arena->recycle(); // items were just released by the layers
   _preRenderCallbacks.clear();
   _cameraDataLUT.atomicOp([](cameradatalut_ptr_t& unlocked){unlocked->clear();});
   _state.store(1000);
@@ -168,16 +172,24 @@ DrawQueueLayer* DrawQueue::MergeLayer(const std::string& layername) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static std::atomic<int> _itemSerialCounter = 0;
+static thread_local DrawQueueSlab* _tl_boundslab = nullptr;
+
 drawqueueitem_ptr_t DrawQueueLayer::enqueueDrawable(const DrawQueueTransferData& xfdata, const Drawable* d) {
   // ork::opq::assertOnQueue2(opq::updateSerialQueue());
-  // _items.push_back(DrawQueueItem()); // replace std::vector with an array so we can amortize construction costs
-  auto item = std::make_shared<DrawQueueItem>(); // todo USE POOL
+  // item, its control block and its usermap nodes all live in the drawqueue's arena
+  //  the control block's allocator keeps the arena alive for the usermap too
+  OrkAssert(_arena != nullptr);
+  using alloc_t = DrawQueueArenaAllocator<DrawQueueItem>;
+  auto item = std::allocate_shared<DrawQueueItem>(alloc_t(_arena), xfdata, _arena.get());
   item->_drawable = d;
-  item->_dqxferdata       = xfdata;
   item->_bufferIndex = miBufferIndex;
-  static std::atomic<int> counter = 0;
-  item->_serialno = counter++;
   item->_sortkey = _sortkey;
+  if (auto slab = _tl_boundslab) { // serial number assigned at merge
+    slab->_append(this, item);
+    return item;
+  }
+  item->_serialno = _itemSerialCounter++;
   _items.atomicOp([this,item](DrawQueueLayer::itemvect_t& unlocked){
     unlocked.push_back(item);
     _itemIndex = unlocked.size();
@@ -187,11 +199,72 @@ drawqueueitem_ptr_t DrawQueueLayer::enqueueDrawable(const DrawQueueTransferData&
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void DrawQueueSlab::bindToThread() {
+  OrkAssert(_tl_boundslab == nullptr);
+  _tl_boundslab = this;
+}
+void DrawQueueSlab::unbindFromThread() {
+  OrkAssert(_tl_boundslab == this);
+  _tl_boundslab = nullptr;
+}
+DrawQueueSlab* DrawQueueSlab::boundToThread() {
+  return _tl_boundslab;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void DrawQueueSlab::_append(DrawQueueLayer* layer, drawqueueitem_ptr_t item) {
+  for (auto& l : _layers) {
+    if (l._layer == layer) {
+      l._items.push_back(item);
+      return;
+    }
+  }
+  auto& l  = _layers.emplace_back();
+  l._layer = layer;
+  l._items.push_back(item);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// one lock per layer, slabs visited in order.
+//  slabs are emptied (capacity kept) so no item outlives the arena frame
+///////////////////////////////////////////////////////////////////////////////
+
+void DrawQueue::mergeSlabs(std::vector<DrawQueueSlab>& slabs) {
+  for (int il = 0; il < miNumLayersUsed; il++) {
+    auto player = &mRawLayers[il];
+    player->_items.atomicOp([player, &slabs](DrawQueueLayer::itemvect_t& unlocked) {
+      for (auto& slab : slabs) {
+        for (auto& l : slab._layers) {
+          if (l._layer != player)
+            continue;
+          int serialno = _itemSerialCounter.fetch_add(int(l._items.size()));
+          for (auto& item : l._items) {
+            item->_serialno = serialno++;
+            unlocked.push_back(item);
+          }
+          l._items.clear();
+        }
+      }
+      if (not unlocked.empty())
+        player->_itemIndex = unlocked.size();
+    });
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 DrawQueue::DrawQueue(int ibidx)
     : miNumLayersUsed(0) 
     , miBufferIndex(ibidx) {
     _state.store(1000);
 
+    _arena = std::make_shared<DrawQueueArena>();
+
+    for (int il = 0; il < kmaxlayers; il++) {
+      mRawLayers[il]._arena = _arena;
+    }
+
     _cameraDataLUT.atomicOp([](cameradatalut_ptr_t& unlocked){
       unlocked = std::make_shared<CameraDataLut>();
     });
@@ -199,9 +272,11 @@ DrawQueue::DrawQueue(int ibidx)
 DrawQueue::~DrawQueue() {
   _state.store(0);
 }
-DrawQueueItem::DrawQueueItem()
+DrawQueueItem::DrawQueueItem(const DrawQueueTransferData& xfdata, std::pmr::memory_resource* mem)
       : _drawable(0)
-      , _bufferIndex(0) {
+      , _dqxferdata(xfdata)
+      , _bufferIndex(0)
+      , _usermap(mem) {
   _state.store(1000);
   }
 
@@ -223,6 +298,123 @@ DrawQueueLayer::~DrawQueueLayer(){
 //void DrawQueueLayer::terminate() {
 //}
 
+///////////////////////////////////////////////////////////////////////////////
+
+DrawQueueArena::Block::Block(size_t size)
+    : _size((size + 63) & ~size_t(63)) {
+  _base = (uint8_t*) aligned_alloc(64, _size);
+  _offset.store(0);
+  _numlive.store(0);
+}
+DrawQueueArena::Block::~Block() {
+  free(_base);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+DrawQueueArena::DrawQueueArena()
+    : _mutex("dqarena") {
+  _current.store(nullptr);
+  _numallocs.store(0);
+  _numbytes.store(0);
+  _numlive.store(0);
+}
+DrawQueueArena::~DrawQueueArena() {
+  OrkAssert(_numlive.load() == 0); // items reference the arena, see DrawQueueArenaAllocator
+  for (auto blk : _blocks)
+    delete blk;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// each allocation is preceded by its owning block, so a free can
+//  drop that block's live count without searching
+///////////////////////////////////////////////////////////////////////////////
+
+static constexpr size_t kblockheader = sizeof(DrawQueueArena::Block*);
+
+void* DrawQueueArena::do_allocate(size_t bytes, size_t alignment) {
+  _numallocs++;
+  _numbytes += bytes;
+  _numlive++;
+  size_t span = kblockheader + bytes + alignment - 1;
+  while (true) {
+    Block* blk = _current.load();
+    if (blk) {
+      size_t offset  = blk->_offset.fetch_add(span);
+      uintptr_t base = uintptr_t(blk->_base);
+      uintptr_t addr = (base + offset + kblockheader + alignment - 1) & ~uintptr_t(alignment - 1);
+      if ((addr + bytes) <= (base + blk->_size)) {
+        blk->_numlive++;
+        memcpy((void*)(addr - kblockheader), &blk, kblockheader);
+        return (void*)addr;
+      }
+    }
+    _nextBlock(blk, span);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void DrawQueueArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+  Block* blk = nullptr;
+  memcpy(&blk, (const uint8_t*)p - kblockheader, kblockheader);
+  blk->_numlive--; // memory comes back on recycle()
+  _numlive--;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// move to the next block large enough (recycled blocks first, pinned
+//  blocks skipped). only the first thread to see a given block
+//  exhausted does the work
+///////////////////////////////////////////////////////////////////////////////
+
+void DrawQueueArena::_nextBlock(Block* exhausted, size_t minsize) {
+  _mutex.Lock();
+  if (_current.load() == exhausted) {
+    Block* next = nullptr;
+    size_t first = exhausted ? _blockindex + 1 : 0;
+    for (size_t i = first; i < _blocks.size() and (next == nullptr); i++) {
+      if (_blocks[i]->_size >= minsize and _blocks[i]->_numlive.load() == 0) {
+        next        = _blocks[i];
+        _blockindex = i;
+      }
+    }
+    if (nullptr == next) {
+      next = new Block(std::max(kblocksize, minsize));
+      _blocks.push_back(next);
+      _blockindex = _blocks.size() - 1;
+    }
+    next->_offset.store(0);
+    _current.store(next);
+  }
+  _mutex.UnLock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// every block without live allocations is reused from the next frame on.
+//  something still holding an item only pins the block(s) it lives in,
+//  so the arena grows by at most the pinned blocks, not by a frame.
+///////////////////////////////////////////////////////////////////////////////
+
+bool DrawQueueArena::recycle() {
+  _mutex.Lock();
+  size_t numpinned = 0;
+  for (auto blk : _blocks) {
+    if (blk->_numlive.load() != 0)
+      numpinned++;
+  }
+  _lastframe._numallocs = _numallocs.exchange(0);
+  _lastframe._numbytes  = _numbytes.exchange(0);
+  _lastframe._numblocks = _blocks.size();
+  _lastframe._numpinned = numpinned;
+  _blockindex           = 0;
+  _current.store(nullptr); // first allocation claims the first unpinned block
+  if (numpinned)
+    _numdeferred++;
+  _mutex.UnLock();
+  return (0 == numpinned);
+}
+
 void DrawQueueItem::terminate() {
   _drawable = nullptr;
 }
@@ -71,7 +71,8 @@ void Drawable::enqueueToRenderQueue(
 
 drawqueueitem_ptr_t Drawable::enqueueOnLayer(const DrawQueueTransferData& xfdata, DrawQueueLayer& buffer) const {
   auto item = buffer.enqueueDrawable(xfdata, this);
-  item->_onrenderable = this->_onrenderable;
+  if (this->_onrenderable)
+    item->_onrenderable = this->_onrenderable;
   return item;
 }
 
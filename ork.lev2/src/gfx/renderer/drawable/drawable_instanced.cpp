@@ -74,7 +74,8 @@ void InstancedDrawable::resize(size_t count) {
 drawqueueitem_ptr_t InstancedDrawable::enqueueOnLayer(
     const DrawQueueTransferData& xfdata, //
     DrawQueueLayer& buffer) const {
-  auto instances_copy            = std::make_shared<InstancedDrawableInstanceData>();
+  using alloc_t                  = std::pmr::polymorphic_allocator<InstancedDrawableInstanceData>;
+  auto instances_copy            = std::allocate_shared<InstancedDrawableInstanceData>(alloc_t(buffer._arena));
   *instances_copy                = *_instancedata;
   drawqueueitem_ptr_t dbufitem = Drawable::enqueueOnLayer(xfdata, buffer);
   dbufitem->_usermap["rtthread_instance_data"_crcu].set<instanceddrawinstancedata_ptr_t>(instances_copy);
@@ -12,6 +12,8 @@
 #include <ork/lev2/gfx/renderer/renderer.h>
 #include <ork/lev2/gfx/gfxmodel.h>
 #include <ork/lev2/gfx/fx_pipeline.h>
+#include <ork/lev2/gfx/material_pbr.inl>
+#include <ork/lev2/gfx/gfxvtxquant.h>
 
 #include <ork/kernel/orklut.hpp>
 #include <ork/reflect/properties/DirectTypedMap.hpp>
@@ -203,6 +205,10 @@ void InstancedModelDrawable::enqueueToRenderQueue(
         for (int ic = 0; ic < inumclus; ic++) {
           auto cluster    = xgmsub->cluster(ic);
           auto vtxbuf     = cluster->_vertexBuffer;
+          if (vtxquant::isQuantizedFormat(vtxbuf->GetStreamFormat())) {
+            if (auto as_pbr = std::dynamic_pointer_cast<PBRMaterial>(xgmsub->_material))
+              as_pbr->bindVertexDequant(context, cluster->mBoundingBox);
+          }
           size_t numprims = cluster->numPrimGroups();
           for (size_t ipg = 0; ipg < numprims; ipg++) {
             auto primgroup = cluster->primgroup(ipg);
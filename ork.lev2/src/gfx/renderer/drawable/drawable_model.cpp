@@ -169,6 +169,24 @@ void ModelDrawable::enqueueToRenderQueue(drawqueueitem_constptr_t item, lev2::IR
 
   matw.decompose(matw_trans, matw_rot, matw_scale);
 
+  //////////////////////////////////////////////////////////////////////
+  // LOD : bounding diameter as a fraction of viewport height
+  //  (P[1][1] is cot(fovy/2))
+  //////////////////////////////////////////////////////////////////////
+
+  int lod = 0;
+  if (Model->numLods() > 1) {
+    auto mtcs = topCPD.isStereoOnePass() ? topCPD._stereoCameraMatrices->_mono : topCPD.cameraMatrices();
+    if (mtcs) {
+      float cam_dist    = (ctr - topCPD.monoCamPos(fmtx4())).length();
+      float diameter    = 2.0f * frad * matw_scale * _scale;
+      float screen_size = (cam_dist > 0.0f) //
+                              ? (diameter * mtcs->_pmatrix.elemXY(1, 1)) / (2.0f * cam_dist)
+                              : 1.0f;
+      lod               = Model->selectLod(screen_size);
+    }
+  }
+
   int inumacc = 0;
   int inumrej = 0;
 
@@ -179,12 +197,13 @@ void ModelDrawable::enqueueToRenderQueue(drawqueueitem_constptr_t item, lev2::IR
 
     auto material = submeshinst->material();
 
-    int inumclus = submesh->_clusters.size();
+    const auto& clusters = submesh->lodClusters(lod);
+    int inumclus         = clusters.size();
 
     for (int ic = 0; ic < inumclus; ic++) {
       bool btest = true;
 
-      auto cluster = submesh->cluster(ic);
+      auto cluster = clusters[ic];
 
       if (isSkinned) {
 
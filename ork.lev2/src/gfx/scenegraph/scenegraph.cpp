@@ -149,6 +149,15 @@ void Scene::initWithParams(varmap::varmap_ptr_t params) {
   if (auto try_dbufcontext = params->typedValueForKey<dbufcontext_ptr_t>("dbufcontext")) {
     _dbufcontext_SG = try_dbufcontext.value();
   }
+  if (auto try_grain = params->tryKeyAsInteger("EnqueueGrainSize")) {
+    _enqueueGrainSize = std::max(int(try_grain.value()), 0);
+  }
+  if (auto try_cpupick = params->typedValueForKey<bool>("CpuPicking")) {
+    _cpuPicking = try_cpupick.value();
+  }
+  if (auto try_asyncpick = params->typedValueForKey<bool>("AsyncPickReadback")) {
+    _asyncPickReadback = try_asyncpick.value();
+  }
 
   for (auto p : params->_themap) {
     auto k = p.first;
@@ -3,6 +3,9 @@
 #include <ork/kernel/opq.h>
 #include <ork/lev2/gfx/renderer/NodeCompositor/OutputNodeRtGroup.h>
 #include <ork/lev2/gfx/renderer/NodeCompositor/NodeCompositorPicking.h>
+#include <ork/lev2/gfx/raypick.h>
+#include <ork/lev2/gfx/gfxmodel.h>
+#include <ork/util/logger.h>
 using namespace std::string_literals;
 using namespace ork;
 
@@ -10,6 +13,8 @@ const int PICKBUFDIM = 127;
 
 namespace ork::lev2::scenegraph {
 
+static logchannel_ptr_t logchan_sgpick = logger()->createChannel("SGPICK", fvec3(0.5, 0.9, 0.7), false);
+
 SgPickBuffer::SgPickBuffer(ork::lev2::Context* ctx, Scene& scene)
     : _context(ctx)
     , _scene(scene) {
@@ -43,14 +48,122 @@ void SgPickBuffer::pickWithScreenCoord(cameradata_ptr_t cam, fvec2 screencoord,
 }
 ///////////////////////////////////////////////////////////////////////////
 void SgPickBuffer::pickWithRay(fray3_constptr_t ray, callback_t callback) {
-    mydraw(ray);
-    callback(_pfc);
+    if (_scene._cpuPicking) {
+      pickWithRayCPU(ray, callback);
+      return;
+    }
+    bool async = _scene._asyncPickReadback;
+    Timer timer;
+    timer.Start();
+    bool handed_off = mydraw(ray, callback);
+    double seconds  = timer.SecsSinceStart();
+    auto& timings   = async ? _asyncTimings : _syncTimings;
+    timings._numPicks++;
+    timings._seconds += seconds;
+    logchan_sgpick->log(
+        "pick async<%d> msec<%g> avg msec sync<%g> async<%g>", //
+        int(async),
+        seconds * 1000.0,
+        _syncTimings.averageMsec(),
+        _asyncTimings.averageMsec());
+    if (not handed_off)
+      callback(_pfc);
+}
+///////////////////////////////////////////////////////////////////////////
+// CPU path : only model drawables carry pick meshes,
+//  hit info goes into the same channels the pick render reads back
+///////////////////////////////////////////////////////////////////////////
+void SgPickBuffer::pickWithRayCPU(fray3_constptr_t ray, callback_t callback) {
+  _gatherPickScene();
+  for (auto& value : _pfc->_pickvalues) {
+    value = nullptr;
+  }
+  RayPickHit hit;
+  if (_pickScene->intersect(*ray, hit)) {
+    uint64_t userdata = _pickScene->_instances[hit._instance]._userdata;
+    auto drawable     = _pickDrawables[userdata >> 32];
+    auto vmap         = _pfc->_pickvalues[0].makeShared<varmap::VarMap>();
+    (*vmap)["x"]      = drawable->_pickID;
+    (*vmap)["y"]      = uint32_t(userdata & 0xffffffff);
+    (*vmap)["z"]      = uint32_t(2); // ps_pick constants
+    (*vmap)["w"]      = uint32_t(3);
+    if (_scene._pickFormat == 0) {
+      _pfc->_pickvalues[1].set<fvec4>(fvec4(hit._position, 0.0f));
+      _pfc->_pickvalues[2].set<fvec4>(fvec4(hit._normal, 0.0f));
+      _pfc->_pickvalues[3].set<fvec4>(fvec4(hit._uv.x, hit._uv.y, 0.0f, 0.0f));
+    }
+  }
+  callback(_pfc);
+}
+///////////////////////////////////////////////////////////////////////////
+void SgPickBuffer::_gatherPickScene() {
+  if (nullptr == _pickScene) {
+    _pickScene = std::make_shared<PickScene>();
+  }
+  _pickScene->clear();
+  _pickDrawables.clear();
+
+  std::vector<layer_ptr_t> layers;
+  _scene._layers.atomicOp([&](const Scene::layer_map_t& unlocked) {
+    for (auto layer_item : unlocked) {
+      layers.push_back(layer_item.second);
+    }
+  });
+
+  auto add_drawable = [this](drawable_ptr_t drawable, const fmtx4& matw) {
+    uint64_t drawable_index = _pickDrawables.size();
+    if (auto as_model = std::dynamic_pointer_cast<ModelDrawable>(drawable)) {
+      auto minst = as_model->_modelinst;
+      auto model = minst ? minst->xgmModel() : as_model->_model.get();
+      if (nullptr == model or nullptr == model->_pickMesh)
+        return;
+      // same composition as ModelRenderable::Render
+      fmtx4 smat, tmat, rmat;
+      smat.setScale(as_model->_scale);
+      tmat.setTranslation(as_model->_offset);
+      rmat.fromQuaternion(as_model->_orientation);
+      fmtx4 nmat = fmtx4::multiply_ltor(tmat, rmat, smat, matw);
+      if (minst and minst->isBlenderZup()) {
+        fmtx4 rmatx, rmaty;
+        rmatx.rotateOnX(3.14159f * -0.5f);
+        rmaty.rotateOnX(3.14159f);
+        nmat = fmtx4::multiply_ltor(rmatx, rmaty, nmat);
+      }
+      _pickDrawables.push_back(drawable);
+      _pickScene->addInstance(model->_pickMesh, nmat, drawable_index << 32);
+    } else if (auto as_instanced = std::dynamic_pointer_cast<InstancedModelDrawable>(drawable)) {
+      auto model = as_instanced->_model;
+      auto idata = as_instanced->_instancedata;
+      if (nullptr == model or nullptr == model->_pickMesh or nullptr == idata)
+        return;
+      _pickDrawables.push_back(drawable);
+      for (size_t i = 0; i < idata->_count; i++) {
+        if (idata->_instancePool.count(int(i)))
+          continue; // free slot
+        _pickScene->addInstance(model->_pickMesh, idata->_worldmatrices[i], (drawable_index << 32) | uint64_t(i));
+      }
+    }
+  };
+
+  for (auto l : layers) {
+    l->_drawable_nodes.atomicOp([&](const Layer::drawablenodevect_t& unlocked) {
+      for (auto n : unlocked) {
+        if (n->_drawable and n->_enabled and n->_pickable) {
+          add_drawable(n->_drawable, n->_dqxfdata._worldTransform->composed());
+        }
+      }
+    });
+  }
+  _pickScene->build();
 }
 ///////////////////////////////////////////////////////////////////////////
-void SgPickBuffer::mydraw(fray3_constptr_t ray) {
+// returns true when the callback was handed to readbacks
+///////////////////////////////////////////////////////////////////////////
+bool SgPickBuffer::mydraw(fray3_constptr_t ray, callback_t callback) {
   ork::opq::assertOnQueue2(opq::mainSerialQueue());
   _context->makeCurrentContext();
-  auto FBI = _context->FBI();
+  auto FBI        = _context->FBI();
+  bool handed_off = false;
   ///////////////////////////////////////////////////////////////////////////
   if (nullptr == _compdata) {
     _compdata = new CompositingData;
@@ -159,7 +272,12 @@ void SgPickBuffer::mydraw(fray3_constptr_t ray) {
     // fetch the pixel, yo.
     ///////////////////////////////////////////??
     _pfc->endPickRender();
-    FBI->GetPixel(screen_coordinate, *_pfc);
+    if (_scene._asyncPickReadback) {
+      _pfc->fetchPixelAsync(screen_coordinate, callback);
+      handed_off = true;
+    } else {
+      FBI->GetPixel(screen_coordinate, *_pfc);
+    }
     ///////////////////////////////////////////??
 
   } // if(DB)
@@ -168,5 +286,6 @@ void SgPickBuffer::mydraw(fray3_constptr_t ray) {
   _context->popRenderContextFrameData();
   lev2::GfxEnv::GetRef().GetGlobalLock().UnLock();
   ///////////////////////////////////////////////////////////////////////////}
+  return handed_off;
 }
 } // namespace ork::lev2::scenegraph
@@ -7,8 +7,10 @@
 
 #include <ork/lev2/gfx/scenegraph/scenegraph.h>
 #include <ork/lev2/ui/event.h>
+#include <ork/kernel/opq.h>
 #include <ork/util/logger.h>
 #include <ork/profiling.inl>
+#include <thread>
 
 using namespace std::string_literals;
 using namespace ork;
@@ -76,9 +78,12 @@ void Scene::enqueueToRenderer(cameradatalut_ptr_t cameras, on_enqueue_fn_t on_en
         if (n->_drawable and n->_enabled) {
 
           DrawItem item;
-          item._layer   = drawable_layer;
-          item._drwnode = n;
+          item._layer      = drawable_layer;
+          item._drwnode    = n;
+          item._concurrent = n->_drawable->canEnqueueConcurrently();
           _nodes2draw.push_back(item);
+          // drawables may be shared by nodes, keep this write on one thread
+          n->_drawable->_pickable = n->_pickable;
         }
       }
     });
@@ -87,28 +92,97 @@ void Scene::enqueueToRenderer(cameradatalut_ptr_t cameras, on_enqueue_fn_t on_en
 
   ////////////////////////////////////////////////////////////////////////////
 
-  if (1)
-    for (auto item : _nodes2draw) {
-      auto& drawable_layer = item._layer;
-      auto n               = item._drwnode;
-      if (RENDER_DEBUG_LOG) {
-        fvec3 pos = n->_dqxfdata._worldTransform->_translation;
-        
-        logchan_sgrender->log(
-            "enqueue drawable<%s> on layer<%s> pos<%g %g %g>", //
-            (void*)n->_drawable->_name.c_str(),  //
-            drawable_layer->_name.c_str(),
-            pos.x, pos.y, pos.z );
+  auto enqueue_node = [](const DrawItem& item) {
+    auto& drawable_layer = item._layer;
+    auto n               = item._drwnode;
+    if (RENDER_DEBUG_LOG) {
+      fvec3 pos = n->_dqxfdata._worldTransform->_translation;
+      
+      logchan_sgrender->log(
+          "enqueue drawable<%s> on layer<%s> pos<%g %g %g>", //
+          (void*)n->_drawable->_name.c_str(),  //
+          drawable_layer->_name.c_str(),
+          pos.x, pos.y, pos.z );
+    }
+    n->_dqxfdata._modcolor = n->_modcolor;
+    n->_dqxfdata._use_modcolor = true;
+    //printf( "modcolor<%g %g %g %g>\n", n->_modcolor.x, n->_modcolor.y, n->_modcolor.z, n->_modcolor.w );
+    if (n->_viewRelative) {
+      n->_dqxfdata._worldTransform->_viewRelative = true;
+    }
+    n->_drawable->enqueueOnLayer(n->_dqxfdata, *drawable_layer);
+  };
+
+  int numnodes = int(_nodes2draw.size());
+  int grain    = _enqueueGrainSize;
+
+  if (grain <= 0 or numnodes < 2 * grain) {
+    for (const auto& item : _nodes2draw)
+      enqueue_node(item);
+  } else {
+    ////////////////////////////////////////////////////////////////////////////
+    // chunked parallel enqueue
+    //  each chunk fills its own slab, slabs are merged in chunk order,
+    //  so layer item order matches the serial walk.
+    //  chunks holding a drawable which can not enqueue concurrently
+    //  are deferred and run on this thread after the workers are done.
+    ////////////////////////////////////////////////////////////////////////////
+    EASY_BLOCK("Scene::enqueueToRenderer::parallel", 0xffa02020);
+    int numchunks = (numnodes + grain - 1) / grain;
+    _enqueueSlabs.resize(numchunks);
+    _enqueueSlabDeferred.assign(numchunks, 0);
+
+    auto enqueue_chunk = [this, grain, numnodes, &enqueue_node](int ichunk, bool on_worker) {
+      int ibeg = ichunk * grain;
+      int iend = std::min(ibeg + grain, numnodes);
+      if (on_worker) {
+        for (int i = ibeg; i < iend; i++) {
+          if (not _nodes2draw[i]._concurrent) {
+            _enqueueSlabDeferred[ichunk] = 1;
+            return;
+          }
+        }
       }
-      n->_drawable->_pickable = n->_pickable;
-      n->_dqxfdata._modcolor = n->_modcolor;
-      n->_dqxfdata._use_modcolor = true;
-      //printf( "modcolor<%g %g %g %g>\n", n->_modcolor.x, n->_modcolor.y, n->_modcolor.z, n->_modcolor.w );
-      if (n->_viewRelative) {
-        n->_dqxfdata._worldTransform->_viewRelative = true;
+      auto& slab = _enqueueSlabs[ichunk];
+      slab.bindToThread();
+      for (int i = ibeg; i < iend; i++)
+        enqueue_node(_nodes2draw[i]);
+      slab.unbindFromThread();
+    };
+
+    ////////////////////////////////////
+    // chunks are claimed through an atomic counter,
+    //  helpers that start late just find no work left
+    ////////////////////////////////////
+
+    struct ChunkState {
+      std::atomic<int> _next = 0;
+      std::atomic<int> _done = 0;
+    };
+    auto state      = std::make_shared<ChunkState>();
+    auto run_chunks = [state, numchunks, &enqueue_chunk]() {
+      int ichunk = state->_next.fetch_add(1);
+      while (ichunk < numchunks) {
+        enqueue_chunk(ichunk, true);
+        state->_done.fetch_add(1, std::memory_order_release);
+        ichunk = state->_next.fetch_add(1);
       }
-      n->_drawable->enqueueOnLayer(n->_dqxfdata, *drawable_layer);
+    };
+    auto q         = opq::concurrentQueue();
+    int numhelpers = std::min(numchunks, q->_numThreadsRunning.load() + 1) - 1;
+    for (int i = 0; i < numhelpers; i++) {
+      q->enqueue(run_chunks, "sg.enqueueToRenderer");
     }
+    run_chunks();
+    while (state->_done.load(std::memory_order_acquire) < numchunks) {
+      std::this_thread::yield();
+    }
+    for (int ichunk = 0; ichunk < numchunks; ichunk++) {
+      if (_enqueueSlabDeferred[ichunk])
+        enqueue_chunk(ichunk, false);
+    }
+    DB->mergeSlabs(_enqueueSlabs);
+  }
 
   ////////////////////////////////////////////////////////////////////////////
 
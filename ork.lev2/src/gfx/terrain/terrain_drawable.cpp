@@ -20,6 +20,7 @@
 #include <ork/lev2/gfx/renderer/renderer.h>
 #include <ork/lev2/gfx/material_freestyle.h>
 #include <ork/lev2/gfx/terrain/terrain_drawable.h>
+#include <ork/lev2/gfx/terrain/terrain_streaming.h>
 #include <ork/lev2/gfx/meshutil/meshutil.h>
 #include <ork/lev2/gfx/meshutil/rigid_primitive.inl>
 #include <ork/lev2/gfx/meshutil/clusterizer.h>
@@ -27,6 +28,8 @@
 #include <ork/reflect/properties/AccessorTyped.hpp>
 #include <ork/reflect/properties/DirectTyped.hpp>
 #include <ork/kernel/datacache.h>
+#include <ork/util/logger.h>
+#include <boost/filesystem.hpp>
 #include <ork/reflect/properties/registerX.inl>
 ///////////////////////////////////////////////////////////////////////////////
 using namespace ork::lev2;
@@ -112,6 +115,10 @@ struct TerrainRenderImpl {
   datablock_ptr_t recomputeTextures(Context* context);
   void reloadCachedTextures(Context* context, datablock_ptr_t dblock);
 
+  bool gpuInitStreaming(Context* context);
+  void gpuUpdateStreaming(Context* context, const fvec3& campos, const fmtx4& mvp);
+  void renderStreaming(Context* context);
+
   terraindrawableinst_ptr_t _hfinstance;
   hfptr_t _heightfield;
 
@@ -122,6 +129,9 @@ struct TerrainRenderImpl {
   const FxShaderTechnique* _tekStereo         = nullptr;
   const FxShaderTechnique* _tekDefGbuf1Stereo = nullptr;
   const FxShaderTechnique* _tekPick           = nullptr;
+  const FxShaderTechnique* _tekCdlodGbuf1       = nullptr;
+  const FxShaderTechnique* _tekCdlodGbuf1Stereo = nullptr;
+  const FxShaderTechnique* _tekCdlodPick        = nullptr;
 
   const FxShaderParam* _parMatVPL       = nullptr;
   const FxShaderParam* _parMatVPC       = nullptr;
@@ -142,6 +152,7 @@ struct TerrainRenderImpl {
   const FxShaderParam* _parGblendYbias  = nullptr;
   const FxShaderParam* _parGblendStepLo = nullptr;
   const FxShaderParam* _parGblendStepHi = nullptr;
+  const FxShaderParam* _parMorphRange   = nullptr;
   Texture* _heightmapTextureA           = nullptr;
   Texture* _heightmapTextureB           = nullptr;
   fvec3 _aabbmin;
@@ -149,6 +160,12 @@ struct TerrainRenderImpl {
   AABox _aabox;
   SectorInfo _sector[8];
   lev2::textureassetptr_t _sphericalenvmap = nullptr;
+
+  using tileidxbuf_t = StaticIndexBuffer<uint16_t>;
+  terrainstreamer_ptr_t _streamer;
+  std::shared_ptr<tileidxbuf_t> _tileIndices[5]; // quadrants 0..3, whole tile
+  Context* _streamContext = nullptr;             // owns the tile vertex buffers
+  int _streamFrame        = -1;                  // target frame of the last selection update
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -161,6 +178,16 @@ TerrainRenderImpl::TerrainRenderImpl(terraindrawableinst_ptr_t hfinst) {
 ///////////////////////////////////////////////////////////////////////////////
 
 TerrainRenderImpl::~TerrainRenderImpl() {
+  if (_streamer) {
+    auto gbi = _streamContext->GBI();
+    for (auto& item : _streamer->_resident) {
+      auto tile = item.second;
+      if (tile->_gpuvertices)
+        gbi->ReleaseVB(*tile->_gpuvertices.get());
+      tile->_gpuvertices = nullptr;
+    }
+  }
+  _streamer = nullptr; // waits for in flight tiles
   if (_heightmapTextureA) {
     delete _heightmapTextureA;
   }
@@ -915,6 +942,10 @@ void TerrainRenderImpl::gpuUpdate(Context* context) {
     _tekDefGbuf1       = _terrainMaterial->technique("terrain_gbuf1");
     _tekDefGbuf1Stereo = _terrainMaterial->technique("terrain_gbuf1_stereo");
 
+    _tekCdlodGbuf1       = _terrainMaterial->technique("terrain_cdlod_gbuf1");
+    _tekCdlodGbuf1Stereo = _terrainMaterial->technique("terrain_cdlod_gbuf1_stereo");
+    _tekCdlodPick        = _terrainMaterial->technique("pick_cdlod");
+
     _parMatVPL   = _terrainMaterial->param("MatMVPL");
     _parMatVPC   = _terrainMaterial->param("MatMVPC");
     _parMatVPR   = _terrainMaterial->param("MatMVPR");
@@ -935,6 +966,14 @@ void TerrainRenderImpl::gpuUpdate(Context* context) {
     _parGblendYbias  = _terrainMaterial->param("GBlendYBias");
     _parGblendStepLo = _terrainMaterial->param("GBlendStepLo");
     _parGblendStepHi = _terrainMaterial->param("GBlendStepHi");
+    _parMorphRange   = _terrainMaterial->param("MorphRange");
+  }
+
+  if (_hfinstance->_data->_streaming) {
+    if (not gpuInitStreaming(context))
+      logerrchannel()->log("TerrainRenderImpl : streaming init failed hfpath<%s>", _hfinstance->hfpath().c_str());
+    _gpuDataDirty = false;
+    return;
   }
 
   bool _loadok = _heightfield->Load(_hfinstance->hfpath());
@@ -959,6 +998,125 @@ void TerrainRenderImpl::gpuUpdate(Context* context) {
 
   _gpuDataDirty = false;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// streaming : the heightfield is baked into a tile file once (in the
+//  datablock cache folder, keyed on the source image), after that only
+//  the tile file's header and min/max table are loaded up front
+///////////////////////////////////////////////////////////////////////////////
+
+bool TerrainRenderImpl::gpuInitStreaming(Context* context) {
+  const auto& HFDD = _hfinstance->_data;
+  auto abs_path    = _hfinstance->hfpath().toAbsolute();
+  if (not boost::filesystem::exists(abs_path.toBFS()))
+    return false;
+  OrkAssert(HFDD->_streamTileSize <= 128); // 16 bit indices
+
+  auto tile_hasher = DataBlock::createHasher();
+  tile_hasher->accumulateString(abs_path.toStdString());
+  tile_hasher->accumulateItem<uint64_t>(uint64_t(boost::filesystem::file_size(abs_path.toBFS())));
+  tile_hasher->accumulateItem<int64_t>(int64_t(boost::filesystem::last_write_time(abs_path.toBFS())));
+  tile_hasher->accumulateItem<int>(HFDD->_streamTileSize);
+  tile_hasher->accumulateString("terrain-tiles-v0");
+  tile_hasher->finish();
+  auto tilepath = DataBlockCache::_generateCachePath(tile_hasher->result());
+
+  auto tilefile = std::make_shared<TerrainTileFile>();
+  if (not tilefile->open(tilepath)) {
+    // the only time the whole heightfield is in memory
+    auto heightfield = std::make_shared<HeightMap>(0, 0);
+    bool ok          = heightfield->Load(_hfinstance->hfpath());
+    ok               = ok and TerrainTileFile::bake(*heightfield, tilepath, HFDD->_streamTileSize);
+    ok               = ok and tilefile->open(tilepath);
+    if (not ok)
+      return false;
+  }
+
+  _streamContext             = context;
+  _streamer                  = std::make_shared<TerrainStreamer>(tilefile, _hfinstance->_worldSizeXZ, _hfinstance->_worldHeight);
+  _streamer->_residentBudget = size_t(HFDD->_streamResidentBudget);
+  _streamer->_lodDistance    = HFDD->_streamLodDistance;
+
+  ////////////////////////////////////////
+  // index buffers shared by every tile : quadrants (for partially
+  //  refined nodes) and the whole tile, quads split along +x+z
+  //  to match the morph targets
+  ////////////////////////////////////////
+
+  const int tilesize = tilefile->_header._tilesize;
+  const int half     = tilesize / 2;
+  const int nv       = tilesize + 1;
+  for (int q = 0; q < 5; q++) {
+    int i0 = (q == 4) ? 0 : (q & 1) * half;
+    int j0 = (q == 4) ? 0 : (q >> 1) * half;
+    int n  = (q == 4) ? tilesize : half;
+    std::vector<uint16_t> indices;
+    indices.reserve(n * n * 6);
+    for (int j = j0; j < j0 + n; j++) {
+      for (int i = i0; i < i0 + n; i++) {
+        uint16_t v00 = uint16_t(j * nv + i);
+        uint16_t v10 = v00 + 1;
+        uint16_t v01 = v00 + nv;
+        uint16_t v11 = v01 + 1;
+        indices.insert(indices.end(), {v00, v11, v10, v00, v01, v11});
+      }
+    }
+    _tileIndices[q]  = std::make_shared<tileidxbuf_t>(int(indices.size()));
+    auto gpuindexptr = (void*)context->GBI()->LockIB(*_tileIndices[q].get());
+    memcpy(gpuindexptr, indices.data(), indices.size() * sizeof(uint16_t));
+    context->GBI()->UnLockIB(*_tileIndices[q].get());
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TerrainRenderImpl::gpuUpdateStreaming(Context* context, const fvec3& campos, const fmtx4& mvp) {
+  fmtx4 ivp;
+  ivp.inverseOf(mvp);
+  Frustum frustum; // terrain space
+  frustum.set(ivp);
+  _streamer->update(campos, &frustum);
+
+  auto gbi = context->GBI();
+  for (auto tile : _streamer->_uploads) {
+    using vertex_t     = TerrainTile::vertex_t;
+    int numverts       = int(tile->_vertices.size());
+    auto VB            = VertexBufferBase::CreateVertexBuffer(vertex_t::meFormat, numverts, true);
+    auto gpuvtxpointer = (void*)gbi->LockVB(*VB.get(), 0, numverts);
+    memcpy(gpuvtxpointer, tile->_vertices.data(), numverts * sizeof(vertex_t));
+    gbi->UnLockVB(*VB.get());
+    tile->_gpuvertices = VB;
+    tile->_vertices.clear();
+    tile->_vertices.shrink_to_fit();
+  }
+  for (auto tile : _streamer->_evicted) {
+    if (tile->_gpuvertices)
+      gbi->ReleaseVB(*tile->_gpuvertices.get());
+    tile->_gpuvertices = nullptr;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TerrainRenderImpl::renderStreaming(Context* context) {
+  auto gbi = context->GBI();
+  for (const auto& sel : _streamer->_selection) {
+    auto vbuf = sel._tile->_gpuvertices;
+    if (nullptr == vbuf)
+      continue;
+    float morphlen = sel._morphEnd - sel._morphStart;
+    _terrainMaterial->bindParamVec2(_parMorphRange, fvec2(sel._morphStart, (morphlen > 0.0f) ? (1.0f / morphlen) : 0.0f));
+    if (sel._quadmask == 0xf)
+      gbi->DrawIndexedPrimitiveEML(*vbuf.get(), *_tileIndices[4].get(), PrimitiveType::TRIANGLES);
+    else {
+      for (int q = 0; q < 4; q++)
+        if (sel._quadmask & (1 << q))
+          gbi->DrawIndexedPrimitiveEML(*vbuf.get(), *_tileIndices[q].get(), PrimitiveType::TRIANGLES);
+    }
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void TerrainRenderImpl::render(const RenderContextInstData& RCID) {
@@ -982,7 +1140,7 @@ void TerrainRenderImpl::render(const RenderContextInstData& RCID) {
   const int iglX           = _heightfield->GetGridSizeX();
   const int iglZ           = _heightfield->GetGridSizeZ();
   const int terrain_ngrids = iglX * iglZ;
-  if (terrain_ngrids < 1024)
+  if (nullptr == _streamer and terrain_ngrids < 1024)
     return;
   ///////////////////////////////////////////////////////////////////
   // render
@@ -1043,6 +1201,18 @@ void TerrainRenderImpl::render(const RenderContextInstData& RCID) {
   auto tek_viz  = stereo1pass ? _tekDefGbuf1Stereo : _tekDefGbuf1;
   auto tek_pick = _tekPick;
 
+  if (_streamer) {
+    tek_viz  = stereo1pass ? _tekCdlodGbuf1Stereo : _tekCdlodGbuf1;
+    tek_pick = _tekCdlodPick;
+    // the selection follows the primary camera, once per frame.
+    //  pick, shadow and probe views draw what it selected
+    bool primary_view = not(bpick or CPD._isAuxiliaryView);
+    if (primary_view and _streamFrame != targ->GetTargetFrame()) {
+      _streamFrame = targ->GetTargetFrame();
+      gpuUpdateStreaming(targ, campos_mono, MVPC);
+    }
+  }
+
   _terrainMaterial->_rasterstate.SetCullTest(ECullTest::OFF);
 
   _terrainMaterial->begin(bpick ? tek_pick : tek_viz, RCFD);
@@ -1068,6 +1238,11 @@ void TerrainRenderImpl::render(const RenderContextInstData& RCID) {
   _terrainMaterial->bindParamFloat(_parGblendStepLo, HFDD->_gblend_steplo);
   _terrainMaterial->bindParamFloat(_parGblendStepHi, HFDD->_gblend_stephi);
 
+  if (_streamer) {
+    renderStreaming(targ);
+    _terrainMaterial->end(RCFD);
+    return;
+  }
   ////////////////////////////////
   // render L0
   ////////////////////////////////
@@ -0,0 +1,492 @@
+///////////////////////////////////////////////////////////////////////////////
+// streaming terrain (CDLOD), see terrain_streaming.h
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/lev2/gfx/terrain/terrain_streaming.h>
+#include <ork/util/logger.h>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace ork::lev2 {
+///////////////////////////////////////////////////////////////////////////////
+
+static void _computeLevelBases(const TerrainTileFile::Header& hdr, std::vector<size_t>& bases, size_t& numnodes) {
+  bases.resize(hdr._numlevels);
+  numnodes = 0;
+  for (int level = 0; level < hdr._numlevels; level++) {
+    size_t across = size_t((hdr._dim / hdr._tilesize) >> level);
+    bases[level]  = numnodes;
+    numnodes += across * across;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool TerrainTileFile::bake(const HeightMap& hmap, const std::string& path, int tilesize) {
+  const int gx = hmap.GetGridSizeX();
+  const int gz = hmap.GetGridSizeZ();
+  int dim      = 1;
+  while ((dim << 1) <= std::min(gx, gz))
+    dim <<= 1;
+  if (tilesize < 2 or (tilesize & (tilesize - 1)) or dim < tilesize)
+    return false;
+
+  Header hdr;
+  hdr._dim       = dim;
+  hdr._tilesize  = tilesize;
+  hdr._numlevels = 1;
+  while ((tilesize << (hdr._numlevels - 1)) < dim)
+    hdr._numlevels++;
+  hdr._hmin = hmap.GetMinHeight();
+  hdr._hmax = hmap.GetMaxHeight();
+  if (not(hdr._hmax > hdr._hmin))
+    hdr._hmax = hdr._hmin + 1.0f;
+
+  const float qscale = 65535.0f / (hdr._hmax - hdr._hmin);
+  auto quantized     = [&](int x, int z) -> uint16_t {
+    x       = std::clamp(x, 0, gx - 1);
+    z       = std::clamp(z, 0, gz - 1);
+    float q = (hmap.GetHeight(x, z) - hdr._hmin) * qscale + 0.5f;
+    return uint16_t(std::clamp(q, 0.0f, 65535.0f));
+  };
+
+  TerrainTileFile tf;
+  tf._header = hdr;
+  size_t numnodes = 0;
+  _computeLevelBases(hdr, tf._levelbase, numnodes);
+  tf._minmax.resize(numnodes);
+
+  ////////////////////////////////////////
+  // min/max : level 0 from the texels it covers,
+  //  coarser levels from their children (a superset of their samples)
+  ////////////////////////////////////////
+
+  for (int tz = 0; tz < tf.tilesAcross(0); tz++) {
+    for (int tx = 0; tx < tf.tilesAcross(0); tx++) {
+      uint16_t qmin = 0xffff;
+      uint16_t qmax = 0;
+      for (int j = 0; j <= tilesize; j++) {
+        for (int i = 0; i <= tilesize; i++) {
+          uint16_t q = quantized(tx * tilesize + i, tz * tilesize + j);
+          qmin       = std::min(qmin, q);
+          qmax       = std::max(qmax, q);
+        }
+      }
+      tf._minmax[tf.nodeIndex(0, tx, tz)] = fvec2(tf.decodeHeight(qmin), tf.decodeHeight(qmax));
+    }
+  }
+  for (int level = 1; level < hdr._numlevels; level++) {
+    for (int tz = 0; tz < tf.tilesAcross(level); tz++) {
+      for (int tx = 0; tx < tf.tilesAcross(level); tx++) {
+        fvec2 mm(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+        for (int q = 0; q < 4; q++) {
+          const auto& child = tf.nodeMinMax(level - 1, tx * 2 + (q & 1), tz * 2 + (q >> 1));
+          mm.x              = std::min(mm.x, child.x);
+          mm.y              = std::max(mm.y, child.y);
+        }
+        tf._minmax[tf.nodeIndex(level, tx, tz)] = mm;
+      }
+    }
+  }
+
+  ////////////////////////////////////////
+  // header, min/max table, then tiles in node order
+  ////////////////////////////////////////
+
+  FILE* fout = fopen(path.c_str(), "wb");
+  if (nullptr == fout)
+    return false;
+  bool ok = (1 == fwrite(&hdr, sizeof(Header), 1, fout));
+  std::vector<float> mmdata;
+  mmdata.reserve(numnodes * 2);
+  for (const auto& mm : tf._minmax) {
+    mmdata.push_back(mm.x);
+    mmdata.push_back(mm.y);
+  }
+  ok = ok and (mmdata.size() == fwrite(mmdata.data(), sizeof(float), mmdata.size(), fout));
+
+  const int nsamp = tf.samplesPerSide();
+  std::vector<uint16_t> samples(nsamp * nsamp);
+  for (int level = 0; ok and level < hdr._numlevels; level++) {
+    const int stride = 1 << level;
+    const int span   = tilesize << level;
+    for (int tz = 0; tz < tf.tilesAcross(level); tz++) {
+      for (int tx = 0; tx < tf.tilesAcross(level); tx++) {
+        for (int j = 0; j < nsamp; j++)
+          for (int i = 0; i < nsamp; i++)
+            samples[j * nsamp + i] = quantized(tx * span + (i - 1) * stride, tz * span + (j - 1) * stride);
+        ok = ok and (samples.size() == fwrite(samples.data(), sizeof(uint16_t), samples.size(), fout));
+      }
+    }
+  }
+  fclose(fout);
+  return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool TerrainTileFile::open(const std::string& path) {
+  FILE* fin = fopen(path.c_str(), "rb");
+  if (nullptr == fin)
+    return false;
+  bool ok = (1 == fread(&_header, sizeof(Header), 1, fin));
+  ok      = ok and (_header._magic == kMagic) and (_header._version == kVersion);
+  ok      = ok and (_header._tilesize >= 2) and (_header._dim >= _header._tilesize) and (_header._numlevels >= 1);
+  if (ok) {
+    size_t numnodes = 0;
+    _computeLevelBases(_header, _levelbase, numnodes);
+    std::vector<float> mmdata(numnodes * 2);
+    ok = (mmdata.size() == fread(mmdata.data(), sizeof(float), mmdata.size(), fin));
+    _minmax.resize(numnodes);
+    for (size_t i = 0; i < numnodes; i++)
+      _minmax[i] = fvec2(mmdata[i * 2 + 0], mmdata[i * 2 + 1]);
+    _tiledataoffset = sizeof(Header) + mmdata.size() * sizeof(float);
+    _path           = path;
+  }
+  fclose(fin);
+  return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+TerrainStreamer::TerrainStreamer(terraintilefile_ptr_t file, float worldsize, float worldheight)
+    : _file(file)
+    , _worldSize(worldsize)
+    , _worldHeight(worldheight) {
+  _completed = std::make_shared<completed_t>();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TerrainStreamer::~TerrainStreamer() {
+  waitIdle(); // completions point at the file
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TerrainStreamer::waitIdle() const {
+  for (auto batch : _batches)
+    batch->wait();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+float TerrainStreamer::nodeWorldSize(int level) const {
+  const auto& hdr = _file->_header;
+  return _worldSize * float(hdr._tilesize << level) / float(hdr._dim);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+AABox TerrainStreamer::nodeBounds(int level, int tx, int tz) const {
+  float size     = nodeWorldSize(level);
+  float x0       = float(tx) * size - _worldSize * 0.5f;
+  float z0       = float(tz) * size - _worldSize * 0.5f;
+  const auto& mm = _file->nodeMinMax(level, tx, tz);
+  return AABox(fvec3(x0, mm.x * _worldHeight, z0), fvec3(x0 + size, mm.y * _worldHeight, z0 + size));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ranges double per level, each range has to clear its node's diagonal
+//  (plus height) or a node could border one 2 levels away
+
+float TerrainStreamer::lodRange(int level) const {
+  if (level >= topLevel())
+    return std::numeric_limits<float>::max();
+  float base = (_lodDistance > 0.0f) ? _lodDistance : nodeWorldSize(0) * 2.5f;
+  return base * float(1 << level);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+terraintile_ptr_t TerrainStreamer::generateTile(
+    const TerrainTileFile& file, //
+    const uint16_t* samples,
+    float worldsize,
+    float worldheight,
+    int level,
+    int tx,
+    int tz) {
+  const auto& hdr = file._header;
+  const int tsize = hdr._tilesize;
+  const int nsamp = file.samplesPerSide();
+
+  auto tile    = std::make_shared<TerrainTile>();
+  tile->_level = level;
+  tile->_tx    = tx;
+  tile->_tz    = tz;
+
+  const float step = worldsize * float(1 << level) / float(hdr._dim);
+  const float x0   = float(tx * tsize) * step - worldsize * 0.5f;
+  const float z0   = float(tz * tsize) * step - worldsize * 0.5f;
+  auto height      = [&](int i, int j) -> float { //
+    return file.decodeHeight(samples[(j + 1) * nsamp + (i + 1)]) * worldheight;
+  };
+
+  ////////////////////////////////////////
+  // positions, normals (central differences through the apron)
+  ////////////////////////////////////////
+
+  const int nv = tsize + 1;
+  auto& verts  = tile->_vertices;
+  verts.resize(nv * nv);
+  fvec3 bbmin(std::numeric_limits<float>::max());
+  fvec3 bbmax(-std::numeric_limits<float>::max());
+  for (int j = 0; j < nv; j++) {
+    for (int i = 0; i < nv; i++) {
+      auto& vtx     = verts[j * nv + i];
+      vtx.mPosition = fvec3(x0 + float(i) * step, height(i, j), z0 + float(j) * step);
+      vtx.mNormal   = fvec3(height(i - 1, j) - height(i + 1, j), 2.0f * step, height(i, j - 1) - height(i, j + 1)).normalized();
+      bbmin         = bbmin.minXYZ(vtx.mPosition);
+      bbmax         = bbmax.maxXYZ(vtx.mPosition);
+    }
+  }
+  tile->_bounds = AABox(bbmin, bbmax);
+
+  ////////////////////////////////////////
+  // morph targets : odd vertices slide onto the next level's triangles
+  //  (every level splits its quads along +x+z, so the center of a
+  //   coarse quad lands on that diagonal)
+  ////////////////////////////////////////
+
+  auto P = [&](int i, int j) -> const fvec3& { return verts[j * nv + i].mPosition; };
+  for (int j = 0; j < nv; j++) {
+    for (int i = 0; i < nv; i++) {
+      bool oddx = (i & 1);
+      bool oddz = (j & 1);
+      fvec3 target;
+      if (oddx and oddz)
+        target = (P(i - 1, j - 1) + P(i + 1, j + 1)) * 0.5f;
+      else if (oddx)
+        target = (P(i - 1, j) + P(i + 1, j)) * 0.5f;
+      else if (oddz)
+        target = (P(i, j - 1) + P(i, j + 1)) * 0.5f;
+      else
+        target = P(i, j);
+      verts[j * nv + i].mUV = fvec4(target, 0.0f);
+    }
+  }
+  return tile;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TerrainStreamer::_request(int level, int tx, int tz) {
+  uint64_t key = tileKey(level, tx, tz);
+  if (_requested.count(key) or _requested.size() >= _maxInFlight)
+    return;
+  _requested.insert(key);
+  if (nullptr == _batch)
+    _batch = std::make_shared<file::AsyncReadBatch>();
+  auto tilefile     = _file;
+  auto completed    = _completed;
+  float worldsize   = _worldSize;
+  float worldheight = _worldHeight;
+  auto samples      = std::make_shared<std::vector<uint16_t>>(tilefile->tileBytes() / sizeof(uint16_t));
+  _batch->add(
+      tilefile->_path,
+      tilefile->tileOffset(level, tx, tz),
+      tilefile->tileBytes(),
+      samples->data(),
+      [=](file::asyncreadreq_ptr_t req) {
+        terraintile_ptr_t tile;
+        if (req->ok() and req->_bytesRead == tilefile->tileBytes())
+          tile = generateTile(*tilefile, samples->data(), worldsize, worldheight, level, tx, tz);
+        else { // collected as a failed request
+          tile         = std::make_shared<TerrainTile>();
+          tile->_level = level;
+          tile->_tx    = tx;
+          tile->_tz    = tz;
+        }
+        completed->atomicOp([tile](std::vector<terraintile_ptr_t>& tiles) { tiles.push_back(tile); });
+      });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+terraintile_ptr_t TerrainStreamer::_touch(int level, int tx, int tz) {
+  auto it = _resident.find(tileKey(level, tx, tz));
+  if (it == _resident.end())
+    return nullptr;
+  auto tile        = it->second;
+  tile->_lastframe = _frame;
+  _lru.splice(_lru.begin(), _lru, tile->_lruit);
+  return tile;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TerrainStreamer::_emit(terraintile_ptr_t tile, uint32_t quadmask) {
+  TerrainSelection sel;
+  sel._tile     = tile;
+  sel._quadmask = quadmask;
+  sel._morphEnd = lodRange(tile->_level);
+  if (tile->_level >= topLevel())
+    sel._morphStart = sel._morphEnd; // root never morphs
+  else {
+    float inner     = (tile->_level > 0) ? lodRange(tile->_level - 1) : 0.0f;
+    sel._morphStart = sel._morphEnd - (sel._morphEnd - inner) * _morphFraction;
+  }
+  _selection.push_back(sel);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static bool _sphereTouchesBox(const fvec3& center, float radius, const AABox& box) {
+  if (radius == std::numeric_limits<float>::max())
+    return true;
+  fvec3 nearest = center.maxXYZ(box.Min()).minXYZ(box.Max());
+  return (nearest - center).magnitudeSquared() <= (radius * radius);
+}
+
+static bool _frustumTouchesBox(const Frustum& frustum, const AABox& box) {
+  const fplane* planes[6] = {
+      &frustum._nearPlane,
+      &frustum._farPlane,
+      &frustum._leftPlane,
+      &frustum._rightPlane,
+      &frustum._topPlane,
+      &frustum._bottomPlane};
+  for (auto plane : planes) {
+    // corner furthest along the (inward) normal
+    fvec3 pos(
+        (plane->n.x >= 0.0f) ? box.Max().x : box.Min().x,
+        (plane->n.y >= 0.0f) ? box.Max().y : box.Min().y,
+        (plane->n.z >= 0.0f) ? box.Max().z : box.Min().z);
+    if (plane->isPointBehind(pos))
+      return false;
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool TerrainStreamer::_wantsNode(int level, int tx, int tz) const {
+  AABox box = nodeBounds(level, tx, tz);
+  if (not _sphereTouchesBox(_campos, lodRange(level), box))
+    return false;
+  return (nullptr == _frustum) or _frustumTouchesBox(*_frustum, box);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// true : the node took care of its area (drew it, or it is not visible)
+// false : out of range, the parent draws this quadrant at its own level
+
+bool TerrainStreamer::_selectNode(int level, int tx, int tz) {
+  AABox box = nodeBounds(level, tx, tz);
+  if (not _sphereTouchesBox(_campos, lodRange(level), box))
+    return false;
+  if (_frustum and not _frustumTouchesBox(*_frustum, box))
+    return true;
+  auto tile = _touch(level, tx, tz);
+  OrkAssert(tile); // parents only refine into resident children
+  if (level == 0 or not _sphereTouchesBox(_campos, lodRange(level - 1), box)) {
+    _emit(tile, 0xf);
+    return true;
+  }
+  ////////////////////////////////////////
+  // refine, once every child we would draw is resident
+  ////////////////////////////////////////
+  bool ready = true;
+  for (int q = 0; q < 4; q++) {
+    int cx = tx * 2 + (q & 1);
+    int cz = tz * 2 + (q >> 1);
+    if (_wantsNode(level - 1, cx, cz) and nullptr == _touch(level - 1, cx, cz)) {
+      _request(level - 1, cx, cz);
+      ready = false;
+    }
+  }
+  if (not ready) {
+    _emit(tile, 0xf);
+    return true;
+  }
+  uint32_t quadmask = 0;
+  for (int q = 0; q < 4; q++) {
+    if (not _selectNode(level - 1, tx * 2 + (q & 1), tz * 2 + (q >> 1)))
+      quadmask |= (1 << q);
+  }
+  if (quadmask)
+    _emit(tile, quadmask);
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// least recently used first, never the root or anything drawn this frame
+
+void TerrainStreamer::_evict() {
+  auto it = _lru.end();
+  while (_resident.size() > _residentBudget and it != _lru.begin()) {
+    --it;
+    auto tile = _resident[*it];
+    if (tile->_lastframe == _frame or tile->_level == topLevel())
+      continue;
+    _evicted.push_back(tile);
+    _resident.erase(*it);
+    it = _lru.erase(it);
+    _numEvicted++;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TerrainStreamer::update(const fvec3& campos, const Frustum* frustum) {
+  _frame++;
+  _campos  = campos;
+  _frustum = frustum;
+  _selection.clear();
+  _uploads.clear();
+  _evicted.clear();
+  _batches.erase(
+      std::remove_if(
+          _batches.begin(), //
+          _batches.end(),
+          [](file::asyncreadbatch_ptr_t batch) { return batch->numPending() == 0; }),
+      _batches.end());
+
+  ////////////////////////////////////////
+  // collect what the workers finished
+  ////////////////////////////////////////
+
+  std::vector<terraintile_ptr_t> finished;
+  _completed->atomicOp([&finished](std::vector<terraintile_ptr_t>& tiles) { finished.swap(tiles); });
+  for (auto tile : finished) {
+    uint64_t key = tileKey(tile->_level, tile->_tx, tile->_tz);
+    _requested.erase(key);
+    if (tile->_vertices.empty()) {
+      logerrchannel()->log("TerrainStreamer : tile<%d %d %d> failed to load", tile->_level, tile->_tx, tile->_tz);
+      continue;
+    }
+    _lru.push_front(key);
+    tile->_lruit     = _lru.begin();
+    tile->_lastframe = _frame;
+    _resident[key]   = tile;
+    _uploads.push_back(tile);
+    _numLoaded++;
+  }
+
+  ////////////////////////////////////////
+  // select from the root (pinned once resident)
+  ////////////////////////////////////////
+
+  int top = topLevel();
+  for (int tz = 0; tz < _file->tilesAcross(top); tz++) {
+    for (int tx = 0; tx < _file->tilesAcross(top); tx++) {
+      if (_resident.count(tileKey(top, tx, tz)))
+        _selectNode(top, tx, tz);
+      else
+        _request(top, tx, tz);
+    }
+  }
+  if (_batch) {
+    _batch->submit();
+    _batches.push_back(_batch);
+    _batch = nullptr;
+  }
+  _evict();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+} // namespace ork::lev2
+///////////////////////////////////////////////////////////////////////////////
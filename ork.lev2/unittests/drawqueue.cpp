@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/lev2/gfx/renderer/drawable.h>
+#include <utpp/UnitTest++.h>
+#include <thread>
+
+using namespace ork::lev2;
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(drawqueue_arena) {
+  DrawQueueArena arena;
+  DrawQueueTransferData xfdata;
+  using alloc_t = std::pmr::polymorphic_allocator<DrawQueueItem>;
+  size_t numblocks = 0;
+  for (int frame = 0; frame < 3; frame++) {
+    std::vector<drawqueueitem_ptr_t> items;
+    for (int i = 0; i < 1000; i++) {
+      auto item = std::allocate_shared<DrawQueueItem>(alloc_t(&arena), xfdata, &arena);
+      item->_usermap[uint32_t(i)].set<int>(i);
+      items.push_back(item);
+    }
+    CHECK_EQUAL(items[500]->_usermap.find(500)->second.get<int>(), 500);
+    CHECK(items[0]->_dqxferdata._worldTransform == xfdata._worldTransform);
+    CHECK_EQUAL(arena.recycle(), false); // items still referenced
+    CHECK(arena.lastFrameStats()._numallocs >= 2000); // item + usermap node
+    CHECK(arena.lastFrameStats()._numpinned > 0);
+    items.clear();
+    CHECK_EQUAL(arena.recycle(), true);
+    CHECK_EQUAL(arena.lastFrameStats()._numpinned, 0);
+    /////////////////////////////////////
+    // blocks are reused, not grown, frame over frame
+    /////////////////////////////////////
+    if (frame == 0)
+      numblocks = arena._blocks.size();
+    CHECK_EQUAL(arena._blocks.size(), numblocks);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// an item held across frames pins only its own block,
+//  the rest of the arena keeps being recycled
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(drawqueue_arena_pinned) {
+  DrawQueueArena arena;
+  DrawQueueTransferData xfdata;
+  using alloc_t = std::pmr::polymorphic_allocator<DrawQueueItem>;
+  drawqueueitem_ptr_t held;
+  size_t numblocks = 0;
+  for (int frame = 0; frame < 16; frame++) {
+    std::vector<drawqueueitem_ptr_t> items;
+    for (int i = 0; i < 1000; i++)
+      items.push_back(std::allocate_shared<DrawQueueItem>(alloc_t(&arena), xfdata, &arena));
+    if (frame == 0)
+      held = items[0];
+    items.clear();
+    CHECK_EQUAL(arena.recycle(), false);
+    CHECK_EQUAL(arena.lastFrameStats()._numpinned, 1);
+    if (frame == 1)
+      numblocks = arena._blocks.size();
+    if (frame > 1)
+      CHECK_EQUAL(arena._blocks.size(), numblocks);
+  }
+  CHECK_EQUAL(arena._numdeferred, 16);
+  held = nullptr;
+  CHECK_EQUAL(arena.recycle(), true);
+  CHECK_EQUAL(arena._numlive.load(), 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// an item still held when its DrawQueue goes away keeps the arena alive
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(drawqueue_item_outlives_queue) {
+  drawqueueitem_ptr_t held;
+  std::weak_ptr<DrawQueueArena> weak_arena;
+  Drawable drawable;
+  {
+    DrawQueue DB(0);
+    DrawQueueTransferData xfdata;
+    held = DB.MergeLayer("A")->enqueueDrawable(xfdata, &drawable);
+    held->_usermap[1].set<int>(7);
+    weak_arena = DB._arena;
+  }
+  CHECK(not weak_arena.expired());
+  CHECK_EQUAL(held->_usermap.find(1)->second.get<int>(), 7);
+  held = nullptr;
+  CHECK(weak_arena.expired());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// slabs filled on separate threads, merged back in slab order
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(drawqueue_slab_merge) {
+  constexpr int knumslabs = 8;
+  constexpr int kperslab  = 500;
+  DrawQueue DB(0);
+  auto layerA = DB.MergeLayer("A");
+  auto layerB = DB.MergeLayer("B");
+  std::vector<Drawable> drawables(knumslabs * kperslab);
+  std::vector<DrawQueueSlab> slabs(knumslabs);
+  std::vector<std::thread> threads;
+  for (int is = 0; is < knumslabs; is++) {
+    threads.emplace_back([&, is]() {
+      DrawQueueTransferData xfdata;
+      slabs[is].bindToThread();
+      for (int i = 0; i < kperslab; i++) {
+        int index  = is * kperslab + i;
+        auto layer = (index & 1) ? layerB : layerA;
+        layer->enqueueDrawable(xfdata, &drawables[index]);
+      }
+      slabs[is].unbindFromThread();
+    });
+  }
+  for (auto& thr : threads)
+    thr.join();
+  CHECK(DrawQueueSlab::boundToThread() == nullptr);
+
+  DB.mergeSlabs(slabs);
+
+  auto check_layer = [&](DrawQueueLayer* layer, int parity) {
+    const auto& items = layer->_items._unprotected_ref();
+    CHECK_EQUAL(size_t(knumslabs * kperslab / 2), items.size());
+    bool in_order = true;
+    int prev_serial = -1;
+    for (size_t i = 0; i < items.size(); i++) {
+      if (items[i]->_drawable != &drawables[i * 2 + parity])
+        in_order = false;
+      if (items[i]->_serialno <= prev_serial)
+        in_order = false;
+      prev_serial = items[i]->_serialno;
+    }
+    CHECK(in_order);
+    CHECK(layer->HasData());
+  };
+  check_layer(layerA, 0);
+  check_layer(layerB, 1);
+  for (auto& slab : slabs) {
+    for (auto& l : slab._layers)
+      CHECK(l._items.empty());
+  }
+}
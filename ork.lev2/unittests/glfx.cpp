@@ -9,7 +9,12 @@
 #include <ork/lev2/gfx/gfxenv.h>
 #include <ork/lev2/lev2_asset.h>
 #include <ork/kernel/opq.h>
+#include <ork/kernel/datacache.h>
 #include <utpp/UnitTest++.h>
+#include <gfx/gl/gl.h>
+#include <gfx/gl/glfx/glslfxi.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
 
 TEST(glfx1) {
   // we must load shaders on the main thread!
@@ -47,3 +52,97 @@ TEST(glfx1) {
 
   ork::opq::mainSerialQueue()->drain();
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// generated containers round trip through the DataBlockCache,
+//  and go stale when the driver or an imported file changes
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+const char* kcachetest_fx = R"(
+fxconfig fxcfg_default {
+  glsl_version = "150";
+}
+uniform_set ub_vtx {
+  mat4 mvp;
+}
+vertex_interface iface_vtest : ub_vtx {
+  inputs {
+    vec4 position : POSITION;
+  }
+  outputs {
+    vec4 frg_clr;
+  }
+}
+fragment_interface iface_ftest {
+  inputs {
+    vec4 frg_clr;
+  }
+  outputs {
+    layout(location = 0) vec4 out_clr;
+  }
+}
+state_block sb_test : default {
+  CullTest = PASS_FRONT;
+}
+vertex_shader vs_test : iface_vtest {
+  gl_Position = mvp * position;
+  frg_clr     = position;
+}
+fragment_shader ps_test : iface_ftest {
+  out_clr = frg_clr;
+}
+technique tek_test {
+  fxconfig = fxcfg_default;
+  pass p0 {
+    vertex_shader   = vs_test;
+    fragment_shader = ps_test;
+    state_block     = sb_test;
+  }
+}
+)";
+} // namespace
+
+TEST(glfx_containercache) {
+  using namespace ork::lev2::glslfx;
+  ork::opq::mainSerialQueue()->enqueue([&]() {
+    std::string name = "glfx_containercache_test";
+    std::string text = kcachetest_fx;
+    auto driverid    = driverIdentity();
+    CHECK(driverid.length() > 3);
+    /////////////////////////////////////
+    // key : driver, name and text all count
+    /////////////////////////////////////
+    uint64_t key = containerCacheKey(driverid, name, text.c_str(), text.length());
+    CHECK(key != containerCacheKey(driverid + "x", name, text.c_str(), text.length()));
+    CHECK(key != containerCacheKey(driverid, name + "x", text.c_str(), text.length()));
+    CHECK(key != containerCacheKey(driverid, name, text.c_str(), text.length() - 2));
+    /////////////////////////////////////
+    // a load populates the cache, which deserializes
+    //  back to the same container
+    /////////////////////////////////////
+    auto generated = LoadFxFromText(name, text);
+    CHECK(generated != nullptr);
+    auto block = ork::DataBlockCache::findDataBlock(key);
+    CHECK(block != nullptr);
+    auto cached = deserializeContainer(block, name);
+    CHECK(cached != nullptr);
+    CHECK_EQUAL(generated->_techniqueMap.size(), cached->_techniqueMap.size());
+    CHECK(cached->_techniqueMap.find("tek_test") != cached->_techniqueMap.end());
+    CHECK_EQUAL(generated->_vertexShaders.size(), cached->_vertexShaders.size());
+    CHECK_EQUAL(generated->vertexShader("vs_test")->mShaderText, cached->vertexShader("vs_test")->mShaderText);
+    CHECK_EQUAL(generated->fragmentShader("ps_test")->mShaderText, cached->fragmentShader("ps_test")->mShaderText);
+    /////////////////////////////////////
+    // an edited import invalidates the entry
+    /////////////////////////////////////
+    auto imppath = (boost::filesystem::temp_directory_path() / "ork_test_glfx_import.i").string();
+    std::ofstream(imppath) << "// version 1\n";
+    containerdeps_t deps = {ContainerDependency{imppath, fileContentHash(imppath)}};
+    auto depblock        = serializeContainer(generated, deps);
+    CHECK(deserializeContainer(depblock, name) != nullptr);
+    std::ofstream(imppath) << "// version 2\n";
+    CHECK(deserializeContainer(depblock, name) == nullptr);
+    boost::filesystem::remove(imppath);
+  });
+  ork::opq::mainSerialQueue()->drain();
+}
@@ -7,7 +7,19 @@
 
 #include <ork/pch.h>
 #include <ork/lev2/gfx/meshutil/meshutil.h>
+#include <ork/lev2/gfx/gfxvtxquant.h>
+#include <ork/lev2/gfx/gfxvtxbuf.h>
+#include <ork/lev2/gfx/meshutil/meshutil_optimize.h>
+#include <ork/lev2/gfx/meshutil/clusterizer.h>
+#include <ork/lev2/gfx/material_pbr.inl>
+#include <ork/lev2/gfx/gfxctxdummy.h>
+#include "gfx/meshutil/assimp_util.inl"
 #include <utpp/UnitTest++.h>
+#include <random>
+#include <map>
+#include <queue>
+#include <array>
+#include <set>
 
 namespace ork::meshutil {
 
@@ -44,4 +56,643 @@ TEST(MergeVertex) {
   CHECK_EQUAL(v1, v2);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(VertexWeldTable) {
+  std::mt19937_64 rng(0x5eed);
+  VertexWeldTable table;
+  std::unordered_map<uint64_t, uint32_t> reference;
+  for (uint32_t i = 0; i < 20000; i++) {
+    uint64_t h = rng() & 0xffff; // force plenty of repeats
+    if (table.find(h) == VertexWeldTable::kEMPTY) {
+      CHECK(reference.find(h) == reference.end());
+      table.insert(h, i);
+      reference[h] = i;
+    }
+  }
+  CHECK_EQUAL(table.size(), reference.size());
+  for (auto item : reference)
+    CHECK_EQUAL(table.find(item.first), item.second);
+  table.clear();
+  CHECK_EQUAL(table.size(), size_t(0));
+  CHECK_EQUAL(table.find(reference.begin()->first), VertexWeldTable::kEMPTY);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// the multimap based pruning pruneInfluences() replaced
+///////////////////////////////////////////////////////////////////////////////
+
+static PrunedInfluences _legacyPrune(const std::vector<RawInfluence>& influences) {
+  std::multimap<float, const std::string*> largestWeightMap;
+  std::multimap<float, const std::string*> prunedWeightMap;
+  for (auto infl : influences) {
+    float fw = infl._weight;
+    if (fw < 0.001)
+      fw = 0.001;
+    largestWeightMap.insert(std::make_pair(1.0f - fw, infl._jointpath));
+  }
+  int icount      = 0;
+  float totweight = 0.0f;
+  for (auto it : largestWeightMap) {
+    if (icount < 4) {
+      totweight += (1.0f - it.first);
+      icount++;
+    }
+  }
+  if (totweight == 0.0f)
+    totweight = 1.0f;
+  icount             = 0;
+  float newtotweight = 0.0f;
+  for (auto item : largestWeightMap) {
+    if (icount < 4) {
+      float fjointweight = (1.0f - item.first) / totweight;
+      newtotweight += fjointweight;
+      prunedWeightMap.insert(std::make_pair(fjointweight, item.second));
+      ++icount;
+    }
+  }
+  if (newtotweight == 0.0f)
+    newtotweight = 1.0f;
+  PrunedInfluences rval;
+  rval._count = int(prunedWeightMap.size());
+  int windex  = 0;
+  for (auto it = prunedWeightMap.rbegin(); it != prunedWeightMap.rend(); it++) {
+    rval._jointpaths[windex] = it->second;
+    rval._weights[windex]    = it->first / newtotweight;
+    windex++;
+  }
+  return rval;
+}
+
+TEST(PruneInfluences) {
+  std::mt19937 rng(1234);
+  std::vector<std::string> joints;
+  for (int i = 0; i < 16; i++)
+    joints.push_back(FormatString("/root/joint%d", i));
+  // coarse weights so ties are common
+  std::uniform_int_distribution<int> numdist(1, 9);
+  std::uniform_int_distribution<int> wdist(0, 8);
+  std::uniform_int_distribution<int> jdist(0, 15);
+  for (int iter = 0; iter < 5000; iter++) {
+    std::vector<RawInfluence> influences;
+    int numinf = numdist(rng);
+    for (int i = 0; i < numinf; i++)
+      influences.push_back(RawInfluence{&joints[jdist(rng)], float(wdist(rng)) * 0.125f});
+    auto expected = _legacyPrune(influences);
+    auto pruned   = pruneInfluences(influences.data(), influences.size());
+    CHECK_EQUAL(expected._count, pruned._count);
+    for (int i = 0; i < expected._count; i++) {
+      CHECK(expected._jointpaths[i] == pruned._jointpaths[i]);
+      CHECK_EQUAL(expected._weights[i], pruned._weights[i]);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// the serial, unordered_map welded import readFromAssimp() replaced
+//  (same node walk and vertex construction, multimap pruning above)
+///////////////////////////////////////////////////////////////////////////////
+
+static void _legacyImport(const file::Path& abspath, Mesh& out) {
+  auto dblock    = datablockFromFileAtPath(abspath);
+  auto extension = std::string(abspath.getExtension().c_str());
+  auto flags     = assimpImportFlags() | aiProcess_PopulateArmatureData;
+  auto scene     = aiImportFileFromMemory((const char*)dblock->data(), dblock->length(), flags, extension.c_str());
+  OrkAssert(scene);
+  auto parsedskel = parseSkeleton(scene);
+  bool is_skinned = parsedskel->_isSkinned;
+  //////////////////////////////////////////////
+  std::map<int, std::vector<std::pair<std::string, float>>> weightlut;
+  std::queue<aiNode*> nodestack;
+  nodestack.push(scene->mRootNode);
+  while (not nodestack.empty()) {
+    auto n = nodestack.front();
+    nodestack.pop();
+    for (int m = 0; m < n->mNumMeshes; ++m) {
+      const aiMesh* mesh = scene->mMeshes[n->mMeshes[m]];
+      for (int b = 0; b < mesh->mNumBones; b++) {
+        auto bone      = mesh->mBones[b];
+        auto bone_path = aiNodePathName(bone->mNode);
+        auto itb       = parsedskel->_xgmskelmap_by_path.find(bone_path);
+        if (itb == parsedskel->_xgmskelmap_by_path.end())
+          continue;
+        auto xgmnode = itb->second;
+        if (xgmnode->_varmap["visited_weights"].isA<bool>())
+          continue;
+        xgmnode->_varmap["visited_weights"].set<bool>(true);
+        for (int v = 0; v < bone->mNumWeights; v++)
+          weightlut[bone->mWeights[v].mVertexId].push_back(std::make_pair(bone_path, bone->mWeights[v].mWeight));
+      }
+    }
+    for (int i = 0; i < n->mNumChildren; ++i)
+      nodestack.push(n->mChildren[i]);
+  }
+  auto it_root       = parsedskel->_xgmskelmap_by_path.find(aiNodePathName(scene->mRootNode));
+  auto root_skelnode = (it_root != parsedskel->_xgmskelmap_by_path.end()) ? it_root->second : nullptr;
+  //////////////////////////////////////////////
+  auto& deformer_bones = out._varmap->makeValueForKey<bonename_set_t>("deformer_bones");
+  std::map<std::string, std::unordered_map<uint64_t, vertex_ptr_t>> weldmaps;
+  out._vertexExtents.BeginGrow();
+  nodestack.push(scene->mRootNode);
+  while (not nodestack.empty()) {
+    auto n = nodestack.front();
+    nodestack.pop();
+    fmtx4 ork_model_mtx;
+    fmtx3 ork_normal_mtx;
+    if (false == is_skinned) {
+      ork_model_mtx  = convertMatrix44(n->mTransformation);
+      ork_normal_mtx = ork_model_mtx.rotMatrix33();
+    }
+    for (int i = 0; i < n->mNumMeshes; ++i) {
+      const aiMesh* mesh = scene->mMeshes[n->mMeshes[i]];
+      auto& out_submesh  = out.MergeSubMesh(mesh->mName.data);
+      auto& weldmap      = weldmaps[mesh->mName.data];
+      bool has_colors    = mesh->mColors[0] != nullptr;
+      bool has_uvs       = mesh->mTextureCoords[0] != nullptr;
+      vertex muverts[4];
+      for (int t = 0; t < mesh->mNumFaces; ++t) {
+        const aiFace* face = &mesh->mFaces[t];
+        if (face->mNumIndices != 3)
+          continue;
+        vertex_ptr_t outvtx[3];
+        for (int fv = 0; fv < 3; fv++) {
+          int index      = face->mIndices[fv];
+          const auto& v  = mesh->mVertices[index];
+          const auto& nn = mesh->mNormals[index];
+          const auto& uv = (mesh->mTextureCoords[0])[index];
+          const auto& b  = (mesh->mBitangents)[index];
+          auto& muvtx    = muverts[fv];
+          muvtx.mPos     = fvec3_to_dvec3(fvec3(v.x, v.y, v.z).transform(ork_model_mtx).xyz());
+          muvtx.mNrm     = fvec3_to_dvec3(fvec3(nn.x, nn.y, nn.z).transform(ork_normal_mtx));
+          out._vertexExtents.Grow(dvec3_to_fvec3(muvtx.mPos));
+          if (has_colors)
+            muvtx.mCol[0] = fvec4(1, 1, 1, 1);
+          if (has_uvs) {
+            muvtx.miNumUvs            = 1;
+            muvtx.mUV[0].mMapTexCoord = fvec2(uv.x, uv.y);
+            muvtx.mUV[0].mMapBiNormal = fvec3(b.x, b.y, b.z).transform(ork_normal_mtx);
+          }
+          auto itw = weightlut.find(index);
+          if (is_skinned and itw != weightlut.end()) {
+            std::vector<RawInfluence> influences;
+            for (const auto& item : itw->second) {
+              influences.push_back(RawInfluence{&item.first, item.second});
+              deformer_bones.insert(item.first);
+            }
+            auto pruned        = _legacyPrune(influences);
+            muvtx.miNumWeights = pruned._count;
+            for (int iw = 0; iw < 4; iw++) {
+              muvtx._jointpaths[iw]   = root_skelnode->_path;
+              muvtx.mJointWeights[iw] = 0.0f;
+            }
+            for (int iw = 0; iw < pruned._count; iw++) {
+              muvtx._jointpaths[iw]   = *pruned._jointpaths[iw];
+              muvtx.mJointWeights[iw] = pruned._weights[iw];
+            }
+          }
+          ////////////////////////////////////////
+          // legacy weld : hash -> vertex map,
+          //  only first seen vertices reach the pool
+          ////////////////////////////////////////
+          uint64_t vhash = muvtx.hash();
+          auto itv       = weldmap.find(vhash);
+          if (itv == weldmap.end())
+            itv = weldmap.insert(std::make_pair(vhash, out_submesh.mergeVertex(muvtx))).first;
+          outvtx[fv] = itv->second;
+        }
+        out_submesh.mergePoly(Polygon(outvtx[0], outvtx[1], outvtx[2]));
+      }
+    }
+    for (int i = 0; i < n->mNumChildren; ++i)
+      nodestack.push(n->mChildren[i]);
+  }
+  out._vertexExtents.EndGrow();
+  aiReleaseImport(scene);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void _checkSameMesh(const Mesh& reference, const Mesh& imported) {
+  const auto& lut_r = reference.RefSubMeshLut();
+  const auto& lut_i = imported.RefSubMeshLut();
+  CHECK_EQUAL(lut_r.size(), lut_i.size());
+  CHECK(reference._vertexExtents.Min() == imported._vertexExtents.Min());
+  CHECK(reference._vertexExtents.Max() == imported._vertexExtents.Max());
+  for (auto item : lut_r) {
+    auto it = lut_i.find(item.first);
+    CHECK(it != lut_i.end());
+    if (it == lut_i.end())
+      continue;
+    auto sub_r = item.second;
+    auto sub_i = it->second;
+    CHECK_EQUAL(sub_r->numVertices(), sub_i->numVertices());
+    CHECK_EQUAL(sub_r->numPolys(), sub_i->numPolys());
+    if (sub_r->numVertices() != sub_i->numVertices() or sub_r->numPolys() != sub_i->numPolys())
+      continue;
+    for (int i = 0; i < sub_r->numVertices(); i++)
+      CHECK_EQUAL(sub_r->vertex(i)->hash(), sub_i->vertex(i)->hash());
+    for (int i = 0; i < sub_r->numPolys(); i++) {
+      auto poly_r = sub_r->poly(i);
+      auto poly_i = sub_i->poly(i);
+      CHECK_EQUAL(poly_r->numVertices(), poly_i->numVertices());
+      for (int v = 0; v < int(poly_r->numVertices()); v++)
+        CHECK_EQUAL(poly_r->vertexID(v), poly_i->vertexID(v));
+    }
+  }
+  auto bones_r = reference._varmap->typedValueForKey<bonename_set_t>("deformer_bones").value();
+  auto bones_i = imported._varmap->typedValueForKey<bonename_set_t>("deformer_bones").value();
+  CHECK(bones_r == bones_i);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// serial and parallel imports must both match the legacy import exactly
+///////////////////////////////////////////////////////////////////////////////
+
+static void _checkSameImport(const char* path) {
+  auto abspath = file::Path(path).toAbsolute();
+  Mesh legacy, serial, parallel;
+  _legacyImport(abspath, legacy);
+  serial._varmap->makeValueForKey<bool>("assimp.serial_import") = true;
+  serial.readFromAssimp(abspath);
+  parallel.readFromAssimp(abspath);
+  _checkSameMesh(legacy, serial);
+  _checkSameMesh(legacy, parallel);
+}
+
+TEST(ParallelAssimpImport) {
+  _checkSameImport("data://tests/bonetest_mesh.gltf");
+  _checkSameImport("data://tests/pbr_calib.glb");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// quantized xgm vertex streams : decode error and footprint on test models
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(QuantizedVertexHalf) {
+  using namespace lev2::vtxquant;
+  // every finite half survives a float roundtrip
+  int numbad = 0;
+  for (uint32_t h = 0; h < 65536; h++) {
+    if (((h >> 10) & 0x1f) == 31)
+      continue;
+    numbad += (floatToHalf(halfToFloat(U16(h))) != h) ? 1 : 0;
+  }
+  CHECK_EQUAL(numbad, 0);
+  CHECK_EQUAL(floatToHalf(1.0f), U16(0x3c00));
+  CHECK_EQUAL(floatToHalf(-2.0f), U16(0xc000));
+  CHECK_EQUAL(floatToHalf(65520.0f), U16(0x7c00));
+}
+
+static void _checkQuantizedStreams(const char* path) {
+  using namespace lev2::vtxquant;
+  Mesh mesh;
+  mesh.readFromAssimp(file::Path(path).toAbsolute());
+  bool is_skinned = false;
+  if (auto as_bool = mesh._varmap->typedValueForKey<bool>("is_skinned"))
+    is_skinned = as_bool.value();
+  size_t float_size = is_skinned ? sizeof(lev2::SVtxV12N12B12T8I4W4) : sizeof(lev2::SVtxV12N12B12T16);
+  size_t quant_size = is_skinned ? sizeof(lev2::SVtxV8N4B4T4I4W4) : sizeof(lev2::SVtxV8N4B4T8);
+  size_t numverts   = 0;
+  float max_poserr  = 0.0f; // relative to the bounds extent
+  float max_nrmdot  = 1.0f;
+  float max_uverr   = 0.0f; // relative to the uv magnitude
+  for (auto item : mesh.RefSubMeshLut()) {
+    auto sub         = item.second;
+    const auto& bbox = sub->aabox();
+    PositionQuantizer quantizer(bbox.Min(), bbox.Max());
+    const auto& ext  = quantizer._scale;
+    float extent     = std::max(ext.x, std::max(ext.y, ext.z));
+    for (int i = 0; i < sub->numVertices(); i++) {
+      const auto& vtx = *sub->vertex(i);
+      fvec3 pos(vtx.mPos.x, vtx.mPos.y, vtx.mPos.z);
+      U16 qpos[3];
+      quantizer.encode(pos, qpos);
+      max_poserr = std::max(max_poserr, (quantizer.decode(qpos) - pos).length() / extent);
+      fvec3 nrm(vtx.mNrm.x, vtx.mNrm.y, vtx.mNrm.z);
+      if (nrm.length() > 0.5f) {
+        nrm.normalizeInPlace();
+        S16 ox, oy;
+        octEncode(nrm, ox, oy);
+        max_nrmdot = std::min(max_nrmdot, nrm.dotWith(octDecode(ox, oy)));
+      }
+      const auto& uv = vtx.mUV[0].mMapTexCoord;
+      for (float c : {uv.x, uv.y}) {
+        float decoded = halfToFloat(floatToHalf(c));
+        max_uverr     = std::max(max_uverr, fabsf(decoded - c) / std::max(fabsf(c), 1.0f));
+      }
+      numverts++;
+    }
+  }
+  size_t float_bytes = numverts * float_size;
+  size_t quant_bytes = numverts * quant_size;
+  printf(
+      "quantized<%s> verts<%zu> float<%zu bytes> quant<%zu bytes> saved<%.1f%%> poserr<%g> nrmdot<%g> uverr<%g>\n",
+      path,
+      numverts,
+      float_bytes,
+      quant_bytes,
+      100.0 * double(float_bytes - quant_bytes) / double(float_bytes),
+      max_poserr,
+      max_nrmdot,
+      max_uverr);
+  CHECK(numverts > 0);
+  CHECK(quant_bytes * 2 <= float_bytes);
+  CHECK(max_poserr <= 1.0f / 65535.0f); // half a step per axis
+  CHECK(max_nrmdot > 0.99999f);
+  CHECK(max_uverr <= 1.0f / 2048.0f);
+}
+
+TEST(QuantizedVertexStreams) {
+  _checkQuantizedStreams("data://tests/bonetest_mesh.gltf");
+  _checkQuantizedStreams("data://tests/pbr_calib.glb");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// index optimization on a shuffled grid :
+//  same triangles (and winding) out, better post transform cache reuse
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(OptimizeIndexOrder) {
+  constexpr int kgrid = 64;
+  std::vector<fvec3> positions;
+  for (int y = 0; y <= kgrid; y++)
+    for (int x = 0; x <= kgrid; x++)
+      positions.push_back(fvec3(x, y, 0));
+  using tri_t = std::array<uint32_t, 3>;
+  std::vector<tri_t> tris;
+  for (int y = 0; y < kgrid; y++) {
+    for (int x = 0; x < kgrid; x++) {
+      uint32_t a = y * (kgrid + 1) + x;
+      uint32_t c = a + kgrid + 1;
+      tris.push_back(tri_t{a, a + 1, c + 1});
+      tris.push_back(tri_t{a, c + 1, c});
+    }
+  }
+  std::shuffle(tris.begin(), tris.end(), std::mt19937(7));
+  index_vect_t indices;
+  for (const auto& t : tris)
+    indices.insert(indices.end(), t.begin(), t.end());
+
+  // winding preserving canonical triangle set
+  auto canonical = [](const index_vect_t& inp, const index_vect_t* order) {
+    std::multiset<tri_t> rval;
+    for (size_t i = 0; i < inp.size(); i += 3) {
+      tri_t t{inp[i], inp[i + 1], inp[i + 2]};
+      if (order)
+        t = tri_t{(*order)[t[0]], (*order)[t[1]], (*order)[t[2]]};
+      std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+      rval.insert(t);
+    }
+    return rval;
+  };
+  auto reference = canonical(indices, nullptr);
+
+  auto before = analyzeVertexCache(indices, positions.size());
+  optimizeVertexCache(indices, positions.size());
+  optimizeOverdraw(indices, positions);
+  index_vect_t order;
+  size_t numout = optimizeVertexFetch(indices, order, positions.size());
+  auto after    = analyzeVertexCache(indices, numout);
+  CHECK(canonical(indices, &order) == reference);
+  CHECK_EQUAL(numout, positions.size());
+  CHECK(after._acmr < 0.8f);
+  CHECK(after._acmr < before._acmr);
+  // fetch order is first use order
+  uint32_t highest = 0;
+  for (auto i : indices) {
+    CHECK(i <= highest + 1);
+    highest = std::max(highest, i);
+  }
+
+  std::vector<fvec3> reordered;
+  for (auto iv : order)
+    reordered.push_back(positions[iv]);
+  auto meshlets  = buildMeshlets(indices, reordered);
+  size_t numtris = 0;
+  for (const auto& m : meshlets) {
+    CHECK(m._vertices.size() <= lev2::XgmMeshlet::kMAXVERTICES);
+    CHECK(m._triangles.size() <= lev2::XgmMeshlet::kMAXTRIANGLES * 3);
+    // flat +z grid : every meshlet is culled from below, none from above
+    CHECK(m.isBackfacing(m._center - fvec3(0, 0, 10)));
+    CHECK(not m.isBackfacing(m._center + fvec3(0, 0, 10)));
+    numtris += m._triangles.size() / 3;
+  }
+  CHECK_EQUAL(numtris, tris.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// uv sphere with a texture seam at phi=0 and pole fans
+///////////////////////////////////////////////////////////////////////////////
+
+static void _buildUvSphere(submesh& sphere) {
+  constexpr int knu = 64;
+  constexpr int knv = 32;
+  auto make_vertex = [&](int j, int i) -> vertex_ptr_t {
+    double theta = M_PI * double(j) / double(knv);
+    double phi   = 2.0 * M_PI * double(i % knu) / double(knu);
+    vertex v;
+    v.mPos                 = dvec3(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta));
+    v.mNrm                 = v.mPos;
+    v.mUV[0].mMapTexCoord  = fvec2(float(i) / float(knu), float(j) / float(knv));
+    v.miNumWeights         = 1;
+    v._jointpaths[0]       = (j < knv / 2) ? "upper" : "lower";
+    v.mJointWeights[0]     = 1.0f;
+    return sphere.mergeVertex(v);
+  };
+  std::vector<std::vector<vertex_ptr_t>> grid(knv + 1, std::vector<vertex_ptr_t>(knu + 1));
+  for (int j = 0; j <= knv; j++)
+    for (int i = 0; i <= knu; i++)
+      grid[j][i] = make_vertex(j, i);
+  for (int i = 0; i < knu; i++) {
+    sphere.mergePoly(Polygon(grid[0][i], grid[1][i], grid[1][i + 1]));
+    sphere.mergePoly(Polygon(grid[knv][i], grid[knv - 1][i + 1], grid[knv - 1][i]));
+  }
+  for (int j = 1; j < knv - 1; j++) {
+    for (int i = 0; i < knu; i++) {
+      auto a = grid[j][i];
+      auto b = grid[j][i + 1];
+      auto c = grid[j + 1][i];
+      auto d = grid[j + 1][i + 1];
+      sphere.mergePoly(Polygon(a, c, d));
+      sphere.mergePoly(Polygon(a, d, b));
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(SimplifyLodChain) {
+  submesh sphere;
+  _buildUvSphere(sphere);
+  auto volume_of = [](const submesh& inp, int& out_degenerates) {
+    double volume   = 0.0;
+    out_degenerates = 0;
+    inp.visitAllPolys([&](merged_poly_const_ptr_t p) {
+      auto a = inp.vertex(p->vertexID(0))->mPos;
+      auto b = inp.vertex(p->vertexID(1))->mPos;
+      auto c = inp.vertex(p->vertexID(2))->mPos;
+      volume += a.dotWith(b.crossWith(c)) / 6.0;
+      if ((b - a).crossWith(c - a).magnitude() < 1.0e-12)
+        out_degenerates++;
+    });
+    return volume;
+  };
+  int degenerates   = 0;
+  double ref_volume = volume_of(sphere, degenerates);
+  int numtris       = sphere.numPolys();
+
+  for (float ratio : {0.5f, 0.25f}) {
+    submesh simplified;
+    submeshSimplify(sphere, simplified, ratio);
+    double volume = volume_of(simplified, degenerates);
+    CHECK(simplified.numPolys() <= int(float(numtris) * ratio * 1.05f));
+    CHECK(simplified.numPolys() >= int(float(numtris) * ratio * 0.8f));
+    CHECK_EQUAL(degenerates, 0);
+    CHECK(fabs(volume - ref_volume) < 0.1 * ref_volume);
+    // half edge collapses : surviving vertices keep their exact source attributes
+    int numsrcverts = sphere.numVertices();
+    for (int iv = 0; iv < simplified.numVertices(); iv++) {
+      auto v = simplified.vertex(iv);
+      sphere.mergeVertex(*v);
+      CHECK_EQUAL(sphere.numVertices(), numsrcverts);
+    }
+  }
+
+  lev2::XgmModel model;
+  CHECK_EQUAL(model.numLods(), 1);
+  CHECK_EQUAL(model.selectLod(0.01f), 0);
+  model._lodScreenSizes = {0.25f, 0.125f};
+  CHECK_EQUAL(model.numLods(), 3);
+  CHECK_EQUAL(model.selectLod(1.0f), 0);
+  CHECK_EQUAL(model.selectLod(0.2f), 1);
+  CHECK_EQUAL(model.selectLod(0.01f), 2);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// xgm v2 : the LOD section (switch sizes, per LOD clusters and their
+//  indices) survives a write / read round trip
+///////////////////////////////////////////////////////////////////////////////
+
+static lev2::xgmcluster_ptr_list_t _buildLodClusters(lev2::Context& context, const submesh& inp) {
+  XgmClusterizerStd clusterizer;
+  MeshConfigurationFlags flags;
+  XgmClusterTri clustertri;
+  clusterizer.Begin();
+  inp.visitAllPolys([&](merged_poly_const_ptr_t p) {
+    for (int i = 0; i < 3; i++)
+      clustertri._vertex[i] = *inp.vertex(p->vertexID(i));
+    clusterizer.addTriangle(clustertri, flags);
+  });
+  clusterizer.End();
+  lev2::xgmcluster_ptr_list_t rval;
+  for (size_t ic = 0; ic < clusterizer.GetNumClusters(); ic++) {
+    auto clusterbuilder = clusterizer.GetCluster(int(ic));
+    auto xgm_cluster    = std::make_shared<lev2::XgmCluster>();
+    clusterbuilder->optimize();
+    clusterbuilder->buildVertexBuffer(context, lev2::EVtxStreamFormat::V12N12B12T16);
+    buildXgmCluster(context, xgm_cluster, clusterbuilder, true);
+    rval.push_back(xgm_cluster);
+  }
+  return rval;
+}
+
+TEST(XgmLodRoundTrip) {
+  lev2::ContextDummy dummy;
+  submesh lod0, lod1, lod2;
+  _buildUvSphere(lod0);
+  submeshSimplify(lod0, lod1, 0.5f);
+  submeshSimplify(lod1, lod2, 0.5f);
+
+  lev2::XgmModel source;
+  auto material = std::make_shared<lev2::PBRMaterial>();
+  material->SetName("lodtest"_pool);
+  source.AddMaterial(material);
+  auto mesh = std::make_shared<lev2::XgmMesh>();
+  mesh->SetMeshName("Mesh1"_pool);
+  source.AddMesh("Mesh1"_pool, mesh);
+  auto src_sub       = std::make_shared<lev2::XgmSubMesh>();
+  src_sub->_material = material;
+  src_sub->_clusters = _buildLodClusters(dummy, lod0);
+  src_sub->_lodClusters.push_back(_buildLodClusters(dummy, lod1));
+  src_sub->_lodClusters.push_back(_buildLodClusters(dummy, lod2));
+  mesh->AddSubMesh(src_sub);
+  source.SetBoundingCenter(fvec3(0, 0, 0));
+  source.SetBoundingRadius(1.0f);
+  source.SetBoundingAA_XYZ(fvec3(0, 0, 0));
+  source.SetBoundingAA_WHD(fvec3(1, 1, 1));
+  source._lodScreenSizes = {0.25f, 0.125f};
+
+  auto datablock = lev2::writeXgmToDatablock(&source);
+  CHECK(datablock != nullptr);
+
+  lev2::XgmModel readback;
+  readback._varmap.makeValueForKey<bool>("xgm.pickmesh") = false;
+  CHECK(lev2::XgmModel::_loadXGM(&readback, datablock));
+  CHECK_EQUAL(readback.numLods(), 3);
+  CHECK(readback._lodScreenSizes == source._lodScreenSizes);
+  CHECK_EQUAL(readback.selectLod(0.5f), 0);
+  CHECK_EQUAL(readback.selectLod(0.2f), 1);
+  CHECK_EQUAL(readback.selectLod(0.1f), 2);
+  CHECK_EQUAL(readback.numMeshes(), 1);
+  if (readback.numMeshes() != 1 or readback.mesh(0)->numSubMeshes() != 1)
+    return;
+
+  auto GBI     = lev2::contextForCurrentThread()->GBI();
+  auto dst_sub = readback.mesh(0)->subMesh(0);
+  CHECK_EQUAL(dst_sub->_lodClusters.size(), size_t(2));
+  size_t prev_numindices = 0;
+  for (int ilod = 0; ilod < 3; ilod++) {
+    const auto& src_clusters = src_sub->lodClusters(ilod);
+    const auto& dst_clusters = dst_sub->lodClusters(ilod);
+    CHECK_EQUAL(dst_clusters.size(), src_clusters.size());
+    size_t numindices = 0;
+    for (size_t ic = 0; ic < std::min(src_clusters.size(), dst_clusters.size()); ic++) {
+      auto src     = src_clusters[ic];
+      auto dst     = dst_clusters[ic];
+      int numverts = dst->_vertexBuffer->GetNumVertices();
+      CHECK_EQUAL(src->_vertexBuffer->GetNumVertices(), numverts);
+      CHECK(dst->mBoundingBox.Min() == src->mBoundingBox.Min());
+      CHECK(dst->mBoundingBox.Max() == src->mBoundingBox.Max());
+      CHECK(src->_meshlets.size() > 0);
+      CHECK_EQUAL(src->_meshlets.size(), dst->_meshlets.size());
+      for (size_t im = 0; im < std::min(src->_meshlets.size(), dst->_meshlets.size()); im++) {
+        const auto& src_m = src->_meshlets[im];
+        const auto& dst_m = dst->_meshlets[im];
+        CHECK(src_m._vertices == dst_m._vertices);
+        CHECK(src_m._triangles == dst_m._triangles);
+        CHECK(src_m._center == dst_m._center);
+        CHECK_EQUAL(src_m._radius, dst_m._radius);
+        CHECK(src_m._coneAxis == dst_m._coneAxis);
+        CHECK_EQUAL(src_m._coneCutoff, dst_m._coneCutoff);
+      }
+      CHECK_EQUAL(src->numPrimGroups(), dst->numPrimGroups());
+      if (src->numPrimGroups() != dst->numPrimGroups())
+        continue;
+      for (int ipg = 0; ipg < int(dst->numPrimGroups()); ipg++) {
+        const auto& src_ib = *src->primgroup(ipg)->GetIndexBuffer();
+        const auto& dst_ib = *dst->primgroup(ipg)->GetIndexBuffer();
+        int count          = dst->primgroup(ipg)->GetNumIndices();
+        CHECK_EQUAL(src->primgroup(ipg)->GetNumIndices(), count);
+        auto src_idx = (const uint16_t*)dummy.GBI()->LockIB(src_ib);
+        auto dst_idx = (const uint16_t*)GBI->LockIB(dst_ib);
+        bool same    = true;
+        int maxindex = 0;
+        for (int i = 0; i < count; i++) {
+          same     = same and (src_idx[i] == dst_idx[i]);
+          maxindex = std::max(maxindex, int(dst_idx[i]));
+        }
+        GBI->UnLockIB(dst_ib);
+        dummy.GBI()->UnLockIB(src_ib);
+        CHECK(same);
+        CHECK(maxindex < numverts);
+        numindices += size_t(count);
+      }
+    }
+    if (ilod > 0)
+      CHECK(numindices < prev_numindices);
+    prev_numindices = numindices;
+  }
+}
+
 } // namespace ork::meshutil
@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/lev2/gfx/raypick.h>
+#include <ork/lev2/gfx/gfxvtxbuf_structs.h>
+#include <ork/kernel/timer.h>
+#include <utpp/UnitTest++.h>
+#include <random>
+
+using namespace ork;
+using namespace ork::lev2;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// uv sphere, normals from the center, uv from the parameterization
+///////////////////////////////////////////////////////////////////////////////
+
+pickmesh_ptr_t makeSphereMesh(float radius, int rings, int segments) {
+  auto mesh  = std::make_shared<PickMesh>();
+  auto point = [&](int r, int s, fvec3& pos, fvec3& nrm, fvec2& uv) {
+    float theta = PI * float(r) / float(rings);
+    float phi   = PI2 * float(s) / float(segments);
+    nrm         = fvec3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+    pos         = nrm * radius;
+    uv          = fvec2(float(s) / float(segments), float(r) / float(rings));
+  };
+  for (int r = 0; r < rings; r++) {
+    for (int s = 0; s < segments; s++) {
+      fvec3 pos[4], nrm[4];
+      fvec2 uv[4];
+      point(r, s, pos[0], nrm[0], uv[0]);
+      point(r, s + 1, pos[1], nrm[1], uv[1]);
+      point(r + 1, s + 1, pos[2], nrm[2], uv[2]);
+      point(r + 1, s, pos[3], nrm[3], uv[3]);
+      fvec3 tpos[3] = {pos[0], pos[1], pos[2]};
+      fvec3 tnrm[3] = {nrm[0], nrm[1], nrm[2]};
+      fvec2 tuv[3]  = {uv[0], uv[1], uv[2]};
+      mesh->addTriangle(tpos, tnrm, tuv);
+      fvec3 bpos[3] = {pos[0], pos[2], pos[3]};
+      fvec3 bnrm[3] = {nrm[0], nrm[2], nrm[3]};
+      fvec2 buv[3]  = {uv[0], uv[2], uv[3]};
+      mesh->addTriangle(bpos, bnrm, buv);
+    }
+  }
+  mesh->build();
+  return mesh;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+float bruteForceDistance(const PickMesh& mesh, const fray3& ray) {
+  float best = std::numeric_limits<float>::infinity();
+  for (const auto& tri : mesh._triangles) {
+    fvec3 pvec = ray.mDirection.crossWith(tri._e2);
+    float det  = tri._e1.dotWith(pvec);
+    if (fabsf(det) < 1.0e-12f)
+      continue;
+    fvec3 tvec = ray.mOrigin - tri._p0;
+    float u    = tvec.dotWith(pvec) / det;
+    fvec3 qvec = tvec.crossWith(tri._e1);
+    float v    = ray.mDirection.dotWith(qvec) / det;
+    float t    = tri._e2.dotWith(qvec) / det;
+    if (u >= 0.0f and v >= 0.0f and (u + v) <= 1.0f and t > 0.0f)
+      best = std::min(best, t);
+  }
+  return best;
+}
+
+fray3 randomRay(std::mt19937& rng, float shell, float target) {
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  fvec3 from(unit(rng), unit(rng), unit(rng));
+  fvec3 to(unit(rng), unit(rng), unit(rng));
+  from = from.normalized() * shell;
+  to   = to * target;
+  return fray3(from, (to - from).normalized());
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// BVH traversal must find exactly what a linear scan finds,
+//  and survive the cache round trip
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RayPickMeshMatchesBruteForce) {
+  auto mesh = makeSphereMesh(1.0f, 64, 128);
+  CHECK_EQUAL(size_t(64 * 128 * 2), mesh->numTriangles());
+
+  auto cached = std::make_shared<PickMesh>();
+  CHECK(cached->deserialize(mesh->serialize()));
+  CHECK_EQUAL(mesh->numTriangles(), cached->numTriangles());
+
+  std::mt19937 rng(1234);
+  int mismatches  = 0;
+  int numhits     = 0;
+  int badnormals  = 0;
+  int cachemisses = 0;
+  for (int i = 0; i < 1000; i++) {
+    auto ray      = randomRay(rng, 3.0f, 1.3f);
+    float expect  = bruteForceDistance(*mesh, ray);
+    RayPickHit hit;
+    bool didhit = mesh->intersect(ray, hit);
+    if (didhit != std::isfinite(expect) or (didhit and fabsf(hit._distance - expect) > 1.0e-4f))
+      mismatches++;
+    RayPickHit hit2;
+    if (cached->intersect(ray, hit2) != didhit or (didhit and hit2._distance != hit._distance))
+      cachemisses++;
+    if (didhit) {
+      numhits++;
+      // interpolated sphere normals point away from the center
+      if (hit._normal.dotWith(hit._position.normalized()) < 0.99f)
+        badnormals++;
+    }
+  }
+  CHECK_EQUAL(0, mismatches);
+  CHECK_EQUAL(0, cachemisses);
+  CHECK_EQUAL(0, badnormals);
+  CHECK(numhits > 100);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// two level : 1000 transformed instances of one mesh
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RayPickSceneInstances) {
+  auto mesh = makeSphereMesh(0.4f, 32, 64);
+
+  PickScene scene;
+  std::mt19937 rng(4321);
+  std::uniform_real_distribution<float> angle(0.0f, PI2);
+  std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+  for (int ix = 0; ix < 10; ix++) {
+    for (int iy = 0; iy < 10; iy++) {
+      for (int iz = 0; iz < 10; iz++) {
+        fmtx4 world;
+        fvec3 pos(float(ix) * 2.0f - 9.0f, float(iy) * 2.0f - 9.0f, float(iz) * 2.0f - 9.0f);
+        world.compose(pos, fquat(fvec3(0, 1, 0), angle(rng)), scale(rng));
+        scene.addInstance(mesh, world, uint64_t(scene._instances.size()));
+      }
+    }
+  }
+  ork::Timer timer;
+  timer.Start();
+  scene.build();
+  double buildsecs = timer.SecsSinceStart();
+
+  constexpr int knumrays = 1000;
+  std::vector<fray3> rays;
+  for (int i = 0; i < knumrays; i++)
+    rays.push_back(randomRay(rng, 20.0f, 10.0f));
+
+  std::vector<RayPickHit> hits(knumrays);
+  timer.Start();
+  for (int i = 0; i < knumrays; i++)
+    scene.intersect(rays[i], hits[i]);
+  double picksecs = timer.SecsSinceStart();
+
+  int mismatches = 0;
+  int numhits    = 0;
+  for (int i = 0; i < knumrays; i++) {
+    // brute force over instances, same ray parameter in model space
+    float expect   = std::numeric_limits<float>::infinity();
+    int expect_idx = -1;
+    for (size_t j = 0; j < scene._instances.size(); j++) {
+      const auto& inst = scene._instances[j];
+      fvec3 o          = fvec4(rays[i].mOrigin, 1.0f).transform(inst._invworld).xyz();
+      fvec3 d          = fvec4(rays[i].mDirection, 0.0f).transform(inst._invworld).xyz();
+      float t          = bruteForceDistance(*mesh, fray3(o, d));
+      if (t < expect) {
+        expect     = t;
+        expect_idx = int(j);
+      }
+    }
+    const auto& hit = hits[i];
+    if ((hit._instance >= 0) != (expect_idx >= 0))
+      mismatches++;
+    else if (expect_idx >= 0) {
+      numhits++;
+      if (fabsf(hit._distance - expect) > 1.0e-3f)
+        mismatches++;
+      fvec3 wpos = rays[i].mOrigin + rays[i].mDirection * hit._distance;
+      if ((wpos - hit._position).magnitude() > 1.0e-3f)
+        mismatches++;
+    }
+  }
+  printf(
+      "RayPickSceneInstances: instances<%zu> build<%g ms> pick<%g us/ray> hits<%d>\n",
+      scene._instances.size(),
+      buildsecs * 1000.0,
+      picksecs * 1.0e6 / double(knumrays),
+      numhits);
+  CHECK_EQUAL(0, mismatches);
+  CHECK(numhits > 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// xgm cluster decode : one strip quad in the xy plane, uv = xy
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(RayPickClusterDecode) {
+  std::vector<SVtxV12N12B12T8C4> verts;
+  fvec3 nrm(0, 0, 1);
+  fvec3 bin(0, 1, 0);
+  verts.emplace_back(fvec3(0, 0, 0), nrm, bin, fvec2(0, 0));
+  verts.emplace_back(fvec3(1, 0, 0), nrm, bin, fvec2(1, 0));
+  verts.emplace_back(fvec3(0, 1, 0), nrm, bin, fvec2(0, 1));
+  verts.emplace_back(fvec3(1, 1, 0), nrm, bin, fvec2(1, 1));
+  U16 strip[4] = {0, 1, 2, 3};
+
+  PickMesh mesh;
+  bool ok = mesh.addCluster(
+      EVtxStreamFormat::V12N12B12T8C4,
+      verts.data(),
+      int(verts.size()),
+      fvec3(0, 0, 0),
+      fvec3(1, 1, 0),
+      PrimitiveType::TRIANGLESTRIP,
+      strip,
+      4);
+  CHECK(ok);
+  mesh.build();
+  CHECK_EQUAL(size_t(2), mesh.numTriangles());
+
+  RayPickHit hit;
+  CHECK(mesh.intersect(fray3(fvec3(0.25f, 0.75f, 5.0f), fvec3(0, 0, -1)), hit));
+  CHECK_CLOSE(5.0f, hit._distance, 1.0e-5f);
+  CHECK_CLOSE(0.25f, hit._uv.x, 1.0e-5f);
+  CHECK_CLOSE(0.75f, hit._uv.y, 1.0e-5f);
+  CHECK_CLOSE(1.0f, hit._normal.z, 1.0e-5f);
+
+  RayPickHit miss;
+  CHECK(not mesh.intersect(fray3(fvec3(1.5f, 0.5f, 5.0f), fvec3(0, 0, -1)), miss));
+}
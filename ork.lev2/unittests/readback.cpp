@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <utpp/UnitTest++.h>
+#include <ork/kernel/opq.h>
+#include <ork/lev2/gfx/gfxenv.h>
+#include <vector>
+
+using namespace ork;
+using namespace ork::lev2;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// a gpu that finishes submissions in order, up to _gpuDone
+//  each readback's texels are its request's _x
+///////////////////////////////////////////////////////////////////////////////
+
+struct FakeReadback final : public ReadbackInterface {
+  FakeReadback(int numslots)
+      : ReadbackInterface(*contextForCurrentThread(), numslots)
+      , _sequence(numslots, 0)
+      , _values(numslots, 0) {
+  }
+  void _doSubmit(int slot, const ReadbackRequest& req) final {
+    _sequence[slot] = ++_numSubmitted;
+    _values[slot]   = uint32_t(req._x);
+  }
+  bool _doPoll(int slot) final {
+    return _sequence[slot] <= _gpuDone;
+  }
+  void _doWait(int slot) final {
+    _numWaits++;
+    _gpuDone = std::max(_gpuDone, _sequence[slot]);
+  }
+  void _doFetch(int slot, ReadbackResult& result) final {
+    auto texels = (uint32_t*)result._bytes.data();
+    for (int i = 0; i < result._width * result._height; i++)
+      texels[i] = _values[slot];
+  }
+  std::vector<int> _sequence;
+  std::vector<uint32_t> _values;
+  int _numSubmitted = 0;
+  int _gpuDone      = 0;
+  int _numWaits     = 0;
+};
+
+struct Delivered {
+  std::vector<readbackresult_ptr_t> _results;
+  void enqueue(ReadbackInterface& rbi, int value) {
+    ReadbackRequest req;
+    req._x          = value;
+    req._width      = 2;
+    req._height     = 2;
+    req._format     = EBufferFormat::R32UI;
+    req._queue      = opq::mainSerialQueue();
+    req._onComplete = [this](readbackresult_ptr_t result) { _results.push_back(result); };
+    rbi.enqueue(req);
+  }
+  size_t count() {
+    opq::mainSerialQueue()->drain();
+    return _results.size();
+  }
+};
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// nothing is delivered before the gpu is done or inside the submit frame,
+//  and results come back in submission order
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(ReadbackRingLatency) {
+  FakeReadback rbi(4);
+  Delivered delivered;
+  rbi.poll(10);
+  delivered.enqueue(rbi, 100);
+  delivered.enqueue(rbi, 101);
+  delivered.enqueue(rbi, 102);
+  CHECK_EQUAL(size_t(3), rbi.numInFlight());
+
+  rbi._gpuDone = 3;
+  rbi.poll(10); // same frame : fences not tested yet
+  CHECK_EQUAL(size_t(0), delivered.count());
+  CHECK_EQUAL(size_t(0), rbi.stats()._numPolls);
+
+  rbi._gpuDone = 2;
+  rbi.poll(11);
+  CHECK_EQUAL(size_t(2), delivered.count());
+  CHECK_EQUAL(size_t(1), rbi.numInFlight());
+  CHECK_EQUAL(size_t(1), rbi.stats()._numNotReady);
+
+  rbi._gpuDone = 3;
+  rbi.poll(13);
+  CHECK_EQUAL(size_t(3), delivered.count());
+  CHECK_EQUAL(size_t(0), rbi.numInFlight());
+  for (int i = 0; i < 3; i++) {
+    auto r = delivered._results[i];
+    CHECK_EQUAL(uint64_t(i + 1), r->_ticket);
+    CHECK_EQUAL(10, r->_submitFrame);
+    CHECK_EQUAL(size_t(16), r->_bytes.size());
+    CHECK_EQUAL(uint32_t(100 + i), r->texel<uint32_t>(1, 1));
+  }
+  CHECK_EQUAL(13, delivered._results[2]->_completeFrame);
+  auto stats = rbi.stats();
+  CHECK_EQUAL(size_t(3), stats._numCompleted);
+  CHECK_EQUAL(size_t(0), stats._numStalls);
+  CHECK_EQUAL(0, rbi._numWaits);
+  CHECK_CLOSE(5.0f / 3.0f, stats.averageLatency(), 1.0e-5f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// a full ring waits on its oldest slot only, flush waits on the rest
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(ReadbackRingOverflow) {
+  FakeReadback rbi(2);
+  Delivered delivered;
+  for (int i = 0; i < 5; i++)
+    delivered.enqueue(rbi, i);
+  CHECK_EQUAL(size_t(2), rbi.numInFlight());
+  CHECK_EQUAL(size_t(3), delivered.count());
+  CHECK_EQUAL(size_t(3), rbi.stats()._numStalls);
+  CHECK_EQUAL(3, rbi._numWaits);
+
+  rbi.flush();
+  CHECK_EQUAL(size_t(5), delivered.count());
+  CHECK_EQUAL(size_t(0), rbi.numInFlight());
+  for (int i = 0; i < 5; i++)
+    CHECK_EQUAL(uint32_t(i), delivered._results[i]->texel<uint32_t>(0, 0));
+}
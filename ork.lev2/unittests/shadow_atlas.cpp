@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <utpp/UnitTest++.h>
+#include <ork/lev2/gfx/lighting/shadow_atlas.h>
+#include <vector>
+
+using namespace ork;
+using namespace ork::lev2;
+
+namespace {
+
+using request_t = ShadowAtlasLayout::Request;
+
+int _keys[512];
+
+request_t makeRequest(int index, float screensize, uint64_t lightstate = 1) {
+  request_t req;
+  req._key        = &_keys[index];
+  req._screenSize = screensize;
+  req._maxSize    = 1024;
+  req._lightState = lightstate;
+  return req;
+}
+
+// every tile inside the atlas, aligned to its size, and no two overlapping
+int countLayoutErrors(const ShadowAtlasLayout& layout) {
+  int errors = 0;
+  std::vector<ShadowAtlasTile> tiles;
+  for (const auto& item : layout._slots) {
+    const auto& t = item.second._tile;
+    if (t._size < layout._minTile or (t._x % t._size) != 0 or (t._y % t._size) != 0)
+      errors++;
+    if (t._x + t._size > layout._atlasDim or t._y + t._size > layout._atlasDim)
+      errors++;
+    tiles.push_back(t);
+  }
+  for (size_t i = 0; i < tiles.size(); i++) {
+    for (size_t j = i + 1; j < tiles.size(); j++) {
+      const auto& a = tiles[i];
+      const auto& b = tiles[j];
+      bool apart    = (a._x + a._size <= b._x) or (b._x + b._size <= a._x) //
+                   or (a._y + a._size <= b._y) or (b._y + b._size <= a._y);
+      if (not apart)
+        errors++;
+    }
+  }
+  return errors;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(ShadowAtlasDesiredSize) {
+  ShadowAtlasLayout layout(4096, 128);
+  CHECK_EQUAL(128, layout.desiredSize(0.0f, 1024));
+  CHECK_EQUAL(128, layout.desiredSize(100.0f, 1024));
+  CHECK_EQUAL(256, layout.desiredSize(129.0f, 1024));
+  CHECK_EQUAL(512, layout.desiredSize(400.0f, 1024));
+  CHECK_EQUAL(1024, layout.desiredSize(5000.0f, 1024));
+  CHECK_EQUAL(512, layout.desiredSize(5000.0f, 700));  // light's own max (floored to pow2)
+  CHECK_EQUAL(2048, layout.desiredSize(5000.0f, 8192)); // half the atlas at most
+  layout._texelsPerPixel = 2.0f;
+  CHECK_EQUAL(256, layout.desiredSize(100.0f, 1024));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(ShadowAtlasPacking) {
+  ShadowAtlasLayout layout(4096, 128);
+  std::vector<request_t> requests;
+  float sizes[] = {1500.0f, 20.0f, 300.0f, 700.0f, 200.0f, 1000.0f, 50.0f, 130.0f, 600.0f};
+  for (int i = 0; i < 9; i++)
+    requests.push_back(makeRequest(i, sizes[i]));
+  layout.update(requests, 0);
+  CHECK_EQUAL(size_t(9), layout._slots.size());
+  CHECK_EQUAL(0, countLayoutErrors(layout));
+  CHECK_EQUAL(1024, layout.slot(&_keys[0])->_tile._size);
+  CHECK_EQUAL(128, layout.slot(&_keys[1])->_tile._size);
+  CHECK_EQUAL(512, layout.slot(&_keys[2])->_tile._size);
+  fvec4 uvr = layout.slot(&_keys[0])->_tile.uvRect(4096);
+  CHECK_CLOSE(0.25f, uvr.z, 1.0e-6f);
+
+  // more lights than fit at full size : biggest tiles shrink, layout stays valid
+  requests.clear();
+  for (int i = 0; i < 256; i++)
+    requests.push_back(makeRequest(i, 5000.0f));
+  layout.update(requests, 0);
+  CHECK_EQUAL(size_t(256), layout._slots.size());
+  CHECK_EQUAL(0, countLayoutErrors(layout));
+  int64_t area = 0;
+  for (const auto& item : layout._slots)
+    area += int64_t(item.second._tile._size) * int64_t(item.second._tile._size);
+  CHECK(area <= int64_t(4096) * int64_t(4096));
+  CHECK_EQUAL(256, layout.slot(&_keys[0])->_tile._size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// small coverage changes do not resize (or move) anything
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(ShadowAtlasHysteresis) {
+  ShadowAtlasLayout layout(4096, 128);
+  std::vector<request_t> requests;
+  for (int i = 0; i < 4; i++)
+    requests.push_back(makeRequest(i, 900.0f));
+  layout.update(requests, 0);
+  CHECK_EQUAL(size_t(1), layout._numRepacks);
+  auto before = layout.slot(&_keys[2])->_tile;
+
+  requests[2]._screenSize = 500.0f; // wants 512, has 1024 : keep
+  layout.update(requests, 0);
+  requests[2]._screenSize = 300.0f; // wants 512, has 1024 : keep
+  layout.update(requests, 0);
+  CHECK_EQUAL(size_t(1), layout._numRepacks);
+  CHECK(layout.slot(&_keys[2])->_tile == before);
+
+  requests[2]._screenSize = 200.0f; // wants 256 : 4x too big, shrink
+  layout.update(requests, 0);
+  CHECK_EQUAL(size_t(2), layout._numRepacks);
+  CHECK_EQUAL(256, layout.slot(&_keys[2])->_tile._size);
+
+  requests[2]._screenSize = 300.0f; // wants 512 : grow right away
+  layout.update(requests, 0);
+  CHECK_EQUAL(size_t(3), layout._numRepacks);
+  CHECK_EQUAL(512, layout.slot(&_keys[2])->_tile._size);
+  CHECK_EQUAL(0, countLayoutErrors(layout));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// static depth is only re-rendered when it went stale
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(ShadowAtlasStaticCache) {
+  ShadowAtlasLayout layout(4096, 128);
+  std::vector<request_t> requests;
+  for (int i = 0; i < 3; i++)
+    requests.push_back(makeRequest(i, 900.0f, 100 + i));
+
+  auto render_stale = [&]() -> int {
+    int count = 0;
+    for (const auto& req : requests) {
+      if (layout.needsStaticRender(req._key)) {
+        layout.markStaticRendered(req._key);
+        count++;
+      }
+    }
+    return count;
+  };
+
+  layout.update(requests, 7);
+  CHECK_EQUAL(3, render_stale());
+  layout.update(requests, 7);
+  CHECK_EQUAL(0, render_stale()); // nothing changed
+
+  requests[1]._lightState = 555; // light moved
+  layout.update(requests, 7);
+  CHECK(not layout.needsStaticRender(requests[0]._key));
+  CHECK(layout.needsStaticRender(requests[1]._key));
+  CHECK_EQUAL(1, render_stale());
+
+  layout.update(requests, 8); // a static caster moved
+  CHECK_EQUAL(3, render_stale());
+
+  // a new bigger light pushes the others to new tiles
+  requests.insert(requests.begin(), makeRequest(3, 2000.0f, 103));
+  requests[0]._maxSize = 2048;
+  layout.update(requests, 8);
+  CHECK_EQUAL(4, render_stale());
+  CHECK_EQUAL(0, countLayoutErrors(layout));
+  CHECK_EQUAL(size_t(3 + 1 + 3 + 4), layout._numStaticRenders);
+
+  // removed lights drop their slots
+  requests.pop_back();
+  layout.update(requests, 8);
+  CHECK_EQUAL(size_t(3), layout._slots.size());
+  CHECK(nullptr == layout.slot(&_keys[2]));
+}
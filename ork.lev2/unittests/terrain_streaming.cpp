@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/lev2/gfx/terrain/terrain_streaming.h>
+#include <utpp/UnitTest++.h>
+#include <boost/filesystem.hpp>
+
+using namespace ork;
+using namespace ork::lev2;
+
+namespace {
+
+constexpr float kWorldSize   = 4096.0f;
+constexpr float kWorldHeight = 600.0f;
+
+///////////////////////////////////////////////////////////////////////////////
+// rolling hills, normalized like HeightMap::Load leaves them (-0.5 .. 0.5)
+///////////////////////////////////////////////////////////////////////////////
+
+terraintilefile_ptr_t makeTileFile(int dim, int tilesize) {
+  HeightMap hmap(dim, dim);
+  for (int iz = 0; iz < dim; iz++)
+    for (int ix = 0; ix < dim; ix++)
+      hmap.SetHeight(ix, iz, 0.5f * sinf(float(ix) * 0.05f) * cosf(float(iz) * 0.031f));
+  auto path = (boost::filesystem::temp_directory_path() / "ork_test_terrain_streaming.ortt").string();
+  auto file = std::make_shared<TerrainTileFile>();
+  if (not TerrainTileFile::bake(hmap, path, tilesize) or not file->open(path))
+    return nullptr;
+  return file;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// every level 0 cell drawn exactly once (no holes, no overlap)
+///////////////////////////////////////////////////////////////////////////////
+
+bool selectionCoversTerrain(const TerrainStreamer& streamer) {
+  const int across = streamer._file->tilesAcross(0);
+  std::vector<int> coverage(across * across, 0);
+  for (const auto& sel : streamer._selection) {
+    int level = sel._tile->_level;
+    if (level == 0) {
+      if (sel._quadmask != 0xf)
+        return false;
+      coverage[sel._tile->_tz * across + sel._tile->_tx]++;
+      continue;
+    }
+    int qspan = 1 << (level - 1); // level 0 cells per quadrant side
+    for (int q = 0; q < 4; q++) {
+      if (0 == (sel._quadmask & (1 << q)))
+        continue;
+      int cx0 = (sel._tile->_tx * 2 + (q & 1)) * qspan;
+      int cz0 = (sel._tile->_tz * 2 + (q >> 1)) * qspan;
+      for (int cz = cz0; cz < cz0 + qspan; cz++)
+        for (int cx = cx0; cx < cx0 + qspan; cx++)
+          coverage[cz * across + cx]++;
+    }
+  }
+  for (int c : coverage)
+    if (c != 1)
+      return false;
+  return true;
+}
+
+void settle(TerrainStreamer& streamer, const fvec3& campos) {
+  for (int i = 0; i < 64; i++) {
+    streamer.update(campos);
+    if (streamer.numInFlight() == 0)
+      return;
+    streamer.waitIdle();
+  }
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// tile meshes : level 0 lands on the heightfield, even vertices don't morph,
+//  odd ones morph onto the level above
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(TerrainStreamingTileMesh) {
+  auto file = makeTileFile(512, 32);
+  CHECK(file != nullptr);
+  CHECK_EQUAL(5, file->_header._numlevels);
+  CHECK_EQUAL(16, file->tilesAcross(0));
+
+  for (int level : {0, 2}) {
+    std::vector<uint16_t> samples(file->tileBytes() / sizeof(uint16_t));
+    FILE* fin = fopen(file->_path.c_str(), "rb");
+    fseek(fin, long(file->tileOffset(level, 1, 2)), SEEK_SET);
+    CHECK_EQUAL(samples.size(), fread(samples.data(), sizeof(uint16_t), samples.size(), fin));
+    fclose(fin);
+    auto tile = TerrainStreamer::generateTile(*file, samples.data(), kWorldSize, kWorldHeight, level, 1, 2);
+    CHECK_EQUAL(size_t(33 * 33), tile->_vertices.size());
+
+    const float texel   = kWorldSize / 512.0f;
+    const float quantum = kWorldHeight / 65535.0f;
+    int badpos = 0, badmorph = 0, badnormal = 0;
+    for (int j = 0; j <= 32; j++) {
+      for (int i = 0; i <= 32; i++) {
+        const auto& vtx = tile->_vertices[j * 33 + i];
+        int ix          = (1 * 32 + i) << level;
+        int iz          = (2 * 32 + j) << level;
+        float expect_y  = 0.5f * sinf(float(ix) * 0.05f) * cosf(float(iz) * 0.031f) * kWorldHeight;
+        if (fabsf(vtx.mPosition.x - (float(ix) * texel - kWorldSize * 0.5f)) > 1.0e-3f)
+          badpos++;
+        if (fabsf(vtx.mPosition.y - expect_y) > quantum)
+          badpos++;
+        fvec3 target = vtx.mUV.xyz();
+        bool even    = (0 == (i & 1)) and (0 == (j & 1));
+        if (even and (target - vtx.mPosition).magnitude() > 1.0e-5f)
+          badmorph++;
+        if (fabsf(vtx.mNormal.magnitude() - 1.0f) > 1.0e-4f or vtx.mNormal.y <= 0.0f)
+          badnormal++;
+      }
+    }
+    // the center of a coarse quad morphs onto its +x+z diagonal
+    const auto& center = tile->_vertices[1 * 33 + 1];
+    fvec3 diag         = (tile->_vertices[0].mPosition + tile->_vertices[2 * 33 + 2].mPosition) * 0.5f;
+    if ((center.mUV.xyz() - diag).magnitude() > 1.0e-4f)
+      badmorph++;
+    CHECK_EQUAL(0, badpos);
+    CHECK_EQUAL(0, badmorph);
+    CHECK_EQUAL(0, badnormal);
+    CHECK(tile->_bounds.Min().y >= file->nodeMinMax(level, 1, 2).x * kWorldHeight - quantum);
+    CHECK(tile->_bounds.Max().y <= file->nodeMinMax(level, 1, 2).y * kWorldHeight + quantum);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CDLOD selection : full coverage, finest under the camera, coarse far away
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(TerrainStreamingSelection) {
+  auto file = makeTileFile(512, 32);
+  TerrainStreamer streamer(file, kWorldSize, kWorldHeight);
+  fvec3 campos(-1500.0f, 400.0f, -1500.0f);
+  settle(streamer, campos);
+  CHECK(selectionCoversTerrain(streamer));
+
+  int level_under_camera = -1;
+  int maxlevel           = 0;
+  for (const auto& sel : streamer._selection) {
+    const auto& bounds = sel._tile->_bounds;
+    if (campos.x >= bounds.Min().x and campos.x <= bounds.Max().x //
+        and campos.z >= bounds.Min().z and campos.z <= bounds.Max().z)
+      level_under_camera = sel._tile->_level;
+    maxlevel = std::max(maxlevel, sel._tile->_level);
+    CHECK(sel._morphStart <= sel._morphEnd);
+  }
+  CHECK_EQUAL(0, level_under_camera);
+  CHECK(maxlevel >= 3);
+
+  // while tiles are still in flight, coarser tiles cover for them
+  TerrainStreamer cold(file, kWorldSize, kWorldHeight);
+  cold._maxInFlight = 2;
+  for (int i = 0; i < 8; i++) {
+    cold.update(fvec3(1500.0f, 400.0f, 1500.0f));
+    CHECK(cold._selection.empty() or selectionCoversTerrain(cold));
+    cold.waitIdle();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// residency budget : flying across evicts least recently used tiles,
+//  never what is on screen, and never opens a hole
+///////////////////////////////////////////////////////////////////////////////
+
+TEST(TerrainStreamingEviction) {
+  auto file = makeTileFile(512, 32);
+  TerrainStreamer streamer(file, kWorldSize, kWorldHeight);
+  streamer._residentBudget = 24;
+
+  int holes = 0;
+  for (int step = 0; step <= 16; step++) {
+    float t = float(step) / 16.0f;
+    fvec3 campos(-1800.0f + 3600.0f * t, 300.0f, -1800.0f + 3600.0f * t);
+    settle(streamer, campos);
+    if (not selectionCoversTerrain(streamer))
+      holes++;
+    // over budget only by what this frame draws
+    size_t inuse = 0;
+    for (const auto& item : streamer._resident)
+      inuse += (item.second->_lastframe == streamer._frame) ? 1 : 0;
+    CHECK(streamer._resident.size() <= std::max(streamer._residentBudget, inuse));
+  }
+  CHECK_EQUAL(0, holes);
+  CHECK(streamer._numEvicted > 0);
+  CHECK_EQUAL(streamer._numLoaded - streamer._numEvicted, streamer._resident.size());
+}
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////
+// Orkid Media Engine
+// Copyright 1996-2023, Michael T. Mayers.
+// Distributed under the MIT License.
+// see license-mit.txt in the root of the repo, and/or https://opensource.org/license/mit/
+////////////////////////////////////////////////////////////////
+
+#include <ork/pch.h>
+#include <ork/application/application.h>
+#include <ork/file/fileenv.h>
+#include <ork/file/path.h>
+#include <ork/kernel/datacache.h>
+#include <ork/kernel/opq.h>
+#include <ork/kernel/timer.h>
+#include <ork/lev2/init.h>
+#include <ork/lev2/gfx/gfxenv.h>
+#include <ork/lev2/gfx/material_pbr.inl>
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <fstream>
+
+namespace po = ::boost::program_options;
+
+namespace ork::lev2 {
+void GfxInit(const std::string& gfxlayer);
+extern context_ptr_t gloadercontext;
+} // namespace ork::lev2
+
+using namespace ork;
+
+///////////////////////////////////////////////////////////////////////////////
+// cpu prefilter timing on a synthetic source (no gpu involved)
+///////////////////////////////////////////////////////////////////////////////
+
+static int _bench(int w, int h, int numiters) {
+  envprefilter::EnvImage src(w, h);
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) {
+      fvec3 d         = envprefilter::sourceDirection((float(x) + 0.5f) / float(w), (float(y) + 0.5f) / float(h), true);
+      src.texel(x, y) = fvec4(d.x * 0.5f + 0.5f, d.y * 0.5f + 0.5f, 1.0f, 1.0f);
+    }
+  envprefilter::Params params;
+  params._sourceZPole = true;
+  for (int i = 0; i < numiters; i++) {
+    ork::Timer timer;
+    timer.Start();
+    auto result = envprefilter::prefilter(src, params);
+    printf(
+        "envprefilter %dx%d : %zu spec levels, %zu diffuse levels in %g sec\n",
+        w,
+        h,
+        result._specularLevels.size(),
+        result._diffuseLevels.size(),
+        timer.SecsSinceStart());
+  }
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// offline env map prefilter : loads the source as the runtime does (through
+//  the texture interface, so png sources go through the same XTX conversion)
+//  and runs PBRMaterial::prefilterEnvMap on it. the bundle lands in the
+//  datablock cache under the runtime's key, the runtime then skips the work.
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv, char** envp) {
+
+  auto desc = std::make_shared<po::options_description>("orkid env map prefilter");
+
+  ////////////////////////////////////
+
+  auto rval =                          //
+      desc->add_options()              //
+      ("help", "produce help message") //
+      ("in", po::value<std::string>()->default_value(""), "source env map (as loaded by the runtime)") //
+      ("equirectangular", "source is read as a skybox equirectangular map") //
+      ("out", po::value<std::string>()->default_value(""), "also write the bundle to this file") //
+      ("bench", po::value<int>()->default_value(0), "time the cpu prefilter on a synthetic 1024x512 source, N times");
+
+  ////////////////////////////////////
+
+  auto vars = std::make_shared<po::variables_map>();
+  if (desc) {
+    auto cmdline = po::parse_command_line(argc, argv, *desc);
+    po::store(cmdline, *vars);
+    po::notify(*vars);
+  }
+  if (vars->count("help")) {
+    std::cout << (*desc) << "\n";
+    exit(0);
+  }
+
+  //////////////////////////////////////////////////////////////
+
+  auto inname          = (*vars)["in"].as<std::string>();
+  auto outname         = (*vars)["out"].as<std::string>();
+  int numbench         = (*vars)["bench"].as<int>();
+  bool equirectangular = vars->count("equirectangular") != 0;
+  if (numbench > 0)
+    return _bench(1024, 512, numbench);
+  if (inname.empty()) {
+    std::cout << (*desc) << "\n";
+    return -1;
+  }
+
+  auto filebytes = datablockFromFileAtPath(file::Path(inname.c_str()));
+  if (nullptr == filebytes) {
+    printf("could not read<%s>\n", inname.c_str());
+    return -1;
+  }
+
+  //////////////////////////////////////////////////////////////
+  // headless lev2 : the loader context does the decode and readback
+  //////////////////////////////////////////////////////////////
+
+  auto initdata = std::make_shared<ork::AppInitData>(argc, argv, envp);
+  lev2::initModule(initdata);
+  auto spctx = std::make_shared<StringPoolContext>();
+  StringPoolStack::push(spctx);
+  rtti::Class::InitializeClasses();
+  lev2::GfxInit("");
+  auto context = lev2::gloadercontext.get();
+  OrkAssert(context != nullptr);
+  lev2::ThreadGfxContext gfxctx_track(context);
+  context->makeCurrentContext();
+
+  auto rawenvmap        = std::make_shared<lev2::Texture>();
+  rawenvmap->_debugName = inname;
+  if (not context->TXI()->LoadTexture(rawenvmap, filebytes)) {
+    printf("could not decode<%s>\n", inname.c_str());
+    return -1;
+  }
+  opq::mainSerialQueue()->drain(); // gpu upload
+
+  //////////////////////////////////////////////////////////////
+
+  ork::Timer timer;
+  timer.Start();
+  lev2::PBRMaterial::prefilterEnvMap(rawenvmap, context, equirectangular);
+  opq::mainSerialQueue()->drain();
+  uint64_t cachekey = lev2::PBRMaterial::envPrefilterCacheKey(rawenvmap->_contentHash, equirectangular);
+  auto bundle       = DataBlockCache::findDataBlock(cachekey);
+  OrkAssert(bundle != nullptr);
+  printf(
+      "envbake<%s> %dx%d equirectangular<%d> key<%016zx> bytes<%zu> time<%g sec>\n", //
+      inname.c_str(),
+      rawenvmap->_width,
+      rawenvmap->_height,
+      int(equirectangular),
+      size_t(cachekey),
+      bundle->length(),
+      timer.SecsSinceStart());
+
+  if (outname.length()) {
+    std::ofstream out(outname, std::ios::binary);
+    out.write((const char*)bundle->data(), bundle->length());
+  }
+  StringPoolStack::pop();
+  return 0;
+}